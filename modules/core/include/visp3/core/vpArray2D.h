@@ -45,6 +45,9 @@
 #include <fstream>
 #include <sstream>
 #include <limits>
+#ifdef VISP_HAVE_CPP11_COMPATIBILITY
+#  include <utility>
+#endif
 
 #include <visp3/core/vpConfig.h>
 #include <visp3/core/vpException.h>
@@ -78,6 +81,8 @@ protected:
   Type **rowPtrs;
   //! Current array size (rowNum * colNum)
   unsigned int dsize;
+  //! False when the memory is provided by a fixed size derived class (see vpFixedArray2D)
+  bool ownData;
 
 public:
   //! Address of the first element of the data array
@@ -89,17 +94,44 @@ public:
   Number of columns and rows are set to zero.
   */
   vpArray2D<Type>()
-    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), data(NULL)
+    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), ownData(true), data(NULL)
   {}
   /*!
   Copy constructor of a 2D array.
   */
   vpArray2D<Type>(const vpArray2D<Type> & A)
-    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), data(NULL)
+    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), ownData(true), data(NULL)
   {
     resize(A.rowNum, A.colNum);
     memcpy(data, A.data, rowNum*colNum*sizeof(Type));
   }
+#ifdef VISP_HAVE_CPP11_COMPATIBILITY
+  /*!
+  Move constructor of a 2D array. The memory of \e A is taken without copy
+  and \e A becomes an empty array, unless \e A has a fixed size (see
+  vpFixedArray2D) in which case it is copied.
+  */
+  vpArray2D<Type>(vpArray2D<Type> && A)
+    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), ownData(true), data(NULL)
+  {
+    if (A.ownData) {
+      rowNum = A.rowNum;
+      colNum = A.colNum;
+      rowPtrs = A.rowPtrs;
+      dsize = A.dsize;
+      data = A.data;
+
+      A.rowNum = A.colNum = A.dsize = 0;
+      A.rowPtrs = NULL;
+      A.data = NULL;
+    }
+    else {
+      // The memory of a fixed size array can't be taken
+      resize(A.rowNum, A.colNum);
+      memcpy(data, A.data, rowNum*colNum*sizeof(Type));
+    }
+  }
+#endif
   /*!
   Constructor that initializes a 2D array with 0.
 
@@ -107,7 +139,7 @@ public:
   \param c : Array number of columns.
   */
   vpArray2D<Type>(unsigned int r, unsigned int c)
-    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), data(NULL)
+    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), ownData(true), data(NULL)
   {
     resize(r, c);
   }
@@ -119,7 +151,7 @@ public:
   \param val : Each element of the array is set to \e val.
   */
   vpArray2D<Type>(unsigned int r, unsigned int c, Type val)
-    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), data(NULL)
+    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), ownData(true), data(NULL)
   {
     resize(r, c);
     *this = val;
@@ -129,15 +161,15 @@ public:
   */
   virtual ~vpArray2D<Type>()
   {
-    if (data != NULL ) {
+    if (ownData && data != NULL ) {
       free(data);
-      data=NULL;
     }
+    data=NULL;
 
-    if (rowPtrs!=NULL) {
+    if (ownData && rowPtrs!=NULL) {
       free(rowPtrs);
-      rowPtrs=NULL ;
     }
+    rowPtrs=NULL ;
     rowNum = colNum = dsize = 0;
   }
 
@@ -163,6 +195,9 @@ public:
   after resize. If false, the initial values from the common part of the
   array (common part between old and new version of the array) are kept.
   Default value is true.
+
+  \exception vpException::dimensionError If the array has a fixed size
+  (see vpFixedArray2D) that differs from the requested one.
   */
   void resize(const unsigned int nrows, const unsigned int ncols,
               const bool flagNullify = true)
@@ -173,6 +208,10 @@ public:
       }
     }
     else {
+      if (! ownData) {
+        throw(vpException(vpException::dimensionError,
+          "Cannot resize a fixed size (%dx%d) array to (%dx%d)", rowNum, colNum, nrows, ncols)) ;
+      }
       const bool recopyNeeded = (ncols != this ->colNum);
       Type * copyTmp = NULL;
       unsigned int rowTmp = 0, colTmp=0;
@@ -255,6 +294,36 @@ public:
     return *this;
   }
 
+#ifdef VISP_HAVE_CPP11_COMPATIBILITY
+  /*!
+    Move operator of a 2D array. The memory of the array is freed and
+    replaced by the one of \e A, that becomes an empty array. \e A is
+    copied when one of the arrays has a fixed size (see vpFixedArray2D).
+  */
+  vpArray2D<Type> & operator=(vpArray2D<Type> && A)
+  {
+    if (! ownData || ! A.ownData) {
+      // The memory of a fixed size array can't be replaced nor taken
+      return vpArray2D<Type>::operator=(static_cast<const vpArray2D<Type> &>(A));
+    }
+    if (this != &A) {
+      free(data);
+      free(rowPtrs);
+
+      rowNum = A.rowNum;
+      colNum = A.colNum;
+      rowPtrs = A.rowPtrs;
+      dsize = A.dsize;
+      data = A.data;
+
+      A.rowNum = A.colNum = A.dsize = 0;
+      A.rowPtrs = NULL;
+      A.data = NULL;
+    }
+    return *this;
+  }
+#endif
+
   //! Set element \f$A_{ij} = x\f$ using A[i][j] = x
   inline Type *operator[](unsigned int i) { return rowPtrs[i]; }
   //! Get element \f$x = A_{ij}\f$ using x = A[i][j]
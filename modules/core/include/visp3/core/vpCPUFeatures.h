@@ -0,0 +1,79 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * CPU features (hardware capabilities) detected at runtime.
+ *
+ *****************************************************************************/
+
+#ifndef __vpCPUFeatures_h_
+#define __vpCPUFeatures_h_
+
+/*!
+  \file vpCPUFeatures.h
+  \brief CPU features (hardware capabilities) detected at runtime.
+*/
+
+#include <visp3/core/vpConfig.h>
+
+/*!
+  \ingroup group_core_cpu_features
+
+  Query the SIMD instruction sets supported by the processor the program is
+  running on. The detection is done once, the first time one of these
+  functions is called.
+
+  These functions are used internally to select at runtime the fastest
+  implementation of some image processing functions (see vpImageConvert).
+  A binary built on a recent compiler can thus take benefit of AVX2 on a
+  recent processor while remaining usable on an older one.
+
+  \code
+#include <visp3/core/vpCPUFeatures.h>
+
+int main()
+{
+  std::cout << "SSE2: " << vpCPUFeatures::checkSSE2() << std::endl;
+  std::cout << "AVX2: " << vpCPUFeatures::checkAVX2() << std::endl;
+}
+  \endcode
+*/
+namespace vpCPUFeatures
+{
+  VISP_EXPORT bool checkSSE2();
+  VISP_EXPORT bool checkSSE3();
+  VISP_EXPORT bool checkSSSE3();
+  VISP_EXPORT bool checkSSE41();
+  VISP_EXPORT bool checkSSE42();
+  VISP_EXPORT bool checkAVX();
+  VISP_EXPORT bool checkAVX2();
+  VISP_EXPORT bool checkNEON();
+};
+
+#endif
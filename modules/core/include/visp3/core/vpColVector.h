@@ -82,6 +82,9 @@ public:
   vpColVector(unsigned int n, double val) : vpArray2D<double>(n, 1, val){};
   //! Copy constructor that allows to construct a column vector from an other one.
   vpColVector(const vpColVector &v) : vpArray2D<double>(v) {};
+#ifdef VISP_HAVE_CPP11_COMPATIBILITY
+  vpColVector(vpColVector &&v);
+#endif
   vpColVector(const vpColVector &v, unsigned int r, unsigned int nrows) ;
   //! Constructor that initialize a column vector from a 3-dim (Euler or \f$\theta {\bf u}\f$)
   //! or 4-dim (quaternion) rotation vector.
@@ -174,6 +177,9 @@ public:
   inline const double &operator[](unsigned int n) const { return *(data+n);  }
   //! Copy operator.   Allow operation such as A = v
   vpColVector &operator=(const vpColVector &v);
+#ifdef VISP_HAVE_CPP11_COMPATIBILITY
+  vpColVector &operator=(vpColVector &&v);
+#endif
   vpColVector &operator=(const vpPoseVector &p);
   vpColVector &operator=(const vpRotationVector &rv);
   vpColVector &operator=(const vpTranslationVector &tv);
@@ -192,10 +198,10 @@ public:
 
   vpColVector operator+(const vpColVector &v) const;
   vpTranslationVector operator+(const vpTranslationVector &t) const;
-  vpColVector &operator+=(vpColVector v);
+  vpColVector &operator+=(const vpColVector &v);
 
   vpColVector operator-(const vpColVector &v) const;
-  vpColVector &operator-=(vpColVector v);
+  vpColVector &operator-=(const vpColVector &v);
   vpColVector operator-() const;
 
   vpColVector &operator<<(const vpColVector &v);
@@ -0,0 +1,106 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * 2D array with a size known at compile time.
+ *
+ *****************************************************************************/
+#ifndef __vpFixedArray2D_h_
+#define __vpFixedArray2D_h_
+
+#include <string.h>
+
+#include <visp3/core/vpArray2D.h>
+
+/*!
+  \class vpFixedArray2D
+  \ingroup group_core_matrices
+
+  \brief Implementation of a 2D array of \e R rows and \e C columns whose
+  elements are stored in the object itself rather than on the heap.
+
+  It is the base class of the small matrices used in geometry:
+  vpRotationMatrix, vpHomogeneousMatrix, vpVelocityTwistMatrix and
+  vpForceTwistMatrix. Constructing, copying or destroying them doesn't
+  involve any memory allocation, which matters when thousands of frame
+  transformations are composed per image.
+
+  Since it inherits from vpArray2D, a vpFixedArray2D can be used wherever a
+  vpArray2D is expected. Only its size can't change: vpArray2D::resize()
+  throws a vpException::dimensionError when the requested size differs from
+  \e R x \e C.
+
+  The elements are set to zero by the default constructor.
+*/
+template<class Type, unsigned int R, unsigned int C>
+class vpFixedArray2D : public vpArray2D<Type>
+{
+public:
+  //! Constructor that initializes the array with 0.
+  vpFixedArray2D()
+    : vpArray2D<Type>()
+  {
+    init();
+    memset(m_data, 0, sizeof(m_data));
+  }
+  //! Copy constructor.
+  vpFixedArray2D(const vpFixedArray2D<Type, R, C> &A)
+    : vpArray2D<Type>()
+  {
+    init();
+    memcpy(m_data, A.m_data, sizeof(m_data));
+  }
+  virtual ~vpFixedArray2D() {}
+
+  using vpArray2D<Type>::operator=;
+  //! Copy operator.
+  vpFixedArray2D<Type, R, C> &operator=(const vpFixedArray2D<Type, R, C> &A)
+  {
+    memcpy(m_data, A.m_data, sizeof(m_data));
+    return *this;
+  }
+
+private:
+  void init()
+  {
+    this->rowNum = R;
+    this->colNum = C;
+    this->dsize = R * C;
+    this->data = m_data;
+    this->rowPtrs = m_rowPtrs;
+    this->ownData = false;
+    for (unsigned int i = 0; i < R; i++)
+      m_rowPtrs[i] = m_data + i * C;
+  }
+
+  Type m_data[R * C];
+  Type *m_rowPtrs[R];
+};
+
+#endif
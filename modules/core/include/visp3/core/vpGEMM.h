@@ -44,6 +44,25 @@
 
 const vpArray2D<double> null(0,0);
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+// First element and number of elements between two rows of an array, that
+// differs from its number of columns for a vpSubMatrix
+inline double *vpGEMMData(const vpArray2D<double> &M)
+{
+  return (M.getRows() > 0) ? M[0] : NULL;
+}
+inline unsigned int vpGEMMStride(const vpArray2D<double> &M)
+{
+  return (M.getRows() > 1) ? (unsigned int)(M[1] - M[0]) : M.getCols();
+}
+#endif
+
+VISP_EXPORT void vpGEMMKernel(bool transA, bool transB, unsigned int m, unsigned int n, unsigned int k,
+                              double alpha, const double *A, unsigned int lda, const double *B, unsigned int ldb,
+                              double beta, double *C, unsigned int ldc);
+VISP_EXPORT void vpGEMVKernel(unsigned int m, unsigned int n, const double *A, unsigned int lda,
+                              const double *x, double *y);
+
 /*!
   Enumeration of the operations applied on matrices in vpGEMM() function.
   
@@ -134,6 +153,8 @@ inline void GEMMsize<7>(const vpArray2D<double> & A,const vpArray2D<double> & B,
   Bcols= B.getRows();
 }
 
+// Straightforward implementations of the products, used as a reference by the
+// tests. vpTGEMM() relies on vpGEMMKernel().
 template<unsigned int>
 inline void GEMM1(const unsigned int &/*Arows*/,const unsigned int &/*Brows*/, const unsigned int &/*Bcols*/, const vpArray2D<double> & /*A*/, const vpArray2D<double> & /*B*/, const double & /*alpha*/,vpArray2D<double> &/*D*/){}
 
@@ -310,17 +331,39 @@ inline void vpTGEMM(const vpArray2D<double> & A, const vpArray2D<double> & B, co
                       Arows, Acols, Brows, Bcols)) ;
   }
   
+  const bool transA = (T & VP_GEMM_A_T) != 0;
+  const bool transB = (T & VP_GEMM_B_T) != 0;
+
   if(C.getRows()!=0 && C.getCols()!=0){
-    if ((Arows != C.getRows()) || (Bcols != C.getCols())) {
+    const bool transC = (T & VP_GEMM_C_T) != 0;
+    const unsigned int Crows = transC ? C.getCols() : C.getRows();
+    const unsigned int Ccols = transC ? C.getRows() : C.getCols();
+    if ((Arows != Crows) || (Bcols != Ccols)) {
       throw(vpException(vpException::dimensionError,
                         "In vpGEMM, cannot add resulting (%dx%d) matrix to (%dx%d) matrix",
-                        Arows, Bcols, C.getRows(), C.getCols())) ;
+                        Arows, Bcols, Crows, Ccols)) ;
+    }
+
+    // D = beta*op(C), then D += alpha*op(A)*op(B)
+    if (transC) {
+      vpArray2D<double> Ct(Arows, Bcols);
+      for(unsigned int r=0;r<Arows;r++)
+        for(unsigned int c=0;c<Bcols;c++)
+          Ct[r][c]=beta*C[c][r];
+      for(unsigned int r=0;r<Arows;r++)
+        for(unsigned int c=0;c<Bcols;c++)
+          D[r][c]=Ct[r][c];
+    }
+    else {
+      for(unsigned int r=0;r<Arows;r++)
+        for(unsigned int c=0;c<Bcols;c++)
+          D[r][c]=beta*C[r][c];
     }
-    
-    GEMM2<T>(Arows,Brows,Bcols,A,B,alpha,C,beta,D);
-  }else{
-    GEMM1<T>(Arows,Brows,Bcols,A,B,alpha,D);
   }
+
+  vpGEMMKernel(transA, transB, Arows, Bcols, Brows, alpha,
+               vpGEMMData(A), vpGEMMStride(A), vpGEMMData(B), vpGEMMStride(B),
+               (C.getRows()!=0 && C.getCols()!=0) ? 1. : 0., vpGEMMData(D), vpGEMMStride(D));
   
 }
 
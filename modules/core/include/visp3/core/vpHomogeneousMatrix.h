@@ -58,7 +58,7 @@ class vpPoint;
 #include <vector>
 #include <fstream>
 
-#include <visp3/core/vpArray2D.h>
+#include <visp3/core/vpFixedArray2D.h>
 #include <visp3/core/vpRotationMatrix.h>
 #include <visp3/core/vpThetaUVector.h>
 //#include <visp3/core/vpTranslationVector.h>
@@ -74,7 +74,8 @@ class vpPoint;
   The class provides a data structure for the homogeneous matrices
   as well as a set of operations on these matrices.
 
-  The vpHomogeneousMatrix class is derived from vpArray2D<double>.
+  The vpHomogeneousMatrix class is derived from vpFixedArray2D<double, 4, 4>,
+  so that composing or inverting homogeneous matrices doesn't allocate memory.
 
   An homogeneous matrix is 4x4 matrix defines as
   \f[
@@ -90,7 +91,7 @@ class vpPoint;
   \f$ ^a{\bf t}_b \f$ is a translation vector.
 
 */
-class VISP_EXPORT vpHomogeneousMatrix : public vpArray2D<double>
+class VISP_EXPORT vpHomogeneousMatrix : public vpFixedArray2D<double, 4, 4>
 {
  public:
   vpHomogeneousMatrix();
@@ -57,6 +57,8 @@
 #include <fstream>
 #include <iostream>
 #include <math.h>
+#include <new>
+#include <stdlib.h>
 #include <string.h>
 
 class vpDisplay;
@@ -85,6 +87,23 @@ class vpDisplay;
   if i is the ith rows and j the jth columns the value of this pixel
   is given by I[i][j] (that is equivalent to row[i][j]).
 
+  <h3> Memory management </h3>
+
+  The bitmap allocated by the image starts on a 64 bytes boundary, which is
+  the size of a cache line and the alignment expected by SIMD instructions.
+  The rows are stored one after the other without padding, so that the whole
+  bitmap can always be processed as a single array of getSize() pixels.
+
+  An image can also wrap a memory buffer that it doesn't own, for instance a
+  buffer filled by a frame grabber, the data of a cv::Mat or a shared memory
+  segment, using wrap(). No copy is done and the buffer is never freed by
+  the image: it has to stay alive as long as the image uses it. Resizing the
+  image to the same size keeps writing in the wrapped buffer, while resizing
+  it to another size allocates a new bitmap owned by the image.
+
+  vpImagePool provides a fixed set of such buffers that can be reused from
+  one image to the next in an acquisition loop.
+
   <h3>Example</h3>
   The following example available in tutorial-image-manipulation.cpp shows how
   to create gray level and color images and how to access to the pixels.
@@ -123,6 +142,10 @@ public:
   vpImage() ;
   //! copy constructor
   vpImage(const vpImage<Type>&);
+#ifdef VISP_HAVE_CPP11_COMPATIBILITY
+  //! move constructor
+  vpImage(vpImage<Type>&&);
+#endif
   //! constructor  set the size of the image
   vpImage(unsigned int height, unsigned int width) ;
   //! constructor  set the size of the image and init all the pixel
@@ -137,6 +160,8 @@ public:
   void init(unsigned int height, unsigned int width, Type value) ;
   //! init from an image stored as a continuous array in memory
   void init(Type * const array, const unsigned int height, const unsigned int width, const bool copyData=false);
+  //! wrap an external buffer without copy nor ownership
+  void wrap(Type * const array, const unsigned int height, const unsigned int width);
   //! set the size of the image without initializing it.
   void resize(const unsigned int h, const unsigned int w) ;
   //! set the size of the image and initialize it.
@@ -295,6 +320,9 @@ public:
 
   //! Copy operator
   vpImage<Type>&  operator=(const vpImage<Type> &I) ;
+#ifdef VISP_HAVE_CPP11_COMPATIBILITY
+  vpImage<Type>&  operator=(vpImage<Type> &&I) ;
+#endif
 
   vpImage<Type>& operator=(const Type &v);
   bool operator==(const vpImage<Type> &I);
@@ -318,13 +346,88 @@ public:
   // Perform a look-up table transformation
   void performLut(const Type (&lut)[256], const unsigned int nbThreads=1);
 
+  /*!
+    Return true if the bitmap was allocated by the image and is freed with
+    it, false if the image wraps an external buffer.
+
+    \sa wrap()
+  */
+  inline bool isBitmapOwner() const { return ownership != WRAPPED_BITMAP; }
+
 private:
+  /*!
+    Origin of the bitmap, that gives the way it is freed.
+  */
+  typedef enum {
+    ALLOCATED_BITMAP, /*!< Allocated by allocateBitmap(), freed by freeBitmap(). */
+    ADOPTED_BITMAP,   /*!< Allocated with new[] by the user and given to init(), freed with delete[]. */
+    WRAPPED_BITMAP    /*!< External buffer given to wrap(), never freed by the image. */
+  } vpBitmapOwnership;
+
+  static Type *allocateBitmap(unsigned int n);
+  static void freeBitmap(Type *ptr, unsigned int n);
+  void releaseBitmap();
+  void attachBitmap(Type * const array, const unsigned int h, const unsigned int w, const vpBitmapOwnership owner);
+
   unsigned int npixels ; //<! number of pixel in the image
   unsigned int width ;   //<! number of columns
   unsigned int height ;   //<! number of rows
   Type **row ;    //!< points the row pointer array
+  vpBitmapOwnership ownership ; //!< gives how bitmap has to be freed
 };
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+/*!
+  Allocate an array of \e n pixels starting on a 64 bytes boundary. The
+  address returned by malloc() is stored just before the aligned array.
+  Like new Type[n], the pixels are default-initialized.
+*/
+template<class Type>
+Type *vpImage<Type>::allocateBitmap(unsigned int n)
+{
+  const size_t alignment = 64;
+  void *raw = malloc((size_t)n*sizeof(Type) + alignment + sizeof(void *));
+  if (raw == NULL) {
+    throw(vpException(vpException::memoryAllocationError,
+                      "cannot allocate bitmap ")) ;
+  }
+  size_t address = ((size_t)raw + sizeof(void *) + alignment - 1) & ~(alignment - 1);
+  ((void **)address)[-1] = raw;
+
+  Type *ptr = (Type *)address;
+  for (unsigned int i = 0; i < n; i++)
+    new (ptr + i) Type;
+  return ptr;
+}
+
+/*!
+  Free an array allocated with allocateBitmap().
+*/
+template<class Type>
+void vpImage<Type>::freeBitmap(Type *ptr, unsigned int n)
+{
+  if (ptr == NULL)
+    return;
+  for (unsigned int i = 0; i < n; i++)
+    ptr[i].~Type();
+  free(((void **)ptr)[-1]);
+}
+
+/*!
+  Free the bitmap if it is owned by the image, forget it otherwise.
+*/
+template<class Type>
+void vpImage<Type>::releaseBitmap()
+{
+  if (ownership == ALLOCATED_BITMAP)
+    freeBitmap(bitmap, npixels);
+  else if (ownership == ADOPTED_BITMAP)
+    delete [] bitmap;
+  bitmap = NULL;
+  ownership = ALLOCATED_BITMAP;
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 
 #if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
 namespace {
@@ -534,8 +637,7 @@ vpImage<Type>::init(unsigned int h, unsigned int w)
   {
     if (bitmap != NULL) {
       vpDEBUG_TRACE(10,"Destruction bitmap[]") ;
-      delete [] bitmap;
-      bitmap = NULL;
+      releaseBitmap();
     }
   }
 
@@ -544,15 +646,7 @@ vpImage<Type>::init(unsigned int h, unsigned int w)
 
   npixels=width*height;
 
-  if (bitmap == NULL)  bitmap = new  Type[npixels] ;
-
-  //  vpERROR_TRACE("Allocate bitmap %p",bitmap) ;
-  if (bitmap == NULL)
-  {
-        vpERROR_TRACE("cannot allocate bitmap ") ;
-    throw(vpException(vpException::memoryAllocationError,
-          "cannot allocate bitmap ")) ;
-  }
+  if (bitmap == NULL)  bitmap = allocateBitmap(npixels) ;
 
   if (row == NULL)  row = new  Type*[height] ;
 //  vpERROR_TRACE("Allocate row %p",row) ;
@@ -577,13 +671,23 @@ vpImage<Type>::init(unsigned int h, unsigned int w)
   \param h : Image height.
   \param w : Image width.
   \param copyData : If false (by default) only the memory address is copied, otherwise the data are copied.
+  When the address is copied, the image takes the ownership of \e array, that has to be allocated
+  with new[] and is freed by the image with delete[]. To use a buffer without taking its ownership,
+  use wrap() instead.
 
   \exception vpException::memoryAllocationError
+
+  \sa wrap()
 */
 template<class Type>
 void
 vpImage<Type>::init(Type * const array, const unsigned int h, const unsigned int w, const bool copyData)
 {
+  if (!copyData) {
+    attachBitmap(array, h, w, ADOPTED_BITMAP);
+    return;
+  }
+
   if (h != this->height) {
     if (row != NULL)  {
       delete [] row;
@@ -591,11 +695,10 @@ vpImage<Type>::init(Type * const array, const unsigned int h, const unsigned int
     }
   }
 
-  //Delete bitmap if copyData==false, otherwise only if the dimension differs
-  if ( (copyData && ((h != this->height) || (w != this->width))) || !copyData ) {
+  //Delete bitmap only if the dimension differs
+  if ((h != this->height) || (w != this->width)) {
     if (bitmap != NULL) {
-      delete [] bitmap;
-      bitmap = NULL;
+      releaseBitmap();
     }
   }
 
@@ -604,21 +707,85 @@ vpImage<Type>::init(Type * const array, const unsigned int h, const unsigned int
 
   npixels = width*height;
 
-  if(copyData) {
-    if (bitmap == NULL)  bitmap = new  Type[npixels];
+  if (bitmap == NULL)  bitmap = allocateBitmap(npixels);
+
+  //Copy the image data
+  memcpy(bitmap, array, (size_t) (npixels * sizeof(Type)));
+
+  if (row == NULL)  row = new Type*[height];
+  if (row == NULL) {
+    throw(vpException(vpException::memoryAllocationError,
+          "cannot allocate row ")) ;
+  }
+
+  for (unsigned int i = 0  ; i < height ; i++) {
+    row[i] = bitmap + i*width;
+  }
+}
+
+/*!
+  \brief Image initialization
+
+  Make the image wrap a buffer stored as a continuous array in memory, without
+  copy. The image doesn't take the ownership of \e array, that is never freed
+  by the image and has to stay alive as long as the image uses it.
+
+  Resizing the image to the same size keeps writing in \e array, while resizing
+  it to another size allocates a new bitmap owned by the image.
+
+  \param array : Buffer of \e h x \e w pixels.
+  \param h : Image height.
+  \param w : Image width.
+
+  The following example wraps a grey level buffer without copy:
+  \code
+  unsigned char *buffer = new unsigned char[480*640];
+  vpImage<unsigned char> I;
+  I.wrap(buffer, 480, 640); // I[i][j] is buffer[i*640+j]
+  // ...
+  delete [] buffer; // Once I is not used anymore
+  \endcode
+
+  \exception vpException::memoryAllocationError
+
+  \sa isBitmapOwner()
+*/
+template<class Type>
+void
+vpImage<Type>::wrap(Type * const array, const unsigned int h, const unsigned int w)
+{
+  attachBitmap(array, h, w, WRAPPED_BITMAP);
+}
 
-    if (bitmap == NULL) {
-      throw(vpException(vpException::memoryAllocationError,
-            "cannot allocate bitmap ")) ;
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+/*!
+  Replace the bitmap by \e array, that is freed according to \e owner.
+*/
+template<class Type>
+void
+vpImage<Type>::attachBitmap(Type * const array, const unsigned int h, const unsigned int w,
+                            const vpBitmapOwnership owner)
+{
+  if (h != this->height) {
+    if (row != NULL)  {
+      delete [] row;
+      row = NULL;
     }
+  }
 
-    //Copy the image data
-    memcpy(bitmap, array, (size_t) (npixels * sizeof(Type)));
-  } else {
-    //Copy the address of the array in the bitmap
-    bitmap = array;
+  if (bitmap != NULL) {
+    releaseBitmap();
   }
 
+  this->width = w ;
+  this->height = h;
+
+  npixels = width*height;
+
+  //Copy the address of the array in the bitmap
+  bitmap = array;
+  ownership = owner;
+
   if (row == NULL)  row = new Type*[height];
   if (row == NULL) {
     throw(vpException(vpException::memoryAllocationError,
@@ -629,6 +796,7 @@ vpImage<Type>::init(Type * const array, const unsigned int h, const unsigned int
     row[i] = bitmap + i*width;
   }
 }
+#endif // DOXYGEN_SHOULD_SKIP_THIS
 
 /*!
   \brief Constructor
@@ -650,7 +818,7 @@ vpImage<Type>::init(Type * const array, const unsigned int h, const unsigned int
 */
 template<class Type>
 vpImage<Type>::vpImage(unsigned int h, unsigned int w)
-  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL)
+  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL), ownership(ALLOCATED_BITMAP)
 {
   try
   {
@@ -681,7 +849,7 @@ vpImage<Type>::vpImage(unsigned int h, unsigned int w)
 */
 template<class Type>
 vpImage<Type>::vpImage (unsigned int h, unsigned int w, Type value)
-  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL)
+  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL), ownership(ALLOCATED_BITMAP)
 {
   try
   {
@@ -703,14 +871,17 @@ vpImage<Type>::vpImage (unsigned int h, unsigned int w, Type value)
   \param h : Image height.
   \param w : Image width.
   \param copyData : If false (by default) only the memory address is copied, otherwise the data are copied.
+  When the address is copied, the image takes the ownership of \e array, that has to be allocated
+  with new[] and is freed by the image with delete[]. To use a buffer without taking its ownership,
+  use wrap() instead.
 
   \return MEMORY_FAULT if memory allocation is impossible, else OK
 
-  \sa vpImage::init(array, height, width)
+  \sa vpImage::init(array, height, width), wrap()
 */
 template<class Type>
 vpImage<Type>::vpImage (Type * const array, const unsigned int h, const unsigned int w, const bool copyData)
-  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL)
+  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL), ownership(ALLOCATED_BITMAP)
 {
   try
   {
@@ -733,7 +904,7 @@ vpImage<Type>::vpImage (Type * const array, const unsigned int h, const unsigned
 */
 template<class Type>
 vpImage<Type>::vpImage()
-  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL)
+  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL), ownership(ALLOCATED_BITMAP)
 {
 }
 
@@ -824,8 +995,7 @@ vpImage<Type>::destroy()
   {
   //  vpERROR_TRACE("Deallocate bitmap memory %p",bitmap) ;
 //    vpDEBUG_TRACE(20,"Deallocate bitmap memory %p",bitmap) ;
-    delete [] bitmap ;
-    bitmap = NULL;
+    releaseBitmap();
   }
 
 
@@ -858,7 +1028,7 @@ vpImage<Type>::~vpImage()
 */
 template<class Type>
 vpImage<Type>::vpImage(const vpImage<Type>& I)
-  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL)
+  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL), ownership(ALLOCATED_BITMAP)
 {
   try
   {
@@ -873,6 +1043,23 @@ vpImage<Type>::vpImage(const vpImage<Type>& I)
   }
 }
 
+#ifdef VISP_HAVE_CPP11_COMPATIBILITY
+/*!
+  Move constructor. The bitmap of \e I is taken without copy and \e I
+  becomes an empty image.
+*/
+template<class Type>
+vpImage<Type>::vpImage(vpImage<Type>&& I)
+  : bitmap(I.bitmap), display(NULL), npixels(I.npixels), width(I.width), height(I.height), row(I.row),
+    ownership(I.ownership)
+{
+  I.bitmap = NULL;
+  I.row = NULL;
+  I.npixels = I.width = I.height = 0;
+  I.ownership = ALLOCATED_BITMAP;
+}
+#endif
+
 /*!
   \brief Return the maximum value within the bitmap
 
@@ -923,52 +1110,28 @@ void vpImage<Type>::getMinMaxValue(Type &min, Type &max) const
 
 /*!
   \brief Copy operator
+
+  If the image has already the size of \e I, its memory is reused, even
+  if it wraps an external buffer.
 */
 template<class Type>
 vpImage<Type> & vpImage<Type>::operator=(const vpImage<Type> &I)
 {
-    /* we first have to set the initial values of the image because resize function calls init function that test the actual size of the image */
-  if(bitmap != NULL){
-    delete[] bitmap;
-    bitmap = NULL ;
+  if (this == &I)
+    return (* this);
+
+  if(I.npixels == 0) {
+    destroy();
+    this->width = I.width;
+    this->height = I.height;
+    this->npixels = I.npixels;
+    return (* this);
   }
 
-  if(row != NULL){
-    delete[] row;
-    row = NULL ;
-  }
-  this->width = I.width;
-  this->height = I.height;
-  this->npixels = I.npixels;
   try
   {
-    if(I.npixels != 0)
-    {
-      if (bitmap == NULL){
-        bitmap = new  Type[npixels] ;
-      }
-
-      if (bitmap == NULL){
-            vpERROR_TRACE("cannot allocate bitmap ") ;
-        throw(vpException(vpException::memoryAllocationError,
-              "cannot allocate bitmap ")) ;
-      }
-
-      if (row == NULL){
-        row = new  Type*[height] ;
-      }
-      if (row == NULL){
-        vpERROR_TRACE("cannot allocate row ") ;
-        throw(vpException(vpException::memoryAllocationError,
-              "cannot allocate row ")) ;
-      }
-
-      memcpy(bitmap, I.bitmap, I.npixels*sizeof(Type)) ;
-
-      for (unsigned int i=0; i<this->height; i++){
-        row[i] = bitmap + i*this->width;
-      }
-    }
+    init(I.height, I.width);
+    memcpy(bitmap, I.bitmap, I.npixels*sizeof(Type)) ;
   }
   catch(vpException &)
   {
@@ -979,6 +1142,41 @@ vpImage<Type> & vpImage<Type>::operator=(const vpImage<Type> &I)
 }
 
 
+#ifdef VISP_HAVE_CPP11_COMPATIBILITY
+/*!
+  Move operator. The memory of the image is freed and replaced by the bitmap
+  of \e I, that becomes an empty image. If \e I wraps an external buffer, the
+  image wraps it in turn.
+
+  If the image wraps an external buffer that has the size of \e I, the pixels
+  are copied in this buffer like with the copy operator, so that the image
+  keeps wrapping it.
+*/
+template<class Type>
+vpImage<Type> & vpImage<Type>::operator=(vpImage<Type> &&I)
+{
+  if (ownership == WRAPPED_BITMAP && bitmap != NULL && I.height == height && I.width == width) {
+    return (*this = static_cast<const vpImage<Type> &>(I));
+  }
+
+  if (this != &I) {
+    destroy();
+    bitmap = I.bitmap;
+    row = I.row;
+    npixels = I.npixels;
+    width = I.width;
+    height = I.height;
+    ownership = I.ownership;
+
+    I.bitmap = NULL;
+    I.row = NULL;
+    I.npixels = I.width = I.height = 0;
+    I.ownership = ALLOCATED_BITMAP;
+  }
+  return (* this);
+}
+#endif
+
 /*!
   \brief = operator : Set all the element of the bitmap to a given  value \e v.
    \f$ A = v <=> A[i][j] = v \f$
@@ -93,6 +93,13 @@
 
   \include tutorial-image-converter.cpp
 
+  Most of the conversions between YUV, RGB, RGBa and grey images use SIMD
+  instructions. The instruction set (SSE2, SSSE3 or AVX2) is selected at
+  runtime from the capabilities of the processor (see vpCPUFeatures), NEON is
+  used on ARM when enabled at build time. The SIMD and the scalar code paths
+  give the same results. Large images are moreover split in bands of rows
+  that are converted by the threads of vpThreadPool.
+
 */
 class VISP_EXPORT vpImageConvert
 {
@@ -63,6 +63,15 @@
 
   \brief  Various image filter, convolution, etc...
 
+  The separable filters (filterX(), filterY(), filter(), gaussianBlur(),
+  getGradX(), getGradY()...) process whole rows: the borders are handled by
+  padding instead of per-pixel tests, the inner loops run over contiguous
+  pixels so that the compiler can vectorize them and bands of rows are
+  processed in parallel by the threads of vpThreadPool. They are available
+  with vpImage<float> outputs, which halve the memory traffic compared to
+  vpImage<double>, and gaussianBlur() has a fixed point version that keeps
+  unsigned char images.
+
 */
 class VISP_EXPORT vpImageFilter
 {
@@ -180,6 +189,8 @@ public:
 
   static void filter(const vpImage<unsigned char> &I, vpImage<double>& GI, const double *filter,unsigned  int size);
   static void filter(const vpImage<double> &I, vpImage<double>& GI, const double *filter,unsigned  int size);
+  static void filter(const vpImage<unsigned char> &I, vpImage<float>& GI, const float *filter, unsigned int size);
+  static void filter(const vpImage<float> &I, vpImage<float>& GI, const float *filter, unsigned int size);
 
   static inline unsigned char filterGaussXPyramidal(const vpImage<unsigned char> &I, unsigned int i, unsigned int j)
   {
@@ -192,6 +203,8 @@ public:
 
   static void filterX(const vpImage<unsigned char> &I, vpImage<double>& dIx, const double *filter,unsigned  int size);
   static void filterX(const vpImage<double> &I, vpImage<double>& dIx, const double *filter,unsigned  int size);
+  static void filterX(const vpImage<unsigned char> &I, vpImage<float>& dIx, const float *filter, unsigned int size);
+  static void filterX(const vpImage<float> &I, vpImage<float>& dIx, const float *filter, unsigned int size);
 
   static inline double filterX(const vpImage<unsigned char> &I,
                                unsigned int r, unsigned int c,
@@ -298,6 +311,8 @@ public:
 
   static void filterY(const vpImage<unsigned char> &I, vpImage<double>& dIx, const double *filter,unsigned  int size);
   static void filterY(const vpImage<double> &I, vpImage<double>& dIx, const double *filter,unsigned  int size);
+  static void filterY(const vpImage<unsigned char> &I, vpImage<float>& dIy, const float *filter, unsigned int size);
+  static void filterY(const vpImage<float> &I, vpImage<float>& dIy, const float *filter, unsigned int size);
   static inline double filterY(const vpImage<unsigned char> &I,
                                unsigned int r, unsigned int c,
                                const double *filter,unsigned  int size)
@@ -394,6 +409,9 @@ public:
 
   static void gaussianBlur(const vpImage<unsigned char> &I, vpImage<double>& GI, unsigned int size=7, double sigma=0., bool normalize=true);
   static void gaussianBlur(const vpImage<double> &I, vpImage<double>& GI, unsigned int size=7, double sigma=0., bool normalize=true);
+  static void gaussianBlur(const vpImage<unsigned char> &I, vpImage<float>& GI, unsigned int size=7, double sigma=0., bool normalize=true);
+  static void gaussianBlur(const vpImage<float> &I, vpImage<float>& GI, unsigned int size=7, double sigma=0., bool normalize=true);
+  static void gaussianBlur(const vpImage<unsigned char> &I, vpImage<unsigned char>& GI, unsigned int size=7, double sigma=0.);
   /*!
    Apply a 5x5 Gaussian filter to an image pixel.
 
@@ -424,6 +442,8 @@ public:
 
   static void getGaussianKernel(double *filter, unsigned int size, double sigma=0., bool normalize=true);
   static void getGaussianDerivativeKernel(double *filter, unsigned int size, double sigma=0., bool normalize=true);
+  static void getGaussianKernel(float *filter, unsigned int size, double sigma=0., bool normalize=true);
+  static void getGaussianDerivativeKernel(float *filter, unsigned int size, double sigma=0., bool normalize=true);
 
   //fonction renvoyant le gradient en X de l'image I pour traitement pyramidal => dimension /2
   static void getGradX(const vpImage<unsigned char> &I, vpImage<double>& dIx);
@@ -431,6 +451,11 @@ public:
   static void getGradX(const vpImage<double> &I, vpImage<double>& dIx, const double *filter, unsigned int size);
   static void getGradXGauss2D(const vpImage<unsigned char> &I, vpImage<double>& dIx, const double *gaussianKernel,
                               const double *gaussianDerivativeKernel, unsigned  int size);
+  static void getGradX(const vpImage<unsigned char> &I, vpImage<float>& dIx);
+  static void getGradX(const vpImage<unsigned char> &I, vpImage<float>& dIx, const float *filter, unsigned int size);
+  static void getGradX(const vpImage<float> &I, vpImage<float>& dIx, const float *filter, unsigned int size);
+  static void getGradXGauss2D(const vpImage<unsigned char> &I, vpImage<float>& dIx, const float *gaussianKernel,
+                              const float *gaussianDerivativeKernel, unsigned int size);
 
   //fonction renvoyant le gradient en Y de l'image I
   static void getGradY(const vpImage<unsigned char> &I, vpImage<double>& dIy);
@@ -438,6 +463,11 @@ public:
   static void getGradY(const vpImage<double> &I, vpImage<double>& dIy, const double *filter, unsigned int size);
   static void getGradYGauss2D(const vpImage<unsigned char> &I, vpImage<double>& dIy, const double *gaussianKernel,
                               const double *gaussianDerivativeKernel,unsigned  int size);
+  static void getGradY(const vpImage<unsigned char> &I, vpImage<float>& dIy);
+  static void getGradY(const vpImage<unsigned char> &I, vpImage<float>& dIy, const float *filter, unsigned int size);
+  static void getGradY(const vpImage<float> &I, vpImage<float>& dIy, const float *filter, unsigned int size);
+  static void getGradYGauss2D(const vpImage<unsigned char> &I, vpImage<float>& dIy, const float *gaussianKernel,
+                              const float *gaussianDerivativeKernel, unsigned int size);
 
 } ;
 
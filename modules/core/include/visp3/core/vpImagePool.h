@@ -0,0 +1,222 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Pool of image buffers.
+ *
+ *****************************************************************************/
+
+#ifndef vpImagePool_H
+#define vpImagePool_H
+
+/*!
+  \file vpImagePool.h
+
+  \brief Fixed set of image buffers reused by an acquisition loop.
+*/
+
+#include <vector>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpImage.h>
+#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
+#  include <visp3/core/vpMutex.h>
+#endif
+
+/*!
+  \class vpImagePool
+
+  \ingroup group_core_image
+
+  \brief Fixed set of image buffers of the same size that are reused from one
+  frame to the next.
+
+  The buffers are allocated once by init(). acquire() makes an image wrap a
+  free buffer without copy, and release() gives the buffer back to the pool.
+  A grab loop can then fill and process images without any allocation, and
+  images can be handed over to another thread without copying them. acquire()
+  and release() can be called from different threads.
+
+  \code
+#include <visp3/core/vpImagePool.h>
+
+int main()
+{
+  vpImagePool<unsigned char> pool(4, 480, 640);
+
+  vpImage<unsigned char> I;
+  if (pool.acquire(I)) {
+    // Fill and process I, or give it to another thread
+    pool.release(I);
+  }
+}
+  \endcode
+
+  The pool has to outlive the images that wrap its buffers.
+*/
+template<class Type>
+class vpImagePool
+{
+public:
+  vpImagePool();
+  vpImagePool(unsigned int nbBuffers, unsigned int height, unsigned int width);
+
+  bool acquire(vpImage<Type> &I);
+  void init(unsigned int nbBuffers, unsigned int height, unsigned int width);
+  void release(vpImage<Type> &I);
+
+  unsigned int getNbAvailableBuffers();
+  //! Return the number of buffers of the pool.
+  inline unsigned int getNbBuffers() const { return (unsigned int)m_buffers.size(); }
+  //! Return the height of the buffers.
+  inline unsigned int getHeight() const { return m_height; }
+  //! Return the width of the buffers.
+  inline unsigned int getWidth() const { return m_width; }
+
+private:
+  vpImagePool(const vpImagePool &);
+  vpImagePool &operator=(const vpImagePool &);
+
+  std::vector< vpImage<Type> > m_buffers;
+  std::vector<bool> m_available;
+  unsigned int m_height;
+  unsigned int m_width;
+#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
+  vpMutex m_mutex;
+#endif
+};
+
+/*!
+  Default constructor. The pool has no buffer until init() is called.
+*/
+template<class Type>
+vpImagePool<Type>::vpImagePool()
+  : m_buffers(), m_available(), m_height(0), m_width(0)
+#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
+  , m_mutex()
+#endif
+{
+}
+
+/*!
+  Create a pool of \e nbBuffers images of size \e height x \e width.
+  \sa init()
+*/
+template<class Type>
+vpImagePool<Type>::vpImagePool(unsigned int nbBuffers, unsigned int height, unsigned int width)
+  : m_buffers(), m_available(), m_height(0), m_width(0)
+#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
+  , m_mutex()
+#endif
+{
+  init(nbBuffers, height, width);
+}
+
+/*!
+  Allocate \e nbBuffers images of size \e height x \e width. The previous
+  buffers are freed: no image should wrap them anymore.
+*/
+template<class Type>
+void vpImagePool<Type>::init(unsigned int nbBuffers, unsigned int height, unsigned int width)
+{
+#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
+  vpMutex::vpScopedLock lock(m_mutex);
+#endif
+  m_buffers.clear();
+  m_buffers.resize(nbBuffers);
+  for (unsigned int i = 0; i < nbBuffers; i++)
+    m_buffers[i].resize(height, width);
+  m_available.assign(nbBuffers, true);
+  m_height = height;
+  m_width = width;
+}
+
+/*!
+  Make \e I wrap a free buffer of the pool, without allocation nor copy. The
+  content of the buffer is the one of the last image that used it.
+
+  \param I : Image that wraps the buffer until release() is called.
+  \return false if all the buffers are in use, true otherwise.
+*/
+template<class Type>
+bool vpImagePool<Type>::acquire(vpImage<Type> &I)
+{
+#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
+  vpMutex::vpScopedLock lock(m_mutex);
+#endif
+  for (size_t i = 0; i < m_buffers.size(); i++) {
+    if (m_available[i]) {
+      m_available[i] = false;
+      I.wrap(m_buffers[i].bitmap, m_height, m_width);
+      return true;
+    }
+  }
+  return false;
+}
+
+/*!
+  Give back to the pool the buffer wrapped by \e I. \e I is detached from the
+  buffer and doesn't contain any pixel anymore.
+
+  \exception vpException::badValue : If \e I doesn't wrap a buffer of the pool.
+*/
+template<class Type>
+void vpImagePool<Type>::release(vpImage<Type> &I)
+{
+#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
+  vpMutex::vpScopedLock lock(m_mutex);
+#endif
+  for (size_t i = 0; i < m_buffers.size(); i++) {
+    if (m_buffers[i].bitmap == I.bitmap && !m_available[i]) {
+      m_available[i] = true;
+      I.destroy();
+      return;
+    }
+  }
+  throw(vpException(vpException::badValue, "The image doesn't use a buffer of the pool"));
+}
+
+/*!
+  Return the number of buffers that can be acquired.
+*/
+template<class Type>
+unsigned int vpImagePool<Type>::getNbAvailableBuffers()
+{
+#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
+  vpMutex::vpScopedLock lock(m_mutex);
+#endif
+  unsigned int nb = 0;
+  for (size_t i = 0; i < m_available.size(); i++)
+    if (m_available[i])
+      nb++;
+  return nb;
+}
+
+#endif
@@ -0,0 +1,117 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Pyramid of images.
+ *
+ *****************************************************************************/
+
+#ifndef vpImagePyramid_H
+#define vpImagePyramid_H
+
+/*!
+  \file vpImagePyramid.h
+
+  \brief Pyramid of images built by successive downsampling.
+*/
+
+#include <vector>
+
+#include <visp3/core/vpImage.h>
+
+/*!
+  \class vpImagePyramid
+
+  \ingroup group_core_image
+
+  \brief Pyramid of grey level images where the size of each level is half
+  the size of the previous one.
+
+  The level 0 is the input image itself, that is not copied: it has to stay
+  alive as long as the pyramid is used. The other levels are owned by the
+  pyramid and kept between two calls to build(), so that no memory is
+  allocated when successive images of the same size are processed. Each
+  level is computed from the previous one in a single pass over its rows, the
+  horizontal and vertical filtering being fused, and the rows are split
+  between the threads of vpThreadPool.
+
+  The same pyramid can be built once per frame and given to several
+  trackers, for instance vpMbEdgeTracker::track(const vpImagePyramid &) and
+  vpTemplateTracker::track(const vpImagePyramid &).
+
+  \code
+#include <visp3/core/vpImagePyramid.h>
+
+int main()
+{
+  vpImage<unsigned char> I(480, 640);
+  vpImagePyramid pyramid(vpImagePyramid::GAUSSIAN);
+
+  // For each new image I
+  pyramid.build(I, 3);
+  const vpImage<unsigned char> &I2 = pyramid[2]; // 120 x 160 image
+}
+  \endcode
+*/
+class VISP_EXPORT vpImagePyramid
+{
+public:
+  typedef enum {
+    SUBSAMPLING, /*!< Each level keeps one pixel over two of the previous level,
+                      along the rows and the columns. */
+    GAUSSIAN     /*!< Each level is smoothed by the 5 taps Gaussian kernel used by
+                      vpImageFilter::getGaussPyramidal() before being subsampled. */
+  } vpPyramidType;
+
+  explicit vpImagePyramid(vpPyramidType type = GAUSSIAN);
+
+  void build(const vpImage<unsigned char> &I, unsigned int nbLevels);
+  void clear();
+
+  const vpImage<unsigned char> &getLevel(unsigned int level) const;
+  //! Return the number of levels built by the last call to build().
+  inline unsigned int getNbLevels() const { return m_nbLevels; }
+  //! Return the downsampling method.
+  inline vpPyramidType getType() const { return m_type; }
+  void setType(vpPyramidType type);
+
+  /*!
+    Return the image of a given level, 0 being the input image.
+    \sa getLevel()
+  */
+  inline const vpImage<unsigned char> &operator[](unsigned int level) const { return getLevel(level); }
+
+private:
+  vpPyramidType m_type;
+  unsigned int m_nbLevels;
+  const vpImage<unsigned char> *m_I;
+  std::vector< vpImage<unsigned char> > m_levels; // Levels 1 to m_nbLevels-1
+};
+
+#endif
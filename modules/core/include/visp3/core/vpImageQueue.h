@@ -0,0 +1,491 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Bounded queue of timestamped images between an acquisition thread and a
+ * processing thread.
+ *
+ *****************************************************************************/
+
+#ifndef vpImageQueue_H
+#define vpImageQueue_H
+
+/*!
+  \file vpImageQueue.h
+
+  \brief Lock-free single-producer single-consumer queue of timestamped
+  images.
+*/
+
+#include <vector>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpFrameGrabber.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpTime.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+/*
+  Index shared between the producer and the consumer of a vpImageQueue. The
+  accesses are atomic and act as full memory barriers.
+*/
+class VISP_EXPORT vpImageQueueIndex
+{
+public:
+  vpImageQueueIndex() : m_value(0) {}
+
+  unsigned int load() const;
+  void store(unsigned int value);
+  bool compareAndSwap(unsigned int expected, unsigned int value);
+
+private:
+  volatile long m_value;
+};
+#endif
+
+/*!
+  \class vpImageQueue
+
+  \ingroup group_core_image
+
+  \brief Bounded lock-free queue of timestamped images between one
+  acquisition thread (the producer) and one processing thread (the consumer).
+
+  The queue owns a fixed set of image buffers that are allocated once by
+  init(). The producer fills the image returned by getWriteImage() and
+  publishes it with push(); the consumer gets the oldest published image with
+  pop() and gives its buffer back with release(). Images are never copied:
+  the images handed to both sides wrap the buffers of the queue, so that a
+  grabber writes directly in the buffer that the tracker will read.
+
+  Neither push() nor pop() ever blocks on the other thread, so that a slow
+  frame doesn't delay the acquisition of the next ones and the jitter of the
+  acquisition doesn't stall the processing. When the queue is full, push()
+  applies the drop policy given to init():
+  - vpImageQueue::DROP_OLDEST replaces the oldest queued frame by the new one.
+    The consumer always gets the most recent frames, which suits trackers.
+  - vpImageQueue::DROP_NEWEST discards the new frame and keeps the queued
+    ones, which suits recording.
+
+  In both cases the number of dropped frames is counted.
+
+  \code
+#include <visp3/core/vpImageQueue.h>
+#include <visp3/core/vpThread.h>
+#include <visp3/sensor/vpV4l2Grabber.h>
+
+vpV4l2Grabber g;
+vpImageQueue<unsigned char> queue;
+bool stop = false;
+
+vpThread::Return capture(vpThread::Args)
+{
+  while (!stop)
+    queue.push(g); // Acquire in the queue and timestamp the frame
+  return 0;
+}
+
+int main()
+{
+  vpImage<unsigned char> I;
+  g.open(I);
+  queue.init(2, I.getHeight(), I.getWidth(), vpImageQueue<unsigned char>::DROP_OLDEST);
+  vpThread thread(capture);
+
+  double timestamp;
+  for (int i = 0; i < 1000; i++) {
+    if (queue.pop(I, timestamp, 100)) { // Wait for a frame for at most 100 ms
+      // Track in I
+      queue.release(I);
+    }
+  }
+  stop = true;
+  thread.join();
+  std::cout << queue.getNbDroppedFrames() << " frames dropped" << std::endl;
+}
+  \endcode
+
+  Only one thread may call the producer methods getWriteImage() and push(),
+  and only one thread may call the consumer methods pop() and release(). The
+  other methods can be called from any thread, except init() that has to be
+  called before the threads start. The queue has to outlive the images that
+  wrap its buffers.
+*/
+template<class Type>
+class vpImageQueue
+{
+public:
+  /*! Behavior of push() when the queue is full. */
+  typedef enum {
+    DROP_OLDEST, /*!< The oldest queued frame is dropped. */
+    DROP_NEWEST  /*!< The pushed frame is dropped. */
+  } vpDropPolicy;
+
+  vpImageQueue();
+  vpImageQueue(unsigned int capacity, unsigned int height, unsigned int width,
+               const vpDropPolicy policy=DROP_OLDEST);
+
+  void init(unsigned int capacity, unsigned int height, unsigned int width,
+            const vpDropPolicy policy=DROP_OLDEST);
+
+  // Producer
+  /*!
+    Return the image that the producer has to fill before calling push(). The
+    image wraps a buffer of the queue: its size must not be changed.
+  */
+  inline vpImage<Type> &getWriteImage() { return m_writeImage; }
+  bool push(double timestamp);
+  bool push(vpFrameGrabber &grabber);
+
+  // Consumer
+  bool pop(vpImage<Type> &I, double &timestamp, double timeout_ms=0);
+  void release(vpImage<Type> &I);
+
+  //! Return the maximum number of frames that can be queued.
+  inline unsigned int getCapacity() const { return m_capacity; }
+  //! Return the drop policy applied when the queue is full.
+  inline vpDropPolicy getDropPolicy() const { return m_policy; }
+  //! Return the height of the images.
+  inline unsigned int getHeight() const { return m_height; }
+  //! Return the width of the images.
+  inline unsigned int getWidth() const { return m_width; }
+  //! Return the number of frames that were dropped because the queue was full.
+  inline unsigned int getNbDroppedFrames() const { return m_nbDropped.load(); }
+  //! Return the number of frames given to push().
+  inline unsigned int getNbPushedFrames() const { return m_nbPushed.load(); }
+  /*!
+    Return the number of frames waiting in the queue. The value is only a
+    snapshot when the producer or the consumer is running.
+  */
+  inline unsigned int getNbQueuedFrames() const { return m_head.load() - m_tail.load(); }
+
+private:
+  vpImageQueue(const vpImageQueue &);
+  vpImageQueue &operator=(const vpImageQueue &);
+
+  static unsigned int roundUpPowerOfTwo(unsigned int n)
+  {
+    unsigned int p = 1;
+    while (p < n)
+      p <<= 1;
+    return p;
+  }
+  unsigned int takeFreeBuffer();
+
+  //! Image buffers: capacity + one for the producer and one for the consumer.
+  std::vector< vpImage<Type> > m_buffers;
+  //! Acquisition time of the frame in each buffer.
+  std::vector<double> m_timestamps;
+  //! Indexes of the buffers of the queued frames, in a ring.
+  std::vector<unsigned int> m_queue;
+  unsigned int m_queueMask;
+  //! Indexes of the buffers given back by the consumer, in a ring.
+  std::vector<unsigned int> m_free;
+  unsigned int m_freeMask;
+  //! Counter of the frames published by the producer.
+  vpImageQueueIndex m_head;
+  //! Counter of the frames removed from the queue, by pop() or by a drop.
+  vpImageQueueIndex m_tail;
+  //! Counter of the buffers given back by the consumer.
+  vpImageQueueIndex m_freeHead;
+  //! Counter of the buffers taken back by the producer.
+  unsigned int m_freeTail;
+  vpImageQueueIndex m_nbPushed;
+  vpImageQueueIndex m_nbDropped;
+  //! Buffer filled by the producer and the image that wraps it.
+  unsigned int m_writeBuffer;
+  vpImage<Type> m_writeImage;
+  //! Buffer owned by the consumer between pop() and release().
+  unsigned int m_readBuffer;
+  bool m_reading;
+  unsigned int m_capacity;
+  unsigned int m_height;
+  unsigned int m_width;
+  vpDropPolicy m_policy;
+};
+
+/*!
+  Default constructor. The queue can't be used until init() is called.
+*/
+template<class Type>
+vpImageQueue<Type>::vpImageQueue()
+  : m_buffers(), m_timestamps(), m_queue(), m_queueMask(0), m_free(), m_freeMask(0), m_head(), m_tail(), m_freeHead(), m_freeTail(0),
+    m_nbPushed(), m_nbDropped(), m_writeBuffer(0), m_writeImage(), m_readBuffer(0), m_reading(false),
+    m_capacity(0), m_height(0), m_width(0), m_policy(DROP_OLDEST)
+{
+}
+
+/*!
+  Create a queue of at most \e capacity images of size \e height x \e width.
+  \sa init()
+*/
+template<class Type>
+vpImageQueue<Type>::vpImageQueue(unsigned int capacity, unsigned int height, unsigned int width,
+                                 const vpDropPolicy policy)
+  : m_buffers(), m_timestamps(), m_queue(), m_queueMask(0), m_free(), m_freeMask(0), m_head(), m_tail(), m_freeHead(), m_freeTail(0),
+    m_nbPushed(), m_nbDropped(), m_writeBuffer(0), m_writeImage(), m_readBuffer(0), m_reading(false),
+    m_capacity(0), m_height(0), m_width(0), m_policy(DROP_OLDEST)
+{
+  init(capacity, height, width, policy);
+}
+
+/*!
+  Allocate the buffers of a queue of at most \e capacity images of size
+  \e height x \e width, and empty the queue. The previous buffers are freed:
+  no image should wrap them anymore, and neither the producer nor the consumer
+  may be running.
+
+  \param capacity : Maximum number of frames waiting for the consumer. A
+  capacity of 1 gives the lowest latency.
+  \param height, width : Size of the images.
+  \param policy : Frame dropped by push() when the queue is full.
+
+  \exception vpException::badValue : If \e capacity is 0.
+*/
+template<class Type>
+void vpImageQueue<Type>::init(unsigned int capacity, unsigned int height, unsigned int width,
+                              const vpDropPolicy policy)
+{
+  if (capacity == 0) {
+    throw(vpException(vpException::badValue, "The capacity of the queue must be at least 1"));
+  }
+  const unsigned int nbBuffers = capacity + 2;
+
+  m_writeImage.destroy();
+  m_buffers.clear();
+  m_buffers.resize(nbBuffers);
+  for (unsigned int i = 0; i < nbBuffers; i++)
+    m_buffers[i].resize(height, width);
+  m_timestamps.assign(nbBuffers, 0.);
+  // The counters wrap around consistently with rings of 2^n slots
+  m_queueMask = roundUpPowerOfTwo(capacity) - 1;
+  m_queue.assign(m_queueMask + 1, 0);
+  m_freeMask = roundUpPowerOfTwo(nbBuffers) - 1;
+  m_free.assign(m_freeMask + 1, 0);
+
+  // The producer starts with the first buffer, all the others are free
+  for (unsigned int i = 0; i < nbBuffers - 1; i++)
+    m_free[i] = i + 1;
+  m_freeHead.store(nbBuffers - 1);
+  m_freeTail = 0;
+  m_head.store(0);
+  m_tail.store(0);
+  m_nbPushed.store(0);
+  m_nbDropped.store(0);
+  m_writeBuffer = 0;
+  m_writeImage.wrap(m_buffers[0].bitmap, height, width);
+  m_readBuffer = 0;
+  m_reading = false;
+
+  m_capacity = capacity;
+  m_height = height;
+  m_width = width;
+  m_policy = policy;
+}
+
+/*!
+  Take a buffer given back by the consumer. There is always one: the buffers
+  that are neither queued, nor filled by the producer, nor read by the
+  consumer are free.
+*/
+template<class Type>
+unsigned int vpImageQueue<Type>::takeFreeBuffer()
+{
+  // Reading the head makes the slot written by the consumer visible
+  if (m_freeHead.load() == m_freeTail) {
+    throw(vpException(vpException::fatalError, "No free buffer in the image queue"));
+  }
+  unsigned int buffer = m_free[m_freeTail & m_freeMask];
+  m_freeTail++;
+  return buffer;
+}
+
+/*!
+  Publish the image returned by getWriteImage() and give the producer a new
+  image to fill. The call never blocks: when the queue is full, a frame is
+  dropped according to the drop policy.
+
+  \param timestamp : Acquisition time of the image, for instance given by
+  vpTime::measureTimeMs().
+
+  \return false if a frame was dropped, true otherwise.
+
+  \exception vpException::badValue : If the size of the image returned by
+  getWriteImage() was changed.
+
+  \sa push(vpFrameGrabber &)
+*/
+template<class Type>
+bool vpImageQueue<Type>::push(double timestamp)
+{
+  if (m_writeImage.bitmap != m_buffers[m_writeBuffer].bitmap) {
+    m_writeImage.wrap(m_buffers[m_writeBuffer].bitmap, m_height, m_width);
+    throw(vpException(vpException::badValue, "The image to push is not %dx%d", m_height, m_width));
+  }
+  m_nbPushed.store(m_nbPushed.load() + 1);
+  m_timestamps[m_writeBuffer] = timestamp;
+
+  // Only the producer modifies the head
+  const unsigned int head = m_head.load();
+  unsigned int next;
+  bool dropped = false;
+  for (;;) {
+    const unsigned int tail = m_tail.load();
+    if (head - tail < m_capacity) {
+      m_queue[head & m_queueMask] = m_writeBuffer;
+      m_head.store(head + 1);
+      next = takeFreeBuffer();
+      break;
+    }
+
+    if (m_policy == DROP_NEWEST) {
+      // Keep filling the same buffer
+      m_nbDropped.store(m_nbDropped.load() + 1);
+      return false;
+    }
+
+    // Steal the oldest frame unless the consumer pops it first. Its slot is
+    // the one of the new frame, that the consumer can't read before the head
+    // is updated.
+    const unsigned int oldest = m_queue[tail & m_queueMask];
+    if (m_tail.compareAndSwap(tail, tail + 1)) {
+      m_queue[head & m_queueMask] = m_writeBuffer;
+      m_head.store(head + 1);
+      m_nbDropped.store(m_nbDropped.load() + 1);
+      next = oldest;
+      dropped = true;
+      break;
+    }
+    // The consumer made room in the meantime
+  }
+
+  m_writeBuffer = next;
+  m_writeImage.wrap(m_buffers[next].bitmap, m_height, m_width);
+  return !dropped;
+}
+
+/*!
+  Acquire an image from \e grabber in the queue and publish it with the time
+  at which the acquisition ended.
+
+  \code
+  vpImage<unsigned char> &I = queue.getWriteImage();
+  grabber.acquire(I);
+  queue.push(vpTime::measureTimeMs());
+  \endcode
+
+  Only available for images of unsigned char or vpRGBa.
+
+  \return false if a frame was dropped, true otherwise.
+*/
+template<class Type>
+bool vpImageQueue<Type>::push(vpFrameGrabber &grabber)
+{
+  grabber.acquire(m_writeImage);
+  return push(vpTime::measureTimeMs());
+}
+
+/*!
+  Get the oldest frame of the queue. \e I wraps the buffer of the frame, that
+  the producer won't modify until release() is called.
+
+  \param I : Image that wraps the frame. If \e I still wraps the frame of the
+  previous call, this frame is released first.
+  \param timestamp : Acquisition time given to push().
+  \param timeout_ms : Maximum time to wait for a frame if the queue is empty.
+  With a null timeout the call never waits.
+
+  \return false if no frame was available before the timeout, true otherwise.
+
+  \exception vpException::badValue : If the previous frame was not released.
+*/
+template<class Type>
+bool vpImageQueue<Type>::pop(vpImage<Type> &I, double &timestamp, double timeout_ms)
+{
+  if (m_reading) {
+    if (I.bitmap != m_buffers[m_readBuffer].bitmap) {
+      throw(vpException(vpException::badValue, "The previous frame of the queue was not released"));
+    }
+    release(I);
+  }
+
+  double t0 = 0.;
+  bool waiting = false;
+  unsigned int buffer = 0;
+  for (;;) {
+    const unsigned int tail = m_tail.load();
+    if (m_head.load() == tail) {
+      if (!waiting) {
+        if (timeout_ms <= 0)
+          return false;
+        t0 = vpTime::measureTimeMs();
+        waiting = true;
+      }
+      else if (vpTime::measureTimeMs() - t0 >= timeout_ms) {
+        return false;
+      }
+      vpTime::sleepMs(0.1);
+      continue;
+    }
+
+    buffer = m_queue[tail & m_queueMask];
+    // Fails if the producer dropped this frame in the meantime
+    if (m_tail.compareAndSwap(tail, tail + 1))
+      break;
+  }
+
+  m_readBuffer = buffer;
+  m_reading = true;
+  timestamp = m_timestamps[buffer];
+  I.wrap(m_buffers[buffer].bitmap, m_height, m_width);
+  return true;
+}
+
+/*!
+  Give back to the producer the buffer of the frame returned by pop(). \e I
+  is detached from the buffer and doesn't contain any pixel anymore.
+
+  \exception vpException::badValue : If \e I doesn't wrap the frame returned
+  by pop().
+*/
+template<class Type>
+void vpImageQueue<Type>::release(vpImage<Type> &I)
+{
+  if (!m_reading || I.bitmap != m_buffers[m_readBuffer].bitmap) {
+    throw(vpException(vpException::badValue, "The image doesn't wrap the frame returned by the queue"));
+  }
+  const unsigned int freeHead = m_freeHead.load();
+  m_free[freeHead & m_freeMask] = m_readBuffer;
+  m_freeHead.store(freeHead + 1);
+  m_reading = false;
+  I.destroy();
+}
+
+#endif
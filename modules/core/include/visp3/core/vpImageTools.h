@@ -48,20 +48,76 @@
 */
 
 #include <visp3/core/vpImage.h>
-
-#ifdef VISP_HAVE_PTHREAD
-#  include <pthread.h>
-#endif
-
 #include <visp3/core/vpImageException.h>
 #include <visp3/core/vpMath.h>
 #include <visp3/core/vpRect.h>
 #include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpThreadPool.h>
 
 #include <fstream>
 #include <iostream>
 #include <math.h>
 #include <string.h>
+#include <vector>
+
+/*!
+  \class vpUndistortMap
+
+  \ingroup group_core_image
+
+  \brief Lookup table that undistorts images with a given set of camera
+  parameters.
+
+  The map is computed once by vpImageTools::initUndistortMap(). For each
+  pixel of the undistorted image it stores the index of the top-left pixel
+  of the distorted image used for the bilinear interpolation and the
+  interpolation weights in 1/256 fixed point. Undistorting an image with
+  vpImageTools::undistort(const vpImage<unsigned char> &, const vpUndistortMap &, vpImage<unsigned char> &)
+  then only consists in gathering pixels.
+
+  \code
+#include <visp3/core/vpImageTools.h>
+
+int main()
+{
+  vpImage<unsigned char> I(480, 640), U;
+  vpCameraParameters cam;
+  cam.initPersProjWithDistortion(600, 600, 320, 240, -0.17, 0.17);
+
+  vpUndistortMap map;
+  vpImageTools::initUndistortMap(cam, I.getWidth(), I.getHeight(), map);
+
+  // For each new image I
+  vpImageTools::undistort(I, map, U);
+}
+  \endcode
+*/
+class VISP_EXPORT vpUndistortMap
+{
+  friend class vpImageTools;
+
+public:
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+  typedef struct vpUndistortMapEntry {
+    int index;           // Index of the top-left source pixel, -1 if outside
+    short du;            // Weight of the right pixels, in [-256, 256]
+    short dv;            // Weight of the bottom pixels, in [-256, 256]
+  } vpUndistortMapEntry;
+#endif
+
+  vpUndistortMap() : width(0), height(0), copy(false), entries() {}
+
+  //! Return the height of the images that can be undistorted with the map.
+  inline unsigned int getHeight() const { return height; }
+  //! Return the width of the images that can be undistorted with the map.
+  inline unsigned int getWidth() const { return width; }
+
+private:
+  unsigned int width;
+  unsigned int height;
+  bool copy; // true when there is no distortion
+  std::vector<vpUndistortMapEntry> entries;
+};
 
 /*!
   \class vpImageTools
@@ -71,6 +127,15 @@
   \brief Various image tools; sub-image extraction, modification of
   the look up table, binarisation...
 
+  changeLUT(), undistort(), flip(), imageDifference() and
+  imageDifferenceAbsolute() process bands of rows in parallel, using the
+  threads of vpThreadPool.
+
+  When several images are undistorted with the same camera parameters,
+  prefer initUndistortMap() followed by
+  undistort(const vpImage<unsigned char> &, const vpUndistortMap &, vpImage<unsigned char> &)
+  that avoid to evaluate the distortion model for each pixel of each image.
+
 */
 class VISP_EXPORT vpImageTools
 {
@@ -103,6 +168,18 @@ public:
                         const vpCameraParameters &cam,
                         vpImage<Type> &newI);
 
+  static void initUndistortMap(const vpCameraParameters &cam,
+                               unsigned int width, unsigned int height,
+                               vpUndistortMap &map);
+
+  static void undistort(const vpImage<unsigned char> &I,
+                        const vpUndistortMap &map,
+                        vpImage<unsigned char> &undistI);
+
+  static void undistort(const vpImage<vpRGBa> &I,
+                        const vpUndistortMap &map,
+                        vpImage<vpRGBa> &undistI);
+
   template<class Type>
   static void flip(const vpImage<Type> &I,
                         vpImage<Type> &newI);
@@ -276,50 +353,31 @@ inline void vpImageTools::binarise(vpImage<unsigned char> &I,
   }
 }
 
-#ifdef VISP_HAVE_PTHREAD
-
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 template<class Type>
 class vpUndistortInternalType
 {
 public:
-  Type *src;
+  const Type *src;
   Type *dst;
   unsigned int width;
   unsigned int height;
   vpCameraParameters cam;
-  unsigned int nthreads;
-  unsigned int threadid;
 public:
   vpUndistortInternalType()
-    : src(NULL), dst(NULL), width(0), height(0), cam(), nthreads(0), threadid(0)
+    : src(NULL), dst(NULL), width(0), height(0), cam()
   {};
 
-  vpUndistortInternalType(const vpUndistortInternalType<Type> &u) {
-    *this = u;
-  };
-  vpUndistortInternalType &operator=(const vpUndistortInternalType<Type> &u) {
-    src = u.src;
-    dst = u.dst;
-    width = u.width;
-    height = u.height;
-    cam = u.cam;
-    nthreads = u.nthreads;
-    threadid = u.threadid;
-  }
-
-  static void *vpUndistort_threaded(void *arg);
+  static void vpUndistort_band(unsigned int begin, unsigned int end, void *arg);
 };
 
 
 template<class Type>
-void *vpUndistortInternalType<Type>::vpUndistort_threaded(void *arg)
+void vpUndistortInternalType<Type>::vpUndistort_band(unsigned int begin, unsigned int end, void *arg)
 {
   vpUndistortInternalType<Type> *undistortSharedData = (vpUndistortInternalType<Type>*)arg;
-  int offset   = (int)undistortSharedData->threadid;
   int width    = (int)undistortSharedData->width;
   int height   = (int)undistortSharedData->height;
-  int nthreads = (int)undistortSharedData->nthreads;
 
   double u0 = undistortSharedData->cam.get_u0();
   double v0 = undistortSharedData->cam.get_v0();
@@ -333,10 +391,10 @@ void *vpUndistortInternalType<Type>::vpUndistort_threaded(void *arg)
   double kud_px2 = kud * invpx * invpx;
   double kud_py2 = kud * invpy * invpy;
 
-  Type *dst = undistortSharedData->dst+(height/nthreads*offset)*width;
-  Type *src = undistortSharedData->src;
+  Type *dst = undistortSharedData->dst+begin*(unsigned int)width;
+  const Type *src = undistortSharedData->src;
 
-  for (double v = height/nthreads*offset;v < height/nthreads*(offset+1) ; v++) {
+  for (double v = begin;v < end ; v++) {
     double  deltav  = v - v0;
     //double fr1 = 1.0 + kd * (vpMath::sqr(deltav * invpy));
     double fr1 = 1.0 + kud_py2 * deltav * deltav;
@@ -362,26 +420,75 @@ void *vpUndistortInternalType<Type>::vpUndistort_threaded(void *arg)
       Type v01;
       Type v23;
       if ( (0 <= u_round) && (0 <= v_round) &&
-	   (u_round < ((width) - 1)) && (v_round < ((height) - 1)) ) {
-	//process interpolation
-	const Type* _mp = &src[v_round*width+u_round];
-	v01 = (Type)(_mp[0] + ((_mp[1] - _mp[0]) * du_double));
-	_mp += width;
-	v23 = (Type)(_mp[0] + ((_mp[1] - _mp[0]) * du_double));
-	*dst = (Type)(v01 + ((v23 - v01) * dv_double));
+           (u_round < ((width) - 1)) && (v_round < ((height) - 1)) ) {
+        //process interpolation
+        const Type* _mp = &src[v_round*width+u_round];
+        v01 = (Type)(_mp[0] + ((_mp[1] - _mp[0]) * du_double));
+        _mp += width;
+        v23 = (Type)(_mp[0] + ((_mp[1] - _mp[0]) * du_double));
+        *dst = (Type)(v01 + ((v23 - v01) * dv_double));
       }
       else {
-	*dst = 0;
+        *dst = 0;
       }
       dst++;
     }
   }
+}
 
-  pthread_exit((void*) 0);
-  return NULL;
+template<class Type>
+class vpFlipInternalType
+{
+public:
+  const Type *src;
+  Type *dst;
+  unsigned int width;
+  unsigned int height;
+public:
+  vpFlipInternalType()
+    : src(NULL), dst(NULL), width(0), height(0)
+  {};
+
+  static void vpFlip_band(unsigned int begin, unsigned int end, void *arg);
+  static void vpFlipInPlace_band(unsigned int begin, unsigned int end, void *arg);
+};
+
+template<class Type>
+void vpFlipInternalType<Type>::vpFlip_band(unsigned int begin, unsigned int end, void *arg)
+{
+  vpFlipInternalType<Type> *flipSharedData = (vpFlipInternalType<Type>*)arg;
+  unsigned int width = flipSharedData->width;
+  unsigned int height = flipSharedData->height;
+
+  for (unsigned int i = begin; i < end; i++)
+  {
+    memcpy(flipSharedData->dst+i*width, flipSharedData->src+(height-1-i)*width,
+           width*sizeof(Type));
+  }
+}
+
+// Swaps the rows i and height-1-i for i in [begin, end)
+template<class Type>
+void vpFlipInternalType<Type>::vpFlipInPlace_band(unsigned int begin, unsigned int end, void *arg)
+{
+  vpFlipInternalType<Type> *flipSharedData = (vpFlipInternalType<Type>*)arg;
+  unsigned int width = flipSharedData->width;
+  unsigned int height = flipSharedData->height;
+  Type *bitmap = flipSharedData->dst;
+  vpImage<Type> Ibuf;
+  Ibuf.resize(1, width);
+
+  for (unsigned int i = begin; i < end; i++)
+  {
+    memcpy(Ibuf.bitmap, bitmap+i*width,
+           width*sizeof(Type));
+    memcpy(bitmap+i*width, bitmap+(height-1-i)*width,
+           width*sizeof(Type));
+    memcpy(bitmap+(height-1-i)*width, Ibuf.bitmap,
+           width*sizeof(Type));
+  }
 }
 #endif // DOXYGEN_SHOULD_SKIP_THIS
-#endif // VISP_HAVE_PTHREAD
 
 /*!
   Undistort an image
@@ -401,76 +508,19 @@ void *vpUndistortInternalType<Type>::vpUndistort_threaded(void *arg)
   \warning This function is time consuming :
     - On "Rhea"(Intel Core 2 Extreme X6800 2.93GHz, 2Go RAM)
       or "Charon"(Intel Xeon 3 GHz, 2Go RAM) : ~8 ms for a 640x480 image.
+    When the camera parameters do not change between images, use rather
+    initUndistortMap() and undistort(const vpImage<unsigned char> &, const vpUndistortMap &, vpImage<unsigned char> &).
 */
 template<class Type>
 void vpImageTools::undistort(const vpImage<Type> &I,
                              const vpCameraParameters &cam,
                              vpImage<Type> &undistI)
 {
-#ifdef VISP_HAVE_PTHREAD
-  //
-  // Optimized version using pthreads
-  //
-  unsigned int width = I.getWidth();
-  unsigned int height = I.getHeight();
-
-  undistI.resize(height, width);
-
-  double kud = cam.get_kud();
-
-  //if (kud == 0) {
-  if (std::fabs(kud) <= std::numeric_limits<double>::epsilon()) {
-    // There is no need to undistort the image
-    undistI = I;
-    return;
-  }
-
-  unsigned int nthreads = 2;
-  pthread_attr_t attr;
-  pthread_t *callThd = new pthread_t [nthreads];
-  pthread_attr_init(&attr);
-  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
-
-  vpUndistortInternalType<Type> *undistortSharedData;
-  undistortSharedData = new vpUndistortInternalType<Type> [nthreads];
-
-  for(unsigned int i=0;i<nthreads;i++) {
-    // Each thread works on a different set of data.
-    //    vpTRACE("create thread %d", i);
-    undistortSharedData[i].src      = I.bitmap;
-    undistortSharedData[i].dst      = undistI.bitmap;
-    undistortSharedData[i].width    = I.getWidth();
-    undistortSharedData[i].height   = I.getHeight();
-    undistortSharedData[i].cam      = cam;
-    undistortSharedData[i].nthreads = nthreads;
-    undistortSharedData[i].threadid = i;
-    pthread_create( &callThd[i], &attr,
-		    &vpUndistortInternalType<Type>::vpUndistort_threaded,
-		    &undistortSharedData[i]);
-  }
-  pthread_attr_destroy(&attr);
-  /* Wait on the other threads */
-
-  for(unsigned int i=0;i<nthreads;i++) {
-    //  vpTRACE("join thread %d", i);
-    pthread_join( callThd[i], NULL);
-  }
-
-  delete [] callThd;
-  delete [] undistortSharedData;
-#else // VISP_HAVE_PTHREAD
-  //
-  // optimized version without pthreads
-  //
   unsigned int width = I.getWidth();
   unsigned int height = I.getHeight();
 
   undistI.resize(height, width);
 
-  double u0 = cam.get_u0();
-  double v0 = cam.get_v0();
-  double px = cam.get_px();
-  double py = cam.get_py();
   double kud = cam.get_kud();
 
   //if (kud == 0) {
@@ -480,60 +530,16 @@ void vpImageTools::undistort(const vpImage<Type> &I,
     return;
   }
 
-  double invpx = 1.0/px;
-  double invpy = 1.0/py;
-
-  double kud_px2 = kud * invpx * invpx;
-  double kud_py2 = kud * invpy * invpy;
-
-  Type *dst = undistI.bitmap;
-  for (double v = 0;v < height ; v++) {
-    double  deltav  = v - v0;
-    //double fr1 = 1.0 + kd * (vpMath::sqr(deltav * invpy));
-    double fr1 = 1.0 + kud_py2 * deltav * deltav;
-
-    for (double u = 0 ; u < width ; u++) {
-      //computation of u,v : corresponding pixel coordinates in I.
-      double  deltau  = u - u0;
-      //double fr2 = fr1 + kd * (vpMath::sqr(deltau * invpx));
-      double fr2 = fr1 + kud_px2 * deltau * deltau;
-
-      double u_double = deltau * fr2 + u0;
-      double v_double = deltav * fr2 + v0;
-
-      //printf("[%g][%g] %g %g : ", u, v, u_double, v_double );
-
-      //computation of the bilinear interpolation
-
-      //declarations
-      int u_round  = (int) (u_double);
-      int v_round  = (int) (v_double);
-      if (u_round < 0.f) u_round = -1;
-      if (v_round < 0.f) v_round = -1;
-      double  du_double  = (u_double) - (double) u_round;
-      double  dv_double  = (v_double) - (double) v_round;
-      Type  v01;
-      Type  v23;
-      if ( (0 <= u_round) && (0 <= v_round) &&
-           (u_round < (((int)width) - 1)) && (v_round < (((int)height) - 1)) ) {
-        //process interpolation
-        const Type* _mp = &I[(unsigned int)v_round][(unsigned int)u_round];
-        v01 = (Type)(_mp[0] + ((_mp[1] - _mp[0]) * du_double));
-        _mp += width;
-        v23 = (Type)(_mp[0] + ((_mp[1] - _mp[0]) * du_double));
-        *dst = (Type)(v01 + ((v23 - v01) * dv_double));
-        //printf("R %d G %d B %d\n", dst->R, dst->G, dst->B);
-      }
-      else {
-        *dst = 0;
-      }
-      dst++;
-    }
-  }
-#endif // VISP_HAVE_PTHREAD
-
-
+  vpUndistortInternalType<Type> undistortSharedData;
+  undistortSharedData.src    = I.bitmap;
+  undistortSharedData.dst    = undistI.bitmap;
+  undistortSharedData.width  = width;
+  undistortSharedData.height = height;
+  undistortSharedData.cam    = cam;
 
+  // Bands of at least 8192 pixels
+  vpThreadPool::parallelFor(0, height, &vpUndistortInternalType<Type>::vpUndistort_band, &undistortSharedData,
+                            8192 / (width + 1) + 1);
 
 #if 0
   // non optimized version
@@ -583,11 +589,15 @@ void vpImageTools::flip(const vpImage<Type> &I,
     width = I.getWidth();
     newI.resize(height, width);
 
-    for (unsigned int i = 0; i < height; i++)
-    {
-      memcpy(newI.bitmap+i*width, I.bitmap+(height-1-i)*width,
-	     width*sizeof(Type));
-    }
+    vpFlipInternalType<Type> flipSharedData;
+    flipSharedData.src = I.bitmap;
+    flipSharedData.dst = newI.bitmap;
+    flipSharedData.width = width;
+    flipSharedData.height = height;
+
+    // Bands of at least 64 KB
+    vpThreadPool::parallelFor(0, height, &vpFlipInternalType<Type>::vpFlip_band, &flipSharedData,
+                              65536 / (width*sizeof(Type) + 1) + 1);
 }
 
 
@@ -625,23 +635,19 @@ template<class Type>
 void vpImageTools::flip(vpImage<Type> &I)
 {
     unsigned int height = 0, width = 0;
-    unsigned int i = 0;
-    vpImage<Type> Ibuf;
 
     height = I.getHeight();
     width = I.getWidth();
-    Ibuf.resize(1, width);
 
-    for ( i = 0; i < height/2; i++)
-    {
-      memcpy(Ibuf.bitmap, I.bitmap+i*width,
-  	            width*sizeof(Type));
+    vpFlipInternalType<Type> flipSharedData;
+    flipSharedData.src = I.bitmap;
+    flipSharedData.dst = I.bitmap;
+    flipSharedData.width = width;
+    flipSharedData.height = height;
 
-      memcpy(I.bitmap+i*width, I.bitmap+(height-1-i)*width,
-  	            width*sizeof(Type));
-      memcpy(I.bitmap+(height-1-i)*width, Ibuf.bitmap,
-  	            width*sizeof(Type));
-    }
+    // Bands of at least 64 KB, each row swap moving two rows
+    vpThreadPool::parallelFor(0, height/2, &vpFlipInternalType<Type>::vpFlipInPlace_band, &flipSharedData,
+                              32768 / (width*sizeof(Type) + 1) + 1);
 }
 
 #endif
@@ -120,6 +120,11 @@ class VISP_EXPORT vpMatrix : public vpArray2D<double>
     \param val : Each element of the matrix is set to \e val.
   */
   vpMatrix(unsigned int r, unsigned int c, double val) : vpArray2D<double>(r, c, val) {};
+  //! Copy constructor.
+  vpMatrix(const vpMatrix &M) : vpArray2D<double>(M) {};
+#ifdef VISP_HAVE_CPP11_COMPATIBILITY
+  vpMatrix(vpMatrix &&M);
+#endif
   vpMatrix(const vpMatrix &M, unsigned int r, unsigned int c,
            unsigned int nrows, unsigned int ncols) ;
   /*!
@@ -177,6 +182,10 @@ class VISP_EXPORT vpMatrix : public vpArray2D<double>
   //@{
   vpMatrix &operator<<(double*);
   vpMatrix &operator=(const vpArray2D<double> &A);
+  vpMatrix &operator=(const vpMatrix &A);
+#ifdef VISP_HAVE_CPP11_COMPATIBILITY
+  vpMatrix &operator=(vpMatrix &&A);
+#endif
   vpMatrix &operator=(const double x);
   //@}
 
@@ -39,6 +39,9 @@
 #define vpNetwork_H
 
 #include <visp3/core/vpConfig.h>
+#include <visp3/core/vpArray2D.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpRGBa.h>
 #include <visp3/core/vpRequest.h>
 
 #include <vector>
@@ -70,6 +73,19 @@
   TCP provides reliable, ordered delivery of a stream of bytes from a program 
   on one computer to another program on another computer.
   
+  Besides raw objects and string requests, images and matrices can be
+  exchanged as binary messages with sendImage(), sendMatrix(), receiveImage()
+  and receiveMatrix(). Each message is prefixed by a header giving its type,
+  its size and the length of its payload. The payload is sent as it is in
+  memory, in the same system call as the header, and received directly in the
+  destination image or matrix: there is no string encoding nor copy. Both
+  sides have to know which kind of message comes next, and these messages
+  shouldn't be mixed with raw objects or requests on the same connection.
+
+  Under Linux, the sockets are watched with epoll, that doesn't limit the
+  number of connections and doesn't scan them all at each call. The other
+  systems use select().
+
   \warning This class shouldn't be used directly. You better use vpClient and
   vpServer to simulate your network. Some exemples are provided in these classes.
 
@@ -122,6 +138,7 @@ protected:
 #else
   SOCKET                  socketMax;
 #endif
+  int                     epollFileDescriptor;
   
   //Message Handling 
   std::vector<vpRequest*> request_list;
@@ -140,8 +157,18 @@ protected:
   
   bool                    verboseMode;
   
+  void              _addReceptor(const vpReceptor &rec);
+  void              _removeReceptor(const unsigned int &index);
+  int               _waitForData(std::vector<unsigned int> &readyReceptors, const int &receptorIndex = -1,
+                                 bool *emitterReady = NULL);
+
 private:
-  
+  // The epoll descriptor is owned and closed by the destructor
+  vpNetwork(const vpNetwork &);
+  vpNetwork &operator=(const vpNetwork &);
+
+  std::vector<char> receiveBuffer;
+
   std::vector<int>  _handleRequests();
   int               _handleFirstRequest();
   
@@ -149,6 +176,15 @@ private:
   void              _receiveRequestFrom(const unsigned int &receptorEmitting);
   int               _receiveRequestOnce();
   int               _receiveRequestOnceFrom(const unsigned int &receptorEmitting);
+
+  int               _receiveAll(const unsigned int &index, char *buffer, const size_t &size);
+  int               _receiveMessage(const int &receptorEmitting, const unsigned int &type, const size_t &sizeOfElement,
+                                    unsigned int &index, unsigned int &rows, unsigned int &cols);
+  int               _receiveMatrix(vpArray2D<double> &M, const int &receptorEmitting);
+  template<class Type>
+  int               _receiveImage(vpImage<Type> &I, const int &receptorEmitting, const unsigned int &type);
+  int               _sendMessageTo(const unsigned int &type, const unsigned int &rows, const unsigned int &cols,
+                                   const char *payload, const size_t &size, const unsigned int &dest);
   
 public:
 
@@ -193,6 +229,13 @@ public:
   int               receiveRequestOnce();
   int               receiveRequestOnceFrom(const unsigned int &receptorEmitting);
   
+  int               receiveImage(vpImage<unsigned char> &I);
+  int               receiveImage(vpImage<vpRGBa> &I);
+  int               receiveImageFrom(vpImage<unsigned char> &I, const unsigned int &receptorEmitting);
+  int               receiveImageFrom(vpImage<vpRGBa> &I, const unsigned int &receptorEmitting);
+  int               receiveMatrix(vpArray2D<double> &M);
+  int               receiveMatrixFrom(vpArray2D<double> &M, const unsigned int &receptorEmitting);
+
   std::vector<int>  receiveAndDecodeRequest();
   std::vector<int>  receiveAndDecodeRequestFrom(const unsigned int &receptorEmitting);
   int               receiveAndDecodeRequestOnce();
@@ -205,6 +248,13 @@ public:
   template<typename T>
   int               sendTo(T* object, const unsigned int &dest, const unsigned int &sizeOfObject = sizeof(T));
   
+  int               sendImage(const vpImage<unsigned char> &I);
+  int               sendImage(const vpImage<vpRGBa> &I);
+  int               sendImageTo(const vpImage<unsigned char> &I, const unsigned int &dest);
+  int               sendImageTo(const vpImage<vpRGBa> &I, const unsigned int &dest);
+  int               sendMatrix(const vpArray2D<double> &M);
+  int               sendMatrixTo(const vpArray2D<double> &M, const unsigned int &dest);
+
   int               sendRequest(vpRequest &req);
   int               sendRequestTo(vpRequest &req, const unsigned int &dest);
   
@@ -281,21 +331,8 @@ int vpNetwork::receive(T* object, const unsigned int &sizeOfObject)
     return -1;
   }
   
-  tv.tv_sec = tv_sec;
-  tv.tv_usec = tv_usec;
-  
-  FD_ZERO(&readFileDescriptor);        
-  
-  for(unsigned int i=0; i<receptor_list.size(); i++){
-    FD_SET((unsigned int)receptor_list[i].socketFileDescriptorReceptor,&readFileDescriptor);
-
-    if(i == 0)
-      socketMax = receptor_list[i].socketFileDescriptorReceptor;
-   
-    if(socketMax < receptor_list[i].socketFileDescriptorReceptor) socketMax = receptor_list[i].socketFileDescriptorReceptor; 
-  }
-
-  int value = select((int)socketMax+1,&readFileDescriptor,NULL,NULL,&tv);
+  std::vector<unsigned int> ready;
+  int value = _waitForData(ready);
   int numbytes = 0;
   
   if(value == -1){
@@ -308,22 +345,17 @@ int vpNetwork::receive(T* object, const unsigned int &sizeOfObject)
     return 0;
   }
   else{
-    for(unsigned int i=0; i<receptor_list.size(); i++){
-      if(FD_ISSET((unsigned int)receptor_list[i].socketFileDescriptorReceptor,&readFileDescriptor)){
+    unsigned int i = ready[0];
 #if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
-        numbytes = recv(receptor_list[i].socketFileDescriptorReceptor, (char*)(void*)object, sizeOfObject, 0);
+    numbytes = recv(receptor_list[i].socketFileDescriptorReceptor, (char*)(void*)object, sizeOfObject, 0);
 #else
-        numbytes = recv((unsigned int)receptor_list[i].socketFileDescriptorReceptor, (char*)(void*)object, (int)sizeOfObject, 0);
+    numbytes = recv((unsigned int)receptor_list[i].socketFileDescriptorReceptor, (char*)(void*)object, (int)sizeOfObject, 0);
 #endif
-        if(numbytes <= 0)
-        {
-          std::cout << "Disconnected : " << inet_ntoa(receptor_list[i].receptorAddress.sin_addr) << std::endl;
-          receptor_list.erase(receptor_list.begin()+(int)i);
-          return numbytes;
-        }
-        
-        break;
-      }
+    if(numbytes <= 0)
+    {
+      std::cout << "Disconnected : " << inet_ntoa(receptor_list[i].receptorAddress.sin_addr) << std::endl;
+      _removeReceptor(i);
+      return numbytes;
     }
   }
   
@@ -361,15 +393,8 @@ int vpNetwork::receiveFrom(T* object, const unsigned int &receptorEmitting, cons
     return -1;
   }
   
-  tv.tv_sec = tv_sec;
-  tv.tv_usec = tv_usec;
-  
-  FD_ZERO(&readFileDescriptor);
-  
-  socketMax = receptor_list[receptorEmitting].socketFileDescriptorReceptor;
-  FD_SET((unsigned int)receptor_list[receptorEmitting].socketFileDescriptorReceptor,&readFileDescriptor);
-    
-  int value = select((int)socketMax+1,&readFileDescriptor,NULL,NULL,&tv);
+  std::vector<unsigned int> ready;
+  int value = _waitForData(ready, (int)receptorEmitting);
   int numbytes = 0;
   
   if(value == -1){
@@ -382,18 +407,16 @@ int vpNetwork::receiveFrom(T* object, const unsigned int &receptorEmitting, cons
     return 0;
   }
   else{
-    if(FD_ISSET((unsigned int)receptor_list[receptorEmitting].socketFileDescriptorReceptor,&readFileDescriptor)){
 #if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
-      numbytes = recv(receptor_list[receptorEmitting].socketFileDescriptorReceptor, (char*)(void*)object, sizeOfObject, 0);
+    numbytes = recv(receptor_list[receptorEmitting].socketFileDescriptorReceptor, (char*)(void*)object, sizeOfObject, 0);
 #else
-      numbytes = recv((unsigned int)receptor_list[receptorEmitting].socketFileDescriptorReceptor, (char*)(void*)object, (int)sizeOfObject, 0);
+    numbytes = recv((unsigned int)receptor_list[receptorEmitting].socketFileDescriptorReceptor, (char*)(void*)object, (int)sizeOfObject, 0);
 #endif
-      if(numbytes <= 0)
-      {
-        std::cout << "Disconnected : " << inet_ntoa(receptor_list[receptorEmitting].receptorAddress.sin_addr) << std::endl;
-        receptor_list.erase(receptor_list.begin()+(int)receptorEmitting);
-        return numbytes;
-      }
+    if(numbytes <= 0)
+    {
+      std::cout << "Disconnected : " << inet_ntoa(receptor_list[receptorEmitting].receptorAddress.sin_addr) << std::endl;
+      _removeReceptor(receptorEmitting);
+      return numbytes;
     }
   }
   
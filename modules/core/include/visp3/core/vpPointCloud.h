@@ -0,0 +1,204 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Organized point cloud stored in contiguous arrays.
+ *
+ *****************************************************************************/
+
+#ifndef vpPointCloud_H
+#define vpPointCloud_H
+
+/*!
+  \file vpPointCloud.h
+
+  \brief Organized point cloud stored in contiguous arrays.
+*/
+
+#include <limits>
+#include <vector>
+
+#include <stdint.h>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpColVector.h>
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpRGBa.h>
+
+/*!
+  \class vpPointCloud
+
+  \ingroup group_core_camera
+
+  \brief Organized point cloud built from a depth map, with one point per
+  pixel of the depth map.
+
+  Unlike a std::vector<vpColVector>, that allocates each point separately,
+  the coordinates are stored in three contiguous arrays of floats (X, Y and
+  Z, in meter, expressed in the depth camera frame) organized as the depth
+  map: the point at row \e i and column \e j has the index \e i * getWidth()
+  + \e j. An optional array of colors and a mask of the valid points follow
+  the same organization. The arrays are kept when the point cloud is filled
+  again with the same size, so that filling a point cloud at each frame
+  doesn't allocate memory.
+
+  A point is valid when its depth Z is positive and not greater than the
+  maximal depth. The coordinates of the invalid points are set to 0.
+
+  The deprojection of the depth map is computed with the rays of the depth
+  camera, i.e. the normalized coordinates \f$(x, y)\f$ of each pixel that
+  depend only on the intrinsic parameters and are computed once with
+  computeRays(). A point is then given by \f$(X, Y, Z) = (x Z, y Z, Z)\f$,
+  which buildFrom() computes with SIMD instructions when the CPU supports
+  them (SSE2 or NEON).
+
+  \code
+#include <visp3/core/vpPointCloud.h>
+
+int main()
+{
+  vpCameraParameters cam(600, 600, 320, 240);
+  vpImage<uint16_t> depth(480, 640, 1000); // Depth in mm
+
+  std::vector<float> raysX, raysY;
+  vpPointCloud::computeRays(cam, depth.getHeight(), depth.getWidth(), raysX, raysY);
+
+  vpPointCloud pointcloud;
+  pointcloud.buildFrom(depth, 0.001f, raysX, raysY);
+
+  const float *X = pointcloud.getX();
+  const float *Y = pointcloud.getY();
+  const float *Z = pointcloud.getZ();
+  const unsigned char *valid = pointcloud.getValidMask();
+  for (unsigned int k = 0; k < pointcloud.size(); k++) {
+    if (valid[k]) {
+      // Use X[k], Y[k], Z[k]
+    }
+  }
+}
+  \endcode
+*/
+class VISP_EXPORT vpPointCloud
+{
+public:
+  vpPointCloud();
+  vpPointCloud(const unsigned int height, const unsigned int width, const bool withColor=false);
+
+  void buildFrom(const uint16_t *depth, const unsigned int height, const unsigned int width, const float depthScale,
+                 const std::vector<float> &raysX, const std::vector<float> &raysY,
+                 const float maxZ=std::numeric_limits<float>::max());
+  void buildFrom(const vpImage<uint16_t> &depth, const float depthScale,
+                 const std::vector<float> &raysX, const std::vector<float> &raysY,
+                 const float maxZ=std::numeric_limits<float>::max());
+  void buildFrom(const float *depth, const unsigned int height, const unsigned int width,
+                 const std::vector<float> &raysX, const std::vector<float> &raysY,
+                 const float maxZ=std::numeric_limits<float>::max());
+  void buildFrom(const vpImage<float> &depth,
+                 const std::vector<float> &raysX, const std::vector<float> &raysY,
+                 const float maxZ=std::numeric_limits<float>::max());
+
+  void clear();
+
+  static void computeRays(const vpCameraParameters &cam, const unsigned int height, const unsigned int width,
+                          std::vector<float> &raysX, std::vector<float> &raysY);
+
+  //! Return true if the point cloud has no point.
+  inline bool empty() const { return m_Z.empty(); }
+
+  void enableColor(const bool enable);
+
+  /*!
+    Return the colors of the points, or NULL if the point cloud has no
+    color.
+    \sa hasColor(), enableColor()
+  */
+  inline vpRGBa *getColor() { return m_color.empty() ? NULL : &m_color[0]; }
+  //! \sa getColor()
+  inline const vpRGBa *getColor() const { return m_color.empty() ? NULL : &m_color[0]; }
+  //! Return the height of the point cloud, i.e. the height of the depth map.
+  inline unsigned int getHeight() const { return m_height; }
+  //! Return the number of valid points.
+  inline unsigned int getNbValidPoints() const { return m_nbValid; }
+  vpColVector getPoint(const unsigned int i, const unsigned int j) const;
+  /*!
+    Return the mask of the valid points: 1 for a valid point, 0 otherwise.
+  */
+  inline unsigned char *getValidMask() { return m_valid.empty() ? NULL : &m_valid[0]; }
+  //! \sa getValidMask()
+  inline const unsigned char *getValidMask() const { return m_valid.empty() ? NULL : &m_valid[0]; }
+  //! Return the width of the point cloud, i.e. the width of the depth map.
+  inline unsigned int getWidth() const { return m_width; }
+  //! Return the X coordinates of the points.
+  inline float *getX() { return m_X.empty() ? NULL : &m_X[0]; }
+  //! Return the X coordinates of the points.
+  inline const float *getX() const { return m_X.empty() ? NULL : &m_X[0]; }
+  //! Return the Y coordinates of the points.
+  inline float *getY() { return m_Y.empty() ? NULL : &m_Y[0]; }
+  //! Return the Y coordinates of the points.
+  inline const float *getY() const { return m_Y.empty() ? NULL : &m_Y[0]; }
+  //! Return the Z coordinates of the points.
+  inline float *getZ() { return m_Z.empty() ? NULL : &m_Z[0]; }
+  //! Return the Z coordinates of the points.
+  inline const float *getZ() const { return m_Z.empty() ? NULL : &m_Z[0]; }
+
+  //! Return true if the point cloud stores the color of the points.
+  inline bool hasColor() const { return m_withColor; }
+
+  /*!
+    Return true if the point at row \e i and column \e j is valid.
+  */
+  inline bool isValid(const unsigned int i, const unsigned int j) const
+  {
+    return m_valid[i*m_width + j] != 0;
+  }
+
+  void resize(const unsigned int height, const unsigned int width);
+
+  //! Return the number of points, valid or not.
+  inline unsigned int size() const { return m_height*m_width; }
+
+private:
+  void allocate(const unsigned int height, const unsigned int width);
+  static void checkRays(const std::vector<float> &raysX, const std::vector<float> &raysY,
+                        const unsigned int height, const unsigned int width);
+
+  unsigned int m_height;
+  unsigned int m_width;
+  bool m_withColor;
+  unsigned int m_nbValid;
+  std::vector<float> m_X;
+  std::vector<float> m_Y;
+  std::vector<float> m_Z;
+  std::vector<vpRGBa> m_color;
+  std::vector<unsigned char> m_valid;
+};
+
+#endif
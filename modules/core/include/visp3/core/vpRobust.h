@@ -77,6 +77,8 @@ private:
   vpColVector sorted_normres;
   //!Sorted residues
   vpColVector sorted_residues;
+  //!Normalized residues of all the residues (see MEstimator(const vpRobustEstimatorType, const vpColVector &, const vpColVector &, vpColVector &))
+  vpColVector all_normres;
 
   //!Noise threshold
   double NoiseThreshold;
@@ -0,0 +1,156 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Reader of the images of a shared memory segment.
+ *
+ *****************************************************************************/
+
+#ifndef vpSharedImageReader_H
+#define vpSharedImageReader_H
+
+/*!
+  \file vpSharedImageReader.h
+
+  \brief Frame grabber reading the images published by another process
+  through shared memory.
+*/
+
+#include <string>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpFrameGrabber.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpRGBa.h>
+
+#if defined(VISP_HAVE_PTHREAD) && !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
+
+/*!
+  \class vpSharedImageReader
+
+  \ingroup group_core_network
+
+  \brief Frame grabber that reads the images published by a
+  vpSharedImageWriter of the same computer.
+
+  acquire() waits for a frame more recent than the previous one and returns
+  the latest published frame: frames published in the meantime are skipped and
+  counted. When the image has the type of the images of the writer, it wraps
+  the shared memory without copy and the writer won't reuse the slot until the
+  next call to acquire(), release() or close(). The pixels are mapped
+  read-only: the image must not be modified. Otherwise the image is converted.
+
+  Up to 32 readers, in the same process or not, can read the same segment at
+  the same time. If the process of a reader dies while it holds a frame, its
+  slot is given back when the writer needs it or when another reader opens
+  the segment. The readers have to run in the same PID namespace as the
+  writer, since they are identified by their process id.
+
+  \code
+#include <visp3/core/vpSharedImageReader.h>
+
+int main()
+{
+  vpSharedImageReader reader("/camera");
+  vpImage<unsigned char> I;
+  reader.open(I);
+
+  for (int i = 0; i < 1000; i++) {
+    reader.acquire(I); // Wait for the next frame
+    // Track in I, acquired at reader.getTimestamp()
+  }
+  std::cout << reader.getNbSkippedFrames() << " frames skipped" << std::endl;
+  reader.close();
+}
+  \endcode
+
+  \sa vpSharedImageWriter
+*/
+class VISP_EXPORT vpSharedImageReader : public vpFrameGrabber
+{
+public:
+  vpSharedImageReader();
+  vpSharedImageReader(const std::string &name);
+  virtual ~vpSharedImageReader();
+
+  void acquire(vpImage<unsigned char> &I);
+  void acquire(vpImage<vpRGBa> &I);
+
+  void close();
+
+  //! Return the name of the shared memory segment.
+  inline std::string getName() const { return m_name; }
+  //! Return the number of frames published but not acquired since the first acquired one.
+  inline unsigned long getNbSkippedFrames() const { return m_nbSkipped; }
+  //! Return the sequence number of the last acquired frame.
+  inline unsigned long getSequence() const { return m_sequence; }
+  //! Return the timeout of acquire() in ms, negative for no timeout.
+  inline double getTimeout() const { return m_timeout; }
+  //! Return the acquisition time of the last acquired frame given by the writer.
+  inline double getTimestamp() const { return m_timestamp; }
+
+  void open(vpImage<unsigned char> &I);
+  void open(vpImage<vpRGBa> &I);
+
+  void release();
+
+  //! Set the name of the shared memory segment given to vpSharedImageWriter::open().
+  inline void setName(const std::string &name) { m_name = name; }
+  /*!
+    Set the maximum time acquire() waits for a frame. By default it is 1000 ms.
+
+    \param timeout_ms : Timeout in ms, or a negative value to wait forever.
+  */
+  inline void setTimeout(const double timeout_ms) { m_timeout = timeout_ms; }
+
+private:
+  vpSharedImageReader(const vpSharedImageReader &);
+  vpSharedImageReader &operator=(const vpSharedImageReader &);
+
+  void open();
+  const unsigned char *waitForFrame();
+
+  std::string m_name;
+  void *m_segment;
+  size_t m_segmentSize;
+  const unsigned char *m_bitmaps;
+  size_t m_bitmapsSize;
+  unsigned int m_bytesPerPixel;
+  //! Descriptor of the reader in the segment, -1 if none.
+  int m_reader;
+  //! Slot held by the reader, -1 if none.
+  int m_slot;
+  unsigned long m_sequence;
+  unsigned long m_nbSkipped;
+  double m_timestamp;
+  double m_timeout;
+};
+
+#endif
+#endif
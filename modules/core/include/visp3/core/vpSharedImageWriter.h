@@ -0,0 +1,152 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Writer of images in a shared memory segment.
+ *
+ *****************************************************************************/
+
+#ifndef vpSharedImageWriter_H
+#define vpSharedImageWriter_H
+
+/*!
+  \file vpSharedImageWriter.h
+
+  \brief Publication of images to other processes through shared memory.
+*/
+
+#include <string>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpRGBa.h>
+#include <visp3/core/vpTime.h>
+
+#if defined(VISP_HAVE_PTHREAD) && !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
+
+/*!
+  \class vpSharedImageWriter
+
+  \ingroup group_core_network
+
+  \brief Publish images to the processes of the same computer through a POSIX
+  shared memory segment.
+
+  The segment is a ring of image slots. Each published frame gets a sequence
+  number and a timestamp, and wakes up the vpSharedImageReader that wait for
+  it. Any number of readers can read the frames at the same time without copy:
+  a reader maps the same memory, and the writer never modifies a slot that a
+  reader is using. When the readers are slower than the writer, they get the
+  latest frame and skip the older ones; the writer is never blocked by them.
+
+  The images can be written without copy with getWriteImage() and push(), for
+  instance by a grabber, or copied with write().
+
+  \code
+#include <visp3/core/vpSharedImageWriter.h>
+#include <visp3/sensor/vpV4l2Grabber.h>
+
+int main()
+{
+  vpV4l2Grabber g;
+  vpImage<unsigned char> I;
+  g.open(I);
+
+  vpSharedImageWriter writer;
+  writer.open("/camera", I); // Segment of the size and the type of I
+
+  for (int i = 0; i < 1000; i++) {
+    if (writer.getWriteImage(I)) { // I wraps a free slot
+      g.acquire(I);
+      writer.push(vpTime::measureTimeMs());
+    }
+  }
+  writer.close();
+}
+  \endcode
+
+  The number of slots has to be greater than the number of readers plus one,
+  otherwise all the slots may be in use when the writer needs one. Readers that
+  open the segment before the writer (re)creates it have to open it again.
+
+  A reader whose process dies while it holds a frame, without closing the
+  segment, would keep its slot forever. The writer releases the slots of dead
+  readers when all the slots are used, see releaseDeadReaders(). Under Linux, the
+  mutex that wakes up the readers is robust, so that a reader that dies while
+  waiting for a frame doesn't block the writer.
+
+  \sa vpSharedImageReader
+*/
+class VISP_EXPORT vpSharedImageWriter
+{
+public:
+  vpSharedImageWriter();
+  virtual ~vpSharedImageWriter();
+
+  void close();
+
+  bool getWriteImage(vpImage<unsigned char> &I);
+  bool getWriteImage(vpImage<vpRGBa> &I);
+
+  //! Return the name of the shared memory segment.
+  inline std::string getName() const { return m_name; }
+  //! Return the number of slots of the segment.
+  inline unsigned int getNbSlots() const { return m_nbSlots; }
+  //! Return the sequence number of the latest frame, 0 if none was published.
+  inline unsigned long getSequence() const { return m_sequence; }
+
+  void open(const std::string &name, const vpImage<unsigned char> &I, const unsigned int nbSlots=4);
+  void open(const std::string &name, const vpImage<vpRGBa> &I, const unsigned int nbSlots=4);
+
+  unsigned long push(const double timestamp);
+
+  unsigned int releaseDeadReaders();
+
+  unsigned long write(const vpImage<unsigned char> &I, const double timestamp);
+  unsigned long write(const vpImage<vpRGBa> &I, const double timestamp);
+
+private:
+  vpSharedImageWriter(const vpSharedImageWriter &);
+  vpSharedImageWriter &operator=(const vpSharedImageWriter &);
+
+  void open(const std::string &name, const unsigned int height, const unsigned int width,
+            const unsigned int bytesPerPixel, const unsigned int nbSlots);
+  unsigned char *reserve(const unsigned int height, const unsigned int width, const unsigned int bytesPerPixel);
+
+  std::string m_name;
+  void *m_segment;
+  size_t m_size;
+  unsigned int m_nbSlots;
+  //! Slot reserved by getWriteImage(), -1 if none.
+  int m_slot;
+  unsigned long m_sequence;
+};
+
+#endif
+#endif
@@ -0,0 +1,107 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Pool of worker threads shared by the image processing functions.
+ *
+ *****************************************************************************/
+
+#ifndef __vpThreadPool_h_
+#define __vpThreadPool_h_
+
+#include <visp3/core/vpConfig.h>
+
+/*!
+  \class vpThreadPool
+
+  \ingroup group_core_threading
+
+  \brief Pool of worker threads used to split a loop into bands processed in
+  parallel.
+
+  The worker threads are created once, the first time they are needed, and
+  kept alive until the end of the program, so that the cost of a parallel
+  loop is only a wake-up of the workers. This pool is shared by the image
+  processing functions of ViSP (vpImageConvert, vpImageTools, ...).
+
+  The number of threads is global. By default it is equal to the number of
+  cores of the machine and can be changed with setNumThreads(). When only one
+  thread is used, or when ViSP is built without pthread or Windows threading
+  capabilities, the loops are executed sequentially by the calling thread.
+
+  A loop is described by a function that processes a range of indexes:
+  \code
+#include <visp3/core/vpThreadPool.h>
+
+struct Data {
+  const float *src;
+  float *dst;
+};
+
+void scaleBand(unsigned int begin, unsigned int end, void *arg)
+{
+  Data *data = static_cast<Data *>(arg);
+  for (unsigned int i = begin; i < end; i++)
+    data->dst[i] = 2.f * data->src[i];
+}
+
+int main()
+{
+  float src[1000], dst[1000];
+  // ...
+  Data data;
+  data.src = src;
+  data.dst = dst;
+  vpThreadPool::setNumThreads(4);
+  // Bands of at least 100 elements
+  vpThreadPool::parallelFor(0, 1000, scaleBand, &data, 100);
+}
+  \endcode
+
+  A call to parallelFor() from a task that is already executed by the pool, or
+  from another thread while the pool is busy, is executed sequentially by the
+  calling thread.
+*/
+class VISP_EXPORT vpThreadPool
+{
+public:
+  /*!
+    Function processing the indexes in [\e begin, \e end). \e arg is the
+    pointer given to parallelFor().
+   */
+  typedef void (*Task)(unsigned int begin, unsigned int end, void *arg);
+
+  static unsigned int getNumCores();
+  static unsigned int getNumThreads();
+  static void parallelFor(unsigned int begin, unsigned int end, vpThreadPool::Task task, void *arg,
+                          unsigned int min_band_size=1);
+  static void setNumThreads(unsigned int nthreads);
+};
+
+#endif
@@ -61,8 +61,6 @@ class VISP_EXPORT vpTriangle
     double uvinv01;
     double uvinv10;
     double uvinv11;
-    double ptempo0;
-    double ptempo1;
     double area;
     vpImagePoint apex1;
     vpImagePoint apex2;
@@ -79,7 +77,7 @@ class VISP_EXPORT vpTriangle
     
     void buildFrom(const vpImagePoint &iP1, const vpImagePoint &iP2, const vpImagePoint &iP3);
     
-    bool inTriangle(const vpImagePoint &iP, double threshold = 0.00001);
+    bool inTriangle(const vpImagePoint &iP, double threshold = 0.00001) const;
     
     /*!
       Get the apexes of the triangle.
@@ -0,0 +1,476 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Organized point cloud stored in contiguous arrays.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpPointCloud.cpp
+  \brief Organized point cloud stored in contiguous arrays.
+*/
+
+#include <visp3/core/vpCPUFeatures.h>
+#include <visp3/core/vpPixelMeterConversion.h>
+#include <visp3/core/vpPointCloud.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+// As in vpImageConvert, the x86 kernels are built whatever the compiler flags
+// are, thanks to the target attribute, and selected at runtime. The NEON
+// kernels are enabled at build time.
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#  define VISP_SIMD_X86 1
+#  define VP_TARGET_SSE2
+#elif (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))) \
+  && (defined(__i386__) || defined(__x86_64__))
+#  define VISP_SIMD_X86 1
+#  define VP_TARGET_SSE2 __attribute__((target("sse2")))
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  define VISP_SIMD_NEON 1
+#endif
+
+#if defined(VISP_SIMD_X86)
+#  include <emmintrin.h>
+#elif defined(VISP_SIMD_NEON)
+#  include <arm_neon.h>
+#endif
+
+/*
+  The kernels deproject the longest prefix of the depth map they can process
+  with full vectors and return the number of points they computed (0 when no
+  suitable instruction set is available). The remaining points are computed
+  by the scalar code, which is the reference: the invalid points are masked
+  to +0 after the multiplications so that the kernels are bit-exact with it.
+*/
+
+namespace {
+
+#if defined(VISP_SIMD_X86)
+
+// Number of bits set in the 8 lowest bits of b
+inline unsigned int countBits8(unsigned int b)
+{
+  b = b - ((b >> 1) & 0x55);
+  b = (b & 0x33) + ((b >> 2) & 0x33);
+  return (b + (b >> 4)) & 0x0f;
+}
+
+// Deproject 4 points and return the mask of the valid ones
+VP_TARGET_SSE2 inline __m128 deproject4_sse2(const __m128 &z, const float *raysX, const float *raysY,
+                                             const __m128 &maxZ, float *X, float *Y, float *Z)
+{
+  const __m128 valid = _mm_and_ps(_mm_cmpgt_ps(z, _mm_setzero_ps()), _mm_cmple_ps(z, maxZ));
+  _mm_storeu_ps(X, _mm_and_ps(_mm_mul_ps(z, _mm_loadu_ps(raysX)), valid));
+  _mm_storeu_ps(Y, _mm_and_ps(_mm_mul_ps(z, _mm_loadu_ps(raysY)), valid));
+  _mm_storeu_ps(Z, _mm_and_ps(z, valid));
+  return valid;
+}
+
+// Store the mask of 8 points as 0 or 1 bytes and return the number of valid points
+VP_TARGET_SSE2 inline unsigned int storeValid8_sse2(const __m128 &valid0, const __m128 &valid1, unsigned char *valid)
+{
+  __m128i v = _mm_packs_epi32(_mm_castps_si128(valid0), _mm_castps_si128(valid1));
+  v = _mm_and_si128(_mm_packs_epi16(v, v), _mm_set1_epi8(1));
+  _mm_storel_epi64((__m128i *) valid, v);
+  return countBits8((unsigned int) (_mm_movemask_ps(valid0) | (_mm_movemask_ps(valid1) << 4)));
+}
+
+VP_TARGET_SSE2 unsigned int deprojectU16_sse2(const uint16_t *depth, float depthScale, const float *raysX,
+                                              const float *raysY, float maxZ, float *X, float *Y, float *Z,
+                                              unsigned char *valid, unsigned int size, unsigned int &nbValid)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128 scale = _mm_set1_ps(depthScale);
+  const __m128 max_z = _mm_set1_ps(maxZ);
+  unsigned int i = 0;
+  for (; i + 8 <= size; i += 8) {
+    const __m128i d = _mm_loadu_si128((const __m128i *)(depth + i));
+    const __m128 z0 = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(d, zero)), scale);
+    const __m128 z1 = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(d, zero)), scale);
+    const __m128 valid0 = deproject4_sse2(z0, raysX + i, raysY + i, max_z, X + i, Y + i, Z + i);
+    const __m128 valid1 = deproject4_sse2(z1, raysX + i + 4, raysY + i + 4, max_z, X + i + 4, Y + i + 4, Z + i + 4);
+    nbValid += storeValid8_sse2(valid0, valid1, valid + i);
+  }
+  return i;
+}
+
+VP_TARGET_SSE2 unsigned int deprojectFloat_sse2(const float *depth, const float *raysX, const float *raysY,
+                                                float maxZ, float *X, float *Y, float *Z,
+                                                unsigned char *valid, unsigned int size, unsigned int &nbValid)
+{
+  const __m128 max_z = _mm_set1_ps(maxZ);
+  unsigned int i = 0;
+  for (; i + 8 <= size; i += 8) {
+    const __m128 valid0 = deproject4_sse2(_mm_loadu_ps(depth + i), raysX + i, raysY + i, max_z,
+                                          X + i, Y + i, Z + i);
+    const __m128 valid1 = deproject4_sse2(_mm_loadu_ps(depth + i + 4), raysX + i + 4, raysY + i + 4, max_z,
+                                          X + i + 4, Y + i + 4, Z + i + 4);
+    nbValid += storeValid8_sse2(valid0, valid1, valid + i);
+  }
+  return i;
+}
+
+#elif defined(VISP_SIMD_NEON)
+
+// Deproject 4 points and return the mask of the valid ones
+inline uint32x4_t deproject4_neon(const float32x4_t &z, const float *raysX, const float *raysY,
+                                  const float32x4_t &maxZ, float *X, float *Y, float *Z)
+{
+  const uint32x4_t valid = vandq_u32(vcgtq_f32(z, vdupq_n_f32(0.f)), vcleq_f32(z, maxZ));
+  vst1q_f32(X, vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(vmulq_f32(z, vld1q_f32(raysX))), valid)));
+  vst1q_f32(Y, vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(vmulq_f32(z, vld1q_f32(raysY))), valid)));
+  vst1q_f32(Z, vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(z), valid)));
+  return valid;
+}
+
+// Store the mask of 8 points as 0 or 1 bytes and return the number of valid points
+inline unsigned int storeValid8_neon(const uint32x4_t &valid0, const uint32x4_t &valid1, unsigned char *valid)
+{
+  const uint8x8_t v = vand_u8(vmovn_u16(vcombine_u16(vmovn_u32(valid0), vmovn_u32(valid1))), vdup_n_u8(1));
+  vst1_u8(valid, v);
+  return (unsigned int) vget_lane_u64(vpaddl_u32(vpaddl_u16(vpaddl_u8(v))), 0);
+}
+
+unsigned int deprojectU16_neon(const uint16_t *depth, float depthScale, const float *raysX,
+                               const float *raysY, float maxZ, float *X, float *Y, float *Z,
+                               unsigned char *valid, unsigned int size, unsigned int &nbValid)
+{
+  const float32x4_t scale = vdupq_n_f32(depthScale);
+  const float32x4_t max_z = vdupq_n_f32(maxZ);
+  unsigned int i = 0;
+  for (; i + 8 <= size; i += 8) {
+    const uint16x8_t d = vld1q_u16(depth + i);
+    const float32x4_t z0 = vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(d))), scale);
+    const float32x4_t z1 = vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(d))), scale);
+    const uint32x4_t valid0 = deproject4_neon(z0, raysX + i, raysY + i, max_z, X + i, Y + i, Z + i);
+    const uint32x4_t valid1 = deproject4_neon(z1, raysX + i + 4, raysY + i + 4, max_z, X + i + 4, Y + i + 4, Z + i + 4);
+    nbValid += storeValid8_neon(valid0, valid1, valid + i);
+  }
+  return i;
+}
+
+unsigned int deprojectFloat_neon(const float *depth, const float *raysX, const float *raysY,
+                                 float maxZ, float *X, float *Y, float *Z,
+                                 unsigned char *valid, unsigned int size, unsigned int &nbValid)
+{
+  const float32x4_t max_z = vdupq_n_f32(maxZ);
+  unsigned int i = 0;
+  for (; i + 8 <= size; i += 8) {
+    const uint32x4_t valid0 = deproject4_neon(vld1q_f32(depth + i), raysX + i, raysY + i, max_z,
+                                              X + i, Y + i, Z + i);
+    const uint32x4_t valid1 = deproject4_neon(vld1q_f32(depth + i + 4), raysX + i + 4, raysY + i + 4, max_z,
+                                              X + i + 4, Y + i + 4, Z + i + 4);
+    nbValid += storeValid8_neon(valid0, valid1, valid + i);
+  }
+  return i;
+}
+
+#endif
+
+unsigned int deprojectU16_simd(const uint16_t *depth, float depthScale, const float *raysX, const float *raysY,
+                               float maxZ, float *X, float *Y, float *Z, unsigned char *valid,
+                               unsigned int size, unsigned int &nbValid)
+{
+#if defined(VISP_SIMD_X86)
+  if (vpCPUFeatures::checkSSE2())
+    return deprojectU16_sse2(depth, depthScale, raysX, raysY, maxZ, X, Y, Z, valid, size, nbValid);
+  return 0;
+#elif defined(VISP_SIMD_NEON)
+  return deprojectU16_neon(depth, depthScale, raysX, raysY, maxZ, X, Y, Z, valid, size, nbValid);
+#else
+  (void)depth; (void)depthScale; (void)raysX; (void)raysY; (void)maxZ;
+  (void)X; (void)Y; (void)Z; (void)valid; (void)size; (void)nbValid;
+  return 0;
+#endif
+}
+
+unsigned int deprojectFloat_simd(const float *depth, const float *raysX, const float *raysY,
+                                 float maxZ, float *X, float *Y, float *Z, unsigned char *valid,
+                                 unsigned int size, unsigned int &nbValid)
+{
+#if defined(VISP_SIMD_X86)
+  if (vpCPUFeatures::checkSSE2())
+    return deprojectFloat_sse2(depth, raysX, raysY, maxZ, X, Y, Z, valid, size, nbValid);
+  return 0;
+#elif defined(VISP_SIMD_NEON)
+  return deprojectFloat_neon(depth, raysX, raysY, maxZ, X, Y, Z, valid, size, nbValid);
+#else
+  (void)depth; (void)raysX; (void)raysY; (void)maxZ;
+  (void)X; (void)Y; (void)Z; (void)valid; (void)size; (void)nbValid;
+  return 0;
+#endif
+}
+
+// Scalar reference of the kernels
+inline void deprojectPoint(float z, float rayX, float rayY, float maxZ, float &X, float &Y, float &Z,
+                           unsigned char &valid, unsigned int &nbValid)
+{
+  if (z > 0.f && z <= maxZ) {
+    X = z * rayX;
+    Y = z * rayY;
+    Z = z;
+    valid = 1;
+    nbValid++;
+  }
+  else {
+    X = Y = Z = 0.f;
+    valid = 0;
+  }
+}
+
+}
+
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Default constructor that builds an empty point cloud without color.
+*/
+vpPointCloud::vpPointCloud()
+  : m_height(0), m_width(0), m_withColor(false), m_nbValid(0), m_X(), m_Y(), m_Z(), m_color(), m_valid()
+{
+}
+
+/*!
+  Build a point cloud of \e height x \e width invalid points.
+
+  \param height, width : Size of the point cloud, i.e. of the depth map.
+  \param withColor : If true, the point cloud stores the color of the points.
+*/
+vpPointCloud::vpPointCloud(const unsigned int height, const unsigned int width, const bool withColor)
+  : m_height(0), m_width(0), m_withColor(withColor), m_nbValid(0), m_X(), m_Y(), m_Z(), m_color(), m_valid()
+{
+  resize(height, width);
+}
+
+/*!
+  Resize the point cloud to \e height x \e width points. The memory is kept
+  when the number of points doesn't increase. After a resize, all the points
+  are invalid and their coordinates are set to 0.
+
+  \param height, width : Size of the point cloud, i.e. of the depth map.
+*/
+void vpPointCloud::resize(const unsigned int height, const unsigned int width)
+{
+  allocate(height, width);
+  m_X.assign(m_X.size(), 0.f);
+  m_Y.assign(m_Y.size(), 0.f);
+  m_Z.assign(m_Z.size(), 0.f);
+  m_valid.assign(m_valid.size(), 0);
+}
+
+// Resize the arrays without initializing them
+void vpPointCloud::allocate(const unsigned int height, const unsigned int width)
+{
+  const unsigned int size = height * width;
+  m_height = height;
+  m_width = width;
+  m_X.resize(size);
+  m_Y.resize(size);
+  m_Z.resize(size);
+  m_color.resize(m_withColor ? size : 0);
+  m_valid.resize(size);
+  m_nbValid = 0;
+}
+
+/*!
+  Remove all the points. The memory is released.
+*/
+void vpPointCloud::clear()
+{
+  m_height = m_width = 0;
+  m_nbValid = 0;
+  std::vector<float>().swap(m_X);
+  std::vector<float>().swap(m_Y);
+  std::vector<float>().swap(m_Z);
+  std::vector<vpRGBa>().swap(m_color);
+  std::vector<unsigned char>().swap(m_valid);
+}
+
+/*!
+  Enable or disable the storage of the color of the points. The colors are
+  filled by the sensors (see vpRealSense::acquire() or
+  vpKinect::getPointCloud()), buildFrom() doesn't modify them.
+
+  \param enable : If true, getColor() gives access to an array of
+  getHeight() x getWidth() colors.
+*/
+void vpPointCloud::enableColor(const bool enable)
+{
+  m_withColor = enable;
+  m_color.resize(m_withColor ? size() : 0);
+}
+
+/*!
+  Compute the rays of a depth camera, i.e. the normalized coordinates
+  \f$(x, y)\f$ of all the pixels of the depth map, that are then given to
+  buildFrom(). The distortion of the camera, if any, is taken into account.
+
+  \param cam : Intrinsic parameters of the depth camera.
+  \param height, width : Size of the depth map.
+  \param raysX, raysY : Normalized coordinates \e x and \e y of the pixels,
+  organized as the depth map.
+*/
+void vpPointCloud::computeRays(const vpCameraParameters &cam, const unsigned int height, const unsigned int width,
+                               std::vector<float> &raysX, std::vector<float> &raysY)
+{
+  raysX.resize(height * width);
+  raysY.resize(height * width);
+  double x = 0., y = 0.;
+  for (unsigned int i = 0; i < height; i++) {
+    for (unsigned int j = 0; j < width; j++) {
+      vpPixelMeterConversion::convertPoint(cam, (double) j, (double) i, x, y);
+      raysX[i*width + j] = (float) x;
+      raysY[i*width + j] = (float) y;
+    }
+  }
+}
+
+void vpPointCloud::checkRays(const std::vector<float> &raysX, const std::vector<float> &raysY,
+                             const unsigned int height, const unsigned int width)
+{
+  if (raysX.size() != height * width || raysY.size() != height * width) {
+    throw(vpException(vpException::dimensionError,
+                      "The rays (%u, %u) don't match the size of the depth map (%ux%u)",
+                      (unsigned int) raysX.size(), (unsigned int) raysY.size(), height, width));
+  }
+}
+
+/*!
+  Build the point cloud from a raw depth map, as given by RGB-D sensors.
+
+  \param depth : Raw depth map of \e height x \e width values.
+  \param height, width : Size of the depth map.
+  \param depthScale : Scale that converts a raw depth value in meter.
+  \param raysX, raysY : Rays of the depth camera, see computeRays().
+  \param maxZ : Maximal depth in meter of the valid points.
+
+  \exception vpException::dimensionError : If the size of the rays doesn't
+  match the size of the depth map.
+*/
+void vpPointCloud::buildFrom(const uint16_t *depth, const unsigned int height, const unsigned int width,
+                             const float depthScale, const std::vector<float> &raysX,
+                             const std::vector<float> &raysY, const float maxZ)
+{
+  checkRays(raysX, raysY, height, width);
+  allocate(height, width);
+  if (empty())
+    return;
+
+  const unsigned int n = size();
+  unsigned int i = deprojectU16_simd(depth, depthScale, &raysX[0], &raysY[0], maxZ,
+                                     &m_X[0], &m_Y[0], &m_Z[0], &m_valid[0], n, m_nbValid);
+  for (; i < n; i++) {
+    deprojectPoint(depth[i] * depthScale, raysX[i], raysY[i], maxZ, m_X[i], m_Y[i], m_Z[i], m_valid[i], m_nbValid);
+  }
+}
+
+/*!
+  Build the point cloud from a raw depth map, as given by RGB-D sensors.
+
+  \param depth : Raw depth map.
+  \param depthScale : Scale that converts a raw depth value in meter.
+  \param raysX, raysY : Rays of the depth camera, see computeRays().
+  \param maxZ : Maximal depth in meter of the valid points.
+
+  \exception vpException::dimensionError : If the size of the rays doesn't
+  match the size of the depth map.
+*/
+void vpPointCloud::buildFrom(const vpImage<uint16_t> &depth, const float depthScale,
+                             const std::vector<float> &raysX, const std::vector<float> &raysY, const float maxZ)
+{
+  buildFrom(depth.bitmap, depth.getHeight(), depth.getWidth(), depthScale, raysX, raysY, maxZ);
+}
+
+/*!
+  Build the point cloud from a metric depth map.
+
+  \param depth : Depth map of \e height x \e width values in meter. Values
+  that are not positive, such as the -1 of vpKinect, give invalid points.
+  \param height, width : Size of the depth map.
+  \param raysX, raysY : Rays of the depth camera, see computeRays().
+  \param maxZ : Maximal depth in meter of the valid points.
+
+  \exception vpException::dimensionError : If the size of the rays doesn't
+  match the size of the depth map.
+*/
+void vpPointCloud::buildFrom(const float *depth, const unsigned int height, const unsigned int width,
+                             const std::vector<float> &raysX, const std::vector<float> &raysY, const float maxZ)
+{
+  checkRays(raysX, raysY, height, width);
+  allocate(height, width);
+  if (empty())
+    return;
+
+  const unsigned int n = size();
+  unsigned int i = deprojectFloat_simd(depth, &raysX[0], &raysY[0], maxZ,
+                                       &m_X[0], &m_Y[0], &m_Z[0], &m_valid[0], n, m_nbValid);
+  for (; i < n; i++) {
+    deprojectPoint(depth[i], raysX[i], raysY[i], maxZ, m_X[i], m_Y[i], m_Z[i], m_valid[i], m_nbValid);
+  }
+}
+
+/*!
+  Build the point cloud from a metric depth map.
+
+  \param depth : Depth map in meter.
+  \param raysX, raysY : Rays of the depth camera, see computeRays().
+  \param maxZ : Maximal depth in meter of the valid points.
+
+  \exception vpException::dimensionError : If the size of the rays doesn't
+  match the size of the depth map.
+*/
+void vpPointCloud::buildFrom(const vpImage<float> &depth,
+                             const std::vector<float> &raysX, const std::vector<float> &raysY, const float maxZ)
+{
+  buildFrom(depth.bitmap, depth.getHeight(), depth.getWidth(), raysX, raysY, maxZ);
+}
+
+/*!
+  Return the point at row \e i and column \e j.
+
+  \return A 4-dimension column vector with the X, Y, Z, 1 coordinates of the
+  point, as the points returned in a std::vector<vpColVector> by
+  vpRealSense::acquire().
+*/
+vpColVector vpPointCloud::getPoint(const unsigned int i, const unsigned int j) const
+{
+  if (i >= m_height || j >= m_width) {
+    throw(vpException(vpException::dimensionError, "Point (%u, %u) outside of the %ux%u point cloud",
+                      i, j, m_height, m_width));
+  }
+  vpColVector p(4);
+  const unsigned int k = i*m_width + j;
+  p[0] = m_X[k];
+  p[1] = m_Y[k];
+  p[2] = m_Z[k];
+  p[3] = 1;
+  return p;
+}
@@ -49,19 +49,134 @@
 // image
 #include <visp3/core/vpImageConvert.h>
 
-#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
-#  include <emmintrin.h>
-#  define VISP_HAVE_SSE2 1
-
-#  if defined __SSE3__ || (defined _MSC_VER && _MSC_VER >= 1500)
-#    include <pmmintrin.h>
-#    define VISP_HAVE_SSE3 1
-#  endif
-#  if defined __SSSE3__  || (defined _MSC_VER && _MSC_VER >= 1500)
-#    include <tmmintrin.h>
-#    define VISP_HAVE_SSSE3 1
-#  endif
-#endif
+#include <visp3/core/vpThreadPool.h>
+
+#include "vpImageConvert_simd.h"
+
+namespace {
+// Number of pixels below which a conversion is not split between threads:
+// waking up the workers would cost more than the conversion itself
+const unsigned int vpMinPixelsPerBand = 1 << 16;
+
+// Conversion of a contiguous set of pixels
+typedef void (*vpPixelConversion)(unsigned char *src, unsigned char *dst, unsigned int size);
+
+struct vpPixelConversionData
+{
+  vpPixelConversion conversion;
+  unsigned char *src;
+  unsigned char *dst;
+  unsigned int src_step; // Bytes per pixel in src
+  unsigned int dst_step; // Bytes per pixel in dst
+  unsigned int unit;     // Number of pixels converted together (macro pixel)
+  unsigned int size;
+  unsigned int width;    // Used by line based conversions
+  unsigned int height;
+  bool flip;
+};
+
+void convertPixelBand(unsigned int begin, unsigned int end, void *arg)
+{
+  const vpPixelConversionData *data = static_cast<const vpPixelConversionData *>(arg);
+  unsigned int first = begin * data->unit;
+  // The last band also gets the pixels that do not fill a macro pixel
+  unsigned int last = (end == (data->size + data->unit - 1) / data->unit) ? data->size : end * data->unit;
+  data->conversion(data->src + first * data->src_step, data->dst + first * data->dst_step, last - first);
+}
+
+/*
+  Apply a conversion to size pixels, in parallel bands of macro pixels of
+  unit pixels.
+ */
+void convertPixels(vpPixelConversion conversion, unsigned char *src, unsigned int src_step,
+                   unsigned char *dst, unsigned int dst_step, unsigned int size, unsigned int unit = 1)
+{
+  vpPixelConversionData data;
+  data.conversion = conversion;
+  data.src = src;
+  data.dst = dst;
+  data.src_step = src_step;
+  data.dst_step = dst_step;
+  data.unit = unit;
+  data.size = size;
+  data.width = 0;
+  data.height = 0;
+  data.flip = false;
+  vpThreadPool::parallelFor(0, (size + unit - 1) / unit, convertPixelBand, &data, vpMinPixelsPerBand / unit);
+}
+
+void convertLineBand(unsigned int begin, unsigned int end, void *arg)
+{
+  const vpPixelConversionData *data = static_cast<const vpPixelConversionData *>(arg);
+  for (unsigned int i = begin; i < end; i++) {
+    unsigned int src_line = data->flip ? data->height - 1 - i : i;
+    data->conversion(data->src + src_line * data->width * data->src_step, data->dst + i * data->width * data->dst_step,
+                     data->width);
+  }
+}
+
+/*
+  Apply a conversion line by line, in parallel bands of lines. When flip is
+  true, the last line of src gives the first line of dst.
+ */
+void convertLines(vpPixelConversion conversion, unsigned char *src, unsigned int src_step,
+                  unsigned char *dst, unsigned int dst_step, unsigned int width, unsigned int height, bool flip)
+{
+  if (!flip) {
+    convertPixels(conversion, src, src_step, dst, dst_step, width * height);
+    return;
+  }
+  vpPixelConversionData data;
+  data.conversion = conversion;
+  data.src = src;
+  data.dst = dst;
+  data.src_step = src_step;
+  data.dst_step = dst_step;
+  data.unit = 1;
+  data.size = width * height;
+  data.width = width;
+  data.height = height;
+  data.flip = flip;
+  vpThreadPool::parallelFor(0, height, convertLineBand, &data, width > 0 ? vpMinPixelsPerBand / width + 1 : 1);
+}
+
+// Conversion of npairs pairs of lines of a planar YUV 4:2:0 image
+typedef void (*vpYUV420Conversion)(unsigned char *y, unsigned char *u, unsigned char *v, unsigned char *dst,
+                                   unsigned int width, unsigned int npairs);
+
+struct vpYUV420ConversionData
+{
+  vpYUV420Conversion conversion;
+  unsigned char *y;
+  unsigned char *u;
+  unsigned char *v;
+  unsigned char *dst;
+  unsigned int dst_step;
+  unsigned int width;
+};
+
+void convertYUV420Band(unsigned int begin, unsigned int end, void *arg)
+{
+  const vpYUV420ConversionData *data = static_cast<const vpYUV420ConversionData *>(arg);
+  unsigned int width = data->width;
+  data->conversion(data->y + 2 * begin * width, data->u + begin * (width / 2), data->v + begin * (width / 2),
+                   data->dst + 2 * begin * width * data->dst_step, width, end - begin);
+}
+
+void convertYUV420(vpYUV420Conversion conversion, unsigned char *y, unsigned char *u, unsigned char *v,
+                   unsigned char *dst, unsigned int dst_step, unsigned int width, unsigned int height)
+{
+  vpYUV420ConversionData data;
+  data.conversion = conversion;
+  data.y = y;
+  data.u = u;
+  data.v = v;
+  data.dst = dst;
+  data.dst_step = dst_step;
+  data.width = width;
+  vpThreadPool::parallelFor(0, height / 2, convertYUV420Band, &data, width > 0 ? vpMinPixelsPerBand / (2 * width) + 1 : 1);
+}
+}
 
 
 bool vpImageConvert::YCbCrLUTcomputed = false;
@@ -949,7 +1064,7 @@ void vpImageConvert::convert(const vpImage<unsigned char> & src,
 
   \param src : Source image in YARP format.
   \param dest : Destination image in ViSP format.
-  \param copyData : Set to true to copy all the image content. If false we only update the image pointer.
+  \param copyData : Set to true to copy all the image content. If false \e dest wraps the YARP buffer, see vpImage::wrap(), and \e src has to outlive it.
 
   \code
 #include <visp3/core/vpConfig.h>
@@ -980,11 +1095,12 @@ int main()
 void vpImageConvert::convert(const yarp::sig::ImageOf< yarp::sig::PixelMono > *src,
                              vpImage<unsigned char> & dest,const bool copyData)
 {
-  dest.resize(src->height(),src->width());
-  if(copyData)
+  if(copyData) {
+    dest.resize(src->height(),src->width());
     memcpy(dest.bitmap, src->getRawImage(), src->height()*src->width()*sizeof(yarp::sig::PixelMono));
+  }
   else
-    dest.bitmap = src->getRawImage();
+    dest.wrap(src->getRawImage(), src->height(), src->width());
 }
 	
 /*!
@@ -1039,7 +1155,7 @@ void vpImageConvert::convert(const vpImage<vpRGBa> & src,
 
   \param src : Source image in YARP format.
   \param dest : Destination image in ViSP format.
-  \param copyData : Set to true to copy all the image content. If false we only update the image pointer.
+  \param copyData : Set to true to copy all the image content. If false \e dest wraps the YARP buffer, see vpImage::wrap(), and \e src has to outlive it.
   
   \code
 #include <visp3/core/vpConfig.h>
@@ -1071,11 +1187,12 @@ int main()
 void vpImageConvert::convert(const yarp::sig::ImageOf< yarp::sig::PixelRgba > *src,
                              vpImage<vpRGBa> & dest,const bool copyData)
 {
-  dest.resize(src->height(),src->width());
-  if(copyData)
+  if(copyData) {
+    dest.resize(src->height(),src->width());
     memcpy(dest.bitmap, src->getRawImage(),src->height()*src->width()*sizeof(yarp::sig::PixelRgba));
+  }
   else
-    dest.bitmap = (vpRGBa*)src->getRawImage();
+    dest.wrap((vpRGBa*)src->getRawImage(), src->height(), src->width());
 }
 
 /*!
@@ -1175,26 +1292,19 @@ void vpImageConvert::convert(const yarp::sig::ImageOf< yarp::sig::PixelRgb > *sr
 
 #define vpSAT(c) \
         if (c & (~255)) { if (c < 0) c = 0; else c = 255; }
-/*!
-  Convert an image from YUYV 4:2:2 (y0 u01 y1 v01 y2 u23 y3 v23 ...) to RGB32.
-  Destination rgba memory area has to be allocated before.
 
-  \sa YUV422ToRGBa()
-*/
-void vpImageConvert::YUYVToRGBa(unsigned char* yuyv, unsigned char* rgba,
-                                unsigned int width, unsigned int height)
+namespace {
+void YUYVToRGBaSerial(unsigned char* yuyv, unsigned char* rgba, unsigned int size)
 {
   unsigned char *s;
   unsigned char *d;
-  int w, h;
   int r, g, b, cr, cg, cb, y1, y2;
 
-  h = (int)height;
-  w = (int)width;
-  s = yuyv;
-  d = rgba;
-  while (h--) {
-    int c = w >> 1;
+  unsigned int nsimd = vp_simd_YUYVToRGBa(yuyv, rgba, size);
+  s = yuyv + 2*nsimd;
+  d = rgba + 4*nsimd;
+  {
+    int c = (int)((size - nsimd) >> 1);
     while (c--) {
       y1 = *s++;
       cb = ((*s - 128) * 454) >> 8;
@@ -1230,27 +1340,33 @@ void vpImageConvert::YUYVToRGBa(unsigned char* yuyv, unsigned char* rgba,
     }
   }
 }
-/*!
+}
 
-  Convert an image from YUYV 4:2:2 (y0 u01 y1 v01 y2 u23 y3 v23 ...)
-  to RGB24. Destination rgb memory area has to be allocated before.
+/*!
+  Convert an image from YUYV 4:2:2 (y0 u01 y1 v01 y2 u23 y3 v23 ...) to RGB32.
+  Destination rgba memory area has to be allocated before.
 
-  \sa YUV422ToRGB()
+  \sa YUV422ToRGBa()
 */
-void vpImageConvert::YUYVToRGB(unsigned char* yuyv, unsigned char* rgb,
-                               unsigned int width, unsigned int height)
+void vpImageConvert::YUYVToRGBa(unsigned char* yuyv, unsigned char* rgba,
+                                unsigned int width, unsigned int height)
+{
+  // Each line is made of width/2 macro pixels
+  convertPixels(YUYVToRGBaSerial, yuyv, 2, rgba, 4, 2 * ((width >> 1) * height), 2);
+}
+
+namespace {
+void YUYVToRGBSerial(unsigned char* yuyv, unsigned char* rgb, unsigned int size)
 {
   unsigned char *s;
   unsigned char *d;
-  int h, w;
   int r, g, b, cr, cg, cb, y1, y2;
 
-  h = (int)height;
-  w = (int)width;
-  s = yuyv;
-  d = rgb;
-  while (h--) {
-    int c = w >> 1;
+  unsigned int nsimd = vp_simd_YUYVToRGB(yuyv, rgb, size);
+  s = yuyv + 2*nsimd;
+  d = rgb + 3*nsimd;
+  {
+    int c = (int)((size - nsimd) >> 1);
     while (c--) {
       y1 = *s++;
       cb = ((*s - 128) * 454) >> 8;
@@ -1283,16 +1399,27 @@ void vpImageConvert::YUYVToRGB(unsigned char* yuyv, unsigned char* rgb,
     }
   }
 }
+}
+
 /*!
 
   Convert an image from YUYV 4:2:2 (y0 u01 y1 v01 y2 u23 y3 v23 ...)
-  to grey. Destination rgb memory area has to be allocated before.
+  to RGB24. Destination rgb memory area has to be allocated before.
 
-  \sa YUV422ToGrey()
+  \sa YUV422ToRGB()
 */
-void vpImageConvert::YUYVToGrey(unsigned char* yuyv, unsigned char* grey, unsigned int size)
+void vpImageConvert::YUYVToRGB(unsigned char* yuyv, unsigned char* rgb,
+                               unsigned int width, unsigned int height)
 {
-  unsigned int i=0,j=0;
+  // Each line is made of width/2 macro pixels
+  convertPixels(YUYVToRGBSerial, yuyv, 2, rgb, 3, 2 * ((width >> 1) * height), 2);
+}
+
+namespace {
+void YUYVToGreySerial(unsigned char* yuyv, unsigned char* grey, unsigned int size)
+{
+  unsigned int i = vp_simd_YUYVToGrey(yuyv, grey, size);
+  unsigned int j = 2*i;
 
   while( j < size*2)
     {
@@ -1301,6 +1428,19 @@ void vpImageConvert::YUYVToGrey(unsigned char* yuyv, unsigned char* grey, unsign
       j+=4;
     }
 }
+}
+
+/*!
+
+  Convert an image from YUYV 4:2:2 (y0 u01 y1 v01 y2 u23 y3 v23 ...)
+  to grey. Destination rgb memory area has to be allocated before.
+
+  \sa YUV422ToGrey()
+*/
+void vpImageConvert::YUYVToGrey(unsigned char* yuyv, unsigned char* grey, unsigned int size)
+{
+  convertPixels(YUYVToGreySerial, yuyv, 2, grey, 1, size, 2);
+}
 
 
 /*!
@@ -1428,18 +1568,16 @@ void vpImageConvert::YUV411ToRGBa(unsigned char* yuv, unsigned char* rgba, unsig
 
 }
 
-/*!
-  Convert YUV 4:2:2 (u01 y0 v01 y1 u23 y2 v23 y3 ...) images into RGB32 images.
-  Destination rgba memory area has to be allocated before.
-
-  \sa YUYVToRGBa()
-*/
-void vpImageConvert::YUV422ToRGBa(unsigned char* yuv, unsigned char* rgba, unsigned int size)
+namespace {
+void YUV422ToRGBaSerial(unsigned char* yuv, unsigned char* rgba, unsigned int size)
 {
 
 #if 1
   //  std::cout << "call optimized convertYUV422ToRGBa()" << std::endl;
-  for( unsigned int i = size / 2; i; i-- ) {
+  unsigned int nsimd = vp_simd_YUV422ToRGBa(yuv, rgba, size);
+  yuv += 2*nsimd;
+  rgba += 4*nsimd;
+  for( unsigned int i = (size - nsimd) / 2; i; i-- ) {
     int U   = (int)((*yuv++ - 128) * 0.354);
     int U5  = 5*U;
     int Y0  = *yuv++;
@@ -1461,7 +1599,7 @@ void vpImageConvert::YUV422ToRGBa(unsigned char* yuv, unsigned char* rgba, unsig
     *rgba++ = (unsigned char)R;
     *rgba++ = (unsigned char)G;
     *rgba++ = (unsigned char)B;
-    rgba++;
+    *rgba++ = 0;
 
     //---
     R = Y1 + V2;
@@ -1476,7 +1614,7 @@ void vpImageConvert::YUV422ToRGBa(unsigned char* yuv, unsigned char* rgba, unsig
     *rgba++ = (unsigned char)R;
     *rgba++ = (unsigned char)G;
     *rgba++ = (unsigned char)B;
-    rgba++;
+    *rgba++ = 0;
   }
 
 #else
@@ -1505,6 +1643,18 @@ void vpImageConvert::YUV422ToRGBa(unsigned char* yuv, unsigned char* rgba, unsig
  }
 #endif
 }
+}
+
+/*!
+  Convert YUV 4:2:2 (u01 y0 v01 y1 u23 y2 v23 y3 ...) images into RGB32 images.
+  Destination rgba memory area has to be allocated before.
+
+  \sa YUYVToRGBa()
+*/
+void vpImageConvert::YUV422ToRGBa(unsigned char* yuv, unsigned char* rgba, unsigned int size)
+{
+  convertPixels(YUV422ToRGBaSerial, yuv, 2, rgba, 4, size, 2);
+}
 
 /*!
 
@@ -1529,19 +1679,15 @@ void vpImageConvert::YUV411ToGrey(unsigned char* yuv, unsigned char* grey, unsig
   }
 }
 
-/*!
-
-  Convert YUV 4:2:2 (u01 y0 v01 y1 u23 y2 v23 y3 ...) images into RGB images.
-  Destination rgb memory area has to be allocated before.
-
-  \sa YUYVToRGB()
-
-*/
-void vpImageConvert::YUV422ToRGB(unsigned char* yuv, unsigned char* rgb, unsigned int size)
+namespace {
+void YUV422ToRGBSerial(unsigned char* yuv, unsigned char* rgb, unsigned int size)
 {
 #if 1
   //  std::cout << "call optimized convertYUV422ToRGB()" << std::endl;
-  for( unsigned int i = size / 2; i; i-- ) {
+  unsigned int nsimd = vp_simd_YUV422ToRGB(yuv, rgb, size);
+  yuv += 2*nsimd;
+  rgb += 3*nsimd;
+  for( unsigned int i = (size - nsimd) / 2; i; i-- ) {
     int U   = (int)((*yuv++ - 128) * 0.354);
     int U5  = 5*U;
     int Y0  = *yuv++;
@@ -1604,18 +1750,26 @@ void vpImageConvert::YUV422ToRGB(unsigned char* yuv, unsigned char* rgb, unsigne
  }
 #endif
 }
+}
 
 /*!
 
-  Convert YUV 4:2:2 (u01 y0 v01 y1 u23 y2 v23 y3 ...) images into Grey.
-  Destination grey memory area has to be allocated before.
+  Convert YUV 4:2:2 (u01 y0 v01 y1 u23 y2 v23 y3 ...) images into RGB images.
+  Destination rgb memory area has to be allocated before.
 
-  \sa YUYVToGrey()
+  \sa YUYVToRGB()
 
 */
-void vpImageConvert::YUV422ToGrey(unsigned char* yuv, unsigned char* grey, unsigned int size)
+void vpImageConvert::YUV422ToRGB(unsigned char* yuv, unsigned char* rgb, unsigned int size)
 {
- unsigned int i=0,j=0;
+  convertPixels(YUV422ToRGBSerial, yuv, 2, rgb, 3, size, 2);
+}
+
+namespace {
+void YUV422ToGreySerial(unsigned char* yuv, unsigned char* grey, unsigned int size)
+{
+ unsigned int i = vp_simd_YUV422ToGrey(yuv, grey, size);
+ unsigned int j = 2*i;
 
  while( j < size*2)
  {
@@ -1624,6 +1778,20 @@ void vpImageConvert::YUV422ToGrey(unsigned char* yuv, unsigned char* grey, unsig
    j+=4;
  }
 }
+}
+
+/*!
+
+  Convert YUV 4:2:2 (u01 y0 v01 y1 u23 y2 v23 y3 ...) images into Grey.
+  Destination grey memory area has to be allocated before.
+
+  \sa YUYVToGrey()
+
+*/
+void vpImageConvert::YUV422ToGrey(unsigned char* yuv, unsigned char* grey, unsigned int size)
+{
+  convertPixels(YUV422ToGreySerial, yuv, 2, grey, 1, size, 2);
+}
 
 /*!
 
@@ -1746,24 +1914,20 @@ void vpImageConvert::YUV411ToRGB(unsigned char* yuv, unsigned char* rgb, unsigne
 
 
 
-/*!
-
-  Convert YUV420 into RGBa
-  yuv420 : Y(NxM), U(N/2xM/2), V(N/2xM/2)
-
-*/
-void vpImageConvert::YUV420ToRGBa(unsigned char* yuv, unsigned char* rgba,
-                                  unsigned int width, unsigned int height)
+namespace {
+void YUV420ToRGBaSerial(unsigned char* yuv, unsigned char* iU, unsigned char* iV, unsigned char* rgba,
+                        unsigned int width, unsigned int npairs)
 {
-  //  std::cout << "call optimized ConvertYUV420ToRGBa()" << std::endl;
   int U, V, R, G, B, V2, U5, UV;
   int Y0, Y1, Y2, Y3;
-  unsigned int size = width*height;
-  unsigned char* iU = yuv + size;
-  unsigned char* iV = yuv + 5*size/4;
-  for(unsigned int i = 0; i<height/2; i++)
+  for(unsigned int i = 0; i<npairs; i++)
   {
-  for(unsigned int j = 0; j < width/2 ; j++)
+  unsigned int nsimd = vp_simd_YUV420ToRGBa(yuv, yuv + width, iU, iV, rgba, rgba + 4*width, width);
+  yuv += nsimd;
+  iU += nsimd/2;
+  iV += nsimd/2;
+  rgba += 4*nsimd;
+  for(unsigned int j = nsimd/2; j < width/2 ; j++)
     {
     U   = (int)((*iU++ - 128) * 0.354);
     U5  = 5*U;
@@ -1846,25 +2010,35 @@ void vpImageConvert::YUV420ToRGBa(unsigned char* yuv, unsigned char* rgba,
   rgba+=4*width;
   }
 }
+}
+
 /*!
 
-  Convert YUV420 into RGB
+  Convert YUV420 into RGBa
   yuv420 : Y(NxM), U(N/2xM/2), V(N/2xM/2)
 
 */
-void vpImageConvert::YUV420ToRGB(unsigned char* yuv,
-                                 unsigned char* rgb,
-                                 unsigned int width, unsigned int height)
+void vpImageConvert::YUV420ToRGBa(unsigned char* yuv, unsigned char* rgba,
+                                  unsigned int width, unsigned int height)
+{
+  unsigned int size = width*height;
+  convertYUV420(YUV420ToRGBaSerial, yuv, yuv + size, yuv + 5*size/4, rgba, 4, width, height);
+}
+
+namespace {
+void YUV420ToRGBSerial(unsigned char* yuv, unsigned char* iU, unsigned char* iV, unsigned char* rgb,
+                       unsigned int width, unsigned int npairs)
 {
-  //  std::cout << "call optimized ConvertYUV420ToRGB()" << std::endl;
   int U, V, R, G, B, V2, U5, UV;
   int Y0, Y1, Y2, Y3;
-  unsigned int size = width*height;
-  unsigned char* iU = yuv + size;
-  unsigned char* iV = yuv + 5*size/4;
-  for(unsigned int i = 0; i<height/2; i++)
+  for(unsigned int i = 0; i<npairs; i++)
   {
-  for(unsigned int j = 0; j < width/2 ; j++)
+  unsigned int nsimd = vp_simd_YUV420ToRGB(yuv, yuv + width, iU, iV, rgb, rgb + 3*width, width);
+  yuv += nsimd;
+  iU += nsimd/2;
+  iV += nsimd/2;
+  rgb += 3*nsimd;
+  for(unsigned int j = nsimd/2; j < width/2 ; j++)
     {
     U   = (int)((*iU++ - 128) * 0.354);
     U5  = 5*U;
@@ -1943,6 +2117,21 @@ void vpImageConvert::YUV420ToRGB(unsigned char* yuv,
   rgb+=3*width;
   }
 }
+}
+
+/*!
+
+  Convert YUV420 into RGB
+  yuv420 : Y(NxM), U(N/2xM/2), V(N/2xM/2)
+
+*/
+void vpImageConvert::YUV420ToRGB(unsigned char* yuv,
+                                 unsigned char* rgb,
+                                 unsigned int width, unsigned int height)
+{
+  unsigned int size = width*height;
+  convertYUV420(YUV420ToRGBSerial, yuv, yuv + size, yuv + 5*size/4, rgb, 3, width, height);
+}
 
 /*!
 
@@ -2055,15 +2244,40 @@ void vpImageConvert::YUV444ToGrey(unsigned char* yuv, unsigned char* grey, unsig
 void vpImageConvert::YV12ToRGBa(unsigned char* yuv, unsigned char* rgba,
                                 unsigned int width, unsigned int height)
 {
-  //  std::cout << "call optimized ConvertYV12ToRGBa()" << std::endl;
+  unsigned int size = width*height;
+  convertYUV420(YUV420ToRGBaSerial, yuv, yuv + 5*size/4, yuv + size, rgba, 4, width, height);
+}
+/*!
+
+  Convert YV12 into RGB
+  yuv420 : Y(NxM),  V(N/2xM/2), U(N/2xM/2)
+
+*/
+void vpImageConvert::YV12ToRGB(unsigned char* yuv, unsigned char* rgb,
+                               unsigned int height, unsigned int width)
+{
+  unsigned int size = width*height;
+  convertYUV420(YUV420ToRGBSerial, yuv, yuv + 5*size/4, yuv + size, rgb, 3, width, height);
+}
+
+/*!
+
+  Convert YVU9 into RGBa
+  yuv420 : Y(NxM), V(N/4xM/4), U(N/4xM/4)
+
+*/
+void vpImageConvert::YVU9ToRGBa(unsigned char* yuv, unsigned char* rgba,
+                                unsigned int width, unsigned int height)
+{
+  //  std::cout << "call optimized ConvertYVU9ToRGBa()" << std::endl;
   int U, V, R, G, B, V2, U5, UV;
-  int Y0, Y1, Y2, Y3;
+  int Y0, Y1, Y2, Y3,Y4, Y5, Y6, Y7,Y8, Y9, Y10, Y11,Y12, Y13, Y14, Y15;
   unsigned int size = width*height;
   unsigned char* iV = yuv + size;
-  unsigned char* iU = yuv + 5*size/4;
-  for(unsigned int i = 0; i<height/2; i++)
+  unsigned char* iU = yuv + 17*size/16;
+  for(unsigned int i = 0; i<height/4; i++)
   {
-  for(unsigned int j = 0; j < width/2 ; j++)
+  for(unsigned int j = 0; j < width/4 ; j++)
     {
     U   = (int)((*iU++ - 128) * 0.354);
     U5  = 5*U;
@@ -2071,11 +2285,25 @@ void vpImageConvert::YV12ToRGBa(unsigned char* yuv, unsigned char* rgba,
     V2  = 2*V;
     UV  = - U - V;
     Y0  = *yuv++;
-    Y1  = *yuv;
-    yuv = yuv+width-1;
+    Y1  = *yuv++;
     Y2  = *yuv++;
     Y3  = *yuv;
-    yuv = yuv-width+1;
+    yuv = yuv+width-3;
+    Y4  = *yuv++;
+    Y5  = *yuv++;
+    Y6  = *yuv++;
+    Y7  = *yuv;
+    yuv = yuv+width-3;
+    Y8  = *yuv++;
+    Y9  = *yuv++;
+    Y10  = *yuv++;
+    Y11  = *yuv;
+    yuv = yuv+width-3;
+    Y12  = *yuv++;
+    Y13  = *yuv++;
+    Y14  = *yuv++;
+    Y15  = *yuv;
+    yuv = yuv-3*width+1;
 
     // Original equations
     // R = Y           + 1.402 V
@@ -2108,8 +2336,7 @@ void vpImageConvert::YV12ToRGBa(unsigned char* yuv, unsigned char* rgba,
     *rgba++ = (unsigned char)R;
     *rgba++ = (unsigned char)G;
     *rgba++ = (unsigned char)B;
-    *rgba = 0;
-    rgba = rgba + 4*width-7;
+    *rgba++ = 0;
 
     //---
     R = Y2 + V2;
@@ -2140,220 +2367,10 @@ void vpImageConvert::YV12ToRGBa(unsigned char* yuv, unsigned char* rgba,
     *rgba++ = (unsigned char)G;
     *rgba++ = (unsigned char)B;
     *rgba = 0;
-    rgba = rgba -4*width+1;
-    }
-  yuv+=width;
-  rgba+=4*width;
-  }
-}
-/*!
+    rgba = rgba + 4*width-15;
 
-  Convert YV12 into RGB
-  yuv420 : Y(NxM),  V(N/2xM/2), U(N/2xM/2)
-
-*/
-void vpImageConvert::YV12ToRGB(unsigned char* yuv, unsigned char* rgb,
-                               unsigned int height, unsigned int width)
-{
-  //  std::cout << "call optimized ConvertYV12ToRGB()" << std::endl;
-  int U, V, R, G, B, V2, U5, UV;
-  int Y0, Y1, Y2, Y3;
-  unsigned int size = width*height;
-  unsigned char* iV = yuv + size;
-  unsigned char* iU = yuv + 5*size/4;
-  for(unsigned int i = 0; i<height/2; i++)
-  {
-  for(unsigned int j = 0; j < width/2 ; j++)
-    {
-    U   = (int)((*iU++ - 128) * 0.354);
-    U5  = 5*U;
-    V   = (int)((*iV++ - 128) * 0.707);
-    V2  = 2*V;
-    UV  = - U - V;
-    Y0  = *yuv++;
-    Y1  = *yuv;
-    yuv = yuv+width-1;
-    Y2  = *yuv++;
-    Y3  = *yuv;
-    yuv = yuv-width+1;
-
-    // Original equations
-    // R = Y           + 1.402 V
-    // G = Y - 0.344 U - 0.714 V
-    // B = Y + 1.772 U
-    R = Y0 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y0 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y0 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb++ = (unsigned char)B;
-
-    //---
-    R = Y1 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y1 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y1 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb = (unsigned char)B;
-    rgb = rgb + 3*width-5;
-
-    //---
-    R = Y2 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y2 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y2 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb++ = (unsigned char)B;
-
-    //---
-    R = Y3 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y3 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y3 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgb++ = (unsigned char)R;
-    *rgb++ = (unsigned char)G;
-    *rgb = (unsigned char)B;
-    rgb = rgb -3*width+1;
-    }
-  yuv+=width;
-  rgb+=3*width;
-  }
-}
-
-/*!
-
-  Convert YVU9 into RGBa
-  yuv420 : Y(NxM), V(N/4xM/4), U(N/4xM/4)
-
-*/
-void vpImageConvert::YVU9ToRGBa(unsigned char* yuv, unsigned char* rgba,
-                                unsigned int width, unsigned int height)
-{
-  //  std::cout << "call optimized ConvertYVU9ToRGBa()" << std::endl;
-  int U, V, R, G, B, V2, U5, UV;
-  int Y0, Y1, Y2, Y3,Y4, Y5, Y6, Y7,Y8, Y9, Y10, Y11,Y12, Y13, Y14, Y15;
-  unsigned int size = width*height;
-  unsigned char* iV = yuv + size;
-  unsigned char* iU = yuv + 17*size/16;
-  for(unsigned int i = 0; i<height/4; i++)
-  {
-  for(unsigned int j = 0; j < width/4 ; j++)
-    {
-    U   = (int)((*iU++ - 128) * 0.354);
-    U5  = 5*U;
-    V   = (int)((*iV++ - 128) * 0.707);
-    V2  = 2*V;
-    UV  = - U - V;
-    Y0  = *yuv++;
-    Y1  = *yuv++;
-    Y2  = *yuv++;
-    Y3  = *yuv;
-    yuv = yuv+width-3;
-    Y4  = *yuv++;
-    Y5  = *yuv++;
-    Y6  = *yuv++;
-    Y7  = *yuv;
-    yuv = yuv+width-3;
-    Y8  = *yuv++;
-    Y9  = *yuv++;
-    Y10  = *yuv++;
-    Y11  = *yuv;
-    yuv = yuv+width-3;
-    Y12  = *yuv++;
-    Y13  = *yuv++;
-    Y14  = *yuv++;
-    Y15  = *yuv;
-    yuv = yuv-3*width+1;
-
-    // Original equations
-    // R = Y           + 1.402 V
-    // G = Y - 0.344 U - 0.714 V
-    // B = Y + 1.772 U
-    R = Y0 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y0 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y0 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    *rgba++ = 0;
-
-    //---
-    R = Y1 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y1 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y1 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    *rgba++ = 0;
-
-    //---
-    R = Y2 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y2 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y2 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    *rgba++ = 0;
-
-    //---
-    R = Y3 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y3 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y3 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    *rgba = 0;
-    rgba = rgba + 4*width-15;
-
-    R = Y4 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
+    R = Y4 + V2;
+    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
 
     G = Y4 + UV;
     if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
@@ -2814,16 +2831,13 @@ void vpImageConvert::YVU9ToRGB(unsigned char* yuv, unsigned char* rgb,
   }
 }
 
-/*!
-
-  Convert RGB into RGBa
-
-*/
-void vpImageConvert::RGBToRGBa(unsigned char* rgb, unsigned char* rgba, unsigned int size)
+namespace {
+void RGBToRGBaSerial(unsigned char* rgb, unsigned char* rgba, unsigned int size)
 {
-  unsigned char *pt_input = rgb;
+  unsigned int nsimd = vp_simd_RGBToRGBa(rgb, rgba, size);
+  unsigned char *pt_input = rgb + 3*nsimd;
   unsigned char *pt_end = rgb + 3*size;
-  unsigned char *pt_output = rgba;
+  unsigned char *pt_output = rgba + 4*nsimd;
 
   while(pt_input != pt_end) {
     *(pt_output++) = *(pt_input++) ; // R
@@ -2832,17 +2846,25 @@ void vpImageConvert::RGBToRGBa(unsigned char* rgb, unsigned char* rgba, unsigned
     *(pt_output++) = 0 ; // A
   }
 }
+}
 
 /*!
 
   Convert RGB into RGBa
 
 */
-void vpImageConvert::RGBaToRGB(unsigned char* rgba, unsigned char* rgb, unsigned int size)
+void vpImageConvert::RGBToRGBa(unsigned char* rgb, unsigned char* rgba, unsigned int size)
+{
+  convertPixels(RGBToRGBaSerial, rgb, 3, rgba, 4, size);
+}
+
+namespace {
+void RGBaToRGBSerial(unsigned char* rgba, unsigned char* rgb, unsigned int size)
 {
-  unsigned char *pt_input = rgba;
+  unsigned int nsimd = vp_simd_RGBaToRGB(rgba, rgb, size);
+  unsigned char *pt_input = rgba + 4*nsimd;
   unsigned char *pt_end = rgba + 4*size;
-  unsigned char *pt_output = rgb;
+  unsigned char *pt_output = rgb + 3*nsimd;
 
   while(pt_input != pt_end) {
     *(pt_output++) = *(pt_input++) ; // R
@@ -2851,269 +2873,87 @@ void vpImageConvert::RGBaToRGB(unsigned char* rgba, unsigned char* rgb, unsigned
     pt_input++ ;
   }
 }
+}
+
 /*!
-  Weights convert from linear RGB to CIE luminance assuming a
-  modern monitor. See Charles Pontyon's Colour FAQ
-  http://www.poynton.com/notes/colour_and_gamma/ColorFAQ.html
+
+  Convert RGB into RGBa
 
 */
-void vpImageConvert::RGBToGrey(unsigned char* rgb, unsigned char* grey, unsigned int size)
+void vpImageConvert::RGBaToRGB(unsigned char* rgba, unsigned char* rgb, unsigned int size)
 {
-#if VISP_HAVE_SSSE3
-  unsigned int i = 0;
-
-  if(size >= 16) {
-    //Mask to select R component
-    const __m128i mask_R1 = _mm_set_epi8(
-          -1, -1, -1, -1, 15, -1, 12, -1, 9, -1, 6, -1, 3, -1, 0, -1
-          );
-    const __m128i mask_R2 = _mm_set_epi8(
-          5, -1, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
-          );
-    const __m128i mask_R3 = _mm_set_epi8(
-          -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 14, -1, 11, -1, 8, -1
-          );
-    const __m128i mask_R4 = _mm_set_epi8(
-          13, -1, 10, -1, 7, -1, 4, -1, 1, -1, -1, -1, -1, -1, -1, -1
-          );
-
-    //Mask to select G component
-    const __m128i mask_G1 = _mm_set_epi8(
-          -1, -1, -1, -1, -1, -1, 13, -1, 10, -1, 7, -1, 4, -1, 1, -1
-          );
-    const __m128i mask_G2 = _mm_set_epi8(
-          6, -1, 3, -1, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
-          );
-    const __m128i mask_G3 = _mm_set_epi8(
-          -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 15, -1, 12, -1, 9, -1
-          );
-    const __m128i mask_G4 = _mm_set_epi8(
-          14, -1, 11, -1, 8, -1, 5, -1, 2, -1, -1, -1, -1, -1, -1, -1
-          );
-
-    //Mask to select B component
-    const __m128i mask_B1 = _mm_set_epi8(
-          -1, -1, -1, -1, -1, -1, 14, -1, 11, -1, 8, -1, 5, -1, 2, -1
-          );
-    const __m128i mask_B2 = _mm_set_epi8(
-          7, -1, 4, -1, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
-          );
-    const __m128i mask_B3 = _mm_set_epi8(
-          -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 13, -1, 10, -1
-          );
-    const __m128i mask_B4 = _mm_set_epi8(
-          15, -1, 12, -1, 9, -1, 6, -1, 3, -1, 0, -1, -1, -1, -1, -1
-          );
-
-    //Mask to select the gray component
-    const __m128i mask_low1 = _mm_set_epi8(
-          -1, -1, -1, -1, -1, -1, -1, -1, 15, 13, 11, 9, 7, 5, 3, 1
-          );
-    const __m128i mask_low2 = _mm_set_epi8(
-          15, 13, 11, 9, 7, 5, 3, 1, -1, -1, -1, -1, -1, -1, -1, -1
-          );
-
-    //Coefficients RGB to Gray
-    const __m128i coeff_R = _mm_set_epi16(
-          13933, 13933, 13933, 13933, 13933, 13933, 13933, 13933
-          );
-    const __m128i coeff_G = _mm_set_epi16(
-          (short int) 46871, (short int) 46871, (short int) 46871, (short int) 46871,
-          (short int) 46871, (short int) 46871, (short int) 46871, (short int) 46871
-          );
-    const __m128i coeff_B = _mm_set_epi16(
-          4732, 4732, 4732, 4732, 4732, 4732, 4732, 4732
-          );
-
-    for(; i <= size - 16; i+=16) {
-      //Process 16 color pixels
-      const __m128i data1 = _mm_loadu_si128((const __m128i*) rgb);
-      const __m128i data2 = _mm_loadu_si128((const __m128i*) (rgb + 16));
-      const __m128i data3 = _mm_loadu_si128((const __m128i*) (rgb + 32));
-
-      const __m128i red_0_7 = _mm_or_si128( _mm_shuffle_epi8(data1, mask_R1), _mm_shuffle_epi8(data2, mask_R2) );
-      const __m128i green_0_7 = _mm_or_si128( _mm_shuffle_epi8(data1, mask_G1), _mm_shuffle_epi8(data2, mask_G2) );
-      const __m128i blue_0_7 = _mm_or_si128( _mm_shuffle_epi8(data1, mask_B1), _mm_shuffle_epi8(data2, mask_B2) );
-
-      const __m128i grays_0_7 =
-          _mm_adds_epu16(
-            _mm_mulhi_epu16(red_0_7, coeff_R),
-            _mm_adds_epu16(
-              _mm_mulhi_epu16(green_0_7, coeff_G),
-              _mm_mulhi_epu16(blue_0_7,  coeff_B)
-              ));
-
-      const __m128i red_8_15 = _mm_or_si128( _mm_shuffle_epi8(data2, mask_R3), _mm_shuffle_epi8(data3, mask_R4) );
-      const __m128i green_8_15 = _mm_or_si128( _mm_shuffle_epi8(data2, mask_G3), _mm_shuffle_epi8(data3, mask_G4) );
-      const __m128i blue_8_15 = _mm_or_si128( _mm_shuffle_epi8(data2, mask_B3), _mm_shuffle_epi8(data3, mask_B4) );
-
-      const __m128i grays_8_15 =
-          _mm_adds_epu16(
-            _mm_mulhi_epu16(red_8_15, coeff_R),
-            _mm_adds_epu16(
-              _mm_mulhi_epu16(green_8_15, coeff_G),
-              _mm_mulhi_epu16(blue_8_15,  coeff_B)
-              ));
-
-      _mm_storeu_si128( (__m128i*) grey, _mm_or_si128(_mm_shuffle_epi8(grays_0_7, mask_low1), _mm_shuffle_epi8(grays_8_15, mask_low2)) );
-
-      rgb += 48;
-      grey += 16;
-    }
-  }
-
-  for(; i < size; i++) {
-    *grey = (unsigned char) (0.2126 * (*rgb)
-      + 0.7152 * (*(rgb + 1))
-      + 0.0722 * (*(rgb + 2)) );
+  convertPixels(RGBaToRGBSerial, rgba, 4, rgb, 3, size);
+}
 
-    rgb += 3;
-    ++grey;
-  }
-#else
-  unsigned char *pt_input = rgb;
+namespace {
+void RGBToGreySerial(unsigned char* rgb, unsigned char* grey, unsigned int size)
+{
+  unsigned int nsimd = vp_simd_RGBToGrey(rgb, grey, size);
+  unsigned char *pt_input = rgb + 3*nsimd;
   unsigned char* pt_end = rgb + size*3;
-  unsigned char *pt_output = grey;
+  unsigned char *pt_output = grey + nsimd;
 
   while(pt_input != pt_end) {
-    *pt_output = (unsigned char) (0.2126 * (*pt_input)
-      + 0.7152 * (*(pt_input + 1))
-      + 0.0722 * (*(pt_input + 2)) );
+    *pt_output = (unsigned char) ((2126 * (*pt_input)
+      + 7152 * (*(pt_input + 1))
+      + 722 * (*(pt_input + 2)) ) / 10000);
     pt_input += 3;
     pt_output ++;
   }
-#endif
 }
-/*!
+}
 
-  Weights convert from linear RGBa to CIE luminance assuming a
+/*!
+  Weights convert from linear RGB to CIE luminance assuming a
   modern monitor. See Charles Pontyon's Colour FAQ
   http://www.poynton.com/notes/colour_and_gamma/ColorFAQ.html
 
+  The luminance is computed in fixed point as (2126 R + 7152 G + 722 B) / 10000,
+  so that the SIMD and the scalar code paths give the same result.
 */
-void vpImageConvert::RGBaToGrey(unsigned char* rgba, unsigned char* grey, unsigned int size)
+void vpImageConvert::RGBToGrey(unsigned char* rgb, unsigned char* grey, unsigned int size)
 {
-#if VISP_HAVE_SSSE3
-  unsigned int i = 0;
-
-  if(size >= 16) {
-    //Mask to select R component
-    const __m128i mask_R1 = _mm_set_epi8(
-          -1, -1, -1, -1, -1, -1, -1, -1, 12, -1, 8, -1, 4, -1, 0, -1
-          );
-    const __m128i mask_R2 = _mm_set_epi8(
-          12, -1, 8, -1, 4, -1, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1
-          );
-
-    //Mask to select G component
-    const __m128i mask_G1 = _mm_set_epi8(
-          -1, -1, -1, -1, -1, -1, -1, -1, 13, -1, 9, -1, 5, -1, 1, -1
-          );
-    const __m128i mask_G2 = _mm_set_epi8(
-          13, -1, 9, -1, 5, -1, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1
-          );
-
-    //Mask to select B component
-    const __m128i mask_B1 = _mm_set_epi8(
-          -1, -1, -1, -1, -1, -1, -1, -1, 14, -1, 10, -1, 6, -1, 2, -1
-          );
-    const __m128i mask_B2 = _mm_set_epi8(
-          14, -1, 10, -1, 6, -1, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1
-          );
-
-    //Mask to select the gray component
-    const __m128i mask_low1 = _mm_set_epi8(
-          -1, -1, -1, -1, -1, -1, -1, -1, 15, 13, 11, 9, 7, 5, 3, 1
-          );
-    const __m128i mask_low2 = _mm_set_epi8(
-          15, 13, 11, 9, 7, 5, 3, 1, -1, -1, -1, -1, -1, -1, -1, -1
-          );
-
-    //Coefficients RGB to Gray
-    const __m128i coeff_R = _mm_set_epi16(
-          13933, 13933, 13933, 13933, 13933, 13933, 13933, 13933
-          );
-    const __m128i coeff_G = _mm_set_epi16(
-          (short int) 46871, (short int) 46871, (short int) 46871, (short int) 46871,
-          (short int) 46871, (short int) 46871, (short int) 46871, (short int) 46871
-          );
-    const __m128i coeff_B = _mm_set_epi16(
-          4732, 4732, 4732, 4732, 4732, 4732, 4732, 4732
-          );
-
-    for(; i <= size - 16; i+=16) {
-      //Process 2*4 color pixels
-      const __m128i data1 = _mm_loadu_si128((const __m128i*) rgba);
-      const __m128i data2 = _mm_loadu_si128((const __m128i*) (rgba + 16));
-
-      const __m128i red_0_7 = _mm_or_si128( _mm_shuffle_epi8(data1, mask_R1), _mm_shuffle_epi8(data2, mask_R2) );
-      const __m128i green_0_7 = _mm_or_si128( _mm_shuffle_epi8(data1, mask_G1), _mm_shuffle_epi8(data2, mask_G2) );
-      const __m128i blue_0_7 = _mm_or_si128( _mm_shuffle_epi8(data1, mask_B1), _mm_shuffle_epi8(data2, mask_B2) );
-
-      const __m128i grays_0_7 =
-          _mm_adds_epu16(
-            _mm_mulhi_epu16(red_0_7, coeff_R),
-            _mm_adds_epu16(
-              _mm_mulhi_epu16(green_0_7, coeff_G),
-              _mm_mulhi_epu16(blue_0_7,  coeff_B)
-              ));
-
-      //Process next 2*4 color pixels
-      const __m128i data3 = _mm_loadu_si128((const __m128i*) (rgba + 32));
-      const __m128i data4 = _mm_loadu_si128((const __m128i*) (rgba + 48));
-
-      const __m128i red_8_15 = _mm_or_si128( _mm_shuffle_epi8(data3, mask_R1), _mm_shuffle_epi8(data4, mask_R2) );
-      const __m128i green_8_15 = _mm_or_si128( _mm_shuffle_epi8(data3, mask_G1), _mm_shuffle_epi8(data4, mask_G2) );
-      const __m128i blue_8_15 = _mm_or_si128( _mm_shuffle_epi8(data3, mask_B1), _mm_shuffle_epi8(data4, mask_B2) );
-
-      const __m128i grays_8_15 =
-          _mm_adds_epu16(
-            _mm_mulhi_epu16(red_8_15, coeff_R),
-            _mm_adds_epu16(
-              _mm_mulhi_epu16(green_8_15, coeff_G),
-              _mm_mulhi_epu16(blue_8_15,  coeff_B)
-              ));
-
-      _mm_storeu_si128( (__m128i*) grey, _mm_or_si128(_mm_shuffle_epi8(grays_0_7, mask_low1), _mm_shuffle_epi8(grays_8_15, mask_low2)) );
-
-      rgba += 64;
-      grey += 16;
-    }
-  }
-
-  for(; i < size; i++) {
-    *grey = (unsigned char) (0.2126 * (*rgba)
-      + 0.7152 * (*(rgba + 1))
-      + 0.0722 * (*(rgba + 2)) );
+  convertPixels(RGBToGreySerial, rgb, 3, grey, 1, size);
+}
 
-    rgba += 4;
-    ++grey;
-  }
-#else
-  unsigned char *pt_input = rgba;
+namespace {
+void RGBaToGreySerial(unsigned char* rgba, unsigned char* grey, unsigned int size)
+{
+  unsigned int nsimd = vp_simd_RGBaToGrey(rgba, grey, size);
+  unsigned char *pt_input = rgba + 4*nsimd;
   unsigned char* pt_end = rgba + size*4;
-  unsigned char *pt_output = grey;
+  unsigned char *pt_output = grey + nsimd;
 
   while(pt_input != pt_end) {
-    *pt_output = (unsigned char) (0.2126 * (*pt_input)
-      + 0.7152 * (*(pt_input + 1))
-      + 0.0722 * (*(pt_input + 2)) );
+    *pt_output = (unsigned char) ((2126 * (*pt_input)
+      + 7152 * (*(pt_input + 1))
+      + 722 * (*(pt_input + 2)) ) / 10000);
     pt_input += 4;
     pt_output ++;
   }
-#endif
+}
 }
 
 /*!
-  Convert from grey to linear RGBa.
 
+  Weights convert from linear RGBa to CIE luminance assuming a
+  modern monitor. See Charles Pontyon's Colour FAQ
+  http://www.poynton.com/notes/colour_and_gamma/ColorFAQ.html
+
+  \sa RGBToGrey()
 */
-void
-vpImageConvert::GreyToRGBa(unsigned char* grey, unsigned char* rgba, unsigned int size)
+void vpImageConvert::RGBaToGrey(unsigned char* rgba, unsigned char* grey, unsigned int size)
+{
+  convertPixels(RGBaToGreySerial, rgba, 4, grey, 1, size);
+}
+
+namespace {
+void GreyToRGBaSerial(unsigned char* grey, unsigned char* rgba, unsigned int size)
 {
-  unsigned char *pt_input = grey;
+  unsigned int nsimd = vp_simd_GreyToRGBa(grey, rgba, size);
+  unsigned char *pt_input = grey + nsimd;
   unsigned char *pt_end = grey + size;
-  unsigned char *pt_output = rgba;
+  unsigned char *pt_output = rgba + 4*nsimd;
 
   while(pt_input != pt_end) {
     unsigned char p =  *pt_input ;
@@ -3126,17 +2966,25 @@ vpImageConvert::GreyToRGBa(unsigned char* grey, unsigned char* rgba, unsigned in
     pt_output += 4;
   }
 }
+}
 
 /*!
   Convert from grey to linear RGBa.
 
 */
 void
-vpImageConvert::GreyToRGB(unsigned char* grey, unsigned char* rgb, unsigned int size)
+vpImageConvert::GreyToRGBa(unsigned char* grey, unsigned char* rgba, unsigned int size)
+{
+  convertPixels(GreyToRGBaSerial, grey, 1, rgba, 4, size);
+}
+
+namespace {
+void GreyToRGBSerial(unsigned char* grey, unsigned char* rgb, unsigned int size)
 {
-  unsigned char *pt_input = grey;
+  unsigned int nsimd = vp_simd_GreyToRGB(grey, rgb, size);
+  unsigned char *pt_input = grey + nsimd;
   unsigned char* pt_end = grey + size;
-  unsigned char *pt_output = rgb;
+  unsigned char *pt_output = rgb + 3*nsimd;
 
   while(pt_input != pt_end) {
     unsigned char p =  *pt_input ;
@@ -3148,7 +2996,36 @@ vpImageConvert::GreyToRGB(unsigned char* grey, unsigned char* rgb, unsigned int
     pt_output += 3;
   }
 }
+}
+
+/*!
+  Convert from grey to linear RGBa.
+
+*/
+void
+vpImageConvert::GreyToRGB(unsigned char* grey, unsigned char* rgb, unsigned int size)
+{
+  convertPixels(GreyToRGBSerial, grey, 1, rgb, 3, size);
+}
+
 
+namespace {
+void BGRToRGBaSerial(unsigned char * bgr, unsigned char * rgba, unsigned int size)
+{
+  unsigned int nsimd = vp_simd_BGRToRGBa(bgr, rgba, size);
+  unsigned char *line = bgr + 3*nsimd;
+  rgba += 4*nsimd;
+  for(unsigned int j = nsimd ; j < size ; j++)
+  {
+    *rgba++ = *(line+2);
+    *rgba++ = *(line+1);
+    *rgba++ = *(line+0);
+    *rgba++ = 0;
+
+    line+=3;
+  }
+}
+}
 
 /*!
   Converts a BGR image to RGBa
@@ -3159,274 +3036,37 @@ void
 vpImageConvert::BGRToRGBa(unsigned char * bgr, unsigned char * rgba,
                           unsigned int width, unsigned int height, bool flip)
 {
-  //if we have to flip the image, we start from the end last scanline so the
-  //step is negative
-  int lineStep = (flip) ? -(int)(width*3) : (int)(width*3);
-
-  //starting source address = last line if we need to flip the image
-  unsigned char * src = (flip) ? (bgr+(width*height*3)+lineStep) : bgr;
-  unsigned char * line;
-
-  unsigned int j=0;
-  unsigned int i=0;
+  convertLines(BGRToRGBaSerial, bgr, 3, rgba, 4, width, height, flip);
+}
 
-  for(i=0 ; i < height ; i++)
+namespace {
+void BGRToGreySerial(unsigned char * bgr, unsigned char * grey, unsigned int size)
+{
+  unsigned int nsimd = vp_simd_BGRToGrey(bgr, grey, size);
+  unsigned char *line = bgr + 3*nsimd;
+  grey += nsimd;
+  for(unsigned int j = nsimd ; j < size ; j++)
   {
-    line = src;
-    for( j=0 ; j < width ; j++)
-    {
-      *rgba++ = *(line+2);
-      *rgba++ = *(line+1);
-      *rgba++ = *(line+0);
-      *rgba++ = 0;
-
-      line+=3;
-    }
-    //go to the next line
-    src+=lineStep;
+    *grey++ = (unsigned char)( (2126 * *(line+2)
+       + 7152 * *(line+1)
+       + 722 * *(line+0)) / 10000 );
+    line+=3;
   }
-
+}
 }
 
 /*!
   Converts a BGR image to greyscale
   Flips the image verticaly if needed
   assumes that grey is already resized
+
+  \sa RGBToGrey()
 */
 void
 vpImageConvert::BGRToGrey(unsigned char * bgr, unsigned char * grey,
                           unsigned int width, unsigned int height, bool flip)
 {
-#if VISP_HAVE_SSSE3
-  //Mask to select B component
-  const __m128i mask_B1 = _mm_set_epi8(
-        -1, -1, -1, -1, 15, -1, 12, -1, 9, -1, 6, -1, 3, -1, 0, -1
-        );
-  const __m128i mask_B2 = _mm_set_epi8(
-        5, -1, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
-        );
-  const __m128i mask_B3 = _mm_set_epi8(
-        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 14, -1, 11, -1, 8, -1
-        );
-  const __m128i mask_B4 = _mm_set_epi8(
-        13, -1, 10, -1, 7, -1, 4, -1, 1, -1, -1, -1, -1, -1, -1, -1
-        );
-
-  //Mask to select G component
-  const __m128i mask_G1 = _mm_set_epi8(
-        -1, -1, -1, -1, -1, -1, 13, -1, 10, -1, 7, -1, 4, -1, 1, -1
-        );
-  const __m128i mask_G2 = _mm_set_epi8(
-        6, -1, 3, -1, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
-        );
-  const __m128i mask_G3 = _mm_set_epi8(
-        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 15, -1, 12, -1, 9, -1
-        );
-  const __m128i mask_G4 = _mm_set_epi8(
-        14, -1, 11, -1, 8, -1, 5, -1, 2, -1, -1, -1, -1, -1, -1, -1
-        );
-
-  //Mask to select R component
-  const __m128i mask_R1 = _mm_set_epi8(
-        -1, -1, -1, -1, -1, -1, 14, -1, 11, -1, 8, -1, 5, -1, 2, -1
-        );
-  const __m128i mask_R2 = _mm_set_epi8(
-        7, -1, 4, -1, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
-        );
-  const __m128i mask_R3 = _mm_set_epi8(
-        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 13, -1, 10, -1
-        );
-  const __m128i mask_R4 = _mm_set_epi8(
-        15, -1, 12, -1, 9, -1, 6, -1, 3, -1, 0, -1, -1, -1, -1, -1
-        );
-
-  //Mask to select the gray component
-  const __m128i mask_low1 = _mm_set_epi8(
-        -1, -1, -1, -1, -1, -1, -1, -1, 15, 13, 11, 9, 7, 5, 3, 1
-        );
-  const __m128i mask_low2 = _mm_set_epi8(
-        15, 13, 11, 9, 7, 5, 3, 1, -1, -1, -1, -1, -1, -1, -1, -1
-        );
-
-  //Coefficients RGB to Gray
-//  const __m128i coeff_R = _mm_set_epi8(
-//        54, -1, 54, -1, 54, -1, 54, -1, 54, -1, 54, -1, 54, -1, 54, -1
-//        );
-//  const __m128i coeff_G = _mm_set_epi8(
-//        183, -1, 183, -1, 183, -1, 183, -1, 183, -1, 183, -1, 183, -1, 183, -1
-//        );
-//  const __m128i coeff_B = _mm_set_epi8(
-//        18, -1, 18, -1, 18, -1, 18, -1, 18, -1, 18, -1, 18, -1, 18, -1
-//        );
-//  const __m128i coeff_R = _mm_set_epi16(
-//        6969*2, 6969*2, 6969*2, 6969*2, 6969*2, 6969*2, 6969*2, 6969*2
-//        );
-//  const __m128i coeff_G = _mm_set_epi16(
-//        23434*2, 23434*2, 23434*2, 23434*2, 23434*2, 23434*2, 23434*2, 23434*2
-//        );
-//  const __m128i coeff_B = _mm_set_epi16(
-//        2365*2, 2365*2, 2365*2, 2365*2, 2365*2, 2365*2, 2365*2, 2365*2
-//        );
-  const __m128i coeff_R = _mm_set_epi16(
-        13933, 13933, 13933, 13933, 13933, 13933, 13933, 13933
-        );
-  const __m128i coeff_G = _mm_set_epi16(
-        (short int) 46871, (short int) 46871, (short int) 46871, (short int) 46871,
-        (short int) 46871, (short int) 46871, (short int) 46871, (short int) 46871
-        );
-  const __m128i coeff_B = _mm_set_epi16(
-        4732, 4732, 4732, 4732, 4732, 4732, 4732, 4732
-        );
-
-  if(flip) {
-    int i = ((int) height) - 1;
-    int lineStep = -(int) (width*3);
-    bgr = bgr + (width * (height-1) * 3);
-
-    unsigned char *linePtr = bgr;
-    unsigned char r,g,b;
-
-    if(width >= 16) {
-      for(; i >= 0; i--) {
-        unsigned int j = 0;
-
-        for(; j <= width - 16; j+=16) {
-          //Process 16 color pixels
-          const __m128i data1 = _mm_loadu_si128((const __m128i*) bgr);
-          const __m128i data2 = _mm_loadu_si128((const __m128i*) (bgr + 16));
-          const __m128i data3 = _mm_loadu_si128((const __m128i*) (bgr + 32));
-
-          const __m128i red_0_7 = _mm_or_si128( _mm_shuffle_epi8(data1, mask_R1), _mm_shuffle_epi8(data2, mask_R2) );
-          const __m128i green_0_7 = _mm_or_si128( _mm_shuffle_epi8(data1, mask_G1), _mm_shuffle_epi8(data2, mask_G2) );
-          const __m128i blue_0_7 = _mm_or_si128( _mm_shuffle_epi8(data1, mask_B1), _mm_shuffle_epi8(data2, mask_B2) );
-
-          const __m128i grays_0_7 =
-              _mm_adds_epu16(
-                _mm_mulhi_epu16(red_0_7, coeff_R),
-                _mm_adds_epu16(
-                  _mm_mulhi_epu16(green_0_7, coeff_G),
-                  _mm_mulhi_epu16(blue_0_7,  coeff_B)
-                  ));
-
-          const __m128i red_8_15 = _mm_or_si128( _mm_shuffle_epi8(data2, mask_R3), _mm_shuffle_epi8(data3, mask_R4) );
-          const __m128i green_8_15 = _mm_or_si128( _mm_shuffle_epi8(data2, mask_G3), _mm_shuffle_epi8(data3, mask_G4) );
-          const __m128i blue_8_15 = _mm_or_si128( _mm_shuffle_epi8(data2, mask_B3), _mm_shuffle_epi8(data3, mask_B4) );
-
-          const __m128i grays_8_15 =
-              _mm_adds_epu16(
-                _mm_mulhi_epu16(red_8_15, coeff_R),
-                _mm_adds_epu16(
-                  _mm_mulhi_epu16(green_8_15, coeff_G),
-                  _mm_mulhi_epu16(blue_8_15,  coeff_B)
-                  ));
-
-          _mm_storeu_si128( (__m128i*) grey, _mm_or_si128(_mm_shuffle_epi8(grays_0_7, mask_low1), _mm_shuffle_epi8(grays_8_15, mask_low2)) );
-
-          bgr += 48;
-          grey += 16;
-        }
-
-        for(; j < width; j++) {
-          b = *(bgr++);
-          g = *(bgr++);
-          r = *(bgr++);
-          *grey++ = (unsigned char) ( 0.2126 * r + 0.7152 * g + 0.0722 * b);
-        }
-
-        linePtr += lineStep;
-        bgr = linePtr;
-      }
-    }
-
-    for(; i >= 0; i--) {
-      for(unsigned int j = 0; j < width; j++) {
-        b = *(bgr++);
-        g = *(bgr++);
-        r = *(bgr++);
-        *grey++ = (unsigned char) ( 0.2126 * r + 0.7152 * g + 0.0722 * b);
-      }
-
-      linePtr += lineStep;
-      bgr = linePtr;
-    }
-  } else {
-    unsigned int i = 0;
-    unsigned int size = width * height;
-
-    if(size >= 16) {
-      for(; i <= size - 16; i+=16) {
-        //Process 16 color pixels
-        const __m128i data1 = _mm_loadu_si128((const __m128i*) bgr);
-        const __m128i data2 = _mm_loadu_si128((const __m128i*) (bgr + 16));
-        const __m128i data3 = _mm_loadu_si128((const __m128i*) (bgr + 32));
-
-        const __m128i red_0_7 = _mm_or_si128( _mm_shuffle_epi8(data1, mask_R1), _mm_shuffle_epi8(data2, mask_R2) );
-        const __m128i green_0_7 = _mm_or_si128( _mm_shuffle_epi8(data1, mask_G1), _mm_shuffle_epi8(data2, mask_G2) );
-        const __m128i blue_0_7 = _mm_or_si128( _mm_shuffle_epi8(data1, mask_B1), _mm_shuffle_epi8(data2, mask_B2) );
-
-        const __m128i grays_0_7 =
-            _mm_adds_epu16(
-              _mm_mulhi_epu16(red_0_7, coeff_R),
-              _mm_adds_epu16(
-                _mm_mulhi_epu16(green_0_7, coeff_G),
-                _mm_mulhi_epu16(blue_0_7,  coeff_B)
-                ));
-
-        const __m128i red_8_15 = _mm_or_si128( _mm_shuffle_epi8(data2, mask_R3), _mm_shuffle_epi8(data3, mask_R4) );
-        const __m128i green_8_15 = _mm_or_si128( _mm_shuffle_epi8(data2, mask_G3), _mm_shuffle_epi8(data3, mask_G4) );
-        const __m128i blue_8_15 = _mm_or_si128( _mm_shuffle_epi8(data2, mask_B3), _mm_shuffle_epi8(data3, mask_B4) );
-
-        const __m128i grays_8_15 =
-            _mm_adds_epu16(
-              _mm_mulhi_epu16(red_8_15, coeff_R),
-              _mm_adds_epu16(
-                _mm_mulhi_epu16(green_8_15, coeff_G),
-                _mm_mulhi_epu16(blue_8_15,  coeff_B)
-                ));
-
-        _mm_storeu_si128( (__m128i*) grey, _mm_or_si128(_mm_shuffle_epi8(grays_0_7, mask_low1), _mm_shuffle_epi8(grays_8_15, mask_low2)) );
-
-        bgr += 48;
-        grey += 16;
-      }
-    }
-
-    for(; i < size; i++) {
-      *grey = (unsigned char) (0.2126 * (*(bgr + 2))
-                               + 0.7152 * (*(bgr + 1))
-                               + 0.0722 * (*bgr) );
-
-      bgr += 3;
-      ++grey;
-    }
-  }
-#else
-  //if we have to flip the image, we start from the end last scanline so the
-  //step is negative
-  int lineStep = (flip) ? -(int)(width*3) : (int)(width*3);
-
-  //starting source address = last line if we need to flip the image
-  unsigned char * src = (flip) ? bgr+(width*height*3)+lineStep : bgr;
-  unsigned char * line;
-
-  unsigned int j=0;
-  unsigned int i=0;
-
-  for(i=0 ; i < height ; i++)
-  {
-    line = src;
-    for( j=0 ; j < width ; j++)
-    {
-      *grey++ = (unsigned char)( 0.2126 * *(line+2)
-         + 0.7152 * *(line+1)
-         + 0.0722 * *(line+0)) ;
-      line+=3;
-    }
-
-    //go to the next line
-    src+=lineStep;
-  }
-#endif
+  convertLines(BGRToGreySerial, bgr, 3, grey, 1, width, height, flip);
 }
 
 /*!
@@ -3438,205 +3078,21 @@ void
 vpImageConvert::RGBToRGBa(unsigned char * rgb, unsigned char * rgba,
                           unsigned int width, unsigned int height, bool flip)
 {
-  //if we have to flip the image, we start from the end last scanline so the
-  //step is negative
-  int lineStep = (flip) ? -(int)(width*3) : (int)(width*3);
-
-  //starting source address = last line if we need to flip the image
-  unsigned char * src = (flip) ? (rgb+(width*height*3)+lineStep) : rgb;
-
-  unsigned int j=0;
-  unsigned int i=0;
-
-  for(i=0 ; i < height ; i++)
-  {
-    unsigned char * line = src;
-    for( j=0 ; j < width ; j++)
-    {
-      *rgba++ = *(line++);
-      *rgba++ = *(line++);
-      *rgba++ = *(line++);
-      *rgba++ = 0;
-    }
-    //go to the next line
-    src+=lineStep;
-  }
+  convertLines(RGBToRGBaSerial, rgb, 3, rgba, 4, width, height, flip);
 }
 
 /*!
   Converts a RGB image to greyscale
   Flips the image verticaly if needed
   assumes that grey is already resized
+
+  \sa RGBToGrey()
 */
 void
 vpImageConvert::RGBToGrey(unsigned char * rgb, unsigned char * grey,
                           unsigned int width, unsigned int height, bool flip)
 {
-  if(flip) {
-#if VISP_HAVE_SSSE3
-    int i = ((int) height) - 1;
-    int lineStep = -(int) (width*3);
-    rgb = rgb + (width * (height-1) * 3);
-
-    unsigned char *linePtr = rgb;
-    unsigned char r,g,b;
-
-  if(width >= 16) {
-    //Mask to select R component
-    const __m128i mask_R1 = _mm_set_epi8(
-          -1, -1, -1, -1, 15, -1, 12, -1, 9, -1, 6, -1, 3, -1, 0, -1
-          );
-    const __m128i mask_R2 = _mm_set_epi8(
-          5, -1, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
-          );
-    const __m128i mask_R3 = _mm_set_epi8(
-          -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 14, -1, 11, -1, 8, -1
-          );
-    const __m128i mask_R4 = _mm_set_epi8(
-          13, -1, 10, -1, 7, -1, 4, -1, 1, -1, -1, -1, -1, -1, -1, -1
-          );
-
-    //Mask to select G component
-    const __m128i mask_G1 = _mm_set_epi8(
-          -1, -1, -1, -1, -1, -1, 13, -1, 10, -1, 7, -1, 4, -1, 1, -1
-          );
-    const __m128i mask_G2 = _mm_set_epi8(
-          6, -1, 3, -1, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
-          );
-    const __m128i mask_G3 = _mm_set_epi8(
-          -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 15, -1, 12, -1, 9, -1
-          );
-    const __m128i mask_G4 = _mm_set_epi8(
-          14, -1, 11, -1, 8, -1, 5, -1, 2, -1, -1, -1, -1, -1, -1, -1
-          );
-
-    //Mask to select B component
-    const __m128i mask_B1 = _mm_set_epi8(
-          -1, -1, -1, -1, -1, -1, 14, -1, 11, -1, 8, -1, 5, -1, 2, -1
-          );
-    const __m128i mask_B2 = _mm_set_epi8(
-          7, -1, 4, -1, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
-          );
-    const __m128i mask_B3 = _mm_set_epi8(
-          -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 13, -1, 10, -1
-          );
-    const __m128i mask_B4 = _mm_set_epi8(
-          15, -1, 12, -1, 9, -1, 6, -1, 3, -1, 0, -1, -1, -1, -1, -1
-          );
-
-    //Mask to select the gray component
-    const __m128i mask_low1 = _mm_set_epi8(
-          -1, -1, -1, -1, -1, -1, -1, -1, 15, 13, 11, 9, 7, 5, 3, 1
-          );
-    const __m128i mask_low2 = _mm_set_epi8(
-          15, 13, 11, 9, 7, 5, 3, 1, -1, -1, -1, -1, -1, -1, -1, -1
-          );
-
-    //Coefficients RGB to Gray
-    const __m128i coeff_R = _mm_set_epi16(
-          13933, 13933, 13933, 13933, 13933, 13933, 13933, 13933
-          );
-    const __m128i coeff_G = _mm_set_epi16(
-          (short int) 46871, (short int) 46871, (short int) 46871, (short int) 46871,
-          (short int) 46871, (short int) 46871, (short int) 46871, (short int) 46871
-          );
-    const __m128i coeff_B = _mm_set_epi16(
-          4732, 4732, 4732, 4732, 4732, 4732, 4732, 4732
-          );
-
-    for(; i >= 0; i--) {
-      unsigned int j = 0;
-
-      for(; j <= width - 16; j+=16) {
-        //Process 16 color pixels
-        const __m128i data1 = _mm_loadu_si128((const __m128i*) rgb);
-        const __m128i data2 = _mm_loadu_si128((const __m128i*) (rgb + 16));
-        const __m128i data3 = _mm_loadu_si128((const __m128i*) (rgb + 32));
-
-        const __m128i red_0_7 = _mm_or_si128( _mm_shuffle_epi8(data1, mask_R1), _mm_shuffle_epi8(data2, mask_R2) );
-        const __m128i green_0_7 = _mm_or_si128( _mm_shuffle_epi8(data1, mask_G1), _mm_shuffle_epi8(data2, mask_G2) );
-        const __m128i blue_0_7 = _mm_or_si128( _mm_shuffle_epi8(data1, mask_B1), _mm_shuffle_epi8(data2, mask_B2) );
-
-        const __m128i grays_0_7 =
-            _mm_adds_epu16(
-              _mm_mulhi_epu16(red_0_7, coeff_R),
-              _mm_adds_epu16(
-                _mm_mulhi_epu16(green_0_7, coeff_G),
-                _mm_mulhi_epu16(blue_0_7,  coeff_B)
-                ));
-
-        const __m128i red_8_15 = _mm_or_si128( _mm_shuffle_epi8(data2, mask_R3), _mm_shuffle_epi8(data3, mask_R4) );
-        const __m128i green_8_15 = _mm_or_si128( _mm_shuffle_epi8(data2, mask_G3), _mm_shuffle_epi8(data3, mask_G4) );
-        const __m128i blue_8_15 = _mm_or_si128( _mm_shuffle_epi8(data2, mask_B3), _mm_shuffle_epi8(data3, mask_B4) );
-
-        const __m128i grays_8_15 =
-            _mm_adds_epu16(
-              _mm_mulhi_epu16(red_8_15, coeff_R),
-              _mm_adds_epu16(
-                _mm_mulhi_epu16(green_8_15, coeff_G),
-                _mm_mulhi_epu16(blue_8_15,  coeff_B)
-                ));
-
-        _mm_storeu_si128( (__m128i*) grey, _mm_or_si128(_mm_shuffle_epi8(grays_0_7, mask_low1), _mm_shuffle_epi8(grays_8_15, mask_low2)) );
-
-        rgb += 48;
-        grey += 16;
-      }
-
-      for(; j < width; j++) {
-        r = *(rgb++);
-        g = *(rgb++);
-        b = *(rgb++);
-        *grey++ = (unsigned char) ( 0.2126 * r + 0.7152 * g + 0.0722 * b);
-      }
-
-      linePtr += lineStep;
-      rgb = linePtr;
-    }
-  }
-
-  for(; i >= 0; i--) {
-    for(unsigned int j = 0; j < width; j++) {
-      r = *(rgb++);
-      g = *(rgb++);
-      b = *(rgb++);
-      *grey++ = (unsigned char) ( 0.2126 * r + 0.7152 * g + 0.0722 * b);
-    }
-
-    linePtr += lineStep;
-    rgb = linePtr;
-  }
-#else
-  //if we have to flip the image, we start from the end last scanline so the
-  //step is negative
-  int lineStep = (flip) ? -(int)(width*3) : (int)(width*3);
-
-  //starting source address = last line if we need to flip the image
-  unsigned char * src = (flip) ? rgb+(width*height*3)+lineStep : rgb;
-
-  unsigned int j=0;
-  unsigned int i=0;
-
-  unsigned r,g,b;
-
-  for(i=0 ; i < height ; i++)
-  {
-    unsigned char * line = src;
-    for( j=0 ; j < width ; j++)
-    {
-      r = *(line++);
-      g = *(line++);
-      b = *(line++);
-      *grey++ = (unsigned char)( 0.2126 * r + 0.7152 * g + 0.0722 * b) ;
-    }
-
-    //go to the next line
-    src+=lineStep;
-  }
-#endif
-  } else {
-    RGBToGrey(rgb, grey, width*height);
-  }
+  convertLines(RGBToGreySerial, rgb, 3, grey, 1, width, height, flip);
 }
 
 /*!
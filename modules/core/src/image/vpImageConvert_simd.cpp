@@ -0,0 +1,1160 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * SIMD kernels used by vpImageConvert.
+ *
+ *****************************************************************************/
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpCPUFeatures.h>
+
+#include "vpImageConvert_simd.h"
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+// x86 kernels are built whatever the compiler flags are, thanks to the target
+// attribute, and selected at runtime. NEON kernels are enabled at build time.
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#  define VISP_SIMD_X86 1
+#  if (_MSC_VER >= 1700) // Visual Studio 2012
+#    define VISP_SIMD_AVX2 1
+#  endif
+#  define VP_TARGET_SSE2
+#  define VP_TARGET_SSSE3
+#  define VP_TARGET_AVX2
+#elif (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))) \
+  && (defined(__i386__) || defined(__x86_64__))
+#  define VISP_SIMD_X86 1
+#  define VISP_SIMD_AVX2 1
+#  define VP_TARGET_SSE2  __attribute__((target("sse2")))
+#  define VP_TARGET_SSSE3 __attribute__((target("ssse3")))
+#  define VP_TARGET_AVX2  __attribute__((target("avx2")))
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  define VISP_SIMD_NEON 1
+#endif
+
+#if defined(VISP_SIMD_X86)
+#  include <emmintrin.h>
+#  include <tmmintrin.h>
+#  if defined(VISP_SIMD_AVX2)
+#    include <immintrin.h>
+#  endif
+#elif defined(VISP_SIMD_NEON)
+#  include <arm_neon.h>
+#endif
+
+/*
+  Fixed-point formulations shared by all the kernels, bit-exact with the
+  scalar code of vpImageConvert:
+
+  - YUYV: ((c-128)*454)>>8 and ((c-128)*359)>>8 are computed as the high word
+    of ((c-128)<<7)*908 and ((c-128)<<7)*718.
+  - YUV 4:2:2, 4:2:0: (int)((c-128)*0.354) and (int)((c-128)*0.707) are
+    computed as the high word of |c-128|*23200 and |c-128|*46334 with the sign
+    restored afterwards, which reproduces the rounding toward zero.
+  - Grey: (2126*r + 7152*g + 722*b) / 10000. The quotient is obtained with a
+    correctly rounded single precision division (x86) or with the
+    multiplication by 6871948 followed by a 36 bits shift (NEON), both exact
+    for numerators lower than 2^22.
+*/
+
+namespace {
+
+#if defined(VISP_SIMD_X86)
+
+// ----------------------------------------------------------------------------
+// SSE2 / SSSE3
+// ----------------------------------------------------------------------------
+
+// Interleave 16 R, G, B, A values and store 16 RGBa pixels
+VP_TARGET_SSE2 inline void storeRGBa_sse2(unsigned char *rgba, const __m128i &r, const __m128i &g,
+                                          const __m128i &b, const __m128i &a)
+{
+  const __m128i rg_lo = _mm_unpacklo_epi8(r, g);
+  const __m128i rg_hi = _mm_unpackhi_epi8(r, g);
+  const __m128i ba_lo = _mm_unpacklo_epi8(b, a);
+  const __m128i ba_hi = _mm_unpackhi_epi8(b, a);
+
+  _mm_storeu_si128((__m128i *) rgba,        _mm_unpacklo_epi16(rg_lo, ba_lo));
+  _mm_storeu_si128((__m128i *)(rgba + 16), _mm_unpackhi_epi16(rg_lo, ba_lo));
+  _mm_storeu_si128((__m128i *)(rgba + 32), _mm_unpacklo_epi16(rg_hi, ba_hi));
+  _mm_storeu_si128((__m128i *)(rgba + 48), _mm_unpackhi_epi16(rg_hi, ba_hi));
+}
+
+// Drop the alpha channel of 4 vectors of 4 RGBa pixels and store 16 RGB pixels
+VP_TARGET_SSSE3 inline void storeRGBaAsRGB_ssse3(unsigned char *rgb, const __m128i &p0, const __m128i &p1,
+                                                 const __m128i &p2, const __m128i &p3)
+{
+  const __m128i mask = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+  const __m128i s0 = _mm_shuffle_epi8(p0, mask);
+  const __m128i s1 = _mm_shuffle_epi8(p1, mask);
+  const __m128i s2 = _mm_shuffle_epi8(p2, mask);
+  const __m128i s3 = _mm_shuffle_epi8(p3, mask);
+
+  _mm_storeu_si128((__m128i *) rgb,        _mm_or_si128(s0, _mm_slli_si128(s1, 12)));
+  _mm_storeu_si128((__m128i *)(rgb + 16), _mm_or_si128(_mm_srli_si128(s1, 4), _mm_slli_si128(s2, 8)));
+  _mm_storeu_si128((__m128i *)(rgb + 32), _mm_or_si128(_mm_srli_si128(s2, 8), _mm_slli_si128(s3, 4)));
+}
+
+// Interleave 16 R, G, B values and store 16 RGB pixels
+VP_TARGET_SSSE3 inline void storeRGB_ssse3(unsigned char *rgb, const __m128i &r, const __m128i &g, const __m128i &b)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i rg_lo = _mm_unpacklo_epi8(r, g);
+  const __m128i rg_hi = _mm_unpackhi_epi8(r, g);
+  const __m128i b0_lo = _mm_unpacklo_epi8(b, zero);
+  const __m128i b0_hi = _mm_unpackhi_epi8(b, zero);
+
+  storeRGBaAsRGB_ssse3(rgb, _mm_unpacklo_epi16(rg_lo, b0_lo), _mm_unpackhi_epi16(rg_lo, b0_lo),
+                       _mm_unpacklo_epi16(rg_hi, b0_hi), _mm_unpackhi_epi16(rg_hi, b0_hi));
+}
+
+// Load 16 pixels of 3 bytes and expand them into 4 vectors of 4 pixels of
+// 4 bytes. The mask selects the order of the channels, the 4th byte is 0.
+VP_TARGET_SSSE3 inline void load3To4_ssse3(const unsigned char *src, const __m128i &mask,
+                                           __m128i &p0, __m128i &p1, __m128i &p2, __m128i &p3)
+{
+  const __m128i d0 = _mm_loadu_si128((const __m128i *) src);
+  const __m128i d1 = _mm_loadu_si128((const __m128i *)(src + 16));
+  const __m128i d2 = _mm_loadu_si128((const __m128i *)(src + 32));
+
+  p0 = _mm_shuffle_epi8(d0, mask);
+  p1 = _mm_shuffle_epi8(_mm_alignr_epi8(d1, d0, 12), mask);
+  p2 = _mm_shuffle_epi8(_mm_alignr_epi8(d2, d1, 8), mask);
+  p3 = _mm_shuffle_epi8(_mm_srli_si128(d2, 4), mask);
+}
+
+VP_TARGET_SSSE3 inline __m128i maskRGBToRGBa_ssse3()
+{
+  return _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+}
+
+VP_TARGET_SSSE3 inline __m128i maskBGRToRGBa_ssse3()
+{
+  return _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+}
+
+// (int)(c * k) for signed 16 bits c in [-128, 127], coeff = ceil(k * 2^16)
+VP_TARGET_SSE2 inline __m128i truncMul_sse2(const __m128i &c, const __m128i &coeff)
+{
+  const __m128i s = _mm_srai_epi16(c, 15);
+  const __m128i a = _mm_sub_epi16(_mm_xor_si128(c, s), s);
+  const __m128i q = _mm_mulhi_epu16(a, coeff);
+  return _mm_sub_epi16(_mm_xor_si128(q, s), s);
+}
+
+// R = Y + 2V, G = Y - U - V, B = Y + 5U on 8 signed 16 bits values
+VP_TARGET_SSE2 inline void yuvToRGB16_sse2(const __m128i &y, const __m128i &u, const __m128i &v,
+                                           __m128i &r, __m128i &g, __m128i &b)
+{
+  r = _mm_add_epi16(y, _mm_add_epi16(v, v));
+  g = _mm_sub_epi16(_mm_sub_epi16(y, u), v);
+  b = _mm_add_epi16(y, _mm_add_epi16(_mm_slli_epi16(u, 2), u));
+}
+
+// 8 YUYV pixels (y0 u01 y1 v01 ...) to 8 signed 16 bits R, G, B
+VP_TARGET_SSE2 inline void yuyvToRGB16_sse2(const __m128i &yuyv, __m128i &r, __m128i &g, __m128i &b)
+{
+  const __m128i y = _mm_and_si128(yuyv, _mm_set1_epi16(0x00FF));
+  const __m128i c = _mm_sub_epi16(_mm_srli_epi16(yuyv, 8), _mm_set1_epi16(128)); // u0 v0 u1 v1 ...
+
+  // ((u-128)*454)>>8 in the even words, ((v-128)*359)>>8 in the odd words
+  const __m128i cbr = _mm_mulhi_epi16(_mm_slli_epi16(c, 7),
+                                      _mm_setr_epi16(908, 718, 908, 718, 908, 718, 908, 718));
+  // ((u-128)*88 + (v-128)*183)>>8 for each pair of pixels
+  __m128i cg = _mm_srai_epi32(_mm_madd_epi16(c, _mm_setr_epi16(88, 183, 88, 183, 88, 183, 88, 183)), 8);
+  cg = _mm_packs_epi32(cg, cg);
+  cg = _mm_unpacklo_epi16(cg, cg);
+
+  const __m128i cb = _mm_shufflehi_epi16(_mm_shufflelo_epi16(cbr, _MM_SHUFFLE(2, 2, 0, 0)), _MM_SHUFFLE(2, 2, 0, 0));
+  const __m128i cr = _mm_shufflehi_epi16(_mm_shufflelo_epi16(cbr, _MM_SHUFFLE(3, 3, 1, 1)), _MM_SHUFFLE(3, 3, 1, 1));
+
+  r = _mm_add_epi16(y, cr);
+  g = _mm_sub_epi16(y, cg);
+  b = _mm_add_epi16(y, cb);
+}
+
+// 8 YUV 4:2:2 pixels (u01 y0 v01 y1 ...) to 8 signed 16 bits R, G, B
+VP_TARGET_SSE2 inline void uyvyToRGB16_sse2(const __m128i &uyvy, __m128i &r, __m128i &g, __m128i &b)
+{
+  const __m128i y = _mm_srli_epi16(uyvy, 8);
+  const __m128i c = _mm_sub_epi16(_mm_and_si128(uyvy, _mm_set1_epi16(0x00FF)), _mm_set1_epi16(128));
+  const __m128i uv = truncMul_sse2(c, _mm_setr_epi16(23200, (short) 46334, 23200, (short) 46334,
+                                                     23200, (short) 46334, 23200, (short) 46334));
+
+  const __m128i u = _mm_shufflehi_epi16(_mm_shufflelo_epi16(uv, _MM_SHUFFLE(2, 2, 0, 0)), _MM_SHUFFLE(2, 2, 0, 0));
+  const __m128i v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(uv, _MM_SHUFFLE(3, 3, 1, 1)), _MM_SHUFFLE(3, 3, 1, 1));
+  yuvToRGB16_sse2(y, u, v, r, g, b);
+}
+
+// Grey level of 4 RGBa (or RGB0) pixels, as 32 bits integers
+VP_TARGET_SSE2 inline __m128i rgbaToGrey32_sse2(const __m128i &p)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i coeffs = _mm_setr_epi16(2126, 7152, 722, 0, 2126, 7152, 722, 0);
+  const __m128 lo = _mm_castsi128_ps(_mm_madd_epi16(_mm_unpacklo_epi8(p, zero), coeffs));
+  const __m128 hi = _mm_castsi128_ps(_mm_madd_epi16(_mm_unpackhi_epi8(p, zero), coeffs));
+  const __m128i n = _mm_add_epi32(_mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0))),
+                                  _mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1))));
+  return _mm_cvttps_epi32(_mm_div_ps(_mm_cvtepi32_ps(n), _mm_set1_ps(10000.f)));
+}
+
+VP_TARGET_SSE2 inline __m128i rgbaToGrey_sse2(const __m128i &p0, const __m128i &p1,
+                                              const __m128i &p2, const __m128i &p3)
+{
+  return _mm_packus_epi16(_mm_packs_epi32(rgbaToGrey32_sse2(p0), rgbaToGrey32_sse2(p1)),
+                          _mm_packs_epi32(rgbaToGrey32_sse2(p2), rgbaToGrey32_sse2(p3)));
+}
+
+VP_TARGET_SSE2 unsigned int YUYVToRGBa_sse2(const unsigned char *yuyv, unsigned char *rgba, unsigned int size)
+{
+  const __m128i zero = _mm_setzero_si128();
+  unsigned int i = 0;
+  for (; i + 16 <= size; i += 16, yuyv += 32, rgba += 64) {
+    __m128i r0, g0, b0, r1, g1, b1;
+    yuyvToRGB16_sse2(_mm_loadu_si128((const __m128i *) yuyv), r0, g0, b0);
+    yuyvToRGB16_sse2(_mm_loadu_si128((const __m128i *)(yuyv + 16)), r1, g1, b1);
+    storeRGBa_sse2(rgba, _mm_packus_epi16(r0, r1), _mm_packus_epi16(g0, g1), _mm_packus_epi16(b0, b1), zero);
+  }
+  return i;
+}
+
+VP_TARGET_SSSE3 unsigned int YUYVToRGB_ssse3(const unsigned char *yuyv, unsigned char *rgb, unsigned int size)
+{
+  unsigned int i = 0;
+  for (; i + 16 <= size; i += 16, yuyv += 32, rgb += 48) {
+    __m128i r0, g0, b0, r1, g1, b1;
+    yuyvToRGB16_sse2(_mm_loadu_si128((const __m128i *) yuyv), r0, g0, b0);
+    yuyvToRGB16_sse2(_mm_loadu_si128((const __m128i *)(yuyv + 16)), r1, g1, b1);
+    storeRGB_ssse3(rgb, _mm_packus_epi16(r0, r1), _mm_packus_epi16(g0, g1), _mm_packus_epi16(b0, b1));
+  }
+  return i;
+}
+
+VP_TARGET_SSE2 unsigned int YUV422ToRGBa_sse2(const unsigned char *yuv, unsigned char *rgba, unsigned int size)
+{
+  const __m128i zero = _mm_setzero_si128();
+  unsigned int i = 0;
+  for (; i + 16 <= size; i += 16, yuv += 32, rgba += 64) {
+    __m128i r0, g0, b0, r1, g1, b1;
+    uyvyToRGB16_sse2(_mm_loadu_si128((const __m128i *) yuv), r0, g0, b0);
+    uyvyToRGB16_sse2(_mm_loadu_si128((const __m128i *)(yuv + 16)), r1, g1, b1);
+    storeRGBa_sse2(rgba, _mm_packus_epi16(r0, r1), _mm_packus_epi16(g0, g1), _mm_packus_epi16(b0, b1), zero);
+  }
+  return i;
+}
+
+VP_TARGET_SSSE3 unsigned int YUV422ToRGB_ssse3(const unsigned char *yuv, unsigned char *rgb, unsigned int size)
+{
+  unsigned int i = 0;
+  for (; i + 16 <= size; i += 16, yuv += 32, rgb += 48) {
+    __m128i r0, g0, b0, r1, g1, b1;
+    uyvyToRGB16_sse2(_mm_loadu_si128((const __m128i *) yuv), r0, g0, b0);
+    uyvyToRGB16_sse2(_mm_loadu_si128((const __m128i *)(yuv + 16)), r1, g1, b1);
+    storeRGB_ssse3(rgb, _mm_packus_epi16(r0, r1), _mm_packus_epi16(g0, g1), _mm_packus_epi16(b0, b1));
+  }
+  return i;
+}
+
+// Extract the luminance of 16 packed 4:2:2 pixels, stored either in the low
+// (YUYV) or in the high (UYVY) byte of each 16 bits word
+VP_TARGET_SSE2 unsigned int packedYToGrey_sse2(const unsigned char *yuv, unsigned char *grey, unsigned int size,
+                                               bool y_first)
+{
+  const __m128i mask = _mm_set1_epi16(0x00FF);
+  unsigned int i = 0;
+  for (; i + 16 <= size; i += 16, yuv += 32, grey += 16) {
+    __m128i a = _mm_loadu_si128((const __m128i *) yuv);
+    __m128i b = _mm_loadu_si128((const __m128i *)(yuv + 16));
+    if (y_first) {
+      a = _mm_and_si128(a, mask);
+      b = _mm_and_si128(b, mask);
+    }
+    else {
+      a = _mm_srli_epi16(a, 8);
+      b = _mm_srli_epi16(b, 8);
+    }
+    _mm_storeu_si128((__m128i *) grey, _mm_packus_epi16(a, b));
+  }
+  return i;
+}
+
+// 8 chroma values of a 4:2:0 line to the 16 U and V terms of the pixels
+VP_TARGET_SSE2 inline void yuv420Chroma_sse2(const unsigned char *u, const unsigned char *v,
+                                             __m128i &u_lo, __m128i &u_hi, __m128i &v_lo, __m128i &v_hi)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i offset = _mm_set1_epi16(128);
+  const __m128i cu = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) u), zero), offset);
+  const __m128i cv = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) v), zero), offset);
+  const __m128i qu = truncMul_sse2(cu, _mm_set1_epi16(23200));
+  const __m128i qv = truncMul_sse2(cv, _mm_set1_epi16((short) 46334));
+  u_lo = _mm_unpacklo_epi16(qu, qu);
+  u_hi = _mm_unpackhi_epi16(qu, qu);
+  v_lo = _mm_unpacklo_epi16(qv, qv);
+  v_hi = _mm_unpackhi_epi16(qv, qv);
+}
+
+// 16 luminance values plus their chroma terms to 16 R, G, B
+VP_TARGET_SSE2 inline void yuv420Line_sse2(const unsigned char *y, const __m128i &u_lo, const __m128i &u_hi,
+                                           const __m128i &v_lo, const __m128i &v_hi,
+                                           __m128i &r, __m128i &g, __m128i &b)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i yy = _mm_loadu_si128((const __m128i *) y);
+  __m128i r0, g0, b0, r1, g1, b1;
+  yuvToRGB16_sse2(_mm_unpacklo_epi8(yy, zero), u_lo, v_lo, r0, g0, b0);
+  yuvToRGB16_sse2(_mm_unpackhi_epi8(yy, zero), u_hi, v_hi, r1, g1, b1);
+  r = _mm_packus_epi16(r0, r1);
+  g = _mm_packus_epi16(g0, g1);
+  b = _mm_packus_epi16(b0, b1);
+}
+
+VP_TARGET_SSE2 unsigned int YUV420ToRGBa_sse2(const unsigned char *y0, const unsigned char *y1,
+                                              const unsigned char *u, const unsigned char *v,
+                                              unsigned char *rgba0, unsigned char *rgba1, unsigned int width)
+{
+  const __m128i zero = _mm_setzero_si128();
+  unsigned int i = 0;
+  for (; i + 16 <= width; i += 16) {
+    __m128i u_lo, u_hi, v_lo, v_hi, r, g, b;
+    yuv420Chroma_sse2(u + i/2, v + i/2, u_lo, u_hi, v_lo, v_hi);
+
+    yuv420Line_sse2(y0 + i, u_lo, u_hi, v_lo, v_hi, r, g, b);
+    storeRGBa_sse2(rgba0 + 4*i, r, g, b, zero);
+
+    yuv420Line_sse2(y1 + i, u_lo, u_hi, v_lo, v_hi, r, g, b);
+    storeRGBa_sse2(rgba1 + 4*i, r, g, b, zero);
+  }
+  return i;
+}
+
+VP_TARGET_SSSE3 unsigned int YUV420ToRGB_ssse3(const unsigned char *y0, const unsigned char *y1,
+                                               const unsigned char *u, const unsigned char *v,
+                                               unsigned char *rgb0, unsigned char *rgb1, unsigned int width)
+{
+  unsigned int i = 0;
+  for (; i + 16 <= width; i += 16) {
+    __m128i u_lo, u_hi, v_lo, v_hi, r, g, b;
+    yuv420Chroma_sse2(u + i/2, v + i/2, u_lo, u_hi, v_lo, v_hi);
+
+    yuv420Line_sse2(y0 + i, u_lo, u_hi, v_lo, v_hi, r, g, b);
+    storeRGB_ssse3(rgb0 + 3*i, r, g, b);
+
+    yuv420Line_sse2(y1 + i, u_lo, u_hi, v_lo, v_hi, r, g, b);
+    storeRGB_ssse3(rgb1 + 3*i, r, g, b);
+  }
+  return i;
+}
+
+VP_TARGET_SSSE3 unsigned int threeToRGBa_ssse3(const unsigned char *src, unsigned char *rgba, unsigned int size,
+                                               const __m128i &mask)
+{
+  unsigned int i = 0;
+  for (; i + 16 <= size; i += 16, src += 48, rgba += 64) {
+    __m128i p0, p1, p2, p3;
+    load3To4_ssse3(src, mask, p0, p1, p2, p3);
+    _mm_storeu_si128((__m128i *) rgba,        p0);
+    _mm_storeu_si128((__m128i *)(rgba + 16), p1);
+    _mm_storeu_si128((__m128i *)(rgba + 32), p2);
+    _mm_storeu_si128((__m128i *)(rgba + 48), p3);
+  }
+  return i;
+}
+
+VP_TARGET_SSSE3 unsigned int RGBToRGBa_ssse3(const unsigned char *rgb, unsigned char *rgba, unsigned int size)
+{
+  return threeToRGBa_ssse3(rgb, rgba, size, maskRGBToRGBa_ssse3());
+}
+
+VP_TARGET_SSSE3 unsigned int BGRToRGBa_ssse3(const unsigned char *bgr, unsigned char *rgba, unsigned int size)
+{
+  return threeToRGBa_ssse3(bgr, rgba, size, maskBGRToRGBa_ssse3());
+}
+
+VP_TARGET_SSSE3 unsigned int RGBaToRGB_ssse3(const unsigned char *rgba, unsigned char *rgb, unsigned int size)
+{
+  unsigned int i = 0;
+  for (; i + 16 <= size; i += 16, rgba += 64, rgb += 48) {
+    storeRGBaAsRGB_ssse3(rgb, _mm_loadu_si128((const __m128i *) rgba),
+                         _mm_loadu_si128((const __m128i *)(rgba + 16)),
+                         _mm_loadu_si128((const __m128i *)(rgba + 32)),
+                         _mm_loadu_si128((const __m128i *)(rgba + 48)));
+  }
+  return i;
+}
+
+VP_TARGET_SSE2 unsigned int GreyToRGBa_sse2(const unsigned char *grey, unsigned char *rgba, unsigned int size)
+{
+  unsigned int i = 0;
+  for (; i + 16 <= size; i += 16, grey += 16, rgba += 64) {
+    const __m128i g = _mm_loadu_si128((const __m128i *) grey);
+    const __m128i lo = _mm_unpacklo_epi8(g, g);
+    const __m128i hi = _mm_unpackhi_epi8(g, g);
+    _mm_storeu_si128((__m128i *) rgba,        _mm_unpacklo_epi16(lo, lo));
+    _mm_storeu_si128((__m128i *)(rgba + 16), _mm_unpackhi_epi16(lo, lo));
+    _mm_storeu_si128((__m128i *)(rgba + 32), _mm_unpacklo_epi16(hi, hi));
+    _mm_storeu_si128((__m128i *)(rgba + 48), _mm_unpackhi_epi16(hi, hi));
+  }
+  return i;
+}
+
+VP_TARGET_SSSE3 unsigned int GreyToRGB_ssse3(const unsigned char *grey, unsigned char *rgb, unsigned int size)
+{
+  const __m128i mask0 = _mm_setr_epi8(0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3, 4, 4, 4, 5);
+  const __m128i mask1 = _mm_setr_epi8(5, 5, 6, 6, 6, 7, 7, 7, 8, 8, 8, 9, 9, 9, 10, 10);
+  const __m128i mask2 = _mm_setr_epi8(10, 11, 11, 11, 12, 12, 12, 13, 13, 13, 14, 14, 14, 15, 15, 15);
+  unsigned int i = 0;
+  for (; i + 16 <= size; i += 16, grey += 16, rgb += 48) {
+    const __m128i g = _mm_loadu_si128((const __m128i *) grey);
+    _mm_storeu_si128((__m128i *) rgb,        _mm_shuffle_epi8(g, mask0));
+    _mm_storeu_si128((__m128i *)(rgb + 16), _mm_shuffle_epi8(g, mask1));
+    _mm_storeu_si128((__m128i *)(rgb + 32), _mm_shuffle_epi8(g, mask2));
+  }
+  return i;
+}
+
+VP_TARGET_SSSE3 unsigned int threeToGrey_ssse3(const unsigned char *src, unsigned char *grey, unsigned int size,
+                                               const __m128i &mask)
+{
+  unsigned int i = 0;
+  for (; i + 16 <= size; i += 16, src += 48, grey += 16) {
+    __m128i p0, p1, p2, p3;
+    load3To4_ssse3(src, mask, p0, p1, p2, p3);
+    _mm_storeu_si128((__m128i *) grey, rgbaToGrey_sse2(p0, p1, p2, p3));
+  }
+  return i;
+}
+
+VP_TARGET_SSSE3 unsigned int RGBToGrey_ssse3(const unsigned char *rgb, unsigned char *grey, unsigned int size)
+{
+  return threeToGrey_ssse3(rgb, grey, size, maskRGBToRGBa_ssse3());
+}
+
+VP_TARGET_SSSE3 unsigned int BGRToGrey_ssse3(const unsigned char *bgr, unsigned char *grey, unsigned int size)
+{
+  return threeToGrey_ssse3(bgr, grey, size, maskBGRToRGBa_ssse3());
+}
+
+VP_TARGET_SSE2 unsigned int RGBaToGrey_sse2(const unsigned char *rgba, unsigned char *grey, unsigned int size)
+{
+  unsigned int i = 0;
+  for (; i + 16 <= size; i += 16, rgba += 64, grey += 16) {
+    _mm_storeu_si128((__m128i *) grey, rgbaToGrey_sse2(_mm_loadu_si128((const __m128i *) rgba),
+                                                      _mm_loadu_si128((const __m128i *)(rgba + 16)),
+                                                      _mm_loadu_si128((const __m128i *)(rgba + 32)),
+                                                      _mm_loadu_si128((const __m128i *)(rgba + 48))));
+  }
+  return i;
+}
+
+#  if defined(VISP_SIMD_AVX2)
+
+// ----------------------------------------------------------------------------
+// AVX2
+// ----------------------------------------------------------------------------
+// Most of the AVX2 instructions work on two independent 128 bits lanes: the
+// comments give the pixel indexes held by the [low | high] lanes.
+
+// Interleave R, G, B, A holding pixels [0-7, 16-23 | 8-15, 24-31] and store
+// 32 RGBa pixels
+VP_TARGET_AVX2 inline void storeRGBa_avx2(unsigned char *rgba, const __m256i &r, const __m256i &g,
+                                          const __m256i &b, const __m256i &a)
+{
+  const __m256i rg_lo = _mm256_unpacklo_epi8(r, g); // [0-7 | 8-15]
+  const __m256i rg_hi = _mm256_unpackhi_epi8(r, g); // [16-23 | 24-31]
+  const __m256i ba_lo = _mm256_unpacklo_epi8(b, a);
+  const __m256i ba_hi = _mm256_unpackhi_epi8(b, a);
+
+  const __m256i p0 = _mm256_unpacklo_epi16(rg_lo, ba_lo); // [0-3 | 8-11]
+  const __m256i p1 = _mm256_unpackhi_epi16(rg_lo, ba_lo); // [4-7 | 12-15]
+  const __m256i p2 = _mm256_unpacklo_epi16(rg_hi, ba_hi); // [16-19 | 24-27]
+  const __m256i p3 = _mm256_unpackhi_epi16(rg_hi, ba_hi); // [20-23 | 28-31]
+
+  _mm256_storeu_si256((__m256i *) rgba,        _mm256_permute2x128_si256(p0, p1, 0x20));
+  _mm256_storeu_si256((__m256i *)(rgba + 32), _mm256_permute2x128_si256(p0, p1, 0x31));
+  _mm256_storeu_si256((__m256i *)(rgba + 64), _mm256_permute2x128_si256(p2, p3, 0x20));
+  _mm256_storeu_si256((__m256i *)(rgba + 96), _mm256_permute2x128_si256(p2, p3, 0x31));
+}
+
+VP_TARGET_AVX2 inline __m256i truncMul_avx2(const __m256i &c, const __m256i &coeff)
+{
+  const __m256i s = _mm256_srai_epi16(c, 15);
+  const __m256i a = _mm256_sub_epi16(_mm256_xor_si256(c, s), s);
+  const __m256i q = _mm256_mulhi_epu16(a, coeff);
+  return _mm256_sub_epi16(_mm256_xor_si256(q, s), s);
+}
+
+// 16 YUYV pixels to 16 signed 16 bits R, G, B [0-7 | 8-15]
+VP_TARGET_AVX2 inline void yuyvToRGB16_avx2(const __m256i &yuyv, __m256i &r, __m256i &g, __m256i &b)
+{
+  const __m256i y = _mm256_and_si256(yuyv, _mm256_set1_epi16(0x00FF));
+  const __m256i c = _mm256_sub_epi16(_mm256_srli_epi16(yuyv, 8), _mm256_set1_epi16(128));
+
+  const __m256i cbr = _mm256_mulhi_epi16(_mm256_slli_epi16(c, 7),
+                                         _mm256_setr_epi16(908, 718, 908, 718, 908, 718, 908, 718,
+                                                           908, 718, 908, 718, 908, 718, 908, 718));
+  __m256i cg = _mm256_srai_epi32(_mm256_madd_epi16(c, _mm256_setr_epi16(88, 183, 88, 183, 88, 183, 88, 183,
+                                                                         88, 183, 88, 183, 88, 183, 88, 183)), 8);
+  cg = _mm256_packs_epi32(cg, cg);
+  cg = _mm256_unpacklo_epi16(cg, cg);
+
+  const __m256i cb = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(cbr, _MM_SHUFFLE(2, 2, 0, 0)), _MM_SHUFFLE(2, 2, 0, 0));
+  const __m256i cr = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(cbr, _MM_SHUFFLE(3, 3, 1, 1)), _MM_SHUFFLE(3, 3, 1, 1));
+
+  r = _mm256_add_epi16(y, cr);
+  g = _mm256_sub_epi16(y, cg);
+  b = _mm256_add_epi16(y, cb);
+}
+
+// 16 YUV 4:2:2 pixels to 16 signed 16 bits R, G, B [0-7 | 8-15]
+VP_TARGET_AVX2 inline void uyvyToRGB16_avx2(const __m256i &uyvy, __m256i &r, __m256i &g, __m256i &b)
+{
+  const __m256i y = _mm256_srli_epi16(uyvy, 8);
+  const __m256i c = _mm256_sub_epi16(_mm256_and_si256(uyvy, _mm256_set1_epi16(0x00FF)), _mm256_set1_epi16(128));
+  const __m256i uv = truncMul_avx2(c, _mm256_setr_epi16(23200, (short) 46334, 23200, (short) 46334,
+                                                        23200, (short) 46334, 23200, (short) 46334,
+                                                        23200, (short) 46334, 23200, (short) 46334,
+                                                        23200, (short) 46334, 23200, (short) 46334));
+
+  const __m256i u = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(uv, _MM_SHUFFLE(2, 2, 0, 0)), _MM_SHUFFLE(2, 2, 0, 0));
+  const __m256i v = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(uv, _MM_SHUFFLE(3, 3, 1, 1)), _MM_SHUFFLE(3, 3, 1, 1));
+
+  r = _mm256_add_epi16(y, _mm256_add_epi16(v, v));
+  g = _mm256_sub_epi16(_mm256_sub_epi16(y, u), v);
+  b = _mm256_add_epi16(y, _mm256_add_epi16(_mm256_slli_epi16(u, 2), u));
+}
+
+// Grey level of 8 RGBa pixels, as 32 bits integers [0-3 | 4-7]
+VP_TARGET_AVX2 inline __m256i rgbaToGrey32_avx2(const __m256i &p)
+{
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i coeffs = _mm256_setr_epi16(2126, 7152, 722, 0, 2126, 7152, 722, 0,
+                                           2126, 7152, 722, 0, 2126, 7152, 722, 0);
+  const __m256i lo = _mm256_madd_epi16(_mm256_unpacklo_epi8(p, zero), coeffs); // [0,1 | 4,5]
+  const __m256i hi = _mm256_madd_epi16(_mm256_unpackhi_epi8(p, zero), coeffs); // [2,3 | 6,7]
+  const __m256i n = _mm256_hadd_epi32(lo, hi);
+  return _mm256_cvttps_epi32(_mm256_div_ps(_mm256_cvtepi32_ps(n), _mm256_set1_ps(10000.f)));
+}
+
+VP_TARGET_AVX2 unsigned int YUYVToRGBa_avx2(const unsigned char *yuyv, unsigned char *rgba, unsigned int size)
+{
+  const __m256i zero = _mm256_setzero_si256();
+  unsigned int i = 0;
+  for (; i + 32 <= size; i += 32, yuyv += 64, rgba += 128) {
+    __m256i r0, g0, b0, r1, g1, b1;
+    yuyvToRGB16_avx2(_mm256_loadu_si256((const __m256i *) yuyv), r0, g0, b0);
+    yuyvToRGB16_avx2(_mm256_loadu_si256((const __m256i *)(yuyv + 32)), r1, g1, b1);
+    storeRGBa_avx2(rgba, _mm256_packus_epi16(r0, r1), _mm256_packus_epi16(g0, g1), _mm256_packus_epi16(b0, b1), zero);
+  }
+  return i;
+}
+
+VP_TARGET_AVX2 unsigned int YUV422ToRGBa_avx2(const unsigned char *yuv, unsigned char *rgba, unsigned int size)
+{
+  const __m256i zero = _mm256_setzero_si256();
+  unsigned int i = 0;
+  for (; i + 32 <= size; i += 32, yuv += 64, rgba += 128) {
+    __m256i r0, g0, b0, r1, g1, b1;
+    uyvyToRGB16_avx2(_mm256_loadu_si256((const __m256i *) yuv), r0, g0, b0);
+    uyvyToRGB16_avx2(_mm256_loadu_si256((const __m256i *)(yuv + 32)), r1, g1, b1);
+    storeRGBa_avx2(rgba, _mm256_packus_epi16(r0, r1), _mm256_packus_epi16(g0, g1), _mm256_packus_epi16(b0, b1), zero);
+  }
+  return i;
+}
+
+VP_TARGET_AVX2 unsigned int packedYToGrey_avx2(const unsigned char *yuv, unsigned char *grey, unsigned int size,
+                                               bool y_first)
+{
+  const __m256i mask = _mm256_set1_epi16(0x00FF);
+  unsigned int i = 0;
+  for (; i + 32 <= size; i += 32, yuv += 64, grey += 32) {
+    __m256i a = _mm256_loadu_si256((const __m256i *) yuv);
+    __m256i b = _mm256_loadu_si256((const __m256i *)(yuv + 32));
+    if (y_first) {
+      a = _mm256_and_si256(a, mask);
+      b = _mm256_and_si256(b, mask);
+    }
+    else {
+      a = _mm256_srli_epi16(a, 8);
+      b = _mm256_srli_epi16(b, 8);
+    }
+    // [0-7, 16-23 | 8-15, 24-31] reordered by 64 bits blocks
+    _mm256_storeu_si256((__m256i *) grey, _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), _MM_SHUFFLE(3, 1, 2, 0)));
+  }
+  return i;
+}
+
+VP_TARGET_AVX2 unsigned int RGBaToGrey_avx2(const unsigned char *rgba, unsigned char *grey, unsigned int size)
+{
+  const __m256i perm = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+  unsigned int i = 0;
+  for (; i + 32 <= size; i += 32, rgba += 128, grey += 32) {
+    const __m256i g0 = rgbaToGrey32_avx2(_mm256_loadu_si256((const __m256i *) rgba));
+    const __m256i g1 = rgbaToGrey32_avx2(_mm256_loadu_si256((const __m256i *)(rgba + 32)));
+    const __m256i g2 = rgbaToGrey32_avx2(_mm256_loadu_si256((const __m256i *)(rgba + 64)));
+    const __m256i g3 = rgbaToGrey32_avx2(_mm256_loadu_si256((const __m256i *)(rgba + 96)));
+    // [0-3 of g0, g1, g2, g3 | 4-7 of g0, g1, g2, g3] reordered by 32 bits blocks
+    const __m256i g = _mm256_packus_epi16(_mm256_packs_epi32(g0, g1), _mm256_packs_epi32(g2, g3));
+    _mm256_storeu_si256((__m256i *) grey, _mm256_permutevar8x32_epi32(g, perm));
+  }
+  return i;
+}
+
+#  endif // VISP_SIMD_AVX2
+
+#elif defined(VISP_SIMD_NEON)
+
+// ----------------------------------------------------------------------------
+// NEON
+// ----------------------------------------------------------------------------
+
+inline int16x8_t widen_neon(uint8x8_t v)
+{
+  return vreinterpretq_s16_u16(vmovl_u8(v));
+}
+
+// (int)(c * k) for c in [-128, 127], half_coeff = ceil(k * 2^16) / 2
+inline int16x8_t truncMul_neon(int16x8_t c, int16_t half_coeff)
+{
+  const int16x8_t q = vqdmulhq_n_s16(vabsq_s16(c), half_coeff);
+  return vbslq_s16(vcltq_s16(c, vdupq_n_s16(0)), vnegq_s16(q), q);
+}
+
+inline void yuvToRGB_neon(int16x8_t y, int16x8_t u, int16x8_t v, uint8x8_t &r, uint8x8_t &g, uint8x8_t &b)
+{
+  r = vqmovun_s16(vaddq_s16(y, vaddq_s16(v, v)));
+  g = vqmovun_s16(vsubq_s16(vsubq_s16(y, u), v));
+  b = vqmovun_s16(vaddq_s16(y, vaddq_s16(vshlq_n_s16(u, 2), u)));
+}
+
+// Convert 8 YUYV macro pixels, returns R, G, B of the even and odd pixels
+inline void yuyvToRGB_neon(const uint8x8x4_t &s, uint8x8x2_t &r, uint8x8x2_t &g, uint8x8x2_t &b)
+{
+  const int16x8_t u = vsubq_s16(widen_neon(s.val[1]), vdupq_n_s16(128));
+  const int16x8_t v = vsubq_s16(widen_neon(s.val[3]), vdupq_n_s16(128));
+  const int16x8_t cb = vqdmulhq_n_s16(vshlq_n_s16(u, 7), 454);
+  const int16x8_t cr = vqdmulhq_n_s16(vshlq_n_s16(v, 7), 359);
+  const int32x4_t cg_lo = vmlal_n_s16(vmull_n_s16(vget_low_s16(u), 88), vget_low_s16(v), 183);
+  const int32x4_t cg_hi = vmlal_n_s16(vmull_n_s16(vget_high_s16(u), 88), vget_high_s16(v), 183);
+  const int16x8_t cg = vcombine_s16(vshrn_n_s32(cg_lo, 8), vshrn_n_s32(cg_hi, 8));
+
+  for (int k = 0; k < 2; k++) {
+    const int16x8_t y = widen_neon(s.val[2*k]);
+    r.val[k] = vqmovun_s16(vaddq_s16(y, cr));
+    g.val[k] = vqmovun_s16(vsubq_s16(y, cg));
+    b.val[k] = vqmovun_s16(vaddq_s16(y, cb));
+  }
+}
+
+// Convert 8 UYVY macro pixels, returns R, G, B of the even and odd pixels
+inline void uyvyToRGB_neon(const uint8x8x4_t &s, uint8x8x2_t &r, uint8x8x2_t &g, uint8x8x2_t &b)
+{
+  const int16x8_t u = truncMul_neon(vsubq_s16(widen_neon(s.val[0]), vdupq_n_s16(128)), 11600);
+  const int16x8_t v = truncMul_neon(vsubq_s16(widen_neon(s.val[2]), vdupq_n_s16(128)), 23167);
+  yuvToRGB_neon(widen_neon(s.val[1]), u, v, r.val[0], g.val[0], b.val[0]);
+  yuvToRGB_neon(widen_neon(s.val[3]), u, v, r.val[1], g.val[1], b.val[1]);
+}
+
+// Reorder even and odd pixels
+inline uint8x16_t zip_neon(const uint8x8x2_t &c)
+{
+  const uint8x8x2_t z = vzip_u8(c.val[0], c.val[1]);
+  return vcombine_u8(z.val[0], z.val[1]);
+}
+
+inline void storeRGBa_neon(unsigned char *rgba, uint8x16_t r, uint8x16_t g, uint8x16_t b)
+{
+  uint8x16x4_t d;
+  d.val[0] = r;
+  d.val[1] = g;
+  d.val[2] = b;
+  d.val[3] = vdupq_n_u8(0);
+  vst4q_u8(rgba, d);
+}
+
+inline void storeRGB_neon(unsigned char *rgb, uint8x16_t r, uint8x16_t g, uint8x16_t b)
+{
+  uint8x16x3_t d;
+  d.val[0] = r;
+  d.val[1] = g;
+  d.val[2] = b;
+  vst3q_u8(rgb, d);
+}
+
+// floor(n / 10000) = (n * 6871948) >> 36, exact for n < 2^22
+inline uint32x4_t div10000_neon(uint32x4_t n)
+{
+  const uint32x2_t lo = vshrn_n_u64(vmull_n_u32(vget_low_u32(n), 6871948), 32);
+  const uint32x2_t hi = vshrn_n_u64(vmull_n_u32(vget_high_u32(n), 6871948), 32);
+  return vshrq_n_u32(vcombine_u32(lo, hi), 4);
+}
+
+inline uint8x8_t rgbToGrey_neon(uint8x8_t r, uint8x8_t g, uint8x8_t b)
+{
+  const uint16x8_t r16 = vmovl_u8(r);
+  const uint16x8_t g16 = vmovl_u8(g);
+  const uint16x8_t b16 = vmovl_u8(b);
+  uint32x4_t n_lo = vmull_n_u16(vget_low_u16(r16), 2126);
+  n_lo = vmlal_n_u16(n_lo, vget_low_u16(g16), 7152);
+  n_lo = vmlal_n_u16(n_lo, vget_low_u16(b16), 722);
+  uint32x4_t n_hi = vmull_n_u16(vget_high_u16(r16), 2126);
+  n_hi = vmlal_n_u16(n_hi, vget_high_u16(g16), 7152);
+  n_hi = vmlal_n_u16(n_hi, vget_high_u16(b16), 722);
+  return vmovn_u16(vcombine_u16(vmovn_u32(div10000_neon(n_lo)), vmovn_u32(div10000_neon(n_hi))));
+}
+
+unsigned int YUYVToRGBa_neon(const unsigned char *yuyv, unsigned char *rgba, unsigned int size)
+{
+  unsigned int i = 0;
+  for (; i + 16 <= size; i += 16, yuyv += 32, rgba += 64) {
+    uint8x8x2_t r, g, b;
+    yuyvToRGB_neon(vld4_u8(yuyv), r, g, b);
+    storeRGBa_neon(rgba, zip_neon(r), zip_neon(g), zip_neon(b));
+  }
+  return i;
+}
+
+unsigned int YUYVToRGB_neon(const unsigned char *yuyv, unsigned char *rgb, unsigned int size)
+{
+  unsigned int i = 0;
+  for (; i + 16 <= size; i += 16, yuyv += 32, rgb += 48) {
+    uint8x8x2_t r, g, b;
+    yuyvToRGB_neon(vld4_u8(yuyv), r, g, b);
+    storeRGB_neon(rgb, zip_neon(r), zip_neon(g), zip_neon(b));
+  }
+  return i;
+}
+
+unsigned int YUV422ToRGBa_neon(const unsigned char *yuv, unsigned char *rgba, unsigned int size)
+{
+  unsigned int i = 0;
+  for (; i + 16 <= size; i += 16, yuv += 32, rgba += 64) {
+    uint8x8x2_t r, g, b;
+    uyvyToRGB_neon(vld4_u8(yuv), r, g, b);
+    storeRGBa_neon(rgba, zip_neon(r), zip_neon(g), zip_neon(b));
+  }
+  return i;
+}
+
+unsigned int YUV422ToRGB_neon(const unsigned char *yuv, unsigned char *rgb, unsigned int size)
+{
+  unsigned int i = 0;
+  for (; i + 16 <= size; i += 16, yuv += 32, rgb += 48) {
+    uint8x8x2_t r, g, b;
+    uyvyToRGB_neon(vld4_u8(yuv), r, g, b);
+    storeRGB_neon(rgb, zip_neon(r), zip_neon(g), zip_neon(b));
+  }
+  return i;
+}
+
+unsigned int packedYToGrey_neon(const unsigned char *yuv, unsigned char *grey, unsigned int size, bool y_first)
+{
+  unsigned int i = 0;
+  for (; i + 16 <= size; i += 16, yuv += 32, grey += 16) {
+    const uint8x16x2_t s = vld2q_u8(yuv);
+    vst1q_u8(grey, y_first ? s.val[0] : s.val[1]);
+  }
+  return i;
+}
+
+// 16 pixels of a 4:2:0 line
+inline void yuv420Line_neon(const unsigned char *y, const int16x8x2_t &u, const int16x8x2_t &v,
+                            uint8x16_t &r, uint8x16_t &g, uint8x16_t &b)
+{
+  const uint8x16_t yy = vld1q_u8(y);
+  uint8x8_t r0, g0, b0, r1, g1, b1;
+  yuvToRGB_neon(widen_neon(vget_low_u8(yy)), u.val[0], v.val[0], r0, g0, b0);
+  yuvToRGB_neon(widen_neon(vget_high_u8(yy)), u.val[1], v.val[1], r1, g1, b1);
+  r = vcombine_u8(r0, r1);
+  g = vcombine_u8(g0, g1);
+  b = vcombine_u8(b0, b1);
+}
+
+inline void yuv420Chroma_neon(const unsigned char *u, const unsigned char *v, int16x8x2_t &uu, int16x8x2_t &vv)
+{
+  const int16x8_t qu = truncMul_neon(vsubq_s16(widen_neon(vld1_u8(u)), vdupq_n_s16(128)), 11600);
+  const int16x8_t qv = truncMul_neon(vsubq_s16(widen_neon(vld1_u8(v)), vdupq_n_s16(128)), 23167);
+  uu = vzipq_s16(qu, qu);
+  vv = vzipq_s16(qv, qv);
+}
+
+unsigned int YUV420ToRGBa_neon(const unsigned char *y0, const unsigned char *y1,
+                               const unsigned char *u, const unsigned char *v,
+                               unsigned char *rgba0, unsigned char *rgba1, unsigned int width)
+{
+  unsigned int i = 0;
+  for (; i + 16 <= width; i += 16) {
+    int16x8x2_t uu, vv;
+    uint8x16_t r, g, b;
+    yuv420Chroma_neon(u + i/2, v + i/2, uu, vv);
+    yuv420Line_neon(y0 + i, uu, vv, r, g, b);
+    storeRGBa_neon(rgba0 + 4*i, r, g, b);
+    yuv420Line_neon(y1 + i, uu, vv, r, g, b);
+    storeRGBa_neon(rgba1 + 4*i, r, g, b);
+  }
+  return i;
+}
+
+unsigned int YUV420ToRGB_neon(const unsigned char *y0, const unsigned char *y1,
+                              const unsigned char *u, const unsigned char *v,
+                              unsigned char *rgb0, unsigned char *rgb1, unsigned int width)
+{
+  unsigned int i = 0;
+  for (; i + 16 <= width; i += 16) {
+    int16x8x2_t uu, vv;
+    uint8x16_t r, g, b;
+    yuv420Chroma_neon(u + i/2, v + i/2, uu, vv);
+    yuv420Line_neon(y0 + i, uu, vv, r, g, b);
+    storeRGB_neon(rgb0 + 3*i, r, g, b);
+    yuv420Line_neon(y1 + i, uu, vv, r, g, b);
+    storeRGB_neon(rgb1 + 3*i, r, g, b);
+  }
+  return i;
+}
+
+unsigned int threeToRGBa_neon(const unsigned char *src, unsigned char *rgba, unsigned int size, bool swap)
+{
+  unsigned int i = 0;
+  for (; i + 16 <= size; i += 16, src += 48, rgba += 64) {
+    const uint8x16x3_t s = vld3q_u8(src);
+    storeRGBa_neon(rgba, s.val[swap ? 2 : 0], s.val[1], s.val[swap ? 0 : 2]);
+  }
+  return i;
+}
+
+unsigned int RGBaToRGB_neon(const unsigned char *rgba, unsigned char *rgb, unsigned int size)
+{
+  unsigned int i = 0;
+  for (; i + 16 <= size; i += 16, rgba += 64, rgb += 48) {
+    const uint8x16x4_t s = vld4q_u8(rgba);
+    storeRGB_neon(rgb, s.val[0], s.val[1], s.val[2]);
+  }
+  return i;
+}
+
+unsigned int GreyToRGBa_neon(const unsigned char *grey, unsigned char *rgba, unsigned int size)
+{
+  unsigned int i = 0;
+  for (; i + 16 <= size; i += 16, grey += 16, rgba += 64) {
+    uint8x16x4_t d;
+    d.val[0] = d.val[1] = d.val[2] = d.val[3] = vld1q_u8(grey);
+    vst4q_u8(rgba, d);
+  }
+  return i;
+}
+
+unsigned int GreyToRGB_neon(const unsigned char *grey, unsigned char *rgb, unsigned int size)
+{
+  unsigned int i = 0;
+  for (; i + 16 <= size; i += 16, grey += 16, rgb += 48) {
+    const uint8x16_t g = vld1q_u8(grey);
+    storeRGB_neon(rgb, g, g, g);
+  }
+  return i;
+}
+
+unsigned int threeToGrey_neon(const unsigned char *src, unsigned char *grey, unsigned int size, bool swap)
+{
+  unsigned int i = 0;
+  for (; i + 8 <= size; i += 8, src += 24, grey += 8) {
+    const uint8x8x3_t s = vld3_u8(src);
+    vst1_u8(grey, rgbToGrey_neon(s.val[swap ? 2 : 0], s.val[1], s.val[swap ? 0 : 2]));
+  }
+  return i;
+}
+
+unsigned int RGBaToGrey_neon(const unsigned char *rgba, unsigned char *grey, unsigned int size)
+{
+  unsigned int i = 0;
+  for (; i + 8 <= size; i += 8, rgba += 32, grey += 8) {
+    const uint8x8x4_t s = vld4_u8(rgba);
+    vst1_u8(grey, rgbToGrey_neon(s.val[0], s.val[1], s.val[2]));
+  }
+  return i;
+}
+
+#endif
+
+} // namespace
+
+// ----------------------------------------------------------------------------
+// Runtime dispatch
+// ----------------------------------------------------------------------------
+
+unsigned int vp_simd_YUYVToRGBa(const unsigned char *yuyv, unsigned char *rgba, unsigned int size)
+{
+#if defined(VISP_SIMD_X86)
+#  if defined(VISP_SIMD_AVX2)
+  if (vpCPUFeatures::checkAVX2())
+    return YUYVToRGBa_avx2(yuyv, rgba, size);
+#  endif
+  if (vpCPUFeatures::checkSSE2())
+    return YUYVToRGBa_sse2(yuyv, rgba, size);
+  return 0;
+#elif defined(VISP_SIMD_NEON)
+  return YUYVToRGBa_neon(yuyv, rgba, size);
+#else
+  (void)yuyv; (void)rgba; (void)size;
+  return 0;
+#endif
+}
+
+unsigned int vp_simd_YUYVToRGB(const unsigned char *yuyv, unsigned char *rgb, unsigned int size)
+{
+#if defined(VISP_SIMD_X86)
+  if (vpCPUFeatures::checkSSSE3())
+    return YUYVToRGB_ssse3(yuyv, rgb, size);
+  return 0;
+#elif defined(VISP_SIMD_NEON)
+  return YUYVToRGB_neon(yuyv, rgb, size);
+#else
+  (void)yuyv; (void)rgb; (void)size;
+  return 0;
+#endif
+}
+
+unsigned int vp_simd_YUYVToGrey(const unsigned char *yuyv, unsigned char *grey, unsigned int size)
+{
+#if defined(VISP_SIMD_X86)
+#  if defined(VISP_SIMD_AVX2)
+  if (vpCPUFeatures::checkAVX2())
+    return packedYToGrey_avx2(yuyv, grey, size, true);
+#  endif
+  if (vpCPUFeatures::checkSSE2())
+    return packedYToGrey_sse2(yuyv, grey, size, true);
+  return 0;
+#elif defined(VISP_SIMD_NEON)
+  return packedYToGrey_neon(yuyv, grey, size, true);
+#else
+  (void)yuyv; (void)grey; (void)size;
+  return 0;
+#endif
+}
+
+unsigned int vp_simd_YUV422ToRGBa(const unsigned char *yuv, unsigned char *rgba, unsigned int size)
+{
+#if defined(VISP_SIMD_X86)
+#  if defined(VISP_SIMD_AVX2)
+  if (vpCPUFeatures::checkAVX2())
+    return YUV422ToRGBa_avx2(yuv, rgba, size);
+#  endif
+  if (vpCPUFeatures::checkSSE2())
+    return YUV422ToRGBa_sse2(yuv, rgba, size);
+  return 0;
+#elif defined(VISP_SIMD_NEON)
+  return YUV422ToRGBa_neon(yuv, rgba, size);
+#else
+  (void)yuv; (void)rgba; (void)size;
+  return 0;
+#endif
+}
+
+unsigned int vp_simd_YUV422ToRGB(const unsigned char *yuv, unsigned char *rgb, unsigned int size)
+{
+#if defined(VISP_SIMD_X86)
+  if (vpCPUFeatures::checkSSSE3())
+    return YUV422ToRGB_ssse3(yuv, rgb, size);
+  return 0;
+#elif defined(VISP_SIMD_NEON)
+  return YUV422ToRGB_neon(yuv, rgb, size);
+#else
+  (void)yuv; (void)rgb; (void)size;
+  return 0;
+#endif
+}
+
+unsigned int vp_simd_YUV422ToGrey(const unsigned char *yuv, unsigned char *grey, unsigned int size)
+{
+#if defined(VISP_SIMD_X86)
+#  if defined(VISP_SIMD_AVX2)
+  if (vpCPUFeatures::checkAVX2())
+    return packedYToGrey_avx2(yuv, grey, size, false);
+#  endif
+  if (vpCPUFeatures::checkSSE2())
+    return packedYToGrey_sse2(yuv, grey, size, false);
+  return 0;
+#elif defined(VISP_SIMD_NEON)
+  return packedYToGrey_neon(yuv, grey, size, false);
+#else
+  (void)yuv; (void)grey; (void)size;
+  return 0;
+#endif
+}
+
+unsigned int vp_simd_YUV420ToRGBa(const unsigned char *y0, const unsigned char *y1,
+                                  const unsigned char *u, const unsigned char *v,
+                                  unsigned char *rgba0, unsigned char *rgba1, unsigned int width)
+{
+#if defined(VISP_SIMD_X86)
+  if (vpCPUFeatures::checkSSE2())
+    return YUV420ToRGBa_sse2(y0, y1, u, v, rgba0, rgba1, width);
+  return 0;
+#elif defined(VISP_SIMD_NEON)
+  return YUV420ToRGBa_neon(y0, y1, u, v, rgba0, rgba1, width);
+#else
+  (void)y0; (void)y1; (void)u; (void)v; (void)rgba0; (void)rgba1; (void)width;
+  return 0;
+#endif
+}
+
+unsigned int vp_simd_YUV420ToRGB(const unsigned char *y0, const unsigned char *y1,
+                                 const unsigned char *u, const unsigned char *v,
+                                 unsigned char *rgb0, unsigned char *rgb1, unsigned int width)
+{
+#if defined(VISP_SIMD_X86)
+  if (vpCPUFeatures::checkSSSE3())
+    return YUV420ToRGB_ssse3(y0, y1, u, v, rgb0, rgb1, width);
+  return 0;
+#elif defined(VISP_SIMD_NEON)
+  return YUV420ToRGB_neon(y0, y1, u, v, rgb0, rgb1, width);
+#else
+  (void)y0; (void)y1; (void)u; (void)v; (void)rgb0; (void)rgb1; (void)width;
+  return 0;
+#endif
+}
+
+unsigned int vp_simd_RGBToRGBa(const unsigned char *rgb, unsigned char *rgba, unsigned int size)
+{
+#if defined(VISP_SIMD_X86)
+  if (vpCPUFeatures::checkSSSE3())
+    return RGBToRGBa_ssse3(rgb, rgba, size);
+  return 0;
+#elif defined(VISP_SIMD_NEON)
+  return threeToRGBa_neon(rgb, rgba, size, false);
+#else
+  (void)rgb; (void)rgba; (void)size;
+  return 0;
+#endif
+}
+
+unsigned int vp_simd_BGRToRGBa(const unsigned char *bgr, unsigned char *rgba, unsigned int size)
+{
+#if defined(VISP_SIMD_X86)
+  if (vpCPUFeatures::checkSSSE3())
+    return BGRToRGBa_ssse3(bgr, rgba, size);
+  return 0;
+#elif defined(VISP_SIMD_NEON)
+  return threeToRGBa_neon(bgr, rgba, size, true);
+#else
+  (void)bgr; (void)rgba; (void)size;
+  return 0;
+#endif
+}
+
+unsigned int vp_simd_RGBaToRGB(const unsigned char *rgba, unsigned char *rgb, unsigned int size)
+{
+#if defined(VISP_SIMD_X86)
+  if (vpCPUFeatures::checkSSSE3())
+    return RGBaToRGB_ssse3(rgba, rgb, size);
+  return 0;
+#elif defined(VISP_SIMD_NEON)
+  return RGBaToRGB_neon(rgba, rgb, size);
+#else
+  (void)rgba; (void)rgb; (void)size;
+  return 0;
+#endif
+}
+
+unsigned int vp_simd_GreyToRGBa(const unsigned char *grey, unsigned char *rgba, unsigned int size)
+{
+#if defined(VISP_SIMD_X86)
+  if (vpCPUFeatures::checkSSE2())
+    return GreyToRGBa_sse2(grey, rgba, size);
+  return 0;
+#elif defined(VISP_SIMD_NEON)
+  return GreyToRGBa_neon(grey, rgba, size);
+#else
+  (void)grey; (void)rgba; (void)size;
+  return 0;
+#endif
+}
+
+unsigned int vp_simd_GreyToRGB(const unsigned char *grey, unsigned char *rgb, unsigned int size)
+{
+#if defined(VISP_SIMD_X86)
+  if (vpCPUFeatures::checkSSSE3())
+    return GreyToRGB_ssse3(grey, rgb, size);
+  return 0;
+#elif defined(VISP_SIMD_NEON)
+  return GreyToRGB_neon(grey, rgb, size);
+#else
+  (void)grey; (void)rgb; (void)size;
+  return 0;
+#endif
+}
+
+unsigned int vp_simd_RGBToGrey(const unsigned char *rgb, unsigned char *grey, unsigned int size)
+{
+#if defined(VISP_SIMD_X86)
+  if (vpCPUFeatures::checkSSSE3())
+    return RGBToGrey_ssse3(rgb, grey, size);
+  return 0;
+#elif defined(VISP_SIMD_NEON)
+  return threeToGrey_neon(rgb, grey, size, false);
+#else
+  (void)rgb; (void)grey; (void)size;
+  return 0;
+#endif
+}
+
+unsigned int vp_simd_BGRToGrey(const unsigned char *bgr, unsigned char *grey, unsigned int size)
+{
+#if defined(VISP_SIMD_X86)
+  if (vpCPUFeatures::checkSSSE3())
+    return BGRToGrey_ssse3(bgr, grey, size);
+  return 0;
+#elif defined(VISP_SIMD_NEON)
+  return threeToGrey_neon(bgr, grey, size, true);
+#else
+  (void)bgr; (void)grey; (void)size;
+  return 0;
+#endif
+}
+
+unsigned int vp_simd_RGBaToGrey(const unsigned char *rgba, unsigned char *grey, unsigned int size)
+{
+#if defined(VISP_SIMD_X86)
+#  if defined(VISP_SIMD_AVX2)
+  if (vpCPUFeatures::checkAVX2())
+    return RGBaToGrey_avx2(rgba, grey, size);
+#  endif
+  if (vpCPUFeatures::checkSSE2())
+    return RGBaToGrey_sse2(rgba, grey, size);
+  return 0;
+#elif defined(VISP_SIMD_NEON)
+  return RGBaToGrey_neon(rgba, grey, size);
+#else
+  (void)rgba; (void)grey; (void)size;
+  return 0;
+#endif
+}
+
+#endif // DOXYGEN_SHOULD_SKIP_THIS
@@ -0,0 +1,80 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * SIMD kernels used by vpImageConvert.
+ *
+ *****************************************************************************/
+
+#ifndef __vpImageConvert_simd_h_
+#define __vpImageConvert_simd_h_
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+/*
+  SIMD (SSE2, SSSE3, AVX2 or NEON) kernels used by vpImageConvert. The
+  instruction set is selected at runtime with vpCPUFeatures.
+
+  Each kernel converts the longest prefix of the buffer it can process with
+  full vectors and returns the number of pixels it converted (0 when no
+  suitable instruction set is available). The caller converts the remaining
+  pixels with the scalar code, which is the reference: all the kernels are
+  bit-exact with it.
+*/
+
+unsigned int vp_simd_YUYVToRGBa(const unsigned char *yuyv, unsigned char *rgba, unsigned int size);
+unsigned int vp_simd_YUYVToRGB(const unsigned char *yuyv, unsigned char *rgb, unsigned int size);
+unsigned int vp_simd_YUYVToGrey(const unsigned char *yuyv, unsigned char *grey, unsigned int size);
+
+unsigned int vp_simd_YUV422ToRGBa(const unsigned char *yuv, unsigned char *rgba, unsigned int size);
+unsigned int vp_simd_YUV422ToRGB(const unsigned char *yuv, unsigned char *rgb, unsigned int size);
+unsigned int vp_simd_YUV422ToGrey(const unsigned char *yuv, unsigned char *grey, unsigned int size);
+
+// Planar 4:2:0 (YUV420, YV12): converts the first pixels of two consecutive
+// lines sharing the same chroma line
+unsigned int vp_simd_YUV420ToRGBa(const unsigned char *y0, const unsigned char *y1,
+                                  const unsigned char *u, const unsigned char *v,
+                                  unsigned char *rgba0, unsigned char *rgba1, unsigned int width);
+unsigned int vp_simd_YUV420ToRGB(const unsigned char *y0, const unsigned char *y1,
+                                 const unsigned char *u, const unsigned char *v,
+                                 unsigned char *rgb0, unsigned char *rgb1, unsigned int width);
+
+unsigned int vp_simd_RGBToRGBa(const unsigned char *rgb, unsigned char *rgba, unsigned int size);
+unsigned int vp_simd_BGRToRGBa(const unsigned char *bgr, unsigned char *rgba, unsigned int size);
+unsigned int vp_simd_RGBaToRGB(const unsigned char *rgba, unsigned char *rgb, unsigned int size);
+unsigned int vp_simd_GreyToRGBa(const unsigned char *grey, unsigned char *rgba, unsigned int size);
+unsigned int vp_simd_GreyToRGB(const unsigned char *grey, unsigned char *rgb, unsigned int size);
+
+unsigned int vp_simd_RGBToGrey(const unsigned char *rgb, unsigned char *grey, unsigned int size);
+unsigned int vp_simd_BGRToGrey(const unsigned char *bgr, unsigned char *grey, unsigned int size);
+unsigned int vp_simd_RGBaToGrey(const unsigned char *rgba, unsigned char *grey, unsigned int size);
+
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+#endif
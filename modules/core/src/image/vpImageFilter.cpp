@@ -37,6 +37,7 @@
 
 #include <visp3/core/vpImageFilter.h>
 #include <visp3/core/vpImageConvert.h>
+#include <visp3/core/vpThreadPool.h>
 #if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020408)
 #  include <opencv2/imgproc/imgproc.hpp>
 #elif defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020101)
@@ -45,6 +46,306 @@
 #  include <cv.h>
 #endif
 
+#include <vector>
+
+namespace {
+// Number of pixels below which a filter is not split between threads
+const unsigned int vpMinPixelsPerBand = 1 << 14;
+
+unsigned int minRowsPerBand(unsigned int width)
+{
+  return vpMinPixelsPerBand / (width + 1) + 1;
+}
+
+// Index of the pixel that replaces the pixel i outside of [0, n). This is the
+// mirroring of vpImageFilter::filterXLeftBorder() and filterXRightBorder()
+inline unsigned int borderIndex(int i, unsigned int n)
+{
+  if (i < 0)
+    i = -i;
+  else if (i >= (int)n)
+    i = 2 * (int)n - i - 1;
+  return (unsigned int)vpMath::maximum(vpMath::minimum(i, (int)n - 1), 0);
+}
+
+/*
+  Separable filtering. The borders are handled by copying each row in a
+  padded buffer (horizontal pass) or by mirroring the row pointers (vertical
+  pass), so that the inner loops run over contiguous pixels without any
+  branch and can be vectorized. The operations are done in the same order
+  than in the per-pixel vpImageFilter::filterX() and filterY() functions.
+*/
+template<class TIn, class T>
+struct vpSeparableFilterData
+{
+  const vpImage<TIn> *I;
+  vpImage<T> *If;
+  const T *filter;
+  unsigned int size;
+};
+
+template<class TIn, class T>
+void filterXBand(unsigned int begin, unsigned int end, void *arg)
+{
+  vpSeparableFilterData<TIn, T> *data = static_cast<vpSeparableFilterData<TIn, T> *>(arg);
+  const unsigned int width = data->I->getWidth();
+  const unsigned int half = (data->size - 1) / 2;
+  const T *filter = data->filter;
+  std::vector<T> padded(width + 2 * half);
+
+  for (unsigned int i = begin; i < end; i++) {
+    const TIn *src = (*data->I)[i];
+    T *dst = (*data->If)[i];
+
+    for (unsigned int j = 0; j < half; j++) {
+      padded[j] = static_cast<T>(src[borderIndex((int)j - (int)half, width)]);
+      padded[half + width + j] = static_cast<T>(src[borderIndex((int)(width + j), width)]);
+    }
+    for (unsigned int j = 0; j < width; j++)
+      padded[half + j] = static_cast<T>(src[j]);
+
+    const T *p = &padded[half];
+    for (unsigned int j = 0; j < width; j++)
+      dst[j] = 0;
+    for (unsigned int k = 1; k <= half; k++) {
+      const T f = filter[k];
+      const T *left = p - k;
+      const T *right = p + k;
+      for (unsigned int j = 0; j < width; j++)
+        dst[j] += f * (right[j] + left[j]);
+    }
+    const T f0 = filter[0];
+    for (unsigned int j = 0; j < width; j++)
+      dst[j] += f0 * p[j];
+  }
+}
+
+template<class TIn, class T>
+void filterYBand(unsigned int begin, unsigned int end, void *arg)
+{
+  vpSeparableFilterData<TIn, T> *data = static_cast<vpSeparableFilterData<TIn, T> *>(arg);
+  const unsigned int width = data->I->getWidth();
+  const unsigned int height = data->I->getHeight();
+  const unsigned int half = (data->size - 1) / 2;
+  const T *filter = data->filter;
+
+  for (unsigned int i = begin; i < end; i++) {
+    T *dst = (*data->If)[i];
+
+    for (unsigned int j = 0; j < width; j++)
+      dst[j] = 0;
+    for (unsigned int k = 1; k <= half; k++) {
+      const T f = filter[k];
+      const TIn *top = (*data->I)[borderIndex((int)i - (int)k, height)];
+      const TIn *bottom = (*data->I)[borderIndex((int)(i + k), height)];
+      for (unsigned int j = 0; j < width; j++)
+        dst[j] += f * (static_cast<T>(bottom[j]) + static_cast<T>(top[j]));
+    }
+    const T f0 = filter[0];
+    const TIn *center = (*data->I)[i];
+    for (unsigned int j = 0; j < width; j++)
+      dst[j] += f0 * static_cast<T>(center[j]);
+  }
+}
+
+template<class TIn, class T>
+void filterX(const vpImage<TIn> &I, vpImage<T> &If, const T *filter, unsigned int size)
+{
+  If.resize(I.getHeight(), I.getWidth());
+  vpSeparableFilterData<TIn, T> data;
+  data.I = &I;
+  data.If = &If;
+  data.filter = filter;
+  data.size = size;
+  vpThreadPool::parallelFor(0, I.getHeight(), filterXBand<TIn, T>, &data, minRowsPerBand(I.getWidth()));
+}
+
+template<class TIn, class T>
+void filterY(const vpImage<TIn> &I, vpImage<T> &If, const T *filter, unsigned int size)
+{
+  If.resize(I.getHeight(), I.getWidth());
+  vpSeparableFilterData<TIn, T> data;
+  data.I = &I;
+  data.If = &If;
+  data.filter = filter;
+  data.size = size;
+  vpThreadPool::parallelFor(0, I.getHeight(), filterYBand<TIn, T>, &data, minRowsPerBand(I.getWidth()));
+}
+
+/*
+  Derivative filters. The pixels closer to the border than the half size of
+  the filter are set to 0.
+*/
+template<class TIn, class T>
+void gradXBand(unsigned int begin, unsigned int end, void *arg)
+{
+  vpSeparableFilterData<TIn, T> *data = static_cast<vpSeparableFilterData<TIn, T> *>(arg);
+  const unsigned int width = data->I->getWidth();
+  const unsigned int half = (data->size - 1) / 2;
+  const unsigned int jmax = width > half ? width - half : 0;
+  const T *filter = data->filter;
+
+  for (unsigned int i = begin; i < end; i++) {
+    const TIn *src = (*data->I)[i];
+    T *dst = (*data->If)[i];
+
+    for (unsigned int j = 0; j < width; j++)
+      dst[j] = 0;
+    for (unsigned int k = 1; k <= half; k++) {
+      const T f = filter[k];
+      for (unsigned int j = half; j < jmax; j++)
+        dst[j] += f * (static_cast<T>(src[j + k]) - static_cast<T>(src[j - k]));
+    }
+  }
+}
+
+template<class TIn, class T>
+void gradYBand(unsigned int begin, unsigned int end, void *arg)
+{
+  vpSeparableFilterData<TIn, T> *data = static_cast<vpSeparableFilterData<TIn, T> *>(arg);
+  const unsigned int width = data->I->getWidth();
+  const unsigned int height = data->I->getHeight();
+  const unsigned int half = (data->size - 1) / 2;
+  const T *filter = data->filter;
+
+  for (unsigned int i = begin; i < end; i++) {
+    T *dst = (*data->If)[i];
+
+    for (unsigned int j = 0; j < width; j++)
+      dst[j] = 0;
+    if (i < half || i + half >= height)
+      continue;
+    for (unsigned int k = 1; k <= half; k++) {
+      const T f = filter[k];
+      const TIn *top = (*data->I)[i - k];
+      const TIn *bottom = (*data->I)[i + k];
+      for (unsigned int j = 0; j < width; j++)
+        dst[j] += f * (static_cast<T>(bottom[j]) - static_cast<T>(top[j]));
+    }
+  }
+}
+
+template<class TIn, class T>
+void getGradX(const vpImage<TIn> &I, vpImage<T> &dIx, const T *filter, unsigned int size)
+{
+  dIx.resize(I.getHeight(), I.getWidth());
+  vpSeparableFilterData<TIn, T> data;
+  data.I = &I;
+  data.If = &dIx;
+  data.filter = filter;
+  data.size = size;
+  vpThreadPool::parallelFor(0, I.getHeight(), gradXBand<TIn, T>, &data, minRowsPerBand(I.getWidth()));
+}
+
+template<class TIn, class T>
+void getGradY(const vpImage<TIn> &I, vpImage<T> &dIy, const T *filter, unsigned int size)
+{
+  dIy.resize(I.getHeight(), I.getWidth());
+  vpSeparableFilterData<TIn, T> data;
+  data.I = &I;
+  data.If = &dIy;
+  data.filter = filter;
+  data.size = size;
+  vpThreadPool::parallelFor(0, I.getHeight(), gradYBand<TIn, T>, &data, minRowsPerBand(I.getWidth()));
+}
+
+// Same computation than vpImageFilter::derivativeFilterX() and derivativeFilterY()
+template<class T>
+void derivativeBand(unsigned int begin, unsigned int end, void *arg, bool alongX)
+{
+  vpSeparableFilterData<unsigned char, T> *data = static_cast<vpSeparableFilterData<unsigned char, T> *>(arg);
+  const vpImage<unsigned char> &I = *data->I;
+  const unsigned int width = I.getWidth();
+  const unsigned int height = I.getHeight();
+
+  for (unsigned int i = begin; i < end; i++) {
+    T *dst = (*data->If)[i];
+    for (unsigned int j = 0; j < width; j++)
+      dst[j] = 0;
+
+    if (alongX) {
+      const unsigned char *src = I[i];
+      for (unsigned int j = 3; j + 3 < width; j++) {
+        dst[j] = (static_cast<T>(2047.0) * (src[j+1] - src[j-1])
+                  + static_cast<T>(913.0) * (src[j+2] - src[j-2])
+                  + static_cast<T>(112.0) * (src[j+3] - src[j-3])) / static_cast<T>(8418.0);
+      }
+    }
+    else if (i >= 3 && i + 3 < height) {
+      const unsigned char *m1 = I[i-1], *m2 = I[i-2], *m3 = I[i-3];
+      const unsigned char *p1 = I[i+1], *p2 = I[i+2], *p3 = I[i+3];
+      for (unsigned int j = 0; j < width; j++) {
+        dst[j] = (static_cast<T>(2047.0) * (p1[j] - m1[j])
+                  + static_cast<T>(913.0) * (p2[j] - m2[j])
+                  + static_cast<T>(112.0) * (p3[j] - m3[j])) / static_cast<T>(8418.0);
+      }
+    }
+  }
+}
+
+template<class T>
+void derivativeXBand(unsigned int begin, unsigned int end, void *arg)
+{
+  derivativeBand<T>(begin, end, arg, true);
+}
+
+template<class T>
+void derivativeYBand(unsigned int begin, unsigned int end, void *arg)
+{
+  derivativeBand<T>(begin, end, arg, false);
+}
+
+template<class T>
+void getDerivative(const vpImage<unsigned char> &I, vpImage<T> &dI, bool alongX)
+{
+  dI.resize(I.getHeight(), I.getWidth());
+  vpSeparableFilterData<unsigned char, T> data;
+  data.I = &I;
+  data.If = &dI;
+  data.filter = NULL;
+  data.size = 7;
+  vpThreadPool::parallelFor(0, I.getHeight(), alongX ? derivativeXBand<T> : derivativeYBand<T>, &data,
+                            minRowsPerBand(I.getWidth()));
+}
+
+// Vertical pass of the fixed point Gaussian filter: the horizontal pass
+// gives 8 bits fractional values, the rounded result is scaled back to 8 bits
+struct vpFixedPointFilterData
+{
+  const vpImage<unsigned short> *I;
+  vpImage<unsigned char> *If;
+  const unsigned short *filter;
+  unsigned int size;
+};
+
+void fixedPointFilterYBand(unsigned int begin, unsigned int end, void *arg)
+{
+  vpFixedPointFilterData *data = static_cast<vpFixedPointFilterData *>(arg);
+  const unsigned int width = data->I->getWidth();
+  const unsigned int height = data->I->getHeight();
+  const unsigned int half = (data->size - 1) / 2;
+  const unsigned short *filter = data->filter;
+  std::vector<unsigned int> acc(width);
+
+  for (unsigned int i = begin; i < end; i++) {
+    const unsigned short *center = (*data->I)[i];
+    const unsigned int f0 = filter[0];
+    for (unsigned int j = 0; j < width; j++)
+      acc[j] = f0 * center[j] + (1u << 15);
+    for (unsigned int k = 1; k <= half; k++) {
+      const unsigned int f = filter[k];
+      const unsigned short *top = (*data->I)[borderIndex((int)i - (int)k, height)];
+      const unsigned short *bottom = (*data->I)[borderIndex((int)(i + k), height)];
+      for (unsigned int j = 0; j < width; j++)
+        acc[j] += f * ((unsigned int)bottom[j] + top[j]);
+    }
+    unsigned char *dst = (*data->If)[i];
+    for (unsigned int j = 0; j < width; j++)
+      dst[j] = (unsigned char)(acc[j] >> 16);
+  }
+}
+}
+
 /*!
   Apply a filter to an image.
 
@@ -221,97 +522,107 @@ void vpImageFilter::filter(const vpImage<double> &I, vpImage<double>& GI, const
   GIx.destroy();
 }
 
+/*!
+  Apply a separable filter. The computation is done in single precision.
+ */
+void vpImageFilter::filter(const vpImage<unsigned char> &I, vpImage<float>& GI, const float *filter, unsigned int size)
+{
+  vpImage<float> GIx ;
+  filterX(I, GIx,filter,size);
+  filterY(GIx, GI,filter,size);
+}
+
+/*!
+  Apply a separable filter. The computation is done in single precision.
+ */
+void vpImageFilter::filter(const vpImage<float> &I, vpImage<float>& GI, const float *filter, unsigned int size)
+{
+  vpImage<float> GIx ;
+  filterX(I, GIx,filter,size);
+  filterY(GIx, GI,filter,size);
+}
+
+/*!
+  Apply a 1 x size filter along the rows of an image. The kernel is symmetric,
+  the borders are mirrored as in filterXLeftBorder() and filterXRightBorder().
+
+  \param I : Image to filter.
+  \param dIx : Filtered image.
+  \param filter : Pointer to the (size+1)/2 first coefficients of the kernel
+  (see getGaussianKernel()).
+  \param size : Filter size. This value should be odd.
+ */
 void vpImageFilter::filterX(const vpImage<unsigned char> &I, vpImage<double>& dIx, const double *filter,unsigned  int size)
 {
-  dIx.resize(I.getHeight(),I.getWidth()) ;
-  for (unsigned int i=0 ; i < I.getHeight() ; i++)
-  {
-    for (unsigned int j=0 ; j < (size-1)/2 ; j++)
-    {
-      dIx[i][j]=vpImageFilter::filterXLeftBorder(I,i,j,filter,size);
-      //dIx[i][j]=0;
-    }
-    for (unsigned int j=(size-1)/2 ; j < I.getWidth()-(size-1)/2 ; j++)
-    {
-      dIx[i][j]=vpImageFilter::filterX(I,i,j,filter,size);
-    }
-    for (unsigned int j=I.getWidth()-(size-1)/2 ; j < I.getWidth() ; j++)
-    {
-      dIx[i][j]=vpImageFilter::filterXRightBorder(I,i,j,filter,size);
-      //dIx[i][j]=0;
-    }
-  }
+  ::filterX(I, dIx, filter, size);
 }
+
+/*!
+  \overload
+ */
 void vpImageFilter::filterX(const vpImage<double> &I, vpImage<double>& dIx, const double *filter,unsigned  int size)
 {
-  dIx.resize(I.getHeight(),I.getWidth()) ;
-  for (unsigned int i=0 ; i < I.getHeight() ; i++)
-  {
-    for (unsigned int j=0 ; j < (size-1)/2 ; j++)
-    {
-      dIx[i][j]=vpImageFilter::filterXLeftBorder(I,i,j,filter,size);
-      //dIx[i][j]=0;
-    }
-    for (unsigned int j=(size-1)/2 ; j < I.getWidth()-(size-1)/2 ; j++)
-    {
-      dIx[i][j]=vpImageFilter::filterX(I,i,j,filter,size);
-    }
-    for (unsigned int j=I.getWidth()-(size-1)/2 ; j < I.getWidth() ; j++)
-    {
-      dIx[i][j]=vpImageFilter::filterXRightBorder(I,i,j,filter,size);
-      //dIx[i][j]=0;
-    }
-  }
+  ::filterX(I, dIx, filter, size);
 }
+
+/*!
+  \overload
+
+  The computation is done in single precision.
+ */
+void vpImageFilter::filterX(const vpImage<unsigned char> &I, vpImage<float>& dIx, const float *filter, unsigned int size)
+{
+  ::filterX(I, dIx, filter, size);
+}
+
+/*!
+  \overload
+ */
+void vpImageFilter::filterX(const vpImage<float> &I, vpImage<float>& dIx, const float *filter, unsigned int size)
+{
+  ::filterX(I, dIx, filter, size);
+}
+
+/*!
+  Apply a size x 1 filter along the columns of an image. The kernel is
+  symmetric, the borders are mirrored as in filterYTopBorder() and
+  filterYBottomBorder().
+
+  \param I : Image to filter.
+  \param dIy : Filtered image.
+  \param filter : Pointer to the (size+1)/2 first coefficients of the kernel
+  (see getGaussianKernel()).
+  \param size : Filter size. This value should be odd.
+ */
 void vpImageFilter::filterY(const vpImage<unsigned char> &I, vpImage<double>& dIy, const double *filter,unsigned  int size)
 {
-  dIy.resize(I.getHeight(),I.getWidth()) ;
-  for (unsigned int i=0 ; i < (size-1)/2 ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=vpImageFilter::filterYTopBorder(I,i,j,filter,size);
-    }
-  }
-  for (unsigned int i=(size-1)/2 ; i < I.getHeight()-(size-1)/2 ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=vpImageFilter::filterY(I,i,j,filter,size);
-    }
-  }
-  for (unsigned int i=I.getHeight()-(size-1)/2 ; i < I.getHeight() ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=vpImageFilter::filterYBottomBorder(I,i,j,filter,size);
-    }
-  }
+  ::filterY(I, dIy, filter, size);
 }
+
+/*!
+  \overload
+ */
 void vpImageFilter::filterY(const vpImage<double> &I, vpImage<double>& dIy, const double *filter,unsigned  int size)
 {
-  dIy.resize(I.getHeight(),I.getWidth()) ;
-  for (unsigned int i=0 ; i < (size-1)/2 ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=vpImageFilter::filterYTopBorder(I,i,j,filter,size);
-    }
-  }
-  for (unsigned int i=(size-1)/2 ; i < I.getHeight()-(size-1)/2 ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=vpImageFilter::filterY(I,i,j,filter,size);
-    }
-  }
-  for (unsigned int i=I.getHeight()-(size-1)/2 ; i < I.getHeight() ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=vpImageFilter::filterYBottomBorder(I,i,j,filter,size);
-    }
-  }
+  ::filterY(I, dIy, filter, size);
+}
+
+/*!
+  \overload
+
+  The computation is done in single precision.
+ */
+void vpImageFilter::filterY(const vpImage<unsigned char> &I, vpImage<float>& dIy, const float *filter, unsigned int size)
+{
+  ::filterY(I, dIy, filter, size);
+}
+
+/*!
+  \overload
+ */
+void vpImageFilter::filterY(const vpImage<float> &I, vpImage<float>& dIy, const float *filter, unsigned int size)
+{
+  ::filterY(I, dIy, filter, size);
 }
 
 /*!
@@ -354,6 +665,79 @@ void vpImageFilter::gaussianBlur(const vpImage<double> &I, vpImage<double>& GI,
   delete[] fg;
 }
 
+/*!
+  Apply a Gaussian blur to an image. The computation is done in single
+  precision, that halves the memory used by the intermediate and the output
+  images compared to the vpImage<double> version.
+
+  \param I : Input image.
+  \param GI : Filtered image.
+  \param size : Filter size. This value should be odd.
+  \param sigma : Gaussian standard deviation. If it is equal to zero or negative, it is computed from filter size as sigma = (size-1)/6.
+  \param normalize : Flag indicating whether to normalize the filter coefficients or not.
+ */
+void vpImageFilter::gaussianBlur(const vpImage<unsigned char> &I, vpImage<float>& GI, unsigned int size, double sigma, bool normalize)
+{
+  std::vector<float> fg((size+1)/2);
+  vpImageFilter::getGaussianKernel(&fg[0], size, sigma, normalize) ;
+  vpImageFilter::filter(I, GI, &fg[0], size);
+}
+
+/*!
+  Apply a Gaussian blur to a float image.
+
+  \param I : Input image.
+  \param GI : Filtered image.
+  \param size : Filter size. This value should be odd.
+  \param sigma : Gaussian standard deviation. If it is equal to zero or negative, it is computed from filter size as sigma = (size-1)/6.
+  \param normalize : Flag indicating whether to normalize the filter coefficients or not.
+ */
+void vpImageFilter::gaussianBlur(const vpImage<float> &I, vpImage<float>& GI, unsigned int size, double sigma, bool normalize)
+{
+  std::vector<float> fg((size+1)/2);
+  vpImageFilter::getGaussianKernel(&fg[0], size, sigma, normalize) ;
+  vpImageFilter::filter(I, GI, &fg[0], size);
+}
+
+/*!
+  Apply a normalized Gaussian blur to an image and keep the result as an
+  unsigned char image.
+
+  The kernel coefficients are rounded to 8 bits fixed point values, so that
+  the whole filter is computed with integers. The result may differ by one
+  grey level from the rounded result of the floating point versions.
+
+  \param I : Input image.
+  \param GI : Filtered image.
+  \param size : Filter size. This value should be odd.
+  \param sigma : Gaussian standard deviation. If it is equal to zero or negative, it is computed from filter size as sigma = (size-1)/6.
+ */
+void vpImageFilter::gaussianBlur(const vpImage<unsigned char> &I, vpImage<unsigned char>& GI, unsigned int size, double sigma)
+{
+  std::vector<double> fg((size+1)/2);
+  vpImageFilter::getGaussianKernel(&fg[0], size, sigma, true) ;
+
+  // Coefficients summing to 256
+  std::vector<unsigned short> fi((size+1)/2);
+  int sum = 0;
+  for (unsigned int i = 1; i < fi.size(); i++) {
+    fi[i] = (unsigned short)vpMath::round(fg[i] * 256.);
+    sum += 2 * fi[i];
+  }
+  fi[0] = (unsigned short)vpMath::maximum(256 - sum, 0);
+
+  vpImage<unsigned short> GIx;
+  ::filterX(I, GIx, &fi[0], size);
+
+  GI.resize(I.getHeight(), I.getWidth());
+  vpFixedPointFilterData data;
+  data.I = &GIx;
+  data.If = &GI;
+  data.filter = &fi[0];
+  data.size = size;
+  vpThreadPool::parallelFor(0, I.getHeight(), fixedPointFilterYBand, &data, minRowsPerBand(I.getWidth()));
+}
+
 /*!
   Return the coefficients of a Gaussian filter.
 
@@ -435,150 +819,154 @@ void vpImageFilter::getGaussianDerivativeKernel(double *filter, unsigned int siz
   }
 }
 
+/*!
+  Return the coefficients of a Gaussian filter in single precision.
 
+  \sa getGaussianKernel(double *, unsigned int, double, bool)
+*/
+void vpImageFilter::getGaussianKernel(float *filter, unsigned int size, double sigma, bool normalize)
+{
+  std::vector<double> f((size+1)/2);
+  getGaussianKernel(&f[0], size, sigma, normalize);
+  for (unsigned int i = 0; i < f.size(); i++)
+    filter[i] = (float)f[i];
+}
+
+/*!
+  Return the coefficients of a Gaussian derivative filter in single precision.
+
+  \sa getGaussianDerivativeKernel(double *, unsigned int, double, bool)
+*/
+void vpImageFilter::getGaussianDerivativeKernel(float *filter, unsigned int size, double sigma, bool normalize)
+{
+  std::vector<double> f((size+1)/2);
+  getGaussianDerivativeKernel(&f[0], size, sigma, normalize);
+  for (unsigned int i = 0; i < f.size(); i++)
+    filter[i] = (float)f[i];
+}
+
+/*!
+  Compute the gradient along X with the 1x7 derivative filter of
+  derivativeFilterX(). The three first and last columns are set to 0.
+
+  \param I : Input image.
+  \param dIx : Gradient along X.
+ */
 void vpImageFilter::getGradX(const vpImage<unsigned char> &I, vpImage<double>& dIx)
 {
-  dIx.resize(I.getHeight(),I.getWidth()) ;
-  //dIx=0;
-  for (unsigned int i=0 ; i < I.getHeight() ; i++)
-  {
-    for (unsigned int j=0 ; j < 3 ; j++)
-    {
-      dIx[i][j]=0;
-    }
-    for (unsigned int j=3 ; j < I.getWidth()-3 ; j++)
-    {
-      dIx[i][j]=vpImageFilter::derivativeFilterX(I,i,j);
-    }
-    for (unsigned int j=I.getWidth()-3 ; j < I.getWidth() ; j++)
-    {
-      dIx[i][j]=0;
-    }
-  }
+  getDerivative(I, dIx, true);
+}
+
+/*!
+  \overload
+
+  The computation is done in single precision.
+ */
+void vpImageFilter::getGradX(const vpImage<unsigned char> &I, vpImage<float>& dIx)
+{
+  getDerivative(I, dIx, true);
 }
 
+/*!
+  Compute the gradient along Y with the 7x1 derivative filter of
+  derivativeFilterY(). The three first and last rows are set to 0.
+
+  \param I : Input image.
+  \param dIy : Gradient along Y.
+ */
 void vpImageFilter::getGradY(const vpImage<unsigned char> &I, vpImage<double>& dIy)
 {
-  dIy.resize(I.getHeight(),I.getWidth()) ;
-  //dIy=0;
-  for (unsigned int i=0 ; i < 3 ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=0;
-    }
-  }
-  for (unsigned int i=3 ; i < I.getHeight()-3 ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=vpImageFilter::derivativeFilterY(I,i,j);
-    }
-  }
-  for (unsigned int i=I.getHeight()-3 ; i < I.getHeight() ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=0;
-    }
-  }
+  getDerivative(I, dIy, false);
 }
 
+/*!
+  \overload
+
+  The computation is done in single precision.
+ */
+void vpImageFilter::getGradY(const vpImage<unsigned char> &I, vpImage<float>& dIy)
+{
+  getDerivative(I, dIy, false);
+}
+
+/*!
+  Compute the gradient along X with a derivative filter. The (size-1)/2 first
+  and last columns are set to 0.
+
+  \param I : Input image.
+  \param dIx : Gradient along X.
+  \param filter : Derivative kernel which values should be computed using getGaussianDerivativeKernel().
+  \param size : Size of the kernel.
+ */
 void vpImageFilter::getGradX(const vpImage<unsigned char> &I, vpImage<double>& dIx, const double *filter,unsigned  int size)
 {
-  dIx.resize(I.getHeight(),I.getWidth()) ;
-  //#pragma omp parallel for
-  for (unsigned int i=0 ; i < I.getHeight() ; i++)
-  {
-    for (unsigned int j=0 ; j < (size-1)/2 ; j++)
-    {
-      dIx[i][j]=0;
-    }
-    for (unsigned int j=(size-1)/2 ; j < I.getWidth()-(size-1)/2 ; j++)
-    {
-      dIx[i][j]=vpImageFilter::derivativeFilterX(I,i,j,filter,size);
-    }
-    for (unsigned int j=I.getWidth()-(size-1)/2 ; j < I.getWidth() ; j++)
-    {
-      dIx[i][j]=0;
-    }
-  }
+  ::getGradX(I, dIx, filter, size);
 }
+
+/*!
+  \overload
+ */
 void vpImageFilter::getGradX(const vpImage<double> &I, vpImage<double>& dIx, const double *filter,unsigned  int size)
 {
-  dIx.resize(I.getHeight(),I.getWidth()) ;
-  //dIx=0;
-  for (unsigned int i=0 ; i < I.getHeight() ; i++)
-  {
-    for (unsigned int j=0 ; j < (size-1)/2 ; j++)
-    {
-      dIx[i][j]=0;
-    }
-    for (unsigned int j=(size-1)/2 ; j < I.getWidth()-(size-1)/2 ; j++)
-    {
-      dIx[i][j]=vpImageFilter::derivativeFilterX(I,i,j,filter,size);
-    }
-    for (unsigned int j=I.getWidth()-(size-1)/2 ; j < I.getWidth() ; j++)
-    {
-      dIx[i][j]=0;
-    }
-  }
+  ::getGradX(I, dIx, filter, size);
+}
+
+/*!
+  \overload
+
+  The computation is done in single precision.
+ */
+void vpImageFilter::getGradX(const vpImage<unsigned char> &I, vpImage<float>& dIx, const float *filter, unsigned int size)
+{
+  ::getGradX(I, dIx, filter, size);
+}
+
+/*!
+  \overload
+ */
+void vpImageFilter::getGradX(const vpImage<float> &I, vpImage<float>& dIx, const float *filter, unsigned int size)
+{
+  ::getGradX(I, dIx, filter, size);
 }
 
+/*!
+  Compute the gradient along Y with a derivative filter. The (size-1)/2 first
+  and last rows are set to 0.
+
+  \param I : Input image.
+  \param dIy : Gradient along Y.
+  \param filter : Derivative kernel which values should be computed using getGaussianDerivativeKernel().
+  \param size : Size of the kernel.
+ */
 void vpImageFilter::getGradY(const vpImage<unsigned char> &I, vpImage<double>& dIy, const double *filter,unsigned  int size)
 {
-  dIy.resize(I.getHeight(),I.getWidth()) ;
-  //#pragma omp parallel for
-  for (unsigned int i=0 ; i < (size-1)/2 ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=0;
-    }
-  }
-  //#pragma omp parallel for
-  for (unsigned int i=(size-1)/2 ; i < I.getHeight()-(size-1)/2 ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=vpImageFilter::derivativeFilterY(I,i,j,filter,size);
-    }
-  }
-  //#pragma omp parallel for
-  for (unsigned int i=I.getHeight()-(size-1)/2 ; i < I.getHeight() ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=0;
-    }
-  }
+  ::getGradY(I, dIy, filter, size);
 }
 
+/*!
+  \overload
+ */
 void vpImageFilter::getGradY(const vpImage<double> &I, vpImage<double>& dIy, const double *filter,unsigned  int size)
 {
-  dIy.resize(I.getHeight(),I.getWidth()) ;
-  //dIy=0;
-  for (unsigned int i=0 ; i < (size-1)/2 ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=0;
-    }
-  }
-  for (unsigned int i=(size-1)/2 ; i < I.getHeight()-(size-1)/2 ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=vpImageFilter::derivativeFilterY(I,i,j,filter,size);
-    }
-  }
-  for (unsigned int i=I.getHeight()-(size-1)/2 ; i < I.getHeight() ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=0;
-    }
-  }
+  ::getGradY(I, dIy, filter, size);
+}
+
+/*!
+  \overload
+
+  The computation is done in single precision.
+ */
+void vpImageFilter::getGradY(const vpImage<unsigned char> &I, vpImage<float>& dIy, const float *filter, unsigned int size)
+{
+  ::getGradY(I, dIy, filter, size);
+}
+
+/*!
+  \overload
+ */
+void vpImageFilter::getGradY(const vpImage<float> &I, vpImage<float>& dIy, const float *filter, unsigned int size)
+{
+  ::getGradY(I, dIy, filter, size);
 }
 
 /*!
@@ -611,6 +999,32 @@ void vpImageFilter::getGradYGauss2D(const vpImage<unsigned char> &I, vpImage<dou
   vpImageFilter::getGradY(GIx, dIy, gaussianDerivativeKernel, size);
 }
 
+/*!
+   Compute the gradient along X after applying a gaussian filter along Y, in
+   single precision.
+
+   \sa getGradXGauss2D(const vpImage<unsigned char> &, vpImage<double> &, const double *, const double *, unsigned int)
+ */
+void vpImageFilter::getGradXGauss2D(const vpImage<unsigned char> &I, vpImage<float>& dIx, const float *gaussianKernel, const float *gaussianDerivativeKernel, unsigned int size)
+{
+  vpImage<float> GIy;
+  vpImageFilter::filterY(I,  GIy, gaussianKernel, size);
+  vpImageFilter::getGradX(GIy, dIx, gaussianDerivativeKernel, size);
+}
+
+/*!
+   Compute the gradient along Y after applying a gaussian filter along X, in
+   single precision.
+
+   \sa getGradYGauss2D(const vpImage<unsigned char> &, vpImage<double> &, const double *, const double *, unsigned int)
+ */
+void vpImageFilter::getGradYGauss2D(const vpImage<unsigned char> &I, vpImage<float>& dIy, const float *gaussianKernel, const float *gaussianDerivativeKernel, unsigned int size)
+{
+  vpImage<float> GIx;
+  vpImageFilter::filterX(I,  GIx, gaussianKernel, size);
+  vpImageFilter::getGradY(GIx, dIy, gaussianDerivativeKernel, size);
+}
+
 //operation pour pyramide gaussienne
 void vpImageFilter::getGaussPyramidal(const vpImage<unsigned char> &I, vpImage<unsigned char>& GI)
 {
@@ -0,0 +1,215 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Pyramid of images.
+ *
+ *****************************************************************************/
+
+#include <visp3/core/vpImageFilter.h>
+#include <visp3/core/vpImagePyramid.h>
+#include <visp3/core/vpThreadPool.h>
+
+namespace {
+// Number of pixels below which a level is not split between threads
+const unsigned int vpMinPixelsPerBand = 1 << 15;
+
+struct vpPyramidLevelData
+{
+  const vpImage<unsigned char> *I;
+  vpImage<unsigned char> *GI;
+};
+
+void subsampleBand(unsigned int begin, unsigned int end, void *arg)
+{
+  vpPyramidLevelData *data = static_cast<vpPyramidLevelData *>(arg);
+  const unsigned int w = data->GI->getWidth();
+  for (unsigned int i = begin; i < end; i++) {
+    const unsigned char *src = (*data->I)[2*i];
+    unsigned char *dst = (*data->GI)[i];
+    for (unsigned int j = 0; j < w; j++)
+      dst[j] = src[2*j];
+  }
+}
+
+// Horizontal part of vpImageFilter::getGaussXPyramidal() for one row
+void gaussXRow(const unsigned char *src, unsigned char *dst, unsigned int w)
+{
+  dst[0] = src[0];
+  for (unsigned int j = 1; j + 1 < w; j++) {
+    const unsigned char *s = src + 2*j;
+    dst[j] = (unsigned char)((s[-2] + 4*s[-1] + 6*s[0] + 4*s[1] + s[2]) >> 4);
+  }
+  dst[w-1] = src[2*w-1];
+}
+
+/*
+  Same result than vpImageFilter::getGaussXPyramidal() followed by
+  getGaussYPyramidal(), without the intermediate image: the 5 last
+  horizontally filtered rows are kept in a ring buffer.
+*/
+void gaussianBand(unsigned int begin, unsigned int end, void *arg)
+{
+  vpPyramidLevelData *data = static_cast<vpPyramidLevelData *>(arg);
+  const vpImage<unsigned char> &I = *data->I;
+  vpImage<unsigned char> &GI = *data->GI;
+  const unsigned int w = GI.getWidth();
+  const unsigned int h = GI.getHeight();
+
+  std::vector<unsigned char> buffer(5 * w);
+  unsigned char *rows[5];
+  for (unsigned int k = 0; k < 5; k++)
+    rows[k] = &buffer[k * w];
+  int last = -1; // Last horizontally filtered row in the ring buffer
+
+  for (unsigned int i = begin; i < end; i++) {
+    if (i == 0 || i + 1 >= h) {
+      // First and last rows are not filtered vertically
+      gaussXRow(I[i + 1 >= h ? 2*h-1 : 0], GI[i], w);
+      continue;
+    }
+
+    int first = (int)(2*i) - 2;
+    if (last < first)
+      last = first - 1;
+    for (int r = last + 1; r <= first + 4; r++)
+      gaussXRow(I[(unsigned int)r], rows[r % 5], w);
+    last = first + 4;
+
+    const unsigned char *r0 = rows[first % 5];
+    const unsigned char *r1 = rows[(first + 1) % 5];
+    const unsigned char *r2 = rows[(first + 2) % 5];
+    const unsigned char *r3 = rows[(first + 3) % 5];
+    const unsigned char *r4 = rows[(first + 4) % 5];
+    unsigned char *dst = GI[i];
+    for (unsigned int j = 0; j < w; j++)
+      dst[j] = (unsigned char)((r0[j] + 4*r1[j] + 6*r2[j] + 4*r3[j] + r4[j]) >> 4);
+  }
+}
+}
+
+/*!
+  Create an empty pyramid.
+
+  \param type : Downsampling method used to compute the levels.
+*/
+vpImagePyramid::vpImagePyramid(vpPyramidType type)
+  : m_type(type), m_nbLevels(0), m_I(NULL), m_levels()
+{
+}
+
+/*!
+  Build the pyramid of an image. The images of the levels are reused when
+  their size did not change since the previous call.
+
+  With the GAUSSIAN type, the levels are the same than the ones computed by
+  successive calls to vpImageFilter::getGaussPyramidal(). With the
+  SUBSAMPLING type, the pixel (i, j) of the level l is the pixel (i 2^l, j 2^l)
+  of the input image.
+
+  \param I : Input image, that becomes the level 0. It is not copied.
+  \param nbLevels : Number of levels, input image included.
+*/
+void vpImagePyramid::build(const vpImage<unsigned char> &I, unsigned int nbLevels)
+{
+  m_I = &I;
+  m_nbLevels = nbLevels;
+  if (nbLevels == 0)
+    return;
+  if (m_levels.size() < nbLevels - 1)
+    m_levels.resize(nbLevels - 1);
+
+  const vpImage<unsigned char> *previous = &I;
+  for (unsigned int l = 1; l < nbLevels; l++) {
+    vpImage<unsigned char> &level = m_levels[l-1];
+    unsigned int h = previous->getHeight() / 2;
+    unsigned int w = previous->getWidth() / 2;
+    if (h == 0 || w == 0) {
+      level.resize(0, 0);
+      previous = &level;
+      continue;
+    }
+
+#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100)
+    if (m_type == GAUSSIAN) {
+      // Keep the smoothing of OpenCV
+      vpImageFilter::getGaussPyramidal(*previous, level);
+      previous = &level;
+      continue;
+    }
+#endif
+
+    level.resize(h, w);
+    vpPyramidLevelData data;
+    data.I = previous;
+    data.GI = &level;
+    vpThreadPool::parallelFor(0, h, m_type == GAUSSIAN ? gaussianBand : subsampleBand, &data,
+                              vpMinPixelsPerBand / (w + 1) + 1);
+    previous = &level;
+  }
+}
+
+/*!
+  Release the memory of the levels and forget the input image.
+*/
+void vpImagePyramid::clear()
+{
+  m_levels.clear();
+  m_nbLevels = 0;
+  m_I = NULL;
+}
+
+/*!
+  Return the image of a given level, 0 being the input image.
+
+  \param level : Level of the pyramid.
+
+  \exception vpException::dimensionError : If the level is not built.
+*/
+const vpImage<unsigned char> &vpImagePyramid::getLevel(unsigned int level) const
+{
+  if (level >= m_nbLevels) {
+    throw(vpException(vpException::dimensionError,
+                      "Level %u of a pyramid of %u levels", level, m_nbLevels));
+  }
+  if (level == 0)
+    return *m_I;
+  return m_levels[level-1];
+}
+
+/*!
+  Set the downsampling method. The pyramid has to be built again by build()
+  for the change to be taken into account.
+
+  \param type : Downsampling method used to compute the levels.
+*/
+void vpImagePyramid::setType(vpPyramidType type)
+{
+  m_type = type;
+}
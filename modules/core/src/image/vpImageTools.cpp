@@ -36,6 +36,106 @@
  *****************************************************************************/
 
 #include <visp3/core/vpImageTools.h>
+#include <visp3/core/vpThreadPool.h>
+
+namespace {
+// Number of pixels below which a pixel-wise operation is not split between
+// threads
+const unsigned int vpMinPixelsPerBand = 1 << 16;
+
+struct vpImageLutData
+{
+  unsigned char *bitmap;
+  unsigned char lut[256];
+};
+
+void changeLUTBand(unsigned int begin, unsigned int end, void *arg)
+{
+  vpImageLutData *data = static_cast<vpImageLutData *>(arg);
+  unsigned char *p = data->bitmap + begin;
+  unsigned char *pend = data->bitmap + end;
+  for (; p < pend; p++) {
+    *p = data->lut[*p];
+  }
+}
+
+struct vpImageDifferenceData
+{
+  const unsigned char *I1;
+  const unsigned char *I2;
+  unsigned char *Idiff;
+};
+
+void imageDifferenceBand(unsigned int begin, unsigned int end, void *arg)
+{
+  vpImageDifferenceData *data = static_cast<vpImageDifferenceData *>(arg);
+  for (unsigned int b = begin; b < end; b++)
+  {
+    int diff = data->I1[b] - data->I2[b] + 128;
+    data->Idiff[b] = (unsigned char) (vpMath::maximum(vpMath::minimum(diff, 255), 0));
+  }
+}
+
+void imageDifferenceAbsoluteBand(unsigned int begin, unsigned int end, void *arg)
+{
+  vpImageDifferenceData *data = static_cast<vpImageDifferenceData *>(arg);
+  for (unsigned int b = begin; b < end; b++)
+  {
+    int diff = data->I1[b] - data->I2[b];
+    data->Idiff[b] = diff;
+  }
+}
+
+struct vpUndistortMapData
+{
+  const unsigned char *src;
+  unsigned char *dst;
+  unsigned int width;
+  unsigned int nchannels;
+  const vpUndistortMap::vpUndistortMapEntry *entries;
+};
+
+// Bilinear interpolation of the rows [begin, end) with the weights of the
+// map, rounded to the nearest integer
+void undistortMapBand(unsigned int begin, unsigned int end, void *arg)
+{
+  vpUndistortMapData *data = static_cast<vpUndistortMapData *>(arg);
+  const unsigned int nchannels = data->nchannels;
+  const unsigned int step = data->width * nchannels;
+  const vpUndistortMap::vpUndistortMapEntry *entry = data->entries + begin * data->width;
+  const vpUndistortMap::vpUndistortMapEntry *entry_end = data->entries + end * data->width;
+  unsigned char *dst = data->dst + begin * step;
+
+  for (; entry < entry_end; entry++) {
+    if (entry->index < 0) {
+      for (unsigned int c = 0; c < nchannels; c++)
+        *dst++ = 0;
+      continue;
+    }
+    const unsigned char *p = data->src + (unsigned int)entry->index * nchannels;
+    const int du = entry->du;
+    const int dv = entry->dv;
+    for (unsigned int c = 0; c < nchannels; c++, p++) {
+      int top = p[0] * 256 + (p[nchannels] - p[0]) * du;
+      int bottom = p[step] * 256 + (p[step + nchannels] - p[step]) * du;
+      *dst++ = (unsigned char)((top * 256 + (bottom - top) * dv + (1 << 15)) >> 16);
+    }
+  }
+}
+
+void undistortMap(const unsigned char *src, unsigned char *dst, unsigned int nchannels, const vpUndistortMap &map,
+                  const vpUndistortMap::vpUndistortMapEntry *entries)
+{
+  vpUndistortMapData data;
+  data.src = src;
+  data.dst = dst;
+  data.width = map.getWidth();
+  data.nchannels = nchannels;
+  data.entries = entries;
+  vpThreadPool::parallelFor(0, map.getHeight(), undistortMapBand, &data,
+                            vpMinPixelsPerBand / (4 * map.getWidth() + 1) + 1);
+}
+}
 
 
 /*!
@@ -107,21 +207,21 @@ void vpImageTools::changeLUT(vpImage<unsigned char>& I,
     throw (vpImageException(vpImageException::incorrectInitializationError ,
 			    "Bad gray levels")) ;
   }
-  unsigned char v;
-
   double factor = (double)(B_star - A_star)/(double)(B - A);
 
-  for (unsigned int i=0 ; i < I.getHeight(); i++)
-    for (unsigned int j=0 ; j < I.getWidth(); j++) {
-      v = I[i][j];
+  // The new value only depends on the old one: compute it once per gray level
+  vpImageLutData data;
+  data.bitmap = I.bitmap;
+  for (unsigned int v = 0; v < 256; v++) {
+    if (v <= A)
+      data.lut[v] = A_star;
+    else if (v >= B)
+      data.lut[v] = B_star;
+    else
+      data.lut[v] = (unsigned char)(A_star + factor*(v-A));
+  }
 
-      if (v <= A)
-        I[i][j] = A_star;
-      else if (v >= B)
-        I[i][j] = B_star;
-      else
-        I[i][j] = (unsigned char)(A_star + factor*(v-A));
-    }
+  vpThreadPool::parallelFor(0, I.getSize(), changeLUTBand, &data, vpMinPixelsPerBand);
 }
 
 /*!
@@ -148,12 +248,11 @@ void vpImageTools::imageDifference(const vpImage<unsigned char> &I1,
   if ((I1.getHeight() != Idiff.getHeight()) || (I1.getWidth() != Idiff.getWidth()))
     Idiff.resize(I1.getHeight(), I1.getWidth());
   
-  unsigned int n = I1.getHeight() * I1.getWidth() ;
-  for (unsigned int b = 0; b < n ; b++)
-  {
-    int diff = I1.bitmap[b] - I2.bitmap[b] + 128;
-    Idiff.bitmap[b] = (unsigned char) (vpMath::maximum(vpMath::minimum(diff, 255), 0));
-  }
+  vpImageDifferenceData data;
+  data.I1 = I1.bitmap;
+  data.I2 = I2.bitmap;
+  data.Idiff = Idiff.bitmap;
+  vpThreadPool::parallelFor(0, I1.getHeight() * I1.getWidth(), imageDifferenceBand, &data, vpMinPixelsPerBand);
 }
 
 /*!
@@ -180,10 +279,166 @@ vpImageTools::imageDifferenceAbsolute(const vpImage<unsigned char> &I1,
   if ((I1.getHeight() != Idiff.getHeight()) || (I1.getWidth() != Idiff.getWidth()))
     Idiff.resize(I1.getHeight(), I1.getWidth());
 
-  unsigned int n = I1.getHeight() * I1.getWidth() ;
-  for (unsigned int b = 0; b < n ; b++)
-  {
-    int diff = I1.bitmap[b] - I2.bitmap[b];
-    Idiff.bitmap[b] = diff;
+  vpImageDifferenceData data;
+  data.I1 = I1.bitmap;
+  data.I2 = I2.bitmap;
+  data.Idiff = Idiff.bitmap;
+  vpThreadPool::parallelFor(0, I1.getHeight() * I1.getWidth(), imageDifferenceAbsoluteBand, &data,
+                            vpMinPixelsPerBand);
+}
+
+/*!
+  Compute the lookup table used by undistort(const vpImage<unsigned char> &, const vpUndistortMap &, vpImage<unsigned char> &)
+  and undistort(const vpImage<vpRGBa> &, const vpUndistortMap &, vpImage<vpRGBa> &)
+  to undistort images acquired by a camera.
+
+  The radial distortion model of \e cam (see vpCameraParameters::get_kud())
+  is evaluated once for each pixel. The source pixel and the bilinear
+  interpolation weights are stored in the map. As in
+  undistort(const vpImage<Type> &, const vpCameraParameters &, vpImage<Type> &),
+  pixels whose source lies between -1 and 0 are extrapolated from the first
+  row or column of the image.
+
+  \param cam : Parameters of the camera causing distortion.
+  \param width, height : Size of the images to undistort.
+  \param map : Lookup table to use with undistort().
+
+  \sa undistort(const vpImage<Type> &, const vpCameraParameters &, vpImage<Type> &)
+*/
+void vpImageTools::initUndistortMap(const vpCameraParameters &cam,
+                                    unsigned int width, unsigned int height,
+                                    vpUndistortMap &map)
+{
+  map.width = width;
+  map.height = height;
+
+  double kud = cam.get_kud();
+
+  //if (kud == 0) {
+  if (std::fabs(kud) <= std::numeric_limits<double>::epsilon()) {
+    // There is no need to undistort the image
+    map.copy = true;
+    map.entries.clear();
+    return;
+  }
+
+  map.copy = false;
+  map.entries.resize((size_t)width * height);
+
+  double u0 = cam.get_u0();
+  double v0 = cam.get_v0();
+  double px = cam.get_px();
+  double py = cam.get_py();
+
+  double invpx = 1.0/px;
+  double invpy = 1.0/py;
+
+  double kud_px2 = kud * invpx * invpx;
+  double kud_py2 = kud * invpy * invpy;
+
+  vpUndistortMap::vpUndistortMapEntry *entry = map.entries.empty() ? NULL : &map.entries[0];
+  for (unsigned int v = 0; v < height; v++) {
+    double deltav = v - v0;
+    double fr1 = 1.0 + kud_py2 * deltav * deltav;
+
+    for (unsigned int u = 0; u < width; u++, entry++) {
+      double deltau = u - u0;
+      double fr2 = fr1 + kud_px2 * deltau * deltau;
+
+      double u_double = deltau * fr2 + u0;
+      double v_double = deltav * fr2 + v0;
+
+      // Same neighbourhood than undistort(const vpImage<Type> &, const vpCameraParameters &, vpImage<Type> &):
+      // a coordinate in (-1, 0) is truncated to 0 and extrapolated with a
+      // negative weight
+      int u_round = (int) (u_double);
+      int v_round = (int) (v_double);
+      if (u_round < 0.f) u_round = -1;
+      if (v_round < 0.f) v_round = -1;
+
+      if ( (0 <= u_round) && (0 <= v_round) &&
+           (u_round < ((int)width - 1)) && (v_round < ((int)height - 1)) ) {
+        entry->index = v_round * (int)width + u_round;
+        entry->du = (short)vpMath::round((u_double - u_round) * 256.);
+        entry->dv = (short)vpMath::round((v_double - v_round) * 256.);
+      }
+      else {
+        entry->index = -1;
+        entry->du = 0;
+        entry->dv = 0;
+      }
+    }
+  }
+}
+
+/*!
+  Undistort a grey level image with a lookup table computed by
+  initUndistortMap().
+
+  Pixels are obtained by bilinear interpolation with 8 bits fixed point
+  weights and rounded. The result may thus differ by a few grey levels from
+  undistort(const vpImage<Type> &, const vpCameraParameters &, vpImage<Type> &)
+  that truncates the intermediate values.
+
+  \param I : Input image to undistort.
+  \param map : Lookup table computed by initUndistortMap().
+  \param undistI : Undistorted output image, of the same size than \e I.
+
+  \exception vpImageException::incorrectInitializationError : If the size of
+  \e I differs from the one used to compute \e map.
+*/
+void vpImageTools::undistort(const vpImage<unsigned char> &I,
+                             const vpUndistortMap &map,
+                             vpImage<unsigned char> &undistI)
+{
+  if ((I.getHeight() != map.getHeight()) || (I.getWidth() != map.getWidth())) {
+    throw (vpImageException(vpImageException::incorrectInitializationError,
+                            "The image size differs from the one of the undistortion map"));
+  }
+
+  if (map.copy) {
+    undistI = I;
+    return;
   }
+
+  undistI.resize(I.getHeight(), I.getWidth());
+  if (I.getSize() == 0)
+    return;
+
+  undistortMap(I.bitmap, undistI.bitmap, 1, map, &map.entries[0]);
+}
+
+/*!
+  Undistort a color image with a lookup table computed by
+  initUndistortMap().
+
+  Each channel, alpha included, is obtained by bilinear interpolation with 8
+  bits fixed point weights.
+
+  \param I : Input image to undistort.
+  \param map : Lookup table computed by initUndistortMap().
+  \param undistI : Undistorted output image, of the same size than \e I.
+
+  \exception vpImageException::incorrectInitializationError : If the size of
+  \e I differs from the one used to compute \e map.
+*/
+void vpImageTools::undistort(const vpImage<vpRGBa> &I,
+                             const vpUndistortMap &map,
+                             vpImage<vpRGBa> &undistI)
+{
+  if ((I.getHeight() != map.getHeight()) || (I.getWidth() != map.getWidth())) {
+    throw (vpImageException(vpImageException::incorrectInitializationError,
+                            "The image size differs from the one of the undistortion map"));
+  }
+
+  if (map.copy) {
+    undistI = I;
+    return;
+  }
+
+  undistI.resize(I.getHeight(), I.getWidth());
+  if (I.getSize() == 0)
+    return;
+
+  undistortMap((const unsigned char *)I.bitmap, (unsigned char *)undistI.bitmap, 4, map, &map.entries[0]);
 }
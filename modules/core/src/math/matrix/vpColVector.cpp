@@ -56,6 +56,7 @@
 #include <visp3/core/vpException.h>
 #include <visp3/core/vpMath.h>
 #include <visp3/core/vpDebug.h>
+#include <visp3/core/vpSubColVector.h>
 #include <visp3/core/vpRotationVector.h>
 
 #if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
@@ -113,7 +114,7 @@ vpColVector::operator+(const vpTranslationVector &t) const
 
 //! Operator that allows to add two column vectors.
 vpColVector &
-vpColVector::operator+=(vpColVector v)
+vpColVector::operator+=(const vpColVector &v)
 {
   if (getRows() != v.getRows() ) {
     throw(vpException(vpException::dimensionError,
@@ -127,7 +128,7 @@ vpColVector::operator+=(vpColVector v)
 }
 //! Operator that allows to substract two column vectors.
 vpColVector &
-vpColVector::operator-=(vpColVector v)
+vpColVector::operator-=(const vpColVector &v)
 {
   if (getRows() != v.getRows() ) {
     throw(vpException(vpException::dimensionError,
@@ -535,6 +536,33 @@ vpColVector &vpColVector::operator=(const vpColVector &v)
   return *this;
 }
 
+#ifdef VISP_HAVE_CPP11_COMPATIBILITY
+/*!
+  Move constructor. The memory of \e v is taken without copy and \e v
+  becomes an empty vector. A vpSubColVector, that points toward the memory
+  of its parent, is copied.
+*/
+vpColVector::vpColVector(vpColVector &&v)
+  : vpArray2D<double>()
+{
+  *this = std::move(v);
+}
+
+/*!
+  Move operator. The memory of \e v is taken without copy and \e v becomes
+  an empty vector. A vpSubColVector, that points toward the memory of its
+  parent, is copied.
+*/
+vpColVector &vpColVector::operator=(vpColVector &&v)
+{
+  if (dynamic_cast<vpSubColVector *>(&v) != NULL)
+    *this = static_cast<const vpColVector &>(v);
+  else
+    vpArray2D<double>::operator=(std::move(v));
+  return *this;
+}
+#endif
+
 /*!
    Operator that allows to convert a translation vector into a column vector.
  */
@@ -698,9 +726,7 @@ void vpColVector::transpose(vpRowVector &v) const
 */
 vpColVector operator*(const double &x, const vpColVector &v)
 {
-  vpColVector vout ;
-  vout = v*x ;
-  return vout ;
+  return v*x ;
 }
 
 /*!
@@ -1109,7 +1135,11 @@ vpColVector vpColVector::crossProd(const vpColVector &a, const vpColVector &b)
                       a.getRows(), b.getRows()));
   }
 
-  return vpColVector::skew(a) * b;
+  vpColVector c(3);
+  c[0] = a[1]*b[2] - a[2]*b[1];
+  c[1] = a[2]*b[0] - a[0]*b[2];
+  c[2] = a[0]*b[1] - a[1]*b[0];
+  return c;
 }
 
 
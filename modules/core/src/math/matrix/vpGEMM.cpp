@@ -0,0 +1,416 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Blocked matrix-matrix and matrix-vector products.
+ *
+ *****************************************************************************/
+
+#include <visp3/core/vpCPUFeatures.h>
+#include <visp3/core/vpGEMM.h>
+#include <visp3/core/vpThreadPool.h>
+
+#include <string.h>
+#include <vector>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+// The AVX micro-kernels are built whatever the compiler flags are, thanks to
+// the target attribute, and selected at runtime.
+#if defined(_MSC_VER) && (_MSC_VER >= 1700) && (defined(_M_IX86) || defined(_M_X64))
+#  define VISP_GEMM_AVX 1
+#  define VP_TARGET_AVX
+#elif (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))) \
+  && (defined(__i386__) || defined(__x86_64__))
+#  define VISP_GEMM_AVX 1
+#  define VP_TARGET_AVX __attribute__((target("avx")))
+#endif
+
+#if defined(VISP_GEMM_AVX)
+#  include <immintrin.h>
+#endif
+
+/*
+  The product C = alpha * op(A) * op(B) + beta * C follows the usual layout of
+  optimized BLAS libraries:
+  - op(B) is cut in blocks of vpGemmKC x vpGemmNC elements that are packed in
+    panels of vpGemmNR columns,
+  - op(A) is cut in blocks of vpGemmMC x vpGemmKC elements that are packed in
+    panels of vpGemmMR rows,
+  - a micro-kernel computes a vpGemmMR x vpGemmNR block of C from a panel of
+    A and a panel of B, keeping the block in registers.
+  The blocks of rows of op(A) are split between the threads of vpThreadPool.
+*/
+
+namespace {
+const unsigned int vpGemmMR = 4;
+const unsigned int vpGemmNR = 8;
+const unsigned int vpGemmMC = 64;
+const unsigned int vpGemmKC = 256;
+const unsigned int vpGemmNC = 2048;
+// Number of multiply-adds below which a product is computed by plain loops
+const double vpGemmSmallSize = 4096.;
+// Number of multiply-adds below which a product is not split between threads
+const double vpGemmMinSizePerBand = 262144.;
+// Number of matrix elements below which a matrix-vector product is not split between threads
+const unsigned int vpGemvMinSizePerBand = 1 << 15;
+
+typedef void (*vpGemmMicroKernel)(unsigned int kc, const double *a, const double *b, double *ab);
+
+// ab = a * b with a a packed panel of vpGemmMR rows and b a packed panel of
+// vpGemmNR columns
+void gemmMicroKernel(unsigned int kc, const double *a, const double *b, double *ab)
+{
+  double c[vpGemmMR * vpGemmNR];
+  for (unsigned int i = 0; i < vpGemmMR * vpGemmNR; i++)
+    c[i] = 0.;
+
+  for (unsigned int p = 0; p < kc; p++) {
+    for (unsigned int r = 0; r < vpGemmMR; r++) {
+      const double ar = a[r];
+      for (unsigned int col = 0; col < vpGemmNR; col++)
+        c[r * vpGemmNR + col] += ar * b[col];
+    }
+    a += vpGemmMR;
+    b += vpGemmNR;
+  }
+  memcpy(ab, c, sizeof(c));
+}
+
+#if defined(VISP_GEMM_AVX)
+VP_TARGET_AVX void gemmMicroKernelAVX(unsigned int kc, const double *a, const double *b, double *ab)
+{
+  __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+  __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+  __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+  __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+
+  for (unsigned int p = 0; p < kc; p++) {
+    const __m256d b0 = _mm256_loadu_pd(b);
+    const __m256d b1 = _mm256_loadu_pd(b + 4);
+    __m256d ar = _mm256_broadcast_sd(a);
+    c00 = _mm256_add_pd(c00, _mm256_mul_pd(ar, b0));
+    c01 = _mm256_add_pd(c01, _mm256_mul_pd(ar, b1));
+    ar = _mm256_broadcast_sd(a + 1);
+    c10 = _mm256_add_pd(c10, _mm256_mul_pd(ar, b0));
+    c11 = _mm256_add_pd(c11, _mm256_mul_pd(ar, b1));
+    ar = _mm256_broadcast_sd(a + 2);
+    c20 = _mm256_add_pd(c20, _mm256_mul_pd(ar, b0));
+    c21 = _mm256_add_pd(c21, _mm256_mul_pd(ar, b1));
+    ar = _mm256_broadcast_sd(a + 3);
+    c30 = _mm256_add_pd(c30, _mm256_mul_pd(ar, b0));
+    c31 = _mm256_add_pd(c31, _mm256_mul_pd(ar, b1));
+    a += vpGemmMR;
+    b += vpGemmNR;
+  }
+
+  _mm256_storeu_pd(ab,      c00);
+  _mm256_storeu_pd(ab + 4,  c01);
+  _mm256_storeu_pd(ab + 8,  c10);
+  _mm256_storeu_pd(ab + 12, c11);
+  _mm256_storeu_pd(ab + 16, c20);
+  _mm256_storeu_pd(ab + 20, c21);
+  _mm256_storeu_pd(ab + 24, c30);
+  _mm256_storeu_pd(ab + 28, c31);
+}
+#endif
+
+vpGemmMicroKernel selectGemmMicroKernel()
+{
+#if defined(VISP_GEMM_AVX)
+  if (vpCPUFeatures::checkAVX())
+    return gemmMicroKernelAVX;
+#endif
+  return gemmMicroKernel;
+}
+
+struct vpGemmData
+{
+  bool transA, transB;
+  unsigned int m, n, k;
+  double alpha;
+  const double *A;
+  unsigned int lda;
+  const double *B;
+  unsigned int ldb;
+  double *C;
+  unsigned int ldc;
+
+  // Block of op(B) being processed
+  unsigned int j0, nc, p0, kc;
+  double beta;
+  const double *Bp;
+  vpGemmMicroKernel kernel;
+};
+
+// Element (i, j) of op(M)
+inline double element(const double *M, unsigned int ld, bool trans, unsigned int i, unsigned int j)
+{
+  return trans ? M[j * ld + i] : M[i * ld + j];
+}
+
+// Pack the rows [i0, i0+mc) and columns [p0, p0+kc) of op(A) in panels of
+// vpGemmMR rows, padded with zeros
+void packA(const vpGemmData &g, unsigned int i0, unsigned int mc, double *buf)
+{
+  for (unsigned int ir = 0; ir < mc; ir += vpGemmMR) {
+    for (unsigned int p = 0; p < g.kc; p++) {
+      for (unsigned int r = 0; r < vpGemmMR; r++) {
+        *buf++ = (ir + r < mc) ? element(g.A, g.lda, g.transA, i0 + ir + r, g.p0 + p) : 0.;
+      }
+    }
+  }
+}
+
+// Pack the rows [p0, p0+kc) and columns [j0, j0+nc) of op(B) in panels of
+// vpGemmNR columns, padded with zeros
+void packB(const vpGemmData &g, double *buf)
+{
+  for (unsigned int jr = 0; jr < g.nc; jr += vpGemmNR) {
+    for (unsigned int p = 0; p < g.kc; p++) {
+      for (unsigned int c = 0; c < vpGemmNR; c++) {
+        *buf++ = (jr + c < g.nc) ? element(g.B, g.ldb, g.transB, g.p0 + p, g.j0 + jr + c) : 0.;
+      }
+    }
+  }
+}
+
+// Update the blocks [begin, end) of vpGemmMC rows of C with the current block of op(B)
+void gemmRowBlocks(unsigned int begin, unsigned int end, void *arg)
+{
+  const vpGemmData &g = *static_cast<const vpGemmData *>(arg);
+  std::vector<double> Ap(vpGemmMC * g.kc);
+  double ab[vpGemmMR * vpGemmNR];
+
+  for (unsigned int block = begin; block < end; block++) {
+    const unsigned int i0 = block * vpGemmMC;
+    const unsigned int mc = (g.m - i0 < vpGemmMC) ? g.m - i0 : vpGemmMC;
+    packA(g, i0, mc, &Ap[0]);
+
+    for (unsigned int jr = 0; jr < g.nc; jr += vpGemmNR) {
+      const unsigned int nr = (g.nc - jr < vpGemmNR) ? g.nc - jr : vpGemmNR;
+      for (unsigned int ir = 0; ir < mc; ir += vpGemmMR) {
+        const unsigned int mr = (mc - ir < vpGemmMR) ? mc - ir : vpGemmMR;
+        g.kernel(g.kc, &Ap[ir * g.kc], g.Bp + jr * g.kc, ab);
+
+        for (unsigned int r = 0; r < mr; r++) {
+          double *c = g.C + (size_t)(i0 + ir + r) * g.ldc + g.j0 + jr;
+          const double *abr = ab + r * vpGemmNR;
+          if (g.beta == 0.) {
+            for (unsigned int col = 0; col < nr; col++)
+              c[col] = g.alpha * abr[col];
+          }
+          else {
+            for (unsigned int col = 0; col < nr; col++)
+              c[col] = g.beta * c[col] + g.alpha * abr[col];
+          }
+        }
+      }
+    }
+  }
+}
+
+// Plain loops for small products, where packing doesn't pay off
+void gemmSmall(const vpGemmData &g, double beta)
+{
+  for (unsigned int i = 0; i < g.m; i++) {
+    double *c = g.C + (size_t)i * g.ldc;
+    for (unsigned int j = 0; j < g.n; j++) {
+      double s = 0.;
+      for (unsigned int p = 0; p < g.k; p++)
+        s += element(g.A, g.lda, g.transA, i, p) * element(g.B, g.ldb, g.transB, p, j);
+      c[j] = (beta == 0.) ? g.alpha * s : beta * c[j] + g.alpha * s;
+    }
+  }
+}
+
+// y = A * x for 4 rows of A
+void gemvRows(unsigned int n, const double *a0, const double *a1, const double *a2, const double *a3,
+              const double *x, double *y)
+{
+  double s0 = 0., s1 = 0., s2 = 0., s3 = 0.;
+  for (unsigned int j = 0; j < n; j++) {
+    const double xj = x[j];
+    s0 += a0[j] * xj;
+    s1 += a1[j] * xj;
+    s2 += a2[j] * xj;
+    s3 += a3[j] * xj;
+  }
+  y[0] = s0; y[1] = s1; y[2] = s2; y[3] = s3;
+}
+
+#if defined(VISP_GEMM_AVX)
+VP_TARGET_AVX void gemvRowsAVX(unsigned int n, const double *a0, const double *a1, const double *a2, const double *a3,
+                               const double *x, double *y)
+{
+  __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+  __m256d s2 = _mm256_setzero_pd(), s3 = _mm256_setzero_pd();
+  unsigned int j = 0;
+  for (; j + 4 <= n; j += 4) {
+    const __m256d xj = _mm256_loadu_pd(x + j);
+    s0 = _mm256_add_pd(s0, _mm256_mul_pd(_mm256_loadu_pd(a0 + j), xj));
+    s1 = _mm256_add_pd(s1, _mm256_mul_pd(_mm256_loadu_pd(a1 + j), xj));
+    s2 = _mm256_add_pd(s2, _mm256_mul_pd(_mm256_loadu_pd(a2 + j), xj));
+    s3 = _mm256_add_pd(s3, _mm256_mul_pd(_mm256_loadu_pd(a3 + j), xj));
+  }
+  // Horizontal sums: y[r] is the sum of the 4 elements of sr
+  const __m256d s01 = _mm256_hadd_pd(s0, s1); // s0[0]+s0[1], s1[0]+s1[1], s0[2]+s0[3], s1[2]+s1[3]
+  const __m256d s23 = _mm256_hadd_pd(s2, s3);
+  const __m256d sum = _mm256_add_pd(_mm256_permute2f128_pd(s01, s23, 0x20), _mm256_permute2f128_pd(s01, s23, 0x31));
+  _mm256_storeu_pd(y, sum);
+
+  for (; j < n; j++) {
+    const double xj = x[j];
+    y[0] += a0[j] * xj;
+    y[1] += a1[j] * xj;
+    y[2] += a2[j] * xj;
+    y[3] += a3[j] * xj;
+  }
+}
+#endif
+
+struct vpGemvData
+{
+  unsigned int n;
+  const double *A;
+  unsigned int lda;
+  const double *x;
+  double *y;
+  void (*kernel)(unsigned int, const double *, const double *, const double *, const double *,
+                 const double *, double *);
+};
+
+void gemvBand(unsigned int begin, unsigned int end, void *arg)
+{
+  const vpGemvData &g = *static_cast<const vpGemvData *>(arg);
+  unsigned int i = begin;
+  for (; i + 4 <= end; i += 4) {
+    const double *a = g.A + (size_t)i * g.lda;
+    g.kernel(g.n, a, a + g.lda, a + 2 * g.lda, a + 3 * g.lda, g.x, g.y + i);
+  }
+  for (; i < end; i++) {
+    const double *a = g.A + (size_t)i * g.lda;
+    double s = 0.;
+    for (unsigned int j = 0; j < g.n; j++)
+      s += a[j] * g.x[j];
+    g.y[i] = s;
+  }
+}
+}
+
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Compute \f$ C = \alpha \, op(A) \, op(B) + \beta \, C \f$ on row-major
+  arrays, where \f$ op(M) \f$ is \f$ M \f$ or \f$ M^T \f$.
+
+  This is the kernel behind vpGEMM() and the products of vpMatrix. It is a
+  cache-blocked implementation that uses AVX when the processor supports it
+  and splits large products between the threads of vpThreadPool.
+
+  \param transA, transB : If true, use the transpose of \e A, respectively \e B.
+  \param m, n : Number of rows and columns of \e C.
+  \param k : Number of columns of \f$ op(A) \f$ and rows of \f$ op(B) \f$.
+  \param alpha, beta : Scalars. If \e beta is 0, \e C doesn't need to be initialized.
+  \param A, B : Input arrays, that must not overlap \e C.
+  \param lda, ldb, ldc : Number of elements between two rows of \e A, \e B and \e C.
+  \param C : Result.
+*/
+void vpGEMMKernel(bool transA, bool transB, unsigned int m, unsigned int n, unsigned int k,
+                  double alpha, const double *A, unsigned int lda, const double *B, unsigned int ldb,
+                  double beta, double *C, unsigned int ldc)
+{
+  if (m == 0 || n == 0)
+    return;
+
+  vpGemmData g;
+  g.transA = transA; g.transB = transB;
+  g.m = m; g.n = n; g.k = k;
+  g.alpha = alpha;
+  g.A = A; g.lda = lda;
+  g.B = B; g.ldb = ldb;
+  g.C = C; g.ldc = ldc;
+
+  if ((double)m * (double)n * (double)k <= vpGemmSmallSize) {
+    gemmSmall(g, beta);
+    return;
+  }
+
+  g.kernel = selectGemmMicroKernel();
+  const unsigned int nbBlocks = (m + vpGemmMC - 1) / vpGemmMC;
+  std::vector<double> Bp;
+
+  for (g.j0 = 0; g.j0 < n; g.j0 += vpGemmNC) {
+    g.nc = (n - g.j0 < vpGemmNC) ? n - g.j0 : vpGemmNC;
+    for (g.p0 = 0; g.p0 < k; g.p0 += vpGemmKC) {
+      g.kc = (k - g.p0 < vpGemmKC) ? k - g.p0 : vpGemmKC;
+      g.beta = (g.p0 == 0) ? beta : 1.;
+
+      Bp.resize(((g.nc + vpGemmNR - 1) / vpGemmNR) * vpGemmNR * g.kc);
+      packB(g, &Bp[0]);
+      g.Bp = &Bp[0];
+
+      const double blockSize = (double)vpGemmMC * g.nc * g.kc;
+      vpThreadPool::parallelFor(0, nbBlocks, gemmRowBlocks, &g, (unsigned int)(vpGemmMinSizePerBand / blockSize) + 1);
+    }
+  }
+}
+
+/*!
+  Compute \f$ y = A \, x \f$ where \e A is a row-major array of \e m rows and
+  \e n columns.
+
+  This is the kernel behind the vpMatrix by vpColVector product. It uses AVX
+  when the processor supports it and splits large products between the
+  threads of vpThreadPool.
+
+  \param m, n : Number of rows and columns of \e A.
+  \param A : Input array.
+  \param lda : Number of elements between two rows of \e A.
+  \param x : Vector of \e n elements.
+  \param y : Result, vector of \e m elements that must not overlap \e x.
+*/
+void vpGEMVKernel(unsigned int m, unsigned int n, const double *A, unsigned int lda, const double *x, double *y)
+{
+  vpGemvData g;
+  g.n = n;
+  g.A = A;
+  g.lda = lda;
+  g.x = x;
+  g.y = y;
+  g.kernel = gemvRows;
+#if defined(VISP_GEMM_AVX)
+  if (vpCPUFeatures::checkAVX())
+    g.kernel = gemvRowsAVX;
+#endif
+
+  // Bands of a multiple of 4 rows
+  const unsigned int minRows = ((vpGemvMinSizePerBand / (n + 1) + 1 + 3) / 4) * 4;
+  vpThreadPool::parallelFor(0, m, gemvBand, &g, minRows);
+}
@@ -62,10 +62,12 @@
 
 #include <visp3/core/vpMatrix.h>
 #include <visp3/core/vpMath.h>
+#include <visp3/core/vpSubMatrix.h>
 #include <visp3/core/vpTranslationVector.h>
 #include <visp3/core/vpColVector.h>
 #include <visp3/core/vpException.h>
 #include <visp3/core/vpDebug.h>
+#include <visp3/core/vpGEMM.h>
 
 //Prototypes of specific functions
 vpMatrix subblock(const vpMatrix &, unsigned int, unsigned int);
@@ -300,21 +302,8 @@ void vpMatrix::AAt(vpMatrix &B) const
   }
 
   // compute A*A^T
-  for(unsigned int i=0;i<rowNum;i++){
-    for(unsigned int j=i;j<rowNum;j++){
-      double *pi = rowPtrs[i];// row i
-      double *pj = rowPtrs[j];// row j
-
-      // sum (row i .* row j)
-      double ssum=0;
-      for(unsigned int k=0; k < colNum ;k++)
-        ssum += *(pi++)* *(pj++);
-
-      B[i][j]=ssum; //upper triangle
-      if(i!=j)
-        B[j][i]=ssum; //lower triangle
-    }
-  }
+  vpGEMMKernel(false, true, rowNum, rowNum, colNum, 1., vpGEMMData(*this), vpGEMMStride(*this),
+               vpGEMMData(*this), vpGEMMStride(*this), 0., vpGEMMData(B), vpGEMMStride(B));
 }
 
 /*!
@@ -338,33 +327,9 @@ void vpMatrix::AtA(vpMatrix &B) const
     throw ;
   }
 
-  unsigned int i,j,k;
-  double s;
-  double *ptr;
-  for (i=0;i<colNum;i++)
-  {
-    double *Bi = B[i] ;
-    for (j=0;j<i;j++)
-    {
-      ptr=data;
-      s = 0 ;
-      for (k=0;k<rowNum;k++)
-      {
-        s +=(*(ptr+i)) * (*(ptr+j));
-        ptr+=colNum;
-      }
-      *Bi++ = s ;
-      B[j][i] = s;
-    }
-    ptr=data;
-    s = 0 ;
-    for (k=0;k<rowNum;k++)
-    {
-      s +=(*(ptr+i)) * (*(ptr+i));
-      ptr+=colNum;
-    }
-    *Bi = s;
-  }
+  // compute A^T*A
+  vpGEMMKernel(true, false, colNum, colNum, rowNum, 1., vpGEMMData(*this), vpGEMMStride(*this),
+               vpGEMMData(*this), vpGEMMStride(*this), 0., vpGEMMData(B), vpGEMMStride(B));
 }
 
 
@@ -411,6 +376,49 @@ vpMatrix::operator=(const vpArray2D<double> &A)
   return *this;
 }
 
+/*!
+  Copy operator.
+*/
+vpMatrix &
+vpMatrix::operator=(const vpMatrix &A)
+{
+  vpArray2D<double>::operator=(A);
+  return *this;
+}
+
+#ifdef VISP_HAVE_CPP11_COMPATIBILITY
+/*!
+  Move constructor. The memory of \e A is taken without copy and \e A
+  becomes an empty matrix. A vpSubMatrix, that points toward the memory of
+  its parent, is copied.
+*/
+vpMatrix::vpMatrix(vpMatrix &&A)
+  : vpArray2D<double>()
+{
+  *this = std::move(A);
+}
+
+/*!
+  Move operator. The memory of \e A is taken without copy and \e A becomes
+  an empty matrix. A vpSubMatrix, that points toward the memory of its
+  parent, is copied.
+
+  \code
+  vpMatrix A, B(6, 6), C(6, 6);
+  A = B * C; // The result of the product is not copied in A
+  \endcode
+*/
+vpMatrix &
+vpMatrix::operator=(vpMatrix &&A)
+{
+  if (dynamic_cast<vpSubMatrix *>(&A) != NULL)
+    vpArray2D<double>::operator=(A);
+  else
+    vpArray2D<double>::operator=(std::move(A));
+  return *this;
+}
+#endif
+
 //! Set all the element of the matrix A to \e x.
 vpMatrix &
 vpMatrix::operator=(double x)
@@ -611,6 +619,12 @@ void vpMatrix::multMatrixVector(const vpMatrix &A, const vpColVector &v, vpColVe
                       A.getRows(), A.getCols(), v.getRows())) ;
   }
 
+  if (&v == &w) {
+    vpColVector v_copy(v);
+    multMatrixVector(A, v_copy, w);
+    return;
+  }
+
   try {
     if (A.rowNum != w.rowNum) w.resize(A.rowNum);
   }
@@ -618,13 +632,7 @@ void vpMatrix::multMatrixVector(const vpMatrix &A, const vpColVector &v, vpColVe
     throw ;
   }
 
-  w = 0.0;
-  for (unsigned int j=0;j<A.colNum;j++) {
-    double vj = v[j] ; // optimization em 5/12/2006
-    for (unsigned int i=0;i<A.rowNum;i++) {
-      w[i]+=A.rowPtrs[i][j] * vj;
-    }
-  }
+  vpGEMVKernel(A.rowNum, A.colNum, vpGEMMData(A), vpGEMMStride(A), vpGEMMData(v), vpGEMMData(w));
 }
 
 //---------------------------------
@@ -655,22 +663,8 @@ void vpMatrix::mult2Matrices(const vpMatrix &A, const vpMatrix &B, vpMatrix &C)
                       A.getRows(), A.getCols(), B.getRows(), B.getCols())) ;
   }
 
-  // 5/12/06 some "very" simple optimization to avoid indexation
-  unsigned int BcolNum = B.colNum;
-  unsigned int BrowNum = B.rowNum;
-  unsigned int i,j,k;
-  double **BrowPtrs = B.rowPtrs;
-  for (i=0;i<A.rowNum;i++)
-  {
-    double *rowptri = A.rowPtrs[i];
-    double *ci = C[i];
-    for (j=0;j<BcolNum;j++)
-    {
-      double s = 0;
-      for (k=0;k<BrowNum;k++) s += rowptri[k] * BrowPtrs[k][j];
-      ci[j] = s;
-    }
-  }
+  vpGEMMKernel(false, false, A.rowNum, B.colNum, B.rowNum, 1., vpGEMMData(A), vpGEMMStride(A),
+               vpGEMMData(B), vpGEMMStride(B), 0., vpGEMMData(C), vpGEMMStride(C));
 }
 
 /*!
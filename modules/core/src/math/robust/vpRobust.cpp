@@ -53,11 +53,25 @@
 #include <stdlib.h>
 #include <cmath>    // std::fabs
 #include <limits>   // numeric_limits
+#include <algorithm> // std::nth_element
 
 #define vpITMAX 100
 #define vpEPS 3.0e-7
 #define vpCST 1
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+  // Return the k-th smallest value of a[0], ..., a[n-1] in linear time.
+  // The values are reordered.
+  inline double nthValue(double *a, unsigned int n, unsigned int k)
+  {
+    std::nth_element(a, a + k, a + n);
+    return a[k];
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 
 // ===================================================================
 /*!
@@ -66,7 +80,7 @@
 
 */
 vpRobust::vpRobust(unsigned int n_data)
-  : normres(), sorted_normres(), sorted_residues(), NoiseThreshold(0.0017), sig_prev(0), it(0), swap(0), size(n_data)
+  : normres(), sorted_normres(), sorted_residues(), all_normres(), NoiseThreshold(0.0017), sig_prev(0), it(0), swap(0), size(n_data)
 {
   vpCDEBUG(2) << "vpRobust constructor reached" << std::endl;
 
@@ -81,7 +95,7 @@ vpRobust::vpRobust(unsigned int n_data)
 
 */
 vpRobust::vpRobust()
-  : normres(), sorted_normres(), sorted_residues(), NoiseThreshold(0.0017), sig_prev(0), it(0), swap(0), size(0)
+  : normres(), sorted_normres(), sorted_residues(), all_normres(), NoiseThreshold(0.0017), sig_prev(0), it(0), swap(0), size(0)
 {
   vpCDEBUG(2) << "vpRobust constructor with no argument reached" << std::endl;
 }
@@ -151,25 +165,29 @@ void vpRobust::MEstimator(const vpRobustEstimatorType method,
   // resize vector only if the size of residue vector has changed
   unsigned int n_data = residues.getRows();
   resize(n_data); 
+
+  if (n_data == 0)
+    return;
   
-  sorted_residues = residues;
+  memcpy(sorted_residues.data, residues.data, n_data*sizeof(double));
   
   unsigned int ind_med = (unsigned int)(ceil(n_data/2.0))-1;
 
   // Calculate median
-  med = select(sorted_residues, 0, (int)n_data-1, (int)ind_med/*(int)n_data/2*/);
+  med = nthValue(sorted_residues.data, n_data, ind_med);
    //residualMedian = med ;
 
   // Normalize residues
+  const double *r = residues.data;
+  double *nr = normres.data;
   for(unsigned int i=0; i<n_data; i++)
   {
-    normres[i] = (fabs(residues[i]- med));
-    sorted_normres[i] = (fabs(sorted_residues[i]- med));
-
+    nr[i] = fabs(r[i] - med);
   }
+  memcpy(sorted_normres.data, normres.data, n_data*sizeof(double));
 
   // Calculate MAD
-  normmedian = select(sorted_normres, 0, (int)n_data-1, (int)ind_med/*(int)n_data/2*/);
+  normmedian = nthValue(sorted_normres.data, n_data, ind_med);
   //normalizedResidualMedian = normmedian ;
   // 1.48 keeps scale estimate consistent for a normal probability dist.
   sigma = 1.4826*normmedian; // median Absolute Deviation
@@ -222,7 +240,8 @@ void vpRobust::MEstimator(const vpRobustEstimatorType method,
   double sigma=0;// Standard Deviation
 
   unsigned int n_all_data = all_residues.getRows();
-  vpColVector all_normres(n_all_data); 
+  if (all_normres.getRows() != n_all_data)
+    all_normres.resize(n_all_data, false);
 
   // compute median with the residues vector, return all_normres which are the normalized all_residues vector.
   normmedian = computeNormalizedMedian(all_normres,residues,all_residues,weights);
@@ -271,6 +290,20 @@ void vpRobust::MEstimator(const vpRobustEstimatorType method,
 
 
 
+/*!
+  Compute the median absolute deviation of the residues that have a non null
+  weight. The residues are copied in the internal buffers, so that no memory
+  is allocated as long as the number of residues does not change.
+
+  \param all_normres : Absolute deviation of \e all_residues from the median
+  of the residues. Its size must be the size of \e all_residues.
+  \param residues : Residues.
+  \param all_residues : All the residues.
+  \param weights : Weights of the residues. Only the residues with a non null
+  weight are considered.
+
+  \return The median absolute deviation, 0 if all the weights are null.
+*/
 double vpRobust::computeNormalizedMedian(vpColVector &all_normres,
 					 const vpColVector &residues,
 					 const vpColVector &all_residues,
@@ -285,57 +318,45 @@ double vpRobust::computeNormalizedMedian(vpColVector &all_normres,
   
   // resize vector only if the size of residue vector has changed
   resize(n_data);
-    
-  sorted_residues = residues;
-  vpColVector no_null_weight_residues;
-  no_null_weight_residues.resize(n_data);
-  
-  //all_normres.resize(n_all_data); // Normalized Residue
-  //vpColVector sorted_normres(n_data); // Normalized Residue
-  //vpColVector sorted_residues = residues;
-  //vpColVector sorted_residues;
-  
 
+  // Be careful to not use the rejected residues for the
+  // calculation.
   unsigned int index =0;
   for(unsigned int j=0;j<n_data;j++)
   {
     //if(weights[j]!=0)
     if(std::fabs(weights[j]) > std::numeric_limits<double>::epsilon())
     {
-      no_null_weight_residues[index]=residues[j];
+      sorted_residues[index]=residues[j];
       index++;
     }
   }
-  sorted_residues.resize(index);
-  memcpy(sorted_residues.data,no_null_weight_residues.data,index*sizeof(double));
   n_data=index;
 
   vpCDEBUG(2) << "vpRobust MEstimator reached. No. data = " << n_data
 	      << std::endl;
 
   // Calculate Median
-  // Be careful to not use the rejected residues for the
-  // calculation.
-  
-  unsigned int ind_med = (unsigned int)(ceil(n_data/2.0))-1;
-  med = select(sorted_residues, 0, (int)n_data-1, (int)ind_med/*(int)n_data/2*/);
+  if (n_data > 0) {
+    unsigned int ind_med = (unsigned int)(ceil(n_data/2.0))-1;
+    med = nthValue(sorted_residues.data, n_data, ind_med);
 
-  unsigned int i;
-  // Normalize residues
-  for(i=0; i<n_all_data; i++)
-  {
-    all_normres[i] = (fabs(all_residues[i]- med));
+    for(unsigned int i=0; i<n_data; i++)
+    {
+      sorted_normres[i] = (fabs(sorted_residues[i]- med));
+    }
+
+    // MAD calculated only on first iteration
+    normmedian = nthValue(sorted_normres.data, n_data, ind_med);
   }
 
-  for(i=0; i<n_data; i++)
+  // Normalize residues
+  const double *r = all_residues.data;
+  double *nr = all_normres.data;
+  for(unsigned int i=0; i<n_all_data; i++)
   {
-    sorted_normres[i] = (fabs(sorted_residues[i]- med));
+    nr[i] = fabs(r[i] - med);
   }
-  // MAD calculated only on first iteration
-
-  //normmedian = Median(normres, weights);
-  //normmedian = Median(normres);
-  normmedian = select(sorted_normres, 0, (int)n_data-1, (int)ind_med/*(int)n_data/2*/);
 
   return normmedian;
 }
@@ -598,29 +619,28 @@ void vpRobust::psiTukey(double sig, vpColVector &x, vpColVector & weights)
 
   unsigned int n_data = x.getRows();
   double cst_const = vpCST*4.6851;
+  const double eps = std::numeric_limits<double>::epsilon();
+  const double *x_ = x.data;
+  double *w = weights.data;
 
-  for(unsigned int i=0; i<n_data; i++)
+  //if(sig==0)
+  if(std::fabs(sig) <= eps)
   {
-    //if(sig==0 && weights[i]!=0)
-    if(std::fabs(sig) <= std::numeric_limits<double>::epsilon() && std::fabs(weights[i]) > std::numeric_limits<double>::epsilon())
-    {
-      weights[i]=1;
-      continue;
-    }
+    // Only the points that were not already rejected are kept
+    for(unsigned int i=0; i<n_data; i++)
+      w[i] = (std::fabs(w[i]) > eps) ? 1. : 0.;
+    return;
+  }
 
-    double xi_sig = x[i]/sig;
+  // Branch free loop, so that it can be vectorized by the compiler
+  for(unsigned int i=0; i<n_data; i++)
+  {
+    double xi_sig = x_[i]/sig;
+    double wi = vpMath::sqr(1-vpMath::sqr(xi_sig/cst_const));
 
     //if((fabs(xi_sig)<=(cst_const)) && weights[i]!=0)
-    if((std::fabs(xi_sig)<=(cst_const)) && std::fabs(weights[i]) > std::numeric_limits<double>::epsilon())
-    {
-      weights[i] = vpMath::sqr(1-vpMath::sqr(xi_sig/cst_const));
-      //w[i] = vpMath::sqr(1-vpMath::sqr(x[i]/sig/4.7));
-    }
-    else
-    {
-      //Outlier - could resize list of points tracked here?
-      weights[i] = 0;
-    }
+    //Outlier - could resize list of points tracked here?
+    w[i] = ((std::fabs(xi_sig)<=(cst_const)) && std::fabs(w[i]) > eps) ? wi : 0.;
   }
 }
 
@@ -635,18 +655,18 @@ void vpRobust::psiHuber(double sig, vpColVector &x, vpColVector &weights)
 {
   double c = 1.2107; //1.345;
   unsigned int n_data = x.getRows();
+  const double eps = std::numeric_limits<double>::epsilon();
+  const double *x_ = x.data;
+  double *w = weights.data;
 
+  // Branch free loop, so that it can be vectorized by the compiler
   for(unsigned int i=0; i<n_data; i++)
   {
+    double xi_sig = fabs(x_[i]/sig);
+    double wi = (xi_sig<=c) ? 1. : c/xi_sig;
+
     //if(weights[i]!=0)
-    if(std::fabs(weights[i]) > std::numeric_limits<double>::epsilon())
-    {
-      double xi_sig = x[i]/sig;
-      if(fabs(xi_sig)<=c)
-	weights[i] = 1;
-      else
-	weights[i] = c/fabs(xi_sig);
-    }
+    w[i] = (std::fabs(w[i]) > eps) ? wi : w[i];
   }
 }
 
@@ -662,11 +682,13 @@ void vpRobust::psiCauchy(double sig, vpColVector &x, vpColVector &weights)
 {
   unsigned int n_data = x.getRows();
   double const_sig = 2.3849*sig;
+  const double *x_ = x.data;
+  double *w = weights.data;
 
   //Calculate Cauchy's equation
   for(unsigned int i=0; i<n_data; i++)
   {
-    weights[i] = 1/(1+vpMath::sqr(x[i]/(const_sig)));
+    w[i] = 1/(1+vpMath::sqr(x_[i]/(const_sig)));
 
     // If one coordinate is an outlier the other is too!
     // w[i] < 0.01 is a threshold to be set
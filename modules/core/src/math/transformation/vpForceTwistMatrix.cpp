@@ -43,6 +43,24 @@
 #include <visp3/core/vpException.h>
 #include <visp3/core/vpDebug.h>
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  // Fill the row-major 6x6 twist F = [R 0 ; [t]_x R R] from the row-major
+  // rotation R and the translation t
+  void buildForceTwist(const double *R, const double *t, double *F)
+  {
+    for (unsigned int j=0 ; j < 3 ; j++) {
+      F[j]    = R[j];   F[6+j]  = R[3+j]; F[12+j] = R[6+j];
+      F[21+j] = R[j];   F[27+j] = R[3+j]; F[33+j] = R[6+j];
+      F[3+j]  = 0.;     F[9+j]  = 0.;     F[15+j] = 0.;
+      F[18+j] = -t[2]*R[3+j] + t[1]*R[6+j];
+      F[24+j] =  t[2]*R[j]   - t[0]*R[6+j];
+      F[30+j] = -t[1]*R[j]   + t[0]*R[3+j];
+    }
+  }
+}
+#endif
+
 
 /*!
   \file vpForceTwistMatrix.cpp
@@ -91,7 +109,7 @@ vpForceTwistMatrix::eye()
   Initialize a force/torque twist transformation matrix to identity.
 */
 vpForceTwistMatrix::vpForceTwistMatrix()
-  : vpArray2D<double>(6,6)
+  : vpFixedArray2D<double, 6, 6>()
 {
   eye() ;
 }
@@ -104,7 +122,7 @@ vpForceTwistMatrix::vpForceTwistMatrix()
   \param F : Force/torque twist matrix used as initializer.
 */
 vpForceTwistMatrix::vpForceTwistMatrix(const vpForceTwistMatrix &F)
-  : vpArray2D<double>(6,6)
+  : vpFixedArray2D<double, 6, 6>()
 {
   *this = F ;
 }
@@ -134,7 +152,7 @@ vpForceTwistMatrix::vpForceTwistMatrix(const vpForceTwistMatrix &F)
 
 */
 vpForceTwistMatrix::vpForceTwistMatrix(const vpHomogeneousMatrix &M)
-  : vpArray2D<double>(6,6)
+  : vpFixedArray2D<double, 6, 6>()
 {
   buildFrom(M);
 }
@@ -151,7 +169,7 @@ vpForceTwistMatrix::vpForceTwistMatrix(const vpHomogeneousMatrix &M)
 */
 vpForceTwistMatrix::vpForceTwistMatrix(const vpTranslationVector &t,
                                        const vpThetaUVector &thetau)
-  : vpArray2D<double>(6,6)
+  : vpFixedArray2D<double, 6, 6>()
 {
   buildFrom(t, thetau) ;
 }
@@ -168,7 +186,7 @@ vpForceTwistMatrix::vpForceTwistMatrix(const vpTranslationVector &t,
 */
 vpForceTwistMatrix::vpForceTwistMatrix(const vpTranslationVector &t,
                                        const vpRotationMatrix &R)
-  : vpArray2D<double>(6,6)
+  : vpFixedArray2D<double, 6, 6>()
 {
   buildFrom(t, R) ;
 }
@@ -184,7 +202,7 @@ vpForceTwistMatrix::vpForceTwistMatrix(const vpTranslationVector &t,
 */
 vpForceTwistMatrix::vpForceTwistMatrix(const double tx, const double ty, const double tz,
                                        const double tux, const double tuy, const double tuz)
-  : vpArray2D<double>(6,6)
+  : vpFixedArray2D<double, 6, 6>()
 {
   vpTranslationVector T(tx,ty,tz) ;
   vpThetaUVector tu(tux,tuy,tuz) ;
@@ -213,14 +231,13 @@ vpForceTwistMatrix
 vpForceTwistMatrix::operator*(const vpForceTwistMatrix &F) const
 {
   vpForceTwistMatrix Fout ;
+  const double *b = F.data;
+  double *c = Fout.data;
 
   for (unsigned int i=0;i<6;i++) {
-    for (unsigned int j=0;j<6;j++) {
-      double s =0 ;
-      for (unsigned int k=0;k<6;k++)
-        s +=rowPtrs[i][k] * F.rowPtrs[k][j];
-      Fout[i][j] = s ;
-    }
+    const double *a = data + 6*i;
+    for (unsigned int j=0;j<6;j++)
+      c[6*i+j] = a[0]*b[j] + a[1]*b[6+j] + a[2]*b[12+j] + a[3]*b[18+j] + a[4]*b[24+j] + a[5]*b[30+j];
   }
   return Fout;
 }
@@ -337,16 +354,7 @@ vpForceTwistMatrix
 vpForceTwistMatrix::buildFrom(const vpTranslationVector &t,
                               const vpRotationMatrix &R)
 {
-  unsigned int i, j;
-  vpMatrix skewaR = t.skew(t)*R ;
-  
-  for (i=0 ; i < 3 ; i++) {
-    for (j=0 ; j < 3 ; j++)	{
-      (*this)[i][j] = R[i][j] ;
-      (*this)[i+3][j+3] = R[i][j] ;
-      (*this)[i+3][j] = skewaR[i][j] ;
-    }
-  }
+  buildForceTwist(R.data, t.data, data);
   return (*this) ;
 }
 
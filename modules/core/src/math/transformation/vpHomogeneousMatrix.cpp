@@ -54,7 +54,7 @@
  */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t,
                                          const vpQuaternionVector &q)
-  : vpArray2D<double>(4, 4)
+  : vpFixedArray2D<double, 4, 4>()
 {
   buildFrom(t,q);
   (*this)[3][3] = 1.;
@@ -64,7 +64,7 @@ vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t,
   Default constructor that initialize an homogeneous matrix as identity.
 */
 vpHomogeneousMatrix::vpHomogeneousMatrix()
-  : vpArray2D<double>(4, 4)
+  : vpFixedArray2D<double, 4, 4>()
 {
   eye() ;
 }
@@ -73,7 +73,7 @@ vpHomogeneousMatrix::vpHomogeneousMatrix()
   Copy constructor that initialize an homogeneous matrix from another homogeneous matrix.
 */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const vpHomogeneousMatrix &M)
-  : vpArray2D<double>(4, 4)
+  : vpFixedArray2D<double, 4, 4>()
 {
   *this = M;
 }
@@ -83,7 +83,7 @@ vpHomogeneousMatrix::vpHomogeneousMatrix(const vpHomogeneousMatrix &M)
  */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t,
                                          const vpThetaUVector &tu)
-  : vpArray2D<double>(4, 4)
+  : vpFixedArray2D<double, 4, 4>()
 {
   buildFrom(t, tu);
   (*this)[3][3] = 1.;
@@ -94,7 +94,7 @@ vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t,
  */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t,
                                          const vpRotationMatrix &R)
-  : vpArray2D<double>(4, 4)
+  : vpFixedArray2D<double, 4, 4>()
 {
   insert(R);
   insert(t);
@@ -105,7 +105,7 @@ vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t,
   Construct an homogeneous matrix from a pose vector.
  */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const vpPoseVector &p)
-  : vpArray2D<double>(4, 4)
+  : vpFixedArray2D<double, 4, 4>()
 {
   buildFrom(p[0], p[1], p[2], p[3], p[4], p[5]) ;
   (*this)[3][3] = 1.;
@@ -150,7 +150,7 @@ M:
   \endcode
   */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const std::vector<float> &v)
-  : vpArray2D<double>(4, 4)
+  : vpFixedArray2D<double, 4, 4>()
 {
   buildFrom(v) ;
   (*this)[3][3] = 1.;
@@ -195,7 +195,7 @@ M:
   \endcode
   */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const std::vector<double> &v)
-  : vpArray2D<double>(4, 4)
+  : vpFixedArray2D<double, 4, 4>()
 {
   buildFrom(v) ;
   (*this)[3][3] = 1.;
@@ -211,7 +211,7 @@ vpHomogeneousMatrix::vpHomogeneousMatrix(const double tx,
                                          const double tux,
                                          const double tuy,
                                          const double tuz)
-  : vpArray2D<double>(4, 4)
+  : vpFixedArray2D<double, 4, 4>()
 {
   buildFrom(tx, ty, tz, tux, tuy, tuz);
   (*this)[3][3] = 1.;
@@ -421,22 +421,22 @@ vpHomogeneousMatrix
 vpHomogeneousMatrix::operator*(const vpHomogeneousMatrix &M) const
 {
   vpHomogeneousMatrix p;
-
-  vpRotationMatrix R1, R2, R ;
-  vpTranslationVector T1, T2 , T;
-
-  extract(T1) ;
-  M.extract(T2) ;
-
-  extract (R1) ;
-  M.extract (R2) ;
-
-  R = R1*R2 ;
-
-  T = R1*T2 + T1 ;
-
-  p.insert(T) ;
-  p.insert(R) ;
+  const double *a = data, *b = M.data;
+  double *c = p.data;
+
+  // R = R1*R2 and T = R1*T2 + T1, the last row of p being already (0 0 0 1)
+  c[0]  = a[0]*b[0] + a[1]*b[4] + a[2]*b[8];
+  c[1]  = a[0]*b[1] + a[1]*b[5] + a[2]*b[9];
+  c[2]  = a[0]*b[2] + a[1]*b[6] + a[2]*b[10];
+  c[3]  = a[0]*b[3] + a[1]*b[7] + a[2]*b[11] + a[3];
+  c[4]  = a[4]*b[0] + a[5]*b[4] + a[6]*b[8];
+  c[5]  = a[4]*b[1] + a[5]*b[5] + a[6]*b[9];
+  c[6]  = a[4]*b[2] + a[5]*b[6] + a[6]*b[10];
+  c[7]  = a[4]*b[3] + a[5]*b[7] + a[6]*b[11] + a[7];
+  c[8]  = a[8]*b[0] + a[9]*b[4] + a[10]*b[8];
+  c[9]  = a[8]*b[1] + a[9]*b[5] + a[10]*b[9];
+  c[10] = a[8]*b[2] + a[9]*b[6] + a[10]*b[10];
+  c[11] = a[8]*b[3] + a[9]*b[7] + a[10]*b[11] + a[11];
 
   return p;
 }
@@ -673,15 +673,16 @@ vpHomogeneousMatrix
 vpHomogeneousMatrix::inverse() const
 {
   vpHomogeneousMatrix Mi ;
-
-  vpRotationMatrix R ;      extract(R) ;
-  vpTranslationVector T ;   extract(T) ;
-
-  vpTranslationVector RtT ; RtT = -(R.t()*T) ;
-
-
-  Mi.insert(R.t()) ;
-  Mi.insert(RtT) ;
+  const double *a = data;
+  double *c = Mi.data;
+
+  // R^T and -R^T*T
+  c[0] = a[0]; c[1] = a[4]; c[2]  = a[8];
+  c[4] = a[1]; c[5] = a[5]; c[6]  = a[9];
+  c[8] = a[2]; c[9] = a[6]; c[10] = a[10];
+  c[3]  = -(a[0]*a[3] + a[4]*a[7] + a[8]*a[11]);
+  c[7]  = -(a[1]*a[3] + a[5]*a[7] + a[9]*a[11]);
+  c[11] = -(a[2]*a[3] + a[6]*a[7] + a[10]*a[11]);
 
   return Mi ;
 }
@@ -141,15 +141,19 @@ vpRotationMatrix
 vpRotationMatrix::operator*(const vpRotationMatrix &R) const
 {
   vpRotationMatrix p ;
+  const double *a = data, *b = R.data;
+  double *c = p.data;
+
+  c[0] = a[0]*b[0] + a[1]*b[3] + a[2]*b[6];
+  c[1] = a[0]*b[1] + a[1]*b[4] + a[2]*b[7];
+  c[2] = a[0]*b[2] + a[1]*b[5] + a[2]*b[8];
+  c[3] = a[3]*b[0] + a[4]*b[3] + a[5]*b[6];
+  c[4] = a[3]*b[1] + a[4]*b[4] + a[5]*b[7];
+  c[5] = a[3]*b[2] + a[4]*b[5] + a[5]*b[8];
+  c[6] = a[6]*b[0] + a[7]*b[3] + a[8]*b[6];
+  c[7] = a[6]*b[1] + a[7]*b[4] + a[8]*b[7];
+  c[8] = a[6]*b[2] + a[7]*b[5] + a[8]*b[8];
 
-  for (unsigned int i=0;i<3;i++) {
-    for (unsigned int j=0;j<3;j++) {
-      double s =0 ;
-      for (unsigned int k=0;k<3;k++)
-        s +=rowPtrs[i][k] * R.rowPtrs[k][j];
-      p[i][j] = s ;
-    }
-  }
   return p;
 }
 /*! 
@@ -244,15 +248,11 @@ vpTranslationVector
 vpRotationMatrix::operator*(const vpTranslationVector &tv) const
 {
   vpTranslationVector p ;
+  const double *a = data, *t = tv.data;
 
-  for (unsigned int j=0;j<3;j++)
-    p[j] = 0;
-
-  for (unsigned int j=0;j<3;j++) {
-    for (unsigned int i=0;i<3;i++) {
-      p[i] += rowPtrs[i][j] * tv[j];
-    }
-  }
+  p[0] = a[0]*t[0] + a[1]*t[1] + a[2]*t[2];
+  p[1] = a[3]*t[0] + a[4]*t[1] + a[5]*t[2];
+  p[2] = a[6]*t[0] + a[7]*t[1] + a[8]*t[2];
 
   return p;
 }
@@ -331,7 +331,7 @@ vpRotationMatrix::isARotationMatrix() const
 /*!
   Default constructor that initialise a 3-by-3 rotation matrix to identity.
 */
-vpRotationMatrix::vpRotationMatrix() : vpArray2D<double>(3,3)
+vpRotationMatrix::vpRotationMatrix() : vpFixedArray2D<double, 3, 3>()
 {
   eye();
 }
@@ -340,14 +340,14 @@ vpRotationMatrix::vpRotationMatrix() : vpArray2D<double>(3,3)
 /*!
   Copy contructor that construct a 3-by-3 rotation matrix from another rotation matrix.
 */
-vpRotationMatrix::vpRotationMatrix(const vpRotationMatrix &M) : vpArray2D<double>(3,3)
+vpRotationMatrix::vpRotationMatrix(const vpRotationMatrix &M) : vpFixedArray2D<double, 3, 3>()
 {
   (*this) = M ;
 }
 /*!
   Construct a 3-by-3 rotation matrix from an homogeneous matrix.
 */
-vpRotationMatrix::vpRotationMatrix(const vpHomogeneousMatrix &M) : vpArray2D<double>(3,3)
+vpRotationMatrix::vpRotationMatrix(const vpHomogeneousMatrix &M) : vpFixedArray2D<double, 3, 3>()
 {
   buildFrom(M);
 }
@@ -355,7 +355,7 @@ vpRotationMatrix::vpRotationMatrix(const vpHomogeneousMatrix &M) : vpArray2D<dou
 /*!
   Construct a 3-by-3 rotation matrix from \f$ \theta {\bf u}\f$ angle representation.
  */
-vpRotationMatrix::vpRotationMatrix(const vpThetaUVector &tu) : vpArray2D<double>(3,3)
+vpRotationMatrix::vpRotationMatrix(const vpThetaUVector &tu) : vpFixedArray2D<double, 3, 3>()
 {
   buildFrom(tu) ;
 }
@@ -363,7 +363,7 @@ vpRotationMatrix::vpRotationMatrix(const vpThetaUVector &tu) : vpArray2D<double>
 /*!
   Construct a 3-by-3 rotation matrix from a pose vector.
  */
-vpRotationMatrix::vpRotationMatrix(const vpPoseVector &p) : vpArray2D<double>(3,3)
+vpRotationMatrix::vpRotationMatrix(const vpPoseVector &p) : vpFixedArray2D<double, 3, 3>()
 {
   buildFrom(p) ;
 }
@@ -371,7 +371,7 @@ vpRotationMatrix::vpRotationMatrix(const vpPoseVector &p) : vpArray2D<double>(3,
 /*!
   Construct a 3-by-3 rotation matrix from \f$ R(z,y,z) \f$ Euler angle representation.
  */
-vpRotationMatrix::vpRotationMatrix(const vpRzyzVector &euler) : vpArray2D<double>(3,3)
+vpRotationMatrix::vpRotationMatrix(const vpRzyzVector &euler) : vpFixedArray2D<double, 3, 3>()
 {
   buildFrom(euler) ;
 }
@@ -379,7 +379,7 @@ vpRotationMatrix::vpRotationMatrix(const vpRzyzVector &euler) : vpArray2D<double
 /*!
   Construct a 3-by-3 rotation matrix from \f$ R(x,y,z) \f$ Euler angle representation.
  */
-vpRotationMatrix::vpRotationMatrix(const vpRxyzVector &Rxyz) : vpArray2D<double>(3,3)
+vpRotationMatrix::vpRotationMatrix(const vpRxyzVector &Rxyz) : vpFixedArray2D<double, 3, 3>()
 {
   buildFrom(Rxyz) ;
 }
@@ -387,7 +387,7 @@ vpRotationMatrix::vpRotationMatrix(const vpRxyzVector &Rxyz) : vpArray2D<double>
 /*!
   Construct a 3-by-3 rotation matrix from \f$ R(z,y,x) \f$ Euler angle representation.
  */
-vpRotationMatrix::vpRotationMatrix(const vpRzyxVector &Rzyx) : vpArray2D<double>(3,3)
+vpRotationMatrix::vpRotationMatrix(const vpRzyxVector &Rzyx) : vpFixedArray2D<double, 3, 3>()
 {
   buildFrom(Rzyx) ;
 }
@@ -395,7 +395,7 @@ vpRotationMatrix::vpRotationMatrix(const vpRzyxVector &Rzyx) : vpArray2D<double>
 /*!
   Construct a 3-by-3 rotation matrix from \f$ \theta {\bf u}=(\theta u_x, \theta u_y, \theta u_z)^T\f$ angle representation.
  */
-vpRotationMatrix::vpRotationMatrix(const double tux, const double tuy, const double tuz) : vpArray2D<double>(3,3)
+vpRotationMatrix::vpRotationMatrix(const double tux, const double tuy, const double tuz) : vpFixedArray2D<double, 3, 3>()
 {
   buildFrom(tux, tuy, tuz) ;
 }
@@ -403,7 +403,7 @@ vpRotationMatrix::vpRotationMatrix(const double tux, const double tuy, const dou
 /*!
   Construct a 3-by-3 rotation matrix from quaternion angle representation.
  */
-vpRotationMatrix::vpRotationMatrix(const vpQuaternionVector& q) : vpArray2D<double>(3,3)
+vpRotationMatrix::vpRotationMatrix(const vpQuaternionVector& q) : vpFixedArray2D<double, 3, 3>()
 {
   buildFrom(q);
 }
@@ -417,11 +417,12 @@ vpRotationMatrix
 vpRotationMatrix::t() const
 {
   vpRotationMatrix Rt ;
+  const double *a = data;
+  double *c = Rt.data;
 
-  unsigned int i,j;
-  for (i=0;i<3;i++)
-    for (j=0;j<3;j++)
-      Rt[j][i] = (*this)[i][j];
+  c[0] = a[0]; c[1] = a[3]; c[2] = a[6];
+  c[3] = a[1]; c[4] = a[4]; c[5] = a[7];
+  c[6] = a[2]; c[7] = a[5]; c[8] = a[8];
 
   return Rt;
 }
@@ -433,9 +434,7 @@ vpRotationMatrix::t() const
 */
 vpRotationMatrix vpRotationMatrix::inverse() const
 {
-  vpRotationMatrix Ri = (*this).t() ;
-
-  return Ri ;
+  return t() ;
 }
 
 /*!
@@ -41,6 +41,24 @@
 #include <visp3/core/vpVelocityTwistMatrix.h>
 #include <visp3/core/vpException.h>
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  // Fill the row-major 6x6 twist V = [R [t]_x R ; 0 R] from the row-major
+  // rotation R and the translation t
+  void buildVelocityTwist(const double *R, const double *t, double *V)
+  {
+    for (unsigned int j=0 ; j < 3 ; j++) {
+      V[j]    = R[j];   V[6+j]  = R[3+j]; V[12+j] = R[6+j];
+      V[21+j] = R[j];   V[27+j] = R[3+j]; V[33+j] = R[6+j];
+      V[18+j] = 0.;     V[24+j] = 0.;     V[30+j] = 0.;
+      V[3+j]  = -t[2]*R[3+j] + t[1]*R[6+j];
+      V[9+j]  =  t[2]*R[j]   - t[0]*R[6+j];
+      V[15+j] = -t[1]*R[j]   + t[0]*R[3+j];
+    }
+  }
+}
+#endif
+
 
 /*!
   \file vpVelocityTwistMatrix.cpp
@@ -89,7 +107,7 @@ vpVelocityTwistMatrix::eye()
   Initialize a velocity twist transformation matrix as identity.
 */
 vpVelocityTwistMatrix::vpVelocityTwistMatrix()
-  : vpArray2D<double>(6, 6)
+  : vpFixedArray2D<double, 6, 6>()
 {
   eye() ;
 }
@@ -100,7 +118,7 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix()
   \param V : Velocity twist matrix used as initializer.
 */
 vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpVelocityTwistMatrix &V)
-  : vpArray2D<double>(6, 6)
+  : vpFixedArray2D<double, 6, 6>()
 {
   *this = V;
 }
@@ -116,7 +134,7 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpVelocityTwistMatrix &V)
 
 */
 vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpHomogeneousMatrix &M)
-  : vpArray2D<double>(6, 6)
+  : vpFixedArray2D<double, 6, 6>()
 {
   buildFrom(M);
 }
@@ -133,7 +151,7 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpHomogeneousMatrix &M)
 */
 vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpTranslationVector &t,
                                              const vpThetaUVector &thetau)
-  : vpArray2D<double>(6, 6)
+  : vpFixedArray2D<double, 6, 6>()
 {
   buildFrom(t, thetau) ;
 }
@@ -150,7 +168,7 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpTranslationVector &t,
 */
 vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpTranslationVector &t,
                                              const vpRotationMatrix &R)
-  : vpArray2D<double>(6, 6)
+  : vpFixedArray2D<double, 6, 6>()
 {
   buildFrom(t,R) ;
 }
@@ -171,7 +189,7 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix(const double tx,
 					     const double tux,
 					     const double tuy,
                const double tuz)
-  : vpArray2D<double>(6, 6)
+  : vpFixedArray2D<double, 6, 6>()
 {
   vpTranslationVector T(tx,ty,tz) ;
   vpThetaUVector tu(tux,tuy,tuz) ;
@@ -188,15 +206,14 @@ vpVelocityTwistMatrix
 vpVelocityTwistMatrix::operator*(const vpVelocityTwistMatrix &V) const
 {
   vpVelocityTwistMatrix p ;
+  const double *b = V.data;
+  double *c = p.data;
 
-  for (unsigned int i=0;i<6;i++)
+  for (unsigned int i=0;i<6;i++) {
+    const double *a = data + 6*i;
     for (unsigned int j=0;j<6;j++)
-    {
-      double s =0 ;
-      for (int k=0;k<6;k++)
-        s +=rowPtrs[i][k] * V.rowPtrs[k][j];
-      p[i][j] = s ;
-    }
+      c[6*i+j] = a[0]*b[j] + a[1]*b[6+j] + a[2]*b[12+j] + a[3]*b[18+j] + a[4]*b[24+j] + a[5]*b[30+j];
+  }
   return p;
 }
 
@@ -307,17 +324,7 @@ vpVelocityTwistMatrix
 vpVelocityTwistMatrix::buildFrom(const vpTranslationVector &t,
                                  const vpRotationMatrix &R)
 {
-  unsigned int i, j;
-  vpMatrix skewaR = t.skew(t)*R ;
-
-  for (i=0 ; i < 3 ; i++)
-    for (j=0 ; j < 3 ; j++)
-    {
-      (*this)[i][j] = R[i][j] ;
-      (*this)[i+3][j+3] = R[i][j] ;
-      (*this)[i][j+3] = skewaR[i][j] ;
-
-    }
+  buildVelocityTwist(R.data, t.data, data);
   return (*this) ;
 }
 
@@ -370,11 +377,20 @@ vpVelocityTwistMatrix
 vpVelocityTwistMatrix::inverse() const
 {
   vpVelocityTwistMatrix Wi;
-  vpRotationMatrix R;extract(R);
-  vpTranslationVector T;extract(T);
-  vpTranslationVector RtT ; RtT = -(R.t()*T) ;
-
-  Wi.buildFrom(RtT,R.t());
+  const double *V = data;
+
+  // R^T, and t from the upper right block [t]_x R as ([t]_x R) R^T = [t]_x
+  double Rt[9], t[3], RtT[3];
+  for (unsigned int i=0 ; i < 3 ; i++)
+    for (unsigned int j=0 ; j < 3; j++)
+      Rt[3*i+j] = V[6*j+i];
+  t[0] = V[15]*V[6] + V[16]*V[7] + V[17]*V[8];   // ([t]_x)[2][1]
+  t[1] = V[3]*V[12] + V[4]*V[13] + V[5]*V[14];   // ([t]_x)[0][2]
+  t[2] = V[9]*V[0] + V[10]*V[1] + V[11]*V[2];    // ([t]_x)[1][0]
+  for (unsigned int i=0 ; i < 3 ; i++)
+    RtT[i] = -(Rt[3*i]*t[0] + Rt[3*i+1]*t[1] + Rt[3*i+2]*t[2]);
+
+  buildVelocityTwist(Rt, RtT, Wi.data);
 
   return Wi ;
 }
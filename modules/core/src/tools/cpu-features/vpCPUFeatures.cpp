@@ -0,0 +1,175 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * CPU features (hardware capabilities) detected at runtime.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpCPUFeatures.cpp
+  \brief CPU features (hardware capabilities) detected at runtime.
+*/
+
+#include <visp3/core/vpCPUFeatures.h>
+
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#  include <intrin.h>
+#  define VISP_CPU_X86 1
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__i386__) || defined(__x86_64__))
+#  include <cpuid.h>
+#  define VISP_CPU_X86 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+
+  struct vpCPUFeaturesInfo
+  {
+    vpCPUFeaturesInfo()
+      : sse2(false), sse3(false), ssse3(false), sse41(false), sse42(false), avx(false), avx2(false), neon(false)
+    {
+#if defined(VISP_CPU_X86)
+      unsigned int regs[4];
+      cpuid(0, 0, regs);
+      unsigned int max_leaf = regs[0];
+
+      if (max_leaf >= 1) {
+        cpuid(1, 0, regs);
+        sse2  = (regs[3] & (1u << 26)) != 0;
+        sse3  = (regs[2] & (1u <<  0)) != 0;
+        ssse3 = (regs[2] & (1u <<  9)) != 0;
+        sse41 = (regs[2] & (1u << 19)) != 0;
+        sse42 = (regs[2] & (1u << 20)) != 0;
+
+        // AVX registers are usable only if the OS saves the YMM state on context switches
+        bool osxsave = (regs[2] & (1u << 27)) != 0;
+        if (osxsave && (regs[2] & (1u << 28)) != 0) {
+          avx = (xgetbv0() & 0x6) == 0x6;
+        }
+      }
+
+      if (avx && max_leaf >= 7) {
+        cpuid(7, 0, regs);
+        avx2 = (regs[1] & (1u << 5)) != 0;
+      }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+      neon = true;
+#endif
+    }
+
+#if defined(VISP_CPU_X86)
+    static void cpuid(unsigned int leaf, unsigned int subleaf, unsigned int regs[4])
+    {
+#  if defined(_MSC_VER)
+      int r[4];
+      __cpuidex(r, (int)leaf, (int)subleaf);
+      for (unsigned int i = 0; i < 4; i++)
+        regs[i] = (unsigned int)r[i];
+#  else
+      __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#  endif
+    }
+
+    static unsigned long long xgetbv0()
+    {
+#  if defined(_MSC_VER)
+#    if (_MSC_FULL_VER >= 160040219) // Visual Studio 2010 SP1
+      return _xgetbv(0);
+#    else
+      return 0;
+#    endif
+#  else
+      unsigned int eax, edx;
+      __asm__ __volatile__ (".byte 0x0f, 0x01, 0xd0" : "=a"(eax), "=d"(edx) : "c"(0)); // xgetbv
+      return ((unsigned long long)edx << 32) | eax;
+#  endif
+    }
+#endif
+
+    bool sse2;
+    bool sse3;
+    bool ssse3;
+    bool sse41;
+    bool sse42;
+    bool avx;
+    bool avx2;
+    bool neon;
+  };
+
+  const vpCPUFeaturesInfo &getCPUFeaturesInfo()
+  {
+    // Function-local static: the detection is done once on first use
+    static const vpCPUFeaturesInfo info;
+    return info;
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Return true if the processor supports SSE2 instructions.
+*/
+bool vpCPUFeatures::checkSSE2() { return getCPUFeaturesInfo().sse2; }
+
+/*!
+  Return true if the processor supports SSE3 instructions.
+*/
+bool vpCPUFeatures::checkSSE3() { return getCPUFeaturesInfo().sse3; }
+
+/*!
+  Return true if the processor supports SSSE3 instructions.
+*/
+bool vpCPUFeatures::checkSSSE3() { return getCPUFeaturesInfo().ssse3; }
+
+/*!
+  Return true if the processor supports SSE4.1 instructions.
+*/
+bool vpCPUFeatures::checkSSE41() { return getCPUFeaturesInfo().sse41; }
+
+/*!
+  Return true if the processor supports SSE4.2 instructions.
+*/
+bool vpCPUFeatures::checkSSE42() { return getCPUFeaturesInfo().sse42; }
+
+/*!
+  Return true if the processor supports AVX instructions and if the
+  operating system saves the extended registers state.
+*/
+bool vpCPUFeatures::checkAVX() { return getCPUFeaturesInfo().avx; }
+
+/*!
+  Return true if the processor supports AVX2 instructions and if the
+  operating system saves the extended registers state.
+*/
+bool vpCPUFeatures::checkAVX2() { return getCPUFeaturesInfo().avx2; }
+
+/*!
+  Return true if ViSP was built with ARM NEON instructions enabled.
+*/
+bool vpCPUFeatures::checkNEON() { return getCPUFeaturesInfo().neon; }
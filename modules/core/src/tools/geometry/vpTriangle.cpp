@@ -46,7 +46,7 @@
 */
 vpTriangle::vpTriangle()
   : goodTriange(true), S1(), uvinv00(0), uvinv01(0), uvinv10(0), uvinv11(0),
-    ptempo0(0), ptempo1(0), area(0), apex1(), apex2(), apex3()
+    area(0), apex1(), apex2(), apex3()
 {
   init (vpImagePoint(0,0),vpImagePoint(1,0),vpImagePoint(0,1));
 }
@@ -60,7 +60,7 @@ vpTriangle::vpTriangle()
 */
 vpTriangle::vpTriangle(const vpImagePoint &iP1, const vpImagePoint &iP2, const vpImagePoint &iP3)
   : goodTriange(true), S1(), uvinv00(0), uvinv01(0), uvinv10(0), uvinv11(0),
-    ptempo0(0), ptempo1(0), area(0), apex1(), apex2(), apex3()
+    area(0), apex1(), apex2(), apex3()
 {
   init(iP1,iP2,iP3);
 }
@@ -72,7 +72,7 @@ vpTriangle::vpTriangle(const vpImagePoint &iP1, const vpImagePoint &iP2, const v
 */
 vpTriangle::vpTriangle(const vpTriangle &tri)
   : goodTriange(true), S1(), uvinv00(0), uvinv01(0), uvinv10(0), uvinv11(0),
-    ptempo0(0), ptempo1(0), area(0), apex1(), apex2(), apex3()
+    area(0), apex1(), apex2(), apex3()
 {
   *this = tri;
 }
@@ -96,9 +96,10 @@ vpTriangle::operator=(const vpTriangle& tri)
   uvinv01 = tri.uvinv01;
   uvinv10 = tri.uvinv10;
   uvinv11 = tri.uvinv11;
-  ptempo0 = tri.ptempo0;
-  ptempo1 = tri.ptempo1;
   area = tri.area;
+  apex1 = tri.apex1;
+  apex2 = tri.apex2;
+  apex3 = tri.apex3;
   return *this;
 };
 
@@ -119,7 +120,6 @@ vpTriangle::buildFrom(const vpImagePoint &iP1, const vpImagePoint &iP2, const vp
 void
 vpTriangle::init(const vpImagePoint &iP1, const vpImagePoint &iP2, const vpImagePoint &iP3)
 {
-  ptempo0 = ptempo1 = 0.;
   apex1 = iP1;
   apex2 = iP2;
   apex3 = iP3;
@@ -160,7 +160,7 @@ vpTriangle::init(const vpImagePoint &iP1, const vpImagePoint &iP2, const vpImage
   \return Returns true if the point is inside the triangle. Returns false otherwise.
 */
 bool
-vpTriangle::inTriangle(const vpImagePoint &iP, double threshold)
+vpTriangle::inTriangle(const vpImagePoint &iP, double threshold) const
 {
   if(!goodTriange)
     return false;
@@ -168,8 +168,8 @@ vpTriangle::inTriangle(const vpImagePoint &iP, double threshold)
   if(threshold < 0)
     threshold = 0;
   
-  ptempo0 = iP.get_i() - S1.get_i();
-  ptempo1 = iP.get_j() - S1.get_j();
+  double ptempo0 = iP.get_i() - S1.get_i();
+  double ptempo1 = iP.get_j() - S1.get_j();
   
   double p_ds_uv0=ptempo0*uvinv00+ptempo1*uvinv10;
   double p_ds_uv1=ptempo0*uvinv01+ptempo1*uvinv11;
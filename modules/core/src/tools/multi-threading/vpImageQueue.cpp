@@ -0,0 +1,129 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Atomic index of the lock-free image queue.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpImageQueue.cpp
+  \brief Atomic index of the lock-free image queue.
+*/
+
+#include <visp3/core/vpImageQueue.h>
+
+#if defined(_WIN32)
+#  include <windows.h>
+#elif !defined(__GNUC__) && defined(VISP_HAVE_PTHREAD)
+#  include <visp3/core/vpMutex.h>
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#if defined(_WIN32)
+// The Interlocked functions are full memory barriers
+unsigned int vpImageQueueIndex::load() const
+{
+  return (unsigned int)InterlockedCompareExchange(const_cast<volatile long *>(&m_value), 0, 0);
+}
+
+void vpImageQueueIndex::store(unsigned int value)
+{
+  InterlockedExchange(&m_value, (long)value);
+}
+
+bool vpImageQueueIndex::compareAndSwap(unsigned int expected, unsigned int value)
+{
+  return InterlockedCompareExchange(&m_value, (long)value, (long)expected) == (long)expected;
+}
+
+#elif defined(__GNUC__)
+// GCC, Clang and ICC builtins, that are full memory barriers
+unsigned int vpImageQueueIndex::load() const
+{
+  __sync_synchronize();
+  unsigned int value = (unsigned int)m_value;
+  __sync_synchronize();
+  return value;
+}
+
+void vpImageQueueIndex::store(unsigned int value)
+{
+  __sync_synchronize();
+  m_value = (long)value;
+  __sync_synchronize();
+}
+
+bool vpImageQueueIndex::compareAndSwap(unsigned int expected, unsigned int value)
+{
+  return __sync_bool_compare_and_swap(&m_value, (long)expected, (long)value);
+}
+
+#else
+// Without atomic operations, a lock gives the same guarantees
+namespace {
+#if defined(VISP_HAVE_PTHREAD)
+  vpMutex &indexMutex()
+  {
+    static vpMutex mutex;
+    return mutex;
+  }
+#endif
+}
+
+unsigned int vpImageQueueIndex::load() const
+{
+#if defined(VISP_HAVE_PTHREAD)
+  vpMutex::vpScopedLock lock(indexMutex());
+#endif
+  return (unsigned int)m_value;
+}
+
+void vpImageQueueIndex::store(unsigned int value)
+{
+#if defined(VISP_HAVE_PTHREAD)
+  vpMutex::vpScopedLock lock(indexMutex());
+#endif
+  m_value = (long)value;
+}
+
+bool vpImageQueueIndex::compareAndSwap(unsigned int expected, unsigned int value)
+{
+#if defined(VISP_HAVE_PTHREAD)
+  vpMutex::vpScopedLock lock(indexMutex());
+#endif
+  if ((unsigned int)m_value != expected)
+    return false;
+  m_value = (long)value;
+  return true;
+}
+#endif
+
+#endif
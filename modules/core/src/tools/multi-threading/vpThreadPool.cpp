@@ -0,0 +1,408 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Pool of worker threads shared by the image processing functions.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpThreadPool.cpp
+  \brief Pool of worker threads shared by the image processing functions.
+*/
+
+#include <vector>
+
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpThreadPool.h>
+
+#if defined(VISP_HAVE_PTHREAD)
+#  include <pthread.h>
+#  include <unistd.h>
+#elif defined(_WIN32)
+#  include <windows.h>
+#endif
+
+#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
+#  define VISP_THREAD_POOL_ENABLED
+#endif
+
+namespace {
+
+#ifdef VISP_THREAD_POOL_ENABLED
+
+#if defined(VISP_HAVE_PTHREAD)
+typedef pthread_mutex_t vpPoolMutex;
+typedef pthread_cond_t vpPoolCondition;
+typedef pthread_t vpPoolThread;
+
+void poolMutexInit(vpPoolMutex &m)                           { pthread_mutex_init(&m, NULL); }
+void poolMutexDestroy(vpPoolMutex &m)                        { pthread_mutex_destroy(&m); }
+void poolMutexLock(vpPoolMutex &m)                           { pthread_mutex_lock(&m); }
+bool poolMutexTryLock(vpPoolMutex &m)                        { return pthread_mutex_trylock(&m) == 0; }
+void poolMutexUnlock(vpPoolMutex &m)                         { pthread_mutex_unlock(&m); }
+void poolConditionInit(vpPoolCondition &c)                   { pthread_cond_init(&c, NULL); }
+void poolConditionDestroy(vpPoolCondition &c)                { pthread_cond_destroy(&c); }
+void poolConditionWait(vpPoolCondition &c, vpPoolMutex &m)   { pthread_cond_wait(&c, &m); }
+void poolConditionBroadcast(vpPoolCondition &c)              { pthread_cond_broadcast(&c); }
+#else
+typedef CRITICAL_SECTION vpPoolMutex;
+typedef CONDITION_VARIABLE vpPoolCondition;
+typedef HANDLE vpPoolThread;
+
+void poolMutexInit(vpPoolMutex &m)                           { InitializeCriticalSection(&m); }
+void poolMutexDestroy(vpPoolMutex &m)                        { DeleteCriticalSection(&m); }
+void poolMutexLock(vpPoolMutex &m)                           { EnterCriticalSection(&m); }
+bool poolMutexTryLock(vpPoolMutex &m)                        { return TryEnterCriticalSection(&m) != 0; }
+void poolMutexUnlock(vpPoolMutex &m)                         { LeaveCriticalSection(&m); }
+void poolConditionInit(vpPoolCondition &c)                   { InitializeConditionVariable(&c); }
+void poolConditionDestroy(vpPoolCondition &)                 { }
+void poolConditionWait(vpPoolCondition &c, vpPoolMutex &m)   { SleepConditionVariableCS(&c, &m, INFINITE); }
+void poolConditionBroadcast(vpPoolCondition &c)              { WakeAllConditionVariable(&c); }
+#endif
+
+/*!
+  Worker threads waiting for a loop to process. A loop is split into bands
+  that are taken one after the other by the workers and by the thread that
+  submitted the loop.
+ */
+class vpThreadPoolImpl
+{
+public:
+  vpThreadPoolImpl()
+    : m_nthreads(vpThreadPool::getNumCores()), m_workers(), m_mutex(), m_submit(), m_wakeUp(), m_done(),
+      m_generation(0), m_stop(false), m_task(NULL), m_arg(NULL), m_begin(0), m_end(0), m_nbands(0),
+      m_nextBand(0), m_nbandsDone(0), m_failed(false),
+      m_exception(vpException::fatalError, "")
+  {
+    poolMutexInit(m_mutex);
+    poolMutexInit(m_submit);
+    poolConditionInit(m_wakeUp);
+    poolConditionInit(m_done);
+  }
+
+  ~vpThreadPoolImpl()
+  {
+    stopWorkers();
+    poolConditionDestroy(m_done);
+    poolConditionDestroy(m_wakeUp);
+    poolMutexDestroy(m_submit);
+    poolMutexDestroy(m_mutex);
+  }
+
+  static vpThreadPoolImpl &instance()
+  {
+    static vpThreadPoolImpl pool;
+    return pool;
+  }
+
+  unsigned int getNumThreads() const
+  {
+    return m_nthreads;
+  }
+
+  void setNumThreads(unsigned int nthreads)
+  {
+    // Wait for the loop in progress, if any
+    poolMutexLock(m_submit);
+    if (nthreads < m_nthreads) {
+      stopWorkers();
+    }
+    m_nthreads = nthreads;
+    poolMutexUnlock(m_submit);
+  }
+
+  void parallelFor(unsigned int begin, unsigned int end, vpThreadPool::Task task, void *arg,
+                   unsigned int min_band_size)
+  {
+    unsigned int n = end - begin;
+    unsigned int nbands = n / min_band_size + (n % min_band_size != 0 ? 1 : 0);
+    if (nbands > m_nthreads)
+      nbands = m_nthreads;
+
+    // Nested calls and concurrent calls from other threads are processed
+    // sequentially instead of waiting for the pool
+    if (nbands < 2 || !poolMutexTryLock(m_submit)) {
+      task(begin, end, arg);
+      return;
+    }
+
+    try {
+      startWorkers(m_nthreads - 1);
+    }
+    catch(...) {
+      poolMutexUnlock(m_submit);
+      throw;
+    }
+
+    poolMutexLock(m_mutex);
+    m_task = task;
+    m_arg = arg;
+    m_begin = begin;
+    m_end = end;
+    m_nbands = nbands;
+    m_nextBand = 0;
+    m_nbandsDone = 0;
+    m_failed = false;
+    m_generation++;
+    poolConditionBroadcast(m_wakeUp);
+
+    processBands();
+    while (m_nbandsDone < m_nbands) {
+      poolConditionWait(m_done, m_mutex);
+    }
+    bool failed = m_failed;
+    vpException exception = m_exception;
+    m_task = NULL;
+    poolMutexUnlock(m_mutex);
+    poolMutexUnlock(m_submit);
+
+    if (failed)
+      throw exception;
+  }
+
+private:
+  // The first bands hold one more index than the last ones when the size of
+  // the range is not a multiple of the number of bands
+  unsigned int bandBegin(unsigned int band) const
+  {
+    unsigned int n = m_end - m_begin;
+    unsigned int q = n / m_nbands, r = n % m_nbands;
+    return m_begin + band * q + (band < r ? band : r);
+  }
+
+  // Takes the bands that remain to process. Has to be called with m_mutex locked.
+  void processBands()
+  {
+    while (m_nextBand < m_nbands) {
+      unsigned int band = m_nextBand++;
+      unsigned int band_begin = bandBegin(band);
+      unsigned int band_end = bandBegin(band + 1);
+      vpThreadPool::Task task = m_task;
+      void *arg = m_arg;
+
+      poolMutexUnlock(m_mutex);
+      bool failed = false;
+      vpException exception(vpException::fatalError, "Unknown exception thrown by a vpThreadPool task");
+      try {
+        task(band_begin, band_end, arg);
+      }
+      catch(const vpException &e) {
+        failed = true;
+        exception = e;
+      }
+      catch(...) {
+        failed = true;
+      }
+      poolMutexLock(m_mutex);
+
+      if (failed && !m_failed) {
+        m_failed = true;
+        m_exception = exception;
+      }
+      if (++m_nbandsDone == m_nbands) {
+        poolConditionBroadcast(m_done);
+      }
+    }
+  }
+
+  void workerLoop()
+  {
+    poolMutexLock(m_mutex);
+    unsigned long generation = m_generation;
+    while (true) {
+      while (!m_stop && m_generation == generation) {
+        poolConditionWait(m_wakeUp, m_mutex);
+      }
+      if (m_stop)
+        break;
+      generation = m_generation;
+      processBands();
+    }
+    poolMutexUnlock(m_mutex);
+  }
+
+#if defined(VISP_HAVE_PTHREAD)
+  static void *workerEntry(void *arg)
+  {
+    static_cast<vpThreadPoolImpl *>(arg)->workerLoop();
+    return NULL;
+  }
+#else
+  static DWORD WINAPI workerEntry(LPVOID arg)
+  {
+    static_cast<vpThreadPoolImpl *>(arg)->workerLoop();
+    return 0;
+  }
+#endif
+
+  // Has to be called with m_submit locked
+  void startWorkers(unsigned int nworkers)
+  {
+    while (m_workers.size() < nworkers) {
+      vpPoolThread thread;
+#if defined(VISP_HAVE_PTHREAD)
+      if (pthread_create(&thread, NULL, &vpThreadPoolImpl::workerEntry, this) != 0) {
+        throw vpException(vpException::fatalError, "Cannot create the threads of the pool");
+      }
+#else
+      thread = CreateThread(NULL, 0, &vpThreadPoolImpl::workerEntry, this, 0, NULL);
+      if (thread == NULL) {
+        throw vpException(vpException::fatalError, "Cannot create the threads of the pool");
+      }
+#endif
+      m_workers.push_back(thread);
+    }
+  }
+
+  // Has to be called with m_submit locked, or when no loop can be submitted
+  void stopWorkers()
+  {
+    poolMutexLock(m_mutex);
+    m_stop = true;
+    poolConditionBroadcast(m_wakeUp);
+    poolMutexUnlock(m_mutex);
+
+    for (size_t i = 0; i < m_workers.size(); i++) {
+#if defined(VISP_HAVE_PTHREAD)
+      pthread_join(m_workers[i], NULL);
+#else
+      WaitForSingleObject(m_workers[i], INFINITE);
+      CloseHandle(m_workers[i]);
+#endif
+    }
+    m_workers.clear();
+    m_stop = false;
+  }
+
+  vpThreadPoolImpl(const vpThreadPoolImpl &);
+  vpThreadPoolImpl &operator=(const vpThreadPoolImpl &);
+
+  unsigned int m_nthreads; // Number of threads including the calling one
+  std::vector<vpPoolThread> m_workers;
+  vpPoolMutex m_mutex;  // Protects the loop in progress
+  vpPoolMutex m_submit; // Held by the thread that submitted the loop in progress
+  vpPoolCondition m_wakeUp;
+  vpPoolCondition m_done;
+  unsigned long m_generation; // Incremented for each new loop
+  bool m_stop;
+
+  // Loop in progress
+  vpThreadPool::Task m_task;
+  void *m_arg;
+  unsigned int m_begin;
+  unsigned int m_end;
+  unsigned int m_nbands;
+  unsigned int m_nextBand;
+  unsigned int m_nbandsDone;
+  bool m_failed;
+  vpException m_exception;
+};
+
+#endif // VISP_THREAD_POOL_ENABLED
+
+}
+
+/*!
+  Return the number of cores of the machine, or 1 if it cannot be retrieved.
+ */
+unsigned int vpThreadPool::getNumCores()
+{
+#if defined(_WIN32)
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwNumberOfProcessors > 0 ? (unsigned int)info.dwNumberOfProcessors : 1;
+#elif defined(_SC_NPROCESSORS_ONLN)
+  long ncores = sysconf(_SC_NPROCESSORS_ONLN);
+  return ncores > 0 ? (unsigned int)ncores : 1;
+#else
+  return 1;
+#endif
+}
+
+/*!
+  Return the number of threads used to process a loop, including the calling
+  thread.
+
+  \sa setNumThreads()
+ */
+unsigned int vpThreadPool::getNumThreads()
+{
+#ifdef VISP_THREAD_POOL_ENABLED
+  return vpThreadPoolImpl::instance().getNumThreads();
+#else
+  return 1;
+#endif
+}
+
+/*!
+  Set the number of threads used to process a loop, including the calling
+  thread. This setting is global to all the functions that rely on the pool.
+
+  \param nthreads : Number of threads. 0 means the number of cores of the
+  machine (the default), 1 disables multi-threading.
+
+  \sa getNumThreads()
+ */
+void vpThreadPool::setNumThreads(unsigned int nthreads)
+{
+#ifdef VISP_THREAD_POOL_ENABLED
+  vpThreadPoolImpl::instance().setNumThreads(nthreads == 0 ? getNumCores() : nthreads);
+#else
+  (void)nthreads;
+#endif
+}
+
+/*!
+  Split [\e begin, \e end) into contiguous bands and call \e task on each of
+  them, in parallel. The function returns when all the bands are processed.
+
+  \param begin, end : Range of indexes to process.
+  \param task : Function processing a band.
+  \param arg : Argument passed to \e task.
+  \param min_band_size : Minimum number of indexes per band. It prevents small
+  loops to be split in bands that cost more to dispatch than to process.
+
+  \exception vpException : If a task throws an exception, the first one that
+  is caught is thrown again once all the bands are processed.
+ */
+void vpThreadPool::parallelFor(unsigned int begin, unsigned int end, vpThreadPool::Task task, void *arg,
+                               unsigned int min_band_size)
+{
+  if (end <= begin)
+    return;
+  if (min_band_size == 0)
+    min_band_size = 1;
+
+#ifdef VISP_THREAD_POOL_ENABLED
+  vpThreadPoolImpl::instance().parallelFor(begin, end, task, arg, min_band_size);
+#else
+  task(begin, end, arg);
+#endif
+}
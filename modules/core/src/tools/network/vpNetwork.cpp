@@ -36,13 +36,40 @@
  *****************************************************************************/
 
 
+#include <algorithm>
+
 #include <visp3/core/vpNetwork.h>
 
+#if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
+#  include <errno.h>
+#  include <sys/uio.h>
+#endif
+#if defined(__linux__)
+#  include <poll.h>
+#  include <sys/epoll.h>
+#  define VISP_NETWORK_HAVE_EPOLL
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  // Header of the binary messages: magic number, type, number of rows and
+  // columns, and length of the payload, all in network byte order.
+  const unsigned int messageMagic = 0x7650424d;
+  const unsigned int messageHeaderSize = 5;
+
+  enum {
+    MESSAGE_IMAGE_GRAY = 1,
+    MESSAGE_IMAGE_RGBA = 2,
+    MESSAGE_MATRIX = 3
+  };
+}
+#endif
+
 vpNetwork::vpNetwork()
-  : emitter(), receptor_list(), readFileDescriptor(), socketMax(0), request_list(),
+  : emitter(), receptor_list(), readFileDescriptor(), socketMax(0), epollFileDescriptor(-1), request_list(),
     max_size_message(999999), separator("[*@*]"), beginning("[*start*]"), end("[*end*]"),
     param_sep("[*|*]"), currentMessageReceived(), tv(), tv_sec(0), tv_usec(10),
-    verboseMode(false)
+    verboseMode(false), receiveBuffer()
 { 
   tv.tv_sec = tv_sec;
   tv.tv_usec = tv_usec;
@@ -54,6 +81,12 @@ vpNetwork::vpNetwork()
   WSADATA WSAData;
   WSAStartup(MAKEWORD(2,0), &WSAData);
 #endif
+
+#if defined(VISP_NETWORK_HAVE_EPOLL)
+  epollFileDescriptor = epoll_create(1);
+  if (epollFileDescriptor < 0)
+    vpERROR_TRACE( "vpNetwork::vpNetwork(), cannot create the epoll instance." );
+#endif
 }
 
 vpNetwork::~vpNetwork()
@@ -61,6 +94,155 @@ vpNetwork::~vpNetwork()
 #if defined(_WIN32)
   WSACleanup();
 #endif
+#if defined(VISP_NETWORK_HAVE_EPOLL)
+  if (epollFileDescriptor >= 0)
+    close(epollFileDescriptor);
+#endif
+}
+
+/*!
+  Add a receptor to the list of the receptors and watch its socket.
+
+  \param rec : Connected receptor.
+*/
+void vpNetwork::_addReceptor(const vpReceptor &rec)
+{
+  receptor_list.push_back(rec);
+#if defined(VISP_NETWORK_HAVE_EPOLL)
+  struct epoll_event event;
+  memset(&event, 0, sizeof(event));
+  event.events = EPOLLIN;
+  event.data.fd = rec.socketFileDescriptorReceptor;
+  if (epoll_ctl(epollFileDescriptor, EPOLL_CTL_ADD, rec.socketFileDescriptorReceptor, &event) < 0 && verboseMode)
+    vpERROR_TRACE( "Cannot watch the socket of the receptor" );
+#endif
+}
+
+/*!
+  Remove a receptor from the list of the receptors. Its socket isn't closed.
+
+  \param index : Index of the receptor.
+*/
+void vpNetwork::_removeReceptor(const unsigned int &index)
+{
+#if defined(VISP_NETWORK_HAVE_EPOLL)
+  // Fails harmlessly if the socket is already closed
+  struct epoll_event event;
+  epoll_ctl(epollFileDescriptor, EPOLL_CTL_DEL, receptor_list[index].socketFileDescriptorReceptor, &event);
+#endif
+  receptor_list.erase(receptor_list.begin()+(int)index);
+}
+
+/*!
+  Wait for data on the sockets of the receptors, at most for the time set by
+  setTimeoutSec() and setTimeoutUSec(). Under Linux, the sockets are watched
+  with epoll whose resolution is the millisecond: a timeout under 1 ms only
+  checks the sockets without waiting.
+
+  \param readyReceptors : Indexes of the receptors that have data to read or
+  that were disconnected, in increasing order.
+  \param receptorIndex : Index of the only receptor to watch, or -1 to watch
+  all the receptors.
+  \param emitterReady : If not NULL, the socket of the emitter is also watched
+  for incoming connections, and \e emitterReady is set to true if there is one.
+
+  \return The number of sockets ready, 0 if the timeout expired, -1 if an
+  error occured.
+*/
+int vpNetwork::_waitForData(std::vector<unsigned int> &readyReceptors, const int &receptorIndex, bool *emitterReady)
+{
+  readyReceptors.clear();
+  if (emitterReady != NULL)
+    *emitterReady = false;
+
+#if defined(VISP_NETWORK_HAVE_EPOLL)
+  int timeout = (int)(tv_sec * 1000 + tv_usec / 1000);
+
+  if (receptorIndex >= 0 || emitterReady != NULL) {
+    // One receptor, or the epoll instance (readable when one of the receptors
+    // is) with the emitter
+    struct pollfd fds[2];
+    nfds_t nb = 0;
+    if (emitterReady != NULL) {
+      fds[nb].fd = emitter.socketFileDescriptorEmitter;
+      fds[nb].events = POLLIN;
+      fds[nb].revents = 0;
+      nb++;
+    }
+    fds[nb].fd = (receptorIndex >= 0) ? receptor_list[(unsigned int)receptorIndex].socketFileDescriptorReceptor
+                                      : epollFileDescriptor;
+    fds[nb].events = POLLIN;
+    fds[nb].revents = 0;
+    nb++;
+
+    int value = poll(fds, nb, timeout);
+    if (value <= 0)
+      return value;
+    if (emitterReady != NULL && fds[0].revents != 0)
+      *emitterReady = true;
+    if (fds[nb-1].revents == 0)
+      return value;
+    if (receptorIndex >= 0) {
+      readyReceptors.push_back((unsigned int)receptorIndex);
+      return value;
+    }
+    timeout = 0;
+  }
+
+  std::vector<struct epoll_event> events(std::max<size_t>(receptor_list.size(), 1));
+  int nbEvents = epoll_wait(epollFileDescriptor, &events[0], (int)events.size(), timeout);
+  if (nbEvents < 0)
+    return -1;
+
+  for (int e = 0; e < nbEvents; e++) {
+    for (unsigned int i = 0; i < receptor_list.size(); i++) {
+      if (receptor_list[i].socketFileDescriptorReceptor == events[(size_t)e].data.fd) {
+        readyReceptors.push_back(i);
+        break;
+      }
+    }
+  }
+  std::sort(readyReceptors.begin(), readyReceptors.end());
+
+  int value = (int)readyReceptors.size();
+  if (emitterReady != NULL && *emitterReady)
+    value++;
+  return value;
+#else
+  tv.tv_sec = tv_sec;
+  tv.tv_usec = tv_usec;
+
+  FD_ZERO(&readFileDescriptor);
+
+  bool first = true;
+  if (emitterReady != NULL) {
+    socketMax = emitter.socketFileDescriptorEmitter;
+    FD_SET((unsigned int)emitter.socketFileDescriptorEmitter,&readFileDescriptor);
+    first = false;
+  }
+  for (unsigned int i = 0; i < receptor_list.size(); i++) {
+    if (receptorIndex >= 0 && i != (unsigned int)receptorIndex)
+      continue;
+    FD_SET((unsigned int)receptor_list[i].socketFileDescriptorReceptor,&readFileDescriptor);
+    if (first || socketMax < receptor_list[i].socketFileDescriptorReceptor)
+      socketMax = receptor_list[i].socketFileDescriptorReceptor;
+    first = false;
+  }
+
+  int value = select((int)socketMax+1,&readFileDescriptor,NULL,NULL,&tv);
+  if (value <= 0)
+    return value;
+
+  if (emitterReady != NULL && FD_ISSET((unsigned int)emitter.socketFileDescriptorEmitter,&readFileDescriptor))
+    *emitterReady = true;
+  for (unsigned int i = 0; i < receptor_list.size(); i++) {
+    if (receptorIndex >= 0 && i != (unsigned int)receptorIndex)
+      continue;
+    if (FD_ISSET((unsigned int)receptor_list[i].socketFileDescriptorReceptor,&readFileDescriptor))
+      readyReceptors.push_back(i);
+  }
+  return value;
+#endif
 }
 
 /*!
@@ -654,20 +836,8 @@ int vpNetwork::_receiveRequestOnce()
     return -1;
   }
   
-  tv.tv_sec = tv_sec;
-  tv.tv_usec = tv_usec;
-  
-  FD_ZERO(&readFileDescriptor);        
-  
-  for(unsigned int i=0; i<receptor_list.size(); i++){ 
-    if(i == 0)
-      socketMax = receptor_list[i].socketFileDescriptorReceptor;
-    
-    FD_SET((unsigned)receptor_list[i].socketFileDescriptorReceptor,&readFileDescriptor); 
-    if(socketMax < receptor_list[i].socketFileDescriptorReceptor) socketMax = receptor_list[i].socketFileDescriptorReceptor; 
-  }
-
-  int value = select((int)socketMax+1,&readFileDescriptor,NULL,NULL,&tv);
+  std::vector<unsigned int> ready;
+  int value = _waitForData(ready);
   int numbytes = 0;
   
   if(value == -1){
@@ -680,30 +850,21 @@ int vpNetwork::_receiveRequestOnce()
     return 0;
   }
   else{
-    for(unsigned int i=0; i<receptor_list.size(); i++){
-      if(FD_ISSET((unsigned int)receptor_list[i].socketFileDescriptorReceptor,&readFileDescriptor)){
-        char *buf = new char [max_size_message];
+    unsigned int i = ready[0];
+    receiveBuffer.resize(max_size_message);
 #if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
-        numbytes=recv(receptor_list[i].socketFileDescriptorReceptor, buf, max_size_message, 0);
+    numbytes=recv(receptor_list[i].socketFileDescriptorReceptor, &receiveBuffer[0], max_size_message, 0);
 #else
-        numbytes=recv((unsigned int)receptor_list[i].socketFileDescriptorReceptor, buf, (int)max_size_message, 0);
+    numbytes=recv((unsigned int)receptor_list[i].socketFileDescriptorReceptor, &receiveBuffer[0], (int)max_size_message, 0);
 #endif
-          
-        if(numbytes <= 0)
-        {
-          std::cout << "Disconnected : " << inet_ntoa(receptor_list[i].receptorAddress.sin_addr) << std::endl;
-          receptor_list.erase(receptor_list.begin()+(int)i);
-          delete [] buf;
-          return numbytes;
-        }
-        else if(numbytes > 0){
-          std::string returnVal(buf, (unsigned int)numbytes);
-          currentMessageReceived.append(returnVal);
-        }
-        delete [] buf;
-        break;
-      }
+      
+    if(numbytes <= 0)
+    {
+      std::cout << "Disconnected : " << inet_ntoa(receptor_list[i].receptorAddress.sin_addr) << std::endl;
+      _removeReceptor(i);
+      return numbytes;
     }
+    currentMessageReceived.append(&receiveBuffer[0], (unsigned int)numbytes);
   }
   
   return numbytes;
@@ -740,15 +901,8 @@ int vpNetwork::_receiveRequestOnceFrom(const unsigned int &receptorEmitting)
     return -1;
   }
   
-  tv.tv_sec = tv_sec;
-  tv.tv_usec = tv_usec;
-  
-  FD_ZERO(&readFileDescriptor);        
-  
-  socketMax = receptor_list[receptorEmitting].socketFileDescriptorReceptor;
-  FD_SET((unsigned int)receptor_list[receptorEmitting].socketFileDescriptorReceptor,&readFileDescriptor);
-
-  int value = select((int)socketMax+1,&readFileDescriptor,NULL,NULL,&tv);
+  std::vector<unsigned int> ready;
+  int value = _waitForData(ready, (int)receptorEmitting);
   int numbytes = 0;
   if(value == -1){
     if(verboseMode)
@@ -760,26 +914,19 @@ int vpNetwork::_receiveRequestOnceFrom(const unsigned int &receptorEmitting)
     return 0;
   }
   else{
-    if(FD_ISSET((unsigned int)receptor_list[receptorEmitting].socketFileDescriptorReceptor,&readFileDescriptor)){
-      char *buf = new char [max_size_message];
+    receiveBuffer.resize(max_size_message);
 #if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
-      numbytes=recv(receptor_list[receptorEmitting].socketFileDescriptorReceptor, buf, max_size_message, 0);
+    numbytes=recv(receptor_list[receptorEmitting].socketFileDescriptorReceptor, &receiveBuffer[0], max_size_message, 0);
 #else
-      numbytes=recv((unsigned int)receptor_list[receptorEmitting].socketFileDescriptorReceptor, buf, (int)max_size_message, 0);
+    numbytes=recv((unsigned int)receptor_list[receptorEmitting].socketFileDescriptorReceptor, &receiveBuffer[0], (int)max_size_message, 0);
 #endif
-      if(numbytes <= 0)
-      {
-        std::cout << "Disconnected : " << inet_ntoa(receptor_list[receptorEmitting].receptorAddress.sin_addr) << std::endl;
-        receptor_list.erase(receptor_list.begin()+(int)receptorEmitting);
-        delete [] buf;
-        return numbytes;
-      }
-      else if(numbytes > 0){
-        std::string returnVal(buf, (unsigned int)numbytes);
-        currentMessageReceived.append(returnVal);
-      }
-      delete [] buf;
+    if(numbytes <= 0)
+    {
+      std::cout << "Disconnected : " << inet_ntoa(receptor_list[receptorEmitting].receptorAddress.sin_addr) << std::endl;
+      _removeReceptor(receptorEmitting);
+      return numbytes;
     }
+    currentMessageReceived.append(&receiveBuffer[0], (unsigned int)numbytes);
   }
   
   return numbytes;
@@ -787,3 +934,451 @@ int vpNetwork::_receiveRequestOnceFrom(const unsigned int &receptorEmitting)
 
 
 
+
+/*!
+  Send a grey level image to the first receptor in the list, as a binary
+  message.
+
+  \sa vpNetwork::sendImageTo()
+  \sa vpNetwork::receiveImage()
+
+  \param I : Image to send.
+
+  \return The number of bytes sent, or -1 if an error happened.
+*/
+int vpNetwork::sendImage(const vpImage<unsigned char> &I)
+{
+  return sendImageTo(I, 0);
+}
+
+/*!
+  Send a color image to the first receptor in the list, as a binary message.
+
+  \sa vpNetwork::sendImageTo()
+  \sa vpNetwork::receiveImage()
+
+  \param I : Image to send.
+
+  \return The number of bytes sent, or -1 if an error happened.
+*/
+int vpNetwork::sendImage(const vpImage<vpRGBa> &I)
+{
+  return sendImageTo(I, 0);
+}
+
+/*!
+  Send a grey level image to a specific receptor, as a binary message. The
+  header of the message and the pixels are sent in a single system call,
+  without copy.
+
+  \sa vpNetwork::sendImage()
+  \sa vpNetwork::receiveImageFrom()
+
+  \param I : Image to send.
+  \param dest : Index of the receptor receiving the image.
+
+  \return The number of bytes sent, or -1 if an error happened.
+*/
+int vpNetwork::sendImageTo(const vpImage<unsigned char> &I, const unsigned int &dest)
+{
+  return _sendMessageTo(MESSAGE_IMAGE_GRAY, I.getHeight(), I.getWidth(), (const char*)(const void*)I.bitmap,
+                        I.getSize() * sizeof(unsigned char), dest);
+}
+
+/*!
+  Send a color image to a specific receptor, as a binary message. The header
+  of the message and the pixels are sent in a single system call, without
+  copy.
+
+  \sa vpNetwork::sendImage()
+  \sa vpNetwork::receiveImageFrom()
+
+  \param I : Image to send.
+  \param dest : Index of the receptor receiving the image.
+
+  \return The number of bytes sent, or -1 if an error happened.
+*/
+int vpNetwork::sendImageTo(const vpImage<vpRGBa> &I, const unsigned int &dest)
+{
+  return _sendMessageTo(MESSAGE_IMAGE_RGBA, I.getHeight(), I.getWidth(), (const char*)(const void*)I.bitmap,
+                        I.getSize() * sizeof(vpRGBa), dest);
+}
+
+/*!
+  Send a matrix, a homogeneous matrix or a vector to the first receptor in the
+  list, as a binary message.
+
+  \sa vpNetwork::sendMatrixTo()
+  \sa vpNetwork::receiveMatrix()
+
+  \param M : Matrix to send.
+
+  \return The number of bytes sent, or -1 if an error happened.
+*/
+int vpNetwork::sendMatrix(const vpArray2D<double> &M)
+{
+  return sendMatrixTo(M, 0);
+}
+
+/*!
+  Send a matrix, a homogeneous matrix or a vector to a specific receptor, as a
+  binary message. The header of the message and the elements are sent in a
+  single system call, without copy. The elements are sent in the byte order of
+  the sender.
+
+  \sa vpNetwork::sendMatrix()
+  \sa vpNetwork::receiveMatrixFrom()
+
+  \param M : Matrix to send.
+  \param dest : Index of the receptor receiving the matrix.
+
+  \return The number of bytes sent, or -1 if an error happened.
+*/
+int vpNetwork::sendMatrixTo(const vpArray2D<double> &M, const unsigned int &dest)
+{
+  return _sendMessageTo(MESSAGE_MATRIX, M.getRows(), M.getCols(), (const char*)(const void*)M.data,
+                        M.size() * sizeof(double), dest);
+}
+
+/*!
+  Receive a grey level image sent by sendImage() or sendImageTo(), from the
+  first receptor that has data to read. The image is resized if needed and the
+  pixels are received directly in it.
+
+  \sa vpNetwork::receiveImageFrom()
+
+  \param I : Received image.
+
+  \return The number of bytes received, 0 if the timeout expired or if the
+  receptor disconnected, -1 if an error occured or if the next message is not a
+  grey level image.
+*/
+int vpNetwork::receiveImage(vpImage<unsigned char> &I)
+{
+  return _receiveImage(I, -1, MESSAGE_IMAGE_GRAY);
+}
+
+/*!
+  Receive a color image sent by sendImage() or sendImageTo(), from the first
+  receptor that has data to read. The image is resized if needed and the
+  pixels are received directly in it.
+
+  \sa vpNetwork::receiveImageFrom()
+
+  \param I : Received image.
+
+  \return The number of bytes received, 0 if the timeout expired or if the
+  receptor disconnected, -1 if an error occured or if the next message is not a
+  color image.
+*/
+int vpNetwork::receiveImage(vpImage<vpRGBa> &I)
+{
+  return _receiveImage(I, -1, MESSAGE_IMAGE_RGBA);
+}
+
+/*!
+  Receive a grey level image sent by sendImage() or sendImageTo(), from a
+  specific receptor.
+
+  \sa vpNetwork::receiveImage()
+
+  \param I : Received image.
+  \param receptorEmitting : Index of the receptor emitting the image.
+
+  \return The number of bytes received, 0 if the timeout expired or if the
+  receptor disconnected, -1 if an error occured or if the next message is not a
+  grey level image.
+*/
+int vpNetwork::receiveImageFrom(vpImage<unsigned char> &I, const unsigned int &receptorEmitting)
+{
+  return _receiveImage(I, (int)receptorEmitting, MESSAGE_IMAGE_GRAY);
+}
+
+/*!
+  Receive a color image sent by sendImage() or sendImageTo(), from a specific
+  receptor.
+
+  \sa vpNetwork::receiveImage()
+
+  \param I : Received image.
+  \param receptorEmitting : Index of the receptor emitting the image.
+
+  \return The number of bytes received, 0 if the timeout expired or if the
+  receptor disconnected, -1 if an error occured or if the next message is not a
+  color image.
+*/
+int vpNetwork::receiveImageFrom(vpImage<vpRGBa> &I, const unsigned int &receptorEmitting)
+{
+  return _receiveImage(I, (int)receptorEmitting, MESSAGE_IMAGE_RGBA);
+}
+
+/*!
+  Receive a matrix sent by sendMatrix() or sendMatrixTo(), from the first
+  receptor that has data to read. The matrix is resized if needed and the
+  elements are received directly in it.
+
+  \sa vpNetwork::receiveMatrixFrom()
+
+  \param M : Received matrix.
+
+  \return The number of bytes received, 0 if the timeout expired or if the
+  receptor disconnected, -1 if an error occured or if the next message is not a
+  matrix.
+*/
+int vpNetwork::receiveMatrix(vpArray2D<double> &M)
+{
+  return _receiveMatrix(M, -1);
+}
+
+/*!
+  Receive a matrix sent by sendMatrix() or sendMatrixTo(), from a specific
+  receptor.
+
+  \sa vpNetwork::receiveMatrix()
+
+  \param M : Received matrix.
+  \param receptorEmitting : Index of the receptor emitting the matrix.
+
+  \return The number of bytes received, 0 if the timeout expired or if the
+  receptor disconnected, -1 if an error occured or if the next message is not a
+  matrix.
+*/
+int vpNetwork::receiveMatrixFrom(vpArray2D<double> &M, const unsigned int &receptorEmitting)
+{
+  return _receiveMatrix(M, (int)receptorEmitting);
+}
+
+/*!
+  Receive a matrix: header, then elements directly in the matrix.
+*/
+int vpNetwork::_receiveMatrix(vpArray2D<double> &M, const int &receptorEmitting)
+{
+  unsigned int index, rows, cols;
+  int numbytes = _receiveMessage(receptorEmitting, MESSAGE_MATRIX, sizeof(double), index, rows, cols);
+  if (numbytes <= 0)
+    return numbytes;
+
+  if (M.getRows() != rows || M.getCols() != cols)
+    M.resize(rows, cols, false);
+  if (M.size() == 0)
+    return numbytes;
+
+  int payload = _receiveAll(index, (char*)(void*)M.data, M.size() * sizeof(double));
+  if (payload <= 0)
+    return payload;
+  return numbytes + payload;
+}
+
+/*!
+  Receive an image: header, then pixels directly in the image.
+*/
+template<class Type>
+int vpNetwork::_receiveImage(vpImage<Type> &I, const int &receptorEmitting, const unsigned int &type)
+{
+  unsigned int index, rows, cols;
+  int numbytes = _receiveMessage(receptorEmitting, type, sizeof(Type), index, rows, cols);
+  if (numbytes <= 0)
+    return numbytes;
+
+  I.resize(rows, cols);
+  if (I.getSize() == 0)
+    return numbytes;
+
+  int payload = _receiveAll(index, (char*)(void*)I.bitmap, I.getSize() * sizeof(Type));
+  if (payload <= 0)
+    return payload;
+  return numbytes + payload;
+}
+
+/*!
+  Wait for a binary message and receive its header.
+
+  \param receptorEmitting : Index of the receptor emitting the message, or -1
+  for the first receptor that has data to read.
+  \param type : Expected type of message.
+  \param sizeOfElement : Size of the elements of the expected message.
+  \param index : Index of the receptor that sent the message.
+  \param rows, cols : Size of the message.
+
+  \return The number of bytes of the header, 0 if the timeout expired or if the
+  receptor disconnected, -1 if an error occured or if the message is not of the
+  expected type. In that case its payload is skipped.
+*/
+int vpNetwork::_receiveMessage(const int &receptorEmitting, const unsigned int &type, const size_t &sizeOfElement,
+                               unsigned int &index, unsigned int &rows, unsigned int &cols)
+{
+  if(receptor_list.size() == 0 || (receptorEmitting >= 0 && (unsigned int)receptorEmitting >= receptor_list.size()))
+  {
+    if(verboseMode)
+      vpTRACE( "No receptor at the specified index" );
+    return -1;
+  }
+
+  std::vector<unsigned int> ready;
+  int value = _waitForData(ready, receptorEmitting);
+  if(value == -1){
+    if(verboseMode)
+      vpERROR_TRACE( "Select error" );
+    return -1;
+  }
+  else if(value == 0){
+    //Timeout
+    return 0;
+  }
+  index = ready[0];
+
+  unsigned int header[messageHeaderSize];
+  int numbytes = _receiveAll(index, (char*)(void*)header, sizeof(header));
+  if (numbytes <= 0)
+    return numbytes;
+
+  if (ntohl(header[0]) != messageMagic) {
+    if(verboseMode)
+      vpTRACE( "Incorrect message" );
+    return -1;
+  }
+  const unsigned int messageType = ntohl(header[1]);
+  rows = ntohl(header[2]);
+  cols = ntohl(header[3]);
+  size_t size = ntohl(header[4]);
+
+  if (messageType != type || (size_t)rows * cols * sizeOfElement != size) {
+    if(verboseMode)
+      vpTRACE( "Unexpected message" );
+    // Skip the payload to keep the next messages readable
+    receiveBuffer.resize(std::max<size_t>(receiveBuffer.size(), 65536));
+    while (size > 0) {
+      size_t chunk = std::min(size, receiveBuffer.size());
+      if (_receiveAll(index, &receiveBuffer[0], chunk) <= 0)
+        break;
+      size -= chunk;
+    }
+    return -1;
+  }
+
+  return numbytes;
+}
+
+/*!
+  Receive exactly \e size bytes from a receptor.
+
+  \return \e size, or the value returned by recv() if the receptor
+  disconnected or an error occured. In that case the receptor is removed.
+*/
+int vpNetwork::_receiveAll(const unsigned int &index, char *buffer, const size_t &size)
+{
+  size_t received = 0;
+  while (received < size) {
+#if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
+    int numbytes = (int)recv(receptor_list[index].socketFileDescriptorReceptor, buffer + received, size - received, MSG_WAITALL);
+    if (numbytes < 0 && errno == EINTR)
+      continue;
+#else
+    int numbytes = recv((unsigned int)receptor_list[index].socketFileDescriptorReceptor, buffer + received, (int)(size - received), MSG_WAITALL);
+#endif
+    if (numbytes <= 0) {
+      std::cout << "Disconnected : " << inet_ntoa(receptor_list[index].receptorAddress.sin_addr) << std::endl;
+      _removeReceptor(index);
+      return numbytes;
+    }
+    received += (size_t)numbytes;
+  }
+  return (int)size;
+}
+
+/*!
+  Send a binary message to a receptor: the header and the payload are gathered
+  in a single system call.
+
+  \return The number of bytes sent, 0 if there is no receptor at the specified
+  index, -1 if an error happened.
+*/
+int vpNetwork::_sendMessageTo(const unsigned int &type, const unsigned int &rows, const unsigned int &cols,
+                              const char *payload, const size_t &size, const unsigned int &dest)
+{
+  if(receptor_list.size() == 0 || dest > (unsigned int)receptor_list.size()-1 )
+  {
+    if(verboseMode)
+      vpTRACE( "No receptor at the specified index." );
+    return 0;
+  }
+
+  unsigned int header[messageHeaderSize];
+  header[0] = htonl(messageMagic);
+  header[1] = htonl(type);
+  header[2] = htonl(rows);
+  header[3] = htonl(cols);
+  header[4] = htonl((unsigned int)size);
+  const size_t total = sizeof(header) + size;
+
+#if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
+  int flags = 0;
+#  if defined(__linux__)
+  flags = MSG_NOSIGNAL; // Only for Linux
+#  endif
+  struct iovec iov[2];
+  iov[0].iov_base = (void*)header;
+  iov[0].iov_len = sizeof(header);
+  iov[1].iov_base = (void*)payload;
+  iov[1].iov_len = size;
+  struct msghdr message;
+  memset(&message, 0, sizeof(message));
+  message.msg_iov = iov;
+  message.msg_iovlen = (size > 0) ? 2 : 1;
+
+  size_t sent = 0;
+  while (sent < total) {
+    ssize_t numbytes = sendmsg(receptor_list[dest].socketFileDescriptorReceptor, &message, flags);
+    if (numbytes < 0) {
+      if (errno == EINTR)
+        continue;
+      return -1;
+    }
+    sent += (size_t)numbytes;
+    // Skip what was sent after a partial write
+    while (numbytes > 0) {
+      if ((size_t)numbytes >= message.msg_iov->iov_len) {
+        numbytes -= (ssize_t)message.msg_iov->iov_len;
+        message.msg_iov++;
+        message.msg_iovlen--;
+      }
+      else {
+        message.msg_iov->iov_base = (char*)message.msg_iov->iov_base + numbytes;
+        message.msg_iov->iov_len -= (size_t)numbytes;
+        numbytes = 0;
+      }
+    }
+  }
+#else
+  WSABUF buffers[2];
+  buffers[0].buf = (char*)header;
+  buffers[0].len = (ULONG)sizeof(header);
+  buffers[1].buf = (char*)payload;
+  buffers[1].len = (ULONG)size;
+  WSABUF *first = buffers;
+  DWORD nbBuffers = (size > 0) ? 2 : 1;
+
+  size_t sent = 0;
+  while (sent < total) {
+    DWORD numbytes = 0;
+    if (WSASend(receptor_list[dest].socketFileDescriptorReceptor, first, nbBuffers, &numbytes, 0, NULL, NULL) != 0)
+      return -1;
+    sent += numbytes;
+    // Skip what was sent after a partial write
+    while (numbytes > 0) {
+      if (numbytes >= first->len) {
+        numbytes -= first->len;
+        first++;
+        nbBuffers--;
+      }
+      else {
+        first->buf += numbytes;
+        first->len -= numbytes;
+        numbytes = 0;
+      }
+    }
+  }
+#endif
+
+  return (int)total;
+}
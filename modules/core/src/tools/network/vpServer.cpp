@@ -198,24 +198,9 @@ bool vpServer::checkForConnections()
       return false;
     }
   
-  tv.tv_sec = tv_sec;
-  tv.tv_usec = tv_usec;
-  
-  FD_ZERO(&readFileDescriptor);         
-  
-  socketMax = emitter.socketFileDescriptorEmitter;
-  FD_SET((unsigned)emitter.socketFileDescriptorEmitter,&readFileDescriptor);
-
-  for(unsigned int i=0; i<receptor_list.size(); i++){
-    FD_SET((unsigned)receptor_list[i].socketFileDescriptorReceptor,&readFileDescriptor);
-
-    if(i == 0)
-      socketMax = receptor_list[i].socketFileDescriptorReceptor;
-   
-    if(socketMax < receptor_list[i].socketFileDescriptorReceptor) socketMax = receptor_list[i].socketFileDescriptorReceptor; 
-  }
-  
-  int value = select((int)socketMax+1,&readFileDescriptor,NULL,NULL,&tv);
+  std::vector<unsigned int> ready;
+  bool emitterReady;
+  int value = _waitForData(ready, -1, &emitterReady);
   if(value == -1){
     //vpERROR_TRACE( "vpServer::run(), select()" );
     return false;
@@ -224,7 +209,7 @@ bool vpServer::checkForConnections()
     return false;
   }
   else{
-    if(FD_ISSET((unsigned int)emitter.socketFileDescriptorEmitter,&readFileDescriptor)){
+    if(emitterReady){
       vpNetwork::vpReceptor client;
       client.receptorAddressSize = sizeof(client.receptorAddress);
 #if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
@@ -242,27 +227,26 @@ bool vpServer::checkForConnections()
       
       client.receptorIP = inet_ntoa(client.receptorAddress.sin_addr);
       printf("New client connected : %s\n", inet_ntoa(client.receptorAddress.sin_addr));
-      receptor_list.push_back(client);
+      _addReceptor(client);
       
       return true;
     }
     else{
-      for(unsigned int i=0; i<receptor_list.size(); i++){
-        if(FD_ISSET((unsigned int)receptor_list[i].socketFileDescriptorReceptor,&readFileDescriptor)){
-          char deco;
+      for(unsigned int r=0; r<ready.size(); r++){
+        unsigned int i = ready[r];
+        char deco;
 #if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
-          int numbytes = recv(receptor_list[i].socketFileDescriptorReceptor, &deco, 1, MSG_PEEK);
+        int numbytes = recv(receptor_list[i].socketFileDescriptorReceptor, &deco, 1, MSG_PEEK);
 #else //Win32
-          int numbytes = recv((unsigned int)receptor_list[i].socketFileDescriptorReceptor, &deco, 1, MSG_PEEK);
+        int numbytes = recv((unsigned int)receptor_list[i].socketFileDescriptorReceptor, &deco, 1, MSG_PEEK);
 #endif
-          
-      
-          if(numbytes == 0)
-          {
-            std::cout << "Disconnected : " << inet_ntoa(receptor_list[i].receptorAddress.sin_addr) << std::endl;
-            receptor_list.erase(receptor_list.begin()+(int)i);
-            return 0;
-          }
+        
+    
+        if(numbytes == 0)
+        {
+          std::cout << "Disconnected : " << inet_ntoa(receptor_list[i].receptorAddress.sin_addr) << std::endl;
+          _removeReceptor(i);
+          return 0;
         }
       }
     }
@@ -0,0 +1,369 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Reader of the images of a shared memory segment.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpSharedImageReader.cpp
+  \brief Frame grabber reading the images published by another process
+  through shared memory.
+*/
+
+#include <visp3/core/vpSharedImageReader.h>
+
+#if defined(VISP_HAVE_PTHREAD) && !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <visp3/core/vpFrameGrabberException.h>
+#include <visp3/core/vpImageConvert.h>
+#include <visp3/core/vpTime.h>
+
+#include "vpSharedImageSegment.h"
+
+using namespace vpSharedImageSegment;
+
+/*!
+  Default constructor. The name of the segment has to be set with setName()
+  before calling open().
+*/
+vpSharedImageReader::vpSharedImageReader()
+  : vpFrameGrabber(), m_name(), m_segment(NULL), m_segmentSize(0), m_bitmaps(NULL), m_bitmapsSize(0),
+    m_bytesPerPixel(0), m_reader(-1), m_slot(-1), m_sequence(0), m_nbSkipped(0), m_timestamp(0), m_timeout(1000)
+{
+}
+
+/*!
+  Constructor of a reader of the segment \e name, that has to be opened with
+  open().
+
+  \param name : Name of the segment given to vpSharedImageWriter::open().
+*/
+vpSharedImageReader::vpSharedImageReader(const std::string &name)
+  : vpFrameGrabber(), m_name(name), m_segment(NULL), m_segmentSize(0), m_bitmaps(NULL), m_bitmapsSize(0),
+    m_bytesPerPixel(0), m_reader(-1), m_slot(-1), m_sequence(0), m_nbSkipped(0), m_timestamp(0), m_timeout(1000)
+{
+}
+
+/*!
+  Destructor that calls close().
+*/
+vpSharedImageReader::~vpSharedImageReader()
+{
+  close();
+}
+
+/*!
+  Map the shared memory segment: the descriptors read-write, the bitmaps
+  read-only. Then take a free reader descriptor, or the descriptor of a reader
+  whose process is dead.
+*/
+void vpSharedImageReader::open()
+{
+  close();
+
+  int fd = shm_open(m_name.c_str(), O_RDWR, 0);
+  if (fd < 0) {
+    throw(vpFrameGrabberException(vpFrameGrabberException::initializationError,
+                                  "Cannot open the shared memory segment %s: %s", m_name.c_str(), strerror(errno)));
+  }
+
+  struct stat status;
+  void *segment = MAP_FAILED;
+  if (fstat(fd, &status) == 0 && (size_t)status.st_size >= sizeof(vpHeader)) {
+    segment = mmap(NULL, sizeof(vpHeader), PROT_READ, MAP_SHARED, fd, 0);
+  }
+  if (segment == MAP_FAILED) {
+    ::close(fd);
+    throw(vpFrameGrabberException(vpFrameGrabberException::initializationError,
+                                  "Cannot map the shared memory segment %s", m_name.c_str()));
+  }
+  const vpHeader header = *(const vpHeader *)segment;
+  const bool valid = load(((const vpHeader *)segment)->magic) == magic && header.version == version
+      && header.segmentSize == (size_t)status.st_size;
+  munmap(segment, sizeof(vpHeader));
+  if (!valid) {
+    ::close(fd);
+    throw(vpFrameGrabberException(vpFrameGrabberException::initializationError,
+                                  "%s is not a shared memory segment of images", m_name.c_str()));
+  }
+
+  segment = mmap(NULL, header.bitmapsOffset, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  void *bitmaps = MAP_FAILED;
+  if (segment != MAP_FAILED) {
+    bitmaps = mmap(NULL, header.segmentSize - header.bitmapsOffset, PROT_READ, MAP_SHARED, fd, (off_t)header.bitmapsOffset);
+    if (bitmaps == MAP_FAILED)
+      munmap(segment, header.bitmapsOffset);
+  }
+  ::close(fd);
+  if (bitmaps == MAP_FAILED) {
+    throw(vpFrameGrabberException(vpFrameGrabberException::initializationError,
+                                  "Cannot map the shared memory segment %s", m_name.c_str()));
+  }
+
+  vpReader *reader = readers(segment);
+  const long pid = (long)getpid();
+  int index = -1;
+  for (int pass = 0; pass < 2 && index < 0; pass++) {
+    for (unsigned int i = 0; i < maxReaders; i++) {
+      const long owner = load(reader[i].pid);
+      if ((owner == 0 || (pass == 1 && !isAlive(owner))) && compareAndSwap(reader[i].pid, owner, pid)) {
+        store(reader[i].slot, -1L);
+        index = (int)i;
+        break;
+      }
+    }
+  }
+  if (index < 0) {
+    munmap(segment, header.bitmapsOffset);
+    munmap(bitmaps, header.segmentSize - header.bitmapsOffset);
+    throw(vpFrameGrabberException(vpFrameGrabberException::initializationError,
+                                  "Too many readers of the shared memory segment %s", m_name.c_str()));
+  }
+
+  m_segment = segment;
+  m_segmentSize = header.bitmapsOffset;
+  m_bitmaps = (const unsigned char *)bitmaps;
+  m_bitmapsSize = header.segmentSize - header.bitmapsOffset;
+  m_bytesPerPixel = header.bytesPerPixel;
+  m_reader = index;
+  m_slot = -1;
+  m_sequence = 0;
+  m_nbSkipped = 0;
+  m_timestamp = 0;
+  height = header.height;
+  width = header.width;
+  init = true;
+}
+
+/*!
+  Open the shared memory segment and resize \e I to the size of its images.
+
+  \exception vpFrameGrabberException::initializationError : If the segment
+  doesn't exist, or if 32 readers already read it.
+*/
+void vpSharedImageReader::open(vpImage<unsigned char> &I)
+{
+  open();
+  I.resize(height, width);
+}
+
+/*!
+  Open the shared memory segment and resize \e I to the size of its images.
+
+  \exception vpFrameGrabberException::initializationError : If the segment
+  doesn't exist, or if 32 readers already read it.
+*/
+void vpSharedImageReader::open(vpImage<vpRGBa> &I)
+{
+  open();
+  I.resize(height, width);
+}
+
+/*!
+  Unmap the segment. The images that wrap its frames must not be used anymore.
+*/
+void vpSharedImageReader::close()
+{
+  if (m_segment == NULL)
+    return;
+
+  release();
+  store(readers(m_segment)[m_reader].pid, 0L);
+  munmap(m_segment, m_segmentSize);
+  munmap((void *)m_bitmaps, m_bitmapsSize);
+  m_segment = NULL;
+  m_bitmaps = NULL;
+  m_reader = -1;
+  init = false;
+}
+
+/*!
+  Give back to the writer the slot of the last acquired frame, if it is still
+  held. The image that wraps the frame must not be used anymore.
+*/
+void vpSharedImageReader::release()
+{
+  if (m_slot < 0)
+    return;
+  store(readers(m_segment)[m_reader].slot, -1L);
+  m_slot = -1;
+}
+
+/*!
+  Release the previous frame and take the latest frame, after waiting for it
+  if it was already acquired.
+
+  \return The bitmap of the slot of the frame, held by the reader.
+*/
+const unsigned char *vpSharedImageReader::waitForFrame()
+{
+  if (m_segment == NULL) {
+    throw(vpFrameGrabberException(vpFrameGrabberException::initializationError,
+                                  "The shared memory segment is not open"));
+  }
+  release();
+
+  vpHeader *header = (vpHeader *)m_segment;
+  vpSlot *slot = slots(m_segment);
+  vpReader &reader = readers(m_segment)[m_reader];
+  const double t0 = vpTime::measureTimeMs();
+  for (;;) {
+    if (load(header->sequence) > m_sequence) {
+      // Take the latest frame, unless the writer reserves its slot after
+      // publishing a newer one. The slot is given in the descriptor before
+      // checking its state, see vpSharedImageWriter::reserve()
+      const long latest = load(header->latest);
+      store(reader.slot, latest);
+      if (load(slot[latest].state) != SLOT_WRITING) {
+        const unsigned long sequence = load(slot[latest].sequence);
+        if (sequence > m_sequence) {
+          if (m_sequence > 0)
+            m_nbSkipped += sequence - m_sequence - 1;
+          m_sequence = sequence;
+          m_timestamp = slot[latest].timestamp;
+          m_slot = (int)latest;
+          return m_bitmaps + (size_t)latest * header->bitmapStride;
+        }
+      }
+      store(reader.slot, -1L);
+      continue;
+    }
+
+    if (load(header->closed)) {
+      throw(vpFrameGrabberException(vpFrameGrabberException::otherError,
+                                    "The writer of %s is closed", m_name.c_str()));
+    }
+    const double remaining = m_timeout - (vpTime::measureTimeMs() - t0);
+    if (m_timeout >= 0 && remaining <= 0) {
+      throw(vpFrameGrabberException(vpFrameGrabberException::otherError,
+                                    "No frame received from %s in %g ms", m_name.c_str(), m_timeout));
+    }
+
+#ifdef VISP_SHARED_IMAGE_HAVE_CONDITION
+    lockMutex(header);
+    if (load(header->sequence) == m_sequence && !load(header->closed)) {
+      if (m_timeout < 0) {
+        recoverMutex(header, pthread_cond_wait(&header->condition, &header->mutex));
+      }
+      else {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        const long ns = deadline.tv_nsec + (long)(remaining * 1e6);
+        deadline.tv_sec += ns / 1000000000L;
+        deadline.tv_nsec = ns % 1000000000L;
+        recoverMutex(header, pthread_cond_timedwait(&header->condition, &header->mutex, &deadline));
+      }
+    }
+    pthread_mutex_unlock(&header->mutex);
+#else
+    vpTime::sleepMs(1);
+#endif
+  }
+}
+
+/*!
+  Wait for a frame more recent than the previous one and get the latest
+  published frame. If the writer publishes grey level images, \e I wraps the
+  frame without copy until the next call to acquire(), release() or close().
+  Otherwise the frame is converted.
+
+  \exception vpFrameGrabberException::initializationError : If the segment is
+  not open.
+  \exception vpFrameGrabberException::otherError : If no frame was published
+  before the timeout, or if the writer closed the segment. If \e I wrapped the
+  previous frame, it is then detached from it.
+
+  \sa setTimeout(), getTimestamp(), getSequence()
+*/
+void vpSharedImageReader::acquire(vpImage<unsigned char> &I)
+{
+  // Detach I from the previous frame, that is released
+  if (!I.isBitmapOwner() && (const unsigned char *)I.bitmap >= m_bitmaps
+      && (const unsigned char *)I.bitmap < m_bitmaps + m_bitmapsSize)
+    I.destroy();
+
+  const unsigned char *bitmap = waitForFrame();
+  if (m_bytesPerPixel == sizeof(unsigned char)) {
+    I.wrap(const_cast<unsigned char *>(bitmap), height, width);
+  }
+  else {
+    vpImage<vpRGBa> frame;
+    frame.wrap((vpRGBa *)(void *)const_cast<unsigned char *>(bitmap), height, width);
+    vpImageConvert::convert(frame, I);
+    release();
+  }
+}
+
+/*!
+  Wait for a frame more recent than the previous one and get the latest
+  published frame. If the writer publishes color images, \e I wraps the frame
+  without copy until the next call to acquire(), release() or close().
+  Otherwise the frame is converted.
+
+  \exception vpFrameGrabberException::initializationError : If the segment is
+  not open.
+  \exception vpFrameGrabberException::otherError : If no frame was published
+  before the timeout, or if the writer closed the segment. If \e I wrapped the
+  previous frame, it is then detached from it.
+
+  \sa setTimeout(), getTimestamp(), getSequence()
+*/
+void vpSharedImageReader::acquire(vpImage<vpRGBa> &I)
+{
+  // Detach I from the previous frame, that is released
+  if (!I.isBitmapOwner() && (const unsigned char *)(const void *)I.bitmap >= m_bitmaps
+      && (const unsigned char *)(const void *)I.bitmap < m_bitmaps + m_bitmapsSize)
+    I.destroy();
+
+  const unsigned char *bitmap = waitForFrame();
+  if (m_bytesPerPixel == sizeof(vpRGBa)) {
+    I.wrap((vpRGBa *)(void *)const_cast<unsigned char *>(bitmap), height, width);
+  }
+  else {
+    vpImage<unsigned char> frame;
+    frame.wrap(const_cast<unsigned char *>(bitmap), height, width);
+    vpImageConvert::convert(frame, I);
+    release();
+  }
+}
+
+#elif !defined(VISP_BUILD_SHARED_LIBS)
+// Work arround to avoid warning: libvisp_core.a(vpSharedImageReader.cpp.o) has no symbols
+void dummy_vpSharedImageReader() {};
+#endif
@@ -0,0 +1,191 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Layout of the shared memory segment of vpSharedImageWriter and
+ * vpSharedImageReader.
+ *
+ *****************************************************************************/
+
+#ifndef __vpSharedImageSegment_h_
+#define __vpSharedImageSegment_h_
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+#include <errno.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+
+#if defined(_POSIX_THREAD_PROCESS_SHARED) && (_POSIX_THREAD_PROCESS_SHARED > 0)
+// The readers wait on a condition variable shared by the processes, otherwise
+// they poll the segment
+#  define VISP_SHARED_IMAGE_HAVE_CONDITION
+#  if defined(EOWNERDEAD) && defined(__GLIBC__) && ((__GLIBC__ > 2) || ((__GLIBC__ == 2) && (__GLIBC_MINOR__ >= 12)))
+// The mutex is robust: it is not left locked by a process that dies while
+// holding it
+#    define VISP_SHARED_IMAGE_HAVE_ROBUST_MUTEX
+#  endif
+#endif
+
+/*
+  The segment starts with a vpHeader, followed by the nbSlots descriptors of
+  the slots, the maxReaders descriptors of the readers, then by the nbSlots
+  bitmaps of the slots. The descriptors and the bitmaps are aligned on 64
+  bytes, and the first bitmap on a page, so that the readers can map the
+  bitmaps read-only.
+
+  Each reader owns a descriptor, tagged with its process id, that gives the
+  slot it reads. The state of a slot is SLOT_WRITING while the writer fills
+  it, 0 otherwise. A reader writes the slot in its descriptor before checking
+  that the slot is not reserved, and the writer reserves a slot before
+  checking that no reader gives it: with full barriers, one of them sees the
+  other and backs off, so that the writer never modifies a slot that is read.
+  The writer never reserves the slot of the latest frame.
+
+  Since the slots read are given by descriptors tagged with a process id
+  rather than counted, the descriptor of a reader that died without releasing
+  its slot can be freed by the writer or by a new reader.
+*/
+namespace vpSharedImageSegment
+{
+  const unsigned int magic = 0x76705348;
+  const unsigned int version = 2;
+  const long SLOT_WRITING = -1;
+  const unsigned int maxReaders = 32;
+  const size_t alignment = 64;
+
+  struct vpHeader
+  {
+    unsigned int magic;
+    unsigned int version;
+    unsigned int height;
+    unsigned int width;
+    unsigned int bytesPerPixel; // 1 for unsigned char, 4 for vpRGBa
+    unsigned int nbSlots;
+    size_t segmentSize;
+    size_t slotsOffset;
+    size_t readersOffset;
+    size_t bitmapsOffset;
+    size_t bitmapStride;
+#ifdef VISP_SHARED_IMAGE_HAVE_CONDITION
+    pthread_mutex_t mutex;
+    pthread_cond_t condition;
+#endif
+    volatile unsigned long sequence; // Sequence number of the latest frame, 0 before the first one
+    volatile long latest;            // Slot of the latest frame, -1 before the first one
+    volatile long closed;            // Set when the writer closes the segment
+  };
+
+  struct vpSlot
+  {
+    volatile long state;
+    volatile unsigned long sequence;
+    double timestamp;
+  };
+
+  struct vpReader
+  {
+    volatile long pid;  // Process of the reader, 0 if the descriptor is free
+    volatile long slot; // Slot read, -1 if none
+  };
+
+  inline size_t align(size_t size) { return (size + alignment - 1) / alignment * alignment; }
+
+  inline vpSlot *slots(void *segment)
+  {
+    return (vpSlot *)((char *)segment + ((vpHeader *)segment)->slotsOffset);
+  }
+
+  inline vpReader *readers(void *segment)
+  {
+    return (vpReader *)((char *)segment + ((vpHeader *)segment)->readersOffset);
+  }
+
+  // False only if the process doesn't exist anymore
+  inline bool isAlive(long pid)
+  {
+    return kill((pid_t)pid, 0) == 0 || errno != ESRCH;
+  }
+
+  inline unsigned char *bitmap(void *segment, unsigned int slot)
+  {
+    const vpHeader *header = (const vpHeader *)segment;
+    return (unsigned char *)segment + header->bitmapsOffset + slot * header->bitmapStride;
+  }
+
+  // Atomic accesses, that are full memory barriers
+  template<class T>
+  inline T load(const volatile T &value)
+  {
+    __sync_synchronize();
+    T v = value;
+    __sync_synchronize();
+    return v;
+  }
+
+  template<class T>
+  inline void store(volatile T &value, T v)
+  {
+    __sync_synchronize();
+    value = v;
+    __sync_synchronize();
+  }
+
+  inline bool compareAndSwap(volatile long &value, long expected, long v)
+  {
+    return __sync_bool_compare_and_swap(&value, expected, v);
+  }
+
+#ifdef VISP_SHARED_IMAGE_HAVE_CONDITION
+  // When the process that held the mutex died, the state it protects is
+  // consistent since it is only modified by atomic stores: the mutex can be
+  // marked consistent and used again
+  inline void recoverMutex(vpHeader *header, int error)
+  {
+#ifdef VISP_SHARED_IMAGE_HAVE_ROBUST_MUTEX
+    if (error == EOWNERDEAD)
+      pthread_mutex_consistent(&header->mutex);
+#else
+    (void)header;
+    (void)error;
+#endif
+  }
+
+  inline void lockMutex(vpHeader *header)
+  {
+    recoverMutex(header, pthread_mutex_lock(&header->mutex));
+  }
+#endif
+}
+
+#endif
+
+#endif
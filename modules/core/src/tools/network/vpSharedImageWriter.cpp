@@ -0,0 +1,434 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Writer of images in a shared memory segment.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpSharedImageWriter.cpp
+  \brief Publication of images to other processes through shared memory.
+*/
+
+#include <visp3/core/vpSharedImageWriter.h>
+
+#if defined(VISP_HAVE_PTHREAD) && !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include <visp3/core/vpException.h>
+
+#include "vpSharedImageSegment.h"
+
+using namespace vpSharedImageSegment;
+
+/*!
+  Default constructor. No segment is created until open() is called.
+*/
+vpSharedImageWriter::vpSharedImageWriter()
+  : m_name(), m_segment(NULL), m_size(0), m_nbSlots(0), m_slot(-1), m_sequence(0)
+{
+}
+
+/*!
+  Destructor that calls close().
+*/
+vpSharedImageWriter::~vpSharedImageWriter()
+{
+  close();
+}
+
+/*!
+  Create a shared memory segment for images of the size of \e I.
+
+  \param name : Name of the segment, that starts with a slash, for instance
+  "/camera". An existing segment with the same name is replaced.
+  \param I : Image that gives the size of the images.
+  \param nbSlots : Number of images of the ring, at least 2.
+
+  \exception vpException::badValue : If there are less than 2 slots.
+  \exception vpException::ioError : If the segment can't be created.
+*/
+void vpSharedImageWriter::open(const std::string &name, const vpImage<unsigned char> &I, const unsigned int nbSlots)
+{
+  open(name, I.getHeight(), I.getWidth(), sizeof(unsigned char), nbSlots);
+}
+
+/*!
+  Create a shared memory segment for color images of the size of \e I.
+
+  \param name : Name of the segment, that starts with a slash, for instance
+  "/camera". An existing segment with the same name is replaced.
+  \param I : Image that gives the size of the images.
+  \param nbSlots : Number of images of the ring, at least 2.
+
+  \exception vpException::badValue : If there are less than 2 slots.
+  \exception vpException::ioError : If the segment can't be created.
+*/
+void vpSharedImageWriter::open(const std::string &name, const vpImage<vpRGBa> &I, const unsigned int nbSlots)
+{
+  open(name, I.getHeight(), I.getWidth(), sizeof(vpRGBa), nbSlots);
+}
+
+void vpSharedImageWriter::open(const std::string &name, const unsigned int height, const unsigned int width,
+                               const unsigned int bytesPerPixel, const unsigned int nbSlots)
+{
+  if (nbSlots < 2) {
+    throw(vpException(vpException::badValue, "The shared memory segment needs at least 2 slots"));
+  }
+  close();
+
+  const size_t slotsOffset = align(sizeof(vpHeader));
+  const size_t readersOffset = align(slotsOffset + nbSlots * sizeof(vpSlot));
+  // The readers map the bitmaps read-only, from a page boundary
+  const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+  const size_t bitmapsOffset = (readersOffset + maxReaders * sizeof(vpReader) + page - 1) / page * page;
+  const size_t bitmapStride = align((size_t)height * width * bytesPerPixel);
+  const size_t size = bitmapsOffset + nbSlots * bitmapStride;
+
+  // Readers of a previous segment keep it until they close it
+  shm_unlink(name.c_str());
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH);
+  if (fd < 0) {
+    throw(vpException(vpException::ioError, "Cannot create the shared memory segment %s: %s", name.c_str(), strerror(errno)));
+  }
+  if (ftruncate(fd, (off_t)size) < 0) {
+    int error = errno;
+    ::close(fd);
+    shm_unlink(name.c_str());
+    throw(vpException(vpException::ioError, "Cannot allocate the shared memory segment %s: %s", name.c_str(), strerror(error)));
+  }
+  void *segment = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (segment == MAP_FAILED) {
+    int error = errno;
+    shm_unlink(name.c_str());
+    throw(vpException(vpException::ioError, "Cannot map the shared memory segment %s: %s", name.c_str(), strerror(error)));
+  }
+
+  // The segment is filled with zeros
+  vpHeader *header = (vpHeader *)segment;
+  header->version = version;
+  header->height = height;
+  header->width = width;
+  header->bytesPerPixel = bytesPerPixel;
+  header->nbSlots = nbSlots;
+  header->segmentSize = size;
+  header->slotsOffset = slotsOffset;
+  header->readersOffset = readersOffset;
+  header->bitmapsOffset = bitmapsOffset;
+  header->bitmapStride = bitmapStride;
+#ifdef VISP_SHARED_IMAGE_HAVE_CONDITION
+  pthread_mutexattr_t mutexAttributes;
+  pthread_mutexattr_init(&mutexAttributes);
+  pthread_mutexattr_setpshared(&mutexAttributes, PTHREAD_PROCESS_SHARED);
+#ifdef VISP_SHARED_IMAGE_HAVE_ROBUST_MUTEX
+  pthread_mutexattr_setrobust(&mutexAttributes, PTHREAD_MUTEX_ROBUST);
+#endif
+  pthread_mutex_init(&header->mutex, &mutexAttributes);
+  pthread_mutexattr_destroy(&mutexAttributes);
+  pthread_condattr_t conditionAttributes;
+  pthread_condattr_init(&conditionAttributes);
+  pthread_condattr_setpshared(&conditionAttributes, PTHREAD_PROCESS_SHARED);
+  pthread_cond_init(&header->condition, &conditionAttributes);
+  pthread_condattr_destroy(&conditionAttributes);
+#endif
+  header->sequence = 0;
+  header->latest = -1;
+  header->closed = 0;
+  // The readers check the magic number last
+  store(header->magic, magic);
+
+  m_name = name;
+  m_segment = segment;
+  m_size = size;
+  m_nbSlots = nbSlots;
+  m_slot = -1;
+  m_sequence = 0;
+}
+
+/*!
+  Wake up the readers, unmap the segment and remove its name. The readers that
+  mapped it can still read the last frames until they close it.
+*/
+void vpSharedImageWriter::close()
+{
+  if (m_segment == NULL)
+    return;
+
+  vpHeader *header = (vpHeader *)m_segment;
+#ifdef VISP_SHARED_IMAGE_HAVE_CONDITION
+  lockMutex(header);
+  store(header->closed, 1L);
+  pthread_cond_broadcast(&header->condition);
+  pthread_mutex_unlock(&header->mutex);
+#else
+  store(header->closed, 1L);
+#endif
+
+  munmap(m_segment, m_size);
+  shm_unlink(m_name.c_str());
+  m_segment = NULL;
+  m_size = 0;
+  m_slot = -1;
+}
+
+namespace
+{
+  // Return true if a reader gives slot in its descriptor
+  bool isRead(void *segment, long slot)
+  {
+    const vpReader *reader = readers(segment);
+    for (unsigned int i = 0; i < maxReaders; i++) {
+      if (load(reader[i].pid) != 0 && load(reader[i].slot) == slot)
+        return true;
+    }
+    return false;
+  }
+
+  // Get the slots given by the readers, and return their number
+  unsigned int getReadSlots(void *segment, long *read)
+  {
+    const vpReader *reader = readers(segment);
+    unsigned int n = 0;
+    for (unsigned int i = 0; i < maxReaders; i++) {
+      if (load(reader[i].pid) != 0)
+        read[n++] = load(reader[i].slot);
+    }
+    return n;
+  }
+}
+
+/*!
+  Reserve the oldest slot that no reader uses, excluding the slot of the
+  latest frame, and return its bitmap. If all the slots are used, the slots of
+  the readers whose process is dead are released first.
+*/
+unsigned char *vpSharedImageWriter::reserve(const unsigned int height, const unsigned int width,
+                                            const unsigned int bytesPerPixel)
+{
+  if (m_segment == NULL) {
+    throw(vpException(vpException::notInitialized, "The shared memory segment is not open"));
+  }
+  const vpHeader *header = (const vpHeader *)m_segment;
+  if (header->height != height || header->width != width || header->bytesPerPixel != bytesPerPixel) {
+    throw(vpException(vpException::badValue, "The image doesn't match the shared memory segment"));
+  }
+  if (m_slot >= 0)
+    return bitmap(m_segment, (unsigned int)m_slot);
+
+  vpSlot *slot = slots(m_segment);
+  const long latest = load(header->latest);
+  for (int pass = 0; pass < 2; pass++) {
+    for (;;) {
+      // A reader can only take a slot that was the latest one
+      long read[maxReaders];
+      const unsigned int nbRead = getReadSlots(m_segment, read);
+      int oldest = -1;
+      for (unsigned int i = 0; i < m_nbSlots; i++) {
+        if ((long)i != latest && load(slot[i].state) == 0 && std::find(read, read + nbRead, (long)i) == read + nbRead
+            && (oldest < 0 || slot[i].sequence < slot[oldest].sequence))
+          oldest = (int)i;
+      }
+      if (oldest < 0)
+        break;
+      // The slot is reserved before checking the readers again, so that a
+      // reader that takes it in the meantime sees the reservation or is seen
+      if (compareAndSwap(slot[oldest].state, 0, SLOT_WRITING)) {
+        if (!isRead(m_segment, (long)oldest)) {
+          m_slot = oldest;
+          return bitmap(m_segment, (unsigned int)oldest);
+        }
+        store(slot[oldest].state, 0L);
+      }
+    }
+    if (pass == 0 && releaseDeadReaders() == 0)
+      break;
+  }
+  return NULL;
+}
+
+/*!
+  Release the slots held by the readers whose process is dead, for instance a
+  reader that crashed without calling vpSharedImageReader::close(). Otherwise
+  the frame it was reading would never be reused. getWriteImage() and write()
+  call it when all the slots are used. vpSharedImageReader::open() also reuses
+  the descriptor of a dead reader when the 32 descriptors are taken.
+
+  A reader is identified by its process id: it is considered alive as long as
+  a process with this id exists, and the readers have to run in the same PID
+  namespace as the writer.
+
+  \return The number of dead readers whose slot was released.
+*/
+unsigned int vpSharedImageWriter::releaseDeadReaders()
+{
+  if (m_segment == NULL)
+    return 0;
+
+  vpReader *reader = readers(m_segment);
+  unsigned int nbReleased = 0;
+  for (unsigned int i = 0; i < maxReaders; i++) {
+    const long pid = load(reader[i].pid);
+    if (pid != 0 && !isAlive(pid) && compareAndSwap(reader[i].pid, pid, 0L))
+      nbReleased++;
+  }
+  return nbReleased;
+}
+
+/*!
+  Make \e I wrap a free slot of the segment, to fill it without copy before
+  calling push(). Until push() is called, the same slot is returned.
+
+  \return false if all the slots are used by readers, true otherwise.
+
+  \exception vpException::notInitialized : If the segment is not open.
+  \exception vpException::badValue : If the segment was not opened for grey
+  level images.
+*/
+bool vpSharedImageWriter::getWriteImage(vpImage<unsigned char> &I)
+{
+  const vpHeader *header = (const vpHeader *)m_segment;
+  unsigned char *bitmap = reserve(m_segment ? header->height : 0, m_segment ? header->width : 0,
+                                  sizeof(unsigned char));
+  if (bitmap == NULL)
+    return false;
+  I.wrap(bitmap, header->height, header->width);
+  return true;
+}
+
+/*!
+  Make \e I wrap a free slot of the segment, to fill it without copy before
+  calling push(). Until push() is called, the same slot is returned.
+
+  \return false if all the slots are used by readers, true otherwise.
+
+  \exception vpException::notInitialized : If the segment is not open.
+  \exception vpException::badValue : If the segment was not opened for color
+  images.
+*/
+bool vpSharedImageWriter::getWriteImage(vpImage<vpRGBa> &I)
+{
+  const vpHeader *header = (const vpHeader *)m_segment;
+  unsigned char *bitmap = reserve(m_segment ? header->height : 0, m_segment ? header->width : 0,
+                                  sizeof(vpRGBa));
+  if (bitmap == NULL)
+    return false;
+  I.wrap((vpRGBa *)(void *)bitmap, header->height, header->width);
+  return true;
+}
+
+/*!
+  Publish the slot filled after getWriteImage() as the latest frame, and wake
+  up the readers that wait for it. The image that wraps the slot must not be
+  modified anymore.
+
+  \param timestamp : Acquisition time of the image, for instance given by
+  vpTime::measureTimeMs().
+
+  \return The sequence number of the frame, that starts at 1.
+
+  \exception vpException::badValue : If no slot was reserved by
+  getWriteImage().
+*/
+unsigned long vpSharedImageWriter::push(const double timestamp)
+{
+  if (m_segment == NULL || m_slot < 0) {
+    throw(vpException(vpException::badValue, "No image was obtained from getWriteImage()"));
+  }
+  vpHeader *header = (vpHeader *)m_segment;
+  vpSlot &slot = slots(m_segment)[m_slot];
+
+  m_sequence++;
+  slot.timestamp = timestamp;
+  store(slot.sequence, m_sequence);
+  store(slot.state, 0L);
+
+#ifdef VISP_SHARED_IMAGE_HAVE_CONDITION
+  lockMutex(header);
+#endif
+  store(header->latest, (long)m_slot);
+  store(header->sequence, m_sequence);
+#ifdef VISP_SHARED_IMAGE_HAVE_CONDITION
+  pthread_cond_broadcast(&header->condition);
+  pthread_mutex_unlock(&header->mutex);
+#endif
+
+  m_slot = -1;
+  return m_sequence;
+}
+
+/*!
+  Copy \e I in a free slot and publish it.
+
+  \param I : Image to publish, of the size given to open().
+  \param timestamp : Acquisition time of the image.
+
+  \return The sequence number of the frame, or 0 if the frame was dropped
+  because all the slots are used by readers.
+*/
+unsigned long vpSharedImageWriter::write(const vpImage<unsigned char> &I, const double timestamp)
+{
+  unsigned char *bitmap = reserve(I.getHeight(), I.getWidth(), sizeof(unsigned char));
+  if (bitmap == NULL)
+    return 0;
+  memcpy(bitmap, I.bitmap, I.getSize() * sizeof(unsigned char));
+  return push(timestamp);
+}
+
+/*!
+  Copy \e I in a free slot and publish it.
+
+  \param I : Image to publish, of the size given to open().
+  \param timestamp : Acquisition time of the image.
+
+  \return The sequence number of the frame, or 0 if the frame was dropped
+  because all the slots are used by readers.
+*/
+unsigned long vpSharedImageWriter::write(const vpImage<vpRGBa> &I, const double timestamp)
+{
+  unsigned char *bitmap = reserve(I.getHeight(), I.getWidth(), sizeof(vpRGBa));
+  if (bitmap == NULL)
+    return 0;
+  memcpy(bitmap, (const void *)I.bitmap, I.getSize() * sizeof(vpRGBa));
+  return push(timestamp);
+}
+
+#elif !defined(VISP_BUILD_SHARED_LIBS)
+// Work arround to avoid warning: libvisp_core.a(vpSharedImageWriter.cpp.o) has no symbols
+void dummy_vpSharedImageWriter() {};
+#endif
@@ -0,0 +1,179 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the deprojection of depth maps in vpPointCloud.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPointCloud.cpp
+
+  \brief Test the deprojection of depth maps in vpPointCloud against a
+  scalar reference, with sizes that are not a multiple of the SIMD width
+  and invalid depth values.
+*/
+
+#include <iostream>
+#include <limits>
+#include <stdlib.h>
+
+#include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpPointCloud.h>
+
+namespace
+{
+bool check(const vpPointCloud &pointcloud, const std::vector<float> &depth, const std::vector<float> &raysX,
+           const std::vector<float> &raysY, float maxZ, const std::string &name)
+{
+  unsigned int nbValid = 0;
+  for (unsigned int i = 0; i < pointcloud.getHeight(); i++) {
+    for (unsigned int j = 0; j < pointcloud.getWidth(); j++) {
+      const unsigned int k = i*pointcloud.getWidth() + j;
+      const float z = depth[k];
+      const bool valid = (z > 0.f && z <= maxZ);
+      const float X = valid ? z * raysX[k] : 0.f;
+      const float Y = valid ? z * raysY[k] : 0.f;
+      const float Z = valid ? z : 0.f;
+      if (valid)
+        nbValid++;
+
+      if (pointcloud.isValid(i, j) != valid || pointcloud.getX()[k] != X || pointcloud.getY()[k] != Y
+          || pointcloud.getZ()[k] != Z) {
+        std::cerr << name << ": wrong point (" << i << ", " << j << "): " << pointcloud.getX()[k] << " "
+                  << pointcloud.getY()[k] << " " << pointcloud.getZ()[k] << " (" << (int) pointcloud.getValidMask()[k]
+                  << ") instead of " << X << " " << Y << " " << Z << " (" << valid << ")" << std::endl;
+        return false;
+      }
+    }
+  }
+  if (pointcloud.getNbValidPoints() != nbValid) {
+    std::cerr << name << ": " << pointcloud.getNbValidPoints() << " valid points instead of " << nbValid << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool test(unsigned int height, unsigned int width)
+{
+  vpCameraParameters cam(300, 310, width / 2.0, height / 2.0, -0.2, 0.2);
+  std::vector<float> raysX, raysY;
+  vpPointCloud::computeRays(cam, height, width, raysX, raysY);
+
+  const float depthScale = 0.001f;
+  const float maxZ = 4.f;
+  vpImage<uint16_t> depthRaw(height, width);
+  vpImage<float> depthMetric(height, width);
+  std::vector<float> depthRef(height * width);
+  for (unsigned int k = 0; k < height * width; k++) {
+    // Invalid points: no depth, too far, and for the metric depth map
+    // negative (vpKinect) or NaN values
+    if (k % 11 == 0)
+      depthRaw.bitmap[k] = 0;
+    else if (k % 13 == 0)
+      depthRaw.bitmap[k] = 65535;
+    else
+      depthRaw.bitmap[k] = (uint16_t) (rand() % 5000);
+    depthRef[k] = depthRaw.bitmap[k] * depthScale;
+
+    if (k % 7 == 0)
+      depthMetric.bitmap[k] = -1.f;
+    else if (k % 17 == 0)
+      depthMetric.bitmap[k] = std::numeric_limits<float>::quiet_NaN();
+    else
+      depthMetric.bitmap[k] = depthRef[k];
+  }
+
+  vpPointCloud pointcloud;
+  pointcloud.buildFrom(depthRaw, depthScale, raysX, raysY, maxZ);
+  if (!check(pointcloud, depthRef, raysX, raysY, maxZ, "uint16_t depth"))
+    return false;
+
+  // Fill again the same point cloud
+  pointcloud.buildFrom(depthMetric, raysX, raysY, maxZ);
+  std::vector<float> depthMetricRef(depthMetric.bitmap, depthMetric.bitmap + height * width);
+  if (!check(pointcloud, depthMetricRef, raysX, raysY, maxZ, "float depth"))
+    return false;
+
+  vpColVector p = pointcloud.getPoint(height - 1, width - 1);
+  const unsigned int k = height * width - 1;
+  if (p.size() != 4 || p[0] != pointcloud.getX()[k] || p[1] != pointcloud.getY()[k] || p[2] != pointcloud.getZ()[k]
+      || p[3] != 1) {
+    std::cerr << "Wrong point returned by getPoint()" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+}
+
+int main()
+{
+  try {
+    srand(0);
+    const unsigned int sizes[][2] = { {1, 1}, {1, 7}, {3, 5}, {7, 13}, {48, 64}, {61, 83} };
+    for (unsigned int i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+      if (!test(sizes[i][0], sizes[i][1])) {
+        std::cerr << "Failed for a " << sizes[i][0] << "x" << sizes[i][1] << " depth map" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // The rays must match the depth map
+    std::vector<float> raysX, raysY;
+    vpPointCloud::computeRays(vpCameraParameters(), 4, 4, raysX, raysY);
+    vpImage<float> depth(4, 5, 1.f);
+    vpPointCloud pointcloud;
+    try {
+      pointcloud.buildFrom(depth, raysX, raysY);
+      std::cerr << "Rays of a wrong size are accepted" << std::endl;
+      return EXIT_FAILURE;
+    }
+    catch(vpException &e) {
+      if (e.getCode() != vpException::dimensionError) {
+        throw;
+      }
+    }
+
+    // Colors are kept across resizes once enabled
+    pointcloud.enableColor(true);
+    pointcloud.resize(4, 4);
+    if (!pointcloud.hasColor() || pointcloud.getColor() == NULL || pointcloud.getNbValidPoints() != 0) {
+      std::cerr << "Wrong color storage" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    std::cout << "testPointCloud is ok" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,298 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test that the SIMD color conversions of vpImageConvert are bit-exact.
+ *
+ *****************************************************************************/
+/*!
+  \example testColorConversion.cpp
+
+  \brief Test that the SIMD color conversions of vpImageConvert give the same
+  results than a scalar implementation.
+
+*/
+
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include <visp3/core/vpCPUFeatures.h>
+#include <visp3/core/vpImageConvert.h>
+
+namespace {
+  unsigned char saturate(int c)
+  {
+    return (unsigned char) (c < 0 ? 0 : (c > 255 ? 255 : c));
+  }
+
+  void regularYUYVToRGBa(const unsigned char *yuyv, unsigned char *rgba, unsigned int size)
+  {
+    for (unsigned int i = 0; i < size; i += 2, yuyv += 4) {
+      int cb = ((yuyv[1] - 128) * 454) >> 8;
+      int cr = ((yuyv[3] - 128) * 359) >> 8;
+      int cg = ((yuyv[1] - 128) * 88 + (yuyv[3] - 128) * 183) >> 8;
+      for (unsigned int k = 0; k < 2; k++) {
+        int y = yuyv[2*k];
+        *rgba++ = saturate(y + cr);
+        *rgba++ = saturate(y - cg);
+        *rgba++ = saturate(y + cb);
+        *rgba++ = 0;
+      }
+    }
+  }
+
+  void regularYUVToRGBa(int y, int u, int v, unsigned char *rgba)
+  {
+    int U = (int)((u - 128) * 0.354);
+    int V = (int)((v - 128) * 0.707);
+    rgba[0] = saturate(y + 2*V);
+    rgba[1] = saturate(y - U - V);
+    rgba[2] = saturate(y + 5*U);
+    rgba[3] = 0;
+  }
+
+  void regularYUV422ToRGBa(const unsigned char *yuv, unsigned char *rgba, unsigned int size)
+  {
+    for (unsigned int i = 0; i < size; i += 2, yuv += 4, rgba += 8) {
+      regularYUVToRGBa(yuv[1], yuv[0], yuv[2], rgba);
+      regularYUVToRGBa(yuv[3], yuv[0], yuv[2], rgba + 4);
+    }
+  }
+
+  void regularYUV420ToRGBa(const unsigned char *yuv, unsigned char *rgba, unsigned int width, unsigned int height)
+  {
+    const unsigned char *u = yuv + width*height;
+    const unsigned char *v = u + width*height/4;
+    for (unsigned int i = 0; i < height/2*2; i++) {
+      for (unsigned int j = 0; j < width/2*2; j++) {
+        unsigned int c = (i/2)*(width/2) + j/2;
+        regularYUVToRGBa(yuv[i*width + j], u[c], v[c], rgba + 4*(i*width + j));
+      }
+    }
+  }
+
+  unsigned char regularGrey(int r, int g, int b)
+  {
+    return (unsigned char) ((2126*r + 7152*g + 722*b) / 10000);
+  }
+
+  void rgbaToRGB(const std::vector<unsigned char> &rgba, std::vector<unsigned char> &rgb)
+  {
+    rgb.resize(rgba.size() / 4 * 3);
+    for (size_t i = 0; i < rgba.size() / 4; i++) {
+      for (size_t c = 0; c < 3; c++) {
+        rgb[3*i + c] = rgba[4*i + c];
+      }
+    }
+  }
+
+  bool check(const std::vector<unsigned char> &result, const std::vector<unsigned char> &reference,
+             const std::string &name)
+  {
+    if (result.size() != reference.size() || memcmp(&result[0], &reference[0], result.size()) != 0) {
+      std::cerr << name << ": results differ from the scalar implementation!" << std::endl;
+      return false;
+    }
+    std::cout << name << ": ok" << std::endl;
+    return true;
+  }
+}
+
+int main()
+{
+  std::cout << "SSE2: " << vpCPUFeatures::checkSSE2() << " ; SSSE3: " << vpCPUFeatures::checkSSSE3()
+            << " ; AVX2: " << vpCPUFeatures::checkAVX2() << " ; NEON: " << vpCPUFeatures::checkNEON() << std::endl;
+
+  // Odd sizes to exercise the scalar tail after the SIMD kernels
+  const unsigned int width = 646, height = 37;
+  const unsigned int size = width*height;
+
+  std::vector<unsigned char> src(4*size);
+  srand(0);
+  for (size_t i = 0; i < src.size(); i++) {
+    src[i] = (unsigned char) (rand() % 256);
+  }
+  // Saturated values
+  for (size_t i = 0; i < 64; i++) {
+    src[i] = (i % 2) ? 0 : 255;
+  }
+  unsigned char *data = &src[0];
+
+  bool success = true;
+  std::vector<unsigned char> ref, ref_rgb, res;
+
+  // YUYV
+  ref.assign(4*size, 0);
+  regularYUYVToRGBa(data, &ref[0], size);
+  res.assign(4*size, 1);
+  vpImageConvert::YUYVToRGBa(data, &res[0], width, height);
+  success = check(res, ref, "YUYVToRGBa") && success;
+
+  rgbaToRGB(ref, ref_rgb);
+  res.assign(3*size, 1);
+  vpImageConvert::YUYVToRGB(data, &res[0], width, height);
+  success = check(res, ref_rgb, "YUYVToRGB") && success;
+
+  ref.resize(size);
+  for (unsigned int i = 0; i < size; i++) {
+    ref[i] = data[2*i];
+  }
+  res.assign(size, 1);
+  vpImageConvert::YUYVToGrey(data, &res[0], size);
+  success = check(res, ref, "YUYVToGrey") && success;
+
+  // YUV 4:2:2
+  ref.assign(4*size, 0);
+  regularYUV422ToRGBa(data, &ref[0], size);
+  res.assign(4*size, 1);
+  vpImageConvert::YUV422ToRGBa(data, &res[0], size);
+  success = check(res, ref, "YUV422ToRGBa") && success;
+
+  rgbaToRGB(ref, ref_rgb);
+  res.assign(3*size, 1);
+  vpImageConvert::YUV422ToRGB(data, &res[0], size);
+  success = check(res, ref_rgb, "YUV422ToRGB") && success;
+
+  ref.resize(size);
+  for (unsigned int i = 0; i < size; i++) {
+    ref[i] = data[2*i + 1];
+  }
+  res.assign(size, 1);
+  vpImageConvert::YUV422ToGrey(data, &res[0], size);
+  success = check(res, ref, "YUV422ToGrey") && success;
+
+  // YUV 4:2:0 (even height)
+  const unsigned int height420 = height - 1, size420 = width*height420;
+  ref.assign(4*size420, 0);
+  regularYUV420ToRGBa(data, &ref[0], width, height420);
+  res.assign(4*size420, 0);
+  vpImageConvert::YUV420ToRGBa(data, &res[0], width, height420);
+  success = check(res, ref, "YUV420ToRGBa") && success;
+
+  rgbaToRGB(ref, ref_rgb);
+  res.assign(3*size420, 0);
+  vpImageConvert::YUV420ToRGB(data, &res[0], width, height420);
+  success = check(res, ref_rgb, "YUV420ToRGB") && success;
+
+  // RGB, RGBa, BGR and grey
+  ref.resize(4*size);
+  for (unsigned int i = 0; i < size; i++) {
+    for (unsigned int c = 0; c < 3; c++) {
+      ref[4*i + c] = data[3*i + c];
+    }
+    ref[4*i + 3] = 0;
+  }
+  res.assign(4*size, 1);
+  vpImageConvert::RGBToRGBa(data, &res[0], size);
+  success = check(res, ref, "RGBToRGBa") && success;
+
+  res.assign(4*size, 1);
+  vpImageConvert::RGBToRGBa(data, &res[0], width, height, false);
+  success = check(res, ref, "RGBToRGBa (no flip)") && success;
+
+  for (unsigned int i = 0; i < size; i++) {
+    for (unsigned int c = 0; c < 3; c++) {
+      ref[4*i + c] = data[3*i + 2 - c];
+    }
+  }
+  res.assign(4*size, 1);
+  vpImageConvert::BGRToRGBa(data, &res[0], width, height, false);
+  success = check(res, ref, "BGRToRGBa") && success;
+
+  ref.resize(3*size);
+  for (unsigned int i = 0; i < size; i++) {
+    for (unsigned int c = 0; c < 3; c++) {
+      ref[3*i + c] = data[4*i + c];
+    }
+  }
+  res.assign(3*size, 1);
+  vpImageConvert::RGBaToRGB(data, &res[0], size);
+  success = check(res, ref, "RGBaToRGB") && success;
+
+  ref.resize(4*size);
+  for (unsigned int i = 0; i < 4*size; i++) {
+    ref[i] = data[i/4];
+  }
+  res.assign(4*size, 1);
+  vpImageConvert::GreyToRGBa(data, &res[0], size);
+  success = check(res, ref, "GreyToRGBa") && success;
+
+  ref.resize(3*size);
+  for (unsigned int i = 0; i < 3*size; i++) {
+    ref[i] = data[i/3];
+  }
+  res.assign(3*size, 1);
+  vpImageConvert::GreyToRGB(data, &res[0], size);
+  success = check(res, ref, "GreyToRGB") && success;
+
+  ref.resize(size);
+  for (unsigned int i = 0; i < size; i++) {
+    ref[i] = regularGrey(data[4*i], data[4*i + 1], data[4*i + 2]);
+  }
+  res.assign(size, 1);
+  vpImageConvert::RGBaToGrey(data, &res[0], size);
+  success = check(res, ref, "RGBaToGrey") && success;
+
+  for (unsigned int i = 0; i < size; i++) {
+    ref[i] = regularGrey(data[3*i], data[3*i + 1], data[3*i + 2]);
+  }
+  res.assign(size, 1);
+  vpImageConvert::RGBToGrey(data, &res[0], size);
+  success = check(res, ref, "RGBToGrey") && success;
+
+  // Flipped image: the last line of the source is the first of the destination
+  for (unsigned int i = 0; i < height; i++) {
+    for (unsigned int j = 0; j < width; j++) {
+      const unsigned char *p = data + 3*((height - 1 - i)*width + j);
+      ref[i*width + j] = regularGrey(p[0], p[1], p[2]);
+    }
+  }
+  res.assign(size, 1);
+  vpImageConvert::RGBToGrey(data, &res[0], width, height, true);
+  success = check(res, ref, "RGBToGrey (flip)") && success;
+
+  for (unsigned int i = 0; i < height; i++) {
+    for (unsigned int j = 0; j < width; j++) {
+      const unsigned char *p = data + 3*((height - 1 - i)*width + j);
+      ref[i*width + j] = regularGrey(p[2], p[1], p[0]);
+    }
+  }
+  res.assign(size, 1);
+  vpImageConvert::BGRToGrey(data, &res[0], width, height, true);
+  success = check(res, ref, "BGRToGrey (flip)") && success;
+
+  if (!success) {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testColorConversion ok !" << std::endl;
+  return EXIT_SUCCESS;
+}
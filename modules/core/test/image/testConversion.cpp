@@ -159,9 +159,9 @@ void computeRegularRGBaToGrayscale(const unsigned char* rgba, unsigned char* gre
   unsigned char *pt_output = grey;
 
   while(pt_input != pt_end) {
-    *pt_output = (unsigned char) (0.2126 * (*pt_input)
-      + 0.7152 * (*(pt_input + 1))
-      + 0.0722 * (*(pt_input + 2)) );
+    *pt_output = (unsigned char) ((2126 * (*pt_input)
+      + 7152 * (*(pt_input + 1))
+      + 722 * (*(pt_input + 2)) ) / 10000);
     pt_input += 4;
     pt_output ++;
   }
@@ -173,9 +173,9 @@ void computeRegularRGBToGrayscale(const unsigned char* rgb, unsigned char* grey,
   unsigned char *pt_output = grey;
 
   while(pt_input != pt_end) {
-    *pt_output = (unsigned char) (0.2126 * (*pt_input)
-      + 0.7152 * (*(pt_input + 1))
-      + 0.0722 * (*(pt_input + 2)) );
+    *pt_output = (unsigned char) ((2126 * (*pt_input)
+      + 7152 * (*(pt_input + 1))
+      + 722 * (*(pt_input + 2)) ) / 10000);
     pt_input += 3;
     pt_output ++;
   }
@@ -199,9 +199,9 @@ void computeRegularBGRToGrayscale(unsigned char * bgr, unsigned char * grey,
     line = src;
     for( j=0 ; j < width ; j++)
     {
-      *grey++ = (unsigned char)( 0.2126 * *(line+2)
-         + 0.7152 * *(line+1)
-         + 0.0722 * *(line+0)) ;
+      *grey++ = (unsigned char)( (2126 * *(line+2)
+         + 7152 * *(line+1)
+         + 722 * *(line+0)) / 10000 );
       line+=3;
     }
 
@@ -0,0 +1,185 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the separable filters of vpImageFilter.
+ *
+ *****************************************************************************/
+/*!
+  \example testImageFilter.cpp
+
+  \brief Test that the separable filters of vpImageFilter give the same
+  results than the per-pixel filtering functions, in double and single
+  precision.
+
+*/
+
+#include <iostream>
+#include <stdlib.h>
+
+#include <visp3/core/vpImageFilter.h>
+#include <visp3/core/vpTime.h>
+
+namespace {
+  // Reference filtering based on the per-pixel functions of vpImageFilter
+  void regularFilterX(const vpImage<unsigned char> &I, vpImage<double> &If, const double *filter, unsigned int size)
+  {
+    If.resize(I.getHeight(), I.getWidth());
+    unsigned int half = (size-1)/2;
+    for (unsigned int i = 0; i < I.getHeight(); i++) {
+      for (unsigned int j = 0; j < I.getWidth(); j++) {
+        if (j < half)
+          If[i][j] = vpImageFilter::filterXLeftBorder(I, i, j, filter, size);
+        else if (j >= I.getWidth() - half)
+          If[i][j] = vpImageFilter::filterXRightBorder(I, i, j, filter, size);
+        else
+          If[i][j] = vpImageFilter::filterX(I, i, j, filter, size);
+      }
+    }
+  }
+
+  void regularFilterY(const vpImage<double> &I, vpImage<double> &If, const double *filter, unsigned int size)
+  {
+    If.resize(I.getHeight(), I.getWidth());
+    unsigned int half = (size-1)/2;
+    for (unsigned int i = 0; i < I.getHeight(); i++) {
+      for (unsigned int j = 0; j < I.getWidth(); j++) {
+        if (i < half)
+          If[i][j] = vpImageFilter::filterYTopBorder(I, i, j, filter, size);
+        else if (i >= I.getHeight() - half)
+          If[i][j] = vpImageFilter::filterYBottomBorder(I, i, j, filter, size);
+        else
+          If[i][j] = vpImageFilter::filterY(I, i, j, filter, size);
+      }
+    }
+  }
+
+  void regularGradX(const vpImage<unsigned char> &I, vpImage<double> &dIx, const double *filter, unsigned int size)
+  {
+    dIx.resize(I.getHeight(), I.getWidth(), 0);
+    unsigned int half = (size-1)/2;
+    for (unsigned int i = 0; i < I.getHeight(); i++)
+      for (unsigned int j = half; j < I.getWidth() - half; j++)
+        dIx[i][j] = vpImageFilter::derivativeFilterX(I, i, j, filter, size);
+  }
+
+  void regularGradY(const vpImage<unsigned char> &I, vpImage<double> &dIy)
+  {
+    dIy.resize(I.getHeight(), I.getWidth(), 0);
+    for (unsigned int i = 3; i < I.getHeight() - 3; i++)
+      for (unsigned int j = 0; j < I.getWidth(); j++)
+        dIy[i][j] = vpImageFilter::derivativeFilterY(I, i, j);
+  }
+
+  template<class T>
+  bool check(const vpImage<T> &I, const vpImage<double> &Iref, double tolerance, const std::string &name)
+  {
+    if (I.getHeight() != Iref.getHeight() || I.getWidth() != Iref.getWidth()) {
+      std::cerr << name << ": wrong size" << std::endl;
+      return false;
+    }
+    double max_error = 0;
+    for (unsigned int i = 0; i < I.getSize(); i++)
+      max_error = vpMath::maximum(max_error, std::fabs(I.bitmap[i] - Iref.bitmap[i]));
+    std::cout << name << ": max error " << max_error << std::endl;
+    if (max_error > tolerance) {
+      std::cerr << name << ": max error above " << tolerance << std::endl;
+      return false;
+    }
+    return true;
+  }
+}
+
+int main()
+{
+  try {
+    bool success = true;
+    const unsigned int size = 7;
+
+    vpImage<unsigned char> I(483, 641);
+    srand(0);
+    for (unsigned int i = 0; i < I.getHeight(); i++)
+      for (unsigned int j = 0; j < I.getWidth(); j++)
+        I[i][j] = (unsigned char)((i + 2*j + rand() % 32) % 256);
+
+    double fg[(size+1)/2], fd[(size+1)/2];
+    float fgf[(size+1)/2], fdf[(size+1)/2];
+    vpImageFilter::getGaussianKernel(fg, size);
+    vpImageFilter::getGaussianDerivativeKernel(fd, size);
+    vpImageFilter::getGaussianKernel(fgf, size);
+    vpImageFilter::getGaussianDerivativeKernel(fdf, size);
+
+    // Reference
+    vpImage<double> Ix_ref, GI_ref, dIx_ref, dIy_ref;
+    regularFilterX(I, Ix_ref, fg, size);
+    regularFilterY(Ix_ref, GI_ref, fg, size);
+    regularGradX(I, dIx_ref, fd, size);
+    regularGradY(I, dIy_ref);
+
+    // Double precision: the operations are done in the same order
+    vpImage<double> GI, dI;
+    double t = vpTime::measureTimeMs();
+    vpImageFilter::gaussianBlur(I, GI, size);
+    std::cout << "gaussianBlur() vpImage<double>: " << vpTime::measureTimeMs() - t << " ms" << std::endl;
+    success = check(GI, GI_ref, 0, "gaussianBlur() vpImage<double>") && success;
+    vpImageFilter::getGradX(I, dI, fd, size);
+    success = check(dI, dIx_ref, 0, "getGradX() vpImage<double>") && success;
+    vpImageFilter::getGradY(I, dI);
+    success = check(dI, dIy_ref, 0, "getGradY() vpImage<double>") && success;
+
+    // Single precision
+    vpImage<float> GIf, dIf;
+    t = vpTime::measureTimeMs();
+    vpImageFilter::gaussianBlur(I, GIf, size);
+    std::cout << "gaussianBlur() vpImage<float>: " << vpTime::measureTimeMs() - t << " ms" << std::endl;
+    success = check(GIf, GI_ref, 1e-3, "gaussianBlur() vpImage<float>") && success;
+    vpImageFilter::getGradX(I, dIf, fdf, size);
+    success = check(dIf, dIx_ref, 1e-3, "getGradX() vpImage<float>") && success;
+    vpImageFilter::getGradY(I, dIf);
+    success = check(dIf, dIy_ref, 1e-3, "getGradY() vpImage<float>") && success;
+
+    // Fixed point
+    vpImage<unsigned char> GIc;
+    t = vpTime::measureTimeMs();
+    vpImageFilter::gaussianBlur(I, GIc, size);
+    std::cout << "gaussianBlur() vpImage<unsigned char>: " << vpTime::measureTimeMs() - t << " ms" << std::endl;
+    success = check(GIc, GI_ref, 1.5, "gaussianBlur() vpImage<unsigned char>") && success;
+
+    if (!success) {
+      return EXIT_FAILURE;
+    }
+
+    std::cout << "testImageFilter ok !" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,155 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test vpImage memory management and vpImagePool.
+ *
+ *****************************************************************************/
+/*!
+  \example testImagePool.cpp
+
+  \brief Test the alignment of the image bitmap, the wrapping of an external
+  buffer by vpImage and the reuse of the buffers of vpImagePool.
+
+*/
+
+#include <iostream>
+#include <stdlib.h>
+
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpImagePool.h>
+
+namespace {
+  bool check(bool condition, const std::string &msg)
+  {
+    if (!condition)
+      std::cerr << "Failed: " << msg << std::endl;
+    return condition;
+  }
+
+  template<class Type>
+  bool isAligned(const vpImage<Type> &I)
+  {
+    return ((size_t)I.bitmap % 64) == 0;
+  }
+}
+
+int main()
+{
+  try {
+    bool success = true;
+
+    // Aligned allocation
+    vpImage<unsigned char> I(3, 5, 7);
+    vpImage<vpRGBa> Irgba(7, 3, vpRGBa(1, 2, 3, 4));
+    success = check(isAligned(I) && isAligned(Irgba), "aligned bitmap") && success;
+    success = check(I.isBitmapOwner(), "bitmap owned by the image") && success;
+    I.resize(13, 11, 2);
+    success = check(isAligned(I) && I[12][10] == 2, "aligned bitmap after resize") && success;
+
+    // Copy reuses the memory of an image of the same size
+    vpImage<unsigned char> J(13, 11, 5);
+    const unsigned char *bitmap = J.bitmap;
+    J = I;
+    success = check(J.bitmap == bitmap && J[12][10] == 2, "copy without reallocation") && success;
+
+    // Wrapping of an external buffer
+    unsigned char buffer[4*6];
+    for (unsigned int i = 0; i < 4*6; i++)
+      buffer[i] = (unsigned char)i;
+    {
+      vpImage<unsigned char> W;
+      W.wrap(buffer, 4, 6);
+      success = check(W.bitmap == buffer && !W.isBitmapOwner(), "wrapping without copy") && success;
+      success = check(W[3][5] == 23, "wrapped pixel access") && success;
+      W[1][2] = 100;
+      W.resize(4, 6);
+      success = check(W.bitmap == buffer, "resize to the same size keeps the buffer") && success;
+      W = vpImage<unsigned char>(4, 6, 50);
+      success = check(W.bitmap == buffer && buffer[0] == 50, "copy in the wrapped buffer") && success;
+      W.resize(2, 2);
+      success = check(W.bitmap != buffer && W.isBitmapOwner() && isAligned(W), "resize to another size allocates") && success;
+    } // The buffer must not be freed here
+    success = check(buffer[23] == 50, "buffer still valid") && success;
+
+    // Ownership of a buffer allocated with new[] given to the constructor
+    {
+      unsigned char *adopted = new unsigned char[4*6];
+      vpImage<unsigned char> A(adopted, 4, 6);
+      success = check(A.bitmap == adopted && A.isBitmapOwner(), "buffer adopted without copy") && success;
+      A.init(new unsigned char[2*3], 2, 3); // The adopted buffer is freed with delete[]
+      success = check(A.isBitmapOwner() && A.getSize() == 6, "adopted buffer replaced") && success;
+    }
+
+#ifdef VISP_HAVE_CPP11_COMPATIBILITY
+    // Move semantics
+    {
+      vpImage<unsigned char> M;
+      M.wrap(buffer, 4, 6);
+      vpImage<unsigned char> N(std::move(M));
+      success = check(N.bitmap == buffer && !N.isBitmapOwner() && M.bitmap == NULL, "move constructor") && success;
+      M = std::move(I);
+      success = check(M.getHeight() == 13 && M[12][10] == 2 && I.getSize() == 0, "move operator") && success;
+      I = M;
+    }
+#endif
+
+    // Pool of buffers
+    vpImagePool<unsigned char> pool(2, 480, 640);
+    vpImage<unsigned char> I1, I2, I3;
+    success = check(pool.acquire(I1) && pool.acquire(I2), "acquire two buffers") && success;
+    success = check(!pool.acquire(I3), "no more buffer") && success;
+    success = check(I1.getHeight() == 480 && I1.getWidth() == 640 && !I1.isBitmapOwner() && isAligned(I1),
+                    "acquired image") && success;
+    const unsigned char *bitmap1 = I1.bitmap;
+    pool.release(I1);
+    success = check(I1.bitmap == NULL && pool.getNbAvailableBuffers() == 1, "release") && success;
+    success = check(pool.acquire(I3) && I3.bitmap == bitmap1, "buffer reused") && success;
+    try {
+      pool.release(I);
+      success = check(false, "release of an image that is not in the pool") && success;
+    }
+    catch(const vpException &) {
+    }
+    pool.release(I2);
+    pool.release(I3);
+    success = check(pool.getNbAvailableBuffers() == 2, "all buffers released") && success;
+
+    if (!success) {
+      return EXIT_FAILURE;
+    }
+
+    std::cout << "testImagePool ok !" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
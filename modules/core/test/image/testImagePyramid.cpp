@@ -0,0 +1,143 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test vpImagePyramid.
+ *
+ *****************************************************************************/
+/*!
+  \example testImagePyramid.cpp
+
+  \brief Test that the levels of vpImagePyramid are the same than the ones
+  obtained by successive calls to vpImageFilter::getGaussPyramidal() or by
+  subsampling.
+
+*/
+
+#include <iostream>
+#include <sstream>
+#include <stdlib.h>
+
+#include <visp3/core/vpImageFilter.h>
+#include <visp3/core/vpImagePyramid.h>
+#include <visp3/core/vpTime.h>
+
+namespace {
+  bool check(const vpImage<unsigned char> &I, const vpImage<unsigned char> &Iref, const std::string &name)
+  {
+    if (I.getHeight() != Iref.getHeight() || I.getWidth() != Iref.getWidth()) {
+      std::cerr << name << ": wrong size " << I.getHeight() << "x" << I.getWidth()
+                << " instead of " << Iref.getHeight() << "x" << Iref.getWidth() << std::endl;
+      return false;
+    }
+    for (unsigned int i = 0; i < I.getSize(); i++) {
+      if (I.bitmap[i] != Iref.bitmap[i]) {
+        std::cerr << name << ": wrong value at index " << i << std::endl;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool testSize(unsigned int height, unsigned int width, unsigned int nbLevels)
+  {
+    vpImage<unsigned char> I(height, width);
+    for (unsigned int i = 0; i < I.getSize(); i++)
+      I.bitmap[i] = (unsigned char)(rand() % 256);
+
+    vpImagePyramid gaussian(vpImagePyramid::GAUSSIAN), subsampling(vpImagePyramid::SUBSAMPLING);
+    gaussian.build(I, nbLevels);
+    subsampling.build(I, nbLevels);
+
+    bool success = (gaussian.getNbLevels() == nbLevels && subsampling.getNbLevels() == nbLevels);
+    vpImage<unsigned char> Igauss = I, Isub = I;
+    for (unsigned int l = 1; l < nbLevels; l++) {
+      vpImage<unsigned char> Iprev = Igauss;
+      vpImageFilter::getGaussPyramidal(Iprev, Igauss);
+
+      Iprev = Isub;
+      Isub.resize(Iprev.getHeight()/2, Iprev.getWidth()/2);
+      for (unsigned int i = 0; i < Isub.getHeight(); i++)
+        for (unsigned int j = 0; j < Isub.getWidth(); j++)
+          Isub[i][j] = Iprev[2*i][2*j];
+
+      std::ostringstream name;
+      name << height << "x" << width << " level " << l;
+      success = check(gaussian[l], Igauss, "Gaussian " + name.str()) && success;
+      success = check(subsampling[l], Isub, "Subsampling " + name.str()) && success;
+    }
+    return success;
+  }
+}
+
+int main()
+{
+  try {
+    bool success = true;
+    srand(0);
+
+    success = testSize(483, 641, 4) && success;
+    success = testSize(480, 640, 3) && success;
+    success = testSize(11, 7, 3) && success;
+    success = testSize(5, 3, 2) && success;
+
+    // Rebuilding a pyramid of the same size doesn't allocate memory
+    vpImage<unsigned char> I(480, 640, 128);
+    vpImagePyramid pyramid;
+    pyramid.build(I, 4);
+    const unsigned char *bitmap = pyramid[3].bitmap;
+    double t = vpTime::measureTimeMs();
+    pyramid.build(I, 4);
+    std::cout << "Gaussian pyramid of 4 levels: " << vpTime::measureTimeMs() - t << " ms" << std::endl;
+    if (pyramid[3].bitmap != bitmap) {
+      std::cerr << "The levels were reallocated" << std::endl;
+      success = false;
+    }
+
+    // Access to a level that was not built
+    try {
+      pyramid[4];
+      std::cerr << "No exception thrown when accessing level 4" << std::endl;
+      success = false;
+    }
+    catch(const vpException &) {
+    }
+
+    if (!success) {
+      return EXIT_FAILURE;
+    }
+
+    std::cout << "testImagePyramid ok !" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,191 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test vpImageQueue.
+ *
+ *****************************************************************************/
+/*!
+  \example testImageQueue.cpp
+
+  \brief Test the drop policies and the counters of vpImageQueue, and the
+  transfer of frames without copy from an acquisition thread.
+
+*/
+
+#include <iostream>
+#include <stdlib.h>
+
+#include <visp3/core/vpImageQueue.h>
+#include <visp3/core/vpThread.h>
+
+namespace {
+  bool check(bool condition, const std::string &msg)
+  {
+    if (!condition)
+      std::cerr << "Failed: " << msg << std::endl;
+    return condition;
+  }
+
+  // Push a frame whose pixels and timestamp are the frame number
+  bool pushFrame(vpImageQueue<unsigned char> &queue, unsigned int frame)
+  {
+    queue.getWriteImage() = (unsigned char)(frame % 256);
+    return queue.push((double)frame);
+  }
+
+  // The pixels of the frame have to match its timestamp
+  bool isValidFrame(const vpImage<unsigned char> &I, double timestamp)
+  {
+    const unsigned char value = (unsigned char)((unsigned int)timestamp % 256);
+    return I[0][0] == value && I[I.getHeight()-1][I.getWidth()-1] == value;
+  }
+
+#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
+  const unsigned int nbFrames = 2000;
+
+  vpThread::Return produce(vpThread::Args args)
+  {
+    vpImageQueue<unsigned char> &queue = *((vpImageQueue<unsigned char> *)args);
+    for (unsigned int frame = 1; frame <= nbFrames; frame++) {
+      pushFrame(queue, frame);
+      if (frame % 100 == 0)
+        vpTime::sleepMs(1);
+    }
+    return 0;
+  }
+
+  bool checkThreads(const vpImageQueue<unsigned char>::vpDropPolicy policy)
+  {
+    bool success = true;
+    vpImageQueue<unsigned char> queue(3, 48, 64, policy);
+    vpThread producer((vpThread::Fn)produce, (vpThread::Args)&queue);
+
+    vpImage<unsigned char> I;
+    double timestamp, previous = 0;
+    unsigned int nbPopped = 0;
+    bool valid = true;
+    while (queue.pop(I, timestamp, 1000)) {
+      valid = valid && timestamp > previous && isValidFrame(I, timestamp);
+      previous = timestamp;
+      nbPopped++;
+      if (nbPopped % 50 == 0)
+        vpTime::sleepMs(2); // Slow consumer
+      queue.release(I);
+    }
+    producer.join();
+
+    success = check(valid, "frames in order and not modified while read") && success;
+    success = check(queue.getNbPushedFrames() == nbFrames, "all frames pushed") && success;
+    success = check(nbPopped + queue.getNbDroppedFrames() == nbFrames, "each frame popped or dropped") && success;
+    if (policy == vpImageQueue<unsigned char>::DROP_OLDEST)
+      success = check(previous == nbFrames, "last frame popped") && success;
+    std::cout << (policy == vpImageQueue<unsigned char>::DROP_OLDEST ? "Drop oldest: " : "Drop newest: ")
+              << nbPopped << " frames popped, " << queue.getNbDroppedFrames() << " dropped" << std::endl;
+    return success;
+  }
+#endif
+}
+
+int main()
+{
+  try {
+    bool success = true;
+    vpImage<unsigned char> I;
+    double timestamp;
+
+    // Drop oldest
+    vpImageQueue<unsigned char> queue(2, 4, 6, vpImageQueue<unsigned char>::DROP_OLDEST);
+    success = check(!queue.pop(I, timestamp), "empty queue") && success;
+    success = check(pushFrame(queue, 1), "push in an empty queue") && success;
+    const unsigned char *bitmap = queue.getWriteImage().bitmap;
+    success = check(pushFrame(queue, 2), "push in a queue with room") && success;
+    success = check(!pushFrame(queue, 3) && queue.getNbDroppedFrames() == 1, "push in a full queue") && success;
+    success = check(queue.getNbQueuedFrames() == 2 && queue.getNbPushedFrames() == 3, "counters") && success;
+    success = check(queue.pop(I, timestamp) && timestamp == 2 && isValidFrame(I, timestamp), "oldest frame dropped") && success;
+    success = check(I.bitmap == bitmap && !I.isBitmapOwner(), "frame popped without copy") && success;
+    queue.release(I);
+    success = check(I.bitmap == NULL, "release") && success;
+    success = check(queue.pop(I, timestamp) && timestamp == 3 && isValidFrame(I, timestamp), "newest frame kept") && success;
+    // The frame of the previous pop() is released by the next one
+    success = check(!queue.pop(I, timestamp, 5) && I.bitmap == NULL, "timeout on an empty queue") && success;
+
+    // Drop newest
+    queue.init(2, 4, 6, vpImageQueue<unsigned char>::DROP_NEWEST);
+    for (unsigned int frame = 1; frame <= 5; frame++)
+      pushFrame(queue, frame);
+    success = check(queue.getNbDroppedFrames() == 3 && queue.getNbQueuedFrames() == 2, "newest frames dropped") && success;
+    success = check(queue.pop(I, timestamp) && timestamp == 1 && isValidFrame(I, timestamp), "first frame kept") && success;
+    success = check(pushFrame(queue, 6), "room made by pop") && success;
+    success = check(queue.pop(I, timestamp) && timestamp == 2, "second frame kept") && success;
+    success = check(queue.pop(I, timestamp) && timestamp == 6 && isValidFrame(I, timestamp), "frame pushed after pop") && success;
+
+    // Misuse
+    vpImage<unsigned char> J(4, 6);
+    try {
+      queue.pop(J, timestamp);
+      success = check(false, "pop before the release of the previous frame") && success;
+    }
+    catch(const vpException &) {
+    }
+    try {
+      queue.release(J);
+      success = check(false, "release of an image that is not in the queue") && success;
+    }
+    catch(const vpException &) {
+    }
+    queue.release(I);
+    try {
+      queue.getWriteImage().resize(2, 2);
+      queue.push(7);
+      success = check(false, "push of an image of another size") && success;
+    }
+    catch(const vpException &) {
+    }
+    success = check(pushFrame(queue, 8) && queue.pop(I, timestamp) && timestamp == 8, "push after a size error") && success;
+    queue.release(I);
+
+#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
+    // Acquisition thread
+    success = checkThreads(vpImageQueue<unsigned char>::DROP_OLDEST) && success;
+    success = checkThreads(vpImageQueue<unsigned char>::DROP_NEWEST) && success;
+#endif
+
+    if (!success) {
+      return EXIT_FAILURE;
+    }
+
+    std::cout << "testImageQueue ok !" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
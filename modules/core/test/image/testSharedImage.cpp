@@ -0,0 +1,247 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test vpSharedImageWriter and vpSharedImageReader.
+ *
+ *****************************************************************************/
+/*!
+  \example testSharedImage.cpp
+
+  \brief Test the transport of images through shared memory between a writer
+  and readers of the same process and of another process.
+
+*/
+
+#include <iostream>
+#include <sstream>
+#include <stdlib.h>
+
+#include <visp3/core/vpSharedImageReader.h>
+#include <visp3/core/vpSharedImageWriter.h>
+
+#if defined(VISP_HAVE_PTHREAD) && !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <visp3/core/vpFrameGrabberException.h>
+
+namespace {
+  bool check(bool condition, const std::string &msg)
+  {
+    if (!condition)
+      std::cerr << "Failed: " << msg << std::endl;
+    return condition;
+  }
+
+  // Publish a frame whose pixels are the frame number
+  unsigned long writeFrame(vpSharedImageWriter &writer, vpImage<unsigned char> &I, unsigned int frame)
+  {
+    I = (unsigned char)(frame % 256);
+    return writer.write(I, (double)frame);
+  }
+
+  bool isValidFrame(const vpImage<unsigned char> &I, unsigned int frame)
+  {
+    const unsigned char value = (unsigned char)(frame % 256);
+    return I.getSize() > 0 && I[0][0] == value && I[I.getHeight()-1][I.getWidth()-1] == value;
+  }
+
+  // Read frames in another process until the writer is closed
+  int readInChild(const std::string &name)
+  {
+    vpSharedImageReader reader(name);
+    vpImage<unsigned char> I;
+    reader.setTimeout(5000);
+    reader.open(I);
+    unsigned int nbFrames = 0;
+    bool valid = true;
+    try {
+      for (;;) {
+        reader.acquire(I);
+        valid = valid && isValidFrame(I, (unsigned int)reader.getTimestamp());
+        nbFrames++;
+      }
+    }
+    catch(const vpFrameGrabberException &) {
+    }
+    return (valid && nbFrames > 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+
+  // Acquire a frame in another process and die without releasing it
+  void holdInChild(const std::string &name)
+  {
+    vpSharedImageReader reader(name);
+    vpImage<unsigned char> I;
+    reader.open(I);
+    reader.acquire(I);
+    _exit(isValidFrame(I, 1) ? EXIT_SUCCESS : EXIT_FAILURE);
+  }
+}
+
+int main()
+{
+  try {
+    bool success = true;
+    std::ostringstream os;
+    os << "/visp_testSharedImage_" << getpid();
+    const std::string name = os.str();
+
+    vpImage<unsigned char> I(48, 64), J;
+    vpImage<vpRGBa> C;
+    vpSharedImageReader reader1(name), reader2(name);
+    try {
+      reader1.open(J);
+      success = check(false, "open a segment that doesn't exist") && success;
+    }
+    catch(const vpFrameGrabberException &) {
+    }
+
+    vpSharedImageWriter writer;
+    writer.open(name, I, 4);
+    reader1.open(J);
+    reader2.open(C);
+    success = check(reader1.getHeight() == 48 && reader1.getWidth() == 64, "size of the images") && success;
+
+    // Timeout
+    reader1.setTimeout(10);
+    try {
+      reader1.acquire(J);
+      success = check(false, "timeout without frame") && success;
+    }
+    catch(const vpFrameGrabberException &) {
+    }
+
+    // Zero copy read of the latest frame
+    success = check(writeFrame(writer, I, 1) == 1, "first sequence number") && success;
+    reader1.acquire(J);
+    success = check(isValidFrame(J, 1) && !J.isBitmapOwner() && reader1.getSequence() == 1
+                    && reader1.getTimestamp() == 1, "zero copy read") && success;
+    writeFrame(writer, I, 2);
+    writeFrame(writer, I, 3);
+    reader1.acquire(J);
+    success = check(isValidFrame(J, 3) && reader1.getSequence() == 3 && reader1.getNbSkippedFrames() == 1,
+                    "latest frame read") && success;
+
+    // Conversion
+    reader2.acquire(C);
+    success = check(C.isBitmapOwner() && C[47][63].R == 3 && reader2.getSequence() == 3, "converted read") && success;
+
+    // The frame read is not overwritten
+    for (unsigned int frame = 4; frame <= 20; frame++)
+      success = check(writeFrame(writer, I, frame) == frame, "write while a frame is read") && success;
+    success = check(isValidFrame(J, 3), "frame kept while it is read") && success;
+    reader1.acquire(J);
+    success = check(isValidFrame(J, 20) && reader1.getNbSkippedFrames() == 17, "frames skipped") && success;
+
+    // Zero copy write
+    vpImage<unsigned char> W;
+    success = check(writer.getWriteImage(W) && !W.isBitmapOwner(), "zero copy write") && success;
+    W = 21;
+    success = check(writer.push(21) == 21, "push") && success;
+    reader1.acquire(J);
+    success = check(isValidFrame(J, 21), "frame written without copy") && success;
+
+    // The slot of a reader that dies while it holds a frame is reused, not
+    // the slot of a reader that is alive
+    {
+      vpSharedImageWriter writer2;
+      writer2.open(name + "_2", I, 2);
+      writeFrame(writer2, I, 1);
+      pid_t child = fork();
+      if (child == 0) {
+        holdInChild(name + "_2");
+      }
+      int status = EXIT_FAILURE;
+      waitpid(child, &status, 0);
+      success = check(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS, "reader that dies") && success;
+      success = check(writeFrame(writer2, I, 2) == 2, "write in the slot that is not held") && success;
+      success = check(writeFrame(writer2, I, 3) == 3, "write in the slot of a dead reader") && success;
+
+      vpSharedImageReader reader3(name + "_2");
+      vpImage<unsigned char> K;
+      reader3.open(K);
+      reader3.acquire(K);
+      success = check(writeFrame(writer2, I, 4) == 4, "write in the slot that is not read") && success;
+      success = check(writeFrame(writer2, I, 5) == 0 && writer2.releaseDeadReaders() == 0,
+                      "slot of a reader that is alive kept") && success;
+      success = check(isValidFrame(K, 3), "frame kept while it is read") && success;
+      reader3.close();
+      writer2.close();
+    }
+
+    // Reader in another process
+    pid_t child = fork();
+    if (child == 0) {
+      exit(readInChild(name));
+    }
+    vpTime::wait(200); // Let the child open the segment
+    for (unsigned int frame = 22; frame < 300; frame++) {
+      writeFrame(writer, I, frame);
+      vpTime::sleepMs(1);
+    }
+    writer.close();
+    int status = EXIT_FAILURE;
+    waitpid(child, &status, 0);
+    success = check(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS, "reader in another process") && success;
+
+    // The last frame stays readable, but the reader can't wait for a closed writer
+    reader1.acquire(J);
+    success = check(isValidFrame(J, 299), "last frame read after the writer is closed") && success;
+    try {
+      reader1.acquire(J);
+      success = check(false, "read after the writer is closed") && success;
+    }
+    catch(const vpFrameGrabberException &) {
+      success = check(J.bitmap == NULL, "image detached when the read fails") && success;
+    }
+    reader1.close();
+    reader2.close();
+
+    if (!success) {
+      return EXIT_FAILURE;
+    }
+
+    std::cout << "testSharedImage ok !" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
+
+#else
+int main()
+{
+  std::cout << "Shared memory images are not available on this system" << std::endl;
+  return 0;
+}
+#endif
@@ -274,6 +274,43 @@ int main(int argc, const char ** argv)
     std::cout<<"Time for 100 undistortion (ms): "<< endtime - begintime
             << std::endl;
 
+    // Same undistortion with a precomputed map, with a barrel and a
+    // pincushion distortion
+    const double kuds[2] = { -0.17, 0.17 };
+    for (unsigned int k = 0; k < 2; k++) {
+      vpCameraParameters cam_k;
+      cam_k.initPersProjWithDistortion(600,600,192,144,kuds[k],-kuds[k]);
+#if defined BW
+      vpImage<unsigned char> Uref, Umap;
+#elif defined COLOR
+      vpImage<vpRGBa> Uref, Umap;
+#endif
+      vpImageTools::undistort(I, cam_k, Uref);
+
+      vpUndistortMap map;
+      vpImageTools::initUndistortMap(cam_k, I.getWidth(), I.getHeight(), map);
+      begintime = vpTime::measureTimeMs();
+      for(unsigned int i=0;i<100;i++)
+        vpImageTools::undistort(I, map, Umap);
+      endtime = vpTime::measureTimeMs();
+
+      std::cout<<"Time for 100 undistortion with a map (ms), kud = " << kuds[k] << ": "
+              << endtime - begintime << std::endl;
+
+      for (unsigned int i=0; i < Uref.getSize(); i++) {
+#if defined BW
+        if (std::abs((int)Uref.bitmap[i] - (int)Umap.bitmap[i]) > 2) {
+#elif defined COLOR
+        if (std::abs((int)Uref.bitmap[i].R - (int)Umap.bitmap[i].R) > 2
+            || std::abs((int)Uref.bitmap[i].G - (int)Umap.bitmap[i].G) > 2
+            || std::abs((int)Uref.bitmap[i].B - (int)Umap.bitmap[i].B) > 2) {
+#endif
+          std::cerr << "Undistortion with a map differs at pixel " << i << ", kud = " << kuds[k] << std::endl;
+          return 1;
+        }
+      }
+    }
+
     // Write the undistorted image on the disk
 #if defined BW
     filename = vpIoTools::path( vpIoTools::createFilePath(opath, "Klimt_undistorted.pgm") );
@@ -46,6 +46,7 @@
 #include <limits>
 
 #include <visp3/core/vpTranslationVector.h>
+#include <visp3/core/vpFixedArray2D.h>
 
 template<typename Type>
 bool test(const std::string &s, const vpArray2D<Type> &A, const std::vector<Type> &bench)
@@ -158,6 +159,50 @@ int main()
     if (test("A", A, bench3) == false)
       return err;
   }
+  // Test fixed size array
+  {
+    vpFixedArray2D<double, 2, 3> A;
+    std::vector<double> bench1(6, 0);
+    if (test("A", A, bench1) == false)
+      return err;
+
+    std::vector<double> bench2(6);
+    for(unsigned int i=0; i<2; i++) {
+      for(unsigned int j=0; j<3; j++) {
+        A[i][j] = (double)(i+j);
+        bench2[i*3+j] = (double)(i+j);
+      }
+    }
+    vpFixedArray2D<double, 2, 3> B(A), C;
+    C = A;
+    vpArray2D<double> D(A);
+    if (test("B", B, bench2) == false || test("C", C, bench2) == false || test("D", D, bench2) == false)
+      return err;
+    B[0][0] = 10.;
+    if (test("A", A, bench2) == false)
+      return err;
+
+    // Same size resize is allowed, but not a size change
+    A.resize(2, 3, false);
+    if (test("A", A, bench2) == false)
+      return err;
+    try {
+      A.resize(3, 2);
+      std::cout << "Test fails: a fixed size array was resized" << std::endl;
+      return err;
+    }
+    catch(vpException &) {
+    }
+    if (test("A", A, bench2) == false)
+      return err;
+
+    // Copy from a dynamic array of the same size
+    vpArray2D<double> E(2, 3, 1.);
+    A = E;
+    std::vector<double> bench3(6, 1);
+    if (test("A", A, bench3) == false)
+      return err;
+  }
   std::cout << "All tests succeed" << std::endl;
   return 0;
 }
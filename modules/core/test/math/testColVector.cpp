@@ -47,6 +47,7 @@
 #include <visp3/core/vpMath.h>
 #include <visp3/core/vpColVector.h>
 #include <visp3/core/vpGaussRand.h>
+#include <visp3/core/vpSubColVector.h>
 
 
 bool test(const std::string &s, const vpColVector &v, const std::vector<double> &bench)
@@ -414,6 +415,46 @@ int main()
     }
   }
 
+  {
+    vpColVector a(3), b(3);
+    a[0] = 1; a[1] = 2; a[2] = 3;
+    b[0] = -2; b[1] = 5; b[2] = 4;
+    std::vector<double> bench(3);
+    bench[0] = -7; bench[1] = -10; bench[2] = 9;
+    if (test("crossProd(a, b)", vpColVector::crossProd(a, b), bench) == false)
+      return -1;
+    bench[0] = -2; bench[1] = 6; bench[2] = 6;
+    a += b;
+    a -= 2*vpColVector(3, 0.5);
+    if (test("a", a, bench) == false)
+      return -1;
+  }
+
+#ifdef VISP_HAVE_CPP11_COMPATIBILITY
+  {
+    // Move semantics
+    vpColVector v(5, 2.);
+    const double *ptr = v.data;
+    vpColVector w(std::move(v));
+    if (w.data != ptr || v.size() != 0 || w[4] != 2.) {
+      std::cerr << "Problem with the move constructor" << std::endl;
+      return -1;
+    }
+    v = std::move(w);
+    if (v.data != ptr || w.size() != 0 || v[4] != 2.) {
+      std::cerr << "Problem with the move operator" << std::endl;
+      return -1;
+    }
+    // A sub-vector points toward its parent and has to be copied
+    vpSubColVector s(v, 1, 3);
+    w = std::move(s);
+    if (w.data == s.data || w.size() != 3 || s[2] != 2.) {
+      std::cerr << "Problem with the move of a sub-vector" << std::endl;
+      return -1;
+    }
+  }
+#endif
+
   std::cout << "\nAll tests succeed" << std::endl;
   return 0;
 }
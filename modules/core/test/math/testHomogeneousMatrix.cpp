@@ -0,0 +1,130 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the products and inverses of the fixed size transformation matrices.
+ *
+ *****************************************************************************/
+/*!
+  \example testHomogeneousMatrix.cpp
+
+  \brief Test the products and inverses of vpRotationMatrix, vpHomogeneousMatrix,
+  vpVelocityTwistMatrix and vpForceTwistMatrix against vpMatrix.
+
+*/
+
+#include <iostream>
+#include <cmath>
+#include <stdlib.h>
+
+#include <visp3/core/vpForceTwistMatrix.h>
+#include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/core/vpMatrix.h>
+#include <visp3/core/vpRotationMatrix.h>
+#include <visp3/core/vpVelocityTwistMatrix.h>
+
+namespace {
+  bool equal(const vpArray2D<double> &A, const vpArray2D<double> &B, const std::string &msg)
+  {
+    if (A.getRows() != B.getRows() || A.getCols() != B.getCols()) {
+      std::cerr << "Failed: " << msg << ": bad size" << std::endl;
+      return false;
+    }
+    for (unsigned int i = 0; i < A.getRows(); i++)
+      for (unsigned int j = 0; j < A.getCols(); j++)
+        if (std::fabs(A[i][j] - B[i][j]) > 1e-12) {
+          std::cerr << "Failed: " << msg << ": (" << i << "," << j << ") " << A[i][j] << " != " << B[i][j] << std::endl;
+          return false;
+        }
+    return true;
+  }
+
+  vpMatrix toMatrix(const vpArray2D<double> &A)
+  {
+    vpMatrix M(A.getRows(), A.getCols());
+    for (unsigned int i = 0; i < A.getRows(); i++)
+      for (unsigned int j = 0; j < A.getCols(); j++)
+        M[i][j] = A[i][j];
+    return M;
+  }
+}
+
+int main()
+{
+  bool ok = true;
+
+  vpHomogeneousMatrix aMb(0.1, -0.2, 0.5, vpMath::rad(10), vpMath::rad(-20), vpMath::rad(45));
+  vpHomogeneousMatrix bMc(-0.3, 0.4, 1.2, vpMath::rad(-30), vpMath::rad(5), vpMath::rad(80));
+
+  // Rotation matrices
+  vpRotationMatrix aRb(aMb), bRc(bMc);
+  ok &= equal(aRb * bRc, toMatrix(aRb) * toMatrix(bRc), "R1*R2");
+  ok &= equal(aRb.inverse(), toMatrix(aRb).t(), "R^-1");
+  vpTranslationVector t(1., -2., 3.);
+  ok &= equal(aRb * t, toMatrix(aRb) * vpColVector(t), "R*t");
+
+  // Homogeneous matrices
+  vpHomogeneousMatrix aMc = aMb * bMc;
+  ok &= equal(aMc, toMatrix(aMb) * toMatrix(bMc), "M1*M2");
+  ok &= equal(aMb.inverse(), toMatrix(aMb).pseudoInverse(), "M^-1");
+  vpHomogeneousMatrix M = aMb;
+  M *= bMc;
+  ok &= equal(M, aMc, "M1*=M2");
+  vpHomogeneousMatrix Mi;
+  aMc.inverse(Mi);
+  ok &= equal(Mi * aMc, vpHomogeneousMatrix(), "M^-1*M");
+
+  // Twist matrices
+  vpVelocityTwistMatrix aVb(aMb), bVc(bMc), aVc(aMc);
+  ok &= equal(aVb * bVc, toMatrix(aVb) * toMatrix(bVc), "V1*V2");
+  ok &= equal(aVb * bVc, aVc, "V(M1*M2)");
+  ok &= equal(aVb.inverse(), toMatrix(aVb).pseudoInverse(), "V^-1");
+  ok &= equal(aVb.inverse(), vpVelocityTwistMatrix(aMb.inverse()), "V(M^-1)");
+
+  vpForceTwistMatrix aFb(aMb), bFc(bMc), aFc(aMc);
+  ok &= equal(aFb * bFc, toMatrix(aFb) * toMatrix(bFc), "F1*F2");
+  ok &= equal(aFb * bFc, aFc, "F(M1*M2)");
+
+  // The fixed size matrices can't be resized
+  try {
+    vpArray2D<double> &A = aMb;
+    A.resize(3, 3);
+    std::cerr << "Failed: an homogeneous matrix was resized" << std::endl;
+    ok = false;
+  }
+  catch(vpException &) {
+  }
+
+  if (!ok) {
+    std::cerr << "Transformation matrices test failed" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Transformation matrices test succeed" << std::endl;
+  return EXIT_SUCCESS;
+}
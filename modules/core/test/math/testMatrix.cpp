@@ -47,6 +47,7 @@
 #include <visp3/core/vpHomogeneousMatrix.h>
 #include <visp3/core/vpVelocityTwistMatrix.h>
 #include <visp3/core/vpGEMM.h>
+#include <visp3/core/vpSubMatrix.h>
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -301,6 +302,33 @@ main()
       vpGEMM(M, N, 2, C, 3, D, VP_GEMM_A_T);
       std::cout << D << std::endl;
 
+#ifdef VISP_HAVE_CPP11_COMPATIBILITY
+      std::cout << "------------------------" << std::endl;
+      std::cout << "--- TEST move semantics " << std::endl;
+      std::cout << "------------------------" << std::endl;
+      {
+        vpMatrix A(3, 4, 2.);
+        const double *ptr = A.data;
+        vpMatrix B(std::move(A));
+        if (B.data != ptr || A.size() != 0 || B[2][3] != 2.) {
+          std::cout << "Test fails: move constructor" << std::endl;
+          return 1;
+        }
+        A = std::move(B);
+        if (A.data != ptr || B.size() != 0 || A[2][3] != 2.) {
+          std::cout << "Test fails: move operator" << std::endl;
+          return 1;
+        }
+        // A sub-matrix points toward its parent and has to be copied
+        vpSubMatrix S(A, 1, 1, 2, 2);
+        B = std::move(S);
+        if (B.data == S.data || B.getRows() != 2 || B[1][1] != 2. || S[1][1] != 2.) {
+          std::cout << "Test fails: move of a sub-matrix" << std::endl;
+          return 1;
+        }
+      }
+#endif
+
       std::cout << "All tests succeed" << std::endl;
       return 0;
     }
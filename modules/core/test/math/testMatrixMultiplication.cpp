@@ -0,0 +1,202 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test matrix products against straightforward implementations.
+ *
+ *****************************************************************************/
+/*!
+  \example testMatrixMultiplication.cpp
+
+  \brief Test vpMatrix products, AtA(), AAt(), the matrix by vector product and
+  vpGEMM() against straightforward implementations, on sizes that fall in the
+  small, blocked and multi-threaded code paths.
+
+*/
+
+#include <iostream>
+#include <cmath>
+#include <stdlib.h>
+
+#include <visp3/core/vpColVector.h>
+#include <visp3/core/vpGEMM.h>
+#include <visp3/core/vpMatrix.h>
+#include <visp3/core/vpSubMatrix.h>
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/core/vpTime.h>
+
+namespace {
+  void randomize(vpMatrix &M)
+  {
+    for (unsigned int i = 0; i < M.getRows(); i++)
+      for (unsigned int j = 0; j < M.getCols(); j++)
+        M[i][j] = (double)rand() / RAND_MAX - 0.5;
+  }
+
+  vpMatrix naiveProduct(const vpMatrix &A, const vpMatrix &B)
+  {
+    vpMatrix C(A.getRows(), B.getCols());
+    for (unsigned int i = 0; i < A.getRows(); i++)
+      for (unsigned int j = 0; j < B.getCols(); j++) {
+        double s = 0;
+        for (unsigned int k = 0; k < A.getCols(); k++)
+          s += A[i][k] * B[k][j];
+        C[i][j] = s;
+      }
+    return C;
+  }
+
+  // Relative error wrt the magnitude of the terms of the products
+  bool equal(const vpArray2D<double> &M, const vpArray2D<double> &R, unsigned int k, const std::string &msg)
+  {
+    if (M.getRows() != R.getRows() || M.getCols() != R.getCols()) {
+      std::cerr << "Failed: " << msg << ": bad size" << std::endl;
+      return false;
+    }
+    const double tolerance = 1e-14 * (k + 1);
+    for (unsigned int i = 0; i < M.getRows(); i++)
+      for (unsigned int j = 0; j < M.getCols(); j++)
+        if (std::fabs(M[i][j] - R[i][j]) > tolerance) {
+          std::cerr << "Failed: " << msg << ": (" << i << "," << j << ") " << M[i][j] << " != " << R[i][j] << std::endl;
+          return false;
+        }
+    return true;
+  }
+
+  bool testSizes(unsigned int m, unsigned int k, unsigned int n)
+  {
+    vpMatrix A(m, k), B(k, n);
+    randomize(A);
+    randomize(B);
+    bool ok = true;
+
+    ok &= equal(A * B, naiveProduct(A, B), k, "A*B");
+    ok &= equal(A.AtA(), naiveProduct(A.t(), A), m, "AtA");
+    ok &= equal(A.AAt(), naiveProduct(A, A.t()), k, "AAt");
+
+    vpMatrix AtA = A.AtA();
+    for (unsigned int i = 0; i < k; i++)
+      for (unsigned int j = 0; j < i; j++)
+        if (AtA[i][j] != AtA[j][i]) {
+          std::cerr << "Failed: AtA is not symmetric" << std::endl;
+          return false;
+        }
+
+    vpColVector x(k);
+    for (unsigned int i = 0; i < k; i++)
+      x[i] = (double)rand() / RAND_MAX - 0.5;
+    vpMatrix X(x);
+    ok &= equal(A * x, naiveProduct(A, X), k, "A*x");
+
+    // All the vpGEMM operations, compared to the reference implementations
+    vpMatrix C(m, n), Ct(n, m), D, R(m, n);
+    randomize(C);
+    randomize(Ct);
+    vpMatrix At = A.t(), Bt = B.t();
+    vpGEMM(A, B, 2., C, 3., D);
+    GEMM2<0>(m, k, n, A, B, 2., C, 3., R);
+    ok &= equal(D, R, k, "vpGEMM 0");
+    vpGEMM(At, B, 2., C, 3., D, VP_GEMM_A_T);
+    GEMM2<1>(m, k, n, At, B, 2., C, 3., R);
+    ok &= equal(D, R, k, "vpGEMM A_T");
+    vpGEMM(A, Bt, 2., C, 3., D, VP_GEMM_B_T);
+    GEMM2<2>(m, k, n, A, Bt, 2., C, 3., R);
+    ok &= equal(D, R, k, "vpGEMM B_T");
+    vpGEMM(At, Bt, 2., null, 0., D, VP_GEMM_A_T + VP_GEMM_B_T);
+    GEMM1<3>(m, k, n, At, Bt, 2., R);
+    ok &= equal(D, R, k, "vpGEMM A_T B_T");
+    vpGEMM(At, Bt, 2., Ct, 3., D, VP_GEMM_A_T + VP_GEMM_B_T + VP_GEMM_C_T);
+    GEMM2<7>(m, k, n, At, Bt, 2., Ct, 3., R);
+    ok &= equal(D, R, k, "vpGEMM A_T B_T C_T");
+
+    return ok;
+  }
+}
+
+int main()
+{
+  try {
+    srand(0);
+    bool ok = true;
+
+    // Small, blocked with edges, and multi-threaded products
+    const unsigned int sizes[][3] = { {1, 1, 1}, {3, 5, 2}, {6, 6, 6}, {17, 9, 13}, {70, 300, 9},
+                                      {129, 257, 65}, {200, 6, 200}, {1000, 6, 3} };
+    for (unsigned int i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+      std::cout << "Test " << sizes[i][0] << "x" << sizes[i][1] << " * " << sizes[i][1] << "x" << sizes[i][2] << std::endl;
+      ok &= testSizes(sizes[i][0], sizes[i][1], sizes[i][2]);
+    }
+
+    // Products of sub-matrices
+    vpMatrix M(20, 30), N(30, 20);
+    randomize(M);
+    randomize(N);
+    vpSubMatrix Ms(M, 2, 3, 10, 12), Ns(N, 1, 4, 12, 9);
+    vpMatrix Mc(10, 12), Nc(12, 9);
+    for (unsigned int i = 0; i < Mc.getRows(); i++)
+      for (unsigned int j = 0; j < Mc.getCols(); j++)
+        Mc[i][j] = M[i + 2][j + 3];
+    for (unsigned int i = 0; i < Nc.getRows(); i++)
+      for (unsigned int j = 0; j < Nc.getCols(); j++)
+        Nc[i][j] = N[i + 1][j + 4];
+    ok &= equal(Ms * Ns, naiveProduct(Mc, Nc), 12, "sub-matrix product");
+    ok &= equal(Ms.AtA(), naiveProduct(Mc.t(), Mc), 10, "sub-matrix AtA");
+
+    // Tall skinny L^T L as in the visual servoing and pose estimation
+    vpMatrix L(6000, 6);
+    randomize(L);
+    ok &= equal(L.AtA(), naiveProduct(L.t(), L), 6000, "L^T L");
+
+    // Timing of a square product
+    const unsigned int n = 256;
+    vpMatrix A(n, n), B(n, n);
+    randomize(A);
+    randomize(B);
+    double t = vpTime::measureTimeMs();
+    vpMatrix C = naiveProduct(A, B);
+    double t_naive = vpTime::measureTimeMs() - t;
+    t = vpTime::measureTimeMs();
+    vpMatrix D = A * B;
+    double t_gemm = vpTime::measureTimeMs() - t;
+    std::cout << n << "x" << n << " product: " << t_naive << " ms (naive) " << t_gemm << " ms (blocked, "
+              << vpThreadPool::getNumThreads() << " threads)" << std::endl;
+    ok &= equal(D, C, n, "square product");
+
+    if (!ok) {
+      std::cerr << "Matrix multiplication test failed" << std::endl;
+      return EXIT_FAILURE;
+    }
+    std::cout << "Matrix multiplication test succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cerr << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
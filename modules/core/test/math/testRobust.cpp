@@ -50,11 +50,21 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <iostream>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <math.h>
 // List of allowed command line options
 #define GETOPTARGS	"cdho:"
 
 void usage(const char *name, const char *badparam, std::string ofilename);
 bool getOptions(int argc, const char **argv, std::string &ofilename);
+double sortedMedian(std::vector<double> v);
+void referenceWeights(vpRobust::vpRobustEstimatorType method, const vpColVector &residues,
+                      const vpColVector &all_residues, bool use_all, vpColVector &weights);
+bool checkWeights(vpRobust::vpRobustEstimatorType method, const vpColVector &residues,
+                  const vpColVector &weights_init, bool use_all);
+bool testMEstimator();
 
 /*!
 
@@ -135,11 +145,150 @@ bool getOptions(int argc, const char **argv, std::string &ofilename)
 }
 
 
+/*!
+  Median of \e v as computed by vpRobust before it used std::nth_element:
+  the element of rank ceil(n/2)-1 once sorted, 0 if \e v is empty.
+*/
+double sortedMedian(std::vector<double> v)
+{
+  if (v.empty())
+    return 0;
+  std::sort(v.begin(), v.end());
+  return v[(unsigned int)(ceil(v.size()/2.0))-1];
+}
+
+/*!
+  Reference M-estimator weights, computed with a sort-based median and MAD
+  and the influence functions as they were written before vpRobust was
+  optimized.
+
+  \param method : M-estimator.
+  \param residues : Residues used to compute the median and the MAD.
+  \param all_residues : Residues to weight if \e use_all is true.
+  \param use_all : If true mimic MEstimator(method, residues, all_residues,
+  weights) where only the residues with a non null weight are considered,
+  otherwise mimic MEstimator(method, residues, weights).
+  \param weights : Initial weights as input, resulting weights as output.
+*/
+void referenceWeights(vpRobust::vpRobustEstimatorType method, const vpColVector &residues,
+                      const vpColVector &all_residues, bool use_all, vpColVector &weights)
+{
+  const double eps = std::numeric_limits<double>::epsilon();
+  std::vector<double> r;
+  for (unsigned int i=0; i < residues.getRows(); i++) {
+    if (! use_all || std::fabs(weights[i]) > eps)
+      r.push_back(residues[i]);
+  }
+  double med = sortedMedian(r);
+  for (size_t i=0; i < r.size(); i++)
+    r[i] = fabs(r[i] - med);
+  double sigma = 1.4826*sortedMedian(r);
+  if (sigma < 0.0017) // vpRobust default noise threshold
+    sigma = 0.0017;
+
+  const vpColVector &x = use_all ? all_residues : residues;
+  for (unsigned int i=0; i < x.getRows(); i++) {
+    double xi = fabs(x[i] - med);
+    switch (method) {
+    case vpRobust::TUKEY: {
+      double xi_sig = xi/sigma;
+      if ((std::fabs(xi_sig) <= 4.6851) && std::fabs(weights[i]) > eps)
+        weights[i] = vpMath::sqr(1-vpMath::sqr(xi_sig/4.6851));
+      else
+        weights[i] = 0;
+      break;
+    }
+    case vpRobust::HUBER:
+      if (std::fabs(weights[i]) > eps) {
+        double xi_sig = xi/sigma;
+        weights[i] = (fabs(xi_sig) <= 1.2107) ? 1 : 1.2107/fabs(xi_sig);
+      }
+      break;
+    case vpRobust::CAUCHY:
+      weights[i] = 1/(1+vpMath::sqr(xi/(2.3849*sigma)));
+      break;
+    }
+  }
+}
+
+/*!
+  Compare the weights computed by vpRobust::MEstimator() with the reference
+  weights, and check that no weight is modified for empty residues.
+*/
+bool checkWeights(vpRobust::vpRobustEstimatorType method, const vpColVector &residues,
+                  const vpColVector &weights_init, bool use_all)
+{
+  vpRobust robust(0);
+  vpColVector weights = weights_init;
+  if (use_all)
+    robust.MEstimator(method, residues, residues, weights);
+  else
+    robust.MEstimator(method, residues, weights);
+
+  vpColVector ref = weights_init;
+  if (use_all || residues.getRows() > 0)
+    referenceWeights(method, residues, residues, use_all, ref);
+
+  for (unsigned int i=0; i < weights.getRows(); i++) {
+    if (weights[i] != ref[i]) {
+      std::cerr << "Bad weight " << i << " for " << residues.getRows() << " residues (method " << method
+                << ", all residues " << use_all << "): " << weights[i] << " instead of " << ref[i] << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+/*!
+  Regression tests of vpRobust::MEstimator() against a sort-based median:
+  empty residues, all the weights null, odd and even number of residues,
+  with random, repeated and sorted values.
+*/
+bool testMEstimator()
+{
+  const vpRobust::vpRobustEstimatorType methods[3] = { vpRobust::TUKEY, vpRobust::HUBER, vpRobust::CAUCHY };
+  srand(0);
+
+  for (unsigned int m=0; m < 3; m++) {
+    for (int use_all=0; use_all < 2; use_all++) {
+      // Empty residues
+      vpColVector empty;
+      if (! checkWeights(methods[m], empty, empty, use_all != 0))
+        return false;
+
+      const unsigned int sizes[] = { 1, 2, 3, 4, 5, 10, 11, 100, 101, 1000, 1001 };
+      for (unsigned int s=0; s < sizeof(sizes)/sizeof(sizes[0]); s++) {
+        unsigned int n = sizes[s];
+        vpColVector residues(n), repeated(n), sorted(n), ones(n, 1.), zeros(n, 0.), some(n);
+        for (unsigned int i=0; i < n; i++) {
+          residues[i] = (double)rand()/RAND_MAX - 0.5;
+          if (i % 10 == 0)
+            residues[i] *= 100; // outlier
+          repeated[i] = (double)(rand() % 5);
+          sorted[i] = 0.01*i;
+          some[i] = (rand() % 3) ? 1. : 0.;
+        }
+        if (! checkWeights(methods[m], residues, ones, use_all != 0) ||
+            ! checkWeights(methods[m], residues, some, use_all != 0) ||
+            ! checkWeights(methods[m], repeated, ones, use_all != 0) ||
+            ! checkWeights(methods[m], sorted, ones, use_all != 0) ||
+            ! checkWeights(methods[m], residues, zeros, use_all != 0)) // All the weights null
+          return false;
+      }
+    }
+  }
+  return true;
+}
 
 int
 main(int argc, const char ** argv)
 {
   try {
+    std::cout << "Compare vpRobust::MEstimator() with a sort-based median" << std::endl;
+    if (! testMEstimator())
+      return 1;
+    std::cout << "vpRobust::MEstimator() is ok" << std::endl;
+
     std::string ofilename;
     std::string username;
 
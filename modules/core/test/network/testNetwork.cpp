@@ -0,0 +1,188 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test image and matrix messages between a TCP server and a client.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testNetwork.cpp
+
+  Exchange grey level images, color images and matrices between a vpServer
+  and a vpClient running in the same process on the loopback interface, and
+  check that a message of an unexpected type is skipped without breaking the
+  stream.
+*/
+
+#include <iostream>
+#include <visp3/core/vpClient.h>
+#include <visp3/core/vpMatrix.h>
+#include <visp3/core/vpServer.h>
+
+namespace
+{
+  // Size of the header that prefixes each image or matrix message
+  const int headerSize = 5 * sizeof(unsigned int);
+
+  vpImage<unsigned char> greyImage(unsigned int h, unsigned int w, unsigned int seed)
+  {
+    vpImage<unsigned char> I(h, w);
+    for (unsigned int i = 0; i < I.getSize(); i++)
+      I.bitmap[i] = (unsigned char)(i * 7 + seed);
+    return I;
+  }
+
+  vpImage<vpRGBa> colorImage(unsigned int h, unsigned int w, unsigned int seed)
+  {
+    vpImage<vpRGBa> I(h, w);
+    for (unsigned int i = 0; i < I.getSize(); i++)
+      I.bitmap[i] = vpRGBa((unsigned char)(i + seed), (unsigned char)(3 * i), (unsigned char)(5 * i), (unsigned char)seed);
+    return I;
+  }
+
+  bool check(bool ok, const std::string &what)
+  {
+    if (! ok)
+      std::cerr << "Failed: " << what << std::endl;
+    return ok;
+  }
+
+  bool testMessages(vpServer &serv, vpClient &client)
+  {
+    // Grey level image, from the client to the server
+    vpImage<unsigned char> I_grey = greyImage(37, 53, 1), I_grey_received;
+    int size = headerSize + (int)I_grey.getSize();
+    if (! check(client.sendImage(I_grey) == size, "send grey level image")
+        || ! check(serv.receiveImage(I_grey_received) == size, "receive grey level image")
+        || ! check(I_grey_received == I_grey, "grey level image content"))
+      return false;
+
+    // Color image, from the server to the client
+    vpImage<vpRGBa> I_color = colorImage(31, 17, 2), I_color_received;
+    size = headerSize + (int)(I_color.getSize() * sizeof(vpRGBa));
+    if (! check(serv.sendImageTo(I_color, 0) == size, "send color image")
+        || ! check(client.receiveImageFrom(I_color_received, 0) == size, "receive color image")
+        || ! check(I_color_received == I_color, "color image content"))
+      return false;
+
+    // Matrix, received in a matrix of another size
+    vpMatrix M(4, 5), M_received(2, 2);
+    for (unsigned int i = 0; i < M.size(); i++)
+      M.data[i] = 0.1 * i - 1.;
+    size = headerSize + (int)(M.size() * sizeof(double));
+    if (! check(client.sendMatrix(M) == size, "send matrix")
+        || ! check(serv.receiveMatrix(M_received) == size, "receive matrix")
+        || ! check(M_received.getRows() == M.getRows() && M_received.getCols() == M.getCols(), "matrix size"))
+      return false;
+    for (unsigned int i = 0; i < M.size(); i++) {
+      if (! check(M_received.data[i] == M.data[i], "matrix content"))
+        return false;
+    }
+
+    // A grey level image larger than the skip buffer is read as a matrix: it
+    // has to be rejected and skipped, so that the next message is received
+    vpImage<unsigned char> I_skipped = greyImage(240, 320, 3);
+    I_color = colorImage(8, 9, 4);
+    if (! check(client.sendImage(I_skipped) == headerSize + (int)I_skipped.getSize(), "send skipped image")
+        || ! check(client.sendImage(I_color) == headerSize + (int)(I_color.getSize() * sizeof(vpRGBa)), "send color image")
+        || ! check(serv.receiveMatrix(M_received) == -1, "reject a grey level image read as a matrix")
+        || ! check(serv.receiveImage(I_color_received) > 0, "receive color image after the skipped message")
+        || ! check(I_color_received == I_color, "color image content after the skipped message"))
+      return false;
+
+    // Grey level and color images don't match either
+    I_grey = greyImage(5, 6, 5);
+    if (! check(serv.sendImage(I_color) > 0, "send color image")
+        || ! check(serv.sendMatrix(M) > 0, "send matrix")
+        || ! check(serv.sendImage(I_grey) > 0, "send grey level image")
+        || ! check(client.receiveImage(I_grey_received) == -1, "reject a color image read as a grey level image")
+        || ! check(client.receiveImage(I_grey_received) == -1, "reject a matrix read as a grey level image")
+        || ! check(client.receiveImage(I_grey_received) > 0, "receive grey level image after the skipped messages")
+        || ! check(I_grey_received == I_grey, "grey level image content after the skipped messages"))
+      return false;
+
+    // Empty matrix
+    vpMatrix M_empty;
+    if (! check(client.sendMatrix(M_empty) == headerSize, "send empty matrix")
+        || ! check(serv.receiveMatrix(M_received) == headerSize, "receive empty matrix")
+        || ! check(M_received.size() == 0, "empty matrix size"))
+      return false;
+
+    return true;
+  }
+}
+
+int main()
+{
+  try {
+    // Find a free port
+    vpServer *serv = NULL;
+    int port = 35100;
+    for ( ; port < 35200; port++) {
+      serv = new vpServer(port);
+      if (serv->start())
+        break;
+      delete serv;
+      serv = NULL;
+    }
+    if (serv == NULL) {
+      std::cerr << "Cannot start the server" << std::endl;
+      return 1;
+    }
+    serv->setTimeoutSec(1);
+
+    vpClient client;
+    client.setTimeoutSec(1);
+    if (! client.connectToIP("127.0.0.1", (unsigned int)port)) {
+      delete serv;
+      return 1;
+    }
+    for (int i = 0; i < 100 && serv->getNumberOfClients() == 0; i++)
+      serv->checkForConnections();
+    if (serv->getNumberOfClients() != 1) {
+      std::cerr << "The server didn't accept the connection" << std::endl;
+      delete serv;
+      return 1;
+    }
+
+    bool ok = testMessages(*serv, client);
+    client.stop();
+    delete serv;
+
+    if (! ok)
+      return 1;
+    std::cout << "Image and matrix messages are ok" << std::endl;
+    return 0;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,209 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the shared thread pool and the image functions that rely on it.
+ *
+ *****************************************************************************/
+/*!
+  \example testThreadPool.cpp
+
+  \brief Test vpThreadPool and check that the image conversions and tools
+  give the same results whatever the number of threads.
+
+*/
+
+#include <iostream>
+#include <stdlib.h>
+#include <vector>
+
+#include <visp3/core/vpImageConvert.h>
+#include <visp3/core/vpImageTools.h>
+#include <visp3/core/vpThreadPool.h>
+
+namespace {
+  void squareBand(unsigned int begin, unsigned int end, void *arg)
+  {
+    std::vector<unsigned int> *v = static_cast<std::vector<unsigned int> *>(arg);
+    for (unsigned int i = begin; i < end; i++)
+      (*v)[i] += i*i;
+  }
+
+  void nestedBand(unsigned int begin, unsigned int end, void *arg)
+  {
+    std::vector<unsigned int> *v = static_cast<std::vector<unsigned int> *>(arg);
+    for (unsigned int i = begin; i < end; i++) {
+      std::vector<unsigned int> inner(16, 0);
+      vpThreadPool::parallelFor(0, (unsigned int)inner.size(), squareBand, &inner);
+      unsigned int sum = 0;
+      for (size_t j = 0; j < inner.size(); j++)
+        sum += inner[j];
+      (*v)[i] = sum;
+    }
+  }
+
+  void throwingBand(unsigned int begin, unsigned int end, void *)
+  {
+    if (begin == 0 && end > begin)
+      throw vpException(vpException::badValue, "Band %u-%u", begin, end);
+  }
+
+  template<class Type>
+  bool equal(vpImage<Type> &I1, const vpImage<Type> &I2, const std::string &name)
+  {
+    if (I1.getHeight() != I2.getHeight() || I1.getWidth() != I2.getWidth() || !(I1 == I2)) {
+      std::cerr << name << ": results differ with " << vpThreadPool::getNumThreads() << " threads" << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  struct Results {
+    vpImage<vpRGBa> rgba;
+    vpImage<unsigned char> grey;
+    vpImage<unsigned char> yuv420Grey;
+    vpImage<vpRGBa> yuv420Rgba;
+    vpImage<unsigned char> lut;
+    vpImage<unsigned char> diff;
+    vpImage<unsigned char> diffAbs;
+    vpImage<unsigned char> flip;
+    vpImage<vpRGBa> flipInPlace;
+    vpImage<unsigned char> undistort;
+    vpImage<vpRGBa> undistortRgba;
+  };
+
+  void compute(const vpImage<vpRGBa> &src, const vpImage<unsigned char> &grey,
+               const std::vector<unsigned char> &yuv420, Results &r)
+  {
+    unsigned int width = src.getWidth(), height = src.getHeight();
+
+    r.grey.resize(height, width);
+    vpImageConvert::RGBaToGrey((unsigned char *)src.bitmap, r.grey.bitmap, width*height);
+    r.rgba.resize(height, width);
+    vpImageConvert::GreyToRGBa(grey.bitmap, (unsigned char *)r.rgba.bitmap, width*height);
+    r.yuv420Rgba.resize(height, width);
+    vpImageConvert::YUV420ToRGBa((unsigned char *)&yuv420[0], (unsigned char *)r.yuv420Rgba.bitmap, width, height);
+    r.yuv420Grey.resize(height, width);
+    vpImageConvert::YUV420ToGrey((unsigned char *)&yuv420[0], r.yuv420Grey.bitmap, width*height);
+
+    r.lut = grey;
+    vpImageTools::changeLUT(r.lut, 30, 10, 200, 240);
+    vpImageTools::imageDifference(grey, r.grey, r.diff);
+    vpImageTools::imageDifferenceAbsolute(grey, r.grey, r.diffAbs);
+    vpImageTools::flip(grey, r.flip);
+    r.flipInPlace = src;
+    vpImageTools::flip(r.flipInPlace);
+
+    vpCameraParameters cam(600, 600, width/2., height/2., 0.2, -0.2);
+    vpImageTools::undistort(grey, cam, r.undistort);
+    vpImageTools::undistort(src, cam, r.undistortRgba);
+  }
+}
+
+int main()
+{
+  bool success = true;
+  std::cout << "Number of cores: " << vpThreadPool::getNumCores() << std::endl;
+
+  // parallelFor() has to visit each index exactly once
+  vpThreadPool::setNumThreads(4);
+  std::vector<unsigned int> v(100003, 0);
+  vpThreadPool::parallelFor(0, (unsigned int)v.size(), squareBand, &v);
+  vpThreadPool::parallelFor(0, 0, squareBand, &v);
+  for (unsigned int i = 0; i < v.size(); i++) {
+    if (v[i] != i*i) {
+      std::cerr << "parallelFor(): wrong value at index " << i << std::endl;
+      success = false;
+      break;
+    }
+  }
+
+  // Nested calls are run by the calling thread
+  std::vector<unsigned int> nested(64, 0);
+  vpThreadPool::parallelFor(0, (unsigned int)nested.size(), nestedBand, &nested);
+  for (size_t i = 0; i < nested.size(); i++) {
+    if (nested[i] != 1240) {
+      std::cerr << "parallelFor(): wrong nested result" << std::endl;
+      success = false;
+      break;
+    }
+  }
+
+  // Exceptions thrown by a band are forwarded to the caller
+  try {
+    vpThreadPool::parallelFor(0, 1000, throwingBand, NULL);
+    std::cerr << "parallelFor(): exception not forwarded" << std::endl;
+    success = false;
+  }
+  catch(const vpException &e) {
+    std::cout << "Catch expected exception: " << e.getStringMessage() << std::endl;
+  }
+
+  // Odd sizes to exercise the remainders of the bands
+  const unsigned int width = 642, height = 481;
+  vpImage<vpRGBa> src(height, width);
+  vpImage<unsigned char> grey(height, width);
+  std::vector<unsigned char> yuv420(width*height*3/2);
+  srand(0);
+  for (unsigned int i = 0; i < width*height; i++) {
+    src.bitmap[i] = vpRGBa((unsigned char)rand(), (unsigned char)rand(), (unsigned char)rand(), (unsigned char)rand());
+    grey.bitmap[i] = (unsigned char)rand();
+  }
+  for (size_t i = 0; i < yuv420.size(); i++)
+    yuv420[i] = (unsigned char)rand();
+
+  vpThreadPool::setNumThreads(1);
+  Results ref;
+  compute(src, grey, yuv420, ref);
+
+  unsigned int nthreads[] = { 2, 3, 8, 0 };
+  for (unsigned int k = 0; k < sizeof(nthreads)/sizeof(nthreads[0]); k++) {
+    vpThreadPool::setNumThreads(nthreads[k]);
+    Results res;
+    compute(src, grey, yuv420, res);
+    success = equal(res.grey, ref.grey, "RGBaToGrey") && success;
+    success = equal(res.rgba, ref.rgba, "GreyToRGBa") && success;
+    success = equal(res.yuv420Rgba, ref.yuv420Rgba, "YUV420ToRGBa") && success;
+    success = equal(res.yuv420Grey, ref.yuv420Grey, "YUV420ToGrey") && success;
+    success = equal(res.lut, ref.lut, "changeLUT") && success;
+    success = equal(res.diff, ref.diff, "imageDifference") && success;
+    success = equal(res.diffAbs, ref.diffAbs, "imageDifferenceAbsolute") && success;
+    success = equal(res.flip, ref.flip, "flip") && success;
+    success = equal(res.flipInPlace, ref.flipInPlace, "flip (in place)") && success;
+    success = equal(res.undistort, ref.undistort, "undistort") && success;
+    success = equal(res.undistortRgba, ref.undistortRgba, "undistort (vpRGBa)") && success;
+  }
+
+  if (!success) {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testThreadPool ok !" << std::endl;
+  return EXIT_SUCCESS;
+}
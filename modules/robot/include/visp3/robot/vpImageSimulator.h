@@ -177,9 +177,6 @@ class VISP_EXPORT vpImageSimulator
     double *vbase_u_optim;
     double *vbase_v_optim;
 
-    //allocation memoire du point 3D d'intersection entre le vecteur (centre_cam - point_plan_image) et le plan
-    double *Xinter_optim;
-
     //triangles de projection du plan
     std::vector<vpTriangle> listTriangle;
     
@@ -280,14 +277,29 @@ class VISP_EXPORT vpImageSimulator
     
     //function that project a point x,y on the plane, return true if the projection is on the limited plane
     // and in this case return the corresponding image pixel Ipixelplan
-    bool getPixel(const vpImagePoint &iP,unsigned char &Ipixelplan);
-    bool getPixel(const vpImagePoint &iP,vpRGBa &Ipixelplan);
-    bool getPixel(vpImage<unsigned char> &Isrc, const vpImagePoint &iP,
-		  unsigned char &Ipixelplan);
-    bool getPixel(vpImage<vpRGBa> &Isrc, const vpImagePoint &iP,
-		  vpRGBa &Ipixelplan);
-    bool getPixelDepth(const vpImagePoint &iP, double &Zpixelplan);
-    bool getPixelVisibility(const vpImagePoint &iP, double &Zpixelplan);
+    bool getPixel(const vpImagePoint &iP,unsigned char &Ipixelplan) const;
+    bool getPixel(const vpImagePoint &iP,vpRGBa &Ipixelplan) const;
+    bool getPixel(const vpImage<unsigned char> &Isrc, const vpImagePoint &iP,
+		  unsigned char &Ipixelplan) const;
+    bool getPixel(const vpImage<vpRGBa> &Isrc, const vpImagePoint &iP,
+		  vpRGBa &Ipixelplan) const;
+    void getPixel(const vpImagePoint &iP, const bool inside, unsigned char &Ipixel) const;
+    void getPixel(const vpImagePoint &iP, const bool inside, vpRGBa &Ipixel) const;
+    bool getPixelDepth(const vpImagePoint &iP, double &Zpixelplan) const;
+    bool getPixelVisibility(const vpImagePoint &iP, double &Zpixelplan) const;
+
+    bool isInside(const vpImagePoint &iP) const;
+    double getDepth(const vpImagePoint &iP) const;
+    bool getTextureCoordinates(const vpImagePoint &iP, double &u, double &v) const;
+    template<class Type>
+    void getTexel(const vpImage<Type> &Isrc, const double u, const double v, Type &Ipixelplan) const;
+
+    //rendu multi-thread d'une liste de plans
+    static void render(vpImageSimulator **simList, unsigned int nbsimList, const vpCameraParameters &cam,
+                       unsigned int top, unsigned int bottom, unsigned int left, unsigned int right,
+                       vpImage<unsigned char> *Igray, vpImage<vpRGBa> *Icolor);
+    static void nearestPlaneBand(unsigned int begin, unsigned int end, void *arg);
+    static void shadingBand(unsigned int begin, unsigned int end, void *arg);
     
         //operation 3D de base :
     void project(const vpColVector &_vin, const vpHomogeneousMatrix &_cMt,
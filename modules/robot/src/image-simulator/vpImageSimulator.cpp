@@ -43,6 +43,10 @@
 #include <visp3/core/vpMeterPixelConversion.h>
 #include <visp3/core/vpMatrixException.h>
 #include <visp3/core/vpPolygon3D.h>
+#include <visp3/core/vpThreadPool.h>
+
+#include <algorithm>
+#include <limits>
 
 #ifdef VISP_HAVE_MODULE_IO
 #  include <visp3/io/vpImageIo.h>
@@ -61,7 +65,7 @@ vpImageSimulator::vpImageSimulator(const vpColorPlan &col)
   : cMt(), pt(), ptClipped(), interp(SIMPLE), normal_obj(), normal_Cam(), normal_Cam_optim(),
     distance(1.), visible_result(1.), visible(false), X0_2_optim(NULL),
     euclideanNorm_u(0.), euclideanNorm_v(0.), vbase_u(), vbase_v(),
-    vbase_u_optim(NULL), vbase_v_optim(NULL), Xinter_optim(NULL), listTriangle(),
+    vbase_u_optim(NULL), vbase_v_optim(NULL), listTriangle(),
     colorI(col), Ig(), Ic(), rect(), cleanPrevImage(false),
     setBackgroundTexture(false), bgColor(vpColor::white), focal(), needClipping(false)
 {
@@ -88,7 +92,6 @@ vpImageSimulator::vpImageSimulator(const vpColorPlan &col)
   X0_2_optim = new double[3];
   vbase_u_optim = new double[3];
   vbase_v_optim = new double[3];
-  Xinter_optim = new double[3];
 
   pt.resize(4);
 }
@@ -101,7 +104,7 @@ vpImageSimulator::vpImageSimulator(const vpImageSimulator &text)
   : cMt(), pt(), ptClipped(), interp(SIMPLE), normal_obj(), normal_Cam(), normal_Cam_optim(),
     distance(1.), visible_result(1.), visible(false), X0_2_optim(NULL),
     euclideanNorm_u(0.), euclideanNorm_v(0.), vbase_u(), vbase_v(),
-    vbase_u_optim(NULL), vbase_v_optim(NULL), Xinter_optim(NULL), listTriangle(),
+    vbase_u_optim(NULL), vbase_v_optim(NULL), listTriangle(),
     colorI(GRAY_SCALED), Ig(), Ic(), rect(), cleanPrevImage(false),
     setBackgroundTexture(false), bgColor(vpColor::white), focal(), needClipping(false)
 {
@@ -135,7 +138,6 @@ vpImageSimulator::vpImageSimulator(const vpImageSimulator &text)
   X0_2_optim = new double[3];
   vbase_u_optim = new double[3];
   vbase_v_optim = new double[3];
-  Xinter_optim = new double[3];
   
   colorI = text.colorI;
   interp = text.interp;
@@ -155,7 +157,6 @@ vpImageSimulator::~vpImageSimulator()
   delete[] X0_2_optim;
   delete[] vbase_u_optim;
   delete[] vbase_v_optim;
-  delete[] Xinter_optim;
 }
 
 
@@ -382,11 +383,12 @@ vpImageSimulator::getImage(vpImage<unsigned char> &I,
           unsigned char Ipixelplan;
           if(getPixel(ip,Ipixelplan))
           {
-            if (Xinter_optim[2] < zBuffer[i][j] || zBuffer[i][j] < 0)
+            double z = getDepth(ip);
+            if (z < zBuffer[i][j] || zBuffer[i][j] < 0)
             {
               *(bitmap+i*width+j)=Ipixelplan;
               nb_point_dessine++;
-              zBuffer[i][j] = Xinter_optim[2];
+              zBuffer[i][j] = z;
             }
           }
         }
@@ -395,12 +397,13 @@ vpImageSimulator::getImage(vpImage<unsigned char> &I,
           vpRGBa Ipixelplan;
           if(getPixel(ip,Ipixelplan))
           {
-            if (Xinter_optim[2] < zBuffer[i][j] || zBuffer[i][j] < 0)
+            double z = getDepth(ip);
+            if (z < zBuffer[i][j] || zBuffer[i][j] < 0)
             {
               unsigned char pixelgrey = (unsigned char)(0.2126 * Ipixelplan.R + 0.7152 * Ipixelplan.G + 0.0722 * Ipixelplan.B);
               *(bitmap+i*width+j)=pixelgrey;
               nb_point_dessine++;
-              zBuffer[i][j] = Xinter_optim[2];
+              zBuffer[i][j] = z;
             }
           }
         }
@@ -596,7 +599,8 @@ vpImageSimulator::getImage(vpImage<vpRGBa> &I, const vpCameraParameters &cam,
           unsigned char Ipixelplan;
           if(getPixel(ip,Ipixelplan))
           {
-            if (Xinter_optim[2] < zBuffer[i][j] || zBuffer[i][j] < 0)
+            double z = getDepth(ip);
+            if (z < zBuffer[i][j] || zBuffer[i][j] < 0)
             {
               vpRGBa pixelcolor;
               pixelcolor.R = Ipixelplan;
@@ -604,7 +608,7 @@ vpImageSimulator::getImage(vpImage<vpRGBa> &I, const vpCameraParameters &cam,
               pixelcolor.B = Ipixelplan;
               *(bitmap+i*width+j) = pixelcolor;
               nb_point_dessine++;
-              zBuffer[i][j] = Xinter_optim[2];
+              zBuffer[i][j] = z;
             }
           }
         }
@@ -613,11 +617,12 @@ vpImageSimulator::getImage(vpImage<vpRGBa> &I, const vpCameraParameters &cam,
           vpRGBa Ipixelplan;
           if(getPixel(ip,Ipixelplan))
           {
-            if (Xinter_optim[2] < zBuffer[i][j] || zBuffer[i][j] < 0)
+            double z = getDepth(ip);
+            if (z < zBuffer[i][j] || zBuffer[i][j] < 0)
             {
               *(bitmap+i*width+j) = Ipixelplan;
               nb_point_dessine++;
-              zBuffer[i][j] = Xinter_optim[2];
+              zBuffer[i][j] = z;
             }
           }
         }
@@ -630,6 +635,8 @@ vpImageSimulator::getImage(vpImage<vpRGBa> &I, const vpCameraParameters &cam,
   Get the view of the virtual camera. Be careful, the image I is modified. The projected image is not added as an overlay!
   With this method, a list of image is projected into the image. Thus, you have to initialise a list of vpImageSimulator. Then you store them into a vpList. And finally with this method you project them into the image \f$ I \f$. The depth of the 3D scene is managed such as an image in foreground hides an image background.
 
+  The rows of the image are rendered in parallel by the threads of vpThreadPool (see vpThreadPool::setNumThreads()). The resulting image does not depend on the number of threads.
+
   The following example shows how to use the method:
 
   \code
@@ -749,10 +756,10 @@ vpImageSimulator::getImage(vpImage<unsigned char> &I,
 
   unsigned int unvisible = 0;
   unsigned int indexSimu=0;
-  for(std::list<vpImageSimulator>::iterator it=list.begin(); it!=list.end(); ++it, ++indexSimu){
+  for(std::list<vpImageSimulator>::iterator it=list.begin(); it!=list.end(); ++it){
     vpImageSimulator* sim = &(*it);
     if (sim->visible)
-      simList[indexSimu] = sim;
+      simList[indexSimu++] = sim;
     else
       unvisible++;
   }
@@ -778,50 +785,8 @@ vpImageSimulator::getImage(vpImage<unsigned char> &I,
     if (rightFinal < simList[i]->rect.getRight()) rightFinal = simList[i]->rect.getRight();
   }
 
-  double zmin = -1;
-  int indice = -1;
-  unsigned char *bitmap = I.bitmap;
-  vpImagePoint ip;
-
-  for (unsigned int i = (unsigned int)topFinal; i < (unsigned int)bottomFinal; i++)
-  {
-    for (unsigned int j = (unsigned int)leftFinal; j < (unsigned int)rightFinal; j++)
-    {
-      zmin = -1;
-      double x=0,y=0;
-      ip.set_ij(i,j);
-      vpPixelMeterConversion::convertPoint(cam,ip, x,y);
-      ip.set_ij(y,x);
-      for (int k = 0; k < (int)nbsimList; k++)
-      {
-  double z = 0;
-  if(simList[k]->getPixelDepth(ip,z))
-  {
-    if (z < zmin || zmin < 0)
-    {
-      zmin = z;
-      indice = k;
-    }
-  }
-      }
-      if (indice >= 0)
-      {
-        if (simList[indice]->colorI == GRAY_SCALED)
-        {
-    unsigned char Ipixelplan = 255;
-          simList[indice]->getPixel(ip,Ipixelplan);
-    *(bitmap+i*width+j)=Ipixelplan;
-        }
-        else if (simList[indice]->colorI == COLORED)
-        {
-    vpRGBa Ipixelplan(255,255,255);
-    simList[indice]->getPixel(ip,Ipixelplan);
-    unsigned char pixelgrey = (unsigned char)(0.2126 * Ipixelplan.R + 0.7152 * Ipixelplan.G + 0.0722 * Ipixelplan.B);
-    *(bitmap+i*width+j)=pixelgrey;
-        }
-      }
-    }
-  }
+  render(simList, nbsimList, cam, (unsigned int)topFinal, (unsigned int)bottomFinal,
+         (unsigned int)leftFinal, (unsigned int)rightFinal, &I, NULL);
 
   delete[] simList;
 }
@@ -832,6 +797,8 @@ vpImageSimulator::getImage(vpImage<unsigned char> &I,
 
   With this method, a list of image is projected into the image. Thus, you have to initialise a list of vpImageSimulator. Then you store them into a vpList. And finally with this method you project them into the image \f$ I \f$. The depth of the 3D scene is managed such as an image in foreground hides an image background.
 
+  The rows of the image are rendered in parallel by the threads of vpThreadPool (see vpThreadPool::setNumThreads()). The resulting image does not depend on the number of threads.
+
   The following example shows how to use the method:
 
   \code
@@ -951,10 +918,10 @@ vpImageSimulator::getImage(vpImage<vpRGBa> &I,
 
   unsigned int unvisible = 0;
   unsigned int indexSimu = 0;
-  for(std::list<vpImageSimulator>::iterator it=list.begin(); it!=list.end(); ++it, ++indexSimu){
+  for(std::list<vpImageSimulator>::iterator it=list.begin(); it!=list.end(); ++it){
     vpImageSimulator* sim = &(*it);
     if (sim->visible)
-      simList[indexSimu] = sim;
+      simList[indexSimu++] = sim;
     else
       unvisible++;
   }
@@ -980,56 +947,270 @@ vpImageSimulator::getImage(vpImage<vpRGBa> &I,
     if (rightFinal < simList[i]->rect.getRight()) rightFinal = simList[i]->rect.getRight();
   }
 
-  double zmin = -1;
-  int indice = -1;
-  vpRGBa *bitmap = I.bitmap;
+  render(simList, nbsimList, cam, (unsigned int)topFinal, (unsigned int)bottomFinal,
+         (unsigned int)leftFinal, (unsigned int)rightFinal, NULL, &I);
+
+  delete[] simList;
+}
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Data shared by the threads that render a list of planes
+struct vpImageSimulatorRendering
+{
+  vpImageSimulator **simList;
+  unsigned int nbsimList;
+  const vpCameraParameters *cam;
+  unsigned int top;
+  unsigned int left;
+  unsigned int roiWidth;
+  // Normalized x coordinate of each column of the roi. Empty if the camera
+  // model has distortion, since x then also depends on the row.
+  std::vector<double> x;
+  // xmin, xmax, ymin, ymax of each plane in normalized coordinates
+  std::vector<double> bounds;
+  // z-buffer of the roi: index of the nearest plane, -1 if no plane
+  std::vector<int> nearest;
+  // Index of the last plane found in each row, then, once resolved, index of
+  // the plane found before the beginning of each row
+  std::vector<int> previous;
+  vpImage<unsigned char> *Igray;
+  vpImage<vpRGBa> *Icolor;
+};
+
+// Normalized coordinates of the pixel (i, j) of the roi. y is computed once
+// per row when the columns are tabulated.
+inline void
+pixelToMeter(const vpImageSimulatorRendering *data, unsigned int i, unsigned int j, double &y, vpImagePoint &ip)
+{
+  double x = 0;
+  if (data->x.empty())
+    vpPixelMeterConversion::convertPoint(*data->cam, (double)j, (double)i, x, y);
+  else
+    x = data->x[j - data->left];
+  ip.set_ij(y, x);
+}
+
+inline double
+rowToMeter(const vpImageSimulatorRendering *data, unsigned int i)
+{
+  double x = 0, y = 0;
+  if (!data->x.empty())
+    vpPixelMeterConversion::convertPoint(*data->cam, (double)data->left, (double)i, x, y);
+  return y;
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Fill the z-buffer of the rows [\e begin, \e end) of the roi with the index
+  of the nearest plane.
+*/
+void
+vpImageSimulator::nearestPlaneBand(unsigned int begin, unsigned int end, void *arg)
+{
+  vpImageSimulatorRendering *data = static_cast<vpImageSimulatorRendering *>(arg);
   vpImagePoint ip;
 
-  for (unsigned int i = (unsigned int)topFinal; i < (unsigned int)bottomFinal; i++)
+  for (unsigned int r = begin; r < end; r++)
   {
-    for (unsigned int j = (unsigned int)leftFinal; j < (unsigned int)rightFinal; j++)
+    unsigned int i = data->top + r;
+    double y = rowToMeter(data, i);
+    int *nearest = &data->nearest[r * data->roiWidth];
+    int last = -1;
+    for (unsigned int c = 0; c < data->roiWidth; c++)
     {
-      zmin = -1;
-      double x=0,y=0;
-      ip.set_ij(i,j);
-      vpPixelMeterConversion::convertPoint(cam,ip, x,y);
-      ip.set_ij(y,x);
-      for (int k = 0; k < (int)nbsimList; k++)
+      pixelToMeter(data, i, data->left + c, y, ip);
+      double zmin = -1;
+      int indice = -1;
+      for (int k = 0; k < (int)data->nbsimList; k++)
       {
-  double z = 0;
-  if(simList[k]->getPixelDepth(ip,z))
+        const double *bounds = &data->bounds[4 * k];
+        if (ip.get_u() < bounds[0] || ip.get_u() > bounds[1] || ip.get_v() < bounds[2] || ip.get_v() > bounds[3])
+          continue;
+        double z = 0;
+        if(data->simList[k]->getPixelDepth(ip,z))
+        {
+          if (z < zmin || zmin < 0)
+          {
+            zmin = z;
+            indice = k;
+          }
+        }
+      }
+      nearest[c] = indice;
+      if (indice >= 0)
+        last = indice;
+    }
+    data->previous[r] = last;
+  }
+}
+
+/*!
+  Render the rows [\e begin, \e end) of the roi from the z-buffer.
+*/
+void
+vpImageSimulator::shadingBand(unsigned int begin, unsigned int end, void *arg)
+{
+  vpImageSimulatorRendering *data = static_cast<vpImageSimulatorRendering *>(arg);
+  vpImagePoint ip;
+
+  for (unsigned int r = begin; r < end; r++)
   {
-    if (z < zmin || zmin < 0)
+    unsigned int i = data->top + r;
+    double y = rowToMeter(data, i);
+    const int *nearest = &data->nearest[r * data->roiWidth];
+    // A pixel that is not covered by any plane is rendered with the plane of
+    // the previous covered pixel, which leaves the default pixel value of
+    // this plane.
+    int indice = data->previous[r];
+    for (unsigned int c = 0; c < data->roiWidth; c++)
     {
-      zmin = z;
-      indice = k;
+      if (nearest[c] >= 0)
+        indice = nearest[c];
+      if (indice < 0)
+        continue;
+      unsigned int j = data->left + c;
+      pixelToMeter(data, i, j, y, ip);
+      if (data->Igray != NULL)
+        data->simList[indice]->getPixel(ip, nearest[c] >= 0, (*data->Igray)[i][j]);
+      else
+        data->simList[indice]->getPixel(ip, nearest[c] >= 0, (*data->Icolor)[i][j]);
     }
   }
-      }
-      if (indice >= 0)
+}
+
+/*!
+  Render the planes of \e simList in the roi [\e top, \e bottom) x [\e left,
+  \e right) of \e Igray or \e Icolor.
+
+  The rows are processed in parallel in two passes: the first one fills a
+  z-buffer with the index of the nearest plane, the second one samples the
+  textures of the planes kept in the z-buffer.
+*/
+void
+vpImageSimulator::render(vpImageSimulator **simList, unsigned int nbsimList, const vpCameraParameters &cam,
+                         unsigned int top, unsigned int bottom, unsigned int left, unsigned int right,
+                         vpImage<unsigned char> *Igray, vpImage<vpRGBa> *Icolor)
+{
+  if (top >= bottom || left >= right)
+    return;
+
+  vpImageSimulatorRendering data;
+  data.simList = simList;
+  data.nbsimList = nbsimList;
+  data.cam = &cam;
+  data.top = top;
+  data.left = left;
+  data.roiWidth = right - left;
+  data.Igray = Igray;
+  data.Icolor = Icolor;
+
+  unsigned int nbRows = bottom - top;
+  if (cam.get_projModel() == vpCameraParameters::perspectiveProjWithoutDistortion)
+  {
+    data.x.resize(data.roiWidth);
+    for (unsigned int c = 0; c < data.roiWidth; c++)
+    {
+      double y = 0;
+      vpPixelMeterConversion::convertPoint(cam, (double)(left + c), (double)top, data.x[c], y);
+    }
+  }
+  // The bounding box of the triangles of a plane is enlarged to contain all
+  // the points accepted by the tolerance of vpTriangle::inTriangle(), so that
+  // the planes can be skipped without changing the rendering.
+  data.bounds.resize(4 * nbsimList);
+  for (unsigned int k = 0; k < nbsimList; k++)
+  {
+    double xmin = std::numeric_limits<double>::max(), xmax = -std::numeric_limits<double>::max();
+    double ymin = std::numeric_limits<double>::max(), ymax = -std::numeric_limits<double>::max();
+    for (unsigned int t = 0; t < simList[k]->listTriangle.size(); t++)
+    {
+      vpImagePoint apex[3];
+      simList[k]->listTriangle[t].getTriangleApexes(apex[0], apex[1], apex[2]);
+      for (unsigned int a = 0; a < 3; a++)
       {
-        if (simList[indice]->colorI == GRAY_SCALED)
-        {
+        xmin = (std::min)(xmin, apex[a].get_u());
+        xmax = (std::max)(xmax, apex[a].get_u());
+        ymin = (std::min)(ymin, apex[a].get_v());
+        ymax = (std::max)(ymax, apex[a].get_v());
+      }
+    }
+    double margin = 0.01 * (std::max)(xmax - xmin, ymax - ymin);
+    data.bounds[4 * k] = xmin - margin;
+    data.bounds[4 * k + 1] = xmax + margin;
+    data.bounds[4 * k + 2] = ymin - margin;
+    data.bounds[4 * k + 3] = ymax + margin;
+  }
+  data.nearest.resize(nbRows * data.roiWidth);
+  data.previous.resize(nbRows);
+
+  vpThreadPool::parallelFor(0, nbRows, nearestPlaneBand, &data, 4);
+
+  int previous = -1;
+  for (unsigned int r = 0; r < nbRows; r++)
+  {
+    int last = data.previous[r];
+    data.previous[r] = previous;
+    if (last >= 0)
+      previous = last;
+  }
+
+  vpThreadPool::parallelFor(0, nbRows, shadingBand, &data, 4);
+}
+
+/*!
+  Get the value of the pixel \e iP rendered with this plane. If \e inside is
+  false, \e iP is not on the plane and \e Ipixel is set to the default value.
+*/
+void
+vpImageSimulator::getPixel(const vpImagePoint &iP, const bool inside, unsigned char &Ipixel) const
+{
+  double u, v;
+  if (colorI == GRAY_SCALED)
+  {
     unsigned char Ipixelplan = 255;
-          simList[indice]->getPixel(ip,Ipixelplan);
+    if (inside && getTextureCoordinates(iP, u, v))
+      getTexel(Ig, u, v, Ipixelplan);
+    Ipixel = Ipixelplan;
+  }
+  else if (colorI == COLORED)
+  {
+    vpRGBa Ipixelplan(255,255,255);
+    if (inside && getTextureCoordinates(iP, u, v))
+      getTexel(Ic, u, v, Ipixelplan);
+    unsigned char pixelgrey = (unsigned char)(0.2126 * Ipixelplan.R + 0.7152 * Ipixelplan.G + 0.0722 * Ipixelplan.B);
+    Ipixel = pixelgrey;
+  }
+}
+
+/*!
+  Get the value of the pixel \e iP rendered with this plane. If \e inside is
+  false, \e iP is not on the plane and \e Ipixel is set to the default value.
+*/
+void
+vpImageSimulator::getPixel(const vpImagePoint &iP, const bool inside, vpRGBa &Ipixel) const
+{
+  double u, v;
+  if (colorI == GRAY_SCALED)
+  {
+    unsigned char Ipixelplan = 255;
+    if (inside && getTextureCoordinates(iP, u, v))
+      getTexel(Ig, u, v, Ipixelplan);
     vpRGBa pixelcolor;
     pixelcolor.R = Ipixelplan;
     pixelcolor.G = Ipixelplan;
     pixelcolor.B = Ipixelplan;
-    *(bitmap+i*width+j) = pixelcolor;
-        }
-        else if (simList[indice]->colorI == COLORED)
-        {
+    Ipixel = pixelcolor;
+  }
+  else if (colorI == COLORED)
+  {
     vpRGBa Ipixelplan(255,255,255);
-    simList[indice]->getPixel(ip,Ipixelplan);
-    //unsigned char pixelgrey = 0.2126 * Ipixelplan.R + 0.7152 * Ipixelplan.G + 0.0722 * Ipixelplan.B;
-    *(bitmap+i*width+j)=Ipixelplan;
-        }
-      }
-    }
+    if (inside && getTextureCoordinates(iP, u, v))
+      getTexel(Ic, u, v, Ipixelplan);
+    Ipixel = Ipixelplan;
   }
-
-  delete[] simList;
 }
 
 /*!
@@ -1310,261 +1491,140 @@ vpImageSimulator::init(const char* file_image, const std::vector<vpPoint>& X_)
 }
 #endif
 
+/*!
+  Test if the point \e iP given in normalized coordinates is inside the
+  projection of the plane.
+*/
 bool
-vpImageSimulator::getPixel(const vpImagePoint &iP, unsigned char &Ipixelplan)
+vpImageSimulator::isInside(const vpImagePoint &iP) const
 {
-//  std::cout << "In get Pixel" << std::endl;
-  //test si pixel dans zone projetee
-  bool inside = false;
   for(unsigned int i = 0 ; i < listTriangle.size() ; i++)
-      if(listTriangle[i].inTriangle(iP)){
-          inside = true;
-          break;
-      }
-  if(!inside) return false;
-
-//  if(!T1.inTriangle(iP) && !T2.inTriangle(iP)){
-////      std::cout << "The pixel is inside the projected area" << std::endl;
-//    return false;}
-
-  //methoed algebrique
-  double z;
-
-  //calcul de la profondeur de l'intersection
-  z = distance/(normal_Cam_optim[0]*iP.get_u()+normal_Cam_optim[1]*iP.get_v()+normal_Cam_optim[2]);
-  //calcul coordonnees 3D intersection
-  Xinter_optim[0]=iP.get_u()*z;
-  Xinter_optim[1]=iP.get_v()*z;
-  Xinter_optim[2]=z;
-
-  //recuperation des coordonnes de l'intersection dans le plan objet
-  //repere plan object : 
-  //	centre = X0_2_optim[i] (premier point definissant le plan)
-  //	base =  u:(X[1]-X[0]) et v:(X[3]-X[0])
-  //ici j'ai considere que le plan est un rectangle => coordonnees sont simplement obtenu par un produit scalaire
-  double u = 0, v = 0;
-  for(unsigned int i = 0; i < 3; i++)
-  {
-    double diff = (Xinter_optim[i]-X0_2_optim[i]);
-    u += diff*vbase_u_optim[i];
-    v += diff*vbase_v_optim[i];
-  }
-  u = u/(euclideanNorm_u*euclideanNorm_u);
-  v = v/(euclideanNorm_v*euclideanNorm_v);
+    if(listTriangle[i].inTriangle(iP))
+      return true;
+  return false;
+}
 
-  if( u > 0 && v > 0 && u < 1. && v < 1.)
-  {
-    double i2,j2;
-    i2=v*(Ig.getHeight()-1);
-    j2=u*(Ig.getWidth()-1);
-    if (interp == BILINEAR_INTERPOLATION)
-      Ipixelplan = Ig.getValue(i2,j2);
-    else if (interp == SIMPLE)
-      Ipixelplan = Ig[(unsigned int)i2][(unsigned int)j2];
-    return true;
-  }
-  else
-    return false;
+/*!
+  Depth of the intersection between the plane and the line of sight going
+  through the point \e iP given in normalized coordinates.
+*/
+double
+vpImageSimulator::getDepth(const vpImagePoint &iP) const
+{
+  return distance/(normal_Cam_optim[0]*iP.get_u()+normal_Cam_optim[1]*iP.get_v()+normal_Cam_optim[2]);
 }
 
+/*!
+  Compute the coordinates \e u, \e v in [0, 1] of the intersection between
+  the plane and the line of sight going through the point \e iP. Return
+  false if the intersection is outside the textured rectangle.
+*/
 bool
-vpImageSimulator::getPixel(vpImage<unsigned char> &Isrc, 
-			   const vpImagePoint &iP, unsigned char &Ipixelplan)
+vpImageSimulator::getTextureCoordinates(const vpImagePoint &iP, double &u, double &v) const
 {
-  //test si pixel dans zone projetee
-  bool inside = false;
-  for(unsigned int i = 0 ; i < listTriangle.size() ; i++)
-      if(listTriangle[i].inTriangle(iP)){
-          inside = true;
-          break;
-      }
-  if(!inside) return false;
-
-//  if(!T1.inTriangle(iP) && !T2.inTriangle(iP))
-//    return false;
-
   //methoed algebrique
-  double z;
-
   //calcul de la profondeur de l'intersection
-  z = distance/(normal_Cam_optim[0]*iP.get_u()+normal_Cam_optim[1]*iP.get_v()+normal_Cam_optim[2]);
+  double z = getDepth(iP);
   //calcul coordonnees 3D intersection
-  Xinter_optim[0]=iP.get_u()*z;
-  Xinter_optim[1]=iP.get_v()*z;
-  Xinter_optim[2]=z;
+  double Xinter[3];
+  Xinter[0]=iP.get_u()*z;
+  Xinter[1]=iP.get_v()*z;
+  Xinter[2]=z;
 
   //recuperation des coordonnes de l'intersection dans le plan objet
   //repere plan object : 
   //	centre = X0_2_optim[i] (premier point definissant le plan)
   //	base =  u:(X[1]-X[0]) et v:(X[3]-X[0])
   //ici j'ai considere que le plan est un rectangle => coordonnees sont simplement obtenu par un produit scalaire
-  double u = 0, v = 0;
+  u = 0;
+  v = 0;
   for(unsigned int i = 0; i < 3; i++)
   {
-    double diff = (Xinter_optim[i]-X0_2_optim[i]);
+    double diff = (Xinter[i]-X0_2_optim[i]);
     u += diff*vbase_u_optim[i];
     v += diff*vbase_v_optim[i];
   }
   u = u/(euclideanNorm_u*euclideanNorm_u);
   v = v/(euclideanNorm_v*euclideanNorm_v);
 
-  if( u > 0 && v > 0 && u < 1. && v < 1.)
-  {
-    double i2,j2;
-    i2=v*(Isrc.getHeight()-1);
-    j2=u*(Isrc.getWidth()-1);
-    if (interp == BILINEAR_INTERPOLATION)
-      Ipixelplan = Isrc.getValue(i2,j2);
-    else if (interp == SIMPLE)
-      Ipixelplan = Isrc[(unsigned int)i2][(unsigned int)j2];
-    return true;
-  }
-  else
-    return false;
+  return ( u > 0 && v > 0 && u < 1. && v < 1.);
 }
 
+/*!
+  Sample the texture \e Isrc at the coordinates \e u, \e v given by
+  getTextureCoordinates().
+*/
+template<class Type>
+void
+vpImageSimulator::getTexel(const vpImage<Type> &Isrc, const double u, const double v, Type &Ipixelplan) const
+{
+  double i2,j2;
+  i2=v*(Isrc.getHeight()-1);
+  j2=u*(Isrc.getWidth()-1);
+  if (interp == BILINEAR_INTERPOLATION)
+    Ipixelplan = Isrc.getValue(i2,j2);
+  else if (interp == SIMPLE)
+    Ipixelplan = Isrc[(unsigned int)i2][(unsigned int)j2];
+}
 
 bool
-vpImageSimulator::getPixel(const vpImagePoint &iP, vpRGBa &Ipixelplan)
+vpImageSimulator::getPixel(const vpImagePoint &iP, unsigned char &Ipixelplan) const
 {
-  //test si pixel dans zone projetee
-  bool inside = false;
-  for(unsigned int i = 0 ; i < listTriangle.size() ; i++)
-      if(listTriangle[i].inTriangle(iP)){
-          inside = true;
-          break;
-      }
-  if(!inside) return false;
-//  if(!T1.inTriangle(iP) && !T2.inTriangle(iP))
-//    return false;
+  return getPixel(Ig, iP, Ipixelplan);
+}
 
-  //methoed algebrique
-  double z;
+bool
+vpImageSimulator::getPixel(const vpImage<unsigned char> &Isrc,
+			   const vpImagePoint &iP, unsigned char &Ipixelplan) const
+{
+  //test si pixel dans zone projetee
+  if(!isInside(iP)) return false;
 
-  //calcul de la profondeur de l'intersection
-  z = distance/(normal_Cam_optim[0]*iP.get_u()+normal_Cam_optim[1]*iP.get_v()+normal_Cam_optim[2]);
-  //calcul coordonnees 3D intersection
-  Xinter_optim[0]=iP.get_u()*z;
-  Xinter_optim[1]=iP.get_v()*z;
-  Xinter_optim[2]=z;
+  double u, v;
+  if(!getTextureCoordinates(iP, u, v))
+    return false;
 
-  //recuperation des coordonnes de l'intersection dans le plan objet
-  //repere plan object : 
-  //	centre = X0_2_optim[i] (premier point definissant le plan)
-  //	base =  u:(X[1]-X[0]) et v:(X[3]-X[0])
-  //ici j'ai considere que le plan est un rectangle => coordonnees sont simplement obtenu par un produit scalaire
-  double u = 0, v = 0;
-  for(unsigned int i = 0; i < 3; i++)
-  {
-    double diff = (Xinter_optim[i]-X0_2_optim[i]);
-    u += diff*vbase_u_optim[i];
-    v += diff*vbase_v_optim[i];
-  }
-  u = u/(euclideanNorm_u*euclideanNorm_u);
-  v = v/(euclideanNorm_v*euclideanNorm_v);
+  getTexel(Isrc, u, v, Ipixelplan);
+  return true;
+}
 
-  if( u > 0 && v > 0 && u < 1. && v < 1.)
-  {
-    double i2,j2;
-    i2=v*(Ic.getHeight()-1);
-    j2=u*(Ic.getWidth()-1);
-    if (interp == BILINEAR_INTERPOLATION)
-      Ipixelplan = Ic.getValue(i2,j2);
-    else if (interp == SIMPLE)
-      Ipixelplan = Ic[(unsigned int)i2][(unsigned int)j2];
-    return true;
-  }
-  else
-    return false;
+bool
+vpImageSimulator::getPixel(const vpImagePoint &iP, vpRGBa &Ipixelplan) const
+{
+  return getPixel(Ic, iP, Ipixelplan);
 }
 
 bool
-vpImageSimulator::getPixel(vpImage<vpRGBa> &Isrc, const vpImagePoint &iP,
-			   vpRGBa &Ipixelplan)
+vpImageSimulator::getPixel(const vpImage<vpRGBa> &Isrc, const vpImagePoint &iP,
+			   vpRGBa &Ipixelplan) const
 {
   //test si pixel dans zone projetee
-//  if(!T1.inTriangle(iP) && !T2.inTriangle(iP))
-//    return false;
-  bool inside = false;
-  for(unsigned int i = 0 ; i < listTriangle.size() ; i++)
-      if(listTriangle[i].inTriangle(iP)){
-          inside = true;
-          break;
-      }
-  if(!inside) return false;
-
-  //methoed algebrique
-  double z;
+  if(!isInside(iP)) return false;
 
-  //calcul de la profondeur de l'intersection
-  z = distance/(normal_Cam_optim[0]*iP.get_u()+normal_Cam_optim[1]*iP.get_v()+normal_Cam_optim[2]);
-  //calcul coordonnees 3D intersection
-  Xinter_optim[0]=iP.get_u()*z;
-  Xinter_optim[1]=iP.get_v()*z;
-  Xinter_optim[2]=z;
-
-  //recuperation des coordonnes de l'intersection dans le plan objet
-  //repere plan object : 
-  //	centre = X0_2_optim[i] (premier point definissant le plan)
-  //	base =  u:(X[1]-X[0]) et v:(X[3]-X[0])
-  //ici j'ai considere que le plan est un rectangle => coordonnees sont simplement obtenu par un produit scalaire
-  double u = 0, v = 0;
-  for(unsigned int i = 0; i < 3; i++)
-  {
-    double diff = (Xinter_optim[i]-X0_2_optim[i]);
-    u += diff*vbase_u_optim[i];
-    v += diff*vbase_v_optim[i];
-  }
-  u = u/(euclideanNorm_u*euclideanNorm_u);
-  v = v/(euclideanNorm_v*euclideanNorm_v);
-
-  if( u > 0 && v > 0 && u < 1. && v < 1.)
-  {
-    double i2,j2;
-    i2=v*(Isrc.getHeight()-1);
-    j2=u*(Isrc.getWidth()-1);
-    if (interp == BILINEAR_INTERPOLATION)
-      Ipixelplan = Isrc.getValue(i2,j2);
-    else if (interp == SIMPLE)
-      Ipixelplan = Isrc[(unsigned int)i2][(unsigned int)j2];
-    return true;
-  }
-  else
+  double u, v;
+  if(!getTextureCoordinates(iP, u, v))
     return false;
+
+  getTexel(Isrc, u, v, Ipixelplan);
+  return true;
 }
 
 bool 
-vpImageSimulator::getPixelDepth(const vpImagePoint &iP, double &Zpixelplan)
+vpImageSimulator::getPixelDepth(const vpImagePoint &iP, double &Zpixelplan) const
 {
   //test si pixel dans zone projetee
-    bool inside = false;
-    for(unsigned int i = 0 ; i < listTriangle.size() ; i++)
-        if(listTriangle[i].inTriangle(iP)){
-            inside = true;
-            break;
-        }
-    if(!inside) return false;
-//  if(!T1.inTriangle(iP) && !T2.inTriangle(iP))
-//    return false;
+  if(!isInside(iP)) return false;
 
-  Zpixelplan = distance/(normal_Cam_optim[0]*iP.get_u()+normal_Cam_optim[1]*iP.get_v()+normal_Cam_optim[2]);
+  Zpixelplan = getDepth(iP);
   return true;
 }
 
 bool
 vpImageSimulator::getPixelVisibility(const vpImagePoint &iP, 
-				     double &Visipixelplan)
+				     double &Visipixelplan) const
 {
   //test si pixel dans zone projetee
-  bool inside = false;
-  for(unsigned int i = 0 ; i < listTriangle.size() ; i++)
-      if(listTriangle[i].inTriangle(iP)){
-          inside = true;
-          break;
-      }
-  if(!inside) return false;
-//  if(!T1.inTriangle(iP) && !T2.inTriangle(iP))
-//    return false;
+  if(!isInside(iP)) return false;
   
   Visipixelplan = visible_result;
   return true;
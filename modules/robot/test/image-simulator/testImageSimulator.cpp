@@ -0,0 +1,156 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Render a scene of overlapping planes with several threads.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testImageSimulator.cpp
+
+  Render a scene of overlapping planes with vpImageSimulator using 1 and
+  several threads, and check that the images are identical pixel for pixel.
+*/
+
+#include <iostream>
+#include <list>
+
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/robot/vpImageSimulator.h>
+
+namespace
+{
+  // Poses of the planes: some of them overlap, intersect each other, are
+  // partially outside the image or seen from behind
+  const double planePoses[][6] = {
+    {  0.00,  0.00, 1.0, vpMath::rad(10), vpMath::rad(-20),   0.0 },
+    {  0.10,  0.05, 1.2, 0.0,              vpMath::rad(30),  vpMath::rad(15) },
+    { -0.10, -0.05, 0.9, vpMath::rad(-40), 0.0,               vpMath::rad(45) },
+    {  0.05, -0.10, 1.0, vpMath::rad(50),  vpMath::rad(10),  0.0 },
+    {  0.35,  0.20, 1.1, 0.0,              0.0,               vpMath::rad(-30) },
+    {  0.00,  0.10, 1.1, vpMath::rad(180), 0.0,               0.0 }
+  };
+  const unsigned int nbPlanes = sizeof(planePoses) / sizeof(planePoses[0]);
+
+  void initCorners(vpColVector *X, double size)
+  {
+    const double corners[4][2] = { {-1, -1}, {1, -1}, {1, 1}, {-1, 1} };
+    for (unsigned int i = 0; i < 4; i++) {
+      X[i].resize(3);
+      X[i][0] = size * corners[i][0];
+      X[i][1] = size * corners[i][1];
+      X[i][2] = 0;
+    }
+  }
+
+  template<class Type>
+  void initScene(std::list<vpImageSimulator> &list, const vpImage<Type> &texture,
+                 vpImageSimulator::vpColorPlan color, vpImageSimulator::vpInterpolationType interp)
+  {
+    vpColVector X[4];
+    initCorners(X, 0.15);
+    list.clear();
+    for (unsigned int k = 0; k < nbPlanes; k++) {
+      vpImageSimulator sim(color);
+      sim.setInterpolationType(interp);
+      sim.init(texture, X);
+      const double *p = planePoses[k];
+      sim.setCameraPosition(vpHomogeneousMatrix(p[0], p[1], p[2], p[3], p[4], p[5]));
+      list.push_back(sim);
+    }
+  }
+
+  template<class Type>
+  bool compareRendering(std::list<vpImageSimulator> &list, const vpCameraParameters &cam, const Type &background)
+  {
+    vpImage<Type> I_ref(240, 320, background);
+    vpThreadPool::setNumThreads(1);
+    vpImageSimulator::getImage(I_ref, list, cam);
+
+    const unsigned int nthreads[] = { 2, 3, 8 };
+    for (unsigned int t = 0; t < sizeof(nthreads) / sizeof(nthreads[0]); t++) {
+      vpImage<Type> I(240, 320, background);
+      vpThreadPool::setNumThreads(nthreads[t]);
+      vpImageSimulator::getImage(I, list, cam);
+      for (unsigned int i = 0; i < I.getSize(); i++) {
+        if (! (I.bitmap[i] == I_ref.bitmap[i])) {
+          std::cerr << "Pixel (" << i / I.getWidth() << ", " << i % I.getWidth() << ") differs with "
+                    << nthreads[t] << " threads" << std::endl;
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+}
+
+int main()
+{
+  try {
+    vpImage<unsigned char> texture_gray(64, 64);
+    vpImage<vpRGBa> texture_color(64, 64);
+    for (unsigned int i = 0; i < texture_gray.getHeight(); i++) {
+      for (unsigned int j = 0; j < texture_gray.getWidth(); j++) {
+        texture_gray[i][j] = (unsigned char)(((i / 8 + j / 8) % 2) ? 50 + 2 * i : 200 - j);
+        texture_color[i][j] = vpRGBa((unsigned char)(4 * i), (unsigned char)(4 * j), (unsigned char)(i ^ j), 0);
+      }
+    }
+
+    vpCameraParameters cams[2];
+    cams[0].initPersProjWithoutDistortion(300, 300, 160, 120);
+    cams[1].initPersProjWithDistortion(300, 300, 160, 120, -0.2, 0.2);
+    const vpImageSimulator::vpInterpolationType interps[2] = { vpImageSimulator::SIMPLE, vpImageSimulator::BILINEAR_INTERPOLATION };
+
+    unsigned int nthreads = vpThreadPool::getNumThreads();
+    bool ok = true;
+    std::list<vpImageSimulator> list;
+    for (unsigned int c = 0; c < 2 && ok; c++) {
+      for (unsigned int n = 0; n < 2 && ok; n++) {
+        initScene(list, texture_gray, vpImageSimulator::GRAY_SCALED, interps[n]);
+        ok = compareRendering(list, cams[c], (unsigned char)0);
+        if (ok) {
+          initScene(list, texture_color, vpImageSimulator::COLORED, interps[n]);
+          ok = compareRendering(list, cams[c], vpRGBa(0));
+        }
+      }
+    }
+    vpThreadPool::setNumThreads(nthreads);
+
+    if (! ok)
+      return 1;
+    std::cout << "The rendering doesn't depend on the number of threads" << std::endl;
+    return 0;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return 1;
+  }
+}
@@ -53,6 +53,7 @@
 #include <visp3/core/vpCameraParameters.h>
 #include <visp3/core/vpPixelMeterConversion.h>
 #include <visp3/core/vpMeterPixelConversion.h>
+#include <visp3/core/vpPointCloud.h>
 
 /*!
 
@@ -133,6 +134,7 @@ public:
   bool getDepthMap(vpImage<float>& map);
   bool getDepthMap(vpImage<float>& map, vpImage<unsigned char>& Imap);
   bool getRGB(vpImage<vpRGBa>& IRGB);
+  bool getPointCloud(vpPointCloud &pointcloud);
 
 
   inline void getIRCamParameters(vpCameraParameters &cam) const {
@@ -143,6 +145,8 @@ public:
   }
   inline void setIRCamParameters(const vpCameraParameters &cam) {
     IRcam = cam;
+    m_depth_rays_x.clear(); // The rays are computed again by getPointCloud()
+    m_depth_rays_y.clear();
   }
   inline void setRGBCamParameters(const vpCameraParameters &cam) {
     RGBcam = cam;
@@ -178,6 +182,10 @@ public:
   unsigned int height;//height of the rgb image
   unsigned int width;//width of the rgb image
 
+  std::vector<float> m_depth_rays_x;//normalized x coordinates of the depth map pixels
+  std::vector<float> m_depth_rays_y;//normalized y coordinates of the depth map pixels
+  std::vector<float> m_depth_buffer;//depth map at the DM resolution used by getPointCloud()
+
 };
 
 #endif
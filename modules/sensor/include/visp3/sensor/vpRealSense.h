@@ -46,6 +46,7 @@
 #include <visp3/core/vpException.h>
 #include <visp3/core/vpHomogeneousMatrix.h>
 #include <visp3/core/vpImage.h>
+#include <visp3/core/vpPointCloud.h>
 
 #ifdef VISP_HAVE_REALSENSE
 
@@ -168,6 +169,32 @@ int main()
 
     viewer->spinOnce (100);
   }
+}
+  \endcode
+
+  Without PCL, the point cloud can be acquired in a vpPointCloud, that stores
+  the coordinates of the points in contiguous arrays organized as the depth
+  map and is filled without memory allocation once it has the size of the
+  depth map. The colors of the points are only computed when they are
+  enabled:
+  \code
+#include <visp3/sensor/vpRealSense.h>
+
+int main()
+{
+  vpRealSense rs;
+  rs.open();
+
+  vpImage<vpRGBa> color;
+  vpPointCloud pointcloud;
+  pointcloud.enableColor(true);
+
+  while (1) {
+    rs.acquire(color, pointcloud);
+    const float *Z = pointcloud.getZ();
+    const unsigned char *valid = pointcloud.getValidMask();
+    // ...
+  }
 }
   \endcode
 */
@@ -178,6 +205,7 @@ public:
   virtual ~vpRealSense();
 
   void acquire(std::vector<vpColVector> &pointcloud);
+  void acquire(vpPointCloud &pointcloud);
 #ifdef VISP_HAVE_PCL
 	void acquire(pcl::PointCloud<pcl::PointXYZ>::Ptr &pointcloud);
   void acquire(pcl::PointCloud<pcl::PointXYZRGB>::Ptr &pointcloud);
@@ -185,6 +213,8 @@ public:
   void acquire(vpImage<unsigned char> &grey); // tested
   void acquire(vpImage<unsigned char> &grey, std::vector<vpColVector> &pointcloud);
   void acquire(vpImage<unsigned char> &grey, vpImage<uint16_t> &infrared, vpImage<uint16_t> &depth, std::vector<vpColVector> &pointcloud);
+  void acquire(vpImage<unsigned char> &grey, vpPointCloud &pointcloud);
+  void acquire(vpImage<unsigned char> &grey, vpImage<uint16_t> &infrared, vpImage<uint16_t> &depth, vpPointCloud &pointcloud);
 #ifdef VISP_HAVE_PCL
   void acquire(vpImage<unsigned char> &grey, pcl::PointCloud<pcl::PointXYZ>::Ptr &pointcloud);
   void acquire(vpImage<unsigned char> &grey, vpImage<uint16_t> &infrared, vpImage<uint16_t> &depth, pcl::PointCloud<pcl::PointXYZ>::Ptr &pointcloud);
@@ -194,6 +224,8 @@ public:
   void acquire(vpImage<vpRGBa> &color);  // tested
   void acquire(vpImage<vpRGBa> &color, std::vector<vpColVector> &pointcloud);
   void acquire(vpImage<vpRGBa> &color, vpImage<uint16_t> &infrared, vpImage<uint16_t> &depth, std::vector<vpColVector> &pointcloud);
+  void acquire(vpImage<vpRGBa> &color, vpPointCloud &pointcloud);
+  void acquire(vpImage<vpRGBa> &color, vpImage<uint16_t> &infrared, vpImage<uint16_t> &depth, vpPointCloud &pointcloud);
 
 #ifdef VISP_HAVE_PCL
   void acquire(vpImage<vpRGBa> &color, pcl::PointCloud<pcl::PointXYZ>::Ptr &pointcloud);
@@ -238,6 +270,8 @@ protected:
   float m_max_Z; //!< Maximal Z depth in meter
   bool m_enable_color;
   bool m_enable_depth;
+  std::vector<float> m_depth_rays_x; //!< Normalized x coordinates of the depth pixels, used by acquire(vpPointCloud &)
+  std::vector<float> m_depth_rays_y; //!< Normalized y coordinates of the depth pixels, used by acquire(vpPointCloud &)
 };
 
 #endif
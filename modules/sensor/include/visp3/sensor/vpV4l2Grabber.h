@@ -171,6 +171,22 @@ public:
     V4L2_MAX_FORMAT
   } vpV4l2PixelFormatType;
 
+  /*! \struct vpV4l2Buffer
+    View of a frame buffer mapped from the device and borrowed from the
+    driver, see acquireBuffer().
+  */
+  typedef struct {
+    unsigned char *data;       //!< Frame data in the grabber pixel format
+    size_t size;               //!< Number of bytes filled by the driver
+    unsigned int width;        //!< Frame width
+    unsigned int height;       //!< Frame height
+    unsigned int bytesperline; //!< Number of bytes of a frame line
+    vpV4l2PixelFormatType pixelformat; //!< Pixel format of the data
+    struct timeval timestamp;  //!< Time at which the frame was captured by the driver
+    unsigned int sequence;     //!< Frame sequence number set by the driver
+    unsigned int index;        //!< Index of the buffer in the ring
+  } vpV4l2Buffer;
+
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
   struct ng_video_fmt {
     unsigned int   pixelformat;         /* VIDEO_* */
@@ -225,8 +241,18 @@ public:
   void acquire(vpImage<unsigned char> &I, struct timeval &timestamp) ;
   void acquire(vpImage<vpRGBa> &I) ;
   void acquire(vpImage<vpRGBa> &I, struct timeval &timestamp) ;
+  void acquireBuffer(vpV4l2Buffer &buffer);
   bool getField();
   vpV4l2FramerateType getFramerate();
+  /*!
+    Get the number of buffers required for streaming data.
+
+    \sa setNBuffers()
+  */
+  inline unsigned int getNBuffers() const
+  {
+    return this->m_nbuffers;
+  }
   /*!
 
   Get the pixel format used for capture.
@@ -242,6 +268,8 @@ public:
   vpV4l2Grabber & operator>>(vpImage<unsigned char> &I);
   vpV4l2Grabber & operator>>(vpImage<vpRGBa> &I);
 
+  void releaseBuffer(const vpV4l2Buffer &buffer);
+
   /*!
     Activates the verbose mode to print additional information on stdout.
     \param verbose : If true activates the verbose mode.
@@ -272,21 +300,7 @@ public:
 
   void setScale(unsigned scale = vpV4l2Grabber::DEFAULT_SCALE) ;
 
-  /*!
-
-  Set the number of buffers required for streaming data.
-
-  For non real-time applications the number of buffers should be set to 1. For
-  real-time applications to reach 25 fps or 50 fps a good compromise is to set
-  the number of buffers to 3.
-
-  \param nbuffers : Number of ring buffers.
-
-  */
-  inline void setNBuffers(unsigned nbuffers)
-  {
-    this->m_nbuffers = nbuffers;
-  }
+  void setNBuffers(unsigned nbuffers);
 
   /*!
     Set the device name.
@@ -315,6 +329,10 @@ public:
 
   void close();
 
+  bool tryAcquire(vpImage<unsigned char> &I, struct timeval &timestamp);
+  bool tryAcquire(vpImage<vpRGBa> &I, struct timeval &timestamp);
+  bool tryAcquireBuffer(vpV4l2Buffer &buffer);
+
 private:
  
   void setFormat();
@@ -333,9 +351,12 @@ private:
   void getCapabilities();
   void startStreaming();
   void stopStreaming();
-  unsigned char * waiton(__u32 &index, struct timeval &timestamp);
-  int  queueBuffer();
+  unsigned char * waiton(__u32 &index, struct timeval &timestamp, bool blocking = true);
+  int  queueBuffer(__u32 index);
   void queueAll();
+  void convert(const unsigned char *bitmap, vpImage<unsigned char> &I);
+  void convert(const unsigned char *bitmap, vpImage<vpRGBa> &I);
+  void getBuffer(__u32 index, vpV4l2Buffer &buffer);
   void printBufInfo(struct v4l2_buffer buf);
 
   int				fd;
@@ -388,6 +388,39 @@ vpV4l2Grabber::setScale(unsigned scale)
   setHeight(480/scale);
 }
 
+/*!
+
+  Set the number of buffers required for streaming data.
+
+  For non real-time applications the number of buffers should be set to 1. For
+  real-time applications to reach 25 fps or 50 fps a good compromise is to set
+  the number of buffers to 3. Each buffer borrowed with acquireBuffer() is
+  removed from the ring until it is released, so one more buffer should be
+  added per buffer kept by the application.
+
+  The number of buffers is taken into account the next time the device is
+  opened.
+
+  \param nbuffers : Number of ring buffers, between 1 and
+  vpV4l2Grabber::MAX_BUFFERS.
+
+  \exception vpFrameGrabberException::settingError : Wrong number of buffers.
+
+*/
+void
+vpV4l2Grabber::setNBuffers(unsigned nbuffers)
+{
+  if ((nbuffers < 1) || (nbuffers > vpV4l2Grabber::MAX_BUFFERS))
+  {
+    vpERROR_TRACE("Wrong number of buffers %d, it should be between 1 and %d",
+                  nbuffers, vpV4l2Grabber::MAX_BUFFERS) ;
+    throw (vpFrameGrabberException(vpFrameGrabberException::settingError,
+				   "Wrong number of buffers") );
+  }
+
+  this->m_nbuffers = nbuffers;
+}
+
 /*!
   Initialize image acquisition in grey format.
   Set the pixel format acquisition to vpV4l2Grabber::V4L2_GREY_FORMAT.
@@ -571,6 +604,65 @@ vpV4l2Grabber::acquire(vpImage<unsigned char> &I, struct timeval &timestamp)
   unsigned  char *bitmap ;
   bitmap = waiton(index_buffer, timestamp);
 
+  convert(bitmap, I);
+
+  queueBuffer(index_buffer);
+}
+
+/*!
+  Acquire a grey level image if a frame is available, without waiting for the
+  device.
+
+  \param I : Image data structure (8 bits image), unchanged if no frame is
+  available.
+
+  \param timestamp : Timeval data structure providing the unix time
+  at which the frame was captured in the ringbuffer.
+
+  \return true if a frame was acquired, false if no frame is available yet.
+
+  \exception vpFrameGrabberException::initializationError : Frame grabber not
+  initialized.
+
+  \sa acquire(vpImage<unsigned char> &, struct timeval &)
+*/
+bool
+vpV4l2Grabber::tryAcquire(vpImage<unsigned char> &I, struct timeval &timestamp)
+{
+  if (init==false)
+  {
+    open(I);
+  }
+
+  if (init==false)
+  {
+    close();
+
+    throw (vpFrameGrabberException(vpFrameGrabberException::initializationError,
+				   "V4l2 frame grabber not initialized") );
+  }
+
+  unsigned  char *bitmap ;
+  bitmap = waiton(index_buffer, timestamp, false);
+  if (bitmap == NULL)
+    return false;
+
+  convert(bitmap, I);
+
+  queueBuffer(index_buffer);
+
+  return true;
+}
+
+/*!
+  Convert the content of a buffer into a grey level image.
+
+  \param bitmap : Buffer data in the grabber pixel format.
+  \param I : Image data structure (8 bits image), resized if needed.
+*/
+void
+vpV4l2Grabber::convert(const unsigned char *bitmap, vpImage<unsigned char> &I)
+{
   if ((I.getWidth() != width)||(I.getHeight() != height))
     I.resize(height, width) ;
 
@@ -598,8 +690,6 @@ vpV4l2Grabber::acquire(vpImage<unsigned char> &I, struct timeval &timestamp)
     std::cout << "V4L2 conversion not handled" << std::endl;
     break;
   }
-
-  queueAll();
 }
 
 /*!
@@ -652,6 +742,65 @@ vpV4l2Grabber::acquire(vpImage<vpRGBa> &I, struct timeval &timestamp)
   unsigned  char *bitmap ;
   bitmap = waiton(index_buffer, timestamp);
 
+  convert(bitmap, I);
+
+  queueBuffer(index_buffer);
+}
+
+/*!
+  Acquire a color image if a frame is available, without waiting for the
+  device.
+
+  \param I : Image data structure (32 bits image), unchanged if no frame is
+  available.
+
+  \param timestamp : Timeval data structure providing the unix time
+  at which the frame was captured in the ringbuffer.
+
+  \return true if a frame was acquired, false if no frame is available yet.
+
+  \exception vpFrameGrabberException::initializationError : Frame grabber not
+  initialized.
+
+  \sa acquire(vpImage<vpRGBa> &, struct timeval &)
+*/
+bool
+vpV4l2Grabber::tryAcquire(vpImage<vpRGBa> &I, struct timeval &timestamp)
+{
+  if (init==false)
+  {
+    open(I);
+  }
+
+  if (init==false)
+  {
+    close();
+
+    throw (vpFrameGrabberException(vpFrameGrabberException::initializationError,
+				   "V4l2 frame grabber not initialized") );
+  }
+
+  unsigned  char *bitmap ;
+  bitmap = waiton(index_buffer, timestamp, false);
+  if (bitmap == NULL)
+    return false;
+
+  convert(bitmap, I);
+
+  queueBuffer(index_buffer);
+
+  return true;
+}
+
+/*!
+  Convert the content of a buffer into a color image.
+
+  \param bitmap : Buffer data in the grabber pixel format.
+  \param I : Image data structure (32 bits image), resized if needed.
+*/
+void
+vpV4l2Grabber::convert(const unsigned char *bitmap, vpImage<vpRGBa> &I)
+{
   if ((I.getWidth() != width)||(I.getHeight() != height))
     I.resize(height, width) ;
 
@@ -681,9 +830,132 @@ vpV4l2Grabber::acquire(vpImage<vpRGBa> &I, struct timeval &timestamp)
     std::cout << "V4l2 conversion not handled" << std::endl;
     break;
   }
+}
+/*!
+  Acquire the next frame without copying it. The returned buffer is a view of
+  the memory mapped from the device: it is removed from the driver ring and
+  stays valid until it is given back with releaseBuffer() or until the grabber
+  is closed. Meanwhile the driver keeps on capturing in the other buffers, which
+  allows to process a frame while the next ones are acquired.
+
+  The data are in the grabber pixel format (see getPixelFormat()) and no color
+  conversion is done. With vpV4l2Grabber::V4L2_GREY_FORMAT and a line size equal
+  to the width, the buffer can be wrapped in an image without copy:
+  \code
+  vpV4l2Grabber::vpV4l2Buffer buffer;
+  g.acquireBuffer(buffer);
+  vpImage<unsigned char> I;
+  I.wrap(buffer.data, buffer.height, buffer.width);
+  // process I
+  g.releaseBuffer(buffer);
+  \endcode
 
-  queueAll();
+  \param buffer : Borrowed buffer with the frame and its kernel timestamp.
+
+  \exception vpFrameGrabberException::initializationError : Frame grabber not
+  initialized, the grabber has to be open with open() before.
+
+  \exception vpFrameGrabberException::otherError : All the buffers are already
+  borrowed or a frame can't be acquired.
+
+  \sa tryAcquireBuffer(), setNBuffers()
+*/
+void
+vpV4l2Grabber::acquireBuffer(vpV4l2Buffer &buffer)
+{
+  if (init==false)
+  {
+    throw (vpFrameGrabberException(vpFrameGrabberException::initializationError,
+				   "V4l2 frame grabber not initialized") );
+  }
+
+  struct timeval timestamp;
+  waiton(index_buffer, timestamp);
+
+  getBuffer(index_buffer, buffer);
+}
+
+/*!
+  Acquire the next frame without copying it if a frame is available, without
+  waiting for the device. See acquireBuffer() for the lifetime of the buffer.
+
+  \param buffer : Borrowed buffer with the frame and its kernel timestamp,
+  unchanged if no frame is available.
+
+  \return true if a frame was acquired and has to be released with
+  releaseBuffer(), false if no frame is available yet.
+
+  \exception vpFrameGrabberException::initializationError : Frame grabber not
+  initialized, the grabber has to be open with open() before.
+
+  \exception vpFrameGrabberException::otherError : All the buffers are already
+  borrowed or a frame can't be acquired.
+*/
+bool
+vpV4l2Grabber::tryAcquireBuffer(vpV4l2Buffer &buffer)
+{
+  if (init==false)
+  {
+    throw (vpFrameGrabberException(vpFrameGrabberException::initializationError,
+				   "V4l2 frame grabber not initialized") );
+  }
+
+  struct timeval timestamp;
+  if (waiton(index_buffer, timestamp, false) == NULL)
+    return false;
+
+  getBuffer(index_buffer, buffer);
+
+  return true;
 }
+
+/*!
+  Give back to the driver a buffer acquired with acquireBuffer() or
+  tryAcquireBuffer(). The buffer data must not be used anymore.
+
+  \param buffer : Borrowed buffer.
+
+  \exception vpFrameGrabberException::otherError : The buffer is not borrowed.
+*/
+void
+vpV4l2Grabber::releaseBuffer(const vpV4l2Buffer &buffer)
+{
+  // The buffers were unmapped when the streaming was stopped
+  if (streaming == false)
+    return;
+
+  if ((buffer.index >= reqbufs.count) || (buf_me[buffer.index].refcount == 0))
+  {
+    throw (vpFrameGrabberException(vpFrameGrabberException::otherError,
+				   "Buffer not borrowed") );
+  }
+
+  buf_me[buffer.index].refcount = 0;
+  queueBuffer(buffer.index);
+}
+
+/*!
+  Lend a dequeued buffer to the application.
+
+  \param index : Index of the dequeued buffer.
+  \param buffer : Buffer view.
+*/
+void
+vpV4l2Grabber::getBuffer(__u32 index, vpV4l2Buffer &buffer)
+{
+  buf_me[index].refcount = 1;
+
+  buffer.data = buf_me[index].data;
+  buffer.size = buf_v4l2[index].bytesused;
+  buffer.width = width;
+  buffer.height = height;
+  buffer.bytesperline = fmt_v4l2.fmt.pix.bytesperline;
+  buffer.pixelformat = m_pixelformat;
+  buffer.timestamp = buf_v4l2[index].timestamp;
+  buffer.sequence = buf_v4l2[index].sequence;
+  buffer.index = index;
+}
+
 /*!
 
   Return the field (odd or even) corresponding to the last acquired
@@ -1083,6 +1355,13 @@ vpV4l2Grabber::startStreaming()
 				   "Can't require video buffers") );
   }
 
+  // The driver may allocate more buffers than required
+  if (reqbufs.count > vpV4l2Grabber::MAX_BUFFERS)
+  {
+    throw (vpFrameGrabberException(vpFrameGrabberException::otherError,
+				   "Too many video buffers") );
+  }
+
   for (unsigned i = 0; i < reqbufs.count; i++) {
     // Clear the buffer
     memset (&(buf_v4l2[i]), 0, sizeof (buf_v4l2[i]));
@@ -1188,36 +1467,47 @@ vpV4l2Grabber::stopStreaming()
   \param timestamp : Timeval data structure providing the unix time
   [microseconds] at which the frame was captured in the ringbuffer.
 
+  \param blocking : If true wait for the next frame, otherwise return NULL if
+  no frame is available yet.
+
   \exception vpFrameGrabberException::otherError : If can't access to the
   frame.
 */
 unsigned char *
-vpV4l2Grabber::waiton(__u32 &index, struct timeval &timestamp)
+vpV4l2Grabber::waiton(__u32 &index, struct timeval &timestamp, bool blocking)
 {
   struct v4l2_buffer buf;
   struct timeval tv;
   fd_set rdset;
 
+  if (queue == waiton_cpt) {
+    index = 0;
+    throw (vpFrameGrabberException(vpFrameGrabberException::otherError,
+				   "Can't access to the frame: all the buffers are borrowed") );
+  }
+
   /* wait for the next frame */
  again:
 
-  tv.tv_sec  = 30;
-  tv.tv_usec = 0;
-  FD_ZERO(&rdset);
-  FD_SET(static_cast<unsigned int>(fd), &rdset);
-  switch (select(fd + 1, &rdset, NULL, NULL, &tv)) {
-  case -1:
-    if (EINTR == errno)
-      goto again;
-    index = 0;
-    throw (vpFrameGrabberException(vpFrameGrabberException::otherError,
-				   "Can't access to the frame") );
-    return NULL;
-  case  0:
-    index = 0;
-    throw (vpFrameGrabberException(vpFrameGrabberException::otherError,
-				   "Can't access to the frame: timeout") );
-    return NULL;
+  if (blocking) {
+    tv.tv_sec  = 30;
+    tv.tv_usec = 0;
+    FD_ZERO(&rdset);
+    FD_SET(static_cast<unsigned int>(fd), &rdset);
+    switch (select(fd + 1, &rdset, NULL, NULL, &tv)) {
+    case -1:
+      if (EINTR == errno)
+        goto again;
+      index = 0;
+      throw (vpFrameGrabberException(vpFrameGrabberException::otherError,
+				     "Can't access to the frame") );
+      return NULL;
+    case  0:
+      index = 0;
+      throw (vpFrameGrabberException(vpFrameGrabberException::otherError,
+				     "Can't access to the frame: timeout") );
+      return NULL;
+    }
   }
 
 
@@ -1227,6 +1517,9 @@ vpV4l2Grabber::waiton(__u32 &index, struct timeval &timestamp)
   buf.memory = V4L2_MEMORY_MMAP; // Fabien manquait
   if (-1 == v4l2_ioctl(fd,VIDIOC_DQBUF, &buf)) {
     index = 0;
+    // No frame available yet
+    if ((EAGAIN == errno) && (blocking == false))
+      return NULL;
     switch(errno)
     {
     case EAGAIN:
@@ -1269,26 +1562,24 @@ vpV4l2Grabber::waiton(__u32 &index, struct timeval &timestamp)
 
 /*!
 
- Capture helpers.
+ Capture helpers. Give a buffer back to the driver.
+
+ \param index : Index of the buffer in the ring.
+
+ \return 0 if the buffer is queued, -1 if it is borrowed by the application.
 
 */
 int
-vpV4l2Grabber::queueBuffer()
+vpV4l2Grabber::queueBuffer(__u32 index)
 {
-  unsigned int frame = queue % reqbufs.count;
   int rc;
 
+  // The buffer is queued again when the application releases it
+  if (0 != buf_me[index].refcount)
+    return -1;
 
-  if (0 != buf_me[frame].refcount) {
-    if (0 != queue - waiton_cpt)
-      return -1;
-    fprintf(stderr,"v4l2: waiting for a free buffer..............\n");
-    //ng_waiton_video_buf(h->buf_me+frame);
-    std::cout << "Normalement call ng_waiton_video_buf(buf_me+frame); --------\n";
-  }
-
-  //    std::cout << "frame: " << frame << std::endl;
-  rc = v4l2_ioctl(fd, VIDIOC_QBUF, &buf_v4l2[frame]);
+  //    std::cout << "frame: " << index << std::endl;
+  rc = v4l2_ioctl(fd, VIDIOC_QBUF, &buf_v4l2[index]);
   if (0 == rc)
     queue++;
   else
@@ -1318,19 +1609,14 @@ vpV4l2Grabber::queueBuffer()
 
 /*!
 
-  Call the queue buffer private method if needed
+  Queue all the buffers of the ring when the streaming starts.
 
 */
 void
 vpV4l2Grabber::queueAll()
 {
-  for (;;) {
-    if (queue - waiton_cpt >= reqbufs.count) {
-      return;
-    }
-    if (0 != queueBuffer()) {
-      return;
-    }
+  for (__u32 index = 0; index < reqbufs.count; index++) {
+    queueBuffer(index);
   }
 }
 
@@ -58,7 +58,8 @@ vpKinect::vpKinect(freenect_context *ctx, int index)
     m_new_rgb_frame(false),
     m_new_depth_map(false),
     m_new_depth_image(false),
-    height(480), width(640)
+    height(480), width(640),
+    m_depth_rays_x(), m_depth_rays_y(), m_depth_buffer()
 {
   dmap.resize(height, width);
   IRGB.resize(height, width);
@@ -112,6 +113,10 @@ void vpKinect::start(vpKinect::vpDMResolution res)
   	RGBcam.initPersProjWithDistortion(522.5431816996,522.7191431808,311.4001982614,267.4283562142,0.0477365207,-0.0462326418);//new
 #endif
 
+  // The rays of the depth map depend on IRcam
+  m_depth_rays_x.clear();
+  m_depth_rays_y.clear();
+
   this->startVideo();
   this->startDepth();
 }
@@ -248,6 +253,73 @@ bool vpKinect::getRGB(vpImage<vpRGBa>& I_RGB)
   return true;
 }
 
+/*!
+  Get the point cloud of the last depth map, at the depth map resolution
+  given to start(). The points are expressed in meter in the IR camera frame
+  and the points without depth are invalid.
+
+  If the colors of the point cloud are enabled with
+  vpPointCloud::enableColor(), the points are colored with the last RGB image
+  using the RGB camera parameters and the transformation between the two
+  cameras. Invalid points and points outside of the RGB image are black.
+
+  \return false if there is no new depth map since the last call to
+  getDepthMap() or getPointCloud(), true otherwise.
+*/
+bool vpKinect::getPointCloud(vpPointCloud &pointcloud)
+{
+  // Copy the depth map at the DM resolution and release the depth thread
+  m_depth_mutex.lock();
+  if (!m_new_depth_map) {
+    m_depth_mutex.unlock();
+    return false;
+  }
+  m_depth_buffer.resize(hd*wd);
+  if (DMres == DMAP_LOW_RES) {
+    for (unsigned int i = 0; i < hd; i++)
+      for (unsigned int j = 0; j < wd; j++)
+        m_depth_buffer[i*wd + j] = dmap[i<<1][j<<1];
+  }
+  else {
+    memcpy(&m_depth_buffer[0], dmap.bitmap, hd*wd*sizeof(float));
+  }
+  m_new_depth_map = false;
+  m_depth_mutex.unlock();
+
+  if (m_depth_rays_x.size() != hd*wd)
+    vpPointCloud::computeRays(IRcam, hd, wd, m_depth_rays_x, m_depth_rays_y);
+
+  pointcloud.buildFrom(&m_depth_buffer[0], hd, wd, m_depth_rays_x, m_depth_rays_y);
+
+  if (pointcloud.hasColor()) {
+    const float *X = pointcloud.getX();
+    const float *Y = pointcloud.getY();
+    const float *Z = pointcloud.getZ();
+    const unsigned char *valid = pointcloud.getValidMask();
+    vpRGBa *color = pointcloud.getColor();
+    double u = 0., v = 0.;
+
+    vpMutex::vpScopedLock lock(m_rgb_mutex);
+    for (unsigned int k = 0; k < pointcloud.size(); k++) {
+      color[k] = vpRGBa(0);
+      if (valid[k]) {
+        //! Change frame :
+        double X2 = rgbMir[0][0]*X[k] + rgbMir[0][1]*Y[k] + rgbMir[0][2]*Z[k] + rgbMir[0][3];
+        double Y2 = rgbMir[1][0]*X[k] + rgbMir[1][1]*Y[k] + rgbMir[1][2]*Z[k] + rgbMir[1][3];
+        double Z2 = rgbMir[2][0]*X[k] + rgbMir[2][1]*Y[k] + rgbMir[2][2]*Z[k] + rgbMir[2][3];
+        if (Z2 > std::numeric_limits<double>::epsilon()) {
+          //! compute pixel coordinates of the point in the RGB image
+          vpMeterPixelConversion::convertPoint(RGBcam, X2/Z2, Y2/Z2, u, v);
+          if ((u >= 0) && (v >= 0) && ((unsigned int)u < IRGB.getWidth()) && ((unsigned int)v < IRGB.getHeight()))
+            color[k] = IRGB[(unsigned int)v][(unsigned int)u];
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
 /*!
   Warp the RGB frame to the depth camera frame. The size of the resulting IrgbWarped frame is the same as the size of the depth map Idepth
 */
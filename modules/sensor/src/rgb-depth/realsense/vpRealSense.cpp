@@ -49,7 +49,8 @@
  * Default constructor.
  */
 vpRealSense::vpRealSense()
-  : m_context(), m_device(NULL), m_num_devices(0), m_serial_no(), m_intrinsics(), m_max_Z(8), m_enable_color(true), m_enable_depth(true)
+  : m_context(), m_device(NULL), m_num_devices(0), m_serial_no(), m_intrinsics(), m_max_Z(8), m_enable_color(true), m_enable_depth(true),
+    m_depth_rays_x(), m_depth_rays_y()
 {
 
 }
@@ -117,6 +118,9 @@ void vpRealSense::open()
 
     m_intrinsics.push_back(intrin);
   }
+  // The rays used to fill a vpPointCloud depend on the depth intrinsics
+  m_depth_rays_x.clear();
+  m_depth_rays_y.clear();
 
   // Start device
   m_device->start();
@@ -407,6 +411,138 @@ void vpRealSense::acquire(vpImage<vpRGBa> &color, std::vector<vpColVector> &poin
   vp_rs_get_pointcloud_impl(m_device, m_intrinsics, m_max_Z, pointcloud);
 }
 
+/*!
+  Acquire data from RealSense device.
+  \param pointcloud : Point cloud data stored in contiguous arrays. The colors of the points are filled from the color
+  stream when they are enabled with vpPointCloud::enableColor().
+ */
+void vpRealSense::acquire(vpPointCloud &pointcloud)
+{
+  if (m_device == NULL) {
+    throw vpException(vpException::fatalError, "RealSense Camera - Device not opened!");
+  }
+  if (! m_device->is_streaming()) {
+    open();
+  }
+
+  m_device->wait_for_frames();
+
+  // Retrieve point cloud
+  vp_rs_get_pointcloud_impl(m_device, m_intrinsics, m_max_Z, m_depth_rays_x, m_depth_rays_y, pointcloud);
+}
+
+/*!
+  Acquire data from RealSense device.
+  \param grey : Grey level image.
+  \param pointcloud : Point cloud data stored in contiguous arrays. The colors of the points are filled from the color
+  stream when they are enabled with vpPointCloud::enableColor().
+ */
+void vpRealSense::acquire(vpImage<unsigned char> &grey, vpPointCloud &pointcloud)
+{
+  if (m_device == NULL) {
+    throw vpException(vpException::fatalError, "RealSense Camera - Device not opened!");
+  }
+  if (! m_device->is_streaming()) {
+    open();
+  }
+
+  m_device->wait_for_frames();
+
+  // Retrieve grey image
+  vp_rs_get_grey_impl(m_device, m_intrinsics, grey);
+
+  // Retrieve point cloud
+  vp_rs_get_pointcloud_impl(m_device, m_intrinsics, m_max_Z, m_depth_rays_x, m_depth_rays_y, pointcloud);
+}
+
+/*!
+  Acquire data from RealSense device.
+  \param grey : Grey level image.
+  \param infrared : Infrared image.
+  \param depth : Depth image.
+  \param pointcloud : Point cloud data stored in contiguous arrays. The colors of the points are filled from the color
+  stream when they are enabled with vpPointCloud::enableColor().
+ */
+void vpRealSense::acquire(vpImage<unsigned char> &grey, vpImage<uint16_t> &infrared, vpImage<uint16_t> &depth, vpPointCloud &pointcloud)
+{
+  if (m_device == NULL) {
+    throw vpException(vpException::fatalError, "RealSense Camera - Device not opened!");
+  }
+  if (! m_device->is_streaming()) {
+    open();
+  }
+
+  m_device->wait_for_frames();
+
+  // Retrieve grey image
+  vp_rs_get_grey_impl(m_device, m_intrinsics, grey);
+
+  // Retrieve infrared image
+  vp_rs_get_frame_data_impl(m_device, m_intrinsics, rs::stream::infrared, infrared);
+
+  // Retrieve depth image
+  vp_rs_get_frame_data_impl(m_device, m_intrinsics, rs::stream::depth, depth);
+
+  // Retrieve point cloud
+  vp_rs_get_pointcloud_impl(m_device, m_intrinsics, m_max_Z, m_depth_rays_x, m_depth_rays_y, pointcloud);
+}
+
+/*!
+  Acquire data from RealSense device.
+  \param color : Color image.
+  \param pointcloud : Point cloud data stored in contiguous arrays. The colors of the points are filled from the color
+  stream when they are enabled with vpPointCloud::enableColor().
+ */
+void vpRealSense::acquire(vpImage<vpRGBa> &color, vpPointCloud &pointcloud)
+{
+  if (m_device == NULL) {
+    throw vpException(vpException::fatalError, "RealSense Camera - Device not opened!");
+  }
+  if (! m_device->is_streaming()) {
+    open();
+  }
+
+  m_device->wait_for_frames();
+
+  // Retrieve color image
+  vp_rs_get_color_impl(m_device, m_intrinsics, color);
+
+  // Retrieve point cloud
+  vp_rs_get_pointcloud_impl(m_device, m_intrinsics, m_max_Z, m_depth_rays_x, m_depth_rays_y, pointcloud);
+}
+
+/*!
+  Acquire data from RealSense device.
+  \param color : Color image.
+  \param infrared : Infrared image.
+  \param depth : Depth image.
+  \param pointcloud : Point cloud data stored in contiguous arrays. The colors of the points are filled from the color
+  stream when they are enabled with vpPointCloud::enableColor().
+ */
+void vpRealSense::acquire(vpImage<vpRGBa> &color, vpImage<uint16_t> &infrared, vpImage<uint16_t> &depth, vpPointCloud &pointcloud)
+{
+  if (m_device == NULL) {
+    throw vpException(vpException::fatalError, "RealSense Camera - Device not opened!");
+  }
+  if (! m_device->is_streaming()) {
+    open();
+  }
+
+  m_device->wait_for_frames();
+
+  // Retrieve color image
+  vp_rs_get_color_impl(m_device, m_intrinsics, color);
+
+  // Retrieve infrared image
+  vp_rs_get_frame_data_impl(m_device, m_intrinsics, rs::stream::infrared, infrared);
+
+  // Retrieve depth image
+  vp_rs_get_frame_data_impl(m_device, m_intrinsics, rs::stream::depth, depth);
+
+  // Retrieve point cloud
+  vp_rs_get_pointcloud_impl(m_device, m_intrinsics, m_max_Z, m_depth_rays_x, m_depth_rays_y, pointcloud);
+}
+
 #ifdef VISP_HAVE_PCL
 /*!
   Acquire data from RealSense device.
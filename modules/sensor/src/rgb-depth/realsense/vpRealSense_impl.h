@@ -38,6 +38,7 @@
 #include <librealsense/rs.hpp>
 #include <visp3/core/vpConfig.h>
 #include <visp3/core/vpImage.h>
+#include <visp3/core/vpPointCloud.h>
 
 template <class Type>
 void vp_rs_get_frame_data_impl(const rs::device *m_device, const std::vector <rs::intrinsics> &m_intrinsics, const rs::stream &stream, vpImage<Type> &data)
@@ -128,6 +129,74 @@ void vp_rs_get_pointcloud_impl(const rs::device *m_device, const std::vector <rs
   }
 }
 
+// Retrieve point cloud in contiguous arrays
+void vp_rs_get_pointcloud_impl(const rs::device *m_device, const std::vector <rs::intrinsics> &m_intrinsics, float max_Z,
+                               std::vector<float> &rays_x, std::vector<float> &rays_y, vpPointCloud &pointcloud)
+{
+  if (m_device->is_stream_enabled(rs::stream::depth)) {
+    const rs::intrinsics &depth_intrinsics = m_intrinsics[RS_STREAM_DEPTH];
+    int width = depth_intrinsics.width;
+    int height = depth_intrinsics.height;
+
+    // The deprojection is linear in depth: the rays of the depth pixels only
+    // depend on the intrinsics and are computed once
+    if (rays_x.size() != (size_t)(width*height) || rays_y.size() != (size_t)(width*height)) {
+      rays_x.resize(width*height);
+      rays_y.resize(width*height);
+      for (int i = 0; i < height; i++) {
+        for (int j = 0; j < width; j++) {
+          rs::float2 depth_pixel = { (float) j, (float) i};
+          rs::float3 ray = depth_intrinsics.deproject(depth_pixel, 1.f);
+          rays_x[i*width + j] = ray.x;
+          rays_y[i*width + j] = ray.y;
+        }
+      }
+    }
+
+    pointcloud.buildFrom((const uint16_t *)m_device->get_frame_data(rs::stream::depth), (unsigned int)height, (unsigned int)width,
+                         m_device->get_depth_scale(), rays_x, rays_y, max_Z);
+
+    if (pointcloud.hasColor()) {
+      // For invalid points and out of bounds color data, default to a shade of blue in order to visually distinguish holes.
+      // This color value is same as the librealsense out of bounds color value.
+      const vpRGBa hole(96, 157, 198);
+      vpRGBa *point_color = pointcloud.getColor();
+      const unsigned char *valid = pointcloud.getValidMask();
+      const float *X = pointcloud.getX();
+      const float *Y = pointcloud.getY();
+      const float *Z = pointcloud.getZ();
+
+      if (m_device->is_stream_enabled(rs::stream::color) && m_device->get_stream_format(rs::stream::color) == rs::format::rgb8) {
+        rs::extrinsics depth_2_color_extrinsic = m_device->get_extrinsics(rs::stream::depth, rs::stream::color);
+        const rs::intrinsics &color_intrinsics = m_intrinsics[RS_STREAM_COLOR];
+        const unsigned char *color = (const unsigned char *)m_device->get_frame_data(rs::stream::color);
+        int color_width = color_intrinsics.width;
+        int color_height = color_intrinsics.height;
+
+        for (unsigned int k = 0; k < pointcloud.size(); k++) {
+          point_color[k] = hole;
+          if (valid[k]) {
+            rs::float3 depth_point = { X[k], Y[k], Z[k] };
+            rs::float2 color_pixel = color_intrinsics.project(depth_2_color_extrinsic.transform(depth_point));
+            if (color_pixel.y >= 0 && color_pixel.y < color_height && color_pixel.x >= 0 && color_pixel.x < color_width) {
+              const unsigned char *rgb = color + ((int)color_pixel.y*color_width + (int)color_pixel.x)*3;
+              point_color[k] = vpRGBa(rgb[0], rgb[1], rgb[2]);
+            }
+          }
+        }
+      }
+      else {
+        for (unsigned int k = 0; k < pointcloud.size(); k++) {
+          point_color[k] = hole;
+        }
+      }
+    }
+  }
+  else {
+    pointcloud.clear();
+  }
+}
+
 #ifdef VISP_HAVE_PCL
 // Retrieve point cloud
 void vp_rs_get_pointcloud_impl(const rs::device *m_device, const std::vector <rs::intrinsics> &m_intrinsics, float max_Z, pcl::PointCloud<pcl::PointXYZ>::Ptr &pointcloud)
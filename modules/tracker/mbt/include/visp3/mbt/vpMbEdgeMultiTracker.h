@@ -76,6 +76,9 @@ protected:
   //! Map of pyramidal images for each camera
   std::map<std::string, std::vector<const vpImage<unsigned char>* > > m_mapOfPyramidalImages;
 
+  //! Map of the storage of the pyramid levels for each camera, kept between two images
+  std::map<std::string, vpImagePyramid> m_mapOfImagePyramids;
+
   //! Name of the reference camera
   std::string m_referenceCameraName;
 
@@ -283,6 +286,8 @@ public:
   virtual void setMovingEdge(const vpMe &me);
   virtual void setMovingEdge(const std::string &cameraName, const vpMe &me);
 
+  virtual void setNbThreads(const unsigned int nb);
+
   virtual void setNearClippingDistance(const double &dist);
   virtual void setNearClippingDistance(const std::string &cameraName, const double &dist);
 
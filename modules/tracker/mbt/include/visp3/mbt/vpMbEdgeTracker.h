@@ -54,6 +54,7 @@
 #include <visp3/mbt/vpMbtDistanceCylinder.h>
 #include <visp3/core/vpXmlParser.h>
 #include <visp3/core/vpRobust.h>
+#include <visp3/core/vpImagePyramid.h>
 
 #include <iostream>
 #include <fstream>
@@ -304,6 +305,9 @@ class VISP_EXPORT vpMbEdgeTracker: virtual public vpMbTracker
     
     //! Pyramid of image associated to the current image. This pyramid is computed in the init() and in the track() methods.
     std::vector< const vpImage<unsigned char>* > Ipyramid;
+
+    //! Storage of the pyramid levels, kept between two images.
+    vpImagePyramid m_pyramid;
     
     //! Current scale level used. This attribute must not be modified outside of the downScale() and upScale() methods, as it used to specify to some methods which set of distanceLine use. 
     unsigned int scaleLevel;
@@ -311,6 +315,12 @@ class VISP_EXPORT vpMbEdgeTracker: virtual public vpMbTracker
     //! Number of features used in the computation of the projection error
     unsigned int nbFeaturesForProjErrorComputation;
 
+    //! Number of threads used to track the moving edges (1 for a sequential tracking, 0 for all the threads of vpThreadPool).
+    unsigned int nbThreads;
+
+    //! Copies of the moving edges parameters, one for each worker updating the moving edges in parallel.
+    std::vector<vpMe> meThreads;
+
 public:
   
   vpMbEdgeTracker(); 
@@ -349,6 +359,15 @@ public:
   virtual inline vpMe getMovingEdge() const { return this->me;}
 
   virtual unsigned int getNbPoints(const unsigned int level=0) const;
+
+  /*!
+    Get the number of threads used to track the moving edges.
+
+    \return The number of threads, 0 meaning that all the threads of vpThreadPool are used.
+
+    \sa setNbThreads()
+  */
+  inline unsigned int getNbThreads() const { return nbThreads; }
   
   /*!
     Return the scales levels used for the tracking. 
@@ -459,6 +478,8 @@ public:
   
   void setMovingEdge(const vpMe &me);
 
+  virtual void setNbThreads(const unsigned int nb);
+
   virtual void setPose(const vpImage<unsigned char> &I, const vpHomogeneousMatrix& cdMo);
   
   void setScales(const std::vector<bool>& _scales);
@@ -466,6 +487,7 @@ public:
   void setUseEdgeTracking(const std::string &name, const bool &useEdgeTracking);
 
   void track(const vpImage<unsigned char> &I);
+  void track(const vpImagePyramid &pyramid);
   //@}
 
 protected:
@@ -514,6 +536,7 @@ protected:
   unsigned int initMbtTracking(unsigned int &nberrors_lines, unsigned int &nberrors_cylinders, unsigned int &nberrors_circles);
   void initMovingEdge(const vpImage<unsigned char> &I, const vpHomogeneousMatrix &_cMo) ;
   void initPyramid(const vpImage<unsigned char>& _I, std::vector<const vpImage<unsigned char>* >& _pyramid);
+  void initPyramid(const vpImagePyramid& pyramid, std::vector<const vpImage<unsigned char>* >& _pyramid);
   void reInitLevel(const unsigned int _lvl);
   void reinitMovingEdge(const vpImage<unsigned char> &I, const vpHomogeneousMatrix &_cMo);
   void removeCircle(const std::string& name);
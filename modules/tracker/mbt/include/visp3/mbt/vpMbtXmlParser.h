@@ -79,11 +79,14 @@ protected:
     mu2,
     sample,
     step,
+    nb_threads,
     last
   } dataToParseMb;
 
   //! Moving edges parameters.
   vpMe m_ecm;
+  //! Number of threads used to track the moving edges.
+  unsigned int m_nbThreads;
 
 
 public:
@@ -94,6 +97,13 @@ public:
 
   void getMe(vpMe& _ecm) const { _ecm = this->m_ecm;}
 
+  /*!
+    Get the number of threads used to track the moving edges.
+
+    \return The number of threads, see vpMbEdgeTracker::setNbThreads().
+  */
+  inline unsigned int getNbThreads() const { return m_nbThreads; }
+
   void parse(const char * filename);
 
   virtual void readMainClass(xmlDocPtr doc, xmlNodePtr node);
@@ -106,6 +116,13 @@ public:
   
   void setMovingEdge(const vpMe &_ecm){ m_ecm = _ecm; }
 
+  /*!
+    Set the number of threads used to track the moving edges.
+
+    \param nb : Number of threads, see vpMbEdgeTracker::setNbThreads().
+  */
+  inline void setNbThreads(const unsigned int nb) { m_nbThreads = nb; }
+
   void writeMainClass(xmlNodePtr node);
   //@}
 
@@ -53,7 +53,7 @@
   Basic constructor
 */
 vpMbEdgeMultiTracker::vpMbEdgeMultiTracker() : m_mapOfCameraTransformationMatrix(), m_mapOfEdgeTrackers(),
-    m_mapOfPyramidalImages(), m_referenceCameraName("Camera") {
+    m_mapOfPyramidalImages(), m_mapOfImagePyramids(), m_referenceCameraName("Camera") {
   m_mapOfEdgeTrackers["Camera"] = new vpMbEdgeTracker();
 
   //Add default camera transformation matrix
@@ -66,7 +66,7 @@ vpMbEdgeMultiTracker::vpMbEdgeMultiTracker() : m_mapOfCameraTransformationMatrix
   \param nbCameras : Number of cameras to use.
 */
 vpMbEdgeMultiTracker::vpMbEdgeMultiTracker(const unsigned int nbCameras) : m_mapOfCameraTransformationMatrix(),
-    m_mapOfEdgeTrackers(), m_mapOfPyramidalImages(), m_referenceCameraName("Camera") {
+    m_mapOfEdgeTrackers(), m_mapOfPyramidalImages(), m_mapOfImagePyramids(), m_referenceCameraName("Camera") {
 
   if(nbCameras == 0) {
     throw vpException(vpTrackingException::fatalError, "Cannot construct a vpMbEdgeMultiTracker with no camera !");
@@ -107,7 +107,7 @@ vpMbEdgeMultiTracker::vpMbEdgeMultiTracker(const unsigned int nbCameras) : m_map
   \param cameraNames : List of camera names.
 */
 vpMbEdgeMultiTracker::vpMbEdgeMultiTracker(const std::vector<std::string> &cameraNames) : m_mapOfCameraTransformationMatrix(),
-    m_mapOfEdgeTrackers(), m_mapOfPyramidalImages(), m_referenceCameraName("Camera") {
+    m_mapOfEdgeTrackers(), m_mapOfPyramidalImages(), m_mapOfImagePyramids(), m_referenceCameraName("Camera") {
 
   if(cameraNames.empty()) {
     throw vpException(vpTrackingException::fatalError, "Cannot construct a vpMbEdgeMultiTracker with no camera !");
@@ -135,19 +135,16 @@ vpMbEdgeMultiTracker::~vpMbEdgeMultiTracker() {
   cleanPyramid(m_mapOfPyramidalImages);
 }
 
+/*!
+  Clean the pyramids of images set by initPyramid(). The images belong to the
+  pyramids kept by the tracker between two images and are not freed.
+
+  \param pyramid : Map of pyramids of images to clean.
+*/
 void vpMbEdgeMultiTracker::cleanPyramid(std::map<std::string, std::vector<const vpImage<unsigned char>* > >& pyramid) {
   for(std::map<std::string, std::vector<const vpImage<unsigned char>* > >::iterator it1 = pyramid.begin();
       it1 != pyramid.end(); ++it1) {
-    if(it1->second.size() > 0){
-      it1->second[0] = NULL;
-      for(size_t i = 1; i < it1->second.size(); i++) {
-        if(it1->second[i] != NULL) {
-          delete it1->second[i];
-          it1->second[i] = NULL;
-        }
-      }
-      it1->second.clear();
-    }
+    it1->second.clear();
   }
 }
 
@@ -1647,9 +1644,11 @@ void vpMbEdgeMultiTracker::initPyramid(const std::map<std::string, const vpImage
 {
   for(std::map<std::string, const vpImage<unsigned char> * >::const_iterator it = mapOfImages.begin();
       it != mapOfImages.end(); ++it) {
-    pyramid[it->first].resize(scales.size());
+    vpImagePyramid &imagePyramid = m_mapOfImagePyramids[it->first];
+    imagePyramid.setType(vpImagePyramid::SUBSAMPLING);
+    imagePyramid.build(*it->second, (unsigned int)scales.size());
 
-    vpMbEdgeTracker::initPyramid(*it->second, pyramid[it->first]);
+    vpMbEdgeTracker::initPyramid(imagePyramid, pyramid[it->first]);
   }
 }
 
@@ -1686,6 +1685,7 @@ void vpMbEdgeMultiTracker::initPyramid(const std::map<std::string, const vpImage
     <sample>
       <step>4</step>
     </sample>
+    <nb_threads>1</nb_threads>
   </ecm>
   <face>
     <near_clipping>0.01</near_clipping>
@@ -2468,6 +2468,20 @@ void vpMbEdgeMultiTracker::setMovingEdge(const std::string &cameraName, const vp
   }
 }
 
+/*!
+  Set the number of threads used to track the moving edges of all the cameras.
+
+  \param nb : Number of threads, see vpMbEdgeTracker::setNbThreads().
+*/
+void vpMbEdgeMultiTracker::setNbThreads(const unsigned int nb) {
+  for(std::map<std::string, vpMbEdgeTracker *>::const_iterator it = m_mapOfEdgeTrackers.begin();
+      it != m_mapOfEdgeTrackers.end(); ++it) {
+    it->second->setNbThreads(nb);
+  }
+
+  nbThreads = nb;
+}
+
 /*!
   Set the near distance for clipping.
 
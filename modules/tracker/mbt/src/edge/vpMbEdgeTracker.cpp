@@ -56,13 +56,142 @@
 #include <visp3/mbt/vpMbtXmlParser.h>
 #include <visp3/core/vpPolygon3D.h>
 #include <visp3/core/vpVelocityTwistMatrix.h>
+#include <visp3/core/vpThreadPool.h>
 
+#include <algorithm>
 #include <limits>
 #include <string>
 #include <sstream>
 #include <float.h>
 #include <map>
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+  struct vpMbEdgeTrackerFeatures
+  {
+    const vpImage<unsigned char> *I;
+    const vpHomogeneousMatrix *cMo;
+    std::vector<vpMbtDistanceLine *> lines;
+    std::vector<vpMbtDistanceCylinder *> cylinders;
+    std::vector<vpMbtDistanceCircle *> circles;
+    //! Moving edges parameters of the tracker.
+    vpMe *me;
+    //! One copy of the moving edges parameters per worker.
+    std::vector<vpMe> *meThreads;
+    unsigned int nbWorkers;
+  };
+
+  // Number of workers sharing the features. 1 means a sequential processing.
+  unsigned int nbMovingEdgeWorkers(const unsigned int nbThreads)
+  {
+    return (nbThreads == 0) ? vpThreadPool::getNumThreads() : nbThreads;
+  }
+
+  // The moving edges of the lines can modify their parameters (see
+  // vpMbtMeLine::seekExtremities()), so that each worker has to use its own
+  // copy of them.
+  void setFeatureMe(vpMbtDistanceLine *l, vpMe *me)
+  {
+    for(unsigned int i = 0 ; i < l->meline.size() ; i++){
+      if(l->meline[i] != NULL)
+        l->meline[i]->setMe(me);
+    }
+  }
+
+  void setFeatureMe(vpMbtDistanceCylinder *cy, vpMe *me)
+  {
+    if(cy->meline1 != NULL)
+      cy->meline1->setMe(me);
+    if(cy->meline2 != NULL)
+      cy->meline2->setMe(me);
+  }
+
+  void setFeatureMe(vpMbtDistanceCircle *ci, vpMe *me)
+  {
+    if(ci->meEllipse != NULL)
+      ci->meEllipse->setMe(me);
+  }
+
+  void updateFeature(vpMbtDistanceLine *l, const vpImage<unsigned char> &I, const vpHomogeneousMatrix &cMo)
+  {
+    l->updateMovingEdge(I, cMo) ;
+    if (l->nbFeatureTotal == 0 && l->isVisible()){
+      l->Reinit = true;
+    }
+  }
+
+  void updateFeature(vpMbtDistanceCylinder *cy, const vpImage<unsigned char> &I, const vpHomogeneousMatrix &cMo)
+  {
+    cy->updateMovingEdge(I, cMo) ;
+    if((cy->nbFeaturel1 == 0 || cy->nbFeaturel2 == 0) && cy->isVisible()){
+      cy->Reinit = true;
+    }
+  }
+
+  void updateFeature(vpMbtDistanceCircle *ci, const vpImage<unsigned char> &I, const vpHomogeneousMatrix &cMo)
+  {
+    ci->updateMovingEdge(I, cMo) ;
+    if(ci->nbFeature == 0  && ci->isVisible()){
+      ci->Reinit = true;
+    }
+  }
+
+  // The worker w processes the features w, w+nbWorkers, w+2*nbWorkers... so
+  // that the lines, cylinders and circles are spread over all the workers.
+  void trackMovingEdgeBand(unsigned int begin, unsigned int end, void *arg)
+  {
+    vpMbEdgeTrackerFeatures *data = static_cast<vpMbEdgeTrackerFeatures *>(arg);
+    unsigned int nbLines = (unsigned int)data->lines.size();
+    unsigned int nbCylinders = (unsigned int)data->cylinders.size();
+    unsigned int nbFeatures = nbLines + nbCylinders + (unsigned int)data->circles.size();
+
+    for(unsigned int w = begin ; w < end ; w++){
+      for(unsigned int k = w ; k < nbFeatures ; k += data->nbWorkers){
+        if(k < nbLines)
+          data->lines[k]->trackMovingEdge(*data->I, *data->cMo);
+        else if(k < nbLines + nbCylinders)
+          data->cylinders[k - nbLines]->trackMovingEdge(*data->I, *data->cMo);
+        else
+          data->circles[k - nbLines - nbCylinders]->trackMovingEdge(*data->I, *data->cMo);
+      }
+    }
+  }
+
+  void updateMovingEdgeBand(unsigned int begin, unsigned int end, void *arg)
+  {
+    vpMbEdgeTrackerFeatures *data = static_cast<vpMbEdgeTrackerFeatures *>(arg);
+    unsigned int nbLines = (unsigned int)data->lines.size();
+    unsigned int nbCylinders = (unsigned int)data->cylinders.size();
+    unsigned int nbFeatures = nbLines + nbCylinders + (unsigned int)data->circles.size();
+
+    for(unsigned int w = begin ; w < end ; w++){
+      vpMe *me_w = &(*data->meThreads)[w];
+      for(unsigned int k = w ; k < nbFeatures ; k += data->nbWorkers){
+        if(k < nbLines){
+          vpMbtDistanceLine *l = data->lines[k];
+          setFeatureMe(l, me_w);
+          updateFeature(l, *data->I, *data->cMo);
+          setFeatureMe(l, data->me);
+        }
+        else if(k < nbLines + nbCylinders){
+          vpMbtDistanceCylinder *cy = data->cylinders[k - nbLines];
+          setFeatureMe(cy, me_w);
+          updateFeature(cy, *data->I, *data->cMo);
+          setFeatureMe(cy, data->me);
+        }
+        else{
+          vpMbtDistanceCircle *ci = data->circles[k - nbLines - nbCylinders];
+          setFeatureMe(ci, me_w);
+          updateFeature(ci, *data->I, *data->cMo);
+          setFeatureMe(ci, data->me);
+        }
+      }
+    }
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 
 /*!
   Basic constructor
@@ -70,7 +199,8 @@
 vpMbEdgeTracker::vpMbEdgeTracker()
   : compute_interaction(1), lambda(1), me(), lines(1), circles(1), cylinders(1), nline(0), ncircle(0), ncylinder(0),
     nbvisiblepolygone(0), percentageGdPt(0.4), scales(1),
-    Ipyramid(0), scaleLevel(0), nbFeaturesForProjErrorComputation(0)
+    Ipyramid(0), m_pyramid(vpImagePyramid::SUBSAMPLING), scaleLevel(0), nbFeaturesForProjErrorComputation(0),
+    nbThreads(1), meThreads()
 {
   angleAppears = vpMath::rad(89);
   angleDisappears = vpMath::rad(89);
@@ -123,7 +253,6 @@ vpMbEdgeTracker::~vpMbEdgeTracker()
     }
     circles[i].clear();
   }
-  cleanPyramid(Ipyramid);
 }
 
 /*! 
@@ -135,6 +264,7 @@ void
 vpMbEdgeTracker::setMovingEdge(const vpMe &p_me)
 {
   this->me = p_me;
+  meThreads.clear();
 
   for (unsigned int i = 0; i < scales.size(); i += 1){
     if(scales[i]){
@@ -156,6 +286,28 @@ vpMbEdgeTracker::setMovingEdge(const vpMe &p_me)
   }
 }
 
+/*!
+  Set the number of threads used to track the moving edges.
+
+  The lines, cylinders and circles of the model are shared between the
+  workers of vpThreadPool in trackMovingEdge() and updateMovingEdge(). Each
+  feature is processed by a single worker, so that the result does not
+  depend on the number of threads.
+
+  This number can also be set in the \e ecm section of the XML configuration
+  file, see loadConfigFile().
+
+  \param nb : Number of threads. 1 (the default) for a sequential tracking,
+  0 to use all the threads of vpThreadPool (see vpThreadPool::setNumThreads()).
+
+  \sa getNbThreads()
+*/
+void
+vpMbEdgeTracker::setNbThreads(const unsigned int nb)
+{
+  nbThreads = nb;
+}
+
 /*!
   Compute the visual servoing loop to get the pose of the feature set.
   
@@ -1184,7 +1336,26 @@ vpMbEdgeTracker::testTracking()
 void
 vpMbEdgeTracker::track(const vpImage<unsigned char> &I)
 { 
-  initPyramid(I, Ipyramid);
+  m_pyramid.build(I, (unsigned int)scales.size());
+  track(m_pyramid);
+}
+
+/*!
+  Compute each state of the tracking procedure for all the feature sets, from
+  a pyramid already built for the current image. This allows to share the
+  pyramid with other trackers working on the same image.
+  
+  If the tracking is considered as failed an exception is thrown.
+  
+  \param pyramid : Pyramid of the current image. It must have at least as
+  many levels as the scales set with setScales(). The levels of a
+  vpImagePyramid::SUBSAMPLING pyramid are the ones used by track(const vpImage<unsigned char> &).
+ */
+void
+vpMbEdgeTracker::track(const vpImagePyramid &pyramid)
+{ 
+  const vpImage<unsigned char> &I = pyramid[0];
+  initPyramid(pyramid, Ipyramid);
   
 //  for (int lvl = ((int)scales.size()-1); lvl >= 0; lvl -= 1)
   unsigned int lvl = (unsigned int)scales.size();
@@ -1302,7 +1473,7 @@ vpMbEdgeTracker::track(const vpImage<unsigned char> &I)
     }
   } while(lvl != 0);
   
-  cleanPyramid(Ipyramid);
+  Ipyramid.resize(0);
 }
 
 /*!
@@ -1333,7 +1504,8 @@ void vpMbEdgeTracker::init(const vpImage<unsigned char>& I)
 #endif
   
   
-  initPyramid(I, Ipyramid);
+  m_pyramid.build(I, (unsigned int)scales.size());
+  initPyramid(m_pyramid, Ipyramid);
   visibleFace(I, cMo, a);
   unsigned int i = (unsigned int)scales.size();
 
@@ -1354,7 +1526,7 @@ void vpMbEdgeTracker::init(const vpImage<unsigned char>& I)
     }
   } while(i != 0);
   
-  cleanPyramid(Ipyramid);
+  Ipyramid.resize(0);
 }
 
 /*!
@@ -1421,6 +1593,7 @@ vpMbEdgeTracker::loadConfigFile(const std::string& configFile)
     <sample>
       <step>4</step>
     </sample>
+    <nb_threads>1</nb_threads>
   </ecm>
   <face>
     <near_clipping>0.01</near_clipping>
@@ -1448,6 +1621,7 @@ vpMbEdgeTracker::loadConfigFile(const char* configFile)
   xmlp.setAngleAppear(vpMath::deg(angleAppears));
   xmlp.setAngleDisappear(vpMath::deg(angleDisappears));
   xmlp.setMovingEdge(me);
+  xmlp.setNbThreads(nbThreads);
 
   try{
     std::cout << " *********** Parsing XML for Mb Edge Tracker ************ " << std::endl;
@@ -1464,6 +1638,7 @@ vpMbEdgeTracker::loadConfigFile(const char* configFile)
   
   setCameraParameters(camera);
   setMovingEdge(meParser);
+  setNbThreads(xmlp.getNbThreads());
   angleAppears = vpMath::rad(xmlp.getAngleAppear());
   angleDisappears = vpMath::rad(xmlp.getAngleDisappear());
   
@@ -1725,6 +1900,52 @@ vpMbEdgeTracker::initMovingEdge(const vpImage<unsigned char> &I, const vpHomogen
 void
 vpMbEdgeTracker::trackMovingEdge(const vpImage<unsigned char> &I)
 {
+  unsigned int nbWorkers = nbMovingEdgeWorkers(nbThreads);
+
+  if(nbWorkers > 1){
+    // The moving edges are initialized sequentially, only the tracking of the
+    // features is shared between the threads.
+    vpMbEdgeTrackerFeatures data;
+    for(std::list<vpMbtDistanceLine*>::const_iterator it=lines[scaleLevel].begin(); it!=lines[scaleLevel].end(); ++it){
+      vpMbtDistanceLine *l = *it;
+      if(l->isVisible() && l->isTracked()){
+        if(l->meline.size() == 0){
+          l->initMovingEdge(I, cMo);
+        }
+        data.lines.push_back(l);
+      }
+    }
+
+    for(std::list<vpMbtDistanceCylinder*>::const_iterator it=cylinders[scaleLevel].begin(); it!=cylinders[scaleLevel].end(); ++it){
+      vpMbtDistanceCylinder *cy = *it;
+      if(cy->isVisible() && cy->isTracked()) {
+        if(cy->meline1 == NULL || cy->meline2 == NULL){
+          cy->initMovingEdge(I, cMo);
+        }
+        data.cylinders.push_back(cy);
+      }
+    }
+
+    for(std::list<vpMbtDistanceCircle*>::const_iterator it=circles[scaleLevel].begin(); it!=circles[scaleLevel].end(); ++it){
+      vpMbtDistanceCircle *ci = *it;
+      if(ci->isVisible() && ci->isTracked()){
+        if(ci->meEllipse == NULL){
+          ci->initMovingEdge(I, cMo);
+        }
+        data.circles.push_back(ci);
+      }
+    }
+
+    unsigned int nbFeatures = (unsigned int)(data.lines.size() + data.cylinders.size() + data.circles.size());
+    data.I = &I;
+    data.cMo = &cMo;
+    data.me = &me;
+    data.meThreads = NULL;
+    data.nbWorkers = std::min(nbWorkers, nbFeatures);
+    vpThreadPool::parallelFor(0, data.nbWorkers, trackMovingEdgeBand, &data);
+    return;
+  }
+
   for(std::list<vpMbtDistanceLine*>::const_iterator it=lines[scaleLevel].begin(); it!=lines[scaleLevel].end(); ++it){
     vpMbtDistanceLine *l = *it;
     if(l->isVisible() && l->isTracked()){
@@ -1765,36 +1986,52 @@ vpMbEdgeTracker::trackMovingEdge(const vpImage<unsigned char> &I)
 void
 vpMbEdgeTracker::updateMovingEdge(const vpImage<unsigned char> &I)
 {
-  vpMbtDistanceLine *l ;
+  unsigned int nbWorkers = nbMovingEdgeWorkers(nbThreads);
+
+  if(nbWorkers > 1){
+    vpMbEdgeTrackerFeatures data;
+    for(std::list<vpMbtDistanceLine*>::const_iterator it=lines[scaleLevel].begin(); it!=lines[scaleLevel].end(); ++it){
+      if((*it)->isTracked())
+        data.lines.push_back(*it);
+    }
+    for(std::list<vpMbtDistanceCylinder*>::const_iterator it=cylinders[scaleLevel].begin(); it!=cylinders[scaleLevel].end(); ++it){
+      if((*it)->isTracked())
+        data.cylinders.push_back(*it);
+    }
+    for(std::list<vpMbtDistanceCircle*>::const_iterator it=circles[scaleLevel].begin(); it!=circles[scaleLevel].end(); ++it){
+      if((*it)->isTracked())
+        data.circles.push_back(*it);
+    }
+
+    unsigned int nbFeatures = (unsigned int)(data.lines.size() + data.cylinders.size() + data.circles.size());
+    data.nbWorkers = std::min(nbWorkers, nbFeatures);
+    // The copies are cleared by setMovingEdge() when the parameters change
+    if(meThreads.size() < data.nbWorkers)
+      meThreads.resize(data.nbWorkers, me);
+
+    data.I = &I;
+    data.cMo = &cMo;
+    data.me = &me;
+    data.meThreads = &meThreads;
+    vpThreadPool::parallelFor(0, data.nbWorkers, updateMovingEdgeBand, &data);
+    return;
+  }
+
   for(std::list<vpMbtDistanceLine*>::const_iterator it=lines[scaleLevel].begin(); it!=lines[scaleLevel].end(); ++it){
     if((*it)->isTracked()){
-      l = *it;
-      l->updateMovingEdge(I, cMo) ;
-      if (l->nbFeatureTotal == 0 && l->isVisible()){
-        l->Reinit = true;
-      }
+      updateFeature(*it, I, cMo);
     }
   }
 
-  vpMbtDistanceCylinder *cy ;
   for(std::list<vpMbtDistanceCylinder*>::const_iterator it=cylinders[scaleLevel].begin(); it!=cylinders[scaleLevel].end(); ++it){
     if((*it)->isTracked()){
-      cy = *it;
-      cy->updateMovingEdge(I, cMo) ;
-      if((cy->nbFeaturel1 == 0 || cy->nbFeaturel2 == 0) && cy->isVisible()){
-        cy->Reinit = true;
-      }
+      updateFeature(*it, I, cMo);
     }
   }
 
-  vpMbtDistanceCircle *ci ;
   for(std::list<vpMbtDistanceCircle*>::const_iterator it=circles[scaleLevel].begin(); it!=circles[scaleLevel].end(); ++it){
     if((*it)->isTracked()){
-      ci = *it;
-      ci->updateMovingEdge(I, cMo) ;
-      if(ci->nbFeature == 0  && ci->isVisible()){
-        ci->Reinit = true;
-      }
+      updateFeature(*it, I, cMo);
     }
   }
 }
@@ -2837,6 +3074,32 @@ vpMbEdgeTracker::initPyramid(const vpImage<unsigned char>& _I, std::vector< cons
   }
 }
 
+/*!
+  Set the pyramid of image associated to the scales attribute of the class
+  from an already built pyramid. The images are not copied: the vector
+  contains pointers to the levels of \e pyramid, or NULL for the scales that
+  are not used, and must not be given to cleanPyramid().
+
+  \param pyramid : The pyramid of the input image.
+  \param _pyramid : The pyramid of image used by the tracker.
+
+  \exception vpException::dimensionError : If \e pyramid has less levels than
+  the scales attribute.
+*/
+void
+vpMbEdgeTracker::initPyramid(const vpImagePyramid& pyramid, std::vector< const vpImage<unsigned char>* >& _pyramid)
+{
+  if (pyramid.getNbLevels() < scales.size()) {
+    throw vpException(vpException::dimensionError, "The pyramid has %u levels instead of %u",
+                      pyramid.getNbLevels(), (unsigned int)scales.size());
+  }
+
+  _pyramid.resize(scales.size());
+  for (unsigned int i = 0; i < _pyramid.size(); i++) {
+    _pyramid[i] = scales[i] ? &pyramid[i] : NULL;
+  }
+}
+
 /*!
   Clean the pyramid of image allocated with the initPyramid() method. The vector
   has a size equal to zero at the end of the method. 
@@ -54,7 +54,7 @@
   Default constructor. 
   
 */
-vpMbtXmlParser::vpMbtXmlParser() : m_ecm()
+vpMbtXmlParser::vpMbtXmlParser() : m_ecm(), m_nbThreads(1)
 {
   init();
 }
@@ -86,6 +86,7 @@ vpMbtXmlParser::init()
   nodeMap["mu2"] = mu2;
   nodeMap["sample"] = sample;
   nodeMap["step"] = step;
+  nodeMap["nb_threads"] = nb_threads;
 }
 
 /*!
@@ -179,6 +180,7 @@ vpMbtXmlParser::readMainClass(xmlDocPtr doc, xmlNodePtr node)
     std::cout <<"ecm : contrast : mu1 : " << this->m_ecm.getMu1()<<" (default)" <<std::endl;
     std::cout <<"ecm : contrast : mu2 : " << this->m_ecm.getMu2()<<" (default)" <<std::endl;
     std::cout <<"ecm : sample : sample_step : "<< this->m_ecm.getSampleStep()<< " (default)" << std::endl;
+    std::cout <<"ecm : nb_threads : "<< this->m_nbThreads << " (default)" << std::endl;
   }
 
   if(!lod_node) {
@@ -204,6 +206,7 @@ vpMbtXmlParser::read_ecm (xmlDocPtr doc, xmlNodePtr node)
   bool range_node = false;
   bool contrast_node = false;
   bool sample_node = false;
+  bool nb_threads_node = false;
   
   for(xmlNodePtr dataNode = node->xmlChildrenNode; dataNode != NULL;  dataNode = dataNode->next)  {
     if(dataNode->type == XML_ELEMENT_NODE){
@@ -226,6 +229,10 @@ vpMbtXmlParser::read_ecm (xmlDocPtr doc, xmlNodePtr node)
           this->read_sample (doc, dataNode);
           sample_node = true;
           }break;
+        case nb_threads:{
+          this->m_nbThreads = xmlReadUnsignedIntChild(doc, dataNode);
+          nb_threads_node = true;
+          }break;
         default:{
 //          vpTRACE("unknown tag in read_ecm : %d, %s", iter_data->second, (iter_data->first).c_str());
           }break;
@@ -252,6 +259,11 @@ vpMbtXmlParser::read_ecm (xmlDocPtr doc, xmlNodePtr node)
   if(!sample_node) {
     std::cout <<"ecm : sample : sample_step : "<< this->m_ecm.getSampleStep()<< " (default)" << std::endl;
   }
+
+  if(!nb_threads_node)
+    std::cout <<"ecm : nb_threads : "<< this->m_nbThreads << " (default)" << std::endl;
+  else
+    std::cout <<"ecm : nb_threads : "<< this->m_nbThreads << std::endl;
 }
 
 /*!
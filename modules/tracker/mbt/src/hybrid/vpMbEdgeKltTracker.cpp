@@ -79,7 +79,8 @@ vpMbEdgeKltTracker::init(const vpImage<unsigned char>& I)
 {
   vpMbKltTracker::init(I);
   
-  initPyramid(I, Ipyramid);
+  m_pyramid.build(I, (unsigned int)scales.size());
+  initPyramid(m_pyramid, Ipyramid);
 
   vpMbEdgeTracker::resetMovingEdge();
 
@@ -93,7 +94,7 @@ vpMbEdgeKltTracker::init(const vpImage<unsigned char>& I)
     }
   } while(i != 0);
   
-  cleanPyramid(Ipyramid);
+  Ipyramid.resize(0);
 }
 
 /*!
@@ -118,7 +119,8 @@ vpMbEdgeKltTracker::setPose( const vpImage<unsigned char> &I, const vpHomogeneou
       faces.computeScanLineRender(cam, I.getWidth(), I.getHeight());
     }
 
-    initPyramid(I, Ipyramid);
+    m_pyramid.build(I, (unsigned int)scales.size());
+    initPyramid(m_pyramid, Ipyramid);
 
     unsigned int i = (unsigned int)scales.size();
     do {
@@ -130,7 +132,7 @@ vpMbEdgeKltTracker::setPose( const vpImage<unsigned char> &I, const vpHomogeneou
       }
     } while(i != 0);
     
-    cleanPyramid(Ipyramid);
+    Ipyramid.resize(0);
 }
 
 /*!
@@ -235,6 +237,7 @@ vpMbEdgeKltTracker::loadConfigFile(const std::string& configFile)
     <sample>
       <step>4</step>
     </sample>
+    <nb_threads>1</nb_threads>
   </ecm>
   <camera>
     <width>640</width>
@@ -277,6 +280,7 @@ vpMbEdgeKltTracker::loadConfigFile(const char* configFile)
   xmlp.setAngleDisappear(vpMath::deg(angleDisappears));
 
   xmlp.setMovingEdge(me);
+  xmlp.setNbThreads(nbThreads);
 
   xmlp.setMaxFeatures(10000);
   xmlp.setWindowSize(5);
@@ -328,6 +332,7 @@ vpMbEdgeKltTracker::loadConfigFile(const char* configFile)
   vpMe meParser;
   xmlp.getMe(meParser);
   vpMbEdgeTracker::setMovingEdge(meParser);
+  vpMbEdgeTracker::setNbThreads(xmlp.getNbThreads());
 
   tracker.setMaxFeatures((int)xmlp.getMaxFeatures());
   tracker.setWindowSize((int)xmlp.getWindowSize());
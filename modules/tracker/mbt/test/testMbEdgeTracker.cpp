@@ -0,0 +1,254 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Track a cube in synthetic images with several threads.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMbEdgeTracker.cpp
+
+  Track a cube rendered by vpImageSimulator with vpMbEdgeTracker, the moving
+  edges being tracked by 1 and several threads, and check that the estimated
+  poses are identical and close to the simulated ones.
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <vector>
+
+#include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpIoTools.h>
+#include <visp3/core/vpThetaUVector.h>
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/mbt/vpMbEdgeTracker.h>
+#include <visp3/robot/vpImageSimulator.h>
+
+namespace
+{
+  const std::string modelFile = "testMbEdgeTracker_cube.cao";
+
+  // Vertices and faces of the cube, as in tutorial/detection/object/cube.cao
+  const double cubeVertices[8][3] = {
+    {  0.000, 0.000, 0.000 }, { -0.084, 0.000, 0.000 }, { -0.084, 0.084, 0.000 }, {  0.000, 0.084, 0.000 },
+    {  0.000, 0.000, 0.084 }, { -0.084, 0.000, 0.084 }, { -0.084, 0.084, 0.084 }, {  0.000, 0.084, 0.084 }
+  };
+  const unsigned int cubeFaces[6][4] = {
+    { 0, 4, 5, 1 }, { 1, 5, 6, 2 }, { 6, 7, 3, 2 }, { 3, 7, 4, 0 }, { 0, 1, 2, 3 }, { 7, 6, 5, 4 }
+  };
+
+  bool writeModel()
+  {
+    std::ofstream file(modelFile.c_str());
+    if (! file)
+      return false;
+    file << "V1" << std::endl << "8" << std::endl;
+    for (unsigned int i = 0; i < 8; i++)
+      file << cubeVertices[i][0] << " " << cubeVertices[i][1] << " " << cubeVertices[i][2] << std::endl;
+    file << "0" << std::endl << "0" << std::endl << "6" << std::endl;
+    for (unsigned int f = 0; f < 6; f++) {
+      file << "4";
+      for (unsigned int i = 0; i < 4; i++)
+        file << " " << cubeFaces[f][i];
+      file << std::endl;
+    }
+    return file.good();
+  }
+
+  // Center of the cube
+  const double cubeCenter[3] = { -0.042, 0.042, 0.042 };
+
+  // Pose of the frame centered on the cube in image k: small motions of the
+  // cube around its center
+  vpHomogeneousMatrix centerPose(unsigned int k)
+  {
+    return vpHomogeneousMatrix(0.002 * k, -0.001 * k, 0.5 + 0.002 * k,
+                               vpMath::rad(20 + 1. * k), vpMath::rad(-35 + 1.5 * k), vpMath::rad(10 + 1. * k));
+  }
+
+  vpHomogeneousMatrix cubePose(unsigned int k)
+  {
+    return centerPose(k) * vpHomogeneousMatrix(-cubeCenter[0], -cubeCenter[1], -cubeCenter[2], 0, 0, 0);
+  }
+
+  // Faces of uniform and different grey levels in front of a dark plane. The
+  // faces are given in the frame centered on the cube, since vpImageSimulator
+  // doesn't handle the planes that contain the origin of their frame.
+  void renderImages(std::vector< vpImage<unsigned char> > &images, const vpCameraParameters &cam)
+  {
+    std::list<vpImageSimulator> faces;
+    for (unsigned int f = 0; f < 6; f++) {
+      vpImage<unsigned char> texture(8, 8, (unsigned char)(90 + 25 * f));
+      vpColVector X[4];
+      for (unsigned int i = 0; i < 4; i++) {
+        X[i].resize(3);
+        for (unsigned int c = 0; c < 3; c++)
+          X[i][c] = cubeVertices[cubeFaces[f][i]][c] - cubeCenter[c];
+      }
+      vpImageSimulator sim;
+      sim.setInterpolationType(vpImageSimulator::BILINEAR_INTERPOLATION);
+      sim.init(texture, X);
+      sim.setCameraPosition(centerPose(0));
+      faces.push_back(sim);
+    }
+
+    // vpImageSimulator doesn't leave unchanged the pixels of the region of
+    // interest that no face covers: a plane behind the cube covers the whole
+    // image
+    vpImage<unsigned char> texture(8, 8, 30);
+    vpColVector X[4];
+    const double corners[4][2] = { {-1, -1}, {1, -1}, {1, 1}, {-1, 1} };
+    for (unsigned int i = 0; i < 4; i++) {
+      X[i].resize(3);
+      X[i][0] = corners[i][0];
+      X[i][1] = corners[i][1];
+      X[i][2] = 0;
+    }
+    vpImageSimulator background;
+    background.init(texture, X);
+    background.setCameraPosition(vpHomogeneousMatrix(0, 0, 1, 0, 0, 0));
+
+    for (unsigned int k = 0; k < images.size(); k++) {
+      for (std::list<vpImageSimulator>::iterator it = faces.begin(); it != faces.end(); ++it)
+        it->setCameraPosition(centerPose(k));
+      std::list<vpImageSimulator> scene = faces;
+      scene.push_back(background);
+      images[k].resize(480, 640);
+      vpImageSimulator::getImage(images[k], scene, cam);
+    }
+  }
+
+  void track(const std::vector< vpImage<unsigned char> > &images, const vpCameraParameters &cam,
+             unsigned int nbThreads, std::vector<vpHomogeneousMatrix> &poses)
+  {
+    vpMbEdgeTracker tracker;
+    vpMe me;
+    me.setMaskSize(5);
+    me.setMaskNumber(180);
+    me.setRange(8);
+    me.setThreshold(10000);
+    me.setMu1(0.5);
+    me.setMu2(0.5);
+    me.setSampleStep(4);
+    tracker.setMovingEdge(me);
+    tracker.setCameraParameters(cam);
+    tracker.setAngleAppear(vpMath::rad(70));
+    tracker.setAngleDisappear(vpMath::rad(80));
+    tracker.setNearClippingDistance(0.1);
+    tracker.setFarClippingDistance(100.0);
+    tracker.setNbThreads(nbThreads);
+    // The lines of the model are built from random planes (see
+    // vpMbtDistanceLine::buildFrom()) that have to be the same for all the runs
+    srand(0);
+    tracker.loadModel(modelFile);
+    tracker.initFromPose(images[0], cubePose(0));
+
+    poses.clear();
+    for (size_t k = 1; k < images.size(); k++) {
+      tracker.track(images[k]);
+      poses.push_back(tracker.getPose());
+    }
+  }
+
+  bool samePoses(const std::vector<vpHomogeneousMatrix> &p1, const std::vector<vpHomogeneousMatrix> &p2)
+  {
+    for (size_t k = 0; k < p1.size(); k++) {
+      for (unsigned int i = 0; i < p1[k].size(); i++) {
+        if (p1[k].data[i] != p2[k].data[i])
+          return false;
+      }
+    }
+    return true;
+  }
+}
+
+int main()
+{
+  try {
+    vpCameraParameters cam;
+    cam.initPersProjWithoutDistortion(800, 800, 320, 240);
+    std::vector< vpImage<unsigned char> > images(10);
+    renderImages(images, cam);
+
+    if (! writeModel()) {
+      std::cerr << "Cannot write " << modelFile << std::endl;
+      return 1;
+    }
+
+    // The moving edges are shared between the workers of the pool
+    unsigned int nthreads_pool = vpThreadPool::getNumThreads();
+    vpThreadPool::setNumThreads(8);
+
+    std::vector<vpHomogeneousMatrix> ref;
+    track(images, cam, 1, ref);
+
+    // The estimated center of the cube and orientation have to stay close to
+    // the simulated ones
+    bool ok = true;
+    for (size_t k = 0; k < ref.size() && ok; k++) {
+      vpHomogeneousMatrix oMcenter(cubeCenter[0], cubeCenter[1], cubeCenter[2], 0, 0, 0);
+      vpHomogeneousMatrix cMcenter = ref[k] * oMcenter, cdMcenter = centerPose((unsigned int)k + 1);
+      vpTranslationVector dt = cdMcenter.getTranslationVector() - cMcenter.getTranslationVector();
+      vpThetaUVector tu(cdMcenter * cMcenter.inverse());
+      double theta = sqrt(vpMath::sqr(tu[0]) + vpMath::sqr(tu[1]) + vpMath::sqr(tu[2]));
+      if (dt.euclideanNorm() > 0.005 || theta > vpMath::rad(2)) {
+        std::cerr << "The pose of image " << k + 1 << " is wrong" << std::endl;
+        ok = false;
+      }
+    }
+
+    const unsigned int nthreads[] = { 2, 3, 8 };
+    for (unsigned int t = 0; t < sizeof(nthreads) / sizeof(nthreads[0]) && ok; t++) {
+      std::vector<vpHomogeneousMatrix> poses;
+      track(images, cam, nthreads[t], poses);
+      if (! samePoses(ref, poses)) {
+        std::cerr << "The poses differ with " << nthreads[t] << " threads" << std::endl;
+        ok = false;
+      }
+    }
+
+    vpThreadPool::setNumThreads(nthreads_pool);
+    vpIoTools::remove(modelFile);
+
+    if (! ok)
+      return 1;
+    std::cout << "The tracking doesn't depend on the number of threads" << std::endl;
+    return 0;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return 1;
+  }
+}
@@ -123,12 +123,18 @@ public:
   void display(const vpImage<unsigned char>& I);
 
   double convolution(const vpImage<unsigned char>& ima, const vpMe *me) ;
+  static void convolution(const vpImage<unsigned char>& ima, const vpMe *me,
+                          const vpMeSite *const *sites, const unsigned int nbSites, double *conv) ;
 
   vpMeSite *getQueryList(const vpImage<unsigned char> &I, const int range) ;
 
   void track(const vpImage<unsigned char>& im,
 	     const vpMe *me,
 	     const  bool test_contraste=true);
+  void track(const vpImage<unsigned char>& im,
+	     const vpMe *me,
+	     const bool test_contraste,
+	     const double *conv);
   
   /*!
     Set the angle of tangent at site
@@ -52,6 +52,7 @@
 #include <math.h>
 #include <iostream>
 #include <list>
+#include <vector>
 
 /*!
   \class vpMeTracker
@@ -78,6 +79,9 @@ protected:
   
 protected:
   vpMeSite::vpMeSiteDisplayType selectDisplay ;
+  //! Sites processed by track() and convolutions of their query pixels.
+  std::vector<vpMeSite *> querySites;
+  std::vector<double> queryConvolutions;
 
 public:
   // Constructor/Destructor
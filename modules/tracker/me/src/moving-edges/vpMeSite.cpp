@@ -50,6 +50,7 @@
 #include <stdlib.h>
 #include <cmath>    // std::fabs
 #include <limits>   // numeric_limits
+#include <vector>
 #include <visp3/me/vpMeSite.h>
 
 
@@ -63,6 +64,28 @@ bool horsImage(int i , int j, int half, int rows, int cols)
   //return((i < half + 1) || ( i > (rows - half - 3) )||(j < half + 1) || (j > (cols - half - 3) )) ;
   return( (0 < (half_1 - i) ) || ( (i - rows + half_3) > 0 ) || ( 0 < (half_1 -j) ) || ( (j - cols + half_3)  > 0 ) ) ;
 }
+
+// Index of the mask oriented along the tangent of a site of normal angle alpha
+static
+unsigned int maskIndex(double alpha, const vpMe *me)
+{
+  // Calculate tangent angle from normal
+  double theta  = alpha+M_PI/2;
+  // Move tangent angle to within 0->M_PI for a positive
+  // mask index
+  while (theta<0) theta += M_PI;
+  while (theta>M_PI) theta -= M_PI;
+
+  // Convert radians to degrees
+  int thetadeg = vpMath::round(theta * 180 / M_PI) ;
+
+  if(abs(thetadeg) == 180 )
+  {
+    thetadeg= 0 ;
+  }
+
+  return (unsigned int)(thetadeg/(double)me->getAngleStep());
+}
 #endif
 
 void
@@ -321,22 +344,7 @@ vpMeSite::convolution(const vpImage<unsigned char>&I, const  vpMe *me)
   }
   else
   {
-    // Calculate tangent angle from normal
-    double theta  = alpha+M_PI/2;
-    // Move tangent angle to within 0->M_PI for a positive
-    // mask index
-    while (theta<0) theta += M_PI;
-    while (theta>M_PI) theta -= M_PI;
-
-    // Convert radians to degrees
-    int thetadeg = vpMath::round(theta * 180 / M_PI) ;
-
-    if(abs(thetadeg) == 180 )
-    {
-      thetadeg= 0 ;
-    }
-
-    unsigned int index_mask = (unsigned int)(thetadeg/(double)me->getAngleStep());
+    unsigned int index_mask = maskIndex(alpha, me);
 
     unsigned int i_ = static_cast<unsigned int>(i);
     unsigned int j_ = static_cast<unsigned int>(j);
@@ -361,6 +369,69 @@ vpMeSite::convolution(const vpImage<unsigned char>&I, const  vpMe *me)
   return(conv) ;
 }
 
+/*!
+  Compute in a single pass the convolutions of the query pixels of several
+  sites, that is the 2*range+1 pixels along the normal of each site that
+  are considered by track(), where range is given by vpMe::getRange().
+
+  The result is the same as calling convolution() on each site of the list
+  returned by getQueryList(), but no site is allocated and the orientation
+  of the mask is computed once per site.
+
+  \param I : Image.
+  \param me : Moving edges parameters.
+  \param sites : Array of \e nbSites pointers to the sites.
+  \param nbSites : Number of sites.
+  \param conv : Array of nbSites*(2*range+1) values. The convolutions of the
+  query pixels of the site \e k are stored from conv[k*(2*range+1)].
+
+  \sa track(const vpImage<unsigned char>&, const vpMe *, const bool, const double *)
+*/
+void
+vpMeSite::convolution(const vpImage<unsigned char>& I, const vpMe *me,
+                      const vpMeSite *const *sites, const unsigned int nbSites, double *conv)
+{
+  int range = static_cast<int>(me->getRange());
+  int height_ = static_cast<int>(I.getHeight());
+  int width_  = static_cast<int>(I.getWidth());
+  unsigned int msize = me->getMaskSize();
+  int half = (static_cast<int>(msize) - 1) >> 1 ;
+  int half_strip = half + me->getStrip();
+
+  for(unsigned int s = 0 ; s < nbSites ; s++)
+  {
+    const vpMeSite *site = sites[s];
+    double salpha = sin(site->alpha);
+    double calpha = cos(site->alpha);
+    const double *mask = me->getMask()[maskIndex(site->alpha, me)].data;
+    int sign = site->mask_sign;
+
+    for(int k = -range ; k <= range ; k++, conv++)
+    {
+      // Same truncation as init(double, double, double, double, int)
+      int i_ = (int)(site->ifloat+k*salpha);
+      int j_ = (int)(site->jfloat+k*calpha);
+
+      if(horsImage(i_, j_, half_strip, height_, width_))
+      {
+        *conv = 0.0;
+      }
+      else
+      {
+        double c = 0.0;
+        const unsigned char *row = I.bitmap + (i_-half)*width_ + (j_-half);
+        const double *mask_row = mask;
+        for(unsigned int a = 0 ; a < msize ; a++, row += width_, mask_row += msize)
+        {
+          for(unsigned int b = 0 ; b < msize ; b++)
+            c += sign * mask_row[b] * row[b];
+        }
+        *conv = c;
+      }
+    }
+  }
+}
+
 
 /*!
 
@@ -497,30 +568,67 @@ vpMeSite::track(const vpImage<unsigned char>& I,
   //       delete []likelihood; // modif portage
   //     }
 
-  vpMeSite  *list_query_pixels ;
+  // Convolutions of the query pixels, kept on the stack for the usual ranges
+  unsigned int nb_query = 2 * me->getRange() + 1 ;
+  double conv_stack[64] ;
+  std::vector<double> conv_heap ;
+  double *conv = conv_stack ;
+  if(nb_query > sizeof(conv_stack) / sizeof(conv_stack[0]))
+  {
+    conv_heap.resize(nb_query) ;
+    conv = &conv_heap[0] ;
+  }
+
+  const vpMeSite *site = this ;
+  convolution(I, me, &site, 1, conv) ;
+  track(I, me, test_contraste, conv) ;
+}
+
+/*!
+
+  Track the site from the convolutions of its 2*range+1 query pixels
+  computed beforehand, where range is given by vpMe::getRange(). It allows
+  to compute the convolutions of all the sites of a tracker at once with
+  convolution(const vpImage<unsigned char>&, const vpMe *, const vpMeSite *const *, const unsigned int, double *).
+
+  \param I : Image.
+  \param me : Moving edges parameters.
+  \param test_contraste : If true, the contrast of the site is compared to
+  the one of the previous image.
+  \param conv : Convolutions of the query pixels of the site.
+
+  \warning To display the moving edges graphics a call to vpDisplay::flush()
+  is needed.
+
+*/
+void
+vpMeSite::track(const vpImage<unsigned char>& I,
+                const vpMe *me,
+                const bool test_contraste,
+                const double *conv)
+{
   int  max_rank =-1 ;
-  //   int max_rank1=-1 ;
-  //   int max_rank2 = -1;
   double  max_convolution = 0 ;
   double max = 0 ;
   double contraste = 0;
-  //  vpDisplay::display(I) ;
-  //  vpERROR_TRACE("getclcik %d",me->range) ;
-  //  vpDisplay::getClick(I) ;
 
   // range = +/- range of pixels within which the correspondent
   // of the current pixel will be sought
-  unsigned int range  = me->getRange() ;
+  int range  = static_cast<int>(me->getRange()) ;
+
+  double salpha = sin(alpha);
+  double calpha = cos(alpha);
 
-  //  std::cout << i << "  " << j<<"  " << range << "  " << suppress  << std::endl ;
-  list_query_pixels = getQueryList(I, (int)range) ;
+  // Display the query pixels
+  if ((selectDisplay==RANGE_RESULT)||(selectDisplay==RANGE))
+  {
+    for(int k = -range ; k <= range ; k++)
+      vpDisplay::displayCross(I, vpImagePoint(ifloat+k*salpha, jfloat+k*calpha), 1, vpColor::yellow) ;
+  }
 
   double  contraste_max = 1 + me->getMu2();
   double  contraste_min = 1 - me->getMu1();
 
-  // array in which likelihood ratios will be stored
-  double  *likelihood= new double[ 2 * range + 1 ] ;
-
   int ii_1 = i ;
   int jj_1 = j ;
   i_1 = i ;
@@ -529,47 +637,56 @@ vpMeSite::track(const vpImage<unsigned char>& I,
   threshold = me->getThreshold() ;
   double diff = 1e6;
 
-  //    std::cout <<"---------------------"<<std::endl ;
-  for(unsigned int n = 0 ; n < 2 * range + 1 ; n++)
+  for(int n = 0 ; n < 2 * range + 1 ; n++)
   {
     //   convolution results
-    double convolution_ = list_query_pixels[n].convolution(I, me) ;
+    double convolution_ = conv[n] ;
+    double likelihood ;
 
     // luminance ratio of reference pixel to potential correspondent pixel
     // the luminance must be similar, hence the ratio value should
     // lay between, for instance, 0.5 and 1.5 (parameter tolerance)
     if( test_contraste )
     {
-      likelihood[n] = fabs(convolution_ + convlt );
-      if (likelihood[n]> threshold)
+      likelihood = fabs(convolution_ + convlt );
+      if (likelihood > threshold)
       {
         contraste = convolution_ / convlt;
         if((contraste > contraste_min) && (contraste < contraste_max) && fabs(1-contraste) < diff)
         {
           diff = fabs(1-contraste);
           max_convolution= convolution_;
-          max = likelihood[n] ;
-          max_rank = (int)n ;
-          // 	    max_rank2 = max_rank1;
-          // 	    max_rank1 = max_rank;
+          max = likelihood ;
+          max_rank = n ;
         }
       }
     }
 
     else
     {
-      likelihood[n] = fabs(2*convolution_) ;
-      if (likelihood[n] > max  && likelihood[n] > threshold)
+      likelihood = fabs(2*convolution_) ;
+      if (likelihood > max  && likelihood > threshold)
       {
         max_convolution= convolution_;
-        max = likelihood[n] ;
-        max_rank = (int)n ;
-        //           max_rank2 = max_rank1;
-        //           max_rank1 = max_rank;
+        max = likelihood ;
+        max_rank = n ;
       }
     }
   }
-  
+
+  // Query site of rank n, as built by getQueryList() and updated by
+  // convolution() when its mask is outside the image
+  int half = (static_cast<int>(me->getMaskSize()) - 1) >> 1 ;
+  int n = (max_rank >= 0) ? max_rank : 0 ;
+  vpMeSite pel ;
+  pel.init(ifloat+(n-range)*salpha, jfloat+(n-range)*calpha, alpha, convlt, mask_sign) ;
+  pel.setDisplay(selectDisplay) ;
+  if(horsImage(pel.i, pel.j, half + me->getStrip(), static_cast<int>(I.getHeight()), static_cast<int>(I.getWidth())))
+  {
+    pel.i = 0 ;
+    pel.j = 0 ;
+  }
+
   // test on the likelihood threshold if threshold==-1 then
   // the me->threshold is  selected
 
@@ -580,26 +697,24 @@ vpMeSite::track(const vpImage<unsigned char>& I,
   {
     if ((selectDisplay==RANGE_RESULT)||(selectDisplay==RESULT))
     {
-      ip.set_i( list_query_pixels[max_rank].i );
-      ip.set_j( list_query_pixels[max_rank].j );
+      ip.set_i( pel.i );
+      ip.set_j( pel.j );
       vpDisplay::displayPoint(I, ip, vpColor::red);
     }
-		
-    *this = list_query_pixels[max_rank] ;//The vpMeSite2 is replaced by the vpMeSite2 of max likelihood
+
+    *this = pel ;//The vpMeSite2 is replaced by the vpMeSite2 of max likelihood
     normGradient =  vpMath::sqr(max_convolution);
 
     convlt = max_convolution;
     i_1 = ii_1; //list_query_pixels[max_rank].i ;
     j_1 = jj_1; //list_query_pixels[max_rank].j ;
-    delete []list_query_pixels ;
-    delete []likelihood;
   }
   else //none of the query sites is better than the threshold
   {
     if ((selectDisplay==RANGE_RESULT)||(selectDisplay==RESULT))
     {
-      ip.set_i( list_query_pixels[0].i );
-      ip.set_j( list_query_pixels[0].j );
+      ip.set_i( pel.i );
+      ip.set_j( pel.j );
       vpDisplay::displayPoint(I, ip, vpColor::green);
     }
     normGradient = 0 ;
@@ -608,9 +723,6 @@ vpMeSite::track(const vpImage<unsigned char>& I,
       state = CONSTRAST; // contrast suppression
     else
       state = THRESHOLD; // threshold suppression
-
-    delete []list_query_pixels ;
-    delete []likelihood; // modif portage
   }
 }
 
@@ -62,7 +62,8 @@ vpMeTracker::init()
 }
 
 vpMeTracker::vpMeTracker()
-  : list(), me(NULL), init_range(1), nGoodElement(0), selectDisplay(vpMeSite::NONE)
+  : list(), me(NULL), init_range(1), nGoodElement(0), selectDisplay(vpMeSite::NONE),
+    querySites(), queryConvolutions()
 #ifdef VISP_BUILD_DEPRECATED_FUNCTIONS
   , query_range (0), display_point(false)
 #endif
@@ -72,7 +73,8 @@ vpMeTracker::vpMeTracker()
 
 vpMeTracker::vpMeTracker(const vpMeTracker& meTracker)
   : vpTracker(meTracker),
-    list(), me(NULL), init_range(1), nGoodElement(0), selectDisplay(vpMeSite::NONE)
+    list(), me(NULL), init_range(1), nGoodElement(0), selectDisplay(vpMeSite::NONE),
+    querySites(), queryConvolutions()
 #ifdef VISP_BUILD_DEPRECATED_FUNCTIONS
     , query_range (0), display_point(false)
 #endif
@@ -267,22 +269,32 @@ vpMeTracker::track(const vpImage<unsigned char>& I)
 
   }
 
+  // Convolutions of the query pixels of all the sites that are still
+  // tracked, computed at once in buffers kept between two images
+  querySites.clear();
+  for(std::list<vpMeSite>::iterator it=list.begin(); it!=list.end(); ++it){
+    if(it->getState() == vpMeSite::NO_SUPPRESSION)
+      querySites.push_back(&(*it));
+  }
+  unsigned int nb_query = 2 * me->getRange() + 1;
+  if(queryConvolutions.size() < querySites.size() * nb_query)
+    queryConvolutions.resize(querySites.size() * nb_query);
+  if(! querySites.empty())
+    vpMeSite::convolution(I, me, &querySites[0], (unsigned int)querySites.size(), &queryConvolutions[0]);
+
   vpImagePoint ip1, ip2;
   nGoodElement=0;
-  //  int d =0;
+  unsigned int n = 0;
   // Loop through list of sites to track
   for(std::list<vpMeSite>::iterator it=list.begin(); it!=list.end(); ++it){
     vpMeSite s = *it;//current reference pixel
 
-    //    d++ ;
     // If element hasn't been suppressed
     if(s.getState() == vpMeSite::NO_SUPPRESSION)
     {
 
       try{
-        //	vpERROR_TRACE("%d",d ) ;
-        //	vpERROR_TRACE("range %d",me->range) ;
-        s.track(I,me,true);
+        s.track(I,me,true,&queryConvolutions[(n++) * nb_query]);
       }
       catch(vpTrackingException)
       {
@@ -0,0 +1,300 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Track a line and an ellipse in synthetic images.
+ *
+ *****************************************************************************/
+/*!
+  \example testMeTracker.cpp
+
+  \brief Track a line and an ellipse in synthetic images, and check that the
+  convolutions computed for all the sites at once by vpMeTracker::track()
+  give the same sites as tracking each site from the convolutions of its
+  query pixels.
+*/
+
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpImagePoint.h>
+#include <visp3/me/vpMeEllipse.h>
+#include <visp3/me/vpMeLine.h>
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <list>
+#include <vector>
+
+namespace
+{
+  // Bright rectangle whose left edge is at column j0
+  void rectangleImage(vpImage<unsigned char> &I, int j0)
+  {
+    I.resize(240, 320);
+    for (int i = 0; i < (int)I.getHeight(); i++) {
+      for (int j = 0; j < (int)I.getWidth(); j++) {
+        I[i][j] = (i >= 40 && i < 200 && j >= j0 && j < j0 + 120) ? 200 : 30;
+      }
+    }
+  }
+
+  // Bright ellipse centered on (ic, jc), of semi axes a along the columns and
+  // b along the rows
+  void ellipseImage(vpImage<unsigned char> &I, double ic, double jc, double a, double b)
+  {
+    I.resize(240, 320);
+    for (int i = 0; i < (int)I.getHeight(); i++) {
+      for (int j = 0; j < (int)I.getWidth(); j++) {
+        double r = vpMath::sqr((j - jc) / a) + vpMath::sqr((i - ic) / b);
+        I[i][j] = (r <= 1.) ? 200 : 30;
+      }
+    }
+  }
+
+  bool sameSites(const std::list<vpMeSite> &l1, const std::list<vpMeSite> &l2)
+  {
+    if (l1.size() != l2.size())
+      return false;
+    std::list<vpMeSite>::const_iterator it2 = l2.begin();
+    for (std::list<vpMeSite>::const_iterator it1 = l1.begin(); it1 != l1.end(); ++it1, ++it2) {
+      if (it1->i != it2->i || it1->j != it2->j || it1->ifloat != it2->ifloat || it1->jfloat != it2->jfloat
+          || it1->alpha != it2->alpha || it1->convlt != it2->convlt || it1->normGradient != it2->normGradient
+          || it1->mask_sign != it2->mask_sign || it1->weight != it2->weight || it1->getState() != it2->getState()
+          || it1->i_1 != it2->i_1 || it1->j_1 != it2->j_1)
+        return false;
+    }
+    return true;
+  }
+
+  /*
+    Track a site as vpMeSite::track() did before the convolutions were
+    batched: the query pixels are allocated by vpMeSite::getQueryList() and
+    convolved one by one, and the site is replaced by the query pixel of
+    maximum likelihood.
+  */
+  void trackPerQuery(vpMeSite &site, const vpImage<unsigned char> &I, const vpMe &me)
+  {
+    int range = (int)me.getRange();
+    vpMeSite *query = site.getQueryList(I, range);
+
+    int max_rank = -1;
+    double max_convolution = 0;
+    double contraste = 0;
+    double diff = 1e6;
+    site.i_1 = site.i;
+    site.j_1 = site.j;
+    int i_1 = site.i, j_1 = site.j;
+    for (int n = 0; n < 2 * range + 1; n++) {
+      double convolution = query[n].convolution(I, &me);
+      double likelihood = std::fabs(convolution + site.convlt);
+      if (likelihood > me.getThreshold()) {
+        contraste = convolution / site.convlt;
+        if (contraste > 1 - me.getMu1() && contraste < 1 + me.getMu2() && std::fabs(1 - contraste) < diff) {
+          diff = std::fabs(1 - contraste);
+          max_convolution = convolution;
+          max_rank = n;
+        }
+      }
+    }
+
+    if (max_rank >= 0) {
+      site = query[max_rank];
+      site.normGradient = vpMath::sqr(max_convolution);
+      site.convlt = max_convolution;
+      site.i_1 = i_1;
+      site.j_1 = j_1;
+    }
+    else {
+      site.normGradient = 0;
+      site.setState(std::fabs(contraste) > std::numeric_limits<double>::epsilon() ? vpMeSite::CONSTRAST
+                                                                                  : vpMeSite::THRESHOLD);
+    }
+    delete [] query;
+  }
+
+  /*
+    Compare, for the sites of the tracker, the batched computation of
+    vpMeTracker::track() with the per-site one:
+    - the convolutions of vpMeSite::convolution() for all the sites with the
+      convolution of each pixel of vpMeSite::getQueryList(),
+    - the sites tracked by vpMeTracker::track() with the sites tracked one by
+      one from their query pixels, without the batched convolutions.
+    Then track the image with the tracker.
+  */
+  template<class Tracker>
+  bool trackAndCompare(Tracker &tracker, const vpImage<unsigned char> &I, vpMe &me)
+  {
+    const std::list<vpMeSite> sites = tracker.getMeList();
+
+    std::vector<vpMeSite> query_sites;
+    for (std::list<vpMeSite>::const_iterator it = sites.begin(); it != sites.end(); ++it) {
+      if (it->getState() == vpMeSite::NO_SUPPRESSION)
+        query_sites.push_back(*it);
+    }
+    if (query_sites.empty()) {
+      std::cerr << "No site to track" << std::endl;
+      return false;
+    }
+    std::vector<const vpMeSite *> query_ptrs;
+    for (size_t k = 0; k < query_sites.size(); k++)
+      query_ptrs.push_back(&query_sites[k]);
+
+    unsigned int nb_query = 2 * me.getRange() + 1;
+    std::vector<double> conv(query_sites.size() * nb_query);
+    vpMeSite::convolution(I, &me, &query_ptrs[0], (unsigned int)query_ptrs.size(), &conv[0]);
+    for (size_t k = 0; k < query_sites.size(); k++) {
+      vpMeSite *query = query_sites[k].getQueryList(I, (int)me.getRange());
+      bool same = true;
+      for (unsigned int n = 0; n < nb_query; n++)
+        same = same && (query[n].convolution(I, &me) == conv[k * nb_query + n]);
+      delete [] query;
+      if (! same) {
+        std::cerr << "The convolutions of site " << k << " differ" << std::endl;
+        return false;
+      }
+    }
+
+    std::list<vpMeSite> ref_sites = sites;
+    for (std::list<vpMeSite>::iterator it = ref_sites.begin(); it != ref_sites.end(); ++it) {
+      if (it->getState() == vpMeSite::NO_SUPPRESSION)
+        trackPerQuery(*it, I, me);
+    }
+    tracker.vpMeTracker::track(I);
+    if (! sameSites(tracker.getMeList(), ref_sites)) {
+      std::cerr << "The sites tracked at once differ from the sites tracked from their query pixels" << std::endl;
+      return false;
+    }
+
+    tracker.setMeList(sites);
+    tracker.track(I);
+    return true;
+  }
+
+  bool testLine(vpMe &me)
+  {
+    vpImage<unsigned char> I;
+    int j0 = 100;
+    rectangleImage(I, j0);
+
+    vpMeLine line;
+    line.setMe(&me);
+    line.initTracking(I, vpImagePoint(60, j0), vpImagePoint(180, j0));
+
+    for (int t = 1; t <= 10; t++) {
+      rectangleImage(I, j0 + t);
+      if (! trackAndCompare(line, I, me))
+        return false;
+
+      // The sites have to stay on the edge
+      unsigned int nb_good = 0;
+      std::list<vpMeSite> &sites = line.getMeList();
+      for (std::list<vpMeSite>::const_iterator it = sites.begin(); it != sites.end(); ++it) {
+        if (it->getState() != vpMeSite::NO_SUPPRESSION)
+          continue;
+        nb_good++;
+        if (std::fabs(it->jfloat - (j0 + t)) > 1.5) {
+          std::cerr << "Line site (" << it->ifloat << ", " << it->jfloat << ") is not on the edge" << std::endl;
+          return false;
+        }
+      }
+      if (nb_good < 10) {
+        std::cerr << "The line is lost" << std::endl;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool testEllipse(vpMe &me)
+  {
+    vpImage<unsigned char> I;
+    double ic = 120, jc = 150, a = 70, b = 50;
+    ellipseImage(I, ic, jc, a, b);
+
+    // Points selected counter clockwise
+    vpImagePoint ip[5];
+    for (unsigned int k = 0; k < 5; k++) {
+      double theta = 0.3 - 2. * M_PI * k / 5.;
+      ip[k].set_ij(ic + b * sin(theta), jc + a * cos(theta));
+    }
+    vpMeEllipse ellipse;
+    ellipse.setMe(&me);
+    ellipse.initTracking(I, 5, ip);
+
+    for (int t = 1; t <= 10; t++) {
+      ellipseImage(I, ic + 0.5 * t, jc + t, a, b);
+      if (! trackAndCompare(ellipse, I, me))
+        return false;
+
+      unsigned int nb_good = 0;
+      std::list<vpMeSite> &sites = ellipse.getMeList();
+      for (std::list<vpMeSite>::const_iterator it = sites.begin(); it != sites.end(); ++it) {
+        if (it->getState() != vpMeSite::NO_SUPPRESSION)
+          continue;
+        nb_good++;
+        // First order distance to the edge
+        double dj = it->jfloat - (jc + t), di = it->ifloat - (ic + 0.5 * t);
+        double f = vpMath::sqr(dj / a) + vpMath::sqr(di / b) - 1.;
+        double dist = f / (2. * sqrt(vpMath::sqr(dj / (a * a)) + vpMath::sqr(di / (b * b))));
+        if (std::fabs(dist) > 3.) {
+          std::cerr << "Ellipse site (" << it->ifloat << ", " << it->jfloat << ") is not on the edge" << std::endl;
+          return false;
+        }
+      }
+      if (nb_good < 20) {
+        std::cerr << "The ellipse is lost" << std::endl;
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
+int main()
+{
+  try {
+    vpMe me;
+    me.setRange(10);
+    me.setThreshold(15000);
+    me.setSampleStep(5);
+
+    if (! testLine(me))
+      return 1;
+    std::cout << "Line tracking is ok" << std::endl;
+
+    if (! testEllipse(me))
+      return 1;
+    std::cout << "Ellipse tracking is ok" << std::endl;
+    return 0;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return 1;
+  }
+}
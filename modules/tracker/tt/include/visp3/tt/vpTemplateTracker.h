@@ -50,6 +50,7 @@
 #include <visp3/tt/vpTemplateTrackerZone.h>
 #include <visp3/tt/vpTemplateTrackerWarp.h>
 #include <visp3/core/vpImageFilter.h>
+#include <visp3/core/vpImagePyramid.h>
 
 /*!
   \class vpTemplateTracker
@@ -80,6 +81,9 @@ class VISP_EXPORT vpTemplateTracker
     vpTemplateTrackerPointSuppMIInv **ptTemplateSuppPyr;  //pour inverse et compo
     #endif
 
+    vpTemplateTrackerPointSet  *ptTemplatePacked;    // contiguous copy of ptTemplate
+    vpTemplateTrackerPointSet **ptTemplatePackedPyr;
+
     vpTemplateTrackerPointCompo *ptTemplateCompo;    //pour ESM
     vpTemplateTrackerPointCompo **ptTemplateCompoPyr;   //pour ESM
     vpTemplateTrackerZone               *zoneTracked;
@@ -130,11 +134,20 @@ class VISP_EXPORT vpTemplateTracker
     vpColVector                 X2;
     //temporary derivative matrix
     vpMatrix                    dW;
+    //coordinates of the template points warped by warpTemplate()
+    std::vector<double>         xWarped;
+    std::vector<double>         yWarped;
+    //derivatives of the warp at the points warped in xWarped, yWarped
+    std::vector<double>         dWWarped;
+    //parallel computation of the sums over the template points
+    bool                        useParallelReduction;
+    std::vector<double>         reductionBuffer;
 
     vpImage<double>             BI;
     vpImage<double>             dIx ;
     vpImage<double>             dIy ;
     vpTemplateTrackerZone       zoneRef_; // Reference zone
+    vpImagePyramid              m_pyramid; // Gaussian pyramid of the current image, kept between two images
     
 //private:
 //#ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -160,19 +173,28 @@ class VISP_EXPORT vpTemplateTracker
 //#endif
 
   public:
+    /*!
+      Function adding to \e sum the contribution of the template points in
+      [\e begin, \e end). \e arg is the pointer given to reducePoints().
+     */
+    typedef void (*ReduceTask)(unsigned int begin, unsigned int end, void *arg, double *sum);
+
     //! Default constructor.
     vpTemplateTracker()
       : nbLvlPyr(0), l0Pyr(0), pyrInitialised(false), ptTemplate(NULL), ptTemplatePyr(NULL),
         ptTemplateInit(false), templateSize(0), templateSizePyr(NULL), ptTemplateSelect(NULL),
         ptTemplateSelectPyr(NULL), ptTemplateSelectInit(false), templateSelectSize(0),
-        ptTemplateSupp(NULL), ptTemplateSuppPyr(NULL), ptTemplateCompo(NULL), ptTemplateCompoPyr(NULL),
+        ptTemplateSupp(NULL), ptTemplateSuppPyr(NULL), ptTemplatePacked(NULL), ptTemplatePackedPyr(NULL),
+        ptTemplateCompo(NULL), ptTemplateCompoPyr(NULL),
         zoneTracked(NULL), zoneTrackedPyr(NULL), pyr_IDes(NULL), H(), Hdesire(), HdesirePyr(NULL),
         HLM(), HLMdesire(), HLMdesirePyr(NULL), HLMdesireInverse(), HLMdesireInversePyr(NULL),
         G(), gain(0), thresholdGradient(0), costFunctionVerification(false),
         blur(false), useBrent(false), nbIterBrent(0), taillef(0), fgG(NULL), fgdG(NULL),
         ratioPixelIn(0), mod_i(0), mod_j(0), nbParam(), lambdaDep(0), iterationMax(0),
         iterationGlobale(0), diverge(false), nbIteration(0), useCompositionnal(false),
-        useInverse(false), Warp(NULL), p(), dp(), X1(), X2(), dW(), BI(), dIx(), dIy(), zoneRef_()
+        useInverse(false), Warp(NULL), p(), dp(), X1(), X2(), dW(), xWarped(), yWarped(), dWWarped(),
+        useParallelReduction(false), reductionBuffer(), BI(), dIx(), dIy(), zoneRef_(),
+        m_pyramid(vpImagePyramid::GAUSSIAN)
     {}
     vpTemplateTracker(vpTemplateTrackerWarp *_warp);
     virtual        ~vpTemplateTracker();
@@ -188,6 +210,13 @@ class VISP_EXPORT vpTemplateTracker
     unsigned int getNbIteration() const { return nbIteration; }
     vpColVector getp() const { return p;}
     double  getRatioPixelIn() const {return ratioPixelIn;}
+    /*!
+      Return true if the sums over the template points are computed in
+      parallel.
+
+      \sa setUseParallelReduction()
+     */
+    bool    getUseParallelReduction() const {return useParallelReduction;}
 
     /*!
 
@@ -251,12 +280,29 @@ class VISP_EXPORT vpTemplateTracker
     void    setThresholdGradient(double threshold){thresholdGradient=threshold;}
     /*! By default Brent usage is disabled. */
     void    setUseBrent(bool b){useBrent = b;}
+    /*!
+      Enable or disable the parallel computation of the error, gradient and
+      Hessian sums over the template points in trackNoPyr() and in the
+      Hessian initialization of the SSD and ZNCC trackers.
+
+      The template points are split in blocks of fixed size processed by the
+      threads of vpThreadPool, and the partial sums of the blocks are added
+      in the order of the blocks. The result is thus the same whatever the
+      number of threads, but may differ from the sequential computation by
+      rounding errors. The derivatives of the warp are still computed by the
+      calling thread since the warping functions are not reentrant.
+
+      By default the parallel computation is disabled.
+     */
+    void    setUseParallelReduction(bool b){useParallelReduction = b;}
     
     void    track(const vpImage<unsigned char> &I);
+    void    track(const vpImagePyramid &pyramid);
     void    trackRobust(const vpImage<unsigned char> &I);
     
   protected:
 
+    void            allocWarpedPoints(unsigned int nbDerivatives);
     void            computeOptimalBrentGain(const vpImage<unsigned char> &I,vpColVector &tp,double tMI,vpColVector &direction,double &alpha);
     virtual double  getCost(const vpImage<unsigned char> &I, const vpColVector &tp) = 0;
     void            getGaussianBluredImage(const vpImage<unsigned char> &I){ vpImageFilter::filter(I, BI,fgG,taillef); }
@@ -265,8 +311,11 @@ class VISP_EXPORT vpTemplateTracker
     virtual void    initPyramidal(unsigned int nbLvl,unsigned int l0);
     void            initTracking(const vpImage<unsigned char>& I,vpTemplateTrackerZone &zone);
     virtual void    initTrackingPyr(const vpImage<unsigned char>& I,vpTemplateTrackerZone &zone);
+    void            reducePoints(ReduceTask task, void *arg, std::vector<double> &sum);
     virtual void    trackNoPyr(const vpImage<unsigned char> &I) = 0;
     virtual void    trackPyr(const vpImage<unsigned char> &I);
+    void            trackPyr(const vpImagePyramid &pyramid);
+    void            warpTemplate(const vpColVector &tp);
 };
 #endif
 
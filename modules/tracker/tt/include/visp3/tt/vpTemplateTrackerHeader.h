@@ -45,6 +45,7 @@
 #define vpTemplateTrackerHeader_hh
 
 #include <stdio.h>
+#include <vector>
 
 /*!
   \struct vpTemplateTrackerZPoint
@@ -77,6 +78,22 @@ struct vpTemplateTrackerPoint {
 
     vpTemplateTrackerPoint() : x(0), y(0), dx(0), dy(0), val(0), dW(NULL), HiG(NULL) {}
 };
+/*!
+  \struct vpTemplateTrackerPointSet
+  \ingroup group_tt_tools
+
+  Template points stored as contiguous arrays, point after point. The
+  derivatives dW and the steepest descent directions HiG are filled by the
+  trackers that precompute them, with nbParam values for each point.
+*/
+struct vpTemplateTrackerPointSet {
+    std::vector<double> x,y;
+    std::vector<double> val;
+    std::vector<double> dW;
+    std::vector<double> HiG;
+
+    vpTemplateTrackerPointSet() : x(), y(), val(), dW(), HiG() {}
+};
 /*!
   \struct vpTemplateTrackerPointCompo
   \ingroup group_tt_tools
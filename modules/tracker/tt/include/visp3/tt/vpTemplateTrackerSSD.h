@@ -70,6 +70,7 @@ class VISP_EXPORT vpTemplateTrackerSSD: public vpTemplateTracker
             double  getCost(const vpImage<unsigned char> &I, const vpColVector &tp);
             double  getCost(const vpImage<unsigned char> &I){ return getCost(I,p); }
     virtual void    initHessienDesired(const vpImage<unsigned char> &I) = 0;
+            void    sumGradientHessian(const vpImage<unsigned char> &I, double &erreur, unsigned int &Nbpoint);
     virtual void    trackNoPyr(const vpImage<unsigned char> &I) = 0;
 
   public:
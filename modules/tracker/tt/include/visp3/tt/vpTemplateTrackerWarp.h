@@ -61,10 +61,12 @@ class VISP_EXPORT vpTemplateTrackerWarp
     double denom;
     vpMatrix dW;
     unsigned int nbParam ;
+    //! True if warpX() multiplies by denom = 1/w rather than dividing by w, see warpPoints()
+    bool inverseDenom;
     
   public:
     //constructor;
-    vpTemplateTrackerWarp() : denom(1.), dW(), nbParam(0) {}
+    vpTemplateTrackerWarp() : denom(1.), dW(), nbParam(0), inverseDenom(false) {}
     virtual ~vpTemplateTrackerWarp(){}
 
     #ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -140,6 +142,20 @@ class VISP_EXPORT vpTemplateTrackerWarp
     */
     virtual void getParamInverse(const vpColVector &ParamM,vpColVector &ParamMinv) const = 0;
 
+    /*!
+      Get the matrix \f$ \bf M \f$ of the warping function, such that a point
+      \f$ (u, v) \f$ is warped in \f$ (u', v') \f$ with
+      \f$ w (u', v', 1)^T = {\bf M} (u, v, 1)^T \f$.
+      computeCoeff() has to be called before.
+
+      \param ParamM : Parameters of the warping function.
+      \param M : Resulting 3 by 3 matrix stored row after row.
+
+      \return False if the warping function can't be written that way. This is
+      the default behavior, warpPoints() then uses warpX().
+    */
+    virtual bool getWarpMatrix(const vpColVector &/*ParamM*/, double * /*M*/) const { return false; }
+
     /*!
       Get the parameters of the warping function one level down.
 
@@ -211,6 +227,24 @@ class VISP_EXPORT vpTemplateTrackerWarp
     */
     virtual void warpX(const vpColVector &vX,vpColVector &vXres,const vpColVector &ParamM) = 0;
 
+    /*!
+      Warp a list of points stored as contiguous arrays.
+
+      Warping functions that can be written as a 3 by 3 matrix (see
+      getWarpMatrix()) are applied with a loop specialized for translations,
+      affine and projective warps, without any virtual call per point. The
+      results are bitwise identical to warpX().
+      computeCoeff() has to be called before, as for warpX().
+
+      \param u : List of u coordinates (along the columns) of the points.
+      \param v : List of v coordinates (along the rows) of the points.
+      \param nb_pt : Number of points to warp.
+      \param ParamM : Parameters of the warping function.
+      \param u2 : Resulting u coordinates.
+      \param v2 : Resulting v coordinates.
+    */
+    void warpPoints(const double *u, const double *v, unsigned int nb_pt, const vpColVector &ParamM, double *u2, double *v2);
+
     /*!
       Inverse Warp a point.
 
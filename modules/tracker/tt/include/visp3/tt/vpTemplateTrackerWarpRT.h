@@ -111,6 +111,16 @@ public:
     */
   void getParamInverse(const vpColVector &ParamM,vpColVector &ParamMinv) const;
 
+  /*!
+    Get the matrix of the warping function, see vpTemplateTrackerWarp::getWarpMatrix().
+
+    \param ParamM : Parameters of the warping function.
+    \param M : Resulting 3 by 3 matrix stored row after row.
+
+    \return True.
+  */
+  bool getWarpMatrix(const vpColVector &ParamM, double *M) const;
+
   /*!
       Get the parameters of the warping function one level down.
 
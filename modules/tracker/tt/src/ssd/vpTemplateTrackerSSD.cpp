@@ -39,6 +39,73 @@
 
 #include <visp3/tt/vpTemplateTrackerSSD.h>
 
+#include <vector>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+struct vpSSDGradientHessianData
+{
+  const vpImage<unsigned char> *I;
+  const vpImage<double> *BI;
+  const vpImage<double> *dIx;
+  const vpImage<double> *dIy;
+  bool blur;
+  const double *x;
+  const double *y;
+  const double *val;
+  const double *dW;
+  unsigned int nbParam;
+};
+
+// sum = [erreur, Nbpoint, G, H]
+void sumSSDGradientHessian(unsigned int begin, unsigned int end, void *arg, double *sum)
+{
+  const vpSSDGradientHessianData *data = static_cast<const vpSSDGradientHessianData *>(arg);
+  const unsigned int nbParam=data->nbParam;
+  const unsigned int height=data->I->getHeight();
+  const unsigned int width=data->I->getWidth();
+  double *G=sum+2;
+  double *H=G+nbParam;
+  std::vector<double> tempt(nbParam);
+
+  for(unsigned int point=begin;point<end;point++)
+  {
+    double j2=data->x[point];
+    double i2=data->y[point];
+    if((i2>=0)&&(j2>=0)&&(i2<height-1)&&(j2<width-1))
+    {
+      double Tij=data->val[point];
+      double IW;
+      if(!data->blur)
+        IW=data->I->getValue(i2,j2);
+      else
+        IW=data->BI->getValue(i2,j2);
+
+      double dIWx=data->dIx->getValue(i2,j2);
+      double dIWy=data->dIy->getValue(i2,j2);
+      sum[1]++;
+
+      const double *dW0=data->dW+point*2*nbParam;
+      const double *dW1=dW0+nbParam;
+      for(unsigned int it=0;it<nbParam;it++)
+        tempt[it]=dW0[it]*dIWx+dW1[it]*dIWy;
+
+      for(unsigned int it=0;it<nbParam;it++)
+        for(unsigned int jt=0;jt<nbParam;jt++)
+          H[it*nbParam+jt]+=tempt[it]*tempt[jt];
+
+      double er=(Tij-IW);
+      for(unsigned int it=0;it<nbParam;it++)
+        G[it]+=er*tempt[it];
+
+      sum[0]+=(er*er);
+    }
+  }
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 vpTemplateTrackerSSD::vpTemplateTrackerSSD(vpTemplateTrackerWarp *warp)
   : vpTemplateTracker(warp), DI(), temp()
 {
@@ -60,20 +127,14 @@ double vpTemplateTrackerSSD::getCost(const vpImage<unsigned char> &I, const vpCo
   double IW;
   int Nbpoint=0;
 
-  Warp->computeCoeff(tp);
+  warpTemplate(tp);
   for(unsigned int point=0;point<templateSize;point++)
   {
-    int i=ptTemplate[point].y;
-    int j=ptTemplate[point].x;
-    X1[0]=j;X1[1]=i;
-    Warp->computeDenom(X1,tp);
-    Warp->warpX(X1,X2,tp);
-
-    double j2=X2[0];
-    double i2=X2[1];
+    double j2=xWarped[point];
+    double i2=yWarped[point];
     if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
     {
-      double Tij=ptTemplate[point].val;
+      double Tij=ptTemplatePacked->val[point];
       if(!blur)
         IW=I.getValue(i2,j2);
       else
@@ -100,22 +161,17 @@ double vpTemplateTrackerSSD::getSSD(const vpImage<unsigned char> &I, const vpCol
   {
     templateSize=templateSizePyr[0];
     ptTemplate=ptTemplatePyr[0];
+    ptTemplatePacked=ptTemplatePackedPyr[0];
   }
 
-  Warp->computeCoeff(tp);
+  warpTemplate(tp);
   for(unsigned int point=0;point<templateSize;point++)
   {
-    int i=ptTemplate[point].y;
-    int j=ptTemplate[point].x;
-    X1[0]=j;X1[1]=i;
-    Warp->computeDenom(X1,tp);
-    Warp->warpX(X1,X2,tp);
-
-    double j2=X2[0];
-    double i2=X2[1];
+    double j2=xWarped[point];
+    double i2=yWarped[point];
     if((j2<I.getWidth()-1)&&(i2<I.getHeight()-1)&&(i2>0)&&(j2>0))
     {
-      double Tij=ptTemplate[point].val;
+      double Tij=ptTemplatePacked->val[point];
       IW=I.getValue(i2,j2);
       //IW=getSubPixBspline4(I,i2,j2);
       erreur+=((double)Tij-IW)*((double)Tij-IW);
@@ -125,3 +181,39 @@ double vpTemplateTrackerSSD::getSSD(const vpImage<unsigned char> &I, const vpCol
   if(Nbpoint==0)return 10e10;
   return erreur/Nbpoint;
 }
+
+/*!
+  Compute the sum of the squared errors, the gradient G and the Gauss-Newton
+  approximation H of the Hessian of the SSD over the template points that
+  are warped in xWarped, yWarped and whose warp derivatives dW are stored in
+  dWWarped.
+
+  \param I : Current image; its gradient is in dIx and dIy.
+  \param erreur : Sum of the squared errors.
+  \param Nbpoint : Number of template points warped inside the image.
+ */
+void vpTemplateTrackerSSD::sumGradientHessian(const vpImage<unsigned char> &I, double &erreur, unsigned int &Nbpoint)
+{
+  vpSSDGradientHessianData data;
+  data.I=&I;
+  data.BI=&BI;
+  data.dIx=&dIx;
+  data.dIy=&dIy;
+  data.blur=blur;
+  data.x=&xWarped[0];
+  data.y=&yWarped[0];
+  data.val=&ptTemplatePacked->val[0];
+  data.dW=&dWWarped[0];
+  data.nbParam=nbParam;
+
+  std::vector<double> sum(2+nbParam+nbParam*nbParam);
+  reducePoints(sumSSDGradientHessian,&data,sum);
+
+  erreur=sum[0];
+  Nbpoint=(unsigned int)sum[1];
+  for(unsigned int it=0;it<nbParam;it++)
+    G[it]=sum[2+it];
+  for(unsigned int it=0;it<nbParam;it++)
+    for(unsigned int jt=0;jt<nbParam;jt++)
+      H[it][jt]=sum[2+nbParam+it*nbParam+jt];
+}
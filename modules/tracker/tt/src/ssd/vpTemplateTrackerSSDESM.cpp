@@ -39,6 +39,94 @@
 #include <visp3/tt/vpTemplateTrackerSSDESM.h>
 #include <visp3/core/vpImageFilter.h>
 
+#include <algorithm>
+#include <vector>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+struct vpSSDESMData
+{
+  const vpImage<unsigned char> *I;
+  const vpImage<double> *BI;
+  const vpImage<double> *dIx;
+  const vpImage<double> *dIy;
+  bool blur;
+  const vpTemplateTrackerPoint *ptTemplate;
+  const double *x;
+  const double *y;
+  const double *dW;
+  unsigned int nbParam;
+};
+
+// sum = [HInv]
+void sumESMHessianInverse(unsigned int begin, unsigned int end, void *arg, double *sum)
+{
+  const vpSSDESMData *data = static_cast<const vpSSDESMData *>(arg);
+  const unsigned int nbParam=data->nbParam;
+  for(unsigned int point=begin;point<end;point++)
+  {
+    const double *dW=data->ptTemplate[point].dW;
+    for(unsigned int it=0;it<nbParam;it++)
+      for(unsigned int jt=0;jt<nbParam;jt++)
+        sum[it*nbParam+jt]+=dW[it]*dW[jt];
+  }
+}
+
+// sum = [erreur, Nbpoint, GInv, GDir, HDir]
+void sumESMGradientHessian(unsigned int begin, unsigned int end, void *arg, double *sum)
+{
+  const vpSSDESMData *data = static_cast<const vpSSDESMData *>(arg);
+  const unsigned int nbParam=data->nbParam;
+  const unsigned int height=data->I->getHeight();
+  const unsigned int width=data->I->getWidth();
+  double *GInv=sum+2;
+  double *GDir=GInv+nbParam;
+  double *HDir=GDir+nbParam;
+  std::vector<double> tempt(nbParam);
+
+  for(unsigned int point=begin;point<end;point++)
+  {
+    double j2=data->x[point];
+    double i2=data->y[point];
+    if((i2>=0)&&(j2>=0)&&(i2<height-1)&&(j2<width-1))
+    {
+      const vpTemplateTrackerPoint &pt=data->ptTemplate[point];
+      //INVERSE
+      double Tij=pt.val;
+      double IW;
+      if(!data->blur)
+        IW=data->I->getValue(i2,j2);
+      else
+        IW=data->BI->getValue(i2,j2);
+      sum[1]++;
+      double er=(Tij-IW);
+      for(unsigned int it=0;it<nbParam;it++)
+        GInv[it]+=er*pt.dW[it];
+
+      sum[0]+=er*er;
+
+      //DIRECT
+      double dIWx=data->dIx->getValue(i2,j2)+pt.dx;
+      double dIWy=data->dIy->getValue(i2,j2)+pt.dy;
+
+      const double *dW0=data->dW+point*2*nbParam;
+      const double *dW1=dW0+nbParam;
+      for(unsigned int it=0;it<nbParam;it++)
+        tempt[it]=dW0[it]*dIWx+dW1[it]*dIWy;
+
+      for(unsigned int it=0;it<nbParam;it++)
+        for(unsigned int jt=0;jt<nbParam;jt++)
+          HDir[it*nbParam+jt]+=tempt[it]*tempt[jt];
+
+      for(unsigned int it=0;it<nbParam;it++)
+        GDir[it]+=er*tempt[it];
+    }
+  }
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 vpTemplateTrackerSSDESM::vpTemplateTrackerSSDESM(vpTemplateTrackerWarp *warp)
   : vpTemplateTrackerSSD(warp), compoInitialised(false), HDir(), HInv(),
     HLMDir(), HLMInv(), GDir(), GInv()
@@ -80,7 +168,6 @@ void vpTemplateTrackerSSDESM::initCompInverse(const vpImage<unsigned char> &/*I*
   }
 
   //inverse
-  HInv=0;
   for(unsigned int point=0;point<templateSize;point++)
   {
     i=ptTemplate[point].y;
@@ -90,11 +177,16 @@ void vpTemplateTrackerSSDESM::initCompInverse(const vpImage<unsigned char> &/*I*
     Warp->computeDenom(X1,p);
     ptTemplate[point].dW=new double[nbParam];
     Warp->getdW0(i,j,ptTemplate[point].dy,ptTemplate[point].dx,ptTemplate[point].dW);
-
-    for(unsigned int it=0;it<nbParam;it++)
-      for(unsigned int jt=0;jt<nbParam;jt++)
-        HInv[it][jt]+=ptTemplate[point].dW[it]*ptTemplate[point].dW[jt];
   }
+
+  vpSSDESMData data=vpSSDESMData();
+  data.ptTemplate=ptTemplate;
+  data.nbParam=nbParam;
+  std::vector<double> sum(nbParam*nbParam);
+  reducePoints(sumESMHessianInverse,&data,sum);
+  for(unsigned int it=0;it<nbParam;it++)
+    for(unsigned int jt=0;jt<nbParam;jt++)
+      HInv[it][jt]=sum[it*nbParam+jt];
   vpMatrix::computeHLM(HInv,lambdaDep,HLMInv);
 
 compoInitialised=true;
@@ -107,20 +199,27 @@ void vpTemplateTrackerSSDESM::trackNoPyr(const vpImage<unsigned char> &I)
   vpImageFilter::getGradXGauss2D(I, dIx, fgG,fgdG,taillef);
   vpImageFilter::getGradYGauss2D(I, dIy, fgG,fgdG,taillef);
 
-  double IW,dIWx,dIWy;
-  double Tij;
   unsigned int iteration=0;
   int i,j;
   double i2,j2;
   double alpha=2.;
+  allocWarpedPoints(2*nbParam);
+
+  vpSSDESMData data;
+  data.I=&I;
+  data.BI=&BI;
+  data.dIx=&dIx;
+  data.dIy=&dIy;
+  data.blur=blur;
+  data.ptTemplate=ptTemplate;
+  data.x=&xWarped[0];
+  data.y=&yWarped[0];
+  data.dW=&dWWarped[0];
+  data.nbParam=nbParam;
+  std::vector<double> sum(2+2*nbParam+nbParam*nbParam);
   do
   {
-    unsigned int Nbpoint=0;
-    double erreur=0;
     dp=0;
-    HDir=0;
-    GDir=0;
-    GInv=0;
     Warp->computeCoeff(p);
     for(unsigned int point=0;point<templateSize;point++)
     {
@@ -132,47 +231,26 @@ void vpTemplateTrackerSSDESM::trackNoPyr(const vpImage<unsigned char> &I)
       Warp->warpX(X1,X2,p);
 
       j2=X2[0];i2=X2[1];
+      xWarped[point]=j2;yWarped[point]=i2;
       if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
       {
-        //INVERSE
-        Tij=ptTemplate[point].val;
-        if(!blur)
-          IW=I.getValue(i2,j2);
-        else
-          IW=BI.getValue(i2,j2);
-        Nbpoint++;
-        double er=(Tij-IW);
-        for(unsigned int it=0;it<nbParam;it++)
-          GInv[it]+=er*ptTemplate[point].dW[it];
-
-        erreur+=er*er;
-
-        //DIRECT
-        //dIWx=dIx.getValue(i2,j2);
-        //dIWy=dIy.getValue(i2,j2);
-
-        dIWx=dIx.getValue(i2,j2)+ptTemplate[point].dx;
-        dIWy=dIy.getValue(i2,j2)+ptTemplate[point].dy;
-
         //Calcul du Hessien
-        //Warp->dWarp(X1,X2,p,dW);
         Warp->dWarpCompo(X1,X2,p,ptTemplateCompo[point].dW,dW);
-
-        double *tempt=new double[nbParam];
-        for(unsigned int it=0;it<nbParam;it++)
-          tempt[it]=dW[0][it]*dIWx+dW[1][it]*dIWy;
-
-        for(unsigned int it=0;it<nbParam;it++)
-          for(unsigned int jt=0;jt<nbParam;jt++)
-            HDir[it][jt]+=tempt[it]*tempt[jt];
-
-        for(unsigned int it=0;it<nbParam;it++)
-          GDir[it]+=er*tempt[it];
-        delete[] tempt;
+        std::copy(dW.data,dW.data+2*nbParam,&dWWarped[point*2*nbParam]);
       }
+    }
+    reducePoints(sumESMGradientHessian,&data,sum);
 
-
+    double erreur=sum[0];
+    unsigned int Nbpoint=(unsigned int)sum[1];
+    for(unsigned int it=0;it<nbParam;it++)
+    {
+      GInv[it]=sum[2+it];
+      GDir[it]=sum[2+nbParam+it];
+      for(unsigned int jt=0;jt<nbParam;jt++)
+        HDir[it][jt]=sum[2+2*nbParam+it*nbParam+jt];
     }
+
     if(Nbpoint==0) {
       //std::cout<<"plus de point dans template suivi"<<std::endl;
       throw(vpTrackingException(vpTrackingException::notEnoughPointError, "No points in the template"));
@@ -38,6 +38,7 @@
  *****************************************************************************/
 
 #include <limits>   // numeric_limits
+#include <algorithm>
 
 #include <visp3/tt/vpTemplateTrackerSSDForwardAdditional.h>
 #include <visp3/core/vpImageTools.h>
@@ -58,18 +59,15 @@ void vpTemplateTrackerSSDForwardAdditional::trackNoPyr(const vpImage<unsigned ch
   dW=0;
 
   double lambda=lambdaDep;
-  double IW,dIWx,dIWy;
-  double Tij;
   unsigned int iteration=0;
   int i,j;
   double i2,j2;
   double alpha=2.;
+  allocWarpedPoints(2*nbParam);
   do
   {
     unsigned int Nbpoint=0;
     double erreur=0;
-    G=0;
-    H=0 ;
     Warp->computeCoeff(p);
     for(unsigned int point=0;point<templateSize;point++)
     {
@@ -81,38 +79,16 @@ void vpTemplateTrackerSSDForwardAdditional::trackNoPyr(const vpImage<unsigned ch
       Warp->warpX(X1,X2,p);
 
       j2=X2[0];i2=X2[1];
+      xWarped[point]=j2;yWarped[point]=i2;
       if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
       {
-        Tij=ptTemplate[point].val;
-
-        if(!blur)
-          IW=I.getValue(i2,j2);
-        else
-          IW=BI.getValue(i2,j2);
-
-        dIWx=dIx.getValue(i2,j2);
-        dIWy=dIy.getValue(i2,j2);
-        Nbpoint++;
         //Calcul du Hessien
         Warp->dWarp(X1,X2,p,dW);
-        double *tempt=new double[nbParam];
-        for(unsigned int it=0;it<nbParam;it++)
-          tempt[it]=dW[0][it]*dIWx+dW[1][it]*dIWy;
-
-        for(unsigned int it=0;it<nbParam;it++)
-          for(unsigned int jt=0;jt<nbParam;jt++)
-            H[it][jt]+=tempt[it]*tempt[jt];
-
-        double er=(Tij-IW);
-        for(unsigned int it=0;it<nbParam;it++)
-          G[it]+=er*tempt[it];
-
-        erreur+=(er*er);
-        delete[] tempt;
+        std::copy(dW.data,dW.data+2*nbParam,&dWWarped[point*2*nbParam]);
       }
-
-
     }
+    sumGradientHessian(I,erreur,Nbpoint);
+
     if(Nbpoint==0) {
       //std::cout<<"plus de point dans template suivi"<<std::endl;
       throw(vpTrackingException(vpTrackingException::notEnoughPointError, "No points in the template"));
@@ -39,6 +39,79 @@
 #include <visp3/tt/vpTemplateTrackerSSDInverseCompositional.h>
 #include <visp3/core/vpImageTools.h>
 
+#include <vector>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+struct vpSSDInverseCompositionalData
+{
+  const vpImage<unsigned char> *I;
+  const vpImage<double> *BI;
+  bool blur;
+  const bool *select;
+  const double *x;
+  const double *y;
+  const double *val;
+  const double *dW;
+  const double *HiG;
+  unsigned int nbParam;
+};
+
+// sum = [H]
+void sumSSDICHessian(unsigned int begin, unsigned int end, void *arg, double *sum)
+{
+  const vpSSDInverseCompositionalData *data = static_cast<const vpSSDInverseCompositionalData *>(arg);
+  const unsigned int nbParam=data->nbParam;
+  for(unsigned int point=begin;point<end;point++)
+  {
+    if((data->select==NULL)||(data->select[point]))
+    {
+      const double *dWpt=data->dW+point*nbParam;
+      for(unsigned int it=0;it<nbParam;it++)
+        for(unsigned int jt=0;jt<nbParam;jt++)
+          sum[it*nbParam+jt]+=dWpt[it]*dWpt[jt];
+    }
+  }
+}
+
+// sum = [erreur, Nbpoint, dp]
+void sumSSDICError(unsigned int begin, unsigned int end, void *arg, double *sum)
+{
+  const vpSSDInverseCompositionalData *data = static_cast<const vpSSDInverseCompositionalData *>(arg);
+  const unsigned int nbParam=data->nbParam;
+  const unsigned int height=data->I->getHeight();
+  const unsigned int width=data->I->getWidth();
+  double *dp=sum+2;
+  for(unsigned int point=begin;point<end;point++)
+  {
+    if((data->select==NULL)||(data->select[point]))
+    {
+      double j2=data->x[point];
+      double i2=data->y[point];
+
+      if((i2>=0)&&(j2>=0)&&(i2<height-1)&&(j2<width-1))
+      {
+        double Tij=data->val[point];
+        double IW;
+        if(!data->blur)
+          IW=data->I->getValue(i2,j2);
+        else
+          IW=data->BI->getValue(i2,j2);
+        sum[1]++;
+        double er=(Tij-IW);
+        const double *HiG=data->HiG+point*nbParam;
+        for(unsigned int it=0;it<nbParam;it++)
+          dp[it]+=er*HiG[it];
+
+        sum[0]+=er*er;
+      }
+    }
+  }
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 vpTemplateTrackerSSDInverseCompositional::vpTemplateTrackerSSDInverseCompositional(vpTemplateTrackerWarp *warp)
   : vpTemplateTrackerSSD(warp), compoInitialised(false), HInv(), HCompInverse(), useTemplateSelect(false),
     evolRMS(0), x_pos(), y_pos(), threshold_RMS(1e-8)
@@ -51,9 +124,10 @@ vpTemplateTrackerSSDInverseCompositional::vpTemplateTrackerSSDInverseComposition
 void vpTemplateTrackerSSDInverseCompositional::initCompInverse(const vpImage<unsigned char> &/*I*/)
 {
 
-  H=0;
   int i,j;
 
+  ptTemplatePacked->dW.assign(templateSize*nbParam,0.);
+  ptTemplatePacked->HiG.assign(templateSize*nbParam,0.);
   for(unsigned int point=0;point<templateSize;point++)
   {
     if((!useTemplateSelect)||(ptTemplateSelect[point]))
@@ -62,16 +136,19 @@ void vpTemplateTrackerSSDInverseCompositional::initCompInverse(const vpImage<uns
       j=ptTemplate[point].x;
       X1[0]=j;X1[1]=i;
       Warp->computeDenom(X1,p);
-      ptTemplate[point].dW=new double[nbParam];
-
-      Warp->getdW0(i,j,ptTemplate[point].dy,ptTemplate[point].dx,ptTemplate[point].dW);
-
-      for(unsigned int it=0;it<nbParam;it++)
-        for(unsigned int jt=0;jt<nbParam;jt++)
-          H[it][jt]+=ptTemplate[point].dW[it]*ptTemplate[point].dW[jt];
+      Warp->getdW0(i,j,ptTemplate[point].dy,ptTemplate[point].dx,&ptTemplatePacked->dW[point*nbParam]);
     }
-
   }
+
+  vpSSDInverseCompositionalData data=vpSSDInverseCompositionalData();
+  data.select=useTemplateSelect ? ptTemplateSelect : NULL;
+  data.dW=&ptTemplatePacked->dW[0];
+  data.nbParam=nbParam;
+  std::vector<double> sum(nbParam*nbParam);
+  reducePoints(sumSSDICHessian,&data,sum);
+  for(unsigned int it=0;it<nbParam;it++)
+    for(unsigned int jt=0;jt<nbParam;jt++)
+      H[it][jt]=sum[it*nbParam+jt];
   HInv=H;
   vpMatrix HLMtemp(nbParam,nbParam);
   vpMatrix::computeHLM(H,lambdaDep,HLMtemp);
@@ -86,16 +163,15 @@ void vpTemplateTrackerSSDInverseCompositional::initCompInverse(const vpImage<uns
   {
     if((!useTemplateSelect)||(ptTemplateSelect[point]))
     {
-      //i=ptTemplate[point].y;
-      //j=ptTemplate[point].x;
+      const double *dWpt=&ptTemplatePacked->dW[point*nbParam];
       for(unsigned int it=0;it<nbParam;it++)
-        dWtemp[it]=ptTemplate[point].dW[it];
-      
+        dWtemp[it]=dWpt[it];
+
       HiGtemp	= -1.*HCompInverse*dWtemp;
-      ptTemplate[point].HiG=new double[nbParam];
 
+      double *HiGpt=&ptTemplatePacked->HiG[point*nbParam];
       for(unsigned int it=0;it<nbParam;it++)
-        ptTemplate[point].HiG[it]=HiGtemp[it];
+        HiGpt[it]=HiGtemp[it];
     }
   }
   compoInitialised=true;
@@ -112,51 +188,32 @@ void vpTemplateTrackerSSDInverseCompositional::trackNoPyr(const vpImage<unsigned
     vpImageFilter::filter(I, BI,fgG,taillef);
 
   vpColVector dpinv(nbParam);
-  double IW;
-  double Tij;
   unsigned int iteration=0;
-  int i,j;
-  double i2,j2;
   double alpha=2.;
   //vpTemplateTrackerPointtest *pt;
   initPosEvalRMS(p);
 
-  vpTemplateTrackerPoint *pt;
+  vpSSDInverseCompositionalData data;
+  data.I=&I;
+  data.BI=&BI;
+  data.blur=blur;
+  data.select=useTemplateSelect ? ptTemplateSelect : NULL;
+  data.val=&ptTemplatePacked->val[0];
+  data.HiG=&ptTemplatePacked->HiG[0];
+  data.dW=NULL;
+  data.nbParam=nbParam;
+  std::vector<double> sum(2+nbParam);
   do
   {
-    unsigned int Nbpoint=0;
-    double erreur=0;
-    dp=0;
-    Warp->computeCoeff(p);
-    for(unsigned int point=0;point<templateSize;point++)
-    {
-      if((!useTemplateSelect)||(ptTemplateSelect[point]))
-      {
-        //pt=&ptTemplatetest[point];
-        pt=&ptTemplate[point];
-        i=pt->y;
-        j=pt->x;
-        X1[0]=j;X1[1]=i;
-        Warp->computeDenom(X1,p);
-        Warp->warpX(X1,X2,p);
-        j2=X2[0];i2=X2[1];
-
-        if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
-        {
-          Tij=pt->val;
-          if(!blur)
-            IW=I.getValue(i2,j2);
-          else
-            IW=BI.getValue(i2,j2);
-          Nbpoint++;
-          double er=(Tij-IW);
-          for(unsigned int it=0;it<nbParam;it++)
-            dp[it]+=er*pt->HiG[it];
-
-          erreur+=er*er;
-        }
-      }
-    }
+    warpTemplate(p);
+    data.x=&xWarped[0];
+    data.y=&yWarped[0];
+    reducePoints(sumSSDICError,&data,sum);
+
+    double erreur=sum[0];
+    unsigned int Nbpoint=(unsigned int)sum[1];
+    for(unsigned int it=0;it<nbParam;it++)
+      dp[it]=sum[2+it];
     //std::cout << "npoint: " << Nbpoint << std::endl;
     if(Nbpoint==0) {
       //std::cout<<"plus de point dans template suivi"<<std::endl;
@@ -39,12 +39,16 @@
 
 #include <visp3/tt/vpTemplateTracker.h>
 #include <visp3/tt/vpTemplateTrackerBSpline.h>
+#include <visp3/core/vpThreadPool.h>
+
+#include <algorithm>
 
 vpTemplateTracker::vpTemplateTracker(vpTemplateTrackerWarp *_warp)
   : nbLvlPyr(1), l0Pyr(0), pyrInitialised(false), ptTemplate(NULL), ptTemplatePyr(NULL),
     ptTemplateInit(false), templateSize(0), templateSizePyr(NULL),
     ptTemplateSelect(NULL), ptTemplateSelectPyr(NULL), ptTemplateSelectInit(false),
     templateSelectSize(0), ptTemplateSupp(NULL), ptTemplateSuppPyr(NULL),
+    ptTemplatePacked(NULL), ptTemplatePackedPyr(NULL),
     ptTemplateCompo(NULL), ptTemplateCompoPyr(NULL), zoneTracked(NULL), zoneTrackedPyr(NULL),
     pyr_IDes(NULL), H(), Hdesire(), HdesirePyr(), HLM(), HLMdesire(), HLMdesirePyr(),
     HLMdesireInverse(), HLMdesireInversePyr(), G(), gain(1.), thresholdGradient(40),
@@ -52,7 +56,7 @@ vpTemplateTracker::vpTemplateTracker(vpTemplateTrackerWarp *_warp)
     taillef(7), fgG(NULL), fgdG(NULL), ratioPixelIn(0), mod_i(1), mod_j(1), nbParam(0),
     lambdaDep(0.001), iterationMax(30), iterationGlobale(0), diverge(false), nbIteration(0),
     useCompositionnal(true), useInverse(false), Warp(_warp), p(0), dp(), X1(), X2(),
-    dW(), BI(), dIx(), dIy(), zoneRef_()
+    dW(), xWarped(), yWarped(), dWWarped(), useParallelReduction(false), reductionBuffer(), BI(), dIx(), dIy(), zoneRef_(), m_pyramid(vpImagePyramid::GAUSSIAN)
 {
   nbParam = Warp->getNbParam() ;
   p.resize(nbParam);
@@ -159,6 +163,17 @@ void vpTemplateTracker::initTracking(const vpImage<unsigned char>& I, vpTemplate
 
   templateSize=cpt_point;
   GaussI.destroy();
+
+  ptTemplatePacked = new vpTemplateTrackerPointSet;
+  ptTemplatePacked->x.resize(templateSize);
+  ptTemplatePacked->y.resize(templateSize);
+  ptTemplatePacked->val.resize(templateSize);
+  for(unsigned int point=0;point<templateSize;point++)
+  {
+    ptTemplatePacked->x[point]=ptTemplate[point].x;
+    ptTemplatePacked->y[point]=ptTemplate[point].y;
+    ptTemplatePacked->val[point]=ptTemplate[point].val;
+  }
   // 	std::cout<<"\tEnd of reference initialisation ..."<<std::endl;
 }
 
@@ -198,6 +213,14 @@ void vpTemplateTracker::resetTracker()
         ptTemplatePyr = NULL;
     }
 
+    if (ptTemplatePackedPyr) {
+      for(unsigned int i=0;i<nbLvlPyr;i++)
+        delete ptTemplatePackedPyr[i];
+      delete[] ptTemplatePackedPyr;
+      ptTemplatePackedPyr = NULL;
+    }
+    ptTemplatePacked = NULL;
+
     if (ptTemplateCompoPyr) {
       for(unsigned int i=0;i<nbLvlPyr;i++)
       {
@@ -283,6 +306,10 @@ void vpTemplateTracker::resetTracker()
       ptTemplate = NULL;
       ptTemplateInit = false;
     }
+    if (ptTemplatePacked) {
+      delete ptTemplatePacked;
+      ptTemplatePacked = NULL;
+    }
     if (ptTemplateCompo) {
       for(unsigned int point=0;point<templateSize;point++)
       {
@@ -613,11 +640,13 @@ void vpTemplateTracker::initPyramidal(unsigned int nbLvl, unsigned int l0)
   ptTemplateSelectPyr=new bool*[nbLvlPyr];
   ptTemplateSuppPyr=new vpTemplateTrackerPointSuppMIInv*[nbLvlPyr];
   ptTemplateCompoPyr=new vpTemplateTrackerPointCompo*[nbLvlPyr];
+  ptTemplatePackedPyr=new vpTemplateTrackerPointSet*[nbLvlPyr];
   for(unsigned int i=0; i< nbLvlPyr; i++) {
     ptTemplatePyr[i]       = NULL;
     ptTemplateSuppPyr[i]   = NULL;
     ptTemplateSelectPyr[i] = NULL;
     ptTemplateCompoPyr[i]  = NULL;
+    ptTemplatePackedPyr[i] = NULL;
   }
   templateSizePyr=new unsigned int[nbLvlPyr];
   HdesirePyr=new vpMatrix[nbLvlPyr];
@@ -637,6 +666,7 @@ void vpTemplateTracker::initTrackingPyr(const vpImage<unsigned char>& I,vpTempla
   pyr_IDes[0]=I;
   initTracking(pyr_IDes[0],zoneTrackedPyr[0]);
   ptTemplatePyr[0]=ptTemplate;
+  ptTemplatePackedPyr[0]=ptTemplatePacked;
   ptTemplateSelectPyr[0]=ptTemplateSelect;
   templateSizePyr[0]=templateSize;
 
@@ -650,6 +680,7 @@ void vpTemplateTracker::initTrackingPyr(const vpImage<unsigned char>& I,vpTempla
 
       initTracking(pyr_IDes[i],zoneTrackedPyr[i]);
       ptTemplatePyr[i]=ptTemplate;
+      ptTemplatePackedPyr[i]=ptTemplatePacked;
       ptTemplateSelectPyr[i]=ptTemplateSelect;
       templateSizePyr[i]=templateSize;
       //reste probleme avec le Hessien
@@ -757,6 +788,7 @@ void vpTemplateTracker::initHessienDesiredPyr(const vpImage<unsigned char> &I)
   //ptTemplateSupp=ptTemplateSuppPyr[0];
   //ptTemplateCompo=ptTemplateCompoPyr[0];
   ptTemplate=ptTemplatePyr[0];
+  ptTemplatePacked=ptTemplatePackedPyr[0];
   ptTemplateSelect=ptTemplateSelectPyr[0];
 //  ptTemplateSupp=new vpTemplateTrackerPointSuppMIInv[templateSize];
   try{
@@ -778,13 +810,14 @@ void vpTemplateTracker::initHessienDesiredPyr(const vpImage<unsigned char> &I)
 
   if(nbLvlPyr>1)
   {
-    vpImage<unsigned char> Itemp;Itemp=I;
+    m_pyramid.build(I, nbLvlPyr);
     for(unsigned int i=1;i<nbLvlPyr;i++)
     {
-      vpImageFilter::getGaussPyramidal(Itemp,Itemp);
+      const vpImage<unsigned char> &Itemp = m_pyramid[i];
 
       templateSize=templateSizePyr[i];
       ptTemplate=ptTemplatePyr[i];
+      ptTemplatePacked=ptTemplatePackedPyr[i];
       ptTemplateSelect=ptTemplateSelectPyr[i];
       //ptTemplateSupp=ptTemplateSuppPyr[i];
       //ptTemplateCompo=ptTemplateCompoPyr[i];
@@ -821,13 +854,35 @@ void vpTemplateTracker::track(const vpImage<unsigned char> &I)
     trackNoPyr(I);
 }
 
+/*!
+   Track the template on an image from its Gaussian pyramid. This allows to
+   share the pyramid with other trackers working on the same image.
+
+   \param pyramid: vpImagePyramid::GAUSSIAN pyramid of the image to process,
+   with at least as many levels as set with setPyramidal().
+ */
+void vpTemplateTracker::track(const vpImagePyramid &pyramid)
+{
+  if (nbLvlPyr > 1)
+    trackPyr(pyramid);
+  else
+    trackNoPyr(pyramid[0]);
+}
+
 void vpTemplateTracker::trackPyr(const vpImage<unsigned char> &I)
+{
+  m_pyramid.build(I, nbLvlPyr);
+  trackPyr(m_pyramid);
+}
+
+void vpTemplateTracker::trackPyr(const vpImagePyramid &pyramid)
 {
   //vpTRACE("trackPyr");
-  vpImage<unsigned char> *pyr_I;
-//  pyr_I=new vpImage<unsigned char>[nbLvlPyr+1]; // Why +1 ?
-  pyr_I=new vpImage<unsigned char>[nbLvlPyr]; // Why +1 ?
-  pyr_I[0]=I;
+  if (pyramid.getType() != vpImagePyramid::GAUSSIAN || pyramid.getNbLevels() < nbLvlPyr) {
+    throw(vpTrackingException(vpTrackingException::badValue,
+                              "The template tracker needs a Gaussian pyramid of %u levels", nbLvlPyr));
+  }
+  const vpImage<unsigned char> &I = pyramid[0];
 
   try
   {
@@ -840,7 +895,6 @@ void vpTemplateTracker::trackPyr(const vpImage<unsigned char> &I)
     //    p_sauv[0]=p;
         for(unsigned int i=1;i<nbLvlPyr;i++)
         {
-          vpImageFilter::getGaussPyramidal(pyr_I[i-1],pyr_I[i]);
           //test getParamPyramidDown
           /*vpColVector vX_test(2);vX_test[0]=15.;vX_test[1]=30.;
           vpColVector vX_test2(2);
@@ -871,6 +925,7 @@ void vpTemplateTracker::trackPyr(const vpImage<unsigned char> &I)
           {
             templateSize=templateSizePyr[i];
             ptTemplate=ptTemplatePyr[i];
+            ptTemplatePacked=ptTemplatePackedPyr[i];
             ptTemplateSelect=ptTemplateSelectPyr[i];
             ptTemplateSupp=ptTemplateSuppPyr[i];
             ptTemplateCompo=ptTemplateCompoPyr[i];
@@ -878,7 +933,7 @@ void vpTemplateTracker::trackPyr(const vpImage<unsigned char> &I)
             HLM=HLMdesirePyr[i];
             HLMdesireInverse=HLMdesireInversePyr[i];
     //        zoneTracked=&zoneTrackedPyr[i];
-            trackRobust(pyr_I[i]);
+            trackRobust(pyramid[i]);
           }
           //std::cout<<"get p up"<<std::endl;
     //      ptemp=p_sauv[i-1];
@@ -893,6 +948,7 @@ void vpTemplateTracker::trackPyr(const vpImage<unsigned char> &I)
         {
           templateSize=templateSizePyr[0];
           ptTemplate=ptTemplatePyr[0];
+          ptTemplatePacked=ptTemplatePackedPyr[0];
           ptTemplateSelect=ptTemplateSelectPyr[0];
           ptTemplateSupp=ptTemplateSuppPyr[0];
           ptTemplateCompo=ptTemplateCompoPyr[0];
@@ -900,7 +956,7 @@ void vpTemplateTracker::trackPyr(const vpImage<unsigned char> &I)
           HLM=HLMdesirePyr[0];
           HLMdesireInverse=HLMdesireInversePyr[0];
           zoneTracked=&zoneTrackedPyr[0];
-          trackRobust(pyr_I[0]);
+          trackRobust(pyramid[0]);
         }
 
         if (l0Pyr > 0) {
@@ -918,10 +974,8 @@ void vpTemplateTracker::trackPyr(const vpImage<unsigned char> &I)
         //std::cout<<"reviens a tracker de base"<<std::endl;
         trackRobust(I);
       }
-      delete[] pyr_I;
   }
   catch(vpException &e){
-      delete[] pyr_I;
       throw(vpTrackingException(vpTrackingException::badValue, e.getMessage()));
   }
 }
@@ -945,3 +999,110 @@ void vpTemplateTracker::trackRobust(const vpImage<unsigned char> &I)
   else
     trackNoPyr(I);
 }
+
+/*!
+  Warp all the template points with the parameters \e tp. The resulting
+  coordinates are stored in xWarped and yWarped.
+
+  \param tp : Parameters of the warping function.
+ */
+void vpTemplateTracker::warpTemplate(const vpColVector &tp)
+{
+  allocWarpedPoints(0);
+
+  Warp->computeCoeff(tp);
+  if(templateSize>0)
+    Warp->warpPoints(&ptTemplatePacked->x[0],&ptTemplatePacked->y[0],templateSize,tp,&xWarped[0],&yWarped[0]);
+}
+
+/*!
+  Allocate xWarped and yWarped for the current template, and dWWarped with
+  \e nbDerivatives values per template point.
+
+  \param nbDerivatives : Number of values of the warp derivatives stored per
+  point in dWWarped.
+ */
+void vpTemplateTracker::allocWarpedPoints(unsigned int nbDerivatives)
+{
+  if(xWarped.size()<templateSize) {
+    xWarped.resize(templateSize);
+    yWarped.resize(templateSize);
+  }
+  if(dWWarped.size()<templateSize*nbDerivatives)
+    dWWarped.resize(templateSize*nbDerivatives);
+}
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Number of template points summed together by reducePoints(). It doesn't
+// depend on the number of threads, so that the result of the parallel sums
+// is always the same.
+const unsigned int vpTemplateTrackerReduceBlockSize = 1024;
+
+struct vpTemplateTrackerReduceData
+{
+  vpTemplateTracker::ReduceTask task;
+  void *arg;
+  unsigned int nbPoints;
+  unsigned int nbValues;
+  double *partialSums;
+};
+
+void reduceBlocks(unsigned int begin, unsigned int end, void *arg)
+{
+  vpTemplateTrackerReduceData *data = static_cast<vpTemplateTrackerReduceData *>(arg);
+  for(unsigned int b=begin;b<end;b++)
+  {
+    unsigned int first=b*vpTemplateTrackerReduceBlockSize;
+    unsigned int last=std::min(first+vpTemplateTrackerReduceBlockSize,data->nbPoints);
+    data->task(first,last,data->arg,data->partialSums+b*data->nbValues);
+  }
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Compute a sum over all the template points. \e task is called to add the
+  contribution of a range of points to a zeroed array of \e sum.size()
+  values.
+
+  When the parallel computation is disabled (see setUseParallelReduction()),
+  \e task is called once on all the points. Otherwise the points are split in
+  blocks of fixed size whose partial sums are computed by the threads of
+  vpThreadPool and then added in the order of the blocks, which gives the same
+  result whatever the number of threads.
+
+  \param task : Function adding the contribution of a range of points.
+  \param arg : Pointer given to \e task.
+  \param sum : Resulting sums. Its size gives the number of values.
+ */
+void vpTemplateTracker::reducePoints(ReduceTask task, void *arg, std::vector<double> &sum)
+{
+  const unsigned int nbValues=(unsigned int)sum.size();
+  std::fill(sum.begin(),sum.end(),0.);
+
+  if((!useParallelReduction)||(templateSize<=vpTemplateTrackerReduceBlockSize))
+  {
+    task(0,templateSize,arg,nbValues ? &sum[0] : NULL);
+    return;
+  }
+
+  const unsigned int nbBlocks=(templateSize+vpTemplateTrackerReduceBlockSize-1)/vpTemplateTrackerReduceBlockSize;
+  reductionBuffer.assign(nbBlocks*nbValues,0.);
+
+  vpTemplateTrackerReduceData data;
+  data.task=task;
+  data.arg=arg;
+  data.nbPoints=templateSize;
+  data.nbValues=nbValues;
+  data.partialSums=&reductionBuffer[0];
+  vpThreadPool::parallelFor(0,nbBlocks,reduceBlocks,&data);
+
+  for(unsigned int b=0;b<nbBlocks;b++)
+  {
+    const double *partialSum=&reductionBuffer[b*nbValues];
+    for(unsigned int k=0;k<nbValues;k++)
+      sum[k]+=partialSum[k];
+  }
+}
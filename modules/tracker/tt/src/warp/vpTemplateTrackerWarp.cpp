@@ -93,16 +93,97 @@ double vpTemplateTrackerWarp::getDistanceBetweenZoneAndWarpedZone(const vpTempla
 void vpTemplateTrackerWarp::warp(const double *ut0,const double *vt0,int nb_pt,const vpColVector& p,double *u,double *v)
 {
   computeCoeff(p);
+  if(nb_pt>0)
+    warpPoints(ut0,vt0,(unsigned int)nb_pt,p,u,v);
+}
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+// Warp kernels specialized at compile time. warp() returns false when the
+// point is warped behind the image plane (w <= 0). The projective kernels
+// reproduce the rounding of warpX(): vpTemplateTrackerWarpHomographySL3
+// divides by w while vpTemplateTrackerWarpHomography multiplies by 1/w.
+struct vpWarpTranslationKernel {
+  static inline bool warp(const double *M, double u, double v, double &u2, double &v2)
+  {
+    u2=u+M[2];
+    v2=v+M[5];
+    return true;
+  }
+};
+
+struct vpWarpAffineKernel {
+  static inline bool warp(const double *M, double u, double v, double &u2, double &v2)
+  {
+    u2=M[0]*u+M[1]*v+M[2];
+    v2=M[3]*u+M[4]*v+M[5];
+    return true;
+  }
+};
+
+struct vpWarpProjectiveKernel {
+  static inline bool warp(const double *M, double u, double v, double &u2, double &v2)
+  {
+    double w=M[6]*u+M[7]*v+M[8];
+    u2=(M[0]*u+M[1]*v+M[2])/w;
+    v2=(M[3]*u+M[4]*v+M[5])/w;
+    return w>0;
+  }
+};
+
+struct vpWarpProjectiveInverseKernel {
+  static inline bool warp(const double *M, double u, double v, double &u2, double &v2)
+  {
+    const double denom=1./(M[6]*u+M[7]*v+M[8]);
+    u2=(M[0]*u+M[1]*v+M[2])*denom;
+    v2=(M[3]*u+M[4]*v+M[5])*denom;
+    return denom>0;
+  }
+};
+
+template<class Kernel>
+bool warpPointsKernel(const double *M, const double *u, const double *v, unsigned int nb_pt, double *u2, double *v2)
+{
+  bool valid=true;
+  for(unsigned int i=0;i<nb_pt;i++)
+  {
+    if(!Kernel::warp(M,u[i],v[i],u2[i],v2[i]))
+      valid=false;
+  }
+  return valid;
+}
+}
+#endif // #ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+void vpTemplateTrackerWarp::warpPoints(const double *u, const double *v, unsigned int nb_pt, const vpColVector &ParamM,
+                                       double *u2, double *v2)
+{
+  double M[9];
+  if(getWarpMatrix(ParamM,M))
+  {
+    if(M[6]==0. && M[7]==0. && M[8]==1.)
+    {
+      if(M[0]==1. && M[1]==0. && M[3]==0. && M[4]==1.)
+        warpPointsKernel<vpWarpTranslationKernel>(M,u,v,nb_pt,u2,v2);
+      else
+        warpPointsKernel<vpWarpAffineKernel>(M,u,v,nb_pt,u2,v2);
+      return;
+    }
+    if(inverseDenom ? warpPointsKernel<vpWarpProjectiveInverseKernel>(M,u,v,nb_pt,u2,v2)
+                    : warpPointsKernel<vpWarpProjectiveKernel>(M,u,v,nb_pt,u2,v2))
+      return;
+    // Some points are warped behind the image plane, let warpX() handle them
+  }
+
   vpColVector X1(2),X2(2);
-  for(int i=0;i<nb_pt;i++)
+  for(unsigned int i=0;i<nb_pt;i++)
   {
-    X1[0]=ut0[i];
-    X1[1]=vt0[i];
-    computeDenom(X1,p);
-    warpX(X1,X2,p);
-    u[i]=X2[0];
-    v[i]=X2[1];
-    //std::cout<<"warp "<<X2[0]<<","<<X2[1]<<std::endl;
+    X1[0]=u[i];
+    X1[1]=v[i];
+    computeDenom(X1,ParamM);
+    warpX(X1,X2,ParamM);
+    u2[i]=X2[0];
+    v2[i]=X2[1];
   }
 }
 
@@ -144,6 +144,14 @@ void vpTemplateTrackerWarpAffine::getParamInverse(const vpColVector &ParamM,vpCo
   ParamMinv[4]=TransInv[0];ParamMinv[5]=TransInv[1];
 } 
 
+bool vpTemplateTrackerWarpAffine::getWarpMatrix(const vpColVector &ParamM, double *M) const
+{
+  M[0]=1.0+ParamM[0]; M[1]=ParamM[2];     M[2]=ParamM[4];
+  M[3]=ParamM[1];     M[4]=1.0+ParamM[3]; M[5]=ParamM[5];
+  M[6]=0.;            M[7]=0.;            M[8]=1.;
+  return true;
+}
+
 void vpTemplateTrackerWarpAffine::pRondp(const vpColVector &p1, const vpColVector &p2,vpColVector &pres) const
 {
   vpColVector Trans1(2);
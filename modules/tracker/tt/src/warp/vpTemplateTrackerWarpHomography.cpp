@@ -43,6 +43,7 @@ vpTemplateTrackerWarpHomography::vpTemplateTrackerWarpHomography()
 {
   nbParam = 8 ;
   dW.resize(2,nbParam);
+  inverseDenom = true; // warpX() multiplies by denom = 1/w
 }
 
 //get the parameter corresponding to the lower level of a gaussian pyramid
@@ -175,6 +176,14 @@ void vpTemplateTrackerWarpHomography::getParamInverse(const vpColVector &ParamM,
   getParam(Hinv, ParamMinv);
 } 
 
+bool vpTemplateTrackerWarpHomography::getWarpMatrix(const vpColVector &ParamM, double *M) const
+{
+  M[0]=1+ParamM[0]; M[1]=ParamM[3];   M[2]=ParamM[6];
+  M[3]=ParamM[1];   M[4]=1+ParamM[4]; M[5]=ParamM[7];
+  M[6]=ParamM[2];   M[7]=ParamM[5];   M[8]=1.;
+  return true;
+}
+
 
 vpHomography vpTemplateTrackerWarpHomography::getHomography(const vpColVector &ParamM) const
 {
@@ -391,6 +391,14 @@ void vpTemplateTrackerWarpHomographySL3::getParamInverse(const vpColVector &Para
 { 
   ParamMinv=-ParamM;
 } 
+
+bool vpTemplateTrackerWarpHomographySL3::getWarpMatrix(const vpColVector &/*ParamM*/, double *M) const
+{
+  for(unsigned int i=0;i<3;i++)
+    for(unsigned int j=0;j<3;j++)
+      M[3*i+j]=G[i][j];
+  return true;
+}
 void vpTemplateTrackerWarpHomographySL3::pRondp(const vpColVector &p1, const vpColVector &p2,vpColVector &pres) const
 {
   //vrai que si commutatif ...
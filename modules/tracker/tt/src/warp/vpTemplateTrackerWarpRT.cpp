@@ -146,6 +146,16 @@ void vpTemplateTrackerWarpRT::getParamInverse(const vpColVector &ParamM,vpColVec
   ParamMinv[2]=TransInv[1];
 } 
 
+bool vpTemplateTrackerWarpRT::getWarpMatrix(const vpColVector &ParamM, double *M) const
+{
+  double c=cos(ParamM[0]);
+  double s=sin(ParamM[0]);
+  M[0]=c;  M[1]=-s; M[2]=ParamM[1];
+  M[3]=s;  M[4]=c;  M[5]=ParamM[2];
+  M[6]=0.; M[7]=0.; M[8]=1.;
+  return true;
+}
+
 void vpTemplateTrackerWarpRT::pRondp(const vpColVector &p1, const vpColVector &p2,vpColVector &pres) const
 {
   vpColVector Trans1(2);
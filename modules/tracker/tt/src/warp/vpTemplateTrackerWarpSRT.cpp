@@ -152,6 +152,16 @@ void vpTemplateTrackerWarpSRT::getParamInverse(const vpColVector &ParamM,vpColVe
   ParamMinv[3]=TransInv[1];
 } 
 
+bool vpTemplateTrackerWarpSRT::getWarpMatrix(const vpColVector &ParamM, double *M) const
+{
+  double c=(1.0+ParamM[0])*cos(ParamM[1]);
+  double s=(1.0+ParamM[0])*sin(ParamM[1]);
+  M[0]=c;  M[1]=-s; M[2]=ParamM[2];
+  M[3]=s;  M[4]=c;  M[5]=ParamM[3];
+  M[6]=0.; M[7]=0.; M[8]=1.;
+  return true;
+}
+
 void vpTemplateTrackerWarpSRT::pRondp(const vpColVector &p1, const vpColVector &p2,vpColVector &pres) const
 {
   vpColVector Trans1(2);
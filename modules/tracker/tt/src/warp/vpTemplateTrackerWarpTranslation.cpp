@@ -119,6 +119,14 @@ void vpTemplateTrackerWarpTranslation::getParamInverse(const vpColVector &ParamM
   ParamMinv[1]=-ParamM[1];
 } 
 
+bool vpTemplateTrackerWarpTranslation::getWarpMatrix(const vpColVector &ParamM, double *M) const
+{
+  M[0]=1.; M[1]=0.; M[2]=ParamM[0];
+  M[3]=0.; M[4]=1.; M[5]=ParamM[1];
+  M[6]=0.; M[7]=0.; M[8]=1.;
+  return true;
+}
+
 void vpTemplateTrackerWarpTranslation::pRondp(const vpColVector &p1, const vpColVector &p2,vpColVector &pres) const
 {
   pres[0]=p1[0]+p2[0];
@@ -39,6 +39,135 @@
 #include <visp3/tt/vpTemplateTrackerZNCCForwardAdditional.h>
 #include <visp3/core/vpImageFilter.h>
 
+#include <algorithm>
+#include <vector>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+struct vpZNCCForwardAdditionalData
+{
+  const vpImage<unsigned char> *I;
+  const vpImage<double> *BI;
+  const vpImage<double> *dIx;
+  const vpImage<double> *dIy;
+  const vpImage<double> *dIxx;
+  const vpImage<double> *dIxy;
+  const vpImage<double> *dIyy;
+  bool blur;
+  const double *x;
+  const double *y;
+  const double *val;
+  const double *dW;
+  unsigned int nbParam;
+  double moyTij;
+  double moyIW;
+};
+
+// sum = [Nbpoint, moyTij, moyIW]
+void sumZNCCFAMean(unsigned int begin, unsigned int end, void *arg, double *sum)
+{
+  const vpZNCCForwardAdditionalData *data = static_cast<const vpZNCCForwardAdditionalData *>(arg);
+  const unsigned int height=data->I->getHeight();
+  const unsigned int width=data->I->getWidth();
+  for(unsigned int point=begin;point<end;point++)
+  {
+    double j2=data->x[point];
+    double i2=data->y[point];
+    if((i2>=0)&&(j2>=0)&&(i2<height-1)&&(j2<width-1))
+    {
+      double Tij=data->val[point];
+      double IW;
+      if(!data->blur)
+        IW=data->I->getValue(i2,j2);
+      else
+        IW=data->BI->getValue(i2,j2);
+
+      sum[0]++;
+      sum[1]+=Tij;
+      sum[2]+=IW;
+    }
+  }
+}
+
+// sum = [denom, Hdesire]
+void sumZNCCFAHessian(unsigned int begin, unsigned int end, void *arg, double *sum)
+{
+  const vpZNCCForwardAdditionalData *data = static_cast<const vpZNCCForwardAdditionalData *>(arg);
+  const unsigned int nbParam=data->nbParam;
+  const unsigned int height=data->I->getHeight();
+  const unsigned int width=data->I->getWidth();
+  double *Hdesire=sum+1;
+  for(unsigned int point=begin;point<end;point++)
+  {
+    double j2=data->x[point];
+    double i2=data->y[point];
+    if((i2>=0)&&(j2>=0)&&(i2<height-1)&&(j2<width-1))
+    {
+      double Tij=data->val[point];
+      double IW;
+      if(!data->blur)
+        IW=data->I->getValue(i2,j2);
+      else
+        IW=data->BI->getValue(i2,j2);
+
+      const double *dW0=data->dW+point*2*nbParam;
+      const double *dW1=dW0+nbParam;
+      double prod=(Tij-data->moyTij);
+
+      double d_Ixx=data->dIxx->getValue(i2,j2);
+      double d_Iyy=data->dIyy->getValue(i2,j2);
+      double d_Ixy=data->dIxy->getValue(i2,j2);
+
+      for(unsigned int it=0;it<nbParam;it++)
+        for(unsigned int jt=0;jt<nbParam;jt++)
+          Hdesire[it*nbParam+jt] +=prod*(dW0[it]*(dW0[jt]*d_Ixx+dW1[jt]*d_Ixy)
+              +dW1[it]*(dW0[jt]*d_Ixy+dW1[jt]*d_Iyy));
+
+      sum[0]+=(Tij-data->moyTij)*(Tij-data->moyTij)*(IW-data->moyIW)*(IW-data->moyIW);
+    }
+  }
+}
+
+// sum = [erreur, denom, G]
+void sumZNCCFAGradient(unsigned int begin, unsigned int end, void *arg, double *sum)
+{
+  const vpZNCCForwardAdditionalData *data = static_cast<const vpZNCCForwardAdditionalData *>(arg);
+  const unsigned int nbParam=data->nbParam;
+  const unsigned int height=data->I->getHeight();
+  const unsigned int width=data->I->getWidth();
+  double *G=sum+2;
+  for(unsigned int point=begin;point<end;point++)
+  {
+    double j2=data->x[point];
+    double i2=data->y[point];
+    if((i2>=0)&&(j2>=0)&&(i2<height-1)&&(j2<width-1))
+    {
+      double Tij=data->val[point];
+      double IW;
+      if(!data->blur)
+        IW=data->I->getValue(i2,j2);
+      else
+        IW=data->BI->getValue(i2,j2);
+
+      double dIWx=data->dIx->getValue(i2,j2);
+      double dIWy=data->dIy->getValue(i2,j2);
+      const double *dW0=data->dW+point*2*nbParam;
+      const double *dW1=dW0+nbParam;
+
+      double prod=(Tij-data->moyTij);
+      for(unsigned int it=0;it<nbParam;it++)
+        G[it]+=prod*(dW0[it]*dIWx+dW1[it]*dIWy);
+
+      double er=(Tij-IW);
+      sum[0]+=(er*er);
+      sum[1]+=(Tij-data->moyTij)*(Tij-data->moyTij)*(IW-data->moyIW)*(IW-data->moyIW);
+    }
+  }
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 vpTemplateTrackerZNCCForwardAdditional::vpTemplateTrackerZNCCForwardAdditional(vpTemplateTrackerWarp *warp):vpTemplateTrackerZNCC(warp)
 {
   useCompositionnal=false;
@@ -59,15 +188,10 @@ void vpTemplateTrackerZNCCForwardAdditional::initHessienDesired(const vpImage<un
   vpImageFilter::getGradY(dIy, dIyy, fgdG,taillef);
 
   Warp->computeCoeff(p);
-  double IW,dIWx,dIWy;
-  double Tij;
   int i,j;
   double i2,j2;
-  int Nbpoint=0;
 
-  double moyTij=0;
-  double moyIW=0;
-  double denom=0;
+  allocWarpedPoints(2*nbParam);
   for(unsigned int point=0;point<templateSize;point++)
   {
     i=ptTemplate[point].y;
@@ -78,74 +202,46 @@ void vpTemplateTrackerZNCCForwardAdditional::initHessienDesired(const vpImage<un
     Warp->computeDenom(X1,p);
 
     j2=X2[0];i2=X2[1];
+    xWarped[point]=j2;yWarped[point]=i2;
 
     if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
     {
-      Tij=ptTemplate[point].val;
-
-      if(!blur)
-        IW=I.getValue(i2,j2);
-      else
-        IW=BI.getValue(i2,j2);
-
-      Nbpoint++;
-      moyTij+=Tij;
-      moyIW+=IW;
+      Warp->dWarp(X1,X2,p,dW);
+      std::copy(dW.data,dW.data+2*nbParam,&dWWarped[point*2*nbParam]);
     }
   }
+
+  vpZNCCForwardAdditionalData data;
+  data.I=&I;
+  data.BI=&BI;
+  data.dIx=&dIx;
+  data.dIy=&dIy;
+  data.dIxx=&dIxx;
+  data.dIxy=&dIxy;
+  data.dIyy=&dIyy;
+  data.blur=blur;
+  data.x=&xWarped[0];
+  data.y=&yWarped[0];
+  data.val=&ptTemplatePacked->val[0];
+  data.dW=&dWWarped[0];
+  data.nbParam=nbParam;
+
+  std::vector<double> sumMean(3);
+  reducePoints(sumZNCCFAMean,&data,sumMean);
+  int Nbpoint=(int)sumMean[0];
+  double moyTij=sumMean[1];
+  double moyIW=sumMean[2];
   moyTij=moyTij/Nbpoint;
   moyIW=moyIW/Nbpoint;
-  Hdesire=0;
-  for(unsigned int point=0;point<templateSize;point++)
-  {
-    i=ptTemplate[point].y;
-    j=ptTemplate[point].x;
-    X1[0]=j;X1[1]=i;
-    X2[0]=j;X2[1]=i;
-
-    Warp->computeDenom(X1,p);
-
-    j2=X2[0];i2=X2[1];
-
-    if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
-    {
-      Tij=ptTemplate[point].val;
-
-      if(!blur)
-        IW=I.getValue(i2,j2);
-      else
-        IW=BI.getValue(i2,j2);
-
-      dIWx=dIx.getValue(i2,j2);
-      dIWy=dIy.getValue(i2,j2);
-      //Calcul du Hessien
-      Warp->dWarp(X1,X2,p,dW);
-      double *tempt=new double[nbParam];
-      for(unsigned int it=0;it<nbParam;it++)
-        tempt[it]=dW[0][it]*dIWx+dW[1][it]*dIWy;
-
-
-      double prod=(Tij-moyTij);
-
-      double d_Ixx=dIxx.getValue(i2,j2);
-      double d_Iyy=dIyy.getValue(i2,j2);
-      double d_Ixy=dIxy.getValue(i2,j2);
-
-      for(unsigned int it=0;it<nbParam;it++)
-        for(unsigned int jt=0;jt<nbParam;jt++)
-          Hdesire[it][jt] +=prod*(dW[0][it]*(dW[0][jt]*d_Ixx+dW[1][jt]*d_Ixy)
-              +dW[1][it]*(dW[0][jt]*d_Ixy+dW[1][jt]*d_Iyy));
-      /*Hdesire[0][0]+=prod*d_Ixx;
-      Hdesire[1][0]+=prod*d_Ixy;
-      Hdesire[0][1]+=prod*d_Ixy;
-      Hdesire[1][1]+=prod*d_Iyy;*/
-
-      denom+=(Tij-moyTij)*(Tij-moyTij)*(IW-moyIW)*(IW-moyIW);
-      delete[] tempt;
-    }
 
-
-  }
+  data.moyTij=moyTij;
+  data.moyIW=moyIW;
+  std::vector<double> sum(1+nbParam*nbParam);
+  reducePoints(sumZNCCFAHessian,&data,sum);
+  double denom=sum[0];
+  for(unsigned int it=0;it<nbParam;it++)
+    for(unsigned int jt=0;jt<nbParam;jt++)
+      Hdesire[it][jt]=sum[1+it*nbParam+jt];
 
   Hdesire=Hdesire/sqrt(denom);
   vpMatrix::computeHLM(Hdesire,lambdaDep,HLMdesire);
@@ -171,22 +267,32 @@ void vpTemplateTrackerZNCCForwardAdditional::trackNoPyr(const vpImage<unsigned c
   dW=0;
 
   //double lambda=lambdaDep;
-  double IW,dIWx,dIWy;
-  double Tij;
   unsigned int iteration=0;
   int i,j;
   double i2,j2;
   double alpha=2.;
+  allocWarpedPoints(2*nbParam);
+
+  vpZNCCForwardAdditionalData data;
+  data.I=&I;
+  data.BI=&BI;
+  data.dIx=&dIx;
+  data.dIy=&dIy;
+  data.dIxx=NULL;
+  data.dIxy=NULL;
+  data.dIyy=NULL;
+  data.blur=blur;
+  data.x=&xWarped[0];
+  data.y=&yWarped[0];
+  data.val=&ptTemplatePacked->val[0];
+  data.dW=&dWWarped[0];
+  data.nbParam=nbParam;
+  std::vector<double> sumMean(3);
+  std::vector<double> sum(2+nbParam);
   do
   {
-    int Nbpoint=0;
-    double erreur=0;
-    G=0;
     H=0 ;
     Warp->computeCoeff(p);
-    double moyTij=0;
-    double moyIW=0;
-    double denom=0;
     for(unsigned int point=0;point<templateSize;point++)
     {
       i=ptTemplate[point].y;
@@ -197,21 +303,20 @@ void vpTemplateTrackerZNCCForwardAdditional::trackNoPyr(const vpImage<unsigned c
       Warp->warpX(X1,X2,p);
 
       j2=X2[0];i2=X2[1];
+      xWarped[point]=j2;yWarped[point]=i2;
       if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
       {
-        Tij=ptTemplate[point].val;
-
-        if(!blur)
-          IW=I.getValue(i2,j2);
-        else
-          IW=BI.getValue(i2,j2);
-
-        Nbpoint++;
-        moyTij+=Tij;
-        moyIW+=IW;
+        //Calcul du Hessien
+        Warp->dWarp(X1,X2,p,dW);
+        std::copy(dW.data,dW.data+2*nbParam,&dWWarped[point*2*nbParam]);
       }
     }
 
+    reducePoints(sumZNCCFAMean,&data,sumMean);
+    int Nbpoint=(int)sumMean[0];
+    double moyTij=sumMean[1];
+    double moyIW=sumMean[2];
+
     if(! Nbpoint) {
       throw(vpException(vpException::divideByZeroError,
             "Cannot track the template: no point")) ;
@@ -219,65 +324,14 @@ void vpTemplateTrackerZNCCForwardAdditional::trackNoPyr(const vpImage<unsigned c
 
     moyTij=moyTij/Nbpoint;
     moyIW=moyIW/Nbpoint;
-    //vpMatrix d2Wx(nbParam,nbParam);
-    //vpMatrix d2Wy(nbParam,nbParam);
-    for(unsigned int point=0;point<templateSize;point++)
-    {
-      i=ptTemplate[point].y;
-      j=ptTemplate[point].x;
-      X1[0]=j;X1[1]=i;
-
-      Warp->computeDenom(X1,p);
-      Warp->warpX(X1,X2,p);
 
-      j2=X2[0];i2=X2[1];
-      if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
-      {
-        Tij=ptTemplate[point].val;
-
-        if(!blur)
-          IW=I.getValue(i2,j2);
-        else
-          IW=BI.getValue(i2,j2);
-
-        dIWx=dIx.getValue(i2,j2);
-        dIWy=dIy.getValue(i2,j2);
-        //Calcul du Hessien
-        Warp->dWarp(X1,X2,p,dW);
-        double *tempt=new double[nbParam];
-        for(unsigned int it=0;it<nbParam;it++)
-          tempt[it]=dW[0][it]*dIWx+dW[1][it]*dIWy;
-
-
-        double prod=(Tij-moyTij);
-        for(unsigned int it=0;it<nbParam;it++)
-          G[it]+=prod*tempt[it];
-
-        /*	Warp->d2Warp(X1,X2,p,d2Wx,d2Wy);
-        for(int it=0;it<nbParam;it++)
-          for(int jt=0;jt<nbParam;jt++)
-            H[it][jt]+=prod*(d2Wx[it][jt]*dIWx+d2Wx[it][jt]*dIWy);*/
-        /*double d_Ixx=dIxx.getValue(i2,j2);
-        double d_Iyy=dIyy.getValue(i2,j2);
-        double d_Ixy=dIxy.getValue(i2,j2);
-
-        for(int it=0;it<nbParam;it++)
-          for(int jt=0;jt<nbParam;jt++)
-            H[it][jt] +=prod*(dW[0][it]*(dW[0][jt]*d_Ixx+dW[1][jt]*d_Ixy)
-                +dW[1][it]*(dW[0][jt]*d_Ixy+dW[1][jt]*d_Iyy));*/
-        /*H[0][0]+=prod*d_Ixx;
-        H[1][0]+=prod*d_Ixy;
-        H[0][1]+=prod*d_Ixy;
-        H[1][1]+=prod*d_Iyy;*/
-
-        double er=(Tij-IW);
-        erreur+=(er*er);
-        denom+=(Tij-moyTij)*(Tij-moyTij)*(IW-moyIW)*(IW-moyIW);
-        delete[] tempt;
-      }
-
-
-    }
+    data.moyTij=moyTij;
+    data.moyIW=moyIW;
+    reducePoints(sumZNCCFAGradient,&data,sum);
+    double erreur=sum[0];
+    double denom=sum[1];
+    for(unsigned int it=0;it<nbParam;it++)
+      G[it]=sum[2+it];
     /*std::cout<<"G="<<G<<std::endl;
     std::cout<<"H="<<H<<std::endl;
     std::cout<<" denom="<<denom<<std::endl;*/
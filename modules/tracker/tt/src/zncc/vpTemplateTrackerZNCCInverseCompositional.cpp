@@ -41,6 +41,200 @@
 #include <visp3/tt/vpTemplateTrackerZNCCInverseCompositional.h>
 #include <visp3/core/vpImageFilter.h>
 
+#include <algorithm>
+#include <vector>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+struct vpZNCCInverseCompositionalData
+{
+  const vpImage<unsigned char> *I;
+  const vpImage<double> *BI;
+  const vpImage<double> *dIxx;
+  const vpImage<double> *dIxy;
+  const vpImage<double> *dIyy;
+  bool blur;
+  const double *x;
+  const double *y;
+  const double *val;
+  const double *dIrefdp;   // nbParam values per point
+  const double *dW;        // 2*nbParam values per point
+  unsigned int nbParam;
+  double moyIref;
+  double moyIc;
+  const double *moydIrefdp;
+  const double *moyd2Iref;
+};
+
+// sum = [Nbpoint, moyIref, moyIc]
+void sumZNCCICMean(unsigned int begin, unsigned int end, void *arg, double *sum)
+{
+  const vpZNCCInverseCompositionalData *data = static_cast<const vpZNCCInverseCompositionalData *>(arg);
+  const unsigned int height=data->I->getHeight();
+  const unsigned int width=data->I->getWidth();
+  for(unsigned int point=begin;point<end;point++)
+  {
+    double j2=data->x[point];
+    double i2=data->y[point];
+    if((i2>=0)&&(j2>=0)&&(i2<height-1)&&(j2<width-1))
+    {
+      double Iref=data->val[point];
+      double Ic;
+      if(!data->blur)
+        Ic=data->I->getValue(i2,j2);
+      else
+        Ic=data->BI->getValue(i2,j2);
+
+      sum[0]++;
+      sum[1]+=Iref;
+      sum[2]+=Ic;
+    }
+  }
+}
+
+// sum = [Nbpoint, moyIref, moyIc, moydIrefdp, moyd2Iref]
+void sumZNCCICHessianMean(unsigned int begin, unsigned int end, void *arg, double *sum)
+{
+  const vpZNCCInverseCompositionalData *data = static_cast<const vpZNCCInverseCompositionalData *>(arg);
+  const unsigned int nbParam=data->nbParam;
+  const unsigned int height=data->I->getHeight();
+  const unsigned int width=data->I->getWidth();
+  double *moydIrefdp=sum+3;
+  double *moyd2Iref=moydIrefdp+nbParam;
+  for(unsigned int point=begin;point<end;point++)
+  {
+    double j2=data->x[point];
+    double i2=data->y[point];
+    if((i2>=0)&&(j2>=0)&&(i2<height-1)&&(j2<width-1))
+    {
+      double Iref=data->val[point];
+      double Ic;
+      if(!data->blur)
+        Ic=data->I->getValue(i2,j2);
+      else
+        Ic=data->BI->getValue(i2,j2);
+
+      sum[0]++;
+      sum[1]+=Iref;
+      sum[2]+=Ic;
+
+      const double *dWpt=data->dIrefdp+point*nbParam;
+      for(unsigned int it=0;it<nbParam;it++)
+        moydIrefdp[it]+=dWpt[it];
+
+      const double *dW0=data->dW+point*2*nbParam;
+      const double *dW1=dW0+nbParam;
+      double d_Ixx=data->dIxx->getValue(i2,j2);
+      double d_Iyy=data->dIyy->getValue(i2,j2);
+      double d_Ixy=data->dIxy->getValue(i2,j2);
+
+      for(unsigned int it=0;it<nbParam;it++)
+        for(unsigned int jt=0;jt<nbParam;jt++)
+        {
+          moyd2Iref[it*nbParam+jt] +=(dW0[it]*(dW0[jt]*d_Ixx+dW1[jt]*d_Ixy)
+              +dW1[it]*(dW0[jt]*d_Ixy+dW1[jt]*d_Iyy));
+        }
+    }
+  }
+}
+
+// sum = [covarIref, covarIc, sIcIref, sIcdIref, sIcd2Iref, sdIrefdIref]
+void sumZNCCICHessian(unsigned int begin, unsigned int end, void *arg, double *sum)
+{
+  const vpZNCCInverseCompositionalData *data = static_cast<const vpZNCCInverseCompositionalData *>(arg);
+  const unsigned int nbParam=data->nbParam;
+  const unsigned int height=data->I->getHeight();
+  const unsigned int width=data->I->getWidth();
+  const double moyIref=data->moyIref;
+  const double moyIc=data->moyIc;
+  const double *moydIrefdp=data->moydIrefdp;
+  const double *moyd2Iref=data->moyd2Iref;
+  double *sIcdIref=sum+3;
+  double *sIcd2Iref=sIcdIref+nbParam;
+  double *sdIrefdIref=sIcd2Iref+nbParam*nbParam;
+  for(unsigned int point=begin;point<end;point++)
+  {
+    double j2=data->x[point];
+    double i2=data->y[point];
+    if((i2>=0)&&(j2>=0)&&(i2<height-1)&&(j2<width-1))
+    {
+      double Iref=data->val[point];
+      double Ic;
+      if(!data->blur)
+        Ic=data->I->getValue(i2,j2);
+      else
+        Ic=data->BI->getValue(i2,j2);
+
+      double prodIc=(Ic-moyIc);
+      const double *dWpt=data->dIrefdp+point*nbParam;
+      const double *dW0=data->dW+point*2*nbParam;
+      const double *dW1=dW0+nbParam;
+
+      double d_Ixx=data->dIxx->getValue(i2,j2);
+      double d_Iyy=data->dIyy->getValue(i2,j2);
+      double d_Ixy=data->dIxy->getValue(i2,j2);
+
+      for(unsigned int it=0;it<nbParam;it++)
+        for(unsigned int jt=0;jt<nbParam;jt++)
+        {
+          sIcd2Iref[it*nbParam+jt] +=prodIc*(dW0[it]*(dW0[jt]*d_Ixx+dW1[jt]*d_Ixy)
+              +dW1[it]*(dW0[jt]*d_Ixy+dW1[jt]*d_Iyy)-moyd2Iref[it*nbParam+jt]);
+          sdIrefdIref[it*nbParam+jt] +=(dWpt[it]-moydIrefdp[it])*(dWpt[jt]-moydIrefdp[jt]);
+        }
+
+      for(unsigned int it=0;it<nbParam;it++)
+        sIcdIref[it]+=prodIc*(dWpt[it]-moydIrefdp[it]);
+
+      sum[0]+=(Iref-moyIref)*(Iref-moyIref);
+      sum[1]+=(Ic-moyIc)*(Ic-moyIc);
+      sum[2]+=(Iref-moyIref)*(Ic-moyIc);
+    }
+  }
+}
+
+// sum = [covarIref, covarIc, sIcIref, sIcdIref, sIrefdIref]
+void sumZNCCICGradient(unsigned int begin, unsigned int end, void *arg, double *sum)
+{
+  const vpZNCCInverseCompositionalData *data = static_cast<const vpZNCCInverseCompositionalData *>(arg);
+  const unsigned int nbParam=data->nbParam;
+  const unsigned int height=data->I->getHeight();
+  const unsigned int width=data->I->getWidth();
+  const double moyIref=data->moyIref;
+  const double moyIc=data->moyIc;
+  const double *moydIrefdp=data->moydIrefdp;
+  double *sIcdIref=sum+3;
+  double *sIrefdIref=sIcdIref+nbParam;
+  for(unsigned int point=begin;point<end;point++)
+  {
+    double j2=data->x[point];
+    double i2=data->y[point];
+    if((i2>=0)&&(j2>=0)&&(i2<height-1)&&(j2<width-1))
+    {
+      double Iref=data->val[point];
+      const double *dWpt=data->dIrefdp+point*nbParam;
+
+      double Ic;
+      if(!data->blur)
+        Ic=data->I->getValue(i2,j2);
+      else
+        Ic=data->BI->getValue(i2,j2);
+
+      double prod=(Ic-moyIc);
+      for(unsigned int it=0;it<nbParam;it++)
+        sIcdIref[it]+=prod*(dWpt[it]-moydIrefdp[it]);
+      for(unsigned int it=0;it<nbParam;it++)
+        sIrefdIref[it]+=(Iref-moyIref)*(dWpt[it]-moydIrefdp[it]);
+
+      sum[0]+=(Iref-moyIref)*(Iref-moyIref);
+      sum[1]+=(Ic-moyIc)*(Ic-moyIc);
+      sum[2]+=(Iref-moyIref)*(Ic-moyIc);
+    }
+  }
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 vpTemplateTrackerZNCCInverseCompositional::vpTemplateTrackerZNCCInverseCompositional(vpTemplateTrackerWarp *warp)
   : vpTemplateTrackerZNCC(warp), compoInitialised(false),
     evolRMS(0), x_pos(), y_pos(), threshold_RMS(1e-8), moydIrefdp()
@@ -54,6 +248,7 @@ void vpTemplateTrackerZNCCInverseCompositional::initCompInverse(const vpImage<un
   vpImageFilter::getGradXGauss2D(I, dIx, fgG,fgdG,taillef);
   vpImageFilter::getGradYGauss2D(I, dIy, fgG,fgdG,taillef);
 
+  ptTemplatePacked->dW.resize(templateSize*nbParam);
   for(unsigned int point=0;point<templateSize;point++)
   {
     int i=ptTemplate[point].y;
@@ -61,13 +256,12 @@ void vpTemplateTrackerZNCCInverseCompositional::initCompInverse(const vpImage<un
 
     X1[0]=j;X1[1]=i;
     Warp->computeDenom(X1,p);
-    ptTemplate[point].dW=new double[nbParam];
 
     double dx=ptTemplate[point].dx;
     double dy=ptTemplate[point].dy;
     //std::cout<<ptTemplate[point].dx<<","<<ptTemplate[point].dy<<std::endl;
 
-    Warp->getdW0(i,j,dy,dx,ptTemplate[point].dW);
+    Warp->getdW0(i,j,dy,dx,&ptTemplatePacked->dW[point*nbParam]);
 
   }
   //vpTRACE("fin Comp Inverse");
@@ -91,18 +285,10 @@ void vpTemplateTrackerZNCCInverseCompositional::initHessienDesired(const vpImage
   vpImageFilter::getGradY(dIy, dIyy, fgdG,taillef);
 
   Warp->computeCoeff(p);
-  double Ic,dIcx=0.,dIcy=0.;
-  double Iref;
   int i,j;
   double i2,j2;
-  int Nbpoint=0;
-
-  double moyIref=0;
-  double moyIc=0;
-  double denom=0;
-  moydIrefdp.resize(nbParam);	moydIrefdp=0;
-  vpMatrix moyd2Iref(nbParam,nbParam);moyd2Iref=0;
 
+  allocWarpedPoints(2*nbParam);
   for(unsigned int point=0;point<templateSize;point++)
   {
     i=ptTemplate[point].y;
@@ -113,110 +299,71 @@ void vpTemplateTrackerZNCCInverseCompositional::initHessienDesired(const vpImage
     Warp->computeDenom(X1,p);
 
     j2=X2[0];i2=X2[1];
+    xWarped[point]=j2;yWarped[point]=i2;
 
     if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
     {
-      Iref=ptTemplate[point].val;
-
-      if(!blur)
-        Ic=I.getValue(i2,j2);
-      else
-        Ic=BI.getValue(i2,j2);
-
-      Nbpoint++;
-      moyIref+=Iref;
-      moyIc+=Ic;
-
-      for(unsigned int it=0;it<nbParam;it++)
-        moydIrefdp[it]+=ptTemplate[point].dW[it];
-
-
       Warp->dWarp(X1,X2,p,dW);
-      double *tempt=new double[nbParam];
-      for(unsigned int it=0;it<nbParam;it++)
-        tempt[it]=dW[0][it]*dIcx+dW[1][it]*dIcy;
-      double d_Ixx=dIxx.getValue(i2,j2);
-      double d_Iyy=dIyy.getValue(i2,j2);
-      double d_Ixy=dIxy.getValue(i2,j2);
-
-      for(unsigned int it=0;it<nbParam;it++)
-        for(unsigned int jt=0;jt<nbParam;jt++)
-        {
-          moyd2Iref[it][jt] +=(dW[0][it]*(dW[0][jt]*d_Ixx+dW[1][jt]*d_Ixy)
-              +dW[1][it]*(dW[0][jt]*d_Ixy+dW[1][jt]*d_Iyy));
-        }
-
-      delete[] tempt;
-
-
+      std::copy(dW.data,dW.data+2*nbParam,&dWWarped[point*2*nbParam]);
     }
   }
 
+  vpZNCCInverseCompositionalData data;
+  data.I=&I;
+  data.BI=&BI;
+  data.dIxx=&dIxx;
+  data.dIxy=&dIxy;
+  data.dIyy=&dIyy;
+  data.blur=blur;
+  data.x=&xWarped[0];
+  data.y=&yWarped[0];
+  data.val=&ptTemplatePacked->val[0];
+  data.dIrefdp=&ptTemplatePacked->dW[0];
+  data.dW=&dWWarped[0];
+  data.nbParam=nbParam;
+
+  std::vector<double> sumMean(3+nbParam+nbParam*nbParam);
+  reducePoints(sumZNCCICHessianMean,&data,sumMean);
+
+  int Nbpoint=(int)sumMean[0];
+  double moyIref=sumMean[1];
+  double moyIc=sumMean[2];
+  double denom=0;
+  moydIrefdp.resize(nbParam);
+  vpMatrix moyd2Iref(nbParam,nbParam);
+  for(unsigned int it=0;it<nbParam;it++)
+  {
+    moydIrefdp[it]=sumMean[3+it];
+    for(unsigned int jt=0;jt<nbParam;jt++)
+      moyd2Iref[it][jt]=sumMean[3+nbParam+it*nbParam+jt];
+  }
+
   moyIref=moyIref/Nbpoint;
   moydIrefdp=moydIrefdp/Nbpoint;
   moyd2Iref=moyd2Iref/Nbpoint;
   moyIc=moyIc/Nbpoint;
   Hdesire=0;
-  double covarIref=0,covarIc=0;
-  double sIcIref=0;
-  vpColVector sIcdIref(nbParam);sIcdIref=0;
-  vpMatrix sIcd2Iref(nbParam,nbParam);sIcd2Iref=0;
-  vpMatrix sdIrefdIref(nbParam,nbParam);sdIrefdIref=0;
-  for(unsigned int point=0;point<templateSize;point++)
-  {
-    i=ptTemplate[point].y;
-    j=ptTemplate[point].x;
-    X1[0]=j;X1[1]=i;
-    X2[0]=j;X2[1]=i;
 
-    Warp->computeDenom(X1,p);
-
-    j2=X2[0];i2=X2[1];
-
-    if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
+  data.moyIref=moyIref;
+  data.moyIc=moyIc;
+  data.moydIrefdp=moydIrefdp.data;
+  data.moyd2Iref=moyd2Iref.data;
+  std::vector<double> sum(3+nbParam+2*nbParam*nbParam);
+  reducePoints(sumZNCCICHessian,&data,sum);
+
+  double covarIref=sum[0],covarIc=sum[1];
+  double sIcIref=sum[2];
+  vpColVector sIcdIref(nbParam);
+  vpMatrix sIcd2Iref(nbParam,nbParam);
+  vpMatrix sdIrefdIref(nbParam,nbParam);
+  for(unsigned int it=0;it<nbParam;it++)
+  {
+    sIcdIref[it]=sum[3+it];
+    for(unsigned int jt=0;jt<nbParam;jt++)
     {
-      Iref=ptTemplate[point].val;
-
-      if(!blur)
-        Ic=I.getValue(i2,j2);
-      else
-        Ic=BI.getValue(i2,j2);
-
-      dIcx=dIx.getValue(i2,j2);
-      dIcy=dIy.getValue(i2,j2);
-
-      Warp->dWarp(X1,X2,p,dW);
-
-      double *tempt=new double[nbParam];
-      for(unsigned int it=0;it<nbParam;it++)
-        tempt[it]=dW[0][it]*dIcx+dW[1][it]*dIcy;
-
-      double prodIc=(Ic-moyIc);
-
-      double d_Ixx=dIxx.getValue(i2,j2);
-      double d_Iyy=dIyy.getValue(i2,j2);
-      double d_Ixy=dIxy.getValue(i2,j2);
-
-      for(unsigned int it=0;it<nbParam;it++)
-        for(unsigned int jt=0;jt<nbParam;jt++)
-        {
-          sIcd2Iref[it][jt] +=prodIc*(dW[0][it]*(dW[0][jt]*d_Ixx+dW[1][jt]*d_Ixy)
-              +dW[1][it]*(dW[0][jt]*d_Ixy+dW[1][jt]*d_Iyy)-moyd2Iref[it][jt]);
-          sdIrefdIref[it][jt] +=(ptTemplate[point].dW[it]-moydIrefdp[it])*(ptTemplate[point].dW[jt]-moydIrefdp[jt]);
-        }
-
-
-      delete[] tempt;
-
-      for(unsigned int it=0;it<nbParam;it++)
-        sIcdIref[it]+=prodIc*(ptTemplate[point].dW[it]-moydIrefdp[it]);
-
-      covarIref+=(Iref-moyIref)*(Iref-moyIref);
-      covarIc+=(Ic-moyIc)*(Ic-moyIc);
-      sIcIref+=(Iref-moyIref)*(Ic-moyIc);
+      sIcd2Iref[it][jt]=sum[3+nbParam+it*nbParam+jt];
+      sdIrefdIref[it][jt]=sum[3+nbParam+nbParam*nbParam+it*nbParam+jt];
     }
-
-
   }
   covarIref=sqrt(covarIref);
   covarIc=sqrt(covarIc);
@@ -247,92 +394,49 @@ void vpTemplateTrackerZNCCInverseCompositional::trackNoPyr(const vpImage<unsigne
 
   //double erreur=0;
   vpColVector dpinv(nbParam);
-  double Ic;
-  double Iref;
   unsigned int iteration=0;
-  int i,j;
-  double i2,j2;
   initPosEvalRMS(p);
+
+  vpZNCCInverseCompositionalData data=vpZNCCInverseCompositionalData();
+  data.I=&I;
+  data.BI=&BI;
+  data.blur=blur;
+  data.val=&ptTemplatePacked->val[0];
+  data.dIrefdp=&ptTemplatePacked->dW[0];
+  data.nbParam=nbParam;
+  data.moydIrefdp=moydIrefdp.data;
+  std::vector<double> sumMean(3);
+  std::vector<double> sum(3+2*nbParam);
   do
   {
-    unsigned int Nbpoint=0;
     //erreur=0;
     G=0;
-    Warp->computeCoeff(p);
-    double moyIref=0;
-    double moyIc=0;
-    for(unsigned int point=0;point<templateSize;point++)
-    {
-      i=ptTemplate[point].y;
-      j=ptTemplate[point].x;
-      X1[0]=j;X1[1]=i;
-
-      Warp->computeDenom(X1,p);
-      Warp->warpX(X1,X2,p);
-
-      j2=X2[0];i2=X2[1];
-      if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
-      {
-        Iref=ptTemplate[point].val;
-
-        if(!blur)
-          Ic=I.getValue(i2,j2);
-        else
-          Ic=BI.getValue(i2,j2);
-
-        Nbpoint++;
-        moyIref+=Iref;
-        moyIc+=Ic;
-      }
-
-
-    }
+    warpTemplate(p);
+    data.x=&xWarped[0];
+    data.y=&yWarped[0];
+    reducePoints(sumZNCCICMean,&data,sumMean);
+    unsigned int Nbpoint=(unsigned int)sumMean[0];
+    double moyIref=sumMean[1];
+    double moyIc=sumMean[2];
     if(Nbpoint > 0)
     {
       moyIref=moyIref/Nbpoint;
       moyIc=moyIc/Nbpoint;
-      double sIcIref=0;
-      double covarIref=0,covarIc=0;
-      vpColVector sIcdIref(nbParam);sIcdIref=0;
-      vpColVector sIrefdIref(nbParam);sIrefdIref=0;
 
+      data.moyIref=moyIref;
+      data.moyIc=moyIc;
+      reducePoints(sumZNCCICGradient,&data,sum);
 
-      for(unsigned int point=0;point<templateSize;point++)
+      double covarIref=sum[0],covarIc=sum[1];
+      double sIcIref=sum[2];
+      vpColVector sIcdIref(nbParam);
+      vpColVector sIrefdIref(nbParam);
+      for(unsigned int it=0;it<nbParam;it++)
       {
-        i=ptTemplate[point].y;
-        j=ptTemplate[point].x;
-        X1[0]=j;X1[1]=i;
-
-        Warp->computeDenom(X1,p);
-        Warp->warpX(X1,X2,p);
-
-        j2=X2[0];i2=X2[1];
-        if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
-        {
-          Iref=ptTemplate[point].val;
-
-          if(!blur)
-            Ic=I.getValue(i2,j2);
-          else
-            Ic=BI.getValue(i2,j2);
-
-
-          double prod=(Ic-moyIc);
-          for(unsigned int it=0;it<nbParam;it++)
-            sIcdIref[it]+=prod*(ptTemplate[point].dW[it]-moydIrefdp[it]);
-          for(unsigned int it=0;it<nbParam;it++)
-            sIrefdIref[it]+=(Iref-moyIref)*(ptTemplate[point].dW[it]-moydIrefdp[it]);
-
-          //double er=(Iref-Ic);
-          //erreur+=(er*er);
-          //denom+=(Iref-moyIref)*(Iref-moyIref)*(Ic-moyIc)*(Ic-moyIc);
-          covarIref+=(Iref-moyIref)*(Iref-moyIref);
-          covarIc+=(Ic-moyIc)*(Ic-moyIc);
-          sIcIref+=(Iref-moyIref)*(Ic-moyIc);
-        }
-
-
+        sIcdIref[it]=sum[3+it];
+        sIrefdIref[it]=sum[3+nbParam+it];
       }
+
       covarIref=sqrt(covarIref);
       covarIc=sqrt(covarIc);
       double denom=covarIref*covarIc;
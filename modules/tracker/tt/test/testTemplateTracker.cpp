@@ -0,0 +1,188 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Track a template in synthetic images with several threads.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testTemplateTracker.cpp
+
+  Track a textured template moving in synthetic images with the SSD and ZNCC
+  template trackers, with the parallel sums computed by 1 and several
+  threads, and check that the estimated warps are identical.
+*/
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpImagePoint.h>
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/tt/vpTemplateTrackerSSDESM.h>
+#include <visp3/tt/vpTemplateTrackerSSDForwardAdditional.h>
+#include <visp3/tt/vpTemplateTrackerSSDForwardCompositional.h>
+#include <visp3/tt/vpTemplateTrackerSSDInverseCompositional.h>
+#include <visp3/tt/vpTemplateTrackerWarpHomography.h>
+#include <visp3/tt/vpTemplateTrackerWarpHomographySL3.h>
+#include <visp3/tt/vpTemplateTrackerZNCCForwardAdditional.h>
+#include <visp3/tt/vpTemplateTrackerZNCCInverseCompositional.h>
+
+namespace
+{
+  // Smooth texture translated by (di, dj)
+  void textureImage(vpImage<unsigned char> &I, double di, double dj)
+  {
+    I.resize(240, 320);
+    for (unsigned int i = 0; i < I.getHeight(); i++) {
+      for (unsigned int j = 0; j < I.getWidth(); j++) {
+        double x = j - dj, y = i - di;
+        double v = 128 + 40 * sin(x / 7. + 0.3) * cos(y / 9.) + 30 * sin((x + 2 * y) / 13.) + 20 * cos((x - y) / 5.5);
+        I[i][j] = (unsigned char)vpMath::round(v);
+      }
+    }
+  }
+
+  struct vpTrackingResult
+  {
+    std::vector<vpColVector> p;
+    std::vector<vpMatrix> H;
+  };
+
+  template<class Tracker, class Warp>
+  void track(const std::vector< vpImage<unsigned char> > &images, const std::vector<vpImagePoint> &corners,
+             bool parallel, vpTrackingResult &result)
+  {
+    Warp warp;
+    Tracker tracker(&warp);
+    tracker.setSampling(2, 2);
+    tracker.setLambda(0.001);
+    tracker.setIterationMax(30);
+    tracker.setPyramidal(2, 0);
+    tracker.setUseParallelReduction(parallel);
+    tracker.initFromPoints(images[0], corners);
+
+    result.p.clear();
+    result.H.clear();
+    for (size_t k = 1; k < images.size(); k++) {
+      tracker.track(images[k]);
+      result.p.push_back(tracker.getp());
+      result.H.push_back(tracker.getH());
+    }
+  }
+
+  bool sameResults(const vpTrackingResult &r1, const vpTrackingResult &r2)
+  {
+    for (size_t k = 0; k < r1.p.size(); k++) {
+      for (unsigned int i = 0; i < r1.p[k].size(); i++) {
+        if (r1.p[k][i] != r2.p[k][i])
+          return false;
+      }
+      for (unsigned int i = 0; i < r1.H[k].size(); i++) {
+        if (r1.H[k].data[i] != r2.H[k].data[i])
+          return false;
+      }
+    }
+    return true;
+  }
+
+  /*
+    Track the template with the parallel sums computed by 1, 2, 3 and 8
+    threads that have to give the same warps, and without the parallel sums
+    that have to give the same warps up to rounding errors.
+  */
+  template<class Tracker, class Warp>
+  bool compareThreads(const std::string &name, const std::vector< vpImage<unsigned char> > &images,
+                      const std::vector<vpImagePoint> &corners)
+  {
+    vpTrackingResult ref;
+    vpThreadPool::setNumThreads(1);
+    track<Tracker, Warp>(images, corners, true, ref);
+
+    const unsigned int nthreads[] = { 2, 3, 8 };
+    for (unsigned int t = 0; t < sizeof(nthreads) / sizeof(nthreads[0]); t++) {
+      vpTrackingResult result;
+      vpThreadPool::setNumThreads(nthreads[t]);
+      track<Tracker, Warp>(images, corners, true, result);
+      if (! sameResults(ref, result)) {
+        std::cerr << name << ": the warps differ with " << nthreads[t] << " threads" << std::endl;
+        return false;
+      }
+    }
+
+    vpTrackingResult sequential;
+    track<Tracker, Warp>(images, corners, false, sequential);
+    for (size_t k = 0; k < ref.p.size(); k++) {
+      for (unsigned int i = 0; i < ref.p[k].size(); i++) {
+        if (std::fabs(ref.p[k][i] - sequential.p[k][i]) > 1e-6) {
+          std::cerr << name << ": the warps differ from the sequential sums" << std::endl;
+          return false;
+        }
+      }
+    }
+
+    std::cout << name << " is ok" << std::endl;
+    return true;
+  }
+}
+
+int main()
+{
+  try {
+    // The texture moves of one pixel down and two pixels right per image
+    std::vector< vpImage<unsigned char> > images(4);
+    for (size_t k = 0; k < images.size(); k++)
+      textureImage(images[k], 1. * k, 2. * k);
+
+    std::vector<vpImagePoint> corners;
+    corners.push_back(vpImagePoint(60, 80));
+    corners.push_back(vpImagePoint(60, 240));
+    corners.push_back(vpImagePoint(180, 240));
+    corners.push_back(vpImagePoint(60, 80));
+    corners.push_back(vpImagePoint(180, 240));
+    corners.push_back(vpImagePoint(180, 80));
+
+    unsigned int nthreads = vpThreadPool::getNumThreads();
+    bool ok = compareThreads<vpTemplateTrackerSSDInverseCompositional, vpTemplateTrackerWarpHomography>("SSD inverse compositional", images, corners)
+        && compareThreads<vpTemplateTrackerSSDForwardAdditional, vpTemplateTrackerWarpHomography>("SSD forward additional", images, corners)
+        && compareThreads<vpTemplateTrackerSSDForwardCompositional, vpTemplateTrackerWarpHomography>("SSD forward compositional", images, corners)
+        && compareThreads<vpTemplateTrackerSSDESM, vpTemplateTrackerWarpHomographySL3>("SSD ESM", images, corners)
+        && compareThreads<vpTemplateTrackerZNCCForwardAdditional, vpTemplateTrackerWarpHomography>("ZNCC forward additional", images, corners)
+        && compareThreads<vpTemplateTrackerZNCCInverseCompositional, vpTemplateTrackerWarpHomography>("ZNCC inverse compositional", images, corners);
+    vpThreadPool::setNumThreads(nthreads);
+
+    return ok ? 0 : 1;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return 1;
+  }
+}
@@ -145,24 +145,18 @@ double vpTemplateTrackerMI::getCost(const vpImage<unsigned char> &I, const vpCol
   memset(PrtD, 0, Nc_*Nc_*influBspline_*sizeof(double));
 
   //Warp->ComputeMAtWarp(tp);
-  Warp->computeCoeff(tp);
+  warpTemplate(tp);
   for(unsigned int point=0;point<templateSize;point++)
   {
-    int i=ptTemplate[point].y;
-    int j=ptTemplate[point].x;
-    X1[0]=j;X1[1]=i;
-
-    Warp->computeDenom(X1,tp);
-    Warp->warpX(X1,X2,tp);
-    double j2=X2[0];
-    double i2=X2[1];
+    double j2=xWarped[point];
+    double i2=yWarped[point];
 
     //Tij=Templ[i-(int)Triangle->GetMiny()][j-(int)Triangle->GetMinx()];
     if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
     {
       Nbpoint++;
 
-      double Tij=ptTemplate[point].val;
+      double Tij=ptTemplatePacked->val[point];
       if(!blur)
         IW=I.getValue(i2,j2);
       else
@@ -252,21 +246,16 @@ double vpTemplateTrackerMI::getNormalizedCost(const vpImage<unsigned char> &I, c
   memset(Pt_, 0, 256*sizeof(double));
   memset(Prt_, 0, 256*256*sizeof(double));
 
+  warpTemplate(tp);
   for(unsigned int point=0;point<templateSize;point++)
   {
-    int i=ptTemplate[point].y;
-    int j=ptTemplate[point].x;
-    X1[0]=j;X1[1]=i;
-
-    Warp->computeDenom(X1,tp);
-    Warp->warpX(X1,X2,tp);
-    double j2=X2[0];
-    double i2=X2[1];
+    double j2=xWarped[point];
+    double i2=yWarped[point];
 
     if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
     {
       Nbpoint++;
-      double Tij=ptTemplate[point].val;
+      double Tij=ptTemplatePacked->val[point];
       if(!blur)
         IW=I[(int)i2][(int)j2];
       else
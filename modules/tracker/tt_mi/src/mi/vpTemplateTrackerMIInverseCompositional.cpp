@@ -273,22 +273,13 @@ void vpTemplateTrackerMIInverseCompositional::trackNoPyr(const vpImage<unsigned
 
     zeroProbabilities();
 
-    Warp->computeCoeff(p);
+    warpTemplate(p);
 
     {
       for(int point=0;point<(int)templateSize;point++)
       {
-        vpColVector x1(2),x2(2);
-        double i2,j2;
-
-        x1[0]=(double)ptTemplate[point].x;
-        x1[1]=(double)ptTemplate[point].y;
-
-        Warp->computeDenom(x1,p); // A modif pour parallelisation mais ne pose pas de pb avec warp utilises dans DECSA
-        Warp->warpX(x1,x2,p);
-
-        j2=x2[0];
-        i2=x2[1];
+        double j2=xWarped[point];
+        double i2=yWarped[point];
 
         if((i2>=0)&&(j2>=0)&&(i2<I.getHeight()-1)&&(j2<I.getWidth()-1))
         {
@@ -70,6 +70,7 @@
 #include <opencv2/features2d/features2d.hpp>
 #include <opencv2/calib3d/calib3d.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
+#include <opencv2/flann/flann.hpp>
 
 #if defined(VISP_HAVE_OPENCV_XFEATURES2D) // OpenCV >= 3.0.0
 #  include <opencv2/xfeatures2d.hpp>
@@ -81,6 +82,32 @@
 #  include <libxml/xmlwriter.h>
 #endif
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+/*
+  Copy-on-write memory mapping of a learning file saved by vpKeyPoint in the
+  mapped format. The train descriptors and the training images loaded from
+  the file point into the mapping, which is released with the last
+  vpKeyPoint that uses it.
+*/
+class VISP_EXPORT vpMappedLearningData
+{
+public:
+  explicit vpMappedLearningData(const std::string &filename);
+  ~vpMappedLearningData();
+
+  unsigned char *data() const { return m_data; }
+  size_t size() const { return m_size; }
+
+private:
+  vpMappedLearningData(const vpMappedLearningData &);
+  vpMappedLearningData &operator=(const vpMappedLearningData &);
+
+  unsigned char *m_data;
+  size_t m_size;
+  void *m_handle; // File mapping object under Windows
+};
+#endif
+
 /*!
   \class vpKeyPoint
   \ingroup group_vision_keypoints
@@ -239,6 +266,16 @@ public:
     pgmImageFormat   /*!< Save training images in PGM format. */
   } vpImageFormatType;
 
+  /*! Predefined constant for learning file format. */
+  typedef enum {
+    xmlLearningDataFormat,    /*!< XML file, training images saved in separate files. */
+    binaryLearningDataFormat, /*!< Little endian binary file read field by field, training images saved in
+                                   separate files. */
+    mappedLearningDataFormat  /*!< Aligned binary file in the byte order of the host, memory-mapped when loaded:
+                                   the train descriptors and the training images are used without being parsed
+                                   or decoded. */
+  } vpLearningDataFormatType;
+
 
   vpKeyPoint(const std::string &detectorName="ORB", const std::string &extractorName="ORB",
              const std::string &matcherName="BruteForce-Hamming", const vpFilterMatchingType &filterType=ratioDistanceThreshold);
@@ -495,6 +532,9 @@ public:
      Get the train descriptors matrix.
 
      \return : Matrix with descriptors values at each row for each train keypoints (or reference keypoints).
+     When the learning data are loaded from a file in the mappedLearningDataFormat, the matrix points
+     into the mapped file, which stays mapped until reset() or the next call to loadLearningData()
+     without append.
    */
   inline cv::Mat getTrainDescriptors() const {
     return m_trainDescriptors;
@@ -542,6 +582,8 @@ public:
   void reset();
 
   void saveLearningData(const std::string &filename, const bool binaryMode=false, const bool saveTrainingImages=true);
+  void saveLearningData(const std::string &filename, const vpLearningDataFormatType format,
+                        const bool saveTrainingImages=true);
 
   /*!
     Set if the covariance matrix has to be computed in the Virtual Visual Servoing approach.
@@ -557,6 +599,23 @@ public:
     }
   }
 
+  /*!
+     Split the image in horizontal bands to detect the keypoints and extract the descriptors in parallel (when ViSP
+     is built with OpenMP). The keypoints of a band are detected on the band enlarged by \p overlap rows on each side,
+     only those located in the band are kept and the merged list is cleaned with KeyPointsFilter::removeDuplicated().
+     It is used by buildReference() and matchPoint() when the affine detection is not used.
+
+     \param nbBands : Number of bands, 1 to detect and extract on the whole image.
+     \param overlap : Number of rows added on each side of a band, it should be larger than the border needed by the
+     detector and the extractor (31 for ORB).
+
+     \note Detectors that keep a maximum number of keypoints (ORB, GFTT) apply this limit to each band.
+   */
+  inline void setDetectionBands(const unsigned int nbBands, const unsigned int overlap=64) {
+    m_nbDetectionBands = nbBands > 0 ? nbBands : 1;
+    m_detectionBandOverlap = overlap;
+  }
+
   /*!
      Set the method to decide if the object is present or not.
 
@@ -655,6 +714,20 @@ public:
     m_imageFormat = imageFormat;
   }
 
+  /*!
+    Set the maximum number of leaves of the index visited to search the nearest neighbours of a query
+    descriptor. Increasing it improves the recall of the approximate search at the cost of the matching time.
+
+    \param checks : Number of leaves to check (64 by default).
+
+    \sa setUseIndex()
+  */
+  inline void setIndexChecks(const int checks) {
+    m_indexChecks = checks;
+  }
+
+  void setIndexTrees(const int nbTrees);
+
   /*!
      Set and initialize a matcher denominated by his name \p matcherName.
      The different matchers are:
@@ -829,6 +902,8 @@ public:
   }
 #endif
 
+  void setUseIndex(const bool useIndex);
+
   /*!
     Set if we want to match the train keypoints to the query keypoints.
 
@@ -873,6 +948,8 @@ private:
   vpMatrix m_covarianceMatrix;
   //! Current id associated to the training image used for the learning.
   int m_currentImageId;
+  //! Number of rows added on each side of a detection band.
+  unsigned int m_detectionBandOverlap;
   //! Method (based on descriptor distances) to decide if the object is present or not.
   vpDetectionMethodType m_detectionMethod;
   //! Detection score to decide if the object is present or not.
@@ -899,12 +976,22 @@ private:
   vpFilterMatchingType m_filterType;
   //! Image format to use when saving the training images
   vpImageFormatType m_imageFormat;
+  //! Approximate nearest neighbour index of the train descriptors.
+  cv::Ptr<cv::flann::Index> m_index;
+  //! Maximum number of leaves visited when searching the index.
+  int m_indexChecks;
+  //! Train descriptors in the type required by the index.
+  cv::Mat m_indexDescriptors;
+  //! Number of trees of the index.
+  int m_indexTrees;
   //! List of k-nearest neighbors for each detected keypoints (if the method chosen is based upon on knn).
   std::vector<std::vector<cv::DMatch> > m_knnMatches;
   //! Map of image id to know to which training image is related a training keypoints.
   std::map<int, int> m_mapOfImageId;
   //! Map of images to have access to the image buffer according to his image id.
   std::map<int, vpImage<unsigned char> > m_mapOfImages;
+  //! Learning files loaded in mapped format, referenced by the train descriptors and the training images.
+  std::vector<cv::Ptr<vpMappedLearningData> > m_mappedLearningData;
   //! Smart reference-counting pointer (similar to shared_ptr in Boost) of descriptor matcher (e.g. BruteForce or FlannBased).
   cv::Ptr<cv::DescriptorMatcher> m_matcher;
   //! Name of the matcher.
@@ -919,6 +1006,8 @@ private:
   double m_matchingTime;
   //! List of pairs between the keypoint and the 3D point after the Ransac.
   std::vector<std::pair<cv::KeyPoint, cv::Point3f> > m_matchRansacKeyPointsToPoints;
+  //! Number of horizontal bands used to detect and extract in parallel.
+  unsigned int m_nbDetectionBands;
   //! Maximum number of iterations for the Ransac method.
   int m_nbRansacIterations;
   //! Minimum number of inliers for the Ransac method.
@@ -962,6 +1051,8 @@ private:
 #endif
   //! Flag set if a percentage value is used to determine the number of inliers for the Ransac method.
   bool m_useConsensusPercentage;
+  //! Flag set if the query descriptors are matched with the approximate nearest neighbour index.
+  bool m_useIndex;
   //! Flag set if a knn matching method must be used.
   bool m_useKnn;
   //! Flag set if we want to match the train keypoints to the query keypoints, useful when there is only one train image
@@ -976,9 +1067,14 @@ private:
 
   void affineSkew(double tilt, double phi, cv::Mat& img, cv::Mat& mask, cv::Mat& Ai);
 
+  void buildIndex(const std::string &indexFilename="");
+
   double computePoseEstimationError(const std::vector<std::pair<cv::KeyPoint, cv::Point3f> > &matchKeyPoints,
                                     const vpCameraParameters &cam, const vpHomogeneousMatrix &cMo_est);
 
+  void detectExtractBands(const vpImage<unsigned char> &I, std::vector<cv::KeyPoint> &keyPoints, cv::Mat &descriptors,
+                          double &detectionTime, double &extractionTime, const vpRect &rectangle);
+
   void filterMatches();
 
   void init();
@@ -988,6 +1084,12 @@ private:
   void initExtractor(const std::string &extractorName);
   void initExtractors(const std::vector<std::string> &extractorNames);
 
+  void knnMatchBlocks(const cv::Mat &queryDescriptors, std::vector<std::vector<cv::DMatch> > &knnMatches, const int k);
+  void knnMatchIndex(const cv::Mat &queryDescriptors, std::vector<std::vector<cv::DMatch> > &knnMatches, const int k);
+
+  void loadMappedLearningData(const std::string &filename, const bool append, const int startClassId,
+                              const int startImageId);
+
   inline size_t myKeypointHash(const cv::KeyPoint &kp) {
     size_t _Val = 2166136261U, scale = 16777619U;
     Cv32suf u;
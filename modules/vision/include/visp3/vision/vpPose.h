@@ -111,6 +111,14 @@ private:
   double ransacThreshold;
   double distanceToPlaneForCoplanarityTest;
   bool removeRansacDegeneratePoints;
+  //! Number of trials done by the last call to poseRansac()
+  unsigned int ransacNbTrials;
+  //! Probability to draw an outlier free sample used by the adaptive termination of the RANSAC
+  double ransacProbability;
+  //! Flag used to evaluate the RANSAC hypotheses in parallel
+  bool useParallelRansac;
+  //! Flag used to stop the RANSAC as soon as enough trials have been done
+  bool useRansacAdaptiveTermination;
 
 protected:
   double computeResidualDementhon(const vpHomogeneousMatrix &cMo) ;
@@ -133,6 +141,9 @@ public:
   //! compute the residual (i.e., the quality of the result)
   //! compute the residual (in meter for pose M)
   double computeResidual(const vpHomogeneousMatrix &cMo) const ;
+  //! compute the residuals and the number of inliers of several poses
+  void computeResiduals(const std::vector<vpHomogeneousMatrix> &cMo, const double threshold,
+                        std::vector<double> &residuals, std::vector<unsigned int> &nbInliers) const ;
   //! test the coplanarity of the points
   bool coplanar(int &coplanar_plane_type) ;
   void displayModel(vpImage<unsigned char> &I,
@@ -217,6 +228,88 @@ public:
     removeRansacDegeneratePoints = remove;
   }
 
+  /*!
+    Get the number of hypotheses evaluated by the last call to poseRansac().
+
+    \return The number of RANSAC trials.
+  */
+  unsigned int getRansacNbTrials() const {
+    return ransacNbTrials;
+  }
+
+  /*!
+    Get the probability used by the adaptive termination of the RANSAC.
+
+    \return The probability to draw at least one outlier free sample.
+
+    \sa setUseRansacAdaptiveTermination()
+  */
+  double getRansacProbability() const {
+    return ransacProbability;
+  }
+
+  /*!
+    Set the probability to draw at least one outlier free sample, used by the
+    adaptive termination of the RANSAC (0.99 by default).
+
+    \param p : Probability in ]0, 1[.
+
+    \sa setUseRansacAdaptiveTermination()
+  */
+  void setRansacProbability(const double &p) {
+    if(p > 0 && p < 1) {
+      ransacProbability = p;
+    } else {
+      throw vpException(vpException::badValue, "The Ransac probability must be in ]0, 1[.");
+    }
+  }
+
+  /*!
+    Get the flag if the RANSAC hypotheses are evaluated in parallel or not.
+
+    \return True if the hypotheses are evaluated in parallel, false otherwise.
+  */
+  bool getUseParallelRansac() const {
+    return useParallelRansac;
+  }
+
+  /*!
+    Set if the RANSAC hypotheses have to be evaluated in parallel with
+    vpThreadPool. The result doesn't depend on the number of threads but
+    differs from the sequential one since the points are not drawn with the
+    same random series.
+
+    \warning The function passed to poseRansac() is then called from several
+    threads and must be thread-safe.
+
+    \param parallel : True to evaluate the hypotheses in parallel, false otherwise.
+  */
+  void setUseParallelRansac(const bool parallel) {
+    useParallelRansac = parallel;
+  }
+
+  /*!
+    Get the flag if the RANSAC stops as soon as enough trials have been done.
+
+    \return True if the adaptive termination is used, false otherwise.
+  */
+  bool getUseRansacAdaptiveTermination() const {
+    return useRansacAdaptiveTermination;
+  }
+
+  /*!
+    Set if the number of RANSAC trials has to be adapted to the best inlier
+    ratio \f$ w \f$ found so far. The RANSAC then stops after
+    \f$ N = \log(1-p) / \log(1-w^4) \f$ trials, where \f$ p \f$ is the
+    probability set by setRansacProbability(), and never does more than the
+    maximum number of trials.
+
+    \param adaptive : True to use the adaptive termination, false otherwise.
+  */
+  void setUseRansacAdaptiveTermination(const bool adaptive) {
+    useRansacAdaptiveTermination = adaptive;
+  }
+
   /*!
     Get the vector of points.
 
@@ -244,6 +337,10 @@ public:
                                   double lx, vpCameraParameters & cam,
                                   vpHomogeneousMatrix & cMo) ;
                      
+  static void computeResiduals(const std::vector<vpPoint> &points, const std::vector<vpHomogeneousMatrix> &cMo,
+                               const double threshold, std::vector<double> &residuals,
+                               std::vector<unsigned int> &nbInliers) ;
+
   static void findMatch(std::vector<vpPoint> &p2D, 
                      std::vector<vpPoint> &p3D, 
                      const unsigned int &numberOfInlierToReachAConsensus,
@@ -48,6 +48,10 @@
 #  include <opencv2/calib3d/calib3d.hpp>
 #endif
 
+#ifdef VISP_HAVE_OPENMP
+#  include <omp.h>
+#endif
+
 //Detect endianness of the host machine
 //Reference: http://www.boost.org/doc/libs/1_36_0/boost/detail/endian.hpp
 #if defined (__GLIBC__)
@@ -319,6 +323,81 @@ void writeBinaryDoubleLE(std::ofstream &file, const double double_value) {
 #endif
 }
 
+//Layout of the learning files saved in vpKeyPoint::mappedLearningDataFormat. The values are stored in the byte
+//order of the host and each section starts at a multiple of mappedLearningDataAlignment bytes, so that the
+//mapped file can be used in place.
+const char mappedLearningDataMagic[8] = { 'V', 'P', 'K', 'P', 'M', 'A', 'P', '\0' };
+const uint32_t mappedLearningDataVersion = 1;
+const uint32_t mappedLearningDataByteOrder = 0x01020304;
+const uint64_t mappedLearningDataAlignment = 64;
+
+struct vpMappedLearningDataHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t byteOrder;
+  int32_t nbKeyPoints;
+  int32_t descriptorCols;
+  int32_t descriptorType;
+  int32_t have3DInfo;
+  int32_t nbImages;
+  int32_t reserved;
+  uint64_t descriptorStep;    //Size in bytes of a row of descriptor
+  uint64_t keyPointsOffset;   //Array of vpMappedKeyPoint
+  uint64_t pointsOffset;      //Array of (oX, oY, oZ) float triplets, 0 if there is no 3D information
+  uint64_t descriptorsOffset; //Rows of descriptors
+  uint64_t imagesOffset;      //Array of vpMappedImage
+  uint64_t fileSize;
+};
+
+struct vpMappedKeyPoint {
+  float u, v, size, angle, response;
+  int32_t octave, class_id, image_id;
+};
+
+struct vpMappedImage {
+  int32_t image_id;
+  uint32_t height, width;
+  uint32_t reserved;
+  uint64_t offset;            //Grey level pixels, row by row
+};
+
+//Round up an offset in a mapped learning file to the alignment of the sections
+uint64_t alignMappedOffset(const uint64_t offset) {
+  return (offset + mappedLearningDataAlignment - 1) & ~(mappedLearningDataAlignment - 1);
+}
+
+//Write zeros until the position in the file reaches offset
+void writeMappedPadding(std::ofstream &file, uint64_t &position, const uint64_t offset) {
+  const char zeros[mappedLearningDataAlignment] = { 0 };
+  while(position < offset) {
+    uint64_t length = std::min(offset - position, mappedLearningDataAlignment);
+    file.write(zeros, (std::streamsize) length);
+    position += length;
+  }
+}
+
+//Check if a learning file is saved in vpKeyPoint::mappedLearningDataFormat
+bool isMappedLearningData(const std::string &filename) {
+  std::ifstream file(filename.c_str(), std::ifstream::binary);
+  char magic[sizeof(mappedLearningDataMagic)];
+  return file.read(magic, sizeof(magic)) && std::equal(magic, magic + sizeof(magic), mappedLearningDataMagic);
+}
+
+//Name of the file where the index of the train descriptors is saved next to a learning file
+std::string getIndexFilename(const std::string &learningFilename) {
+  return learningFilename + ".index";
+}
+
+//Save the index of the train descriptors next to a learning file, or remove a previously saved one
+void saveIndex(const cv::Ptr<cv::flann::Index> &index, const std::string &learningFilename) {
+  std::string indexFilename = getIndexFilename(learningFilename);
+  if(!index.empty()) {
+    index->save(indexFilename);
+  } else if(vpIoTools::checkFilename(indexFilename)) {
+    vpIoTools::remove(indexFilename);
+  }
+}
+
 /*!
   Constructor to initialize specified detector, extractor, matcher and filtering method.
 
@@ -329,21 +408,23 @@ void writeBinaryDoubleLE(std::ofstream &file, const double double_value) {
  */
 vpKeyPoint::vpKeyPoint(const std::string &detectorName, const std::string &extractorName,
                        const std::string &matcherName, const vpFilterMatchingType &filterType)
-  : m_computeCovariance(false), m_covarianceMatrix(), m_currentImageId(0), m_detectionMethod(detectionScore),
-    m_detectionScore(0.15), m_detectionThreshold(100.0), m_detectionTime(0.), m_detectorNames(),
+  : m_computeCovariance(false), m_covarianceMatrix(), m_currentImageId(0), m_detectionBandOverlap(64),
+    m_detectionMethod(detectionScore), m_detectionScore(0.15), m_detectionThreshold(100.0), m_detectionTime(0.),
+    m_detectorNames(),
     m_detectors(), m_extractionTime(0.), m_extractorNames(), m_extractors(), m_filteredMatches(), m_filterType(filterType),
-    m_imageFormat(jpgImageFormat), m_knnMatches(), m_mapOfImageId(), m_mapOfImages(),
-    m_matcher(), m_matcherName(matcherName),
+    m_imageFormat(jpgImageFormat), m_index(), m_indexChecks(64), m_indexDescriptors(), m_indexTrees(4),
+    m_knnMatches(), m_mapOfImageId(), m_mapOfImages(),
+    m_mappedLearningData(), m_matcher(), m_matcherName(matcherName),
     m_matches(), m_matchingFactorThreshold(2.0), m_matchingRatioThreshold(0.85), m_matchingTime(0.),
-    m_matchRansacKeyPointsToPoints(), m_nbRansacIterations(200), m_nbRansacMinInlierCount(100), m_objectFilteredPoints(),
-    m_poseTime(0.), m_queryDescriptors(), m_queryFilteredKeyPoints(), m_queryKeyPoints(),
+    m_matchRansacKeyPointsToPoints(), m_nbDetectionBands(1), m_nbRansacIterations(200), m_nbRansacMinInlierCount(100),
+    m_objectFilteredPoints(), m_poseTime(0.), m_queryDescriptors(), m_queryFilteredKeyPoints(), m_queryKeyPoints(),
     m_ransacConsensusPercentage(20.0), m_ransacInliers(), m_ransacOutliers(), m_ransacReprojectionError(6.0),
     m_ransacThreshold(0.01), m_trainDescriptors(), m_trainKeyPoints(), m_trainPoints(),
     m_trainVpPoints(), m_useAffineDetection(false),
     #if (VISP_HAVE_OPENCV_VERSION >= 0x020400 && VISP_HAVE_OPENCV_VERSION < 0x030000)
     m_useBruteForceCrossCheck(true),
     #endif
-    m_useConsensusPercentage(false),
+    m_useConsensusPercentage(false), m_useIndex(false),
     m_useKnn(false), m_useMatchTrainToQuery(false), m_useRansacVVS(true), m_useSingleMatchFilter(true)
 {
   //Use k-nearest neighbors (knn) to retrieve the two best matches for a keypoint
@@ -368,21 +449,23 @@ vpKeyPoint::vpKeyPoint(const std::string &detectorName, const std::string &extra
  */
 vpKeyPoint::vpKeyPoint(const std::vector<std::string> &detectorNames, const std::vector<std::string> &extractorNames,
                        const std::string &matcherName, const vpFilterMatchingType &filterType)
-  : m_computeCovariance(false), m_covarianceMatrix(), m_currentImageId(0), m_detectionMethod(detectionScore),
-    m_detectionScore(0.15), m_detectionThreshold(100.0), m_detectionTime(0.), m_detectorNames(detectorNames),
+  : m_computeCovariance(false), m_covarianceMatrix(), m_currentImageId(0), m_detectionBandOverlap(64),
+    m_detectionMethod(detectionScore), m_detectionScore(0.15), m_detectionThreshold(100.0), m_detectionTime(0.),
+    m_detectorNames(detectorNames),
     m_detectors(), m_extractionTime(0.), m_extractorNames(extractorNames), m_extractors(), m_filteredMatches(),
-    m_filterType(filterType), m_imageFormat(jpgImageFormat), m_knnMatches(), m_mapOfImageId(), m_mapOfImages(),
-    m_matcher(),
+    m_filterType(filterType), m_imageFormat(jpgImageFormat), m_index(), m_indexChecks(64), m_indexDescriptors(),
+    m_indexTrees(4), m_knnMatches(), m_mapOfImageId(), m_mapOfImages(),
+    m_mappedLearningData(), m_matcher(),
     m_matcherName(matcherName), m_matches(), m_matchingFactorThreshold(2.0), m_matchingRatioThreshold(0.85), m_matchingTime(0.),
-    m_matchRansacKeyPointsToPoints(), m_nbRansacIterations(200), m_nbRansacMinInlierCount(100), m_objectFilteredPoints(),
-    m_poseTime(0.), m_queryDescriptors(), m_queryFilteredKeyPoints(), m_queryKeyPoints(),
+    m_matchRansacKeyPointsToPoints(), m_nbDetectionBands(1), m_nbRansacIterations(200), m_nbRansacMinInlierCount(100),
+    m_objectFilteredPoints(), m_poseTime(0.), m_queryDescriptors(), m_queryFilteredKeyPoints(), m_queryKeyPoints(),
     m_ransacConsensusPercentage(20.0), m_ransacInliers(), m_ransacOutliers(), m_ransacReprojectionError(6.0),
     m_ransacThreshold(0.01), m_trainDescriptors(), m_trainKeyPoints(), m_trainPoints(),
     m_trainVpPoints(), m_useAffineDetection(false),
     #if (VISP_HAVE_OPENCV_VERSION >= 0x020400 && VISP_HAVE_OPENCV_VERSION < 0x030000)
     m_useBruteForceCrossCheck(true),
     #endif
-    m_useConsensusPercentage(false),
+    m_useConsensusPercentage(false), m_useIndex(false),
     m_useKnn(false), m_useMatchTrainToQuery(false), m_useRansacVVS(true), m_useSingleMatchFilter(true)
 {
   //Use k-nearest neighbors (knn) to retrieve the two best matches for a keypoint
@@ -451,6 +534,67 @@ void vpKeyPoint::affineSkew(double tilt, double phi, cv::Mat& img,
   cv::invertAffineTransform(A, Ai);
 }
 
+/*!
+   Build the approximate nearest neighbour index of the train descriptors if it is used: a hierarchical
+   clustering index with the Hamming distance for binary descriptors, or a randomized k-d forest with the L2
+   distance for floating point descriptors.
+
+   \param indexFilename : If not empty and the file exists, load the index saved in this file by
+   saveLearningData() instead of building it.
+ */
+void vpKeyPoint::buildIndex(const std::string &indexFilename) {
+  m_index = cv::Ptr<cv::flann::Index>();
+  m_indexDescriptors = cv::Mat();
+  if(!m_useIndex || m_trainDescriptors.empty()) {
+    return;
+  }
+
+#if (VISP_HAVE_OPENCV_VERSION >= 0x020400)
+  cvflann::flann_distance_t distance = cvflann::FLANN_DIST_L2;
+  if(m_trainDescriptors.type() == CV_8U) {
+    distance = cvflann::FLANN_DIST_HAMMING;
+    m_indexDescriptors = m_trainDescriptors;
+  } else if(m_trainDescriptors.type() == CV_32F) {
+    m_indexDescriptors = m_trainDescriptors;
+  } else {
+    m_trainDescriptors.convertTo(m_indexDescriptors, CV_32F);
+  }
+
+#if (VISP_HAVE_OPENCV_VERSION >= 0x030000)
+  m_index = cv::makePtr<cv::flann::Index>();
+#else
+  m_index = new cv::flann::Index();
+#endif
+
+  if(!indexFilename.empty() && vpIoTools::checkFilename(indexFilename)) {
+    try {
+      if(m_index->load(m_indexDescriptors, indexFilename)) {
+        return;
+      }
+    }
+    catch(const std::exception &) {
+      //The saved index is corrupted or doesn't fit the train descriptors: cv::Exception, or
+      //cvflann::FLANNException that only derives from std::runtime_error. Build it again
+    }
+#if (VISP_HAVE_OPENCV_VERSION >= 0x030000)
+    m_index = cv::makePtr<cv::flann::Index>();
+#else
+    m_index = new cv::flann::Index();
+#endif
+  }
+
+  if(distance == cvflann::FLANN_DIST_HAMMING) {
+    m_index->build(m_indexDescriptors, cv::flann::HierarchicalClusteringIndexParams(32, cvflann::FLANN_CENTERS_RANDOM,
+                                                                                     m_indexTrees, 100), distance);
+  } else {
+    m_index->build(m_indexDescriptors, cv::flann::KDTreeIndexParams(m_indexTrees), distance);
+  }
+#else
+  (void)indexFilename;
+  throw vpException(vpException::fatalError, "The approximate nearest neighbour index requires OpenCV >= 2.4.");
+#endif
+}
+
 /*!
    Build the reference keypoints list.
 
@@ -516,6 +660,8 @@ unsigned int vpKeyPoint::buildReference(const vpImage<unsigned char> &I,
         m_trainDescriptors.push_back(*it);
       }
     }
+  } else if(m_nbDetectionBands > 1) {
+    detectExtractBands(I, m_trainKeyPoints, m_trainDescriptors, m_detectionTime, m_extractionTime, rectangle);
   } else {
     detect(I, m_trainKeyPoints, m_detectionTime, rectangle);
     extract(I, m_trainKeyPoints, m_trainDescriptors, m_extractionTime);
@@ -538,6 +684,7 @@ unsigned int vpKeyPoint::buildReference(const vpImage<unsigned char> &I,
   //Add train descriptors in matcher object
   m_matcher->clear();
   m_matcher->add(std::vector<cv::Mat>(1, m_trainDescriptors));
+  buildIndex();
 
   return static_cast<unsigned int>(m_trainKeyPoints.size());
 }
@@ -639,6 +786,7 @@ void vpKeyPoint::buildReference(const vpImage<unsigned char> &I, const std::vect
   //Add train descriptors in matcher object
   m_matcher->clear();
   m_matcher->add(std::vector<cv::Mat>(1, m_trainDescriptors));
+  buildIndex();
 
   _reference_computed = true;
 }
@@ -2255,6 +2403,116 @@ void vpKeyPoint::insertImageMatching(const vpImage<unsigned char> &ICurrent, vpI
   }
 }
 
+/*!
+   Search the k nearest train descriptors of each query descriptor with the approximate nearest neighbour index if it
+   is built, with the matcher otherwise. When ViSP is built with OpenMP, the query descriptors are split in blocks of
+   rows matched in parallel, each block with its own copy of the brute force matcher.
+
+   \param queryDescriptors : Query descriptors.
+   \param knnMatches : For each query descriptor, list of at most k matches sorted by increasing distance.
+   \param k : Number of nearest neighbours.
+ */
+void vpKeyPoint::knnMatchBlocks(const cv::Mat &queryDescriptors, std::vector<std::vector<cv::DMatch> > &knnMatches,
+                                const int k) {
+  int nbBlocks = 1;
+#ifdef VISP_HAVE_OPENMP
+  //The FLANN based matcher can't be copied with its train data, small query sets are not worth the copies
+  if(!m_index.empty() || m_matcherName.find("BruteForce") == 0) {
+    nbBlocks = std::max(1, std::min(omp_get_max_threads(), queryDescriptors.rows / 256));
+  }
+#endif
+
+  if(nbBlocks == 1) {
+    if(!m_index.empty()) {
+      knnMatchIndex(queryDescriptors, knnMatches, k);
+    } else {
+      m_matcher->knnMatch(queryDescriptors, knnMatches, k);
+    }
+    return;
+  }
+
+  //The matchers are not safe to share between threads. The clones share the
+  //train descriptors instead of deep copying them.
+  std::vector<cv::Ptr<cv::DescriptorMatcher> > listOfMatchers((size_t) nbBlocks);
+  if(m_index.empty()) {
+    listOfMatchers[0] = m_matcher;
+    for(size_t i = 1; i < listOfMatchers.size(); i++) {
+      listOfMatchers[i] = m_matcher->clone(true);
+      listOfMatchers[i]->add(std::vector<cv::Mat>(1, m_trainDescriptors));
+    }
+  }
+
+  std::vector<std::vector<std::vector<cv::DMatch> > > listOfKnnMatches((size_t) nbBlocks);
+#ifdef VISP_HAVE_OPENMP
+  #pragma omp parallel for
+#endif
+  for(int block = 0; block < nbBlocks; block++) {
+    int first = block * queryDescriptors.rows / nbBlocks;
+    int last = (block + 1) * queryDescriptors.rows / nbBlocks;
+    cv::Mat blockDescriptors = queryDescriptors.rowRange(first, last);
+
+    std::vector<std::vector<cv::DMatch> > &blockKnnMatches = listOfKnnMatches[(size_t) block];
+    if(m_index.empty()) {
+      listOfMatchers[(size_t) block]->knnMatch(blockDescriptors, blockKnnMatches, k);
+    } else {
+      knnMatchIndex(blockDescriptors, blockKnnMatches, k);
+    }
+
+    //Indexes are relative to the block
+    for(std::vector<std::vector<cv::DMatch> >::iterator it1 = blockKnnMatches.begin(); it1 != blockKnnMatches.end(); ++it1) {
+      for(std::vector<cv::DMatch>::iterator it2 = it1->begin(); it2 != it1->end(); ++it2) {
+        it2->queryIdx += first;
+      }
+    }
+  }
+
+  knnMatches.clear();
+  knnMatches.reserve((size_t) queryDescriptors.rows);
+  for(std::vector<std::vector<std::vector<cv::DMatch> > >::const_iterator it = listOfKnnMatches.begin();
+      it != listOfKnnMatches.end(); ++it) {
+    knnMatches.insert(knnMatches.end(), it->begin(), it->end());
+  }
+}
+
+/*!
+   Search the k nearest train descriptors of each query descriptor with the approximate nearest neighbour index.
+
+   \param queryDescriptors : Query descriptors.
+   \param knnMatches : For each query descriptor, list of at most k matches sorted by increasing distance.
+   \param k : Number of nearest neighbours.
+ */
+void vpKeyPoint::knnMatchIndex(const cv::Mat &queryDescriptors, std::vector<std::vector<cv::DMatch> > &knnMatches,
+                               const int k) {
+  knnMatches.clear();
+  //The index can't return more neighbours than train descriptors
+  int knn = std::min(k, m_indexDescriptors.rows);
+  if(queryDescriptors.empty() || knn <= 0) {
+    return;
+  }
+
+  cv::Mat query = queryDescriptors;
+  if(query.type() != m_indexDescriptors.type()) {
+    queryDescriptors.convertTo(query, m_indexDescriptors.type());
+  }
+
+  cv::Mat indices, dists;
+  m_index->knnSearch(query, indices, dists, knn, cv::flann::SearchParams(m_indexChecks));
+
+  knnMatches.resize((size_t) query.rows);
+  for(int i = 0; i < query.rows; i++) {
+    for(int j = 0; j < knn; j++) {
+      int trainIdx = indices.at<int>(i, j);
+      if(trainIdx < 0) {
+        break;
+      }
+
+      //Hamming distances are integers, L2 distances are squared
+      float distance = dists.type() == CV_32S ? (float) dists.at<int>(i, j) : std::sqrt(dists.at<float>(i, j));
+      knnMatches[(size_t) i].push_back(cv::DMatch(i, trainIdx, distance));
+    }
+  }
+}
+
 #ifdef VISP_HAVE_XML2
 /*!
    Load configuration parameters from an XML config file.
@@ -2333,7 +2591,11 @@ void vpKeyPoint::loadConfigFile(const std::string &configFile) {
 
    \param filename : Path of the learning file.
    \param binaryMode : If true, the learning file is in a binary mode, otherwise it is in XML mode.
+   In binary mode, a file saved in the mappedLearningDataFormat is detected and memory-mapped: the
+   train descriptors and the training images are used in place, without being parsed or decoded.
    \param append : If true, concatenate the learning data, otherwise reset the variables.
+
+   \sa saveLearningData(const std::string &, const vpLearningDataFormatType, const bool)
  */
 void vpKeyPoint::loadLearningData(const std::string &filename, const bool binaryMode, const bool append) {
   int startClassId = 0;
@@ -2343,6 +2605,12 @@ void vpKeyPoint::loadLearningData(const std::string &filename, const bool binary
     m_trainPoints.clear();
     m_mapOfImageId.clear();
     m_mapOfImages.clear();
+    //Release the previously mapped learning files once nothing points into them
+    m_trainDescriptors = cv::Mat();
+    m_matcher->clear();
+    m_index = cv::Ptr<cv::flann::Index>();
+    m_indexDescriptors = cv::Mat();
+    m_mappedLearningData.clear();
   } else {
     //In append case, find the max index of keypoint class Id
     for(std::map<int, int>::const_iterator it = m_mapOfImageId.begin(); it != m_mapOfImageId.end(); ++it) {
@@ -2365,7 +2633,9 @@ void vpKeyPoint::loadLearningData(const std::string &filename, const bool binary
     parent += "/";
   }
 
-  if(binaryMode) {
+  if(binaryMode && isMappedLearningData(filename)) {
+    loadMappedLearningData(filename, append, startClassId, startImageId);
+  } else if(binaryMode) {
     std::ifstream file(filename.c_str(), std::ifstream::binary);
     if(!file.is_open()){
       throw vpException(vpException::ioError, "Cannot open the file.");
@@ -2790,11 +3060,96 @@ void vpKeyPoint::loadLearningData(const std::string &filename, const bool binary
   //Add train descriptors in matcher object
   m_matcher->clear();
   m_matcher->add(std::vector<cv::Mat>(1, m_trainDescriptors));
+  //Load the index saved with the learning file, or build it
+  buildIndex(getIndexFilename(filename));
 
   //Set _reference_computed to true as we load learning file
   _reference_computed = true;
 }
 
+/*!
+   Load learning data saved in the mappedLearningDataFormat. The file stays mapped as long as the train
+   descriptors or the training images point into it.
+
+   \param filename : Path of the learning file.
+   \param append : If true, concatenate the learning data.
+   \param startClassId : Offset added to the class id of the keypoints.
+   \param startImageId : Offset added to the id of the training images.
+ */
+void vpKeyPoint::loadMappedLearningData(const std::string &filename, const bool append, const int startClassId,
+                                        const int startImageId) {
+  cv::Ptr<vpMappedLearningData> mapping(new vpMappedLearningData(filename));
+  unsigned char *data = mapping->data();
+
+  //The mapping is aligned on a page boundary
+  if(mapping->size() < sizeof(vpMappedLearningDataHeader)) {
+    throw vpException(vpException::ioError, "The learning file %s is truncated.", filename.c_str());
+  }
+  const vpMappedLearningDataHeader &header = *(const vpMappedLearningDataHeader *) data;
+  if(header.version != mappedLearningDataVersion) {
+    throw vpException(vpException::ioError, "Unsupported version %u of the learning file %s.", header.version,
+                      filename.c_str());
+  }
+  if(header.byteOrder != mappedLearningDataByteOrder) {
+    throw vpException(vpException::ioError, "The learning file %s was saved on a host with a different byte order.",
+                      filename.c_str());
+  }
+
+  //Check that all the sections are inside the file before using them
+  bool valid = header.fileSize == mapping->size() && header.nbKeyPoints >= 0 && header.descriptorCols >= 0
+      && header.nbImages >= 0 && header.descriptorType == CV_MAT_TYPE(header.descriptorType)
+      && header.descriptorStep == (uint64_t) header.descriptorCols * CV_ELEM_SIZE(header.descriptorType);
+  const uint64_t nbKeyPoints = valid ? (uint64_t) header.nbKeyPoints : 0;
+  valid = valid && header.keyPointsOffset + nbKeyPoints * sizeof(vpMappedKeyPoint) <= header.fileSize
+      && (!header.have3DInfo || header.pointsOffset + nbKeyPoints * 3 * sizeof(float) <= header.fileSize)
+      && header.descriptorsOffset + nbKeyPoints * header.descriptorStep <= header.fileSize
+      && header.imagesOffset + (uint64_t) header.nbImages * sizeof(vpMappedImage) <= header.fileSize;
+  const vpMappedImage *images = (const vpMappedImage *) (data + (valid ? header.imagesOffset : 0));
+  for(int i = 0; valid && i < header.nbImages; i++) {
+    valid = images[i].offset + (uint64_t) images[i].height * images[i].width <= header.fileSize;
+  }
+  if(!valid) {
+    throw vpException(vpException::ioError, "The learning file %s is corrupted.", filename.c_str());
+  }
+  m_mappedLearningData.push_back(mapping);
+
+  const vpMappedKeyPoint *keyPoints = (const vpMappedKeyPoint *) (data + header.keyPointsOffset);
+  m_trainKeyPoints.reserve(m_trainKeyPoints.size() + (size_t) nbKeyPoints);
+  for(int i = 0; i < header.nbKeyPoints; i++) {
+    const vpMappedKeyPoint &keyPoint = keyPoints[i];
+    m_trainKeyPoints.push_back(cv::KeyPoint(cv::Point2f(keyPoint.u, keyPoint.v), keyPoint.size, keyPoint.angle,
+                                            keyPoint.response, keyPoint.octave, keyPoint.class_id + startClassId));
+
+    if(keyPoint.image_id != -1) {
+      //No training images if image_id == -1
+      m_mapOfImageId[keyPoint.class_id + startClassId] = keyPoint.image_id + startImageId;
+    }
+  }
+
+  if(header.have3DInfo) {
+    const float *points = (const float *) (data + header.pointsOffset);
+    m_trainPoints.reserve(m_trainPoints.size() + (size_t) nbKeyPoints);
+    for(int i = 0; i < header.nbKeyPoints; i++) {
+      m_trainPoints.push_back(cv::Point3f(points[3*i], points[3*i + 1], points[3*i + 2]));
+    }
+  }
+
+  //The descriptors are used in place
+  cv::Mat trainDescriptors(header.nbKeyPoints, header.descriptorCols, header.descriptorType,
+                           data + header.descriptorsOffset, (size_t) header.descriptorStep);
+  if(!append || m_trainDescriptors.empty()) {
+    m_trainDescriptors = trainDescriptors;
+  } else {
+    cv::vconcat(m_trainDescriptors, trainDescriptors, m_trainDescriptors);
+  }
+
+  //The training images are used in place
+  for(int i = 0; i < header.nbImages; i++) {
+    m_mapOfImages[images[i].image_id + startImageId].wrap(data + images[i].offset, images[i].height,
+                                                          images[i].width);
+  }
+}
+
 /*!
    Match keypoints based on distance between their descriptors.
 
@@ -2829,7 +3184,7 @@ void vpKeyPoint::match(const cv::Mat &trainDescriptors, const cv::Mat &queryDesc
       std::transform(m_knnMatches.begin(), m_knnMatches.end(), matches.begin(), knnToDMatch);
     } else {
       //Match query descriptors to train descriptors
-      m_matcher->knnMatch(queryDescriptors, m_knnMatches, 2);
+      knnMatchBlocks(queryDescriptors, m_knnMatches, 2);
       matches.resize(m_knnMatches.size());
       std::transform(m_knnMatches.begin(), m_knnMatches.end(), matches.begin(), knnToDMatch);
     }
@@ -2847,7 +3202,13 @@ void vpKeyPoint::match(const cv::Mat &trainDescriptors, const cv::Mat &queryDesc
       }
     } else {
       //Match query descriptors to train descriptors
-      m_matcher->match(queryDescriptors, matches);
+      std::vector<std::vector<cv::DMatch> > knnMatches;
+      knnMatchBlocks(queryDescriptors, knnMatches, 1);
+      for(std::vector<std::vector<cv::DMatch> >::const_iterator it = knnMatches.begin(); it != knnMatches.end(); ++it) {
+        if(!it->empty()) {
+          matches.push_back(it->front());
+        }
+      }
     }
   }
   elapsedTime = vpTime::measureTimeMs() - t;
@@ -2922,6 +3283,8 @@ unsigned int vpKeyPoint::matchPoint(const vpImage<unsigned char> &I,
         m_queryDescriptors.push_back(*it);
       }
     }
+  } else if(m_nbDetectionBands > 1) {
+    detectExtractBands(I, m_queryKeyPoints, m_queryDescriptors, m_detectionTime, m_extractionTime, rectangle);
   } else {
     detect(I, m_queryKeyPoints, m_detectionTime, rectangle);
     extract(I, m_queryKeyPoints, m_queryDescriptors, m_extractionTime);
@@ -3017,6 +3380,8 @@ bool vpKeyPoint::matchPoint(const vpImage<unsigned char> &I, const vpCameraParam
         m_queryDescriptors.push_back(*it);
       }
     }
+  } else if(m_nbDetectionBands > 1) {
+    detectExtractBands(I, m_queryKeyPoints, m_queryDescriptors, m_detectionTime, m_extractionTime, rectangle);
   } else {
     detect(I, m_queryKeyPoints, m_detectionTime, rectangle);
     extract(I, m_queryKeyPoints, m_queryDescriptors, m_extractionTime);
@@ -3477,6 +3842,140 @@ void vpKeyPoint::detectExtractAffine(const vpImage<unsigned char> &I,std::vector
 #endif
 }
 
+/*!
+   Detect keypoints and extract descriptors in horizontal bands of the image processed in parallel, see
+   setDetectionBands().
+
+   \param I : Input image.
+   \param keyPoints : Output list of the detected keypoints.
+   \param descriptors : Descriptors matrix with at each row the descriptors values for each keypoint.
+   \param detectionTime : Elapsed time to detect the keypoints.
+   \param extractionTime : Elapsed time to extract the descriptors.
+   \param rectangle : Optional rectangle of the region of interest, only the rows of the rectangle are split in bands.
+ */
+void vpKeyPoint::detectExtractBands(const vpImage<unsigned char> &I, std::vector<cv::KeyPoint> &keyPoints,
+                                    cv::Mat &descriptors, double &detectionTime, double &extractionTime,
+                                    const vpRect &rectangle) {
+  double t = vpTime::measureTimeMs();
+  cv::Mat matImg;
+  vpImageConvert::convert(I, matImg, false);
+
+  //Rows of the image split in bands
+  int rowBegin = 0, rowEnd = matImg.rows;
+  cv::Mat mask;
+  if(rectangle.getWidth() > 0 && rectangle.getHeight() > 0) {
+    mask = cv::Mat::zeros(matImg.rows, matImg.cols, CV_8U);
+    cv::Point leftTop((int) rectangle.getLeft(), (int) rectangle.getTop()), rightBottom((int) rectangle.getRight(),
+                      (int) rectangle.getBottom());
+    cv::rectangle(mask, leftTop, rightBottom, cv::Scalar(255), CV_FILLED);
+
+    rowBegin = std::min(std::max((int) rectangle.getTop(), 0), matImg.rows);
+    rowEnd = std::max(std::min((int) rectangle.getBottom() + 1, matImg.rows), rowBegin);
+  }
+
+  int nbRows = rowEnd - rowBegin;
+  int nbBands = std::max(1, std::min((int) m_nbDetectionBands, nbRows));
+  int overlap = (int) m_detectionBandOverlap;
+
+  //A band owns the rows r such as (r - rowBegin) * nbBands / nbRows == band, it is processed with overlap rows more
+  //on each side to not lose the keypoints at its borders
+  std::vector<int> listOfBandTops((size_t) nbBands), listOfBandBottoms((size_t) nbBands);
+  for(int band = 0; band < nbBands; band++) {
+    int first = rowBegin + (band * nbRows + nbBands - 1) / nbBands;
+    int last = rowBegin + ((band + 1) * nbRows + nbBands - 1) / nbBands;
+    listOfBandTops[(size_t) band] = std::max(first - overlap, 0);
+    listOfBandBottoms[(size_t) band] = std::min(last + overlap, matImg.rows);
+  }
+
+  std::vector<std::vector<cv::KeyPoint> > listOfKeyPoints((size_t) nbBands);
+#ifdef VISP_HAVE_OPENMP
+  #pragma omp parallel for
+#endif
+  for(int band = 0; band < nbBands; band++) {
+    int top = listOfBandTops[(size_t) band], bottom = listOfBandBottoms[(size_t) band];
+    cv::Mat bandImg = matImg.rowRange(top, bottom);
+    cv::Mat bandMask = mask.empty() ? cv::Mat() : mask.rowRange(top, bottom);
+
+    for(std::map<std::string, cv::Ptr<cv::FeatureDetector> >::const_iterator it = m_detectors.begin();
+        it != m_detectors.end(); ++it) {
+      std::vector<cv::KeyPoint> kp;
+      it->second->detect(bandImg, kp, bandMask);
+
+      for(std::vector<cv::KeyPoint>::iterator it_kp = kp.begin(); it_kp != kp.end(); ++it_kp) {
+        it_kp->pt.y += (float) top;
+
+        //Keep only the keypoints owned by the band
+        int row = std::min(std::max((int) it_kp->pt.y, rowBegin), rowEnd - 1);
+        if((row - rowBegin) * nbBands / nbRows == band) {
+          listOfKeyPoints[(size_t) band].push_back(*it_kp);
+        }
+      }
+    }
+  }
+
+  keyPoints.clear();
+  for(std::vector<std::vector<cv::KeyPoint> >::const_iterator it = listOfKeyPoints.begin(); it != listOfKeyPoints.end(); ++it) {
+    keyPoints.insert(keyPoints.end(), it->begin(), it->end());
+  }
+
+  //Remove the keypoints found more than once, for instance by several detectors
+#if (VISP_HAVE_OPENCV_VERSION >= 0x030000)
+  vpKeyPoint::KeyPointsFilter::removeDuplicated(keyPoints);
+#elif (VISP_HAVE_OPENCV_VERSION >= 0x020400)
+  cv::KeyPointsFilter::removeDuplicated(keyPoints);
+#endif
+
+  //Dispatch again the keypoints, the order has been changed
+  for(std::vector<std::vector<cv::KeyPoint> >::iterator it = listOfKeyPoints.begin(); it != listOfKeyPoints.end(); ++it) {
+    it->clear();
+  }
+  for(std::vector<cv::KeyPoint>::const_iterator it = keyPoints.begin(); it != keyPoints.end(); ++it) {
+    int row = std::min(std::max((int) it->pt.y, rowBegin), rowEnd - 1);
+    listOfKeyPoints[(size_t) ((row - rowBegin) * nbBands / nbRows)].push_back(*it);
+  }
+  detectionTime = vpTime::measureTimeMs() - t;
+
+  t = vpTime::measureTimeMs();
+  std::vector<cv::Mat> listOfDescriptors((size_t) nbBands);
+#ifdef VISP_HAVE_OPENMP
+  #pragma omp parallel for
+#endif
+  for(int band = 0; band < nbBands; band++) {
+    std::vector<cv::KeyPoint> &kp = listOfKeyPoints[(size_t) band];
+    if(kp.empty()) {
+      continue;
+    }
+
+    int top = listOfBandTops[(size_t) band], bottom = listOfBandBottoms[(size_t) band];
+    for(std::vector<cv::KeyPoint>::iterator it = kp.begin(); it != kp.end(); ++it) {
+      it->pt.y -= (float) top;
+    }
+
+    double elapsedTime;
+    extract(matImg.rowRange(top, bottom), kp, listOfDescriptors[(size_t) band], elapsedTime);
+
+    for(std::vector<cv::KeyPoint>::iterator it = kp.begin(); it != kp.end(); ++it) {
+      it->pt.y += (float) top;
+    }
+  }
+
+  keyPoints.clear();
+  descriptors = cv::Mat();
+  for(size_t band = 0; band < listOfKeyPoints.size(); band++) {
+    if(listOfDescriptors[band].empty()) {
+      continue;
+    }
+
+    keyPoints.insert(keyPoints.end(), listOfKeyPoints[band].begin(), listOfKeyPoints[band].end());
+    if(descriptors.empty()) {
+      listOfDescriptors[band].copyTo(descriptors);
+    } else {
+      descriptors.push_back(listOfDescriptors[band]);
+    }
+  }
+  extractionTime = vpTime::measureTimeMs() - t;
+}
+
 /*!
    Reset the instance as if we would declare another vpKeyPoint variable.
  */
@@ -3485,23 +3984,26 @@ void vpKeyPoint::reset() {
   referenceImagePointsList.clear(); currentImagePointsList.clear(); matchedReferencePoints.clear(); _reference_computed = false;
 
 
-  m_computeCovariance = false; m_covarianceMatrix = vpMatrix(); m_currentImageId = 0; m_detectionMethod = detectionScore;
+  m_computeCovariance = false; m_covarianceMatrix = vpMatrix(); m_currentImageId = 0; m_detectionBandOverlap = 64;
+  m_detectionMethod = detectionScore;
   m_detectionScore = 0.15; m_detectionThreshold = 100.0; m_detectionTime = 0.0; m_detectorNames.clear();
   m_detectors.clear(); m_extractionTime = 0.0; m_extractorNames.clear(); m_extractors.clear(); m_filteredMatches.clear();
   m_filterType = ratioDistanceThreshold;
-  m_imageFormat = jpgImageFormat; m_knnMatches.clear(); m_mapOfImageId.clear(); m_mapOfImages.clear();
+  m_imageFormat = jpgImageFormat; m_index = cv::Ptr<cv::flann::Index>(); m_indexChecks = 64;
+  m_indexDescriptors = cv::Mat(); m_indexTrees = 4;
+  m_knnMatches.clear(); m_mapOfImageId.clear(); m_mapOfImages.clear();
   m_matcher = cv::Ptr<cv::DescriptorMatcher>(); m_matcherName = "BruteForce-Hamming";
   m_matches.clear(); m_matchingFactorThreshold = 2.0; m_matchingRatioThreshold = 0.85; m_matchingTime = 0.0;
-  m_matchRansacKeyPointsToPoints.clear(); m_nbRansacIterations = 200; m_nbRansacMinInlierCount = 100;
+  m_matchRansacKeyPointsToPoints.clear(); m_nbDetectionBands = 1; m_nbRansacIterations = 200; m_nbRansacMinInlierCount = 100;
   m_objectFilteredPoints.clear();
   m_poseTime = 0.0; m_queryDescriptors = cv::Mat(); m_queryFilteredKeyPoints.clear(); m_queryKeyPoints.clear();
   m_ransacConsensusPercentage = 20.0; m_ransacInliers.clear(); m_ransacOutliers.clear(); m_ransacReprojectionError = 6.0;
   m_ransacThreshold = 0.01; m_trainDescriptors = cv::Mat(); m_trainKeyPoints.clear(); m_trainPoints.clear();
-  m_trainVpPoints.clear(); m_useAffineDetection = false;
+  m_trainVpPoints.clear(); m_useAffineDetection = false; m_mappedLearningData.clear();
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020400 && VISP_HAVE_OPENCV_VERSION < 0x030000)
   m_useBruteForceCrossCheck = true;
 #endif
-  m_useConsensusPercentage = false;
+  m_useConsensusPercentage = false; m_useIndex = false;
   m_useKnn = true; //as m_filterType == ratioDistanceThreshold
   m_useMatchTrainToQuery = false; m_useRansacVVS = true; m_useSingleMatchFilter = true;
 
@@ -3947,6 +4449,182 @@ void vpKeyPoint::saveLearningData(const std::string &filename, bool binaryMode,
     std::cerr << "Error: libxml2 is required !" << std::endl;
 #endif
   }
+
+  saveIndex(m_index, filename);
+}
+
+/*!
+   Save the learning data in a file in the given format.
+
+   In the mappedLearningDataFormat, the keypoints, the 3D points and the descriptors are saved in aligned
+   arrays and the training images are saved as raw grey level pixels in the same file. When such a file is
+   loaded with loadLearningData() in binary mode, it is memory-mapped and the descriptors and the training
+   images are used without being parsed or decoded. The file can only be loaded on a host with the same
+   byte order.
+
+   \param filename : Path of the save file
+   \param format : Format of the learning file
+   \param saveTrainingImages : If true, save also the training images
+ */
+void vpKeyPoint::saveLearningData(const std::string &filename, const vpLearningDataFormatType format,
+                                  const bool saveTrainingImages) {
+  if(format != mappedLearningDataFormat) {
+    saveLearningData(filename, format == binaryLearningDataFormat, saveTrainingImages);
+    return;
+  }
+
+  std::string parent = vpIoTools::getParent(filename);
+  if(!parent.empty()) {
+    vpIoTools::makeDirectory(parent);
+  }
+
+  bool have3DInfo = m_trainPoints.size() > 0;
+  if(have3DInfo && m_trainPoints.size() != m_trainKeyPoints.size()) {
+    throw vpException(vpException::fatalError, "List of keypoints and list of 3D points have different size !");
+  }
+  if((size_t) m_trainDescriptors.rows != m_trainKeyPoints.size()) {
+    throw vpException(vpException::fatalError, "List of keypoints and matrix of descriptors have different size !");
+  }
+
+  //Compute the layout of the file
+  const uint64_t nbKeyPoints = (uint64_t) m_trainKeyPoints.size();
+  vpMappedLearningDataHeader header = vpMappedLearningDataHeader();
+  std::copy(mappedLearningDataMagic, mappedLearningDataMagic + sizeof(mappedLearningDataMagic), header.magic);
+  header.version = mappedLearningDataVersion;
+  header.byteOrder = mappedLearningDataByteOrder;
+  header.nbKeyPoints = (int32_t) nbKeyPoints;
+  header.descriptorCols = m_trainDescriptors.cols;
+  header.descriptorType = m_trainDescriptors.type();
+  header.have3DInfo = have3DInfo ? 1 : 0;
+  header.nbImages = saveTrainingImages ? (int32_t) m_mapOfImages.size() : 0;
+  header.descriptorStep = (uint64_t) m_trainDescriptors.cols * m_trainDescriptors.elemSize();
+
+  uint64_t offset = alignMappedOffset(sizeof(header));
+  header.keyPointsOffset = offset;
+  offset = alignMappedOffset(offset + nbKeyPoints * sizeof(vpMappedKeyPoint));
+  if(have3DInfo) {
+    header.pointsOffset = offset;
+    offset = alignMappedOffset(offset + nbKeyPoints * 3 * sizeof(float));
+  }
+  header.descriptorsOffset = offset;
+  offset = alignMappedOffset(offset + nbKeyPoints * header.descriptorStep);
+  header.imagesOffset = offset;
+  offset = alignMappedOffset(offset + (uint64_t) header.nbImages * sizeof(vpMappedImage));
+
+  std::vector<vpMappedImage> images;
+  if(saveTrainingImages) {
+    for(std::map<int, vpImage<unsigned char> >::const_iterator it = m_mapOfImages.begin(); it != m_mapOfImages.end(); ++it) {
+      vpMappedImage image = vpMappedImage();
+      image.image_id = it->first;
+      image.height = it->second.getHeight();
+      image.width = it->second.getWidth();
+      image.offset = offset;
+      offset = alignMappedOffset(offset + (uint64_t) image.height * image.width);
+      images.push_back(image);
+    }
+  }
+  header.fileSize = offset;
+
+  std::ofstream file(filename.c_str(), std::ofstream::binary);
+  if(!file.is_open()) {
+    throw vpException(vpException::ioError, "Cannot create the file.");
+  }
+
+  uint64_t position = 0;
+  file.write((const char *) &header, sizeof(header));
+  position += sizeof(header);
+
+  writeMappedPadding(file, position, header.keyPointsOffset);
+  for(size_t i = 0; i < m_trainKeyPoints.size(); i++) {
+    const cv::KeyPoint &trainKeyPoint = m_trainKeyPoints[i];
+    vpMappedKeyPoint keyPoint;
+    keyPoint.u = trainKeyPoint.pt.x;
+    keyPoint.v = trainKeyPoint.pt.y;
+    keyPoint.size = trainKeyPoint.size;
+    keyPoint.angle = trainKeyPoint.angle;
+    keyPoint.response = trainKeyPoint.response;
+    keyPoint.octave = trainKeyPoint.octave;
+    keyPoint.class_id = trainKeyPoint.class_id;
+    std::map<int, int>::const_iterator it_findImgId = m_mapOfImageId.find(trainKeyPoint.class_id);
+    keyPoint.image_id = (saveTrainingImages && it_findImgId != m_mapOfImageId.end()) ? it_findImgId->second : -1;
+    file.write((const char *) &keyPoint, sizeof(keyPoint));
+    position += sizeof(keyPoint);
+  }
+
+  if(have3DInfo) {
+    writeMappedPadding(file, position, header.pointsOffset);
+    for(size_t i = 0; i < m_trainPoints.size(); i++) {
+      float point[3] = { m_trainPoints[i].x, m_trainPoints[i].y, m_trainPoints[i].z };
+      file.write((const char *) point, sizeof(point));
+      position += sizeof(point);
+    }
+  }
+
+  writeMappedPadding(file, position, header.descriptorsOffset);
+  for(int i = 0; i < m_trainDescriptors.rows; i++) {
+    file.write((const char *) m_trainDescriptors.ptr(i), (std::streamsize) header.descriptorStep);
+    position += header.descriptorStep;
+  }
+
+  writeMappedPadding(file, position, header.imagesOffset);
+  if(!images.empty()) {
+    file.write((const char *) &images[0], (std::streamsize) (images.size() * sizeof(vpMappedImage)));
+    position += images.size() * sizeof(vpMappedImage);
+  }
+  for(std::vector<vpMappedImage>::const_iterator it = images.begin(); it != images.end(); ++it) {
+    writeMappedPadding(file, position, it->offset);
+    const vpImage<unsigned char> &I = m_mapOfImages[it->image_id];
+    file.write((const char *) I.bitmap, (std::streamsize) I.getSize());
+    position += I.getSize();
+  }
+  writeMappedPadding(file, position, header.fileSize);
+
+  if(!file) {
+    throw vpException(vpException::ioError, "Cannot write the file %s.", filename.c_str());
+  }
+  file.close();
+
+  saveIndex(m_index, filename);
+}
+
+/*!
+   Set the number of trees of the approximate nearest neighbour index. More trees improve the recall for a given
+   number of checks, at the cost of the memory and of the time to build the index.
+
+   \param nbTrees : Number of trees (4 by default).
+
+   \sa setUseIndex(), setIndexChecks()
+ */
+void vpKeyPoint::setIndexTrees(const int nbTrees) {
+  if(nbTrees != m_indexTrees) {
+    m_indexTrees = nbTrees;
+    buildIndex();
+  }
+}
+
+/*!
+   Set if the query descriptors are matched with an approximate nearest neighbour index of the train
+   descriptors instead of the matcher. For large training sets, the matching time becomes sublinear with the
+   number of train descriptors. Binary descriptors (ORB, BRISK, BRIEF...) are indexed with hierarchical
+   clustering trees and the Hamming distance, floating point descriptors (SIFT, SURF...) with a randomized k-d
+   forest and the L2 distance.
+
+   The index is built by buildReference() and loadLearningData(). saveLearningData() saves it next to the
+   learning file, with the \e .index extension, so that loadLearningData() loads it instead of building it again.
+   The trade-off between the recall and the matching time is set with setIndexChecks().
+
+   The matcher is still used when the train keypoints are matched to the query keypoints
+   (see setUseMatchTrainToQuery()).
+
+   \param useIndex : True to use the index.
+
+   \sa setIndexChecks(), setIndexTrees()
+ */
+void vpKeyPoint::setUseIndex(const bool useIndex) {
+  if(useIndex != m_useIndex) {
+    m_useIndex = useIndex;
+    buildIndex();
+  }
 }
 
 #if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x030000)
@@ -0,0 +1,136 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Memory mapping of the learning files of vpKeyPoint.
+ *
+ *****************************************************************************/
+
+#include <visp3/vision/vpKeyPoint.h>
+
+#if (VISP_HAVE_OPENCV_VERSION >= 0x020101)
+
+#include <fstream>
+
+#include <visp3/core/vpException.h>
+
+#if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#elif defined(_WIN32)
+#  include <windows.h>
+#endif
+
+/*
+  Map the learning file copy-on-write: the pages are shared with the page
+  cache and loaded on first access, and modifying the loaded data never
+  modifies the file.
+*/
+vpMappedLearningData::vpMappedLearningData(const std::string &filename)
+  : m_data(NULL), m_size(0), m_handle(NULL)
+{
+#if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw vpException(vpException::ioError, "Cannot open the file %s", filename.c_str());
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+    close(fd);
+    throw vpException(vpException::ioError, "Cannot get the size of the file %s", filename.c_str());
+  }
+  m_size = (size_t)st.st_size;
+  void *data = mmap(NULL, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    throw vpException(vpException::ioError, "Cannot map the file %s", filename.c_str());
+  }
+  m_data = (unsigned char *)data;
+#elif defined(_WIN32)
+  HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE) {
+    throw vpException(vpException::ioError, "Cannot open the file %s", filename.c_str());
+  }
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0) {
+    CloseHandle(file);
+    throw vpException(vpException::ioError, "Cannot get the size of the file %s", filename.c_str());
+  }
+  m_size = (size_t)size.QuadPart;
+  HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+  CloseHandle(file);
+  if (mapping == NULL) {
+    throw vpException(vpException::ioError, "Cannot map the file %s", filename.c_str());
+  }
+  m_data = (unsigned char *)MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+  if (m_data == NULL) {
+    CloseHandle(mapping);
+    throw vpException(vpException::ioError, "Cannot map the file %s", filename.c_str());
+  }
+  m_handle = mapping;
+#else
+  // No memory mapping: read the whole file at once
+  std::ifstream file(filename.c_str(), std::ifstream::binary);
+  if (!file.is_open()) {
+    throw vpException(vpException::ioError, "Cannot open the file %s", filename.c_str());
+  }
+  file.seekg(0, std::ios::end);
+  std::streamoff size = file.tellg();
+  if (size <= 0) {
+    throw vpException(vpException::ioError, "Cannot get the size of the file %s", filename.c_str());
+  }
+  m_size = (size_t)size;
+  m_data = new unsigned char[m_size];
+  file.seekg(0, std::ios::beg);
+  if (!file.read((char *)m_data, (std::streamsize)m_size)) {
+    delete [] m_data;
+    throw vpException(vpException::ioError, "Cannot read the file %s", filename.c_str());
+  }
+#endif
+}
+
+vpMappedLearningData::~vpMappedLearningData()
+{
+#if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
+  munmap(m_data, m_size);
+#elif defined(_WIN32)
+  UnmapViewOfFile(m_data);
+  CloseHandle((HANDLE)m_handle);
+#else
+  delete [] m_data;
+#endif
+}
+
+#elif !defined(VISP_BUILD_SHARED_LIBS)
+// Work around to avoid warning: libvisp_vision.a(vpMappedLearningData.cpp.o) has no symbols
+void dummy_vpMappedLearningData() {};
+#endif
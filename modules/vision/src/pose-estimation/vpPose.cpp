@@ -80,6 +80,8 @@ vpPose::init()
   ransacMaxTrials = 1000;
   ransacThreshold = 0.0001;
   ransacNbInlierConsensus = 4;
+  ransacNbTrials = 0;
+  ransacProbability = 0.99;
 
   residual = 0;
 #if (DEBUG_LEVEL1)
@@ -93,7 +95,8 @@ vpPose::vpPose()
   : npt(0), listP(), residual(0), lambda(0.25), vvsIterMax(200), c3d(),
     computeCovariance(false), covarianceMatrix(),
     ransacNbInlierConsensus(4), ransacMaxTrials(1000), ransacInliers(), ransacInlierIndex(), ransacThreshold(0.0001),
-    distanceToPlaneForCoplanarityTest(0.001), removeRansacDegeneratePoints(false)
+    distanceToPlaneForCoplanarityTest(0.001), removeRansacDegeneratePoints(false),
+    ransacNbTrials(0), ransacProbability(0.99), useParallelRansac(false), useRansacAdaptiveTermination(false)
 {
 #if (DEBUG_LEVEL1)
   std::cout << "begin vpPose::vpPose() " << std::endl ;
@@ -50,6 +50,7 @@
 #include <algorithm>    // std::count
 #include <float.h>      // DBL_MAX
 #include <map>
+#include <vector>
 
 #include <visp3/vision/vpPose.h>
 #include <visp3/core/vpColVector.h>
@@ -58,13 +59,334 @@
 #include <visp3/core/vpList.h>
 #include <visp3/vision/vpPoseException.h>
 #include <visp3/core/vpMath.h>
+#include <visp3/core/vpThreadPool.h>
 
 #define eps 1e-6
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+// Number of hypotheses evaluated by each thread per round of the parallel RANSAC
+const unsigned int vpRansacHypothesesPerThread = 8;
+
+// Contiguous copy of the coordinates of the points used to score the hypotheses
+struct vpRansacPoints
+{
+  std::vector<double> oX, oY, oZ, oW, x, y;
+
+  explicit vpRansacPoints(const std::vector<vpPoint> &points)
+    : oX(points.size()), oY(points.size()), oZ(points.size()), oW(points.size()), x(points.size()), y(points.size())
+  {
+    for (size_t i = 0; i < points.size(); i++) {
+      oX[i] = points[i].get_oX();
+      oY[i] = points[i].get_oY();
+      oZ[i] = points[i].get_oZ();
+      oW[i] = points[i].get_oW();
+      x[i] = points[i].get_x();
+      y[i] = points[i].get_y();
+    }
+  }
+
+  size_t size() const { return x.size(); }
+};
+
+// Minimal standard generator of Park and Miller, one per hypothesis so that
+// the samples don't depend on the number of threads
+class vpRansacRandom
+{
+public:
+  explicit vpRansacRandom(unsigned int trial)
+    : m_x((long)((trial * 2654435761UL) % 2147483646UL) + 1)
+  {
+    next();
+    next();
+  }
+
+  unsigned int operator()(unsigned int n)
+  {
+    return (unsigned int)((double)next() / 2147483647.0 * n) % n;
+  }
+
+private:
+  long next()
+  {
+    const long a = 16807, m = 2147483647, q = 127773, r = 2836;
+    long k = m_x / q;
+    m_x = a * (m_x - k * q) - k * r;
+    if (m_x < 0)
+      m_x += m;
+    return m_x;
+  }
+
+  long m_x;
+};
+
+// Squared reprojection error of each point for the pose cMo. The loop has no
+// branch so that it is vectorized on the contiguous coordinates.
+void squaredErrors(const vpRansacPoints &P, const vpHomogeneousMatrix &cMo, double *e)
+{
+  const double *M = cMo.data;
+  const size_t n = P.size();
+  if (n == 0)
+    return;
+  const double *oX = &P.oX[0], *oY = &P.oY[0], *oZ = &P.oZ[0], *oW = &P.oW[0];
+  const double *x = &P.x[0], *y = &P.y[0];
+  for (size_t i = 0; i < n; i++) {
+    const double X = M[0] * oX[i] + M[1] * oY[i] + M[2] * oZ[i] + M[3] * oW[i];
+    const double Y = M[4] * oX[i] + M[5] * oY[i] + M[6] * oZ[i] + M[7] * oW[i];
+    const double Z = M[8] * oX[i] + M[9] * oY[i] + M[10] * oZ[i] + M[11] * oW[i];
+    const double dx = X / Z - x[i];
+    const double dy = Y / Z - y[i];
+    e[i] = dx * dx + dy * dy;
+  }
+}
+
+// Sum of the squared reprojection errors, as vpPose::computeResidual(), and
+// number of points whose reprojection error is below the threshold. e is a
+// buffer of P.size() elements.
+unsigned int scorePose(const vpRansacPoints &P, const vpHomogeneousMatrix &cMo, double threshold, double *e,
+                       double &residual)
+{
+  squaredErrors(P, cMo, e);
+  unsigned int nbInliers = 0;
+  residual = 0;
+  for (size_t i = 0; i < P.size(); i++) {
+    residual += e[i];
+    if (sqrt(e[i]) < threshold)
+      nbInliers++;
+  }
+  return nbInliers;
+}
+
+// Index of the points whose reprojection error is below the threshold
+void findInliers(const vpRansacPoints &P, const vpHomogeneousMatrix &cMo, double threshold,
+                 std::vector<unsigned int> &consensus)
+{
+  std::vector<double> e(P.size());
+  squaredErrors(P, cMo, e.empty() ? NULL : &e[0]);
+  consensus.clear();
+  for (size_t i = 0; i < e.size(); i++) {
+    if (sqrt(e[i]) < threshold)
+      consensus.push_back((unsigned int)i);
+  }
+}
+
+// Poses scored in parallel, the results being stored by pose index
+struct vpPoseScoring
+{
+  const vpRansacPoints *P;
+  const std::vector<vpHomogeneousMatrix> *cMo;
+  double threshold;
+  double *residuals;
+  unsigned int *nbInliers;
+};
+
+void scorePoses(unsigned int begin, unsigned int end, void *arg)
+{
+  const vpPoseScoring &data = *static_cast<const vpPoseScoring *>(arg);
+  std::vector<double> e(data.P->size());
+  for (unsigned int k = begin; k < end; k++) {
+    data.nbInliers[k] = scorePose(*data.P, (*data.cMo)[k], data.threshold, e.empty() ? NULL : &e[0],
+                                  data.residuals[k]);
+  }
+}
+
+void scorePoses(const vpRansacPoints &P, const std::vector<vpHomogeneousMatrix> &cMo, double threshold,
+                std::vector<double> &residuals, std::vector<unsigned int> &nbInliers)
+{
+  residuals.resize(cMo.size());
+  nbInliers.resize(cMo.size());
+  if (cMo.empty())
+    return;
+
+  vpPoseScoring data;
+  data.P = &P;
+  data.cMo = &cMo;
+  data.threshold = threshold;
+  data.residuals = &residuals[0];
+  data.nbInliers = &nbInliers[0];
+  vpThreadPool::parallelFor(0, (unsigned int)cMo.size(), scorePoses, &data);
+}
+
+// Pose from a minimal set of points with Lagrange and Dementhon methods, the
+// one with the lowest residual being kept. Return false if both fail.
+bool computeMinimalPose(vpPose &poseMin, vpHomogeneousMatrix &cMo, double &r)
+{
+  vpHomogeneousMatrix cMo_lagrange, cMo_dementhon;
+  double r_lagrange = DBL_MAX, r_dementhon = DBL_MAX;
+  bool is_valid_lagrange = false, is_valid_dementhon = false;
+
+  try {
+    poseMin.computePose(vpPose::LAGRANGE, cMo_lagrange);
+    r_lagrange = poseMin.computeResidual(cMo_lagrange);
+    is_valid_lagrange = true;
+  } catch(...) {
+  }
+
+  try {
+    poseMin.computePose(vpPose::DEMENTHON, cMo_dementhon);
+    r_dementhon = poseMin.computeResidual(cMo_dementhon);
+    is_valid_dementhon = true;
+  } catch(...) {
+  }
+
+  //If residual returned is not a number (NAN), set valid to false
+  if (vpMath::isNaN(r_lagrange)) {
+    is_valid_lagrange = false;
+    r_lagrange = DBL_MAX;
+  }
+  if (vpMath::isNaN(r_dementhon)) {
+    is_valid_dementhon = false;
+    r_dementhon = DBL_MAX;
+  }
+
+  if (!is_valid_lagrange && !is_valid_dementhon)
+    return false;
+
+  if (r_lagrange < r_dementhon) {
+    r = r_lagrange;
+    cMo = cMo_lagrange;
+  }
+  else {
+    r = r_dementhon;
+    cMo = cMo_dementhon;
+  }
+  return true;
+}
+
+// Number of trials after which an outlier free sample of nbMinRandom points
+// has been drawn with the given probability, for the observed inlier ratio
+int adaptiveNbTrials(unsigned int nbInliers, unsigned int size, unsigned int nbMinRandom, double probability,
+                     int maxTrials)
+{
+  const double w = pow((double)nbInliers / (double)size, (double)nbMinRandom);
+  if (w >= 1.)
+    return 0;
+  if (w <= 0.)
+    return maxTrials;
+  const double n = ceil(log(1. - probability) / log(1. - w));
+  return (n < (double)maxTrials) ? (int)n : maxTrials;
+}
+
+// Hypotheses computed in parallel, the results being stored by trial index
+struct vpRansacData
+{
+  const std::vector<vpPoint> *points;
+  double threshold;
+  bool (*func)(vpHomogeneousMatrix *);
+  unsigned int firstTrial;
+  std::vector<unsigned char> valid; // Not std::vector<bool>, whose packed elements can't be written concurrently
+  std::vector<vpHomogeneousMatrix> cMo;
+};
+
+void computeHypotheses(unsigned int begin, unsigned int end, void *arg)
+{
+  vpRansacData &data = *static_cast<vpRansacData *>(arg);
+  const unsigned int size = (unsigned int)data.points->size();
+  const unsigned int nbMinRandom = 4;
+
+  for (unsigned int k = begin; k < end; k++) {
+    data.valid[k] = 0;
+
+    vpRansacRandom random(data.firstTrial + k);
+    unsigned int picked[nbMinRandom];
+    vpPose poseMin;
+    for (unsigned int i = 0; i < nbMinRandom; i++) {
+      bool used = true;
+      while (used) {
+        picked[i] = random(size);
+        used = false;
+        for (unsigned int j = 0; j < i; j++)
+          used = used || (picked[j] == picked[i]);
+      }
+      poseMin.addPoint((*data.points)[picked[i]]);
+    }
+
+    double r;
+    vpHomogeneousMatrix cMo;
+    if (!computeMinimalPose(poseMin, cMo, r))
+      continue;
+    r = sqrt(r) / (double)nbMinRandom;
+
+    if (data.func != NULL && !data.func(&cMo))
+      continue;
+
+    if (r < data.threshold) {
+      data.valid[k] = 1;
+      data.cMo[k] = cMo;
+    }
+  }
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Score several pose hypotheses against the points of the pose computation
+  list in one call.
+
+  \sa computeResiduals(const std::vector<vpPoint> &, const std::vector<vpHomogeneousMatrix> &, const double, std::vector<double> &, std::vector<unsigned int> &)
+*/
+void vpPose::computeResiduals(const std::vector<vpHomogeneousMatrix> &cMo, const double threshold,
+                              std::vector<double> &residuals, std::vector<unsigned int> &nbInliers) const
+{
+  computeResiduals(std::vector<vpPoint>(listP.begin(), listP.end()), cMo, threshold, residuals, nbInliers);
+}
+
+/*!
+  Score several pose hypotheses against a set of points in one call.
+
+  The coordinates of the points are copied once in a contiguous layout, the
+  projection of all the points is vectorized and the poses are scored in
+  parallel with vpThreadPool. This is the function used by poseRansac() to
+  score its hypotheses.
+
+  \code
+#include <visp3/vision/vpPose.h>
+
+int main()
+{
+  std::vector<vpPoint> points;
+  std::vector<vpHomogeneousMatrix> hypotheses;
+  // Fill the object and normalized image coordinates of the points
+  // and the candidate poses
+  // ...
+  std::vector<double> residuals;
+  std::vector<unsigned int> nbInliers;
+  vpPose::computeResiduals(points, hypotheses, 0.001, residuals, nbInliers);
+}
+  \endcode
+
+  \param points : Points with their coordinates in the object frame and their
+  normalized coordinates in the image.
+  \param cMo : Poses to score.
+  \param threshold : Maximal reprojection error, in meter, of an inlier.
+  \param residuals : For each pose, sum of the squared reprojection errors of
+  the points in meter, as computed by computeResidual().
+  \param nbInliers : For each pose, number of points whose reprojection error
+  is below \e threshold.
+*/
+void vpPose::computeResiduals(const std::vector<vpPoint> &points, const std::vector<vpHomogeneousMatrix> &cMo,
+                              const double threshold, std::vector<double> &residuals,
+                              std::vector<unsigned int> &nbInliers)
+{
+  const vpRansacPoints P(points);
+  scorePoses(P, cMo, threshold, residuals, nbInliers);
+}
 
 /*! 
   Compute the pose using the Ransac approach. 
  
+  By default the hypotheses are evaluated sequentially until
+  ransacNbInlierConsensus inliers are found or ransacMaxTrials trials are
+  done. Two options change this behavior:
+  - setUseParallelRansac() evaluates the hypotheses in parallel with
+    vpThreadPool. Each hypothesis draws its points with its own random
+    generator, seeded from its trial index, so that the result doesn't
+    depend on the number of threads. In that case \e func is called
+    concurrently and must be thread-safe.
+  - setUseRansacAdaptiveTermination() stops as soon as the number of trials
+    ensures, with the probability set by setRansacProbability(), that an
+    outlier free sample was drawn given the best inlier ratio found so far.
+
   \param cMo : Computed pose
   \param func : Pointer to a function that takes in parameter a vpHomogeneousMatrix
   and returns true if the pose check is OK or false otherwise
@@ -74,18 +396,14 @@ bool vpPose::poseRansac(vpHomogeneousMatrix & cMo, bool (*func)(vpHomogeneousMat
 {  
   ransacInliers.clear();
   ransacInlierIndex.clear();
+  ransacNbTrials = 0;
 
-  srand(0); //Fix seed here so we will have the same pseudo-random series at each run.
   std::vector<unsigned int> best_consensus;
-  std::vector<unsigned int> cur_consensus;
-  std::vector<unsigned int> cur_outliers;
-  std::vector<unsigned int> cur_randoms;
+  vpHomogeneousMatrix best_cMo;
   int nbTrials = 0;
   unsigned int nbMinRandom = 4 ;
   unsigned int nbInliers = 0;
-  double r, r_lagrange, r_dementhon;
-
-  vpHomogeneousMatrix cMo_lagrange, cMo_dementhon;
+  double r;
 
   if (listP.size() < 4) {
     //vpERROR_TRACE("Not enough point to compute the pose");
@@ -93,27 +411,28 @@ bool vpPose::poseRansac(vpHomogeneousMatrix & cMo, bool (*func)(vpHomogeneousMat
                           "Not enough point to compute the pose")) ;
   }
 
-  //Remove potential degenerate points
-  std::list<vpPoint> listOfUniquePoints;
+  //Remove potential degenerate points, the comparisons being done on a
+  //contiguous copy of the coordinates
+  const vpRansacPoints allPoints(std::vector<vpPoint>(listP.begin(), listP.end()));
+  std::vector<vpPoint> listOfUniquePoints;
+  std::vector<size_t> uniquePointIndex;
   std::map<size_t, size_t> mapOfUniquePointIndex;
   size_t index_pt = 0;
   for(std::list<vpPoint>::const_iterator it1 = listP.begin(); it1 != listP.end(); ++it1, index_pt++) {
-    vpPoint ptdeg = *it1;
-
     bool degenerate = false;
-    for(std::list<vpPoint>::const_iterator it2 = listOfUniquePoints.begin(); it2 != listOfUniquePoints.end(); ++it2) {
-      vpPoint pt = *it2;
-
-      if( ((fabs(pt.get_x() - ptdeg.get_x()) < 1e-6) && (fabs(pt.get_y() - ptdeg.get_y()) < 1e-6))  ||
-          ((fabs(pt.get_oX() - ptdeg.get_oX()) < 1e-6) && (fabs(pt.get_oY() - ptdeg.get_oY()) < 1e-6) &&
-              (fabs(pt.get_oZ() - ptdeg.get_oZ()) < 1e-6))) {
+    for(size_t k = 0; k < uniquePointIndex.size(); k++) {
+      const size_t j = uniquePointIndex[k];
+      if( ((fabs(allPoints.x[j] - allPoints.x[index_pt]) < 1e-6) && (fabs(allPoints.y[j] - allPoints.y[index_pt]) < 1e-6))  ||
+          ((fabs(allPoints.oX[j] - allPoints.oX[index_pt]) < 1e-6) && (fabs(allPoints.oY[j] - allPoints.oY[index_pt]) < 1e-6) &&
+              (fabs(allPoints.oZ[j] - allPoints.oZ[index_pt]) < 1e-6))) {
         degenerate = true;
         break;
       }
     }
 
     if(!degenerate) {
-      listOfUniquePoints.push_back(ptdeg);
+      listOfUniquePoints.push_back(*it1);
+      uniquePointIndex.push_back(index_pt);
       mapOfUniquePointIndex[listOfUniquePoints.size()-1] = index_pt;
     }
   }
@@ -127,235 +446,147 @@ bool vpPose::poseRansac(vpHomogeneousMatrix & cMo, bool (*func)(vpHomogeneousMat
 
   if(removeRansacDegeneratePoints) {
     //Remove duplicate points in listP
-    listP = listOfUniquePoints;
+    listP.assign(listOfUniquePoints.begin(), listOfUniquePoints.end());
   }
 
-
+  const vpRansacPoints uniquePoints(listOfUniquePoints);
+  int maxTrials = ransacMaxTrials;
   bool foundSolution = false;
-  
-  while (nbTrials < ransacMaxTrials && nbInliers < (unsigned)ransacNbInlierConsensus)
-  {
-    //Hold the list of the index of the inliers (points in the consensus set)
-    cur_consensus.clear();
-
-    //Use a temporary variable because if not, the cMo passed in parameters will be modified when
-    // we compute the pose for the minimal sample sets but if the pose is not correct when we pass
-    // a function pointer we do not want to modify the cMo passed in parameters
-    vpHomogeneousMatrix cMo_tmp;
-    cur_outliers.clear();
-    cur_randoms.clear();
-    
-    //Vector of used points, initialized at false for all points
-    std::vector<bool> usedPt(size, false);
-    
-    vpPose poseMin;
-    for(unsigned int i = 0; i < nbMinRandom;)
+
+  if (useParallelRansac) {
+    vpRansacData data;
+    data.points = &listOfUniquePoints;
+    data.threshold = ransacThreshold;
+    data.func = func;
+    const unsigned int nbHypothesesPerRound = vpRansacHypothesesPerThread * vpThreadPool::getNumThreads();
+    data.valid.resize(nbHypothesesPerRound);
+    data.cMo.resize(nbHypothesesPerRound);
+
+    std::vector<vpHomogeneousMatrix> hypotheses;
+    std::vector<double> residuals;
+    std::vector<unsigned int> nbInliersHypotheses;
+    while (nbTrials < maxTrials && nbInliers < (unsigned)ransacNbInlierConsensus)
     {
-      if((size_t) std::count(usedPt.begin(), usedPt.end(), true) == usedPt.size()) {
-        //All points was picked once, break otherwise we stay in an infinite loop
-        break;
+      const unsigned int nbHypotheses = std::min(nbHypothesesPerRound, (unsigned int)(maxTrials - nbTrials));
+      data.firstTrial = (unsigned int)nbTrials;
+      vpThreadPool::parallelFor(0, nbHypotheses, computeHypotheses, &data);
+
+      //Score the valid hypotheses of the round in one call
+      hypotheses.clear();
+      for (unsigned int k = 0; k < nbHypotheses; k++) {
+        if (data.valid[k])
+          hypotheses.push_back(data.cMo[k]);
       }
+      scorePoses(uniquePoints, hypotheses, ransacThreshold, residuals, nbInliersHypotheses);
 
-      //Pick a point randomly
-      unsigned int r_ = (unsigned int) rand() % size;
-      while(usedPt[r_]) {
-        //If already picked, pick another point randomly
-        r_ = (unsigned int) rand() % size;
+      //Merge the results in the order of the trials, as the sequential loop does
+      unsigned int h = 0;
+      for (unsigned int k = 0; k < nbHypotheses && nbTrials < maxTrials && nbInliers < (unsigned)ransacNbInlierConsensus; k++) {
+        nbTrials++;
+        if (!data.valid[k])
+          continue;
+        if (nbInliersHypotheses[h] > nbInliers) {
+          foundSolution = true;
+          nbInliers = nbInliersHypotheses[h];
+          best_cMo = hypotheses[h];
+          if (useRansacAdaptiveTermination)
+            maxTrials = std::min(maxTrials, adaptiveNbTrials(nbInliers, size, nbMinRandom, ransacProbability, ransacMaxTrials));
+        }
+        h++;
       }
-      //Mark this point as already picked
-      usedPt[r_] = true;
-      
-      std::list<vpPoint>::const_iterator iter = listOfUniquePoints.begin();
-      std::advance(iter, r_);
-      vpPoint pt = *iter;
-      
-      poseMin.addPoint(pt);
-      cur_randoms.push_back(r_);
-      //Increment the number of points picked
-      i++;
-
-//      bool degenerate = false;
-//      for(std::list<vpPoint>::const_iterator it = poseMin.listP.begin(); it != poseMin.listP.end(); ++it){
-//        vpPoint ptdeg = *it;
-//        if( ((fabs(pt.get_x() - ptdeg.get_x()) < 1e-6) && (fabs(pt.get_y() - ptdeg.get_y()) < 1e-6))  ||
-//            ((fabs(pt.get_oX() - ptdeg.get_oX()) < 1e-6) && (fabs(pt.get_oY() - ptdeg.get_oY()) < 1e-6) && (fabs(pt.get_oZ() - ptdeg.get_oZ()) < 1e-6))){
-//          degenerate = true;
-//          break;
-//        }
-//      }
-//      if(!degenerate) {
-//        poseMin.addPoint(pt);
-//        cur_randoms.push_back(r_);
-//        //Increment the number of points picked
-//        i++;
-//      }
     }
 
-    if(poseMin.npt < nbMinRandom) {
-      nbTrials++;
-      continue;
-    }
-
-    //Flags set if pose computation is OK
-    bool is_valid_lagrange = false;
-    bool is_valid_dementhon = false;
-
-    //Set maximum value for residuals
-    r_lagrange = DBL_MAX;
-    r_dementhon = DBL_MAX;
-
-    try {
-      poseMin.computePose(vpPose::LAGRANGE, cMo_lagrange);
-      r_lagrange = poseMin.computeResidual(cMo_lagrange);
-      is_valid_lagrange = true;
-    } catch(/*vpException &e*/...) {
-//      std::cerr << e.what() << std::endl;
+    if (foundSolution) {
+      cMo = best_cMo;
+      findInliers(uniquePoints, best_cMo, ransacThreshold, best_consensus);
     }
+  }
+  else {
+    //Squared reprojection errors of the current hypothesis
+    std::vector<double> errors(size);
+    srand(0); //Fix seed here so we will have the same pseudo-random series at each run.
+    while (nbTrials < maxTrials && nbInliers < (unsigned)ransacNbInlierConsensus)
+    {
+      //Use a temporary variable because if not, the cMo passed in parameters will be modified when
+      // we compute the pose for the minimal sample sets but if the pose is not correct when we pass
+      // a function pointer we do not want to modify the cMo passed in parameters
+      vpHomogeneousMatrix cMo_tmp;
 
-    try {
-      poseMin.computePose(vpPose::DEMENTHON, cMo_dementhon);
-      r_dementhon = poseMin.computeResidual(cMo_dementhon);
-      is_valid_dementhon = true;
-    } catch(/*vpException &e*/...) {
-//      std::cerr << e.what() << std::endl;
-    }
+      //Vector of used points, initialized at false for all points
+      std::vector<bool> usedPt(size, false);
 
-    //If residual returned is not a number (NAN), set valid to false
-    if(vpMath::isNaN(r_lagrange)) {
-      is_valid_lagrange = false;
-      r_lagrange = DBL_MAX;
-    }
+      vpPose poseMin;
+      for(unsigned int i = 0; i < nbMinRandom;)
+      {
+        if((size_t) std::count(usedPt.begin(), usedPt.end(), true) == usedPt.size()) {
+          //All points was picked once, break otherwise we stay in an infinite loop
+          break;
+        }
 
-    if(vpMath::isNaN(r_dementhon)) {
-      is_valid_dementhon = false;
-      r_dementhon = DBL_MAX;
-    }
+        //Pick a point randomly
+        unsigned int r_ = (unsigned int) rand() % size;
+        while(usedPt[r_]) {
+          //If already picked, pick another point randomly
+          r_ = (unsigned int) rand() % size;
+        }
+        //Mark this point as already picked
+        usedPt[r_] = true;
 
-    //If at least one pose computation is OK,
-    //we can continue, otherwise pick another random set
-    if(is_valid_lagrange || is_valid_dementhon) {
-      if (r_lagrange < r_dementhon) {
-        r = r_lagrange;
-//        cMo = cMo_lagrange;
-        cMo_tmp = cMo_lagrange;
-      }
-      else {
-        r = r_dementhon;
-//        cMo = cMo_dementhon;
-        cMo_tmp = cMo_dementhon;
+        poseMin.addPoint(listOfUniquePoints[r_]);
+        //Increment the number of points picked
+        i++;
       }
-      r = sqrt(r) / (double) nbMinRandom;
 
-      //Filter the pose using some criterion (orientation angles, translations, etc.)
-      bool isPoseValid = true;
-      if(func != NULL) {
-        isPoseValid = func(&cMo_tmp);
-        if(isPoseValid) {
-          cMo = cMo_tmp;
-        }
-      } else {
-        //No post filtering on pose, so copy cMo_temp to cMo
-        cMo = cMo_tmp;
+      nbTrials++;
+      if(poseMin.npt < nbMinRandom) {
+        continue;
       }
 
-      if (isPoseValid && r < ransacThreshold)
-      {
-        unsigned int nbInliersCur = 0;
-        unsigned int iter = 0;
-        for (std::list<vpPoint>::const_iterator it = listOfUniquePoints.begin(); it != listOfUniquePoints.end(); ++it)
-        {
-          vpPoint pt = *it;
-          vpPoint p(pt) ;
-          p.track(cMo) ;
-
-          double d = vpMath::sqr(p.get_x() - pt.get_x()) + vpMath::sqr(p.get_y() - pt.get_y()) ;
-          double error = sqrt(d) ;
-          if(error < ransacThreshold) {
-            // the point is considered as inlier if the error is below the threshold
-            nbInliersCur++;
-            cur_consensus.push_back(iter);
-
-//            // But, we need also to check if it is not a degenerate point
-//            bool degenerate = false;
-//
-//            for(unsigned int it_inlier_index = 0; it_inlier_index< cur_consensus.size(); it_inlier_index++){
-//              std::list<vpPoint>::const_iterator it_point = listP.begin();
-//              std::advance(it_point, cur_consensus[it_inlier_index]);
-//              pt = *it_point;
-//
-//              vpPoint ptdeg = *it;
-//              if( ((fabs(pt.get_x() - ptdeg.get_x()) < 1e-6) && (fabs(pt.get_y() - ptdeg.get_y()) < 1e-6))  ||
-//                  ((fabs(pt.get_oX() - ptdeg.get_oX()) < 1e-6) && (fabs(pt.get_oY() - ptdeg.get_oY()) < 1e-6)
-//                      && (fabs(pt.get_oZ() - ptdeg.get_oZ()) < 1e-6))){
-//                degenerate = true;
-//                break;
-//              }
-//            }
-//
-//            if(!degenerate) {
-//              nbInliersCur++;
-//              cur_consensus.push_back(iter);
-//            }
-//            else {
-//              cur_outliers.push_back(iter);
-//            }
+      //If at least one pose computation is OK,
+      //we can continue, otherwise pick another random set
+      if(computeMinimalPose(poseMin, cMo_tmp, r)) {
+        r = sqrt(r) / (double) nbMinRandom;
+
+        //Filter the pose using some criterion (orientation angles, translations, etc.)
+        bool isPoseValid = true;
+        if(func != NULL) {
+          isPoseValid = func(&cMo_tmp);
+          if(isPoseValid) {
+            cMo = cMo_tmp;
           }
-          else {
-            cur_outliers.push_back(iter);
-          }
-
-          iter++;
+        } else {
+          //No post filtering on pose, so copy cMo_temp to cMo
+          cMo = cMo_tmp;
         }
 
-        if(nbInliersCur > nbInliers)
+        if (isPoseValid && r < ransacThreshold)
         {
-          foundSolution = true;
-          best_consensus = cur_consensus;
-          nbInliers = nbInliersCur;
-        }
-
-        nbTrials++;
-        
-        if(nbTrials >= ransacMaxTrials) {
-//          vpERROR_TRACE("Ransac reached the maximum number of trials");
-          foundSolution = true;
-        }
-      }
-      else {
-        nbTrials++;
+          double residual_;
+          unsigned int nbInliersCur = scorePose(uniquePoints, cMo, ransacThreshold, &errors[0], residual_);
+
+          if(nbInliersCur > nbInliers)
+          {
+            foundSolution = true;
+            best_cMo = cMo;
+            nbInliers = nbInliersCur;
+            if (useRansacAdaptiveTermination)
+              maxTrials = std::min(maxTrials, adaptiveNbTrials(nbInliers, size, nbMinRandom, ransacProbability, ransacMaxTrials));
+          }
 
-        if(nbTrials >= ransacMaxTrials) {
-//          vpERROR_TRACE("Ransac reached the maximum number of trials");
+          if(nbTrials >= maxTrials) {
+            foundSolution = true;
+          }
         }
       }
-    } else {
-      nbTrials++;
-
-      if(nbTrials >= ransacMaxTrials) {
-//        vpERROR_TRACE("Ransac reached the maximum number of trials");
-      }
     }
+
+    //The consensus set is only built for the best hypothesis
+    if (nbInliers > 0)
+      findInliers(uniquePoints, best_cMo, ransacThreshold, best_consensus);
   }
-    
+  ransacNbTrials = (unsigned int)nbTrials;
+
   if(foundSolution) {
-//    std::cout << "Nombre d'inliers " << nbInliers << std::endl ;
-    
-    //Display the random picked points
-    /*
-    std::cout << "Randoms : "; 
-    for(unsigned int i = 0 ; i < cur_randoms.size() ; i++)
-      std::cout << cur_randoms[i] << " ";
-    std::cout << std::endl;
-    */
-    
-    //Display the outliers
-    /*
-    std::cout << "Outliers : "; 
-    for(unsigned int i = 0 ; i < cur_outliers.size() ; i++)
-      std::cout << cur_outliers[i] << " ";
-    std::cout << std::endl;
-    */
-    
     //Even if the cardinality of the best consensus set is inferior to ransacNbInlierConsensus,
     //we want to refine the solution with data in best_consensus and return this pose.
     //This is an approach used for example in p118 in Multiple View Geometry in Computer Vision, Hartley, R.~I. and Zisserman, A.
@@ -365,9 +596,7 @@ bool vpPose::poseRansac(vpHomogeneousMatrix & cMo, bool (*func)(vpHomogeneousMat
       vpPose pose ;
       for(unsigned i = 0 ; i < best_consensus.size(); i++)
       {
-        std::list<vpPoint>::const_iterator iter = listOfUniquePoints.begin();
-        std::advance(iter, best_consensus[i]);
-        vpPoint pt = *iter;
+        const vpPoint &pt = listOfUniquePoints[best_consensus[i]];
       
         pose.addPoint(pt) ;
         ransacInliers.push_back(pt);
@@ -383,49 +612,7 @@ bool vpPose::poseRansac(vpHomogeneousMatrix & cMo, bool (*func)(vpHomogeneousMat
         }
       }
 
-      //Flags set if pose computation is OK
-      bool is_valid_lagrange = false;
-      bool is_valid_dementhon = false;
-
-      //Set maximum value for residuals
-      r_lagrange = DBL_MAX;
-      r_dementhon = DBL_MAX;
-
-      try {
-        pose.computePose(vpPose::LAGRANGE, cMo_lagrange);
-        r_lagrange = pose.computeResidual(cMo_lagrange);
-        is_valid_lagrange = true;
-      } catch(/*vpException &e*/...) {
-//        std::cerr << e.what() << std::endl;
-      }
-
-      try {
-        pose.computePose(vpPose::DEMENTHON, cMo_dementhon);
-        r_dementhon = pose.computeResidual(cMo_dementhon);
-        is_valid_dementhon = true;
-      } catch(/*vpException &e*/...) {
-//        std::cerr << e.what() << std::endl;
-      }
-
-      //If residual returned is not a number (NAN), set valid to false
-      if(vpMath::isNaN(r_lagrange)) {
-        is_valid_lagrange = false;
-        r_lagrange = DBL_MAX;
-      }
-
-      if(vpMath::isNaN(r_dementhon)) {
-        is_valid_dementhon = false;
-        r_dementhon = DBL_MAX;
-      }
-
-      if(is_valid_lagrange || is_valid_dementhon) {
-        if (r_lagrange < r_dementhon) {
-          cMo = cMo_lagrange;
-        }
-        else {
-          cMo = cMo_dementhon;
-        }
-
+      if(computeMinimalPose(pose, cMo, r)) {
         pose.setCovarianceComputation(computeCovariance);
         pose.computePose(vpPose::VIRTUAL_VS, cMo);
 
@@ -418,6 +418,84 @@ int main(int argc, const char ** argv) {
       }
 
 
+      //Save in mapped binary with training images
+      filename = vpIoTools::createFilePath(opath, "mapped_with_img");
+      vpIoTools::makeDirectory(filename);
+      filename = vpIoTools::createFilePath(filename, "test_save_in_mapped_with_img.bin");
+      keyPoints.saveLearningData(filename, vpKeyPoint::mappedLearningDataFormat, true);
+
+      //Test if save is ok
+      if(!vpIoTools::checkFilename(filename)) {
+        std::stringstream ss;
+        ss << "Problem when saving file=" << filename;
+        throw vpException(vpException::ioError, ss.str().c_str());
+      }
+
+      //Test if read is ok, twice to check the release of the previous mapping
+      vpKeyPoint read_keypoint_mapped;
+      read_keypoint_mapped.loadLearningData(filename, true);
+      read_keypoint_mapped.loadLearningData(filename, true);
+      trainKeyPoints_read.clear();
+      read_keypoint_mapped.getTrainKeyPoints(trainKeyPoints_read);
+      trainDescriptors_read = read_keypoint_mapped.getTrainDescriptors();
+
+      if(!compareKeyPoints(trainKeyPoints, trainKeyPoints_read)) {
+        throw vpException(vpException::fatalError, "Problem with trainKeyPoints when reading learning file saved in "
+            "mapped binary with train images !");
+      }
+
+      if(!compareDescriptors(trainDescriptors, trainDescriptors_read)) {
+        throw vpException(vpException::fatalError, "Problem with trainDescriptors when reading learning file saved in "
+            "mapped binary with train images !");
+      }
+
+      if(read_keypoint_mapped.getNbImages() != keyPoints.getNbImages()) {
+        throw vpException(vpException::fatalError, "Problem with the training images when reading learning file saved in "
+            "mapped binary with train images !");
+      }
+
+      //Test append
+      read_keypoint_mapped.loadLearningData(filename, true, true);
+      if(read_keypoint_mapped.getTrainDescriptors().rows != 2*trainDescriptors.rows) {
+        throw vpException(vpException::fatalError, "Problem with trainDescriptors when appending learning file saved in "
+            "mapped binary !");
+      }
+
+
+      //Save with the approximate nearest neighbour index
+      vpKeyPoint keyPoints_index;
+      keyPoints_index.setDetector(keypointName);
+      keyPoints_index.setExtractor(keypointName);
+      keyPoints_index.setUseIndex(true);
+      keyPoints_index.buildReference(I);
+
+      filename = vpIoTools::createFilePath(opath, "mapped_with_index");
+      vpIoTools::makeDirectory(filename);
+      filename = vpIoTools::createFilePath(filename, "test_save_in_mapped_with_index.bin");
+      keyPoints_index.saveLearningData(filename, vpKeyPoint::mappedLearningDataFormat, false);
+
+      //Test if save is ok
+      if(!vpIoTools::checkFilename(filename) || !vpIoTools::checkFilename(filename + ".index")) {
+        std::stringstream ss;
+        ss << "Problem when saving file=" << filename << " with its index";
+        throw vpException(vpException::ioError, ss.str().c_str());
+      }
+
+      //Test if the matching with the loaded index is ok
+      vpKeyPoint read_keypoint_index;
+      read_keypoint_index.setDetector(keypointName);
+      read_keypoint_index.setExtractor(keypointName);
+      read_keypoint_index.setUseIndex(true);
+      read_keypoint_index.loadLearningData(filename, true);
+      unsigned int nbMatches = read_keypoint_index.matchPoint(I);
+      if(nbMatches < trainKeyPoints.size() / 2) {
+        std::stringstream ss;
+        ss << "Problem with the matching using the index: " << nbMatches << " matches for "
+           << trainKeyPoints.size() << " train keypoints !";
+        throw vpException(vpException::fatalError, ss.str().c_str());
+      }
+
+
 #if defined(VISP_HAVE_XML2)
       //Save in xml with training images
       filename = vpIoTools::createFilePath(opath, "xml_with_img");
@@ -52,11 +52,20 @@
 #include <visp3/core/vpIoTools.h>
 #include <visp3/io/vpParseArgv.h>
 
+#include <algorithm>
+
+#ifdef VISP_HAVE_OPENMP
+#  include <omp.h>
+#endif
+
 // List of allowed command line options
 #define GETOPTARGS	"cdh"
 
 void usage(const char *name, const char *badparam);
 bool getOptions(int argc, const char **argv, bool &click_allowed, bool &display);
+void sortByPosition(std::vector<cv::KeyPoint> &keyPoints, cv::Mat &descriptors);
+void checkBands(const vpImage<unsigned char> &I);
+void checkBlockMatching(const vpImage<unsigned char> &Iref, const vpImage<unsigned char> &Iquery);
 
 /*!
 
@@ -130,6 +139,117 @@ bool getOptions(int argc, const char **argv, bool &click_allowed, bool &display)
   return true;
 }
 
+//Order of the keypoints by position
+class vpKeyPointPositionLess {
+public:
+  explicit vpKeyPointPositionLess(const std::vector<cv::KeyPoint> &keyPoints) : m_keyPoints(keyPoints) {}
+  bool operator()(const size_t i, const size_t j) const {
+    const cv::Point2f &pi = m_keyPoints[i].pt, &pj = m_keyPoints[j].pt;
+    return pi.y < pj.y || (pi.y == pj.y && pi.x < pj.x);
+  }
+
+private:
+  const std::vector<cv::KeyPoint> &m_keyPoints;
+};
+
+void sortByPosition(std::vector<cv::KeyPoint> &keyPoints, cv::Mat &descriptors) {
+  std::vector<size_t> order(keyPoints.size());
+  for(size_t i = 0; i < order.size(); i++) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), vpKeyPointPositionLess(keyPoints));
+
+  std::vector<cv::KeyPoint> sortedKeyPoints(keyPoints.size());
+  cv::Mat sortedDescriptors(descriptors.rows, descriptors.cols, descriptors.type());
+  for(size_t i = 0; i < order.size(); i++) {
+    sortedKeyPoints[i] = keyPoints[order[i]];
+    descriptors.row((int) order[i]).copyTo(sortedDescriptors.row((int) i));
+  }
+  keyPoints = sortedKeyPoints;
+  descriptors = sortedDescriptors;
+}
+
+/*!
+  Check that the keypoints detected and the descriptors extracted in bands are the same than on the whole image. The
+  FAST detector and the ORB extractor only look at a neighbourhood smaller than the overlap of the bands.
+*/
+void checkBands(const vpImage<unsigned char> &I) {
+  vpKeyPoint keypoints("FAST", "ORB", "BruteForce-Hamming");
+  keypoints.buildReference(I);
+  std::vector<cv::KeyPoint> keyPoints;
+  keypoints.getTrainKeyPoints(keyPoints);
+  cv::Mat descriptors = keypoints.getTrainDescriptors();
+  sortByPosition(keyPoints, descriptors);
+
+  vpKeyPoint keypoints_bands("FAST", "ORB", "BruteForce-Hamming");
+  keypoints_bands.setDetectionBands(4);
+  keypoints_bands.buildReference(I);
+  std::vector<cv::KeyPoint> keyPointsBands;
+  keypoints_bands.getTrainKeyPoints(keyPointsBands);
+  cv::Mat descriptorsBands = keypoints_bands.getTrainDescriptors();
+  sortByPosition(keyPointsBands, descriptorsBands);
+
+  std::cout << "Detect " << keyPointsBands.size() << " / " << keyPoints.size() << " keypoints with 4 bands." << std::endl;
+  if(keyPoints.empty() || keyPointsBands.size() != keyPoints.size()) {
+    throw vpException(vpException::fatalError, "The keypoints detected in bands differ from the whole image !");
+  }
+  for(size_t i = 0; i < keyPoints.size(); i++) {
+    if(keyPointsBands[i].pt != keyPoints[i].pt || keyPointsBands[i].angle != keyPoints[i].angle
+       || cv::norm(descriptorsBands.row((int) i), descriptors.row((int) i), cv::NORM_HAMMING) != 0) {
+      throw vpException(vpException::fatalError, "The keypoints extracted in bands differ from the whole image !");
+    }
+  }
+}
+
+/*!
+  Check that the query descriptors matched by blocks, in parallel when ViSP is built with OpenMP, get the same matches
+  than with a single matcher.
+*/
+void checkBlockMatching(const vpImage<unsigned char> &Iref, const vpImage<unsigned char> &Iquery) {
+#ifdef VISP_HAVE_OPENMP
+  int nbThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+#endif
+
+  vpKeyPoint::vpFilterMatchingType filterTypes[2] = { vpKeyPoint::ratioDistanceThreshold,
+                                                      vpKeyPoint::constantFactorDistanceThreshold };
+  for(int f = 0; f < 2; f++) {
+    vpKeyPoint keypoints("FAST", "ORB", "BruteForce-Hamming", filterTypes[f]);
+    keypoints.buildReference(Iref);
+    cv::Mat trainDescriptors = keypoints.getTrainDescriptors();
+
+    std::vector<cv::KeyPoint> queryKeyPoints;
+    cv::Mat queryDescriptors;
+    double elapsedTime;
+    keypoints.detect(Iquery, queryKeyPoints, elapsedTime);
+    keypoints.extract(Iquery, queryKeyPoints, queryDescriptors, elapsedTime);
+
+    std::vector<cv::DMatch> matches;
+    keypoints.match(trainDescriptors, queryDescriptors, matches, elapsedTime);
+
+    //The first of the k nearest neighbours is kept
+    cv::Ptr<cv::DescriptorMatcher> matcher = cv::DescriptorMatcher::create("BruteForce-Hamming");
+    std::vector<std::vector<cv::DMatch> > knnMatches;
+    matcher->knnMatch(queryDescriptors, trainDescriptors, knnMatches, f == 0 ? 2 : 1);
+
+    //At least 2 blocks of 256 query descriptors
+    std::cout << "Match " << queryDescriptors.rows << " query descriptors by blocks." << std::endl;
+    if(queryDescriptors.rows < 512 || matches.size() != knnMatches.size()) {
+      throw vpException(vpException::fatalError, "Problem with the matching by blocks !");
+    }
+    for(size_t i = 0; i < matches.size(); i++) {
+      const cv::DMatch &m = matches[i], &ref = knnMatches[i].front();
+      if(m.queryIdx != ref.queryIdx || m.trainIdx != ref.trainIdx || m.distance != ref.distance) {
+        throw vpException(vpException::fatalError, "The matching by blocks differs from a single matcher !");
+      }
+    }
+  }
+
+#ifdef VISP_HAVE_OPENMP
+  omp_set_num_threads(nbThreads);
+#endif
+}
+
 /*!
   \example testKeyPoint.cpp
 
@@ -168,6 +288,17 @@ int main(int argc, const char ** argv) {
     vpKeyPoint keypoints("ORB", "ORB", "BruteForce-Hamming");
     std::cout << "Build " << keypoints.buildReference(Iref) << " reference points." << std::endl;
 
+    //Detect and extract in horizontal bands, and match by blocks, on the reference image tiled twice in each
+    //direction to get enough keypoints
+    vpImage<unsigned char> Itiled(2*Iref.getHeight(), 2*Iref.getWidth());
+    for(unsigned int i = 0; i < 2; i++) {
+      for(unsigned int j = 0; j < 2; j++) {
+        Itiled.insert(Iref, vpImagePoint(i*Iref.getHeight(), j*Iref.getWidth()));
+      }
+    }
+    checkBands(Itiled);
+    checkBlockMatching(Iref, Itiled);
+
     vpVideoReader g;
     g.setFileName(filenameCur);
     g.open(Icur);
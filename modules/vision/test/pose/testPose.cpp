@@ -196,6 +196,24 @@ int main()
     fail = compare_pose(pose, cMo_ref, cMo, "pose by Lagrange than by VVS");
     test_fail |= fail;
 
+    // Score the reference pose and a perturbed one in one call
+    std::cout <<"-------------------------------------------------"<<std::endl ;
+    std::vector<vpHomogeneousMatrix> hypotheses;
+    hypotheses.push_back(cMo_ref);
+    hypotheses.push_back(vpHomogeneousMatrix(0.05, 0, 0, 0, 0, 0) * cMo_ref);
+    std::vector<double> residuals;
+    std::vector<unsigned int> nbInliers;
+    pose.computeResiduals(hypotheses, 0.01, residuals, nbInliers);
+    fail = 0;
+    for (size_t i = 0; i < hypotheses.size(); i++) {
+      if (std::fabs(residuals[i] - pose.computeResidual(hypotheses[i])) > 1e-12)
+        fail = 1;
+    }
+    if (nbInliers[0] != pose.listP.size() || nbInliers[1] != 0)
+      fail = 1;
+    std::cout << "Batch scoring of the poses " << (fail ? "fails" : "is ok") << std::endl;
+    test_fail |= fail;
+
     std::cout << "\nGlobal pose estimation test " << (test_fail ? "fail" : "is ok") << std::endl;
 
     return test_fail;
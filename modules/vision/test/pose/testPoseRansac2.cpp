@@ -42,6 +42,7 @@
 #include <visp3/core/vpMath.h>
 #include <visp3/core/vpGaussRand.h>
 #include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/core/vpThreadPool.h>
 
 //Stanford Bunny Model points
 const std::string file_content =
@@ -1871,6 +1872,45 @@ int main() {
       std::cout << "The pose estimated with the RANSAC method is well estimated !" << std::endl;
     }
 
+    //Parallel RANSAC with adaptive termination, the result must not depend on the number of threads
+    vpHomogeneousMatrix cMo_parallel[2];
+    unsigned int nbTrials_parallel[2];
+    unsigned int nbThreads[2] = {1, 4};
+    for(int i = 0; i < 2; i++) {
+      vpThreadPool::setNumThreads(nbThreads[i]);
+      vpPose pose_parallel;
+      for(std::vector<vpPoint>::const_iterator it = bunnyModelPoints_noisy.begin();
+          it != bunnyModelPoints_noisy.end(); ++it) {
+        pose_parallel.addPoint(*it);
+      }
+      pose_parallel.setRansacNbInliersToReachConsensus(nbInlierToReachConsensus);
+      pose_parallel.setRansacThreshold(threshold);
+      pose_parallel.setRansacMaxTrials(1000);
+      pose_parallel.setUseParallelRansac(true);
+      pose_parallel.setUseRansacAdaptiveTermination(true);
+
+      double t_parallel = vpTime::measureTimeMs();
+      pose_parallel.computePose(vpPose::RANSAC, cMo_parallel[i]);
+      t_parallel = vpTime::measureTimeMs() - t_parallel;
+      nbTrials_parallel[i] = pose_parallel.getRansacNbTrials();
+
+      std::cout << "\ncMo estimated with parallel RANSAC (" << nbThreads[i] << " threads) in " << t_parallel
+                << " ms and " << nbTrials_parallel[i] << " trials" << std::endl;
+    }
+
+    double r_parallel = ground_truth_pose.computeResidual(cMo_parallel[0]);
+    std::cout << "Corresponding residual: " << r_parallel << std::endl;
+    if(r_parallel > threshold || nbTrials_parallel[0] > 1000) {
+      std::cerr << "The pose estimated with the parallel RANSAC method is bad estimated !" << std::endl;
+      return -1;
+    }
+    for(unsigned int i = 0; i < 16; i++) {
+      if(nbTrials_parallel[0] != nbTrials_parallel[1] || !vpMath::equal(cMo_parallel[0].data[i], cMo_parallel[1].data[i], 1e-12)) {
+        std::cerr << "The parallel RANSAC depends on the number of threads !" << std::endl;
+        return -1;
+      }
+    }
+
     return 0;
   }
   catch(vpException &e) {